@@ -21,12 +21,15 @@ namespace ouzel::assets
             particleSystem,
             sprite,
             sound,
-            cue
+            cue,
+            scene
         };
 
         struct Options final
         {
             bool mipmaps = true;
+            bool async = false; // decode on a worker thread and stream to the GPU
+            bool atlas = false; // pack the image into the shared texture atlas
         };
 
         Asset(Type initType,
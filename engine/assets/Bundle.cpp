@@ -2,12 +2,31 @@
 
 #include <cctype>
 #include <stdexcept>
+#include <string_view>
 #include "Bundle.hpp"
 #include "Cache.hpp"
 #include "../formats/Json.hpp"
 
 namespace ouzel::assets
 {
+    namespace
+    {
+        // the tools/ouzel exporter writes the source mesh together with its levels of detail to <mesh>.lod.obj
+        std::string getLodFilename(const std::string& filename)
+        {
+            constexpr std::string_view objExtension = ".obj";
+            constexpr std::string_view lodExtension = ".lod.obj";
+
+            if (filename.size() < objExtension.size() ||
+                filename.compare(filename.size() - objExtension.size(), objExtension.size(), objExtension) != 0 ||
+                (filename.size() >= lodExtension.size() &&
+                 filename.compare(filename.size() - lodExtension.size(), lodExtension.size(), lodExtension) == 0))
+                return {};
+
+            return filename.substr(0, filename.size() - objExtension.size()) + std::string(lodExtension);
+        }
+    }
+
     Bundle::Bundle(Cache& initCache, storage::FileSystem& initFileSystem):
         cache{initCache}, fileSystem{initFileSystem}
     {
@@ -23,7 +42,9 @@ namespace ouzel::assets
                            const std::string& filename,
                            const Asset::Options& options)
     {
-        const auto data = fileSystem.readFile(filename);
+        const auto lodFilename = assetType == Asset::Type::staticMesh ? getLodFilename(filename) : std::string{};
+        const auto data = fileSystem.readFile(!lodFilename.empty() && fileSystem.resourceFileExists(lodFilename) ?
+                                              lodFilename : filename);
 
         const auto& loaders = cache.getLoaders();
 
@@ -46,6 +67,8 @@ namespace ouzel::assets
 
             Asset::Options options;
             options.mipmaps = asset.hasMember("mipmaps") ? asset["mipmaps"].as<bool>() : true;
+            options.async = asset.hasMember("async") ? asset["async"].as<bool>() : false;
+            options.atlas = asset.hasMember("atlas") ? asset["atlas"].as<bool>() : false;
             loadAsset(static_cast<Asset::Type>(asset["type"].as<std::uint32_t>()), name, file, options);
         }
     }
@@ -78,6 +101,28 @@ namespace ouzel::assets
         textures.clear();
     }
 
+    std::shared_ptr<graphics::TextureAtlas::Region> Bundle::getTextureRegion(std::string_view name) const
+    {
+        if (const auto i = textureRegions.find(name); i != textureRegions.end())
+            return i->second;
+
+        return nullptr;
+    }
+
+    void Bundle::setTextureRegion(std::string_view name, const std::shared_ptr<graphics::TextureAtlas::Region>& textureRegion)
+    {
+        const auto i = textureRegions.find(name);
+        if (i == textureRegions.end())
+            textureRegions.insert(std::make_pair(name, textureRegion));
+        else
+            i->second = textureRegion;
+    }
+
+    void Bundle::releaseTextureRegions()
+    {
+        textureRegions.clear();
+    }
+
     const graphics::Shader* Bundle::getShader(std::string_view name) const
     {
         if (const auto i = shaders.find(name); i != shaders.end())
@@ -319,4 +364,26 @@ namespace ouzel::assets
     {
         staticMeshData.clear();
     }
+
+    const scene::SceneData* Bundle::getSceneData(std::string_view name) const
+    {
+        if (const auto i = sceneData.find(name); i != sceneData.end())
+            return &i->second;
+
+        return nullptr;
+    }
+
+    void Bundle::setSceneData(std::string_view name, scene::SceneData&& newSceneData)
+    {
+        const auto i = sceneData.find(name);
+        if (i == sceneData.end())
+            sceneData.insert(std::make_pair(name, std::move(newSceneData)));
+        else
+            i->second = std::move(newSceneData);
+    }
+
+    void Bundle::releaseSceneData()
+    {
+        sceneData.clear();
+    }
 }
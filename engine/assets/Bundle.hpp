@@ -16,11 +16,13 @@
 #include "../graphics/Material.hpp"
 #include "../graphics/Shader.hpp"
 #include "../graphics/Texture.hpp"
+#include "../graphics/TextureAtlas.hpp"
 #include "../gui/Font.hpp"
 #include "../scene/SkinnedMeshRenderer.hpp"
 #include "../scene/StaticMeshRenderer.hpp"
 #include "../scene/SpriteRenderer.hpp"
 #include "../scene/ParticleSystem.hpp"
+#include "../scene/SceneData.hpp"
 #include "../storage/FileSystem.hpp"
 
 namespace ouzel::assets
@@ -49,6 +51,10 @@ namespace ouzel::assets
         void setTexture(std::string_view name, const std::shared_ptr<graphics::Texture>& texture);
         void releaseTextures();
 
+        std::shared_ptr<graphics::TextureAtlas::Region> getTextureRegion(std::string_view name) const;
+        void setTextureRegion(std::string_view name, const std::shared_ptr<graphics::TextureAtlas::Region>& textureRegion);
+        void releaseTextureRegions();
+
         const graphics::Shader* getShader(std::string_view shaderName) const;
         void setShader(std::string_view name, std::unique_ptr<graphics::Shader> shader);
         void releaseShaders();
@@ -93,11 +99,16 @@ namespace ouzel::assets
         void setStaticMeshData(std::string_view name, scene::StaticMeshData&& newStaticMeshData);
         void releaseStaticMeshData();
 
+        const scene::SceneData* getSceneData(std::string_view name) const;
+        void setSceneData(std::string_view name, scene::SceneData&& newSceneData);
+        void releaseSceneData();
+
     private:
         Cache& cache;
         storage::FileSystem& fileSystem;
 
         std::map<std::string, std::shared_ptr<graphics::Texture>, std::less<>> textures;
+        std::map<std::string, std::shared_ptr<graphics::TextureAtlas::Region>, std::less<>> textureRegions;
         std::map<std::string, std::unique_ptr<graphics::Shader>, std::less<>> shaders;
         std::map<std::string, scene::ParticleSystemData, std::less<>> particleSystemData;
         std::map<std::string, std::unique_ptr<graphics::BlendState>, std::less<>> blendStates;
@@ -109,6 +120,7 @@ namespace ouzel::assets
         std::map<std::string, std::unique_ptr<graphics::Material>, std::less<>> materials;
         std::map<std::string, scene::SkinnedMeshData, std::less<>> skinnedMeshData;
         std::map<std::string, scene::StaticMeshData, std::less<>> staticMeshData;
+        std::map<std::string, scene::SceneData, std::less<>> sceneData;
     };
 }
 
@@ -5,11 +5,14 @@
 #include "BmfLoader.hpp"
 #include "ColladaLoader.hpp"
 #include "CueLoader.hpp"
+#include "DdsLoader.hpp"
 #include "GltfLoader.hpp"
 #include "ImageLoader.hpp"
+#include "KtxLoader.hpp"
 #include "MtlLoader.hpp"
 #include "ObjLoader.hpp"
 #include "ParticleSystemLoader.hpp"
+#include "SceneLoader.hpp"
 #include "SpriteLoader.hpp"
 #include "SpriteSheetLoader.hpp"
 #include "TtfLoader.hpp"
@@ -28,9 +31,12 @@ namespace ouzel::assets
         addLoader(Asset::Type::cue, loadCue);
         addLoader(Asset::Type::skinnedMesh, loadGltf);
         addLoader(Asset::Type::image, loadImage);
+        addLoader(Asset::Type::image, loadDds);
+        addLoader(Asset::Type::image, loadKtx);
         addLoader(Asset::Type::material, loadMtl);
         addLoader(Asset::Type::staticMesh, loadObj);
         addLoader(Asset::Type::particleSystem, loadParticleSystem);
+        addLoader(Asset::Type::scene, loadScene);
         addLoader(Asset::Type::sprite, loadSprite);
         addLoader(Asset::Type::sprite, loadSpriteSheet);
         addLoader(Asset::Type::font, loadTtf);
@@ -73,6 +79,15 @@ namespace ouzel::assets
         return nullptr;
     }
 
+    std::shared_ptr<graphics::TextureAtlas::Region> Cache::getTextureRegion(std::string_view name) const
+    {
+        for (const auto bundle : bundles)
+            if (const auto textureRegion = bundle->getTextureRegion(name))
+                return textureRegion;
+
+        return nullptr;
+    }
+
     const graphics::Shader* Cache::getShader(std::string_view name) const
     {
         for (const auto bundle : bundles)
@@ -171,4 +186,13 @@ namespace ouzel::assets
 
         return nullptr;
     }
+
+    const scene::SceneData* Cache::getSceneData(std::string_view name) const
+    {
+        for (const auto bundle : bundles)
+            if (const auto sceneData = bundle->getSceneData(name))
+                return sceneData;
+
+        return nullptr;
+    }
 }
@@ -36,6 +36,7 @@ namespace ouzel::assets
         auto& getLoaders() const noexcept { return loaders; }
 
         std::shared_ptr<graphics::Texture> getTexture(std::string_view name) const;
+        std::shared_ptr<graphics::TextureAtlas::Region> getTextureRegion(std::string_view name) const;
         const graphics::Shader* getShader(std::string_view name) const;
         const graphics::BlendState* getBlendState(std::string_view name) const;
         const graphics::DepthStencilState* getDepthStencilState(std::string_view name) const;
@@ -47,6 +48,7 @@ namespace ouzel::assets
         const graphics::Material* getMaterial(std::string_view name) const;
         const scene::SkinnedMeshData* getSkinnedMeshData(std::string_view name) const;
         const scene::StaticMeshData* getStaticMeshData(std::string_view name) const;
+        const scene::SceneData* getSceneData(std::string_view name) const;
 
     private:
         void addBundle(const Bundle* bundle);
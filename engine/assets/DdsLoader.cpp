@@ -0,0 +1,150 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include "DdsLoader.hpp"
+#include "TextureLevels.hpp"
+#include "../core/Engine.hpp"
+#include "../graphics/Texture.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        constexpr std::uint32_t makeFourCc(char a, char b, char c, char d) noexcept
+        {
+            return static_cast<std::uint32_t>(static_cast<std::uint8_t>(a)) |
+                (static_cast<std::uint32_t>(static_cast<std::uint8_t>(b)) << 8) |
+                (static_cast<std::uint32_t>(static_cast<std::uint8_t>(c)) << 16) |
+                (static_cast<std::uint32_t>(static_cast<std::uint8_t>(d)) << 24);
+        }
+
+        constexpr std::uint32_t ddsMagic = makeFourCc('D', 'D', 'S', ' ');
+        constexpr std::size_t headerSize = 4 + 124;
+        constexpr std::size_t dx10HeaderSize = 20;
+
+        constexpr std::uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+        constexpr std::uint32_t DDPF_FOURCC = 0x4;
+        constexpr std::uint32_t DDPF_RGB = 0x40;
+        constexpr std::uint32_t DDSCAPS2_CUBEMAP = 0x200;
+        constexpr std::uint32_t DDSCAPS2_VOLUME = 0x200000;
+        constexpr std::uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+
+        graphics::PixelFormat getPixelFormatFromFourCc(std::uint32_t fourCc)
+        {
+            switch (fourCc)
+            {
+                case makeFourCc('D', 'X', 'T', '1'): return graphics::PixelFormat::bc1RgbaUnsignedNorm;
+                case makeFourCc('D', 'X', 'T', '2'):
+                case makeFourCc('D', 'X', 'T', '3'): return graphics::PixelFormat::bc2RgbaUnsignedNorm;
+                case makeFourCc('D', 'X', 'T', '4'):
+                case makeFourCc('D', 'X', 'T', '5'): return graphics::PixelFormat::bc3RgbaUnsignedNorm;
+                case makeFourCc('A', 'T', 'I', '1'):
+                case makeFourCc('B', 'C', '4', 'U'): return graphics::PixelFormat::bc4RUnsignedNorm;
+                case makeFourCc('A', 'T', 'I', '2'):
+                case makeFourCc('B', 'C', '5', 'U'): return graphics::PixelFormat::bc5RgUnsignedNorm;
+                default: throw std::runtime_error{"Unsupported DDS pixel format"};
+            }
+        }
+
+        graphics::PixelFormat getPixelFormatFromDxgi(std::uint32_t format)
+        {
+            switch (format)
+            {
+                case 28: return graphics::PixelFormat::rgba8UnsignedNorm; // DXGI_FORMAT_R8G8B8A8_UNORM
+                case 29: return graphics::PixelFormat::rgba8UnsignedNormSRGB; // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+                case 49: return graphics::PixelFormat::rg8UnsignedNorm; // DXGI_FORMAT_R8G8_UNORM
+                case 61: return graphics::PixelFormat::r8UnsignedNorm; // DXGI_FORMAT_R8_UNORM
+                case 71: return graphics::PixelFormat::bc1RgbaUnsignedNorm; // DXGI_FORMAT_BC1_UNORM
+                case 72: return graphics::PixelFormat::bc1RgbaUnsignedNormSRGB; // DXGI_FORMAT_BC1_UNORM_SRGB
+                case 74: return graphics::PixelFormat::bc2RgbaUnsignedNorm; // DXGI_FORMAT_BC2_UNORM
+                case 75: return graphics::PixelFormat::bc2RgbaUnsignedNormSRGB; // DXGI_FORMAT_BC2_UNORM_SRGB
+                case 77: return graphics::PixelFormat::bc3RgbaUnsignedNorm; // DXGI_FORMAT_BC3_UNORM
+                case 78: return graphics::PixelFormat::bc3RgbaUnsignedNormSRGB; // DXGI_FORMAT_BC3_UNORM_SRGB
+                case 80: return graphics::PixelFormat::bc4RUnsignedNorm; // DXGI_FORMAT_BC4_UNORM
+                case 83: return graphics::PixelFormat::bc5RgUnsignedNorm; // DXGI_FORMAT_BC5_UNORM
+                case 95: return graphics::PixelFormat::bc6hRgbUnsignedFloat; // DXGI_FORMAT_BC6H_UF16
+                case 98: return graphics::PixelFormat::bc7RgbaUnsignedNorm; // DXGI_FORMAT_BC7_UNORM
+                case 99: return graphics::PixelFormat::bc7RgbaUnsignedNormSRGB; // DXGI_FORMAT_BC7_UNORM_SRGB
+                default: throw std::runtime_error{"Unsupported DDS pixel format"};
+            }
+        }
+    }
+
+    bool loadDds(Cache&,
+                 Bundle& bundle,
+                 const std::string& name,
+                 const std::vector<std::byte>& data,
+                 const Asset::Options& options)
+    {
+        if (data.size() < headerSize ||
+            decodeLittleEndian<std::uint32_t>(data.data()) != ddsMagic)
+            return false;
+
+        const auto read32 = [&data](std::size_t offset) {
+            if (offset + 4 > data.size())
+                throw std::runtime_error{"Not enough data"};
+            return decodeLittleEndian<std::uint32_t>(data.data() + offset);
+        };
+
+        const auto flags = read32(8);
+        const auto height = read32(12);
+        const auto width = read32(16);
+        const auto levelCount = (flags & DDSD_MIPMAPCOUNT) ? std::max(1U, read32(28)) : 1U;
+        const auto pixelFormatFlags = read32(80);
+        const auto fourCc = read32(84);
+        const auto caps2 = read32(112);
+
+        if (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))
+            throw std::runtime_error{"Only 2D DDS textures are supported"};
+
+        graphics::PixelFormat pixelFormat;
+        std::size_t offset = headerSize;
+
+        if ((pixelFormatFlags & DDPF_FOURCC) && fourCc == makeFourCc('D', 'X', '1', '0'))
+        {
+            if (read32(headerSize + 4) != D3D10_RESOURCE_DIMENSION_TEXTURE2D ||
+                read32(headerSize + 12) > 1)
+                throw std::runtime_error{"Only 2D DDS textures are supported"};
+
+            pixelFormat = getPixelFormatFromDxgi(read32(headerSize));
+            offset += dx10HeaderSize;
+        }
+        else if (pixelFormatFlags & DDPF_FOURCC)
+            pixelFormat = getPixelFormatFromFourCc(fourCc);
+        else if ((pixelFormatFlags & DDPF_RGB) &&
+                 read32(88) == 32 &&
+                 read32(92) == 0x000000FF &&
+                 read32(96) == 0x0000FF00 &&
+                 read32(100) == 0x00FF0000)
+            pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
+        else
+            throw std::runtime_error{"Unsupported DDS pixel format"};
+
+        std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
+
+        for (const auto& levelSize : getLevelSizes(width, height, options.mipmaps ? levelCount : 1U))
+        {
+            const auto levelDataSize = graphics::getDataSize(pixelFormat, levelSize.v[0], levelSize.v[1]);
+
+            if (offset + levelDataSize > data.size())
+                throw std::runtime_error{"Not enough data"};
+
+            const auto levelData = reinterpret_cast<const std::uint8_t*>(data.data()) + offset;
+            levels.emplace_back(levelSize, std::vector<std::uint8_t>(levelData, levelData + levelDataSize));
+            offset += levelDataSize;
+        }
+
+        const auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                                 levels,
+                                                                 levels.front().first,
+                                                                 graphics::Flags::none,
+                                                                 pixelFormat);
+
+        bundle.setTexture(name, texture);
+
+        return true;
+    }
+}
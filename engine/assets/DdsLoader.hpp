@@ -0,0 +1,17 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_DDSLOADER_HPP
+#define OUZEL_ASSETS_DDSLOADER_HPP
+
+#include "Bundle.hpp"
+
+namespace ouzel::assets
+{
+    bool loadDds(Cache& cache,
+                 Bundle& bundle,
+                 const std::string& name,
+                 const std::vector<std::byte>& data,
+                 const Asset::Options& options);
+}
+
+#endif // OUZEL_ASSETS_DDSLOADER_HPP
@@ -0,0 +1,779 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include "GltfLoader.hpp"
+#include "Cache.hpp"
+#include "../core/Engine.hpp"
+#include "../formats/Json.hpp"
+#include "../graphics/Material.hpp"
+#include "../scene/SkinnedMeshRenderer.hpp"
+#include "../utils/Log.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        constexpr std::uint32_t binaryMagic = 0x46546C67; // "glTF"
+        constexpr std::uint32_t jsonChunkType = 0x4E4F534A; // "JSON"
+        constexpr std::uint32_t binaryChunkType = 0x004E4942; // "BIN"
+
+        enum ComponentType: std::uint32_t
+        {
+            signedByte = 5120,
+            unsignedByte = 5121,
+            signedShort = 5122,
+            unsignedShort = 5123,
+            unsignedInt = 5125,
+            floatingPoint = 5126
+        };
+
+        enum class Mode: std::uint32_t
+        {
+            triangles = 4
+        };
+
+        std::uint32_t decodeUInt32(const std::vector<std::byte>& data, std::size_t offset)
+        {
+            if (offset + 4 > data.size())
+                throw std::runtime_error{"Invalid glTF file"};
+
+            return static_cast<std::uint32_t>(data[offset + 0]) |
+                (static_cast<std::uint32_t>(data[offset + 1]) << 8) |
+                (static_cast<std::uint32_t>(data[offset + 2]) << 16) |
+                (static_cast<std::uint32_t>(data[offset + 3]) << 24);
+        }
+
+        std::vector<std::byte> decodeBase64(std::string_view encoded)
+        {
+            std::vector<std::byte> result;
+            result.reserve(encoded.size() * 3 / 4);
+
+            std::uint32_t buffer = 0;
+            std::uint32_t bits = 0;
+
+            for (const auto c : encoded)
+            {
+                std::uint32_t value;
+                if (c >= 'A' && c <= 'Z') value = static_cast<std::uint32_t>(c - 'A');
+                else if (c >= 'a' && c <= 'z') value = static_cast<std::uint32_t>(c - 'a' + 26);
+                else if (c >= '0' && c <= '9') value = static_cast<std::uint32_t>(c - '0' + 52);
+                else if (c == '+') value = 62;
+                else if (c == '/') value = 63;
+                else if (c == '=') break;
+                else throw std::runtime_error{"Invalid base64 data"};
+
+                buffer = (buffer << 6) | value;
+                bits += 6;
+
+                if (bits >= 8)
+                {
+                    bits -= 8;
+                    result.push_back(static_cast<std::byte>((buffer >> bits) & 0xFF));
+                }
+            }
+
+            return result;
+        }
+
+        std::vector<std::byte> loadBuffer(const json::Value& buffer,
+                                          const std::vector<std::byte>& binaryChunk)
+        {
+            // the buffer without an URI is the binary chunk of a .glb file
+            if (!buffer.hasMember("uri")) return binaryChunk;
+
+            const auto& uri = buffer["uri"].as<std::string>();
+
+            if (uri.compare(0, 5, "data:") == 0)
+            {
+                const auto position = uri.find(";base64,");
+                if (position == std::string::npos)
+                    throw std::runtime_error{"Unsupported glTF buffer data URI"};
+
+                return decodeBase64(std::string_view{uri}.substr(position + 8));
+            }
+
+            return engine->getFileSystem().readFile(uri);
+        }
+
+        std::size_t getComponentSize(std::uint32_t componentType)
+        {
+            switch (componentType)
+            {
+                case signedByte:
+                case unsignedByte: return 1;
+                case signedShort:
+                case unsignedShort: return 2;
+                case unsignedInt:
+                case floatingPoint: return 4;
+                default: throw std::runtime_error{"Invalid glTF component type"};
+            }
+        }
+
+        std::size_t getComponentCount(const std::string& type)
+        {
+            if (type == "SCALAR") return 1;
+            else if (type == "VEC2") return 2;
+            else if (type == "VEC3") return 3;
+            else if (type == "VEC4") return 4;
+            else if (type == "MAT4") return 16;
+            else throw std::runtime_error{"Unsupported glTF accessor type " + type};
+        }
+
+        double readComponent(const std::byte* data, std::uint32_t componentType, bool normalized) noexcept
+        {
+            switch (componentType)
+            {
+                case signedByte:
+                {
+                    const auto value = static_cast<std::int8_t>(data[0]);
+                    return normalized ? std::max(value / 127.0, -1.0) : value;
+                }
+                case unsignedByte:
+                {
+                    const auto value = static_cast<std::uint8_t>(data[0]);
+                    return normalized ? value / 255.0 : value;
+                }
+                case signedShort:
+                {
+                    std::int16_t value;
+                    std::memcpy(&value, data, sizeof(value));
+                    return normalized ? std::max(value / 32767.0, -1.0) : value;
+                }
+                case unsignedShort:
+                {
+                    std::uint16_t value;
+                    std::memcpy(&value, data, sizeof(value));
+                    return normalized ? value / 65535.0 : value;
+                }
+                case unsignedInt:
+                {
+                    std::uint32_t value;
+                    std::memcpy(&value, data, sizeof(value));
+                    return value;
+                }
+                case floatingPoint:
+                {
+                    float value;
+                    std::memcpy(&value, data, sizeof(value));
+                    return value;
+                }
+                default: return 0.0;
+            }
+        }
+
+        // returns the elements of the accessor as a flat array of components
+        template <typename T>
+        std::vector<T> readAccessor(const json::Value& document,
+                                    const std::vector<std::vector<std::byte>>& buffers,
+                                    std::size_t accessorIndex,
+                                    std::size_t& components)
+        {
+            const auto& accessor = document["accessors"][accessorIndex];
+
+            if (accessor.hasMember("sparse"))
+                throw std::runtime_error{"Sparse glTF accessors are not supported"};
+
+            const auto count = accessor["count"].as<std::size_t>();
+            const auto componentType = accessor["componentType"].as<std::uint32_t>();
+            const auto normalized = accessor.hasMember("normalized") && accessor["normalized"].as<bool>();
+            const auto componentSize = getComponentSize(componentType);
+            components = getComponentCount(accessor["type"].as<std::string>());
+
+            std::vector<T> result(count * components);
+
+            // accessors without a buffer view are filled with zeros
+            if (!accessor.hasMember("bufferView")) return result;
+
+            const auto& bufferView = document["bufferViews"][accessor["bufferView"].as<std::size_t>()];
+            const auto bufferIndex = bufferView["buffer"].as<std::size_t>();
+            if (bufferIndex >= buffers.size())
+                throw std::runtime_error{"Invalid glTF buffer"};
+
+            const auto& buffer = buffers[bufferIndex];
+
+            const auto elementSize = componentSize * components;
+            const auto stride = bufferView.hasMember("byteStride") ? bufferView["byteStride"].as<std::size_t>() : elementSize;
+            const auto viewOffset = bufferView.hasMember("byteOffset") ? bufferView["byteOffset"].as<std::size_t>() : 0;
+            const auto viewLength = bufferView["byteLength"].as<std::size_t>();
+            const auto offset = accessor.hasMember("byteOffset") ? accessor["byteOffset"].as<std::size_t>() : 0;
+
+            if (count &&
+                (offset + stride * (count - 1) + elementSize > viewLength ||
+                 viewOffset + viewLength > buffer.size()))
+                throw std::runtime_error{"glTF accessor is out of bounds"};
+
+            const auto data = buffer.data() + viewOffset + offset;
+
+            for (std::size_t i = 0; i < count; ++i)
+                for (std::size_t c = 0; c < components; ++c)
+                    result[i * components + c] = static_cast<T>(readComponent(data + i * stride + c * componentSize,
+                                                                               componentType,
+                                                                               normalized));
+
+            return result;
+        }
+
+        template <typename T>
+        std::vector<T> readAccessor(const json::Value& document,
+                                    const std::vector<std::vector<std::byte>>& buffers,
+                                    std::size_t accessorIndex,
+                                    std::size_t expectedComponents,
+                                    const char* description)
+        {
+            std::size_t components;
+            auto result = readAccessor<T>(document, buffers, accessorIndex, components);
+            if (components != expectedComponents)
+                throw std::runtime_error{std::string{"Invalid glTF "} + description + " accessor"};
+            return result;
+        }
+
+        math::Matrix<float, 4> getLocalTransform(const json::Value& node)
+        {
+            math::Matrix<float, 4> result = math::identityMatrix<float, 4>;
+
+            if (node.hasMember("matrix"))
+            {
+                const auto& matrix = node["matrix"];
+                for (std::size_t i = 0; i < 16; ++i)
+                    result.m.v[i] = matrix[i].as<float>(); // column-major in both
+                return result;
+            }
+
+            if (node.hasMember("translation"))
+            {
+                const auto& translation = node["translation"];
+                setTranslation(result, math::Vector<float, 3>{
+                    translation[0].as<float>(), translation[1].as<float>(), translation[2].as<float>()
+                });
+            }
+
+            if (node.hasMember("rotation"))
+            {
+                const auto& rotation = node["rotation"];
+                math::Matrix<float, 4> rotationMatrix;
+                math::setRotation(rotationMatrix, math::Quaternion<float>{
+                    rotation[0].as<float>(), rotation[1].as<float>(), rotation[2].as<float>(), rotation[3].as<float>()
+                });
+                result *= rotationMatrix;
+            }
+
+            if (node.hasMember("scale"))
+            {
+                const auto& scale = node["scale"];
+                math::Matrix<float, 4> scaleMatrix;
+                math::setScale(scaleMatrix, math::Vector<float, 3>{
+                    scale[0].as<float>(), scale[1].as<float>(), scale[2].as<float>()
+                });
+                result *= scaleMatrix;
+            }
+
+            return result;
+        }
+
+        scene::JointTransform getJointTransform(const json::Value& node)
+        {
+            scene::JointTransform result;
+
+            if (node.hasMember("matrix"))
+            {
+                const auto matrix = getLocalTransform(node);
+                result.translation = math::Vector<float, 3>{matrix.m.v[12], matrix.m.v[13], matrix.m.v[14]};
+
+                float m[3][3];
+                for (std::size_t c = 0; c < 3; ++c)
+                {
+                    result.scale.v[c] = std::sqrt(matrix.m.v[c * 4 + 0] * matrix.m.v[c * 4 + 0] +
+                                                  matrix.m.v[c * 4 + 1] * matrix.m.v[c * 4 + 1] +
+                                                  matrix.m.v[c * 4 + 2] * matrix.m.v[c * 4 + 2]);
+                    for (std::size_t r = 0; r < 3; ++r)
+                        m[r][c] = result.scale.v[c] > 0.0F ? matrix.m.v[c * 4 + r] / result.scale.v[c] : 0.0F;
+                }
+
+                result.rotation = math::Quaternion<float>{
+                    std::copysign(std::sqrt(std::max(0.0F, 1.0F + m[0][0] - m[1][1] - m[2][2])) / 2.0F, m[2][1] - m[1][2]),
+                    std::copysign(std::sqrt(std::max(0.0F, 1.0F - m[0][0] + m[1][1] - m[2][2])) / 2.0F, m[0][2] - m[2][0]),
+                    std::copysign(std::sqrt(std::max(0.0F, 1.0F - m[0][0] - m[1][1] + m[2][2])) / 2.0F, m[1][0] - m[0][1]),
+                    std::sqrt(std::max(0.0F, 1.0F + m[0][0] + m[1][1] + m[2][2])) / 2.0F
+                };
+
+                return result;
+            }
+
+            if (node.hasMember("translation"))
+            {
+                const auto& translation = node["translation"];
+                result.translation = math::Vector<float, 3>{
+                    translation[0].as<float>(), translation[1].as<float>(), translation[2].as<float>()
+                };
+            }
+
+            if (node.hasMember("rotation"))
+            {
+                const auto& rotation = node["rotation"];
+                result.rotation = math::Quaternion<float>{
+                    rotation[0].as<float>(), rotation[1].as<float>(), rotation[2].as<float>(), rotation[3].as<float>()
+                };
+            }
+
+            if (node.hasMember("scale"))
+            {
+                const auto& scale = node["scale"];
+                result.scale = math::Vector<float, 3>{
+                    scale[0].as<float>(), scale[1].as<float>(), scale[2].as<float>()
+                };
+            }
+
+            return result;
+        }
+
+        const graphics::Material* loadMaterial(Cache& cache,
+                                               Bundle& bundle,
+                                               const std::string& name,
+                                               const json::Value& document,
+                                               const json::Value& primitive,
+                                               const Asset::Options& options)
+        {
+            const auto materialIndex = primitive.hasMember("material") ? primitive["material"].as<std::size_t>() : 0;
+            const auto materialName = name + "/material" + std::to_string(materialIndex);
+
+            if (const auto material = bundle.getMaterial(materialName))
+                return material;
+
+            auto material = std::make_unique<graphics::Material>();
+            material->blendState = cache.getBlendState(blendAlpha);
+            material->shader = cache.getShader(shaderTexture);
+            material->litShader = cache.getShader(shaderTextureLit);
+            material->ambientColor = math::blackColor; // glTF has no ambient term
+            material->textures[0] = cache.getTexture(textureWhitePixel);
+            material->cullMode = graphics::CullMode::back;
+            material->opaque = true;
+
+            if (primitive.hasMember("material"))
+            {
+                const auto& materialValue = document["materials"][materialIndex];
+
+                if (materialValue.hasMember("doubleSided") && materialValue["doubleSided"].as<bool>())
+                    material->cullMode = graphics::CullMode::none;
+
+                // masked materials are drawn with blending, because the shaders don't discard fragments
+                if (materialValue.hasMember("alphaMode") && materialValue["alphaMode"].as<std::string>() != "OPAQUE")
+                    material->opaque = false;
+
+                if (materialValue.hasMember("pbrMetallicRoughness"))
+                {
+                    const auto& pbr = materialValue["pbrMetallicRoughness"];
+
+                    if (pbr.hasMember("baseColorFactor"))
+                    {
+                        const auto& color = pbr["baseColorFactor"];
+                        material->diffuseColor = math::Color{
+                            color[0].as<float>(), color[1].as<float>(), color[2].as<float>()
+                        };
+                        material->opacity = color[3].as<float>();
+                    }
+
+                    // only images stored in separate files are supported
+                    if (pbr.hasMember("baseColorTexture"))
+                    {
+                        const auto& texture = document["textures"][pbr["baseColorTexture"]["index"].as<std::size_t>()];
+                        if (texture.hasMember("source"))
+                        {
+                            const auto& image = document["images"][texture["source"].as<std::size_t>()];
+                            if (image.hasMember("uri"))
+                            {
+                                const auto& uri = image["uri"].as<std::string>();
+                                if (uri.compare(0, 5, "data:") != 0)
+                                {
+                                    if (!bundle.getTexture(uri))
+                                        bundle.loadAsset(Asset::Type::image, uri, uri, options);
+                                    material->textures[0] = bundle.getTexture(uri);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // the alpha of opaque materials is ignored
+            if (material->opaque) material->opacity = 1.0F;
+
+            bundle.setMaterial(materialName, std::move(material));
+            return bundle.getMaterial(materialName);
+        }
+    }
+
+    bool loadGltf(Cache& cache,
+                  Bundle& bundle,
+                  const std::string& name,
+                  const std::vector<std::byte>& data,
+                  const Asset::Options& options)
+    {
+        json::Value document;
+        std::vector<std::byte> binaryChunk;
+        bool hasDocument = false;
+
+        if (data.size() >= 12 && decodeUInt32(data, 0) == binaryMagic)
+        {
+            if (decodeUInt32(data, 4) != 2)
+                throw std::runtime_error{"Unsupported glTF version"};
+
+            const auto length = std::min(static_cast<std::size_t>(decodeUInt32(data, 8)), data.size());
+
+            for (std::size_t offset = 12; offset + 8 <= length;)
+            {
+                const auto chunkLength = decodeUInt32(data, offset);
+                const auto chunkType = decodeUInt32(data, offset + 4);
+                const auto chunkStart = offset + 8;
+
+                if (chunkStart + chunkLength > length)
+                    throw std::runtime_error{"Invalid glTF chunk"};
+
+                if (chunkType == jsonChunkType)
+                {
+                    document = json::parse(std::vector<std::byte>(data.begin() + static_cast<std::ptrdiff_t>(chunkStart),
+                                                                  data.begin() + static_cast<std::ptrdiff_t>(chunkStart + chunkLength)));
+                    hasDocument = true;
+                }
+                else if (chunkType == binaryChunkType && binaryChunk.empty())
+                    binaryChunk.assign(data.begin() + static_cast<std::ptrdiff_t>(chunkStart),
+                                       data.begin() + static_cast<std::ptrdiff_t>(chunkStart + chunkLength));
+
+                offset = chunkStart + ((chunkLength + 3) & ~std::size_t(3));
+            }
+
+            if (!hasDocument)
+                throw std::runtime_error{"glTF file has no JSON chunk"};
+        }
+        else
+            document = json::parse(data);
+
+        if (!document.hasMember("meshes") || !document.hasMember("nodes"))
+            return true;
+
+        const auto& nodes = document["nodes"];
+        const auto nodeCount = nodes.getSize();
+
+        std::vector<std::size_t> parents(nodeCount, scene::Skeleton::noParent);
+        for (std::size_t i = 0; i < nodeCount; ++i)
+            if (nodes[i].hasMember("children"))
+                for (const auto& child : nodes[i]["children"])
+                    if (const auto childIndex = child.as<std::size_t>(); childIndex < nodeCount)
+                        parents[childIndex] = i;
+
+        // prefer the first node that has both a mesh and a skin
+        std::size_t meshNode = scene::Skeleton::noParent;
+        for (std::size_t i = 0; i < nodeCount; ++i)
+            if (nodes[i].hasMember("mesh"))
+            {
+                if (nodes[i].hasMember("skin"))
+                {
+                    meshNode = i;
+                    break;
+                }
+                else if (meshNode == scene::Skeleton::noParent)
+                    meshNode = i;
+            }
+
+        if (meshNode == scene::Skeleton::noParent)
+            return true;
+
+        // the nodes that share the skin (e.g. the body and the head of a character) are merged into one mesh,
+        // the transforms of skinned nodes are ignored, so their vertices are already in the same space
+        std::vector<std::size_t> meshNodes{meshNode};
+        if (nodes[meshNode].hasMember("skin"))
+        {
+            const auto skinIndex = nodes[meshNode]["skin"].as<std::size_t>();
+
+            for (std::size_t i = meshNode + 1; i < nodeCount; ++i)
+                if (nodes[i].hasMember("mesh") && nodes[i].hasMember("skin") &&
+                    nodes[i]["skin"].as<std::size_t>() == skinIndex)
+                    meshNodes.push_back(i);
+        }
+
+        for (std::size_t i = 0; i < nodeCount; ++i)
+            if (nodes[i].hasMember("mesh") && std::find(meshNodes.begin(), meshNodes.end(), i) == meshNodes.end())
+                log(Log::Level::warning) << "glTF node " << i << " of " << name << " is not loaded, only the meshes that share the first skin are";
+
+        std::vector<std::vector<std::byte>> buffers;
+        if (document.hasMember("buffers"))
+            for (const auto& buffer : document["buffers"])
+                buffers.push_back(loadBuffer(buffer, binaryChunk));
+
+        scene::Skeleton skeleton;
+        std::vector<std::size_t> jointNodes;
+        std::vector<std::uint16_t> jointRemap; // skin joint index to skeleton joint index
+        std::vector<std::size_t> nodeJoints(nodeCount, scene::Skeleton::noParent);
+
+        if (nodes[meshNode].hasMember("skin"))
+        {
+            const auto& skin = document["skins"][nodes[meshNode]["skin"].as<std::size_t>()];
+
+            for (const auto& joint : skin["joints"])
+                jointNodes.push_back(joint.as<std::size_t>());
+
+            if (jointNodes.empty() || jointNodes.size() > std::numeric_limits<std::uint16_t>::max())
+                throw std::runtime_error{"Invalid glTF skin"};
+
+            for (std::size_t i = 0; i < jointNodes.size(); ++i)
+                if (jointNodes[i] >= nodeCount)
+                    throw std::runtime_error{"Invalid glTF joint"};
+                else
+                    nodeJoints[jointNodes[i]] = i;
+
+            // sort the joints by depth, so that the parents precede their children
+            std::vector<std::size_t> depths(jointNodes.size());
+            for (std::size_t i = 0; i < jointNodes.size(); ++i)
+                for (auto parent = parents[jointNodes[i]]; parent != scene::Skeleton::noParent; parent = parents[parent])
+                    if (++depths[i] > nodeCount)
+                        throw std::runtime_error{"glTF node hierarchy has a cycle"};
+
+            std::vector<std::size_t> order(jointNodes.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&depths](std::size_t a, std::size_t b) {
+                return depths[a] < depths[b];
+            });
+
+            jointRemap.resize(jointNodes.size());
+            for (std::size_t i = 0; i < order.size(); ++i)
+                jointRemap[order[i]] = static_cast<std::uint16_t>(i);
+
+            std::vector<float> inverseBindMatrices;
+            if (skin.hasMember("inverseBindMatrices"))
+            {
+                inverseBindMatrices = readAccessor<float>(document, buffers,
+                                                          skin["inverseBindMatrices"].as<std::size_t>(),
+                                                          16, "inverse bind matrix");
+                if (inverseBindMatrices.size() < jointNodes.size() * 16)
+                    throw std::runtime_error{"Invalid glTF inverse bind matrices"};
+            }
+
+            skeleton.joints.resize(jointNodes.size());
+            for (std::size_t i = 0; i < jointNodes.size(); ++i)
+            {
+                const auto& node = nodes[jointNodes[i]];
+                auto& joint = skeleton.joints[jointRemap[i]];
+
+                if (node.hasMember("name")) joint.name = node["name"].as<std::string>();
+                joint.bindPose = getJointTransform(node);
+
+                if (!inverseBindMatrices.empty())
+                    std::copy(inverseBindMatrices.begin() + static_cast<std::ptrdiff_t>(i * 16),
+                              inverseBindMatrices.begin() + static_cast<std::ptrdiff_t>(i * 16 + 16),
+                              joint.inverseBindMatrix.m.v);
+
+                // the closest ancestor that is a joint, the transforms of nodes in between are ignored
+                for (auto parent = parents[jointNodes[i]]; parent != scene::Skeleton::noParent; parent = parents[parent])
+                    if (nodeJoints[parent] != scene::Skeleton::noParent)
+                    {
+                        joint.parent = jointRemap[nodeJoints[parent]];
+                        break;
+                    }
+            }
+
+            // the nodes above the root joint (e.g. the armature) still transform the skeleton
+            for (auto parent = parents[jointNodes[order.front()]]; parent != scene::Skeleton::noParent; parent = parents[parent])
+                skeleton.rootTransform = getLocalTransform(nodes[parent]) * skeleton.rootTransform;
+        }
+        else
+        {
+            // a mesh without a skin is attached to a single joint
+            skeleton.joints.resize(1);
+            jointRemap.push_back(0);
+        }
+
+        math::Box<float, 3> boundingBox;
+        std::vector<std::uint32_t> indices;
+        std::vector<graphics::Vertex> vertices;
+        scene::SkinnedVertices skinnedVertices;
+        std::vector<scene::SkinnedMeshData::Primitive> primitives;
+
+        for (const auto node : meshNodes)
+        {
+            for (const auto& primitive : document["meshes"][nodes[node]["mesh"].as<std::size_t>()]["primitives"])
+            {
+                if (primitive.hasMember("mode") &&
+                    primitive["mode"].as<std::uint32_t>() != static_cast<std::uint32_t>(Mode::triangles))
+                    continue;
+
+                const auto& attributes = primitive["attributes"];
+                if (!attributes.hasMember("POSITION")) continue;
+
+                const auto startIndex = indices.size();
+
+                const auto positions = readAccessor<float>(document, buffers, attributes["POSITION"].as<std::size_t>(), 3, "position");
+                const auto vertexCount = positions.size() / 3;
+                const auto baseVertex = vertices.size();
+
+                if (baseVertex + vertexCount > std::numeric_limits<std::uint32_t>::max())
+                    throw std::runtime_error{"Too many vertices"};
+
+                std::vector<float> normals;
+                if (attributes.hasMember("NORMAL"))
+                    normals = readAccessor<float>(document, buffers, attributes["NORMAL"].as<std::size_t>(), 3, "normal");
+
+                std::vector<float> texCoords;
+                if (attributes.hasMember("TEXCOORD_0"))
+                    texCoords = readAccessor<float>(document, buffers, attributes["TEXCOORD_0"].as<std::size_t>(), 2, "texture coordinate");
+
+                std::size_t colorComponents = 4;
+                std::vector<float> colors;
+                if (attributes.hasMember("COLOR_0"))
+                    colors = readAccessor<float>(document, buffers, attributes["COLOR_0"].as<std::size_t>(), colorComponents);
+
+                std::vector<std::uint32_t> joints;
+                std::vector<float> weights;
+                if (!jointNodes.empty() && attributes.hasMember("JOINTS_0") && attributes.hasMember("WEIGHTS_0"))
+                {
+                    joints = readAccessor<std::uint32_t>(document, buffers, attributes["JOINTS_0"].as<std::size_t>(), 4, "joint");
+                    weights = readAccessor<float>(document, buffers, attributes["WEIGHTS_0"].as<std::size_t>(), 4, "weight");
+                }
+
+                if ((!normals.empty() && normals.size() != vertexCount * 3) ||
+                    (!texCoords.empty() && texCoords.size() != vertexCount * 2) ||
+                    (!colors.empty() && colors.size() != vertexCount * colorComponents) ||
+                    joints.size() != weights.size() ||
+                    (!joints.empty() && joints.size() != vertexCount * 4))
+                    throw std::runtime_error{"Invalid glTF vertex attributes"};
+
+                for (std::size_t i = 0; i < vertexCount; ++i)
+                {
+                    graphics::Vertex vertex;
+                    vertex.position = math::Vector<float, 3>{positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]};
+                    vertex.color = colors.empty() ? math::whiteColor :
+                        math::Color{colors[i * colorComponents + 0],
+                                    colors[i * colorComponents + 1],
+                                    colors[i * colorComponents + 2],
+                                    colorComponents == 4 ? colors[i * colorComponents + 3] : 1.0F};
+                    if (!texCoords.empty())
+                        vertex.texCoords[0] = math::Vector<float, 2>{texCoords[i * 2 + 0], texCoords[i * 2 + 1]};
+                    if (!normals.empty())
+                        vertex.normal = math::Vector<float, 3>{normals[i * 3 + 0], normals[i * 3 + 1], normals[i * 3 + 2]};
+
+                    std::array<std::uint16_t, 4> vertexJoints{};
+                    std::array<float, 4> vertexWeights{1.0F, 0.0F, 0.0F, 0.0F};
+
+                    if (!joints.empty())
+                    {
+                        float sum = 0.0F;
+                        for (std::size_t j = 0; j < 4; ++j)
+                        {
+                            const auto joint = joints[i * 4 + j];
+                            const auto weight = weights[i * 4 + j];
+                            if (weight != 0.0F && joint >= jointRemap.size())
+                                throw std::runtime_error{"Invalid glTF joint index"};
+
+                            vertexJoints[j] = weight != 0.0F ? jointRemap[joint] : 0;
+                            vertexWeights[j] = weight;
+                            sum += weight;
+                        }
+
+                        if (sum > 0.0F)
+                            for (auto& weight : vertexWeights) weight /= sum;
+                        else
+                            vertexWeights = {1.0F, 0.0F, 0.0F, 0.0F};
+                    }
+
+                    vertices.push_back(vertex);
+                    skinnedVertices.positions.push_back(vertex.position);
+                    skinnedVertices.normals.push_back(vertex.normal);
+                    skinnedVertices.joints.push_back(vertexJoints);
+                    skinnedVertices.weights.push_back(vertexWeights);
+                    insertPoint(boundingBox, vertex.position);
+                }
+
+                if (primitive.hasMember("indices"))
+                {
+                    for (const auto index : readAccessor<std::uint32_t>(document, buffers, primitive["indices"].as<std::size_t>(), 1, "index"))
+                        if (index >= vertexCount)
+                            throw std::runtime_error{"Invalid glTF index"};
+                        else
+                            indices.push_back(static_cast<std::uint32_t>(baseVertex + index));
+                }
+                else
+                    for (std::size_t i = 0; i < vertexCount; ++i)
+                        indices.push_back(static_cast<std::uint32_t>(baseVertex + i));
+
+                if (indices.size() > std::numeric_limits<std::uint32_t>::max())
+                    throw std::runtime_error{"Too many indices"};
+
+                primitives.push_back(scene::SkinnedMeshData::Primitive{
+                    loadMaterial(cache, bundle, name, document, primitive, options),
+                    static_cast<std::uint32_t>(startIndex),
+                    static_cast<std::uint32_t>(indices.size() - startIndex)
+                });
+            }
+        }
+
+        std::vector<scene::AnimationClip> animations;
+
+        if (!jointNodes.empty() && document.hasMember("animations"))
+            for (const auto& animationValue : document["animations"])
+            {
+                scene::AnimationClip animation;
+                animation.name = animationValue.hasMember("name") ?
+                    animationValue["name"].as<std::string>() :
+                    "animation" + std::to_string(animations.size());
+
+                const auto& samplers = animationValue["samplers"];
+
+                for (const auto& channelValue : animationValue["channels"])
+                {
+                    const auto& target = channelValue["target"];
+                    if (!target.hasMember("node")) continue;
+
+                    const auto node = target["node"].as<std::size_t>();
+                    if (node >= nodeCount || nodeJoints[node] == scene::Skeleton::noParent) continue;
+
+                    scene::AnimationClip::Channel channel;
+                    channel.joint = jointRemap[nodeJoints[node]];
+
+                    const auto& path = target["path"].as<std::string>();
+                    if (path == "translation") channel.path = scene::AnimationClip::Path::translation;
+                    else if (path == "rotation") channel.path = scene::AnimationClip::Path::rotation;
+                    else if (path == "scale") channel.path = scene::AnimationClip::Path::scale;
+                    else continue; // morph target weights
+
+                    const auto& sampler = samplers[channelValue["sampler"].as<std::size_t>()];
+                    const auto interpolation = sampler.hasMember("interpolation") ?
+                        sampler["interpolation"].as<std::string>() : std::string{"LINEAR"};
+
+                    if (interpolation == "STEP") channel.interpolation = scene::AnimationClip::Interpolation::step;
+                    else if (interpolation == "CUBICSPLINE") channel.interpolation = scene::AnimationClip::Interpolation::cubicSpline;
+                    else channel.interpolation = scene::AnimationClip::Interpolation::linear;
+
+                    const auto components = channel.path == scene::AnimationClip::Path::rotation ? std::size_t(4) : std::size_t(3);
+                    channel.times = readAccessor<float>(document, buffers, sampler["input"].as<std::size_t>(), 1, "animation input");
+                    channel.values = readAccessor<float>(document, buffers, sampler["output"].as<std::size_t>(), components, "animation output");
+
+                    const auto keyValues = channel.interpolation == scene::AnimationClip::Interpolation::cubicSpline ? 3 : 1;
+                    if (channel.values.size() != channel.times.size() * components * keyValues)
+                        throw std::runtime_error{"Invalid glTF animation sampler"};
+
+                    if (channel.times.empty()) continue;
+
+                    animation.duration = std::max(animation.duration, channel.times.back());
+                    animation.channels.push_back(std::move(channel));
+                }
+
+                animations.push_back(std::move(animation));
+            }
+
+        scene::SkinnedMeshData meshData(boundingBox,
+                                        indices,
+                                        vertices,
+                                        skinnedVertices,
+                                        skeleton,
+                                        animations,
+                                        primitives);
+        bundle.setSkinnedMeshData(name, std::move(meshData));
+
+        return true;
+    }
+}
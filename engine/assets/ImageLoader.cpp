@@ -32,8 +32,6 @@
 #define STBI_NO_PNM
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "stb_image_write.h"
 
 #ifdef _MSC_VER
 #  pragma warning( pop )
@@ -43,6 +41,32 @@
 
 namespace ouzel::assets
 {
+    namespace
+    {
+        // decodes the image to 8-bit pixels with the given channel count, stb converts between the channel counts
+        std::vector<std::uint8_t> decodeImage(const std::vector<std::byte>& data, int channels)
+        {
+            int width;
+            int height;
+            int comp;
+
+            using ImageFreeFunction = void(*)(void*);
+            std::unique_ptr<stbi_uc, ImageFreeFunction> tempData{
+                stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data.data()),
+                                      static_cast<int>(data.size()),
+                                      &width, &height,
+                                      &comp, channels),
+                &stbi_image_free
+            };
+
+            if (!tempData)
+                throw std::runtime_error{"Failed to load texture, reason: " + std::string(stbi_failure_reason())};
+
+            return std::vector<std::uint8_t>(tempData.get(),
+                                             tempData.get() + static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * static_cast<std::size_t>(channels));
+        }
+    }
+
     bool loadImage(Cache&,
                    Bundle& bundle,
                    const std::string& name,
@@ -53,103 +77,62 @@ namespace ouzel::assets
         int height;
         int comp;
 
-        using ImageFreeFunction = void(*)(void*);
-        std::unique_ptr<stbi_uc, ImageFreeFunction> tempData{
-            stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data.data()),
-                                  static_cast<int>(data.size()),
-                                  &width, &height,
-                                  &comp, STBI_default),
-            &stbi_image_free
-        };
-
-        if (!tempData)
+        if (!stbi_info_from_memory(reinterpret_cast<const stbi_uc*>(data.data()),
+                                   static_cast<int>(data.size()),
+                                   &width, &height, &comp))
             throw std::runtime_error{"Failed to load texture, reason: " + std::string(stbi_failure_reason())};
 
-        graphics::PixelFormat pixelFormat;
-        std::vector<std::uint8_t> imageData;
+        const math::Size<std::uint32_t, 2> size{
+            static_cast<std::uint32_t>(width),
+            static_cast<std::uint32_t>(height)
+        };
 
-        switch (comp)
+        if (options.atlas)
         {
-            case STBI_grey:
-            {
-                pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
-
-                imageData.resize(static_cast<std::size_t>(width * height * 4));
-
-                for (int y = 0; y < height; ++y)
-                    for (int x = 0; x < width; ++x)
-                    {
-                        const auto sourceOffset = static_cast<std::size_t>(y * width + x);
-                        const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
-                        imageData[destinationOffset + 0] = tempData.get()[sourceOffset];
-                        imageData[destinationOffset + 1] = tempData.get()[sourceOffset];
-                        imageData[destinationOffset + 2] = tempData.get()[sourceOffset];
-                        imageData[destinationOffset + 3] = 255;
-                    }
-                break;
-            }
-            case STBI_grey_alpha:
-            {
-                pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
-
-                imageData.resize(static_cast<std::size_t>(width * height * 4));
-
-                for (int y = 0; y < height; ++y)
-                    for (int x = 0; x < width; ++x)
-                    {
-                        const auto sourceOffset = static_cast<std::size_t>((y * width + x) * 2);
-                        const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
-                        imageData[destinationOffset + 0] = tempData.get()[sourceOffset + 0];
-                        imageData[destinationOffset + 1] = tempData.get()[sourceOffset + 0];
-                        imageData[destinationOffset + 2] = tempData.get()[sourceOffset + 0];
-                        imageData[destinationOffset + 3] = tempData.get()[sourceOffset + 1];
-                    }
-                break;
-            }
-            case STBI_rgb:
-            {
-                pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
-
-                imageData.resize(static_cast<std::size_t>(width * height * 4));
-
-                for (int y = 0; y < height; ++y)
-                    for (int x = 0; x < width; ++x)
-                    {
-                        const auto sourceOffset = static_cast<std::size_t>((y * width + x) * 3);
-                        const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
-                        imageData[destinationOffset + 0] = tempData.get()[sourceOffset + 0];
-                        imageData[destinationOffset + 1] = tempData.get()[sourceOffset + 1];
-                        imageData[destinationOffset + 2] = tempData.get()[sourceOffset + 2];
-                        imageData[destinationOffset + 3] = 255;
-                    }
-                break;
-            }
-            case STBI_rgb_alpha:
-            {
-                pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
-                imageData.assign(tempData.get(),
-                                 tempData.get() + static_cast<std::size_t>(width * height) * 4);
-                break;
-            }
-            default:
-                throw std::runtime_error{"Unsupported pixel format"};
+            auto textureRegion = engine->getTextureAtlas().add(size, decodeImage(data, STBI_rgb_alpha));
+            if (!textureRegion)
+                throw std::runtime_error{"Texture atlas is full"};
+
+            bundle.setTextureRegion(name, textureRegion);
+
+            return true;
         }
 
-        const graphics::Image image{
-            pixelFormat,
-            math::Size<std::uint32_t, 2>{
-                static_cast<std::uint32_t>(width),
-                static_cast<std::uint32_t>(height)
-            },
-            imageData
-        };
+        // grey images stay in one or two channels if the device can sample them as grey
+        const auto luminance = (comp == STBI_grey || comp == STBI_grey_alpha) &&
+            engine->getGraphics().getDevice()->isLuminanceTexturesSupported();
+        const auto channels = luminance ? comp : STBI_rgb_alpha;
+        const auto pixelFormat = !luminance ? graphics::PixelFormat::rgba8UnsignedNorm :
+            (comp == STBI_grey) ? graphics::PixelFormat::r8UnsignedNorm : graphics::PixelFormat::rg8UnsignedNorm;
+        const auto flags = luminance ? graphics::Flags::luminance : graphics::Flags::none;
+
+        std::shared_ptr<graphics::Texture> texture;
 
-        auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
-                                                           image.getData(),
-                                                           image.getSize(),
-                                                           graphics::Flags::none,
-                                                           options.mipmaps ? 0 : 1,
-                                                           image.getPixelFormat());
+        if (options.async)
+        {
+            // decoding and mip map generation happen on a worker thread
+            texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                          size,
+                                                          [data, channels]() { return decodeImage(data, channels); },
+                                                          flags,
+                                                          options.mipmaps ? 0 : 1,
+                                                          pixelFormat);
+        }
+        else
+        {
+            const graphics::Image image{
+                pixelFormat,
+                size,
+                decodeImage(data, channels)
+            };
+
+            texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                          image.getData(),
+                                                          image.getSize(),
+                                                          flags,
+                                                          options.mipmaps ? 0 : 1,
+                                                          image.getPixelFormat());
+        }
 
         bundle.setTexture(name, texture);
 
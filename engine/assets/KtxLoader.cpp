@@ -0,0 +1,248 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include "KtxLoader.hpp"
+#include "TextureLevels.hpp"
+#include "../core/Engine.hpp"
+#include "../graphics/Texture.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        constexpr std::array<std::uint8_t, 12> ktx1Identifier{
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+
+        constexpr std::array<std::uint8_t, 12> ktx2Identifier{
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+
+        bool hasIdentifier(const std::vector<std::byte>& data,
+                           const std::array<std::uint8_t, 12>& identifier) noexcept
+        {
+            return data.size() >= identifier.size() &&
+                std::equal(identifier.begin(), identifier.end(), data.begin(),
+                           [](std::uint8_t a, std::byte b) noexcept { return a == static_cast<std::uint8_t>(b); });
+        }
+
+        graphics::PixelFormat getPixelFormatFromGl(std::uint32_t internalFormat)
+        {
+            switch (internalFormat)
+            {
+                case 0x8229: return graphics::PixelFormat::r8UnsignedNorm; // GL_R8
+                case 0x822B: return graphics::PixelFormat::rg8UnsignedNorm; // GL_RG8
+                case 0x8058: return graphics::PixelFormat::rgba8UnsignedNorm; // GL_RGBA8
+                case 0x8C43: return graphics::PixelFormat::rgba8UnsignedNormSRGB; // GL_SRGB8_ALPHA8
+                case 0x83F0: // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+                case 0x83F1: return graphics::PixelFormat::bc1RgbaUnsignedNorm; // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+                case 0x8C4C: // GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+                case 0x8C4D: return graphics::PixelFormat::bc1RgbaUnsignedNormSRGB; // GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+                case 0x83F2: return graphics::PixelFormat::bc2RgbaUnsignedNorm; // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+                case 0x8C4E: return graphics::PixelFormat::bc2RgbaUnsignedNormSRGB; // GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT
+                case 0x83F3: return graphics::PixelFormat::bc3RgbaUnsignedNorm; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+                case 0x8C4F: return graphics::PixelFormat::bc3RgbaUnsignedNormSRGB; // GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+                case 0x8DBB: return graphics::PixelFormat::bc4RUnsignedNorm; // GL_COMPRESSED_RED_RGTC1
+                case 0x8DBD: return graphics::PixelFormat::bc5RgUnsignedNorm; // GL_COMPRESSED_RG_RGTC2
+                case 0x8E8F: return graphics::PixelFormat::bc6hRgbUnsignedFloat; // GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT
+                case 0x8E8C: return graphics::PixelFormat::bc7RgbaUnsignedNorm; // GL_COMPRESSED_RGBA_BPTC_UNORM
+                case 0x8E8D: return graphics::PixelFormat::bc7RgbaUnsignedNormSRGB; // GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+                case 0x8D64: // GL_ETC1_RGB8_OES, ETC2 is a superset of ETC1
+                case 0x9274: return graphics::PixelFormat::etc2RgbUnsignedNorm; // GL_COMPRESSED_RGB8_ETC2
+                case 0x9275: return graphics::PixelFormat::etc2RgbUnsignedNormSRGB; // GL_COMPRESSED_SRGB8_ETC2
+                case 0x9278: return graphics::PixelFormat::etc2RgbaUnsignedNorm; // GL_COMPRESSED_RGBA8_ETC2_EAC
+                case 0x9279: return graphics::PixelFormat::etc2RgbaUnsignedNormSRGB; // GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+                case 0x9270: return graphics::PixelFormat::eacRUnsignedNorm; // GL_COMPRESSED_R11_EAC
+                case 0x9272: return graphics::PixelFormat::eacRgUnsignedNorm; // GL_COMPRESSED_RG11_EAC
+                case 0x93B0: return graphics::PixelFormat::astc4x4RgbaUnsignedNorm; // GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+                case 0x93D0: return graphics::PixelFormat::astc4x4RgbaUnsignedNormSRGB; // GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR
+                default: throw std::runtime_error{"Unsupported KTX pixel format"};
+            }
+        }
+
+        graphics::PixelFormat getPixelFormatFromVulkan(std::uint32_t format)
+        {
+            switch (format)
+            {
+                case 9: return graphics::PixelFormat::r8UnsignedNorm; // VK_FORMAT_R8_UNORM
+                case 16: return graphics::PixelFormat::rg8UnsignedNorm; // VK_FORMAT_R8G8_UNORM
+                case 37: return graphics::PixelFormat::rgba8UnsignedNorm; // VK_FORMAT_R8G8B8A8_UNORM
+                case 43: return graphics::PixelFormat::rgba8UnsignedNormSRGB; // VK_FORMAT_R8G8B8A8_SRGB
+                case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+                case 133: return graphics::PixelFormat::bc1RgbaUnsignedNorm; // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+                case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+                case 134: return graphics::PixelFormat::bc1RgbaUnsignedNormSRGB; // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+                case 135: return graphics::PixelFormat::bc2RgbaUnsignedNorm; // VK_FORMAT_BC2_UNORM_BLOCK
+                case 136: return graphics::PixelFormat::bc2RgbaUnsignedNormSRGB; // VK_FORMAT_BC2_SRGB_BLOCK
+                case 137: return graphics::PixelFormat::bc3RgbaUnsignedNorm; // VK_FORMAT_BC3_UNORM_BLOCK
+                case 138: return graphics::PixelFormat::bc3RgbaUnsignedNormSRGB; // VK_FORMAT_BC3_SRGB_BLOCK
+                case 139: return graphics::PixelFormat::bc4RUnsignedNorm; // VK_FORMAT_BC4_UNORM_BLOCK
+                case 141: return graphics::PixelFormat::bc5RgUnsignedNorm; // VK_FORMAT_BC5_UNORM_BLOCK
+                case 143: return graphics::PixelFormat::bc6hRgbUnsignedFloat; // VK_FORMAT_BC6H_UFLOAT_BLOCK
+                case 145: return graphics::PixelFormat::bc7RgbaUnsignedNorm; // VK_FORMAT_BC7_UNORM_BLOCK
+                case 146: return graphics::PixelFormat::bc7RgbaUnsignedNormSRGB; // VK_FORMAT_BC7_SRGB_BLOCK
+                case 147: return graphics::PixelFormat::etc2RgbUnsignedNorm; // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+                case 148: return graphics::PixelFormat::etc2RgbUnsignedNormSRGB; // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+                case 151: return graphics::PixelFormat::etc2RgbaUnsignedNorm; // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+                case 152: return graphics::PixelFormat::etc2RgbaUnsignedNormSRGB; // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+                case 153: return graphics::PixelFormat::eacRUnsignedNorm; // VK_FORMAT_EAC_R11_UNORM_BLOCK
+                case 155: return graphics::PixelFormat::eacRgUnsignedNorm; // VK_FORMAT_EAC_R11G11_UNORM_BLOCK
+                case 157: return graphics::PixelFormat::astc4x4RgbaUnsignedNorm; // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+                case 158: return graphics::PixelFormat::astc4x4RgbaUnsignedNormSRGB; // VK_FORMAT_ASTC_4x4_SRGB_BLOCK
+                default: throw std::runtime_error{"Unsupported KTX2 pixel format"};
+            }
+        }
+
+        std::vector<std::uint8_t> readLevel(const std::vector<std::byte>& data,
+                                            std::size_t offset,
+                                            std::size_t size,
+                                            graphics::PixelFormat pixelFormat,
+                                            const math::Size<std::uint32_t, 2>& levelSize)
+        {
+            if (offset > data.size() || size > data.size() - offset)
+                throw std::runtime_error{"Not enough data"};
+
+            if (size < graphics::getDataSize(pixelFormat, levelSize.v[0], levelSize.v[1]))
+                throw std::runtime_error{"Invalid mip level size"};
+
+            const auto levelData = reinterpret_cast<const std::uint8_t*>(data.data()) + offset;
+            return std::vector<std::uint8_t>(levelData, levelData + graphics::getDataSize(pixelFormat, levelSize.v[0], levelSize.v[1]));
+        }
+
+        std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> readKtx1(const std::vector<std::byte>& data,
+                                                                                                graphics::PixelFormat& pixelFormat)
+        {
+            constexpr std::size_t headerSize = 64;
+            if (data.size() < headerSize)
+                throw std::runtime_error{"Not enough data"};
+
+            const auto endianness = decodeLittleEndian<std::uint32_t>(data.data() + 12);
+            const bool bigEndian = endianness == 0x01020304;
+            if (!bigEndian && endianness != 0x04030201)
+                throw std::runtime_error{"Invalid KTX endianness"};
+
+            const auto read32 = [&data, bigEndian](std::size_t offset) {
+                if (offset + 4 > data.size())
+                    throw std::runtime_error{"Not enough data"};
+                return bigEndian ?
+                    decodeBigEndian<std::uint32_t>(data.data() + offset) :
+                    decodeLittleEndian<std::uint32_t>(data.data() + offset);
+            };
+
+            const auto internalFormat = read32(28);
+            const auto width = read32(36);
+            const auto height = read32(40);
+            const auto depth = read32(44);
+            const auto arrayElements = read32(48);
+            const auto faces = read32(52);
+            const auto levelCount = std::max(1U, read32(56));
+            const auto keyValueDataSize = read32(60);
+
+            if (depth > 1 || arrayElements > 0 || faces != 1)
+                throw std::runtime_error{"Only 2D KTX textures are supported"};
+
+            pixelFormat = getPixelFormatFromGl(internalFormat);
+
+            std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
+            std::size_t offset = headerSize + keyValueDataSize;
+
+            for (const auto& levelSize : getLevelSizes(width, height, levelCount))
+            {
+                const auto imageSize = read32(offset);
+                offset += 4;
+
+                levels.emplace_back(levelSize, readLevel(data, offset, imageSize, pixelFormat, levelSize));
+
+                offset += (imageSize + 3U) & ~3U; // mip padding
+            }
+
+            return levels;
+        }
+
+        std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> readKtx2(const std::vector<std::byte>& data,
+                                                                                                graphics::PixelFormat& pixelFormat)
+        {
+            constexpr std::size_t headerSize = 80;
+            if (data.size() < headerSize)
+                throw std::runtime_error{"Not enough data"};
+
+            const auto read32 = [&data](std::size_t offset) {
+                if (offset + 4 > data.size())
+                    throw std::runtime_error{"Not enough data"};
+                return decodeLittleEndian<std::uint32_t>(data.data() + offset);
+            };
+
+            const auto read64 = [&read32](std::size_t offset) {
+                return static_cast<std::size_t>(read32(offset)) |
+                    (static_cast<std::size_t>(static_cast<std::uint64_t>(read32(offset + 4)) << 32));
+            };
+
+            const auto vkFormat = read32(12);
+            const auto width = read32(20);
+            const auto height = read32(24);
+            const auto depth = read32(28);
+            const auto layers = read32(32);
+            const auto faces = read32(36);
+            const auto levelCount = std::max(1U, read32(40));
+            const auto supercompression = read32(44);
+
+            if (depth > 0 || layers > 0 || faces != 1)
+                throw std::runtime_error{"Only 2D KTX2 textures are supported"};
+
+            if (supercompression != 0)
+                throw std::runtime_error{"Supercompressed KTX2 textures are not supported"};
+
+            pixelFormat = getPixelFormatFromVulkan(vkFormat);
+
+            std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
+
+            const auto levelSizes = getLevelSizes(width, height, levelCount);
+
+            for (std::size_t level = 0; level < levelSizes.size(); ++level)
+            {
+                const auto indexOffset = headerSize + level * 24;
+                const auto levelOffset = read64(indexOffset);
+                const auto levelLength = read64(indexOffset + 8);
+
+                const auto& levelSize = levelSizes[level];
+                levels.emplace_back(levelSize, readLevel(data, levelOffset, levelLength, pixelFormat, levelSize));
+            }
+
+            return levels;
+        }
+    }
+
+    bool loadKtx(Cache&,
+                 Bundle& bundle,
+                 const std::string& name,
+                 const std::vector<std::byte>& data,
+                 const Asset::Options& options)
+    {
+        graphics::PixelFormat pixelFormat;
+        std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
+
+        if (hasIdentifier(data, ktx1Identifier))
+            levels = readKtx1(data, pixelFormat);
+        else if (hasIdentifier(data, ktx2Identifier))
+            levels = readKtx2(data, pixelFormat);
+        else
+            return false;
+
+        if (!options.mipmaps) levels.resize(1);
+
+        const auto size = levels.front().first;
+        const auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                                 levels,
+                                                                 size,
+                                                                 graphics::Flags::none,
+                                                                 pixelFormat);
+
+        bundle.setTexture(name, texture);
+
+        return true;
+    }
+}
@@ -0,0 +1,17 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_KTXLOADER_HPP
+#define OUZEL_ASSETS_KTXLOADER_HPP
+
+#include "Bundle.hpp"
+
+namespace ouzel::assets
+{
+    bool loadKtx(Cache& cache,
+                 Bundle& bundle,
+                 const std::string& name,
+                 const std::vector<std::byte>& data,
+                 const Asset::Options& options);
+}
+
+#endif // OUZEL_ASSETS_KTXLOADER_HPP
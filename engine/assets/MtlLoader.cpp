@@ -247,10 +247,14 @@ namespace ouzel::assets
                         auto material = std::make_unique<graphics::Material>();
                         material->blendState = cache.getBlendState(blendAlpha);
                         material->shader = diffuseTexture ? cache.getShader(shaderTexture) : cache.getShader(shaderColor);
+                        material->instancedShader = diffuseTexture ? cache.getShader(shaderTextureInstanced) : nullptr;
+                        material->litShader = diffuseTexture ? cache.getShader(shaderTextureLit) : nullptr;
                         material->textures[0] = diffuseTexture;
                         material->textures[1] = ambientTexture;
+                        material->ambientColor = ambientColor;
                         material->diffuseColor = diffuseColor;
                         material->opacity = opacity;
+                        material->opaque = opacity >= 1.0F;
                         material->cullMode = graphics::CullMode::back;
 
                         bundle.setMaterial(materialName, std::move(material));
@@ -263,6 +267,7 @@ namespace ouzel::assets
 
                     diffuseTexture.reset();
                     ambientTexture.reset();
+                    ambientColor = math::whiteColor;
                     diffuseColor = math::whiteColor;
                     opacity = 1.0F;
                 }
@@ -370,11 +375,14 @@ namespace ouzel::assets
             auto material = std::make_unique<graphics::Material>();
             material->blendState = cache.getBlendState(blendAlpha);
             material->shader = cache.getShader(shaderTexture);
+            material->instancedShader = cache.getShader(shaderTextureInstanced);
+            material->litShader = cache.getShader(shaderTextureLit);
             material->textures[0] = diffuseTexture;
             material->textures[1] = ambientTexture;
             material->ambientColor = ambientColor;
             material->diffuseColor = diffuseColor;
             material->opacity = opacity;
+            material->opaque = opacity >= 1.0F;
             material->cullMode = graphics::CullMode::back;
 
             bundle.setMaterial(materialName, std::move(material));
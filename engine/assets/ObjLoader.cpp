@@ -1,8 +1,10 @@
 // Ouzel by Elviss Strazdins
 
+#include <algorithm>
 #include <cstdlib>
 #include <map>
 #include <stdexcept>
+#include <string>
 #include <tuple>
 #include "ObjLoader.hpp"
 #include "../graphics/Material.hpp"
@@ -174,6 +176,15 @@ namespace ouzel::assets
 
             return true;
         }
+
+        struct Object final
+        {
+            std::string name;
+            math::Box<float, 3> boundingBox;
+            std::vector<std::uint32_t> indices;
+            std::vector<graphics::Vertex> vertices;
+            const graphics::Material* material;
+        };
     }
 
     bool loadObj(Cache&,
@@ -193,6 +204,7 @@ namespace ouzel::assets
         math::Box<float, 3> boundingBox;
 
         std::uint32_t objectCount = 0;
+        std::vector<Object> objects;
 
         for (auto iterator = data.cbegin(); iterator != data.end();)
         {
@@ -234,8 +246,7 @@ namespace ouzel::assets
                 {
                     if (objectCount)
                     {
-                        scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
-                        bundle.setStaticMeshData(objectName, std::move(meshData));
+                        objects.push_back(Object{objectName, boundingBox, indices, vertices, material});
                     }
 
                     skipWhiteSpaces(iterator, data.end());
@@ -389,9 +400,46 @@ namespace ouzel::assets
         }
 
         if (objectCount)
+            objects.push_back(Object{objectName, boundingBox, indices, vertices, material});
+
+        // objects named <name>_LOD<n> are the simplified levels of the object <name>
+        std::vector<std::vector<std::size_t>> levels(objects.size());
+        std::vector<bool> isLevel(objects.size());
+
+        for (std::size_t i = 0; i < objects.size(); ++i)
+            for (std::size_t level = 1;; ++level)
+            {
+                const auto levelName = objects[i].name + "_LOD" + std::to_string(level);
+                const auto levelIterator = std::find_if(objects.begin(), objects.end(),
+                                                        [&levelName](const auto& object) {
+                                                            return object.name == levelName;
+                                                        });
+                if (levelIterator == objects.end()) break;
+
+                const auto levelIndex = static_cast<std::size_t>(levelIterator - objects.begin());
+                levels[i].push_back(levelIndex);
+                isLevel[levelIndex] = true;
+            }
+
+        for (std::size_t i = 0; i < objects.size(); ++i)
         {
-            scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
-            bundle.setStaticMeshData(objectName, std::move(meshData));
+            if (isLevel[i]) continue;
+
+            const auto& object = objects[i];
+            scene::StaticMeshData meshData(object.boundingBox, object.indices, object.vertices, object.material);
+
+            // every level halves the screen size, the distances assume a field of view of 90 degrees
+            const auto radius = length(object.boundingBox.max - object.boundingBox.min) / 2.0F;
+            float screenSize = 1.0F;
+
+            for (const auto levelIndex : levels[i])
+            {
+                screenSize /= 2.0F;
+                meshData.addLod(screenSize, radius / screenSize,
+                                objects[levelIndex].indices, objects[levelIndex].vertices);
+            }
+
+            bundle.setStaticMeshData(object.name, std::move(meshData));
         }
 
         return true;
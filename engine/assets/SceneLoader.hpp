@@ -0,0 +1,25 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_SCENELOADER_HPP
+#define OUZEL_ASSETS_SCENELOADER_HPP
+
+#include <cstdint>
+#include "Bundle.hpp"
+#include "../scene/SceneData.hpp"
+
+namespace ouzel::assets
+{
+    inline bool loadScene(Cache&,
+                          Bundle& bundle,
+                          const std::string& name,
+                          const std::vector<std::byte>& data,
+                          const Asset::Options&)
+    {
+        const auto begin = reinterpret_cast<const std::uint8_t*>(data.data());
+        bundle.setSceneData(name, scene::SceneData{std::vector<std::uint8_t>(begin, begin + data.size())});
+
+        return true;
+    }
+}
+
+#endif // OUZEL_ASSETS_SCENELOADER_HPP
@@ -36,17 +36,25 @@ namespace ouzel::assets
 
         scene::SpriteData spriteData;
 
-        spriteData.texture = bundle.getTexture(imageFilename);
+        auto textureRegion = bundle.getTextureRegion(imageFilename);
+        spriteData.texture = textureRegion ? textureRegion->getTexture() : bundle.getTexture(imageFilename);
         if (!spriteData.texture)
         {
             bundle.loadAsset(Asset::Type::image, imageFilename, imageFilename, options);
-            spriteData.texture = bundle.getTexture(imageFilename);
+            textureRegion = bundle.getTextureRegion(imageFilename);
+            spriteData.texture = textureRegion ? textureRegion->getTexture() : bundle.getTexture(imageFilename);
         }
 
-        const math::Size<float, 2> textureSize{
-            static_cast<float>(spriteData.texture->getSize().v[0]),
-            static_cast<float>(spriteData.texture->getSize().v[1])
-        };
+        // frames of atlased images are built against the source image and then mapped into the region
+        const math::Size<float, 2> textureSize = textureRegion ?
+            math::Size<float, 2>{
+                static_cast<float>(textureRegion->getRectangle().size.v[0]),
+                static_cast<float>(textureRegion->getRectangle().size.v[1])
+            } :
+            math::Size<float, 2>{
+                static_cast<float>(spriteData.texture->getSize().v[0]),
+                static_cast<float>(spriteData.texture->getSize().v[1])
+            };
 
         if (spriteData.texture)
         {
@@ -72,6 +80,7 @@ namespace ouzel::assets
                 }
 
             spriteData.animations[""] = std::move(animation);
+            if (textureRegion) spriteData.setTextureRegion(textureRegion);
 
             bundle.setSpriteData(name, spriteData);
         }
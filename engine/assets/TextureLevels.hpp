@@ -0,0 +1,46 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_TEXTURELEVELS_HPP
+#define OUZEL_ASSETS_TEXTURELEVELS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "../math/Size.hpp"
+
+namespace ouzel::assets
+{
+    // number of levels in a full mip chain of a texture of the given size
+    constexpr std::uint32_t getMaxLevelCount(std::uint32_t width, std::uint32_t height) noexcept
+    {
+        std::uint32_t result = 1;
+        for (auto size = std::max(width, height); size > 1; size >>= 1) ++result;
+        return result;
+    }
+
+    // sizes of the mip levels of a texture file, throws if the size or the level count read from the file is invalid
+    inline std::vector<math::Size<std::uint32_t, 2>> getLevelSizes(std::uint32_t width,
+                                                                   std::uint32_t height,
+                                                                   std::uint32_t levelCount)
+    {
+        if (width == 0 || height == 0)
+            throw std::runtime_error{"Invalid texture size"};
+
+        if (levelCount == 0 || levelCount > getMaxLevelCount(width, height))
+            throw std::runtime_error{"Invalid mip level count"};
+
+        std::vector<math::Size<std::uint32_t, 2>> result;
+        result.reserve(levelCount);
+
+        for (std::uint32_t level = 0; level < levelCount; ++level)
+            result.push_back(math::Size<std::uint32_t, 2>{
+                std::max(1U, width >> level),
+                std::max(1U, height >> level)
+            });
+
+        return result;
+    }
+}
+
+#endif // OUZEL_ASSETS_TEXTURELEVELS_HPP
@@ -3,10 +3,15 @@
 #ifdef __APPLE__
 #  include <TargetConditionals.h>
 #endif
+#include <cassert>
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include "Setup.h"
 #include "Engine.hpp"
+#include "../graphics/empty/EmptyRenderDevice.hpp"
 #include "../scene/Scene.hpp"
 #include "../utils/Utils.hpp"
 
@@ -21,6 +26,9 @@
 #    include "opengl/ColorVSGLES3.h"
 #    include "opengl/TexturePSGLES3.h"
 #    include "opengl/TextureVSGLES3.h"
+#    include "opengl/TextureInstancedVSGLES3.h"
+#    include "opengl/TextureLitPSGLES3.h"
+#    include "opengl/TextureLitVSGLES3.h"
 #  else
 #    include "opengl/ColorPSGL2.h"
 #    include "opengl/ColorVSGL2.h"
@@ -30,10 +38,16 @@
 #    include "opengl/ColorVSGL3.h"
 #    include "opengl/TexturePSGL3.h"
 #    include "opengl/TextureVSGL3.h"
+#    include "opengl/TextureInstancedVSGL3.h"
+#    include "opengl/TextureLitPSGL3.h"
+#    include "opengl/TextureLitVSGL3.h"
 #    include "opengl/ColorPSGL4.h"
 #    include "opengl/ColorVSGL4.h"
 #    include "opengl/TexturePSGL4.h"
 #    include "opengl/TextureVSGL4.h"
+#    include "opengl/TextureInstancedVSGL4.h"
+#    include "opengl/TextureLitPSGL4.h"
+#    include "opengl/TextureLitVSGL4.h"
 #  endif
 #endif
 
@@ -79,6 +93,52 @@ namespace ouzel::core
 {
     namespace
     {
+        // the per instance transform and color come from the instance buffer
+        std::unique_ptr<graphics::Shader> createTextureInstancedShader(graphics::Graphics& graphics,
+                                                                       const std::vector<std::uint8_t>& fragmentShader,
+                                                                       const std::vector<std::uint8_t>& vertexShader)
+        {
+            return std::make_unique<graphics::Shader>(graphics,
+                                                      fragmentShader,
+                                                      vertexShader,
+                                                      std::set<graphics::Vertex::Attribute::Semantic>{
+                                                          {graphics::Vertex::Attribute::Usage::position},
+                                                          {graphics::Vertex::Attribute::Usage::color},
+                                                          {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U},
+                                                          {graphics::Vertex::Attribute::Usage::instanceTransform, 0U},
+                                                          {graphics::Vertex::Attribute::Usage::instanceTransform, 1U},
+                                                          {graphics::Vertex::Attribute::Usage::instanceTransform, 2U},
+                                                          {graphics::Vertex::Attribute::Usage::instanceTransform, 3U},
+                                                          {graphics::Vertex::Attribute::Usage::instanceColor}
+                                                      },
+                                                      std::vector<std::pair<std::string, graphics::DataType>>{
+                                                          {"color", graphics::DataType::float32Vector4}
+                                                      },
+                                                      std::vector<std::pair<std::string, graphics::DataType>>{
+                                                          {"viewProj", graphics::DataType::float32Matrix4}
+                                                      });
+        }
+
+        // std::stoul would accept signs and trailing characters and throw exceptions that don't name the argument
+        std::uint32_t parseCount(const std::string& value, const std::string& name)
+        {
+            if (value.empty() || !std::all_of(value.begin(), value.end(), [](char c) noexcept { return c >= '0' && c <= '9'; }))
+                throw std::runtime_error{"Invalid " + name + " \"" + value + "\""};
+
+            try
+            {
+                const auto result = std::stoul(value);
+                if (result > std::numeric_limits<std::uint32_t>::max())
+                    throw std::out_of_range{"Count out of range"};
+
+                return static_cast<std::uint32_t>(result);
+            }
+            catch (const std::out_of_range&)
+            {
+                throw std::runtime_error{"Invalid " + name + " \"" + value + "\""};
+            }
+        }
+
         Settings parseSettings(const ini::Data& defaultSettings,
                                const ini::Data& userSettings)
         {
@@ -117,6 +177,24 @@ namespace ouzel::core
             const auto& maxAnisotropyValue = userEngineSection.getValue("maxAnisotropy", defaultEngineSection.getValue("maxAnisotropy"));
             if (!maxAnisotropyValue.empty()) settings.graphicsSettings.maxAnisotropy = static_cast<std::uint32_t>(std::stoul(maxAnisotropyValue));
 
+            const auto& emptyFrameRateValue = userEngineSection.getValue("emptyFrameRate", defaultEngineSection.getValue("emptyFrameRate"));
+            if (!emptyFrameRateValue.empty()) settings.graphicsSettings.emptyFrameRate = static_cast<std::uint32_t>(std::stoul(emptyFrameRateValue));
+
+            const auto& framesInFlightValue = userEngineSection.getValue("framesInFlight", defaultEngineSection.getValue("framesInFlight"));
+            if (!framesInFlightValue.empty()) settings.graphicsSettings.framesInFlight = static_cast<std::uint32_t>(std::stoul(framesInFlightValue));
+
+            const auto& adaptiveFramePacingValue = userEngineSection.getValue("adaptiveFramePacing", defaultEngineSection.getValue("adaptiveFramePacing"));
+            if (!adaptiveFramePacingValue.empty()) settings.adaptiveFramePacing = (adaptiveFramePacingValue == "true" || adaptiveFramePacingValue == "1" || adaptiveFramePacingValue == "yes");
+
+            const auto& textureUploadBudgetValue = userEngineSection.getValue("textureUploadBudget", defaultEngineSection.getValue("textureUploadBudget"));
+            if (!textureUploadBudgetValue.empty()) settings.graphicsSettings.textureUploadBudget = static_cast<std::uint32_t>(std::stoul(textureUploadBudgetValue));
+
+            const auto& frameCaptureValue = userEngineSection.getValue("frameCapture", defaultEngineSection.getValue("frameCapture"));
+            if (!frameCaptureValue.empty()) settings.graphicsSettings.frameCapture = (frameCaptureValue == "true" || frameCaptureValue == "1" || frameCaptureValue == "yes");
+
+            const auto& shaderCacheValue = userEngineSection.getValue("shaderCache", defaultEngineSection.getValue("shaderCache"));
+            if (!shaderCacheValue.empty()) settings.shaderCache = (shaderCacheValue == "true" || shaderCacheValue == "1" || shaderCacheValue == "yes");
+
             const auto& resizableValue = userEngineSection.getValue("resizable", defaultEngineSection.getValue("resizable"));
             if (!resizableValue.empty()) settings.resizable = (resizableValue == "true" || resizableValue == "1" || resizableValue == "yes");
 
@@ -152,11 +230,60 @@ namespace ouzel::core
             return settings;
         }
 
-        auto getSettings(storage::FileSystem& fileSystem)
+        auto getSettings(storage::FileSystem& fileSystem, const std::vector<std::string>& args)
         {
             const auto settingsPath = fileSystem.getStorageDirectory() / "settings.ini";
-            return parseSettings(fileSystem.resourceFileExists("settings.ini") ? ini::parse(fileSystem.readFile("settings.ini")) : ini::Data{},
-                                                fileSystem.fileExists(settingsPath) ? ini::parse(fileSystem.readFile(settingsPath)) : ini::Data{});
+            auto settings = parseSettings(fileSystem.resourceFileExists("settings.ini") ? ini::parse(fileSystem.readFile("settings.ini")) : ini::Data{},
+                                          fileSystem.fileExists(settingsPath) ? ini::parse(fileSystem.readFile(settingsPath)) : ini::Data{});
+
+            for (auto i = args.begin(); i != args.end(); ++i)
+                if (*i == "--benchmark")
+                {
+                    if (++i == args.end())
+                        throw std::runtime_error{"Missing the benchmark frame count"};
+
+                    // benchmarks measure only the CPU side, so nothing is rendered or played
+                    settings.benchmarkFrames = parseCount(*i, "benchmark frame count");
+                    settings.graphicsDriver = graphics::Driver::empty;
+                    settings.audioDriver = audio::Driver::empty;
+                }
+                else if (*i == "--capture")
+                {
+                    if (++i == args.end())
+                        throw std::runtime_error{"Missing the capture file"};
+
+                    settings.captureFile = *i;
+
+                    if (++i == args.end())
+                        throw std::runtime_error{"Missing the capture frame"};
+
+                    settings.captureFrame = parseCount(*i, "capture frame");
+                    settings.graphicsSettings.frameCapture = true;
+                }
+                else if (*i == "--replay")
+                {
+                    if (++i == args.end())
+                        throw std::runtime_error{"Missing the replay file"};
+
+                    settings.replayFile = *i;
+
+                    if (++i == args.end())
+                        throw std::runtime_error{"Missing the replay loop count"};
+
+                    settings.replayLoops = parseCount(*i, "replay loop count");
+                }
+
+            if (settings.shaderCache)
+                settings.graphicsSettings.shaderCacheDirectory = fileSystem.getStorageDirectory() / "shaders";
+
+            return settings;
+        }
+
+        template <class Duration>
+        auto getPercentile(const std::vector<Duration>& sortedValues, std::size_t percentile)
+        {
+            const auto index = (sortedValues.size() - 1) * percentile / 100;
+            return std::chrono::duration_cast<std::chrono::microseconds>(sortedValues[index]).count();
         }
 
         auto getWindowFlags(const Settings& settings) noexcept
@@ -170,15 +297,36 @@ namespace ouzel::core
 
     Engine::Engine(const std::vector<std::string>& initArgs):
         fileSystem{*this},
-        settings{getSettings(fileSystem)},
+        settings{getSettings(fileSystem, initArgs)},
         window{settings.size, getWindowFlags(settings), OUZEL_APPLICATION_NAME, settings.graphicsDriver},
         graphics{settings.graphicsDriver, window, settings.graphicsSettings},
+        textureAtlas{graphics, math::Size<std::uint32_t, 2>{2048, 2048}, 4, 3},
         audio{settings.audioDriver, settings.audioSettings},
         assetBundle(cache, fileSystem),
         args{initArgs}
     {
         engine = this;
 
+        if (settings.benchmarkFrames)
+        {
+            oneUpdatePerFrame = true;
+            frameTimings.reserve(settings.benchmarkFrames);
+        }
+
+        // the layer fills the cluster constants, see LightClusters
+        const std::vector<std::pair<std::string, graphics::DataType>> litFragmentShaderConstants{
+            {"color", graphics::DataType::float32Vector4},
+            {"ambientColor", graphics::DataType::float32Vector4},
+            {"clusterGrid", graphics::DataType::float32Vector4},
+            {"clusterViewport", graphics::DataType::float32Vector4},
+            {"clusterDepth", graphics::DataType::float32Vector4}
+        };
+
+        const std::vector<std::pair<std::string, graphics::DataType>> litVertexShaderConstants{
+            {"modelViewProj", graphics::DataType::float32Matrix4},
+            {"modelView", graphics::DataType::float32Matrix4}
+        };
+
         // default assets
         switch (settings.graphicsDriver)
         {
@@ -288,6 +436,97 @@ namespace ouzel::core
 
                 assetBundle.setShader(shaderTexture, std::move(textureShader));
 
+                if (graphics.getDevice()->isInstancingSupported())
+                {
+                    std::unique_ptr<graphics::Shader> textureInstancedShader;
+
+                    switch (graphics.getDevice()->getAPIMajorVersion())
+                    {
+#  if OUZEL_OPENGLES
+                        case 3:
+                            textureInstancedShader = createTextureInstancedShader(graphics,
+                                                                                  std::vector<std::uint8_t>(std::begin(TexturePSGLES3_glsl), std::end(TexturePSGLES3_glsl)),
+                                                                                  std::vector<std::uint8_t>(std::begin(TextureInstancedVSGLES3_glsl), std::end(TextureInstancedVSGLES3_glsl)));
+                            break;
+#  else
+                        case 3:
+                            textureInstancedShader = createTextureInstancedShader(graphics,
+                                                                                  std::vector<std::uint8_t>(std::begin(TexturePSGL3_glsl), std::end(TexturePSGL3_glsl)),
+                                                                                  std::vector<std::uint8_t>(std::begin(TextureInstancedVSGL3_glsl), std::end(TextureInstancedVSGL3_glsl)));
+                            break;
+                        case 4:
+                            textureInstancedShader = createTextureInstancedShader(graphics,
+                                                                                  std::vector<std::uint8_t>(std::begin(TexturePSGL4_glsl), std::end(TexturePSGL4_glsl)),
+                                                                                  std::vector<std::uint8_t>(std::begin(TextureInstancedVSGL4_glsl), std::end(TextureInstancedVSGL4_glsl)));
+                            break;
+#  endif
+                        default: // instanced shaders need GLSL 3.30 or GLSL ES 3.00
+                            break;
+                    }
+
+                    if (textureInstancedShader)
+                        assetBundle.setShader(shaderTextureInstanced, std::move(textureInstancedShader));
+                }
+
+                std::unique_ptr<graphics::Shader> textureLitShader;
+
+                switch (graphics.getDevice()->getAPIMajorVersion())
+                {
+#  if OUZEL_OPENGLES
+                    case 3:
+                        textureLitShader = std::make_unique<graphics::Shader>(graphics,
+                                                                              std::vector<std::uint8_t>(std::begin(TextureLitPSGLES3_glsl),
+                                                                                                        std::end(TextureLitPSGLES3_glsl)),
+                                                                              std::vector<std::uint8_t>(std::begin(TextureLitVSGLES3_glsl),
+                                                                                                        std::end(TextureLitVSGLES3_glsl)),
+                                                                              std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                                  {graphics::Vertex::Attribute::Usage::position},
+                                                                                  {graphics::Vertex::Attribute::Usage::color},
+                                                                                  {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U},
+                                                                                  {graphics::Vertex::Attribute::Usage::normal}
+                                                                              },
+                                                                              litFragmentShaderConstants,
+                                                                              litVertexShaderConstants);
+                        break;
+#  else
+                    case 3:
+                        textureLitShader = std::make_unique<graphics::Shader>(graphics,
+                                                                              std::vector<std::uint8_t>(std::begin(TextureLitPSGL3_glsl),
+                                                                                                        std::end(TextureLitPSGL3_glsl)),
+                                                                              std::vector<std::uint8_t>(std::begin(TextureLitVSGL3_glsl),
+                                                                                                        std::end(TextureLitVSGL3_glsl)),
+                                                                              std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                                  {graphics::Vertex::Attribute::Usage::position},
+                                                                                  {graphics::Vertex::Attribute::Usage::color},
+                                                                                  {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U},
+                                                                                  {graphics::Vertex::Attribute::Usage::normal}
+                                                                              },
+                                                                              litFragmentShaderConstants,
+                                                                              litVertexShaderConstants);
+                        break;
+                    case 4:
+                        textureLitShader = std::make_unique<graphics::Shader>(graphics,
+                                                                              std::vector<std::uint8_t>(std::begin(TextureLitPSGL4_glsl),
+                                                                                                        std::end(TextureLitPSGL4_glsl)),
+                                                                              std::vector<std::uint8_t>(std::begin(TextureLitVSGL4_glsl),
+                                                                                                        std::end(TextureLitVSGL4_glsl)),
+                                                                              std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                                  {graphics::Vertex::Attribute::Usage::position},
+                                                                                  {graphics::Vertex::Attribute::Usage::color},
+                                                                                  {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U},
+                                                                                  {graphics::Vertex::Attribute::Usage::normal}
+                                                                              },
+                                                                              litFragmentShaderConstants,
+                                                                              litVertexShaderConstants);
+                        break;
+#  endif
+                    default: // lit shaders read the light data with texelFetch, which needs GLSL 3.30 or GLSL ES 3.00
+                        break;
+                }
+
+                if (textureLitShader)
+                    assetBundle.setShader(shaderTextureLit, std::move(textureLitShader));
+
                 std::unique_ptr<graphics::Shader> colorShader;
 
                 switch (graphics.getDevice()->getAPIMajorVersion())
@@ -428,6 +667,14 @@ namespace ouzel::core
                                                                       });
 
                 assetBundle.setShader(shaderColor, std::move(colorShader));
+
+                // there is no Direct3D 11 variant of the instanced shader yet, so static meshes are not instanced
+                log(Log::Level::info) << "Instanced drawing is not used with Direct3D 11";
+
+                // the lit shaders exist only in GLSL, without shaderTextureLit the layers don't bin their lights
+                // and the materials are drawn unlit
+                assert(!assetBundle.getShader(shaderTextureLit));
+                log(Log::Level::info) << "Layer lights are not applied with Direct3D 11";
                 break;
             }
 #endif
@@ -473,6 +720,14 @@ namespace ouzel::core
                                                                       "mainPS", "mainVS");
 
                 assetBundle.setShader(shaderColor, std::move(colorShader));
+
+                // there is no Metal variant of the instanced shader yet, so static meshes are not instanced
+                log(Log::Level::info) << "Instanced drawing is not used with Metal";
+
+                // the lit shaders exist only in GLSL, without shaderTextureLit the layers don't bin their lights
+                // and the materials are drawn unlit
+                assert(!assetBundle.getShader(shaderTextureLit));
+                log(Log::Level::info) << "Layer lights are not applied with Metal";
                 break;
             }
 #endif
@@ -496,6 +751,25 @@ namespace ouzel::core
 
                 assetBundle.setShader(shaderTexture, std::move(textureShader));
 
+                // the empty and software render devices support instancing
+                auto textureInstancedShader = createTextureInstancedShader(graphics, {}, {});
+
+                assetBundle.setShader(shaderTextureInstanced, std::move(textureInstancedShader));
+
+                auto textureLitShader = std::make_unique<graphics::Shader>(graphics,
+                                                                           std::vector<std::uint8_t>(),
+                                                                           std::vector<std::uint8_t>(),
+                                                                           std::set<graphics::Vertex::Attribute::Semantic>{
+                                                                               {graphics::Vertex::Attribute::Usage::position},
+                                                                               {graphics::Vertex::Attribute::Usage::color},
+                                                                               {graphics::Vertex::Attribute::Usage::textureCoordinates, 0U},
+                                                                               {graphics::Vertex::Attribute::Usage::normal}
+                                                                           },
+                                                                           litFragmentShaderConstants,
+                                                                           litVertexShaderConstants);
+
+                assetBundle.setShader(shaderTextureLit, std::move(textureLitShader));
+
                 auto colorShader = std::make_unique<graphics::Shader>(graphics,
                                                                       std::vector<std::uint8_t>(),
                                                                       std::vector<std::uint8_t>(),
@@ -570,6 +844,18 @@ namespace ouzel::core
 
         assetBundle.setBlendState(blendScreen, std::move(screenBlendState));
 
+        auto noColorBlendState = std::make_unique<graphics::BlendState>(graphics,
+                                                                        false,
+                                                                        graphics::BlendFactor::one,
+                                                                        graphics::BlendFactor::zero,
+                                                                        graphics::BlendOperation::add,
+                                                                        graphics::BlendFactor::one,
+                                                                        graphics::BlendFactor::zero,
+                                                                        graphics::BlendOperation::add,
+                                                                        graphics::ColorMask::none);
+
+        assetBundle.setBlendState(blendNoColor, std::move(noColorBlendState));
+
         auto whitePixelTexture = std::make_shared<graphics::Texture>(graphics,
                                                                      std::vector<std::uint8_t>{255, 255, 255, 255},
                                                                      math::Size<std::uint32_t, 2>{1U, 1U},
@@ -655,12 +941,38 @@ namespace ouzel::core
 
     void Engine::update()
     {
+        auto updateStartTime = std::chrono::steady_clock::now();
+
+        bool drawFrame = refillRenderQueue;
+        if (drawFrame && settings.adaptiveFramePacing && !settings.benchmarkFrames &&
+            updateStartTime < pacedFrameStartTime)
+        {
+            if (oneUpdatePerFrame)
+            {
+                std::this_thread::sleep_until(pacedFrameStartTime);
+                updateStartTime = std::chrono::steady_clock::now();
+            }
+            else
+                drawFrame = false; // keep updating, a later update draws the frame
+        }
+
         eventDispatcher.dispatchEvents();
 
         const auto currentTime = std::chrono::steady_clock::now();
         auto diff = currentTime - previousUpdateTime;
 
-        if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
+        if (settings.benchmarkFrames)
+        {
+            // a fixed delta makes the simulation, and therefore the measured work, the same on every run
+            auto updateEvent = std::make_unique<UpdateEvent>();
+            updateEvent->type = Event::Type::update;
+            updateEvent->delta = 1.0F / 60.0F;
+            updateTime += 1.0 / 60.0;
+            eventDispatcher.dispatchEvent(std::move(updateEvent));
+
+            animationSystem.update(1.0F / 60.0F);
+        }
+        else if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
         {
             if (diff > std::chrono::milliseconds(1000 / 20))
                 diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
@@ -671,20 +983,141 @@ namespace ouzel::core
             auto updateEvent = std::make_unique<UpdateEvent>();
             updateEvent->type = Event::Type::update;
             updateEvent->delta = delta;
+            updateTime += static_cast<double>(delta);
             eventDispatcher.dispatchEvent(std::move(updateEvent));
+
+            animationSystem.update(delta);
         }
 
         inputManager.update();
         handleEvents(window.getEvents(false));
         audio.update();
 
-        if (refillRenderQueue)
+        if (drawFrame)
         {
+            const auto drawStartTime = std::chrono::steady_clock::now();
+            const auto frameCount = graphics.getFrameCount();
+
+            if (!settings.captureFile.empty() && frameCount >= settings.captureFrame)
+            {
+                graphics.captureFrames(settings.captureFile);
+                settings.captureFile.clear();
+            }
+
+            graphics.setInputTime(updateStartTime);
+            textureAtlas.flush();
             sceneManager.draw();
             refillRenderQueue = false;
+
+            const auto currentFrameDuration = std::chrono::steady_clock::now() - updateStartTime;
+            frameDuration = (frameDuration == std::chrono::steady_clock::duration::zero()) ?
+                currentFrameDuration : (frameDuration * 7 + currentFrameDuration) / 8;
+
+            if (settings.benchmarkFrames)
+            {
+                // keep the render device producing frames even if there is no scene to draw
+                if (graphics.getFrameCount() == frameCount)
+                    graphics.present();
+
+                FrameTiming frameTiming;
+                frameTiming.update = drawStartTime - updateStartTime;
+                frameTiming.submit = graphics.getPresentDuration();
+                frameTiming.draw = std::chrono::steady_clock::now() - drawStartTime - frameTiming.submit;
+                frameTimings.push_back(frameTiming);
+
+                if (frameTimings.size() >= settings.benchmarkFrames)
+                {
+                    logBenchmarkResults();
+                    exit();
+                    return;
+                }
+            }
         }
 
-        refillRenderQueue = graphics.getRefillQueue(oneUpdatePerFrame);
+        if (!refillRenderQueue)
+        {
+            refillRenderQueue = graphics.getRefillQueue(oneUpdatePerFrame);
+
+            // the render device needs the next frame after it finishes the queued ones, so start it
+            // just early enough to be done by then, leaving a margin for the variance of the frame duration
+            if (refillRenderQueue && settings.adaptiveFramePacing)
+            {
+                constexpr auto margin = std::chrono::milliseconds(2);
+                pacedFrameStartTime = graphics.getLastFrameTime() +
+                    graphics.getFrameInterval() * static_cast<std::int64_t>(graphics.getQueuedFrameCount()) -
+                    frameDuration - margin;
+            }
+        }
+    }
+
+    void Engine::logBenchmarkResults() const
+    {
+        const auto logTimings = [this](const char* name, auto getDuration) {
+            std::vector<std::chrono::steady_clock::duration> durations;
+            durations.reserve(frameTimings.size());
+            for (const auto& frameTiming : frameTimings)
+                durations.push_back(getDuration(frameTiming));
+
+            std::sort(durations.begin(), durations.end());
+
+            log(Log::Level::info) << name << " (us): p50 " << getPercentile(durations, 50) <<
+                ", p90 " << getPercentile(durations, 90) <<
+                ", p99 " << getPercentile(durations, 99) <<
+                ", max " << getPercentile(durations, 100);
+        };
+
+        log(Log::Level::info) << "Benchmark finished after " << frameTimings.size() << " frames";
+
+        logTimings("update", [](const FrameTiming& frameTiming) { return frameTiming.update; });
+        logTimings("draw", [](const FrameTiming& frameTiming) { return frameTiming.draw; });
+        logTimings("submit", [](const FrameTiming& frameTiming) { return frameTiming.submit; });
+
+        const auto frameStats = graphics.getDevice()->getFrameStats();
+        log(Log::Level::info) << "Last frame: " << frameStats.drawCallCount << " draw calls, " <<
+            frameStats.triangleCount << " triangles, " <<
+            frameStats.pipelineStateChanges << " pipeline changes, " <<
+            frameStats.textureChanges << " texture changes, " <<
+            frameStats.bufferBytesUploaded + frameStats.textureBytesUploaded << " bytes uploaded";
+
+        if (graphics.getDevice()->getDriver() == graphics::Driver::empty)
+        {
+            const auto renderDevice = static_cast<const graphics::empty::RenderDevice*>(graphics.getDevice());
+            const auto stats = renderDevice->getStats();
+
+            log(Log::Level::info) << "Render device consumed " << stats.frameCount << " frames, " <<
+                stats.errorCount << " invalid commands";
+
+            for (std::size_t i = 0; i < graphics::empty::RenderDevice::commandTypeCount; ++i)
+                if (stats.commandCounts[i])
+                {
+                    const auto type = static_cast<graphics::Command::Type>(i);
+                    log(Log::Level::info) << std::string{graphics::empty::RenderDevice::getCommandName(type)} << ": " <<
+                        stats.commandCounts[i] << " commands, " << stats.commandBytes[i] << " bytes";
+                }
+        }
+    }
+
+    void Engine::replayFrames()
+    {
+        const auto data = fileSystem.readFile(settings.replayFile);
+        const graphics::FrameReplay replay{std::vector<std::uint8_t>(reinterpret_cast<const std::uint8_t*>(data.data()),
+                                                                     reinterpret_cast<const std::uint8_t*>(data.data()) + data.size())};
+
+        log(Log::Level::info) << "Replaying " << replay.getFrameCount() << " frames " << settings.replayLoops << " times";
+
+        const auto result = replay.run(*graphics.getDevice(), settings.replayLoops);
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(result.duration).count();
+
+        log(Log::Level::info) << "Replay finished after " << result.frameCount << " frames in " << duration << " us";
+
+        for (std::size_t i = 0; i < graphics::RenderDevice::commandTypeCount; ++i)
+            if (result.commandTimings.counts[i])
+            {
+                const auto type = static_cast<graphics::Command::Type>(i);
+                const auto commandDuration = std::chrono::duration_cast<std::chrono::microseconds>(result.commandTimings.durations[i]).count();
+                log(Log::Level::info) << std::string{graphics::RenderDevice::getCommandName(type)} << ": " <<
+                    result.commandTimings.counts[i] << " commands, " << commandDuration << " us";
+            }
     }
 
     void Engine::executeOnMainThread(const std::function<void()>& func)
@@ -696,6 +1129,13 @@ namespace ouzel::core
     {
         try
         {
+            if (!settings.replayFile.empty())
+            {
+                replayFrames();
+                exit();
+                return;
+            }
+
             std::unique_ptr<Application> application = ouzel::main(args);
 
 #ifndef __EMSCRIPTEN__
@@ -14,9 +14,11 @@
 #include "Window.hpp"
 #include "WorkerPool.hpp"
 #include "../graphics/Graphics.hpp"
+#include "../graphics/TextureAtlas.hpp"
 #include "../audio/Audio.hpp"
 #include "../events/EventDispatcher.hpp"
 #include "../input/InputManager.hpp"
+#include "../scene/AnimationSystem.hpp"
 #include "../scene/SceneManager.hpp"
 #include "../storage/FileSystem.hpp"
 #include "../assets/Bundle.hpp"
@@ -42,6 +44,13 @@ namespace ouzel::core
         bool highDpi = true; // should high DPI resolution be used
         audio::Driver audioDriver;
         audio::Settings audioSettings;
+        bool shaderCache = true; // store the compiled shader programs in the storage directory
+        bool adaptiveFramePacing = false; // delay the updates so that the input is sampled as close to the present as possible
+        std::uint32_t benchmarkFrames = 0; // run this many frames headless with a fixed delta and log the timings
+        std::string captureFile; // capture a frame to this file after captureFrame frames
+        std::uint32_t captureFrame = 0;
+        std::string replayFile; // replay a frame capture replayLoops times instead of running the application
+        std::uint32_t replayLoops = 0;
     };
 
     class Engine
@@ -71,12 +80,18 @@ namespace ouzel::core
         [[nodiscard]] auto& getGraphics() noexcept { return graphics; }
         [[nodiscard]] auto& getGraphics() const noexcept { return graphics; }
 
+        [[nodiscard]] auto& getTextureAtlas() noexcept { return textureAtlas; }
+        [[nodiscard]] auto& getTextureAtlas() const noexcept { return textureAtlas; }
+
         [[nodiscard]] auto& getAudio() noexcept { return audio; }
         [[nodiscard]] auto& getAudio() const noexcept { return audio; }
 
         [[nodiscard]] auto& getSceneManager() noexcept { return sceneManager; }
         [[nodiscard]] auto& getSceneManager() const noexcept { return sceneManager; }
 
+        [[nodiscard]] auto& getAnimationSystem() noexcept { return animationSystem; }
+        [[nodiscard]] auto& getAnimationSystem() const noexcept { return animationSystem; }
+
         [[nodiscard]] auto& getInputManager() noexcept { return inputManager; }
         [[nodiscard]] auto& getInputManager() const noexcept { return inputManager; }
 
@@ -86,6 +101,8 @@ namespace ouzel::core
         [[nodiscard]] auto& getNetwork() noexcept { return network; }
         [[nodiscard]] auto& getNetwork() const noexcept { return network; }
 
+        [[nodiscard]] auto& getWorkerPool() noexcept { return workerPool; }
+
         void start();
         void pause();
         void resume();
@@ -106,6 +123,12 @@ namespace ouzel::core
         [[nodiscard]] bool isOneUpdatePerFrame() const noexcept { return oneUpdatePerFrame; }
         void setOneUpdatePerFrame(bool value) noexcept { oneUpdatePerFrame = value; }
 
+        // time from sampling the input to the presentation of the frame that used it
+        [[nodiscard]] auto getInputLatency() const noexcept { return graphics.getInputLatency(); }
+
+        // sum of the update deltas in seconds, advances with the fixed delta in benchmarks
+        [[nodiscard]] auto getUpdateTime() const noexcept { return updateTime; }
+
     protected:
         class Command final
         {
@@ -130,23 +153,39 @@ namespace ouzel::core
         EventDispatcher eventDispatcher;
         Window window;
         graphics::Graphics graphics;
+        graphics::TextureAtlas textureAtlas;
         audio::Audio audio;
         input::InputManager inputManager;
         Localization localization;
         assets::Cache cache;
         assets::Bundle assetBundle;
+        scene::AnimationSystem animationSystem;
         scene::SceneManager sceneManager;
         network::Network network;
         WorkerPool workerPool;
 
     private:
+        struct FrameTiming final
+        {
+            std::chrono::steady_clock::duration update{};
+            std::chrono::steady_clock::duration draw{};
+            std::chrono::steady_clock::duration submit{};
+        };
+
         void handleEvents(std::queue<std::unique_ptr<Event>> windowEvents);
+        void logBenchmarkResults() const;
+        void replayFrames();
+
         std::vector<std::string> args;
+        std::vector<FrameTiming> frameTimings;
 
 #ifndef __EMSCRIPTEN__
         thread::Thread updateThread;
 #endif
         std::chrono::steady_clock::time_point previousUpdateTime;
+        double updateTime = 0.0;
+        std::chrono::steady_clock::duration frameDuration{}; // average time from the start of an update to the present
+        std::chrono::steady_clock::time_point pacedFrameStartTime; // when the next frame should start with adaptive pacing
 
         std::atomic_bool active{false};
         std::atomic_bool paused{false};
@@ -160,6 +199,8 @@ namespace ouzel::core
 namespace ouzel
 {
     const std::string shaderTexture = "shaderTexture";
+    const std::string shaderTextureInstanced = "shaderTextureInstanced";
+    const std::string shaderTextureLit = "shaderTextureLit";
     const std::string shaderColor = "shaderColor";
 
     const std::string blendNoBlend = "blendNoBlend";
@@ -167,6 +208,7 @@ namespace ouzel
     const std::string blendMultiply = "blendMultiply";
     const std::string blendAlpha = "blendAlpha";
     const std::string blendScreen = "blendScreen";
+    const std::string blendNoColor = "blendNoColor"; // writes only depth
 
     const std::string textureWhitePixel = "textureWhitePixel";
 
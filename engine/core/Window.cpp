@@ -31,7 +31,8 @@ namespace ouzel::core
             (flags & Flags::resizable) == Flags::resizable,
             (flags & Flags::fullscreen) == Flags::fullscreen,
             (flags & Flags::exclusiveFullscreen) == Flags::exclusiveFullscreen,
-            newTitle
+            newTitle,
+            graphicsDriver
         },
 #elif defined(_WIN32)
         nativeWindow{
@@ -117,7 +117,7 @@ namespace ouzel::core
 
             while (!taskGroup.taskQueue.empty())
             {
-                taskQueue.push(std::pair(std::move(promise),
+                taskQueue.push(std::pair(promise,
                                          std::move(taskGroup.taskQueue.front())));
                 taskGroup.taskQueue.pop();
             }
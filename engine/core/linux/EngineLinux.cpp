@@ -273,14 +273,18 @@ namespace ouzel::core::linux
         core::Engine{args}
     {
 #if OUZEL_SUPPORTS_X11
-        XSetErrorHandler(errorHandler);
+        // the empty driver has no window, so it runs without an X server (e.g. for benchmarks)
+        if (settings.graphicsDriver != graphics::Driver::empty)
+        {
+            XSetErrorHandler(errorHandler);
 
-        // open a connection to the X server
-        display = XOpenDisplay(nullptr);
-        if (!display)
-            throw std::system_error{getLastError(), platform::x11::errorCategory, "Failed to open display"};
+            // open a connection to the X server
+            display = XOpenDisplay(nullptr);
+            if (!display)
+                throw std::system_error{getLastError(), platform::x11::errorCategory, "Failed to open display"};
 
-        executeAtom = XInternAtom(display, "OUZEL_EXECUTE", False);
+            executeAtom = XInternAtom(display, "OUZEL_EXECUTE", False);
+        }
 
 #elif OUZEL_SUPPORTS_DISPMANX
         bcm_host_init();
@@ -310,6 +314,19 @@ namespace ouzel::core::linux
         auto& inputSystem = inputManager.getInputSystem();
 
 #if OUZEL_SUPPORTS_X11
+        if (!display)
+        {
+            while (isActive())
+            {
+                executeAll();
+
+                inputSystem.update();
+            }
+
+            exit();
+            return;
+        }
+
         auto& windowLinux = window.getNativeWindow();
 
         int xInputOpCode = 0;
@@ -513,6 +530,13 @@ namespace ouzel::core::linux
     void Engine::runOnMainThread(const std::function<void()>& func)
     {
 #if OUZEL_SUPPORTS_X11
+        if (!display)
+        {
+            std::scoped_lock lock{executeMutex};
+            executeQueue.push(func);
+            return;
+        }
+
         const auto& windowLinux = window.getNativeWindow();
 
         XEvent event;
@@ -552,9 +576,10 @@ namespace ouzel::core::linux
         core::Engine::setScreenSaverEnabled(newScreenSaverEnabled);
 
 #if OUZEL_SUPPORTS_X11
-        executeOnMainThread([this, newScreenSaverEnabled]() {
-            XScreenSaverSuspend(display, !newScreenSaverEnabled);
-        });
+        if (display)
+            executeOnMainThread([this, newScreenSaverEnabled]() {
+                XScreenSaverSuspend(display, !newScreenSaverEnabled);
+            });
 #endif
     }
 
@@ -24,7 +24,8 @@ namespace ouzel::core::linux
                                bool newResizable,
                                bool newFullscreen,
                                bool newExclusiveFullscreen,
-                               const std::string& newTitle):
+                               const std::string& newTitle,
+                               [[maybe_unused]] graphics::Driver graphicsDriver):
         core::NativeWindow{
             newSize,
             newResizable,
@@ -35,6 +36,18 @@ namespace ouzel::core::linux
         }
     {
 #if OUZEL_SUPPORTS_X11
+        constexpr std::uint32_t defaultWidth = 800U;
+        constexpr std::uint32_t defaultHeight = 600U;
+
+        // nothing is presented with the empty driver, so it runs without an X server
+        if (graphicsDriver == graphics::Driver::empty)
+        {
+            if (size.v[0] == 0) size.v[0] = defaultWidth;
+            if (size.v[1] == 0) size.v[1] = defaultHeight;
+            resolution = size;
+            return;
+        }
+
         const auto engineLinux = static_cast<Engine*>(engine);
         display = engineLinux->getDisplay();
 
@@ -58,9 +71,6 @@ namespace ouzel::core::linux
                 break;
             }
 
-        constexpr std::uint32_t defaultWidth = 800U;
-        constexpr std::uint32_t defaultHeight = 600U;
-
         if (size.v[0] <= 0.0F) size.v[0] = primaryMonitor ? static_cast<std::uint32_t>(primaryMonitor->width * 0.8F) : defaultWidth;
         if (size.v[1] <= 0.0F) size.v[1] = primaryMonitor ? static_cast<std::uint32_t>(primaryMonitor->height * 0.8F) : defaultHeight;
 
@@ -240,6 +250,12 @@ namespace ouzel::core::linux
     void NativeWindow::close()
     {
 #if OUZEL_SUPPORTS_X11
+        if (!display)
+        {
+            engine->exit();
+            return;
+        }
+
         if (!protocolsAtom || !deleteAtom) return;
 
         XEvent event;
@@ -262,20 +278,23 @@ namespace ouzel::core::linux
         size = newSize;
 
 #if OUZEL_SUPPORTS_X11
-        XWindowChanges changes;
-        changes.width = static_cast<int>(size.v[0]);
-        changes.height = static_cast<int>(size.v[1]);
-        XConfigureWindow(display, window, CWWidth | CWHeight, &changes);
-
-        if (!resizable)
+        if (display)
         {
-            XSizeHints sizeHints;
-            sizeHints.flags = PMinSize | PMaxSize;
-            sizeHints.min_width = static_cast<int>(size.v[0]);
-            sizeHints.max_width = static_cast<int>(size.v[0]);
-            sizeHints.min_height = static_cast<int>(size.v[1]);
-            sizeHints.max_height = static_cast<int>(size.v[1]);
-            XSetWMNormalHints(display, window, &sizeHints);
+            XWindowChanges changes;
+            changes.width = static_cast<int>(size.v[0]);
+            changes.height = static_cast<int>(size.v[1]);
+            XConfigureWindow(display, window, CWWidth | CWHeight, &changes);
+
+            if (!resizable)
+            {
+                XSizeHints sizeHints;
+                sizeHints.flags = PMinSize | PMaxSize;
+                sizeHints.min_width = static_cast<int>(size.v[0]);
+                sizeHints.max_width = static_cast<int>(size.v[0]);
+                sizeHints.min_height = static_cast<int>(size.v[1]);
+                sizeHints.max_height = static_cast<int>(size.v[1]);
+                XSetWMNormalHints(display, window, &sizeHints);
+            }
         }
 
         resolution = size;
@@ -289,7 +308,7 @@ namespace ouzel::core::linux
     void NativeWindow::setFullscreen(bool newFullscreen)
     {
 #if OUZEL_SUPPORTS_X11
-        if (fullscreen != newFullscreen)
+        if (display && fullscreen != newFullscreen)
         {
             XEvent event;
             event.type = ClientMessage;
@@ -314,7 +333,7 @@ namespace ouzel::core::linux
     void NativeWindow::setTitle(const std::string& newTitle)
     {
 #if OUZEL_SUPPORTS_X11
-        if (title != newTitle) XStoreName(display, window, newTitle.c_str());
+        if (display && title != newTitle) XStoreName(display, window, newTitle.c_str());
 #endif
 
         title = newTitle;
@@ -323,6 +342,8 @@ namespace ouzel::core::linux
     void NativeWindow::bringToFront()
     {
 #if OUZEL_SUPPORTS_X11
+        if (!display) return;
+
         XRaiseWindow(display, window);
 
         XEvent event;
@@ -345,7 +366,7 @@ namespace ouzel::core::linux
     void NativeWindow::show()
     {
 #if OUZEL_SUPPORTS_X11
-        if (!isMapped())
+        if (display && !isMapped())
         {
             XMapRaised(display, window);
             XFlush(display);
@@ -356,7 +377,7 @@ namespace ouzel::core::linux
     void NativeWindow::hide()
     {
 #if OUZEL_SUPPORTS_X11
-        if (isMapped())
+        if (display && isMapped())
         {
             XWithdrawWindow(display, window, screenNumber);
             XFlush(display);
@@ -367,6 +388,8 @@ namespace ouzel::core::linux
     void NativeWindow::minimize()
     {
 #if OUZEL_SUPPORTS_X11
+        if (!display) return;
+
         XIconifyWindow(display, window, screenNumber);
         XFlush(display);
 #endif
@@ -379,6 +402,8 @@ namespace ouzel::core::linux
     void NativeWindow::restore()
     {
 #if OUZEL_SUPPORTS_X11
+        if (!display) return;
+
         XRaiseWindow(display, window);
 
         XEvent event;
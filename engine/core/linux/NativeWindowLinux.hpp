@@ -19,6 +19,7 @@ typedef struct
 #endif
 
 #include "../NativeWindow.hpp"
+#include "../../graphics/Driver.hpp"
 
 namespace ouzel::core::linux
 {
@@ -32,7 +33,8 @@ namespace ouzel::core::linux
                      bool newResizable,
                      bool newFullscreen,
                      bool newExclusiveFullscreen,
-                     const std::string& newTitle);
+                     const std::string& newTitle,
+                     graphics::Driver graphicsDriver);
         ~NativeWindow() override;
 
         void close();
@@ -66,7 +68,7 @@ namespace ouzel::core::linux
         void handleUnmap();
         bool isMapped() const;
 
-        Display* display = nullptr;
+        Display* display = nullptr; // nullptr if the window is not shown
         int screenNumber = 0;
         ::Window window = None;
         Atom deleteAtom = None;
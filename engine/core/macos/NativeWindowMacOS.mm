@@ -182,6 +182,7 @@ namespace ouzel::core::macos
         switch (graphicsDriver)
         {
             case graphics::Driver::empty:
+            case graphics::Driver::software:
                 view = [[View alloc] initWithFrame:windowFrame];
                 break;
 #if OUZEL_COMPILE_OPENGL
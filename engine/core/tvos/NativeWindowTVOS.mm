@@ -69,6 +69,7 @@ namespace ouzel::core::tvos
         switch (graphicsDriver)
         {
             case graphics::Driver::empty:
+            case graphics::Driver::software:
                 view = [[View alloc] initWithFrame:windowFrame];
                 break;
 #if OUZEL_COMPILE_OPENGL
@@ -0,0 +1,459 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include "BlockDecoder.hpp"
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        constexpr std::uint8_t clampByte(int value) noexcept
+        {
+            return static_cast<std::uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+        }
+
+        constexpr std::uint8_t extend4(std::uint32_t value) noexcept
+        {
+            return static_cast<std::uint8_t>((value << 4) | value);
+        }
+
+        constexpr std::uint8_t extend5(std::uint32_t value) noexcept
+        {
+            return static_cast<std::uint8_t>((value << 3) | (value >> 2));
+        }
+
+        constexpr std::uint8_t extend6(std::uint32_t value) noexcept
+        {
+            return static_cast<std::uint8_t>((value << 2) | (value >> 4));
+        }
+
+        constexpr std::uint8_t extend7(std::uint32_t value) noexcept
+        {
+            return static_cast<std::uint8_t>((value << 1) | (value >> 6));
+        }
+
+        std::uint64_t readLittleEndian64(const std::uint8_t* data) noexcept
+        {
+            std::uint64_t result = 0;
+            for (std::uint32_t i = 0; i < 8; ++i)
+                result |= static_cast<std::uint64_t>(data[i]) << (i * 8);
+            return result;
+        }
+
+        std::uint64_t readBigEndian64(const std::uint8_t* data) noexcept
+        {
+            std::uint64_t result = 0;
+            for (std::uint32_t i = 0; i < 8; ++i)
+                result = (result << 8) | data[i];
+            return result;
+        }
+
+        constexpr std::uint32_t getBits(std::uint64_t value, std::uint32_t highestBit, std::uint32_t count) noexcept
+        {
+            return static_cast<std::uint32_t>((value >> (highestBit + 1 - count)) & ((std::uint64_t(1) << count) - 1));
+        }
+
+        // decodes the color part of a BC1, BC2 or BC3 block to 16 RGBA pixels in row-major order
+        void decodeBc1(const std::uint8_t* block, bool allowTransparency, std::uint8_t* pixels) noexcept
+        {
+            const std::uint32_t color0 = block[0] | (block[1] << 8);
+            const std::uint32_t color1 = block[2] | (block[3] << 8);
+
+            std::array<std::array<std::uint8_t, 4>, 4> palette{};
+            palette[0] = {extend5(color0 >> 11), extend6((color0 >> 5) & 0x3F), extend5(color0 & 0x1F), 255};
+            palette[1] = {extend5(color1 >> 11), extend6((color1 >> 5) & 0x3F), extend5(color1 & 0x1F), 255};
+
+            if (color0 > color1 || !allowTransparency)
+            {
+                for (std::size_t c = 0; c < 3; ++c)
+                {
+                    palette[2][c] = static_cast<std::uint8_t>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+                    palette[3][c] = static_cast<std::uint8_t>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+                }
+                palette[2][3] = 255;
+                palette[3][3] = 255;
+            }
+            else
+            {
+                for (std::size_t c = 0; c < 3; ++c)
+                    palette[2][c] = static_cast<std::uint8_t>((palette[0][c] + palette[1][c]) / 2);
+                palette[2][3] = 255;
+                palette[3] = {0, 0, 0, 0};
+            }
+
+            const std::uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<std::uint32_t>(block[7]) << 24);
+
+            for (std::uint32_t i = 0; i < 16; ++i, pixels += 4)
+            {
+                const auto& color = palette[(indices >> (i * 2)) & 0x03];
+                std::copy(color.begin(), color.end(), pixels);
+            }
+        }
+
+        // decodes a BC4 block (also the alpha part of BC3 and the channels of BC5) to 16 values
+        void decodeBc4(const std::uint8_t* block, std::uint8_t* values, std::size_t stride) noexcept
+        {
+            const std::uint32_t value0 = block[0];
+            const std::uint32_t value1 = block[1];
+
+            std::array<std::uint8_t, 8> palette{};
+            palette[0] = static_cast<std::uint8_t>(value0);
+            palette[1] = static_cast<std::uint8_t>(value1);
+
+            if (value0 > value1)
+            {
+                for (std::uint32_t i = 2; i < 8; ++i)
+                    palette[i] = static_cast<std::uint8_t>(((8 - i) * value0 + (i - 1) * value1 + 3) / 7);
+            }
+            else
+            {
+                for (std::uint32_t i = 2; i < 6; ++i)
+                    palette[i] = static_cast<std::uint8_t>(((6 - i) * value0 + (i - 1) * value1 + 2) / 5);
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            const auto indices = readLittleEndian64(block) >> 16;
+
+            for (std::uint32_t i = 0; i < 16; ++i, values += stride)
+                *values = palette[(indices >> (i * 3)) & 0x07];
+        }
+
+        // decodes the explicit 4-bit alpha of a BC2 block
+        void decodeBc2Alpha(const std::uint8_t* block, std::uint8_t* values, std::size_t stride) noexcept
+        {
+            const auto alpha = readLittleEndian64(block);
+
+            for (std::uint32_t i = 0; i < 16; ++i, values += stride)
+                *values = extend4((alpha >> (i * 4)) & 0x0F);
+        }
+
+        constexpr int etcModifiers[8][4] = {
+            {2, 8, -2, -8},
+            {5, 17, -5, -17},
+            {9, 29, -9, -29},
+            {13, 42, -13, -42},
+            {18, 60, -18, -60},
+            {24, 80, -24, -80},
+            {33, 106, -33, -106},
+            {47, 183, -47, -183}
+        };
+
+        constexpr int etcDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+        // decodes an ETC1 or ETC2 RGB block to 16 RGBA pixels in row-major order
+        void decodeEtc2(const std::uint8_t* block, std::uint8_t* pixels) noexcept
+        {
+            const auto bits = readBigEndian64(block);
+
+            // ETC pixel indices are stored in column-major order
+            const auto getIndex = [bits](std::uint32_t x, std::uint32_t y) noexcept {
+                const auto i = x * 4 + y;
+                return static_cast<std::uint32_t>((((bits >> (16 + i)) & 1) << 1) | ((bits >> i) & 1));
+            };
+
+            const auto setPixel = [pixels](std::uint32_t x, std::uint32_t y, int r, int g, int b) noexcept {
+                auto* pixel = pixels + (y * 4 + x) * 4;
+                pixel[0] = clampByte(r);
+                pixel[1] = clampByte(g);
+                pixel[2] = clampByte(b);
+                pixel[3] = 255;
+            };
+
+            const bool differential = (bits >> 33) & 1;
+            const bool flip = (bits >> 32) & 1;
+
+            std::array<std::array<int, 3>, 2> baseColors{};
+
+            if (differential)
+            {
+                const auto r = static_cast<int>(getBits(bits, 63, 5));
+                const auto g = static_cast<int>(getBits(bits, 55, 5));
+                const auto b = static_cast<int>(getBits(bits, 47, 5));
+                const auto dr = static_cast<int>(getBits(bits, 58, 3) ^ 4) - 4;
+                const auto dg = static_cast<int>(getBits(bits, 50, 3) ^ 4) - 4;
+                const auto db = static_cast<int>(getBits(bits, 42, 3) ^ 4) - 4;
+
+                if (r + dr < 0 || r + dr > 31) // T mode
+                {
+                    const std::array<int, 3> color0{
+                        extend4((getBits(bits, 60, 2) << 2) | getBits(bits, 57, 2)),
+                        extend4(getBits(bits, 55, 4)),
+                        extend4(getBits(bits, 51, 4))
+                    };
+                    const std::array<int, 3> color1{
+                        extend4(getBits(bits, 47, 4)),
+                        extend4(getBits(bits, 43, 4)),
+                        extend4(getBits(bits, 39, 4))
+                    };
+                    const auto distance = etcDistances[(getBits(bits, 35, 2) << 1) | getBits(bits, 32, 1)];
+
+                    const std::array<std::array<int, 3>, 4> paint{{
+                        color0,
+                        {color1[0] + distance, color1[1] + distance, color1[2] + distance},
+                        color1,
+                        {color1[0] - distance, color1[1] - distance, color1[2] - distance}
+                    }};
+
+                    for (std::uint32_t y = 0; y < 4; ++y)
+                        for (std::uint32_t x = 0; x < 4; ++x)
+                        {
+                            const auto& color = paint[getIndex(x, y)];
+                            setPixel(x, y, color[0], color[1], color[2]);
+                        }
+                    return;
+                }
+                else if (g + dg < 0 || g + dg > 31) // H mode
+                {
+                    const auto r0 = getBits(bits, 62, 4);
+                    const auto g0 = (getBits(bits, 58, 3) << 1) | getBits(bits, 52, 1);
+                    const auto b0 = (getBits(bits, 51, 1) << 3) | getBits(bits, 49, 3);
+                    const auto r1 = getBits(bits, 46, 4);
+                    const auto g1 = getBits(bits, 42, 4);
+                    const auto b1 = getBits(bits, 38, 4);
+
+                    const auto value0 = (r0 << 8) | (g0 << 4) | b0;
+                    const auto value1 = (r1 << 8) | (g1 << 4) | b1;
+                    const auto distance = etcDistances[(getBits(bits, 34, 1) << 2) |
+                                                       (getBits(bits, 32, 1) << 1) |
+                                                       (value0 >= value1 ? 1 : 0)];
+
+                    const std::array<int, 3> color0{extend4(r0), extend4(g0), extend4(b0)};
+                    const std::array<int, 3> color1{extend4(r1), extend4(g1), extend4(b1)};
+
+                    const std::array<std::array<int, 3>, 4> paint{{
+                        {color0[0] + distance, color0[1] + distance, color0[2] + distance},
+                        {color0[0] - distance, color0[1] - distance, color0[2] - distance},
+                        {color1[0] + distance, color1[1] + distance, color1[2] + distance},
+                        {color1[0] - distance, color1[1] - distance, color1[2] - distance}
+                    }};
+
+                    for (std::uint32_t y = 0; y < 4; ++y)
+                        for (std::uint32_t x = 0; x < 4; ++x)
+                        {
+                            const auto& color = paint[getIndex(x, y)];
+                            setPixel(x, y, color[0], color[1], color[2]);
+                        }
+                    return;
+                }
+                else if (b + db < 0 || b + db > 31) // planar mode
+                {
+                    const int ro = extend6(getBits(bits, 62, 6));
+                    const int go = extend7((getBits(bits, 56, 1) << 6) | getBits(bits, 54, 6));
+                    const int bo = extend6((getBits(bits, 48, 1) << 5) | (getBits(bits, 44, 2) << 3) | getBits(bits, 41, 3));
+                    const int rh = extend6((getBits(bits, 38, 5) << 1) | getBits(bits, 32, 1));
+                    const int gh = extend7(getBits(bits, 31, 7));
+                    const int bh = extend6(getBits(bits, 24, 6));
+                    const int rv = extend6(getBits(bits, 18, 6));
+                    const int gv = extend7(getBits(bits, 12, 7));
+                    const int bv = extend6(getBits(bits, 5, 6));
+
+                    for (std::uint32_t y = 0; y < 4; ++y)
+                        for (std::uint32_t x = 0; x < 4; ++x)
+                        {
+                            const auto ix = static_cast<int>(x);
+                            const auto iy = static_cast<int>(y);
+                            setPixel(x, y,
+                                     (ix * (rh - ro) + iy * (rv - ro) + 4 * ro + 2) >> 2,
+                                     (ix * (gh - go) + iy * (gv - go) + 4 * go + 2) >> 2,
+                                     (ix * (bh - bo) + iy * (bv - bo) + 4 * bo + 2) >> 2);
+                        }
+                    return;
+                }
+
+                baseColors[0] = {extend5(static_cast<std::uint32_t>(r)), extend5(static_cast<std::uint32_t>(g)), extend5(static_cast<std::uint32_t>(b))};
+                baseColors[1] = {extend5(static_cast<std::uint32_t>(r + dr)), extend5(static_cast<std::uint32_t>(g + dg)), extend5(static_cast<std::uint32_t>(b + db))};
+            }
+            else
+            {
+                baseColors[0] = {extend4(getBits(bits, 63, 4)), extend4(getBits(bits, 55, 4)), extend4(getBits(bits, 47, 4))};
+                baseColors[1] = {extend4(getBits(bits, 59, 4)), extend4(getBits(bits, 51, 4)), extend4(getBits(bits, 43, 4))};
+            }
+
+            const std::array<std::uint32_t, 2> tables{getBits(bits, 39, 3), getBits(bits, 36, 3)};
+
+            for (std::uint32_t y = 0; y < 4; ++y)
+                for (std::uint32_t x = 0; x < 4; ++x)
+                {
+                    const auto subblock = flip ? (y >= 2 ? 1 : 0) : (x >= 2 ? 1 : 0);
+                    const auto& color = baseColors[subblock];
+                    const auto modifier = etcModifiers[tables[subblock]][getIndex(x, y)];
+                    setPixel(x, y, color[0] + modifier, color[1] + modifier, color[2] + modifier);
+                }
+        }
+
+        constexpr int eacModifiers[16][8] = {
+            {-3, -6, -9, -15, 2, 5, 8, 14},
+            {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5, -8, -13, 1, 4, 7, 12},
+            {-2, -4, -6, -13, 1, 3, 5, 12},
+            {-3, -6, -8, -12, 2, 5, 7, 11},
+            {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10},
+            {-3, -5, -8, -11, 2, 4, 7, 10},
+            {-2, -6, -8, -10, 1, 5, 7, 9},
+            {-2, -5, -8, -10, 1, 4, 7, 9},
+            {-2, -4, -8, -10, 1, 3, 7, 9},
+            {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},
+            {-1, -2, -3, -10, 0, 1, 2, 9},
+            {-4, -6, -8, -9, 3, 5, 7, 8},
+            {-3, -5, -7, -9, 2, 4, 6, 8}
+        };
+
+        // decodes an EAC block (the alpha of ETC2 RGBA or an 11-bit R channel, reduced to 8 bits) to 16 values
+        void decodeEac(const std::uint8_t* block, bool elevenBit, std::uint8_t* values, std::size_t stride) noexcept
+        {
+            const auto bits = readBigEndian64(block);
+            const auto base = static_cast<int>(getBits(bits, 63, 8));
+            const auto multiplier = static_cast<int>(getBits(bits, 55, 4));
+            const auto& modifiers = eacModifiers[getBits(bits, 51, 4)];
+
+            for (std::uint32_t y = 0; y < 4; ++y)
+                for (std::uint32_t x = 0; x < 4; ++x)
+                {
+                    const auto i = x * 4 + y; // column-major
+                    const auto modifier = modifiers[getBits(bits, 47 - i * 3, 3)];
+
+                    auto& value = values[(y * 4 + x) * stride];
+
+                    if (elevenBit)
+                    {
+                        const auto result = std::clamp(base * 8 + 4 + modifier * (multiplier ? multiplier * 8 : 1), 0, 2047);
+                        value = static_cast<std::uint8_t>((result * 255 + 1023) / 2047);
+                    }
+                    else
+                        value = clampByte(base + modifier * multiplier);
+                }
+        }
+    }
+
+    bool isDecompressionSupported(PixelFormat pixelFormat) noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc2RgbaUnsignedNorm:
+            case PixelFormat::bc2RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::bc5RgUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+            case PixelFormat::eacRUnsignedNorm:
+            case PixelFormat::eacRgUnsignedNorm:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    PixelFormat getDecompressedPixelFormat(PixelFormat pixelFormat)
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc2RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+                return PixelFormat::rgba8UnsignedNorm;
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc2RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+                return PixelFormat::rgba8UnsignedNormSRGB;
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::eacRUnsignedNorm:
+                return PixelFormat::r8UnsignedNorm;
+            case PixelFormat::bc5RgUnsignedNorm:
+            case PixelFormat::eacRgUnsignedNorm:
+                return PixelFormat::rg8UnsignedNorm;
+            default:
+                throw std::runtime_error{"Pixel format can not be decompressed"};
+        }
+    }
+
+    std::vector<std::uint8_t> decompress(PixelFormat pixelFormat,
+                                         const math::Size<std::uint32_t, 2>& size,
+                                         const std::vector<std::uint8_t>& data)
+    {
+        const auto decompressedPixelFormat = getDecompressedPixelFormat(pixelFormat);
+        const auto pixelSize = getPixelSize(decompressedPixelFormat);
+        const auto blockSize = getBlockSize(pixelFormat);
+        const auto blocksX = (size.v[0] + 3) / 4;
+        const auto blocksY = (size.v[1] + 3) / 4;
+
+        if (data.size() < static_cast<std::size_t>(blocksX) * blocksY * blockSize)
+            throw std::runtime_error{"Not enough compressed texture data"};
+
+        std::vector<std::uint8_t> result(static_cast<std::size_t>(size.v[0]) * size.v[1] * pixelSize);
+        std::array<std::uint8_t, 16 * 4> pixels;
+        const auto* block = data.data();
+
+        for (std::uint32_t blockY = 0; blockY < blocksY; ++blockY)
+            for (std::uint32_t blockX = 0; blockX < blocksX; ++blockX, block += blockSize)
+            {
+                switch (pixelFormat)
+                {
+                    case PixelFormat::bc1RgbaUnsignedNorm:
+                    case PixelFormat::bc1RgbaUnsignedNormSRGB:
+                        decodeBc1(block, true, pixels.data());
+                        break;
+                    case PixelFormat::bc2RgbaUnsignedNorm:
+                    case PixelFormat::bc2RgbaUnsignedNormSRGB:
+                        decodeBc1(block + 8, false, pixels.data());
+                        decodeBc2Alpha(block, pixels.data() + 3, 4);
+                        break;
+                    case PixelFormat::bc3RgbaUnsignedNorm:
+                    case PixelFormat::bc3RgbaUnsignedNormSRGB:
+                        decodeBc1(block + 8, false, pixels.data());
+                        decodeBc4(block, pixels.data() + 3, 4);
+                        break;
+                    case PixelFormat::bc4RUnsignedNorm:
+                        decodeBc4(block, pixels.data(), 1);
+                        break;
+                    case PixelFormat::bc5RgUnsignedNorm:
+                        decodeBc4(block, pixels.data(), 2);
+                        decodeBc4(block + 8, pixels.data() + 1, 2);
+                        break;
+                    case PixelFormat::etc2RgbUnsignedNorm:
+                    case PixelFormat::etc2RgbUnsignedNormSRGB:
+                        decodeEtc2(block, pixels.data());
+                        break;
+                    case PixelFormat::etc2RgbaUnsignedNorm:
+                    case PixelFormat::etc2RgbaUnsignedNormSRGB:
+                        decodeEtc2(block + 8, pixels.data());
+                        decodeEac(block, false, pixels.data() + 3, 4);
+                        break;
+                    case PixelFormat::eacRUnsignedNorm:
+                        decodeEac(block, true, pixels.data(), 1);
+                        break;
+                    case PixelFormat::eacRgUnsignedNorm:
+                        decodeEac(block, true, pixels.data(), 2);
+                        decodeEac(block + 8, true, pixels.data() + 1, 2);
+                        break;
+                    default:
+                        throw std::runtime_error{"Pixel format can not be decompressed"};
+                }
+
+                // blocks on the right and bottom edges can stick out of the image
+                const auto width = std::min(4U, size.v[0] - blockX * 4);
+                const auto height = std::min(4U, size.v[1] - blockY * 4);
+
+                for (std::uint32_t y = 0; y < height; ++y)
+                    std::copy(pixels.data() + y * 4 * pixelSize,
+                              pixels.data() + (y * 4 + width) * pixelSize,
+                              result.data() + ((blockY * 4 + y) * size.v[0] + blockX * 4) * pixelSize);
+            }
+
+        return result;
+    }
+}
@@ -0,0 +1,24 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_BLOCKDECODER_HPP
+#define OUZEL_GRAPHICS_BLOCKDECODER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "PixelFormat.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::graphics
+{
+    // CPU fallback for render devices that can not sample block compressed formats
+    bool isDecompressionSupported(PixelFormat pixelFormat) noexcept;
+
+    // returns the uncompressed format that decompress produces
+    PixelFormat getDecompressedPixelFormat(PixelFormat pixelFormat);
+
+    std::vector<std::uint8_t> decompress(PixelFormat pixelFormat,
+                                         const math::Size<std::uint32_t, 2>& size,
+                                         const std::vector<std::uint8_t>& data);
+}
+
+#endif // OUZEL_GRAPHICS_BLOCKDECODER_HPP
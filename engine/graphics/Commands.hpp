@@ -3,9 +3,11 @@
 #ifndef OUZEL_GRAPHICS_COMMANDS_HPP
 #define OUZEL_GRAPHICS_COMMANDS_HPP
 
+#include <cstdint>
 #include <set>
 #include <string>
-#include <queue>
+#include <utility>
+#include <vector>
 #include "BlendFactor.hpp"
 #include "BlendOperation.hpp"
 #include "BufferType.hpp"
@@ -29,6 +31,27 @@ namespace ouzel::graphics
 {
     using ResourceId = std::size_t;
 
+    // the low bits of a resource handle store the slot index + 1 (0 is an invalid handle)
+    // and the high bits store the generation of the slot, which changes every time the slot is reused
+    constexpr std::size_t resourceIndexBits = sizeof(ResourceId) >= 8 ? 32 : 20;
+    constexpr ResourceId resourceIndexMask = (ResourceId{1} << resourceIndexBits) - 1;
+    constexpr ResourceId resourceGenerationMask = ~ResourceId{0} >> resourceIndexBits;
+
+    constexpr ResourceId makeResourceId(std::size_t index, std::uint32_t generation) noexcept
+    {
+        return ((generation & resourceGenerationMask) << resourceIndexBits) | (index + 1);
+    }
+
+    constexpr std::size_t getResourceIndex(ResourceId id) noexcept
+    {
+        return (id & resourceIndexMask) - 1;
+    }
+
+    constexpr std::uint32_t getResourceGeneration(ResourceId id) noexcept
+    {
+        return static_cast<std::uint32_t>(id >> resourceIndexBits);
+    }
+
     class Command
     {
     public:
@@ -46,6 +69,7 @@ namespace ouzel::graphics
             setDepthStencilState,
             setPipelineState,
             draw,
+            drawInstanced,
             initBlendState,
             initBuffer,
             setBufferData,
@@ -53,8 +77,11 @@ namespace ouzel::graphics
             setShaderConstants,
             initTexture,
             setTextureData,
+            setTextureRegion,
             setTextureParameters,
+            uploadTextureData,
             setTextures,
+            discardRenderTarget,
 
             initRenderPass,
             setRenderPassParameters,
@@ -165,6 +192,26 @@ namespace ouzel::graphics
         const std::uint32_t clearStencil;
     };
 
+    // tells the driver that the contents of the current render target are not needed anymore,
+    // so that tile based GPUs don't have to store them to memory
+    class DiscardRenderTargetCommand final: public Command
+    {
+    public:
+        constexpr DiscardRenderTargetCommand(bool initDiscardColorBuffer,
+                                             bool initDiscardDepthBuffer,
+                                             bool initDiscardStencilBuffer) noexcept:
+            Command{Type::discardRenderTarget},
+            discardColorBuffer{initDiscardColorBuffer},
+            discardDepthBuffer{initDiscardDepthBuffer},
+            discardStencilBuffer{initDiscardStencilBuffer}
+        {
+        }
+
+        const bool discardColorBuffer;
+        const bool discardDepthBuffer;
+        const bool discardStencilBuffer;
+    };
+
     class SetScissorTestCommand final: public Command
     {
     public:
@@ -309,6 +356,39 @@ namespace ouzel::graphics
         const std::uint32_t startIndex;
     };
 
+    class DrawInstancedCommand final: public Command
+    {
+    public:
+        constexpr DrawInstancedCommand(ResourceId initIndexBuffer,
+                                       std::uint32_t initIndexCount,
+                                       std::uint32_t initIndexSize,
+                                       ResourceId initVertexBuffer,
+                                       ResourceId initInstanceBuffer,
+                                       std::uint32_t initInstanceCount,
+                                       DrawMode initDrawMode,
+                                       std::uint32_t initStartIndex) noexcept:
+            Command{Type::drawInstanced},
+            indexBuffer{initIndexBuffer},
+            indexCount{initIndexCount},
+            indexSize{initIndexSize},
+            vertexBuffer{initVertexBuffer},
+            instanceBuffer{initInstanceBuffer},
+            instanceCount{initInstanceCount},
+            drawMode{initDrawMode},
+            startIndex{initStartIndex}
+        {
+        }
+
+        const ResourceId indexBuffer;
+        const std::uint32_t indexCount;
+        const std::uint32_t indexSize;
+        const ResourceId vertexBuffer;
+        const ResourceId instanceBuffer;
+        const std::uint32_t instanceCount;
+        const DrawMode drawMode;
+        const std::uint32_t startIndex;
+    };
+
     class InitBlendStateCommand final: public Command
     {
     public:
@@ -492,6 +572,22 @@ namespace ouzel::graphics
         const CubeFace face;
     };
 
+    // updates a rectangle of each level of a dynamic texture, the other pixels are kept
+    class SetTextureRegionCommand final: public Command
+    {
+    public:
+        SetTextureRegionCommand(ResourceId initTexture,
+                                const std::vector<std::pair<math::Rect<std::uint32_t>, std::vector<std::uint8_t>>>& initLevels) noexcept(false):
+            Command{Type::setTextureRegion},
+            texture{initTexture},
+            levels{initLevels}
+        {
+        }
+
+        const ResourceId texture;
+        const std::vector<std::pair<math::Rect<std::uint32_t>, std::vector<std::uint8_t>>> levels;
+    };
+
     class SetTextureParametersCommand final: public Command
     {
     public:
@@ -522,6 +618,21 @@ namespace ouzel::graphics
         const std::uint32_t maxAnisotropy;
     };
 
+    class UploadTextureDataCommand final: public Command
+    {
+    public:
+        UploadTextureDataCommand(ResourceId initTexture,
+                                 std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> initLevels) noexcept:
+            Command{Type::uploadTextureData},
+            texture{initTexture},
+            levels{std::move(initLevels)}
+        {
+        }
+
+        const ResourceId texture;
+        std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels; // not const, so that the render device can take it over
+    };
+
     class SetTexturesCommand final: public Command
     {
     public:
@@ -573,20 +684,40 @@ namespace ouzel::graphics
         {
         }
 
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        CommandBuffer(CommandBuffer&& other) noexcept:
+            name{std::move(other.name)},
+            commands{std::move(other.commands)},
+            position{std::exchange(other.position, 0)}
+        {
+        }
+
+        CommandBuffer& operator=(CommandBuffer&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            name = std::move(other.name);
+            commands = std::move(other.commands);
+            position = std::exchange(other.position, 0);
+            other.commands.clear();
+
+            return *this;
+        }
+
         auto& getName() const noexcept { return name; }
 
-        auto isEmpty() const noexcept { return commands.empty(); }
+        auto isEmpty() const noexcept { return position == commands.size(); }
 
         void pushCommand(std::unique_ptr<Command> command)
         {
-            commands.push(std::move(command));
+            commands.push_back(std::move(command));
         }
 
         std::unique_ptr<Command> popCommand()
         {
-            auto result = std::move(commands.front());
-            commands.pop();
-            return result;
+            return std::move(commands[position++]);
         }
 
         auto& getCommands() const
@@ -594,9 +725,20 @@ namespace ouzel::graphics
             return commands;
         }
 
+        // removes the commands and the name, but keeps the allocated storage for reuse
+        void reset() noexcept
+        {
+            name.clear();
+            commands.clear();
+            position = 0;
+        }
+
+        auto getCapacity() const noexcept { return commands.capacity(); }
+
     private:
         std::string name;
-        std::queue<std::unique_ptr<Command>> commands;
+        std::vector<std::unique_ptr<Command>> commands;
+        std::size_t position = 0; // index of the next command to pop
     };
 }
 
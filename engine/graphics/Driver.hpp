@@ -10,7 +10,8 @@ namespace ouzel::graphics
         empty,
         openGl,
         direct3D11,
-        metal
+        metal,
+        software
     };
 }
 
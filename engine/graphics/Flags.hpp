@@ -11,7 +11,8 @@ namespace ouzel::graphics
         dynamic = 0x01,
         bindRenderTarget = 0x02,
         bindShader = 0x04,
-        bindShaderMsaa = 0x08
+        bindShaderMsaa = 0x08,
+        luminance = 0x10 // r8 textures are sampled as grey and rg8 textures as grey with alpha
     };
 
     inline constexpr Flags operator&(const Flags a, const Flags b) noexcept
@@ -0,0 +1,869 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include "FrameCapture.hpp"
+#include "../utils/Log.hpp"
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        constexpr std::uint32_t captureVersion = 2;
+
+        using Levels = std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>;
+        using RegionLevels = std::vector<std::pair<math::Rect<std::uint32_t>, std::vector<std::uint8_t>>>;
+        using ConstantInfo = std::vector<std::pair<std::string, DataType>>;
+
+        template <typename T>
+        obf::Value encodeValue(const T value)
+        {
+            if constexpr (std::is_enum_v<T>)
+                return obf::Value{static_cast<std::uint32_t>(value)};
+            else if constexpr (std::is_same_v<T, bool>)
+                return obf::Value{static_cast<std::uint32_t>(value ? 1U : 0U)};
+            else if constexpr (std::is_floating_point_v<T>)
+                return obf::Value{static_cast<float>(value)};
+            else
+                return obf::Value{static_cast<std::uint64_t>(value)};
+        }
+
+        template <typename T>
+        T decodeValue(const obf::Value& value)
+        {
+            if constexpr (std::is_enum_v<T>)
+                return static_cast<T>(value.as<std::uint32_t>());
+            else if constexpr (std::is_same_v<T, bool>)
+                return value.as<std::uint32_t>() != 0;
+            else
+                return value.as<T>();
+        }
+
+        obf::Value encodeColor(const math::Color color)
+        {
+            return obf::Value{color.getIntValue()};
+        }
+
+        math::Color decodeColor(const obf::Value& value)
+        {
+            return math::Color{value.as<std::uint32_t>()};
+        }
+
+        obf::Value encodeSize(const math::Size<std::uint32_t, 2>& size)
+        {
+            return obf::Value::Array{encodeValue(size.v[0]), encodeValue(size.v[1])};
+        }
+
+        math::Size<std::uint32_t, 2> decodeSize(const obf::Value& value)
+        {
+            return math::Size<std::uint32_t, 2>{value[0].as<std::uint32_t>(), value[1].as<std::uint32_t>()};
+        }
+
+        template <typename T>
+        obf::Value encodeRect(const math::Rect<T>& rect)
+        {
+            return obf::Value::Array{
+                encodeValue(rect.position.v[0]), encodeValue(rect.position.v[1]),
+                encodeValue(rect.size.v[0]), encodeValue(rect.size.v[1])
+            };
+        }
+
+        template <typename T>
+        math::Rect<T> decodeRect(const obf::Value& value)
+        {
+            return math::Rect<T>{
+                value[0].as<T>(), value[1].as<T>(),
+                value[2].as<T>(), value[3].as<T>()
+            };
+        }
+
+        template <class Container>
+        obf::Value encodeIds(const Container& ids)
+        {
+            obf::Value::Array result;
+            for (const auto id : ids) result.push_back(encodeValue(id));
+            return result;
+        }
+
+        std::set<ResourceId> decodeIdSet(const obf::Value& value)
+        {
+            std::set<ResourceId> result;
+            for (const auto& id : value) result.insert(id.as<ResourceId>());
+            return result;
+        }
+
+        std::vector<ResourceId> decodeIdVector(const obf::Value& value)
+        {
+            std::vector<ResourceId> result;
+            for (const auto& id : value) result.push_back(id.as<ResourceId>());
+            return result;
+        }
+
+        obf::Value encodeLevels(const Levels& levels)
+        {
+            obf::Value::Array result;
+            for (const auto& [levelSize, data] : levels)
+                result.push_back(obf::Value::Array{encodeSize(levelSize), obf::Value{data}});
+            return result;
+        }
+
+        Levels decodeLevels(const obf::Value& value)
+        {
+            Levels result;
+            for (const auto& level : value)
+                result.emplace_back(decodeSize(level[0]), level[1].as<obf::Value::ByteArray>());
+            return result;
+        }
+
+        obf::Value encodeRegionLevels(const RegionLevels& levels)
+        {
+            obf::Value::Array result;
+            for (const auto& [rectangle, data] : levels)
+                result.push_back(obf::Value::Array{encodeRect(rectangle), obf::Value{data}});
+            return result;
+        }
+
+        RegionLevels decodeRegionLevels(const obf::Value& value)
+        {
+            RegionLevels result;
+            for (const auto& level : value)
+                result.emplace_back(decodeRect<std::uint32_t>(level[0]), level[1].as<obf::Value::ByteArray>());
+            return result;
+        }
+
+        obf::Value encodeConstants(const std::vector<std::vector<float>>& constants)
+        {
+            obf::Value::Array result;
+            for (const auto& constant : constants)
+            {
+                obf::Value::Array values;
+                for (const auto f : constant) values.push_back(encodeValue(f));
+                result.push_back(values);
+            }
+            return result;
+        }
+
+        std::vector<std::vector<float>> decodeConstants(const obf::Value& value)
+        {
+            std::vector<std::vector<float>> result;
+            for (const auto& constant : value)
+            {
+                std::vector<float> values;
+                for (const auto& f : constant) values.push_back(f.as<float>());
+                result.push_back(std::move(values));
+            }
+            return result;
+        }
+
+        obf::Value encodeConstantInfo(const ConstantInfo& constantInfo)
+        {
+            obf::Value::Array result;
+            for (const auto& [name, dataType] : constantInfo)
+                result.push_back(obf::Value::Array{obf::Value{name}, encodeValue(dataType)});
+            return result;
+        }
+
+        ConstantInfo decodeConstantInfo(const obf::Value& value)
+        {
+            ConstantInfo result;
+            for (const auto& info : value)
+                result.emplace_back(info[0].as<std::string>(), decodeValue<DataType>(info[1]));
+            return result;
+        }
+
+        obf::Value encodeCommand(const Command& command)
+        {
+            obf::Value::Array fields{encodeValue(command.type)};
+
+            switch (command.type)
+            {
+                case Command::Type::resize:
+                {
+                    const auto& resizeCommand = static_cast<const ResizeCommand&>(command);
+                    fields.push_back(encodeSize(resizeCommand.size));
+                    break;
+                }
+                case Command::Type::present:
+                    break;
+                case Command::Type::deleteResource:
+                {
+                    const auto& deleteResourceCommand = static_cast<const DeleteResourceCommand&>(command);
+                    fields.push_back(encodeValue(deleteResourceCommand.resource));
+                    break;
+                }
+                case Command::Type::initRenderTarget:
+                {
+                    const auto& initRenderTargetCommand = static_cast<const InitRenderTargetCommand&>(command);
+                    fields.push_back(encodeValue(initRenderTargetCommand.renderTarget));
+                    fields.push_back(encodeIds(initRenderTargetCommand.colorTextures));
+                    fields.push_back(encodeValue(initRenderTargetCommand.depthTexture));
+                    break;
+                }
+                case Command::Type::setRenderTarget:
+                {
+                    const auto& setRenderTargetCommand = static_cast<const SetRenderTargetCommand&>(command);
+                    fields.push_back(encodeValue(setRenderTargetCommand.renderTarget));
+                    break;
+                }
+                case Command::Type::clearRenderTarget:
+                {
+                    const auto& clearCommand = static_cast<const ClearRenderTargetCommand&>(command);
+                    fields.push_back(encodeValue(clearCommand.clearColorBuffer));
+                    fields.push_back(encodeValue(clearCommand.clearDepthBuffer));
+                    fields.push_back(encodeValue(clearCommand.clearStencilBuffer));
+                    fields.push_back(encodeColor(clearCommand.clearColor));
+                    fields.push_back(encodeValue(clearCommand.clearDepth));
+                    fields.push_back(encodeValue(clearCommand.clearStencil));
+                    break;
+                }
+                case Command::Type::discardRenderTarget:
+                {
+                    const auto& discardCommand = static_cast<const DiscardRenderTargetCommand&>(command);
+                    fields.push_back(encodeValue(discardCommand.discardColorBuffer));
+                    fields.push_back(encodeValue(discardCommand.discardDepthBuffer));
+                    fields.push_back(encodeValue(discardCommand.discardStencilBuffer));
+                    break;
+                }
+                case Command::Type::setScissorTest:
+                {
+                    const auto& setScissorTestCommand = static_cast<const SetScissorTestCommand&>(command);
+                    fields.push_back(encodeValue(setScissorTestCommand.enabled));
+                    fields.push_back(encodeRect(setScissorTestCommand.rectangle));
+                    break;
+                }
+                case Command::Type::setViewport:
+                {
+                    const auto& setViewportCommand = static_cast<const SetViewportCommand&>(command);
+                    fields.push_back(encodeRect(setViewportCommand.viewport));
+                    break;
+                }
+                case Command::Type::initDepthStencilState:
+                {
+                    const auto& initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand&>(command);
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.depthStencilState));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.depthTest));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.depthWrite));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.compareFunction));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.stencilEnabled));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.stencilReadMask));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.stencilWriteMask));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.frontFaceStencilFailureOperation));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.frontFaceStencilDepthFailureOperation));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.frontFaceStencilPassOperation));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.frontFaceStencilCompareFunction));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.backFaceStencilFailureOperation));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.backFaceStencilDepthFailureOperation));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.backFaceStencilPassOperation));
+                    fields.push_back(encodeValue(initDepthStencilStateCommand.backFaceStencilCompareFunction));
+                    break;
+                }
+                case Command::Type::setDepthStencilState:
+                {
+                    const auto& setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand&>(command);
+                    fields.push_back(encodeValue(setDepthStencilStateCommand.depthStencilState));
+                    fields.push_back(encodeValue(setDepthStencilStateCommand.stencilReferenceValue));
+                    break;
+                }
+                case Command::Type::setPipelineState:
+                {
+                    const auto& setPipelineStateCommand = static_cast<const SetPipelineStateCommand&>(command);
+                    fields.push_back(encodeValue(setPipelineStateCommand.blendState));
+                    fields.push_back(encodeValue(setPipelineStateCommand.shader));
+                    fields.push_back(encodeValue(setPipelineStateCommand.cullMode));
+                    fields.push_back(encodeValue(setPipelineStateCommand.fillMode));
+                    break;
+                }
+                case Command::Type::draw:
+                {
+                    const auto& drawCommand = static_cast<const DrawCommand&>(command);
+                    fields.push_back(encodeValue(drawCommand.indexBuffer));
+                    fields.push_back(encodeValue(drawCommand.indexCount));
+                    fields.push_back(encodeValue(drawCommand.indexSize));
+                    fields.push_back(encodeValue(drawCommand.vertexBuffer));
+                    fields.push_back(encodeValue(drawCommand.drawMode));
+                    fields.push_back(encodeValue(drawCommand.startIndex));
+                    break;
+                }
+                case Command::Type::drawInstanced:
+                {
+                    const auto& drawInstancedCommand = static_cast<const DrawInstancedCommand&>(command);
+                    fields.push_back(encodeValue(drawInstancedCommand.indexBuffer));
+                    fields.push_back(encodeValue(drawInstancedCommand.indexCount));
+                    fields.push_back(encodeValue(drawInstancedCommand.indexSize));
+                    fields.push_back(encodeValue(drawInstancedCommand.vertexBuffer));
+                    fields.push_back(encodeValue(drawInstancedCommand.instanceBuffer));
+                    fields.push_back(encodeValue(drawInstancedCommand.instanceCount));
+                    fields.push_back(encodeValue(drawInstancedCommand.drawMode));
+                    fields.push_back(encodeValue(drawInstancedCommand.startIndex));
+                    break;
+                }
+                case Command::Type::initBlendState:
+                {
+                    const auto& initBlendStateCommand = static_cast<const InitBlendStateCommand&>(command);
+                    fields.push_back(encodeValue(initBlendStateCommand.blendState));
+                    fields.push_back(encodeValue(initBlendStateCommand.enableBlending));
+                    fields.push_back(encodeValue(initBlendStateCommand.colorBlendSource));
+                    fields.push_back(encodeValue(initBlendStateCommand.colorBlendDest));
+                    fields.push_back(encodeValue(initBlendStateCommand.colorOperation));
+                    fields.push_back(encodeValue(initBlendStateCommand.alphaBlendSource));
+                    fields.push_back(encodeValue(initBlendStateCommand.alphaBlendDest));
+                    fields.push_back(encodeValue(initBlendStateCommand.alphaOperation));
+                    fields.push_back(encodeValue(initBlendStateCommand.colorMask));
+                    break;
+                }
+                case Command::Type::initBuffer:
+                {
+                    const auto& initBufferCommand = static_cast<const InitBufferCommand&>(command);
+                    fields.push_back(encodeValue(initBufferCommand.buffer));
+                    fields.push_back(encodeValue(initBufferCommand.bufferType));
+                    fields.push_back(encodeValue(initBufferCommand.flags));
+                    fields.push_back(obf::Value{initBufferCommand.data});
+                    fields.push_back(encodeValue(initBufferCommand.size));
+                    break;
+                }
+                case Command::Type::setBufferData:
+                {
+                    const auto& setBufferDataCommand = static_cast<const SetBufferDataCommand&>(command);
+                    fields.push_back(encodeValue(setBufferDataCommand.buffer));
+                    fields.push_back(obf::Value{setBufferDataCommand.data});
+                    break;
+                }
+                case Command::Type::initShader:
+                {
+                    const auto& initShaderCommand = static_cast<const InitShaderCommand&>(command);
+                    fields.push_back(encodeValue(initShaderCommand.shader));
+                    fields.push_back(obf::Value{initShaderCommand.fragmentShader});
+                    fields.push_back(obf::Value{initShaderCommand.vertexShader});
+
+                    obf::Value::Array vertexAttributes;
+                    for (const auto& semantic : initShaderCommand.vertexAttributes)
+                        vertexAttributes.push_back(obf::Value::Array{encodeValue(semantic.usage), encodeValue(semantic.index)});
+                    fields.push_back(vertexAttributes);
+
+                    fields.push_back(encodeConstantInfo(initShaderCommand.fragmentShaderConstantInfo));
+                    fields.push_back(encodeConstantInfo(initShaderCommand.vertexShaderConstantInfo));
+                    fields.push_back(obf::Value{initShaderCommand.fragmentShaderFunction});
+                    fields.push_back(obf::Value{initShaderCommand.vertexShaderFunction});
+                    break;
+                }
+                case Command::Type::setShaderConstants:
+                {
+                    const auto& setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand&>(command);
+                    fields.push_back(encodeConstants(setShaderConstantsCommand.fragmentShaderConstants));
+                    fields.push_back(encodeConstants(setShaderConstantsCommand.vertexShaderConstants));
+                    break;
+                }
+                case Command::Type::initTexture:
+                {
+                    const auto& initTextureCommand = static_cast<const InitTextureCommand&>(command);
+                    fields.push_back(encodeValue(initTextureCommand.texture));
+                    fields.push_back(encodeLevels(initTextureCommand.levels));
+                    fields.push_back(encodeValue(initTextureCommand.textureType));
+                    fields.push_back(encodeValue(initTextureCommand.flags));
+                    fields.push_back(encodeValue(initTextureCommand.sampleCount));
+                    fields.push_back(encodeValue(initTextureCommand.pixelFormat));
+                    fields.push_back(encodeValue(initTextureCommand.filter));
+                    fields.push_back(encodeValue(initTextureCommand.maxAnisotropy));
+                    break;
+                }
+                case Command::Type::setTextureData:
+                {
+                    const auto& setTextureDataCommand = static_cast<const SetTextureDataCommand&>(command);
+                    fields.push_back(encodeValue(setTextureDataCommand.texture));
+                    fields.push_back(encodeLevels(setTextureDataCommand.levels));
+                    fields.push_back(encodeValue(setTextureDataCommand.face));
+                    break;
+                }
+                case Command::Type::setTextureRegion:
+                {
+                    const auto& setTextureRegionCommand = static_cast<const SetTextureRegionCommand&>(command);
+                    fields.push_back(encodeValue(setTextureRegionCommand.texture));
+                    fields.push_back(encodeRegionLevels(setTextureRegionCommand.levels));
+                    break;
+                }
+                case Command::Type::setTextureParameters:
+                {
+                    const auto& setTextureParametersCommand = static_cast<const SetTextureParametersCommand&>(command);
+                    fields.push_back(encodeValue(setTextureParametersCommand.texture));
+                    fields.push_back(encodeValue(setTextureParametersCommand.filter));
+                    fields.push_back(encodeValue(setTextureParametersCommand.addressX));
+                    fields.push_back(encodeValue(setTextureParametersCommand.addressY));
+                    fields.push_back(encodeValue(setTextureParametersCommand.addressZ));
+                    fields.push_back(encodeColor(setTextureParametersCommand.borderColor));
+                    fields.push_back(encodeValue(setTextureParametersCommand.maxAnisotropy));
+                    break;
+                }
+                case Command::Type::uploadTextureData:
+                {
+                    const auto& uploadTextureDataCommand = static_cast<const UploadTextureDataCommand&>(command);
+                    fields.push_back(encodeValue(uploadTextureDataCommand.texture));
+                    fields.push_back(encodeLevels(uploadTextureDataCommand.levels));
+                    break;
+                }
+                case Command::Type::setTextures:
+                {
+                    const auto& setTexturesCommand = static_cast<const SetTexturesCommand&>(command);
+                    fields.push_back(encodeIds(setTexturesCommand.textures));
+                    break;
+                }
+                case Command::Type::initRenderPass:
+                {
+                    const auto& initRenderPassCommand = static_cast<const InitRenderPassCommand&>(command);
+                    fields.push_back(encodeValue(initRenderPassCommand.renderPass));
+                    fields.push_back(encodeIds(initRenderPassCommand.renderTargets));
+                    break;
+                }
+                case Command::Type::setRenderPassParameters:
+                {
+                    const auto& setRenderPassParametersCommand = static_cast<const SetRenderPassParametersCommand&>(command);
+                    fields.push_back(encodeValue(setRenderPassParametersCommand.renderPass));
+                    fields.push_back(encodeIds(setRenderPassParametersCommand.renderTargets));
+                    break;
+                }
+                default:
+                    throw std::runtime_error{"Unsupported command"};
+            }
+
+            return fields;
+        }
+
+        std::unique_ptr<Command> decodeCommand(const obf::Value& fields)
+        {
+            const auto type = decodeValue<Command::Type>(fields[0]);
+
+            switch (type)
+            {
+                case Command::Type::resize:
+                    return std::make_unique<ResizeCommand>(decodeSize(fields[1]));
+                case Command::Type::present:
+                    return std::make_unique<PresentCommand>();
+                case Command::Type::deleteResource:
+                    return std::make_unique<DeleteResourceCommand>(fields[1].as<ResourceId>());
+                case Command::Type::initRenderTarget:
+                    return std::make_unique<InitRenderTargetCommand>(fields[1].as<ResourceId>(),
+                                                                     decodeIdSet(fields[2]),
+                                                                     fields[3].as<ResourceId>());
+                case Command::Type::setRenderTarget:
+                    return std::make_unique<SetRenderTargetCommand>(fields[1].as<ResourceId>());
+                case Command::Type::clearRenderTarget:
+                    return std::make_unique<ClearRenderTargetCommand>(decodeValue<bool>(fields[1]),
+                                                                      decodeValue<bool>(fields[2]),
+                                                                      decodeValue<bool>(fields[3]),
+                                                                      decodeColor(fields[4]),
+                                                                      fields[5].as<float>(),
+                                                                      fields[6].as<std::uint32_t>());
+                case Command::Type::discardRenderTarget:
+                    return std::make_unique<DiscardRenderTargetCommand>(decodeValue<bool>(fields[1]),
+                                                                        decodeValue<bool>(fields[2]),
+                                                                        decodeValue<bool>(fields[3]));
+                case Command::Type::setScissorTest:
+                    return std::make_unique<SetScissorTestCommand>(decodeValue<bool>(fields[1]),
+                                                                   decodeRect<float>(fields[2]));
+                case Command::Type::setViewport:
+                    return std::make_unique<SetViewportCommand>(decodeRect<float>(fields[1]));
+                case Command::Type::initDepthStencilState:
+                    return std::make_unique<InitDepthStencilStateCommand>(fields[1].as<ResourceId>(),
+                                                                          decodeValue<bool>(fields[2]),
+                                                                          decodeValue<bool>(fields[3]),
+                                                                          decodeValue<CompareFunction>(fields[4]),
+                                                                          decodeValue<bool>(fields[5]),
+                                                                          fields[6].as<std::uint32_t>(),
+                                                                          fields[7].as<std::uint32_t>(),
+                                                                          decodeValue<StencilOperation>(fields[8]),
+                                                                          decodeValue<StencilOperation>(fields[9]),
+                                                                          decodeValue<StencilOperation>(fields[10]),
+                                                                          decodeValue<CompareFunction>(fields[11]),
+                                                                          decodeValue<StencilOperation>(fields[12]),
+                                                                          decodeValue<StencilOperation>(fields[13]),
+                                                                          decodeValue<StencilOperation>(fields[14]),
+                                                                          decodeValue<CompareFunction>(fields[15]));
+                case Command::Type::setDepthStencilState:
+                    return std::make_unique<SetDepthStencilStateCommand>(fields[1].as<ResourceId>(),
+                                                                         fields[2].as<std::uint32_t>());
+                case Command::Type::setPipelineState:
+                    return std::make_unique<SetPipelineStateCommand>(fields[1].as<ResourceId>(),
+                                                                     fields[2].as<ResourceId>(),
+                                                                     decodeValue<CullMode>(fields[3]),
+                                                                     decodeValue<FillMode>(fields[4]));
+                case Command::Type::draw:
+                    return std::make_unique<DrawCommand>(fields[1].as<ResourceId>(),
+                                                         fields[2].as<std::uint32_t>(),
+                                                         fields[3].as<std::uint32_t>(),
+                                                         fields[4].as<ResourceId>(),
+                                                         decodeValue<DrawMode>(fields[5]),
+                                                         fields[6].as<std::uint32_t>());
+                case Command::Type::drawInstanced:
+                    return std::make_unique<DrawInstancedCommand>(fields[1].as<ResourceId>(),
+                                                                  fields[2].as<std::uint32_t>(),
+                                                                  fields[3].as<std::uint32_t>(),
+                                                                  fields[4].as<ResourceId>(),
+                                                                  fields[5].as<ResourceId>(),
+                                                                  fields[6].as<std::uint32_t>(),
+                                                                  decodeValue<DrawMode>(fields[7]),
+                                                                  fields[8].as<std::uint32_t>());
+                case Command::Type::initBlendState:
+                    return std::make_unique<InitBlendStateCommand>(fields[1].as<ResourceId>(),
+                                                                   decodeValue<bool>(fields[2]),
+                                                                   decodeValue<BlendFactor>(fields[3]),
+                                                                   decodeValue<BlendFactor>(fields[4]),
+                                                                   decodeValue<BlendOperation>(fields[5]),
+                                                                   decodeValue<BlendFactor>(fields[6]),
+                                                                   decodeValue<BlendFactor>(fields[7]),
+                                                                   decodeValue<BlendOperation>(fields[8]),
+                                                                   decodeValue<ColorMask>(fields[9]));
+                case Command::Type::initBuffer:
+                    return std::make_unique<InitBufferCommand>(fields[1].as<ResourceId>(),
+                                                               decodeValue<BufferType>(fields[2]),
+                                                               decodeValue<Flags>(fields[3]),
+                                                               fields[4].as<obf::Value::ByteArray>(),
+                                                               fields[5].as<std::uint32_t>());
+                case Command::Type::setBufferData:
+                    return std::make_unique<SetBufferDataCommand>(fields[1].as<ResourceId>(),
+                                                                  fields[2].as<obf::Value::ByteArray>());
+                case Command::Type::initShader:
+                {
+                    std::set<Vertex::Attribute::Semantic> vertexAttributes;
+                    for (const auto& semantic : fields[4])
+                        vertexAttributes.insert(Vertex::Attribute::Semantic{
+                            decodeValue<Vertex::Attribute::Usage>(semantic[0]),
+                            semantic[1].as<Vertex::Attribute::Index>()
+                        });
+
+                    return std::make_unique<InitShaderCommand>(fields[1].as<ResourceId>(),
+                                                               fields[2].as<obf::Value::ByteArray>(),
+                                                               fields[3].as<obf::Value::ByteArray>(),
+                                                               vertexAttributes,
+                                                               decodeConstantInfo(fields[5]),
+                                                               decodeConstantInfo(fields[6]),
+                                                               fields[7].as<std::string>(),
+                                                               fields[8].as<std::string>());
+                }
+                case Command::Type::setShaderConstants:
+                    return std::make_unique<SetShaderConstantsCommand>(decodeConstants(fields[1]),
+                                                                       decodeConstants(fields[2]));
+                case Command::Type::initTexture:
+                    return std::make_unique<InitTextureCommand>(fields[1].as<ResourceId>(),
+                                                                decodeLevels(fields[2]),
+                                                                decodeValue<TextureType>(fields[3]),
+                                                                decodeValue<Flags>(fields[4]),
+                                                                fields[5].as<std::uint32_t>(),
+                                                                decodeValue<PixelFormat>(fields[6]),
+                                                                decodeValue<SamplerFilter>(fields[7]),
+                                                                fields[8].as<std::uint32_t>());
+                case Command::Type::setTextureData:
+                    return std::make_unique<SetTextureDataCommand>(fields[1].as<ResourceId>(),
+                                                                   decodeLevels(fields[2]),
+                                                                   decodeValue<CubeFace>(fields[3]));
+                case Command::Type::setTextureRegion:
+                    return std::make_unique<SetTextureRegionCommand>(fields[1].as<ResourceId>(),
+                                                                     decodeRegionLevels(fields[2]));
+                case Command::Type::setTextureParameters:
+                    return std::make_unique<SetTextureParametersCommand>(fields[1].as<ResourceId>(),
+                                                                         decodeValue<SamplerFilter>(fields[2]),
+                                                                         decodeValue<SamplerAddressMode>(fields[3]),
+                                                                         decodeValue<SamplerAddressMode>(fields[4]),
+                                                                         decodeValue<SamplerAddressMode>(fields[5]),
+                                                                         decodeColor(fields[6]),
+                                                                         fields[7].as<std::uint32_t>());
+                case Command::Type::uploadTextureData:
+                    return std::make_unique<UploadTextureDataCommand>(fields[1].as<ResourceId>(),
+                                                                      decodeLevels(fields[2]));
+                case Command::Type::setTextures:
+                    return std::make_unique<SetTexturesCommand>(decodeIdVector(fields[1]));
+                case Command::Type::initRenderPass:
+                    return std::make_unique<InitRenderPassCommand>(fields[1].as<ResourceId>(),
+                                                                   decodeIdSet(fields[2]));
+                case Command::Type::setRenderPassParameters:
+                    return std::make_unique<SetRenderPassParametersCommand>(fields[1].as<ResourceId>(),
+                                                                            decodeIdSet(fields[2]));
+                default:
+                    throw std::runtime_error{"Unsupported command"};
+            }
+        }
+
+        template <class T>
+        std::unique_ptr<Command> clone(const Command& command)
+        {
+            return std::make_unique<T>(static_cast<const T&>(command));
+        }
+
+        std::unique_ptr<Command> cloneCommand(const Command& command)
+        {
+            switch (command.type)
+            {
+                case Command::Type::resize: return clone<ResizeCommand>(command);
+                case Command::Type::present: return clone<PresentCommand>(command);
+                case Command::Type::deleteResource: return clone<DeleteResourceCommand>(command);
+                case Command::Type::initRenderTarget: return clone<InitRenderTargetCommand>(command);
+                case Command::Type::setRenderTarget: return clone<SetRenderTargetCommand>(command);
+                case Command::Type::clearRenderTarget: return clone<ClearRenderTargetCommand>(command);
+                case Command::Type::discardRenderTarget: return clone<DiscardRenderTargetCommand>(command);
+                case Command::Type::setScissorTest: return clone<SetScissorTestCommand>(command);
+                case Command::Type::setViewport: return clone<SetViewportCommand>(command);
+                case Command::Type::initDepthStencilState: return clone<InitDepthStencilStateCommand>(command);
+                case Command::Type::setDepthStencilState: return clone<SetDepthStencilStateCommand>(command);
+                case Command::Type::setPipelineState: return clone<SetPipelineStateCommand>(command);
+                case Command::Type::draw: return clone<DrawCommand>(command);
+                case Command::Type::drawInstanced: return clone<DrawInstancedCommand>(command);
+                case Command::Type::initBlendState: return clone<InitBlendStateCommand>(command);
+                case Command::Type::initBuffer: return clone<InitBufferCommand>(command);
+                case Command::Type::setBufferData: return clone<SetBufferDataCommand>(command);
+                case Command::Type::initShader: return clone<InitShaderCommand>(command);
+                case Command::Type::setShaderConstants: return clone<SetShaderConstantsCommand>(command);
+                case Command::Type::initTexture: return clone<InitTextureCommand>(command);
+                case Command::Type::setTextureData: return clone<SetTextureDataCommand>(command);
+                case Command::Type::setTextureRegion: return clone<SetTextureRegionCommand>(command);
+                case Command::Type::setTextureParameters: return clone<SetTextureParametersCommand>(command);
+                case Command::Type::uploadTextureData: return clone<UploadTextureDataCommand>(command);
+                case Command::Type::setTextures: return clone<SetTexturesCommand>(command);
+                case Command::Type::initRenderPass: return clone<InitRenderPassCommand>(command);
+                case Command::Type::setRenderPassParameters: return clone<SetRenderPassParametersCommand>(command);
+                default: throw std::runtime_error{"Unsupported command"};
+            }
+        }
+
+        // returns the resource that the command initializes or modifies, 0 for other commands
+        ResourceId getResource(const Command& command) noexcept
+        {
+            switch (command.type)
+            {
+                case Command::Type::initRenderTarget: return static_cast<const InitRenderTargetCommand&>(command).renderTarget;
+                case Command::Type::initDepthStencilState: return static_cast<const InitDepthStencilStateCommand&>(command).depthStencilState;
+                case Command::Type::initBlendState: return static_cast<const InitBlendStateCommand&>(command).blendState;
+                case Command::Type::initBuffer: return static_cast<const InitBufferCommand&>(command).buffer;
+                case Command::Type::setBufferData: return static_cast<const SetBufferDataCommand&>(command).buffer;
+                case Command::Type::initShader: return static_cast<const InitShaderCommand&>(command).shader;
+                case Command::Type::initTexture: return static_cast<const InitTextureCommand&>(command).texture;
+                case Command::Type::setTextureData: return static_cast<const SetTextureDataCommand&>(command).texture;
+                case Command::Type::setTextureRegion: return static_cast<const SetTextureRegionCommand&>(command).texture;
+                case Command::Type::setTextureParameters: return static_cast<const SetTextureParametersCommand&>(command).texture;
+                case Command::Type::uploadTextureData: return static_cast<const UploadTextureDataCommand&>(command).texture;
+                case Command::Type::initRenderPass: return static_cast<const InitRenderPassCommand&>(command).renderPass;
+                case Command::Type::setRenderPassParameters: return static_cast<const SetRenderPassParametersCommand&>(command).renderPass;
+                default: return 0;
+            }
+        }
+
+        // render targets reference textures and render passes reference render targets,
+        // so they have to be initialized after the resources they use
+        std::uint32_t getInitOrder(Command::Type type) noexcept
+        {
+            switch (type)
+            {
+                case Command::Type::initRenderTarget: return 1;
+                case Command::Type::initRenderPass: return 2;
+                default: return 0;
+            }
+        }
+    }
+
+    FrameCapture::FrameCapture(Driver initDriver, const math::Size<std::uint32_t, 2>& initSize):
+        driver{initDriver}, size{initSize}
+    {
+    }
+
+    void FrameCapture::capture(const std::string& newFilename, std::uint32_t newFrameCount)
+    {
+        if (isCapturing())
+            throw std::runtime_error{"Frame capture already in progress"};
+
+        if (!newFrameCount)
+            throw std::runtime_error{"Invalid frame count"};
+
+        filename = newFilename;
+        frameCount = newFrameCount;
+    }
+
+    void FrameCapture::addCommand(const Command& command)
+    {
+        if (started) frameCommands.push_back(encodeCommand(command));
+
+        trackCommand(command);
+
+        if (command.type == Command::Type::present && isCapturing())
+        {
+            if (!started)
+                begin();
+            else
+            {
+                frames.emplace_back(std::move(frameCommands));
+                frameCommands.clear();
+
+                if (frames.size() >= frameCount)
+                    finish();
+            }
+        }
+    }
+
+    void FrameCapture::trackCommand(const Command& command)
+    {
+        if (command.type == Command::Type::resize)
+            size = static_cast<const ResizeCommand&>(command).size;
+        else if (command.type == Command::Type::deleteResource)
+            resources.erase(static_cast<const DeleteResourceCommand&>(command).resource);
+        else if (const auto resource = getResource(command))
+        {
+            auto& commands = resources[resource];
+
+            switch (command.type)
+            {
+                case Command::Type::initRenderTarget:
+                case Command::Type::initDepthStencilState:
+                case Command::Type::initBlendState:
+                case Command::Type::initBuffer:
+                case Command::Type::initShader:
+                case Command::Type::initTexture:
+                case Command::Type::initRenderPass:
+                    commands.clear();
+                    break;
+                case Command::Type::setTextureData:
+                {
+                    // every face of a cube map is set separately
+                    const auto face = static_cast<const SetTextureDataCommand&>(command).face;
+                    // and replaces the regions set before it
+                    commands.erase(std::remove_if(commands.begin(), commands.end(), [face](const auto& previous) {
+                        return (previous->type == Command::Type::setTextureData &&
+                                static_cast<const SetTextureDataCommand&>(*previous).face == face) ||
+                            (previous->type == Command::Type::setTextureRegion && face == CubeFace::positiveX);
+                    }), commands.end());
+                    break;
+                }
+                case Command::Type::setTextureRegion:
+                    // regions are applied on top of each other
+                    break;
+                default:
+                    // the data and parameter commands always replace the whole state they set
+                    commands.erase(std::remove_if(commands.begin(), commands.end(), [&command](const auto& previous) {
+                        return previous->type == command.type;
+                    }), commands.end());
+                    break;
+            }
+
+            commands.push_back(cloneCommand(command));
+        }
+    }
+
+    void FrameCapture::begin()
+    {
+        started = true;
+        resourceCommands.clear();
+        frames.clear();
+        frameCommands.clear();
+
+        for (std::uint32_t order = 0; order < 3; ++order)
+            for (const auto& [resource, commands] : resources)
+                if (!commands.empty() && getInitOrder(commands.front()->type) == order)
+                    for (const auto& command : commands)
+                        resourceCommands.push_back(encodeCommand(*command));
+    }
+
+    void FrameCapture::finish()
+    {
+        obf::Value capture{obf::Type::object};
+        capture[0] = obf::Value{captureVersion};
+        capture[1] = encodeValue(driver);
+        capture[2] = encodeSize(size);
+        capture[3] = obf::Value{resourceCommands};
+        capture[4] = obf::Value{frames};
+
+        std::vector<std::uint8_t> data;
+        capture.encode(data);
+
+        started = false;
+        frameCount = 0;
+        resourceCommands.clear();
+        frames.clear();
+
+        std::ofstream file{filename, std::ios::binary};
+        if (!file)
+            throw std::runtime_error{"Failed to open file " + filename};
+
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        log(Log::Level::info) << "Frame capture saved to " << filename;
+    }
+
+    FrameReplay::FrameReplay(const std::vector<std::uint8_t>& data)
+    {
+        obf::Value value;
+        value.decode(data, 0);
+        const auto& capture = value;
+
+        if (capture[0].as<std::uint32_t>() != captureVersion)
+            throw std::runtime_error{"Unsupported frame capture version"};
+
+        driver = decodeValue<Driver>(capture[1]);
+        size = decodeSize(capture[2]);
+
+        for (const auto& command : capture[3])
+            resourceCommands.push_back(decodeCommand(command));
+
+        for (const auto& frame : capture[4])
+        {
+            std::vector<std::unique_ptr<Command>> commands;
+            for (const auto& command : frame)
+                commands.push_back(decodeCommand(command));
+            frames.push_back(std::move(commands));
+        }
+    }
+
+    FrameReplay::Result FrameReplay::run(RenderDevice& renderDevice, std::uint32_t loopCount) const
+    {
+        if (renderDevice.getDriver() != driver)
+            throw std::runtime_error{"Frame capture was recorded with a different render driver"};
+
+        CommandBuffer resourceBuffer{"Replay resources"};
+        resourceBuffer.pushCommand(std::make_unique<ResizeCommand>(size));
+        for (const auto& command : resourceCommands)
+            resourceBuffer.pushCommand(cloneCommand(*command));
+        resourceBuffer.pushCommand(std::make_unique<PresentCommand>());
+        renderDevice.submitCommandBuffer(std::move(resourceBuffer));
+
+        renderDevice.setCommandTimingEnabled(true);
+        renderDevice.waitForIdle();
+
+        const auto startTimings = renderDevice.getCommandTimings();
+        const auto startTime = std::chrono::steady_clock::now();
+
+        // the render device posts a frame event every time it starts processing a frame
+        while (renderDevice.hasEvents()) renderDevice.getNextEvent();
+        std::size_t startedFrames = 0;
+        std::size_t submittedFrames = 0;
+
+        for (std::uint32_t loop = 0; loop < loopCount; ++loop)
+        {
+            // keep at most one loop queued ahead of the render thread
+            while (submittedFrames > startedFrames + frames.size())
+                if (renderDevice.getNextEvent().type == RenderDevice::Event::Type::frame)
+                    ++startedFrames;
+
+            for (const auto& frame : frames)
+            {
+                CommandBuffer commandBuffer{"Replay frame"};
+                for (const auto& command : frame)
+                    commandBuffer.pushCommand(cloneCommand(*command));
+                renderDevice.submitCommandBuffer(std::move(commandBuffer));
+                ++submittedFrames;
+            }
+        }
+
+        renderDevice.waitForIdle();
+
+        Result result;
+        result.frameCount = loopCount * getFrameCount();
+        result.duration = std::chrono::steady_clock::now() - startTime;
+
+        const auto endTimings = renderDevice.getCommandTimings();
+        renderDevice.setCommandTimingEnabled(false);
+
+        for (std::size_t i = 0; i < RenderDevice::commandTypeCount; ++i)
+        {
+            result.commandTimings.counts[i] = endTimings.counts[i] - startTimings.counts[i];
+            result.commandTimings.durations[i] = endTimings.durations[i] - startTimings.durations[i];
+        }
+
+        return result;
+    }
+}
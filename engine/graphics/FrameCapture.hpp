@@ -0,0 +1,78 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_FRAMECAPTURE_HPP
+#define OUZEL_GRAPHICS_FRAMECAPTURE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Commands.hpp"
+#include "Driver.hpp"
+#include "RenderDevice.hpp"
+#include "../formats/Obf.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::graphics
+{
+    // Tracks the current state of every render resource from the command stream
+    // and writes the resources and the commands of the requested frames to a capture file
+    class FrameCapture final
+    {
+    public:
+        FrameCapture(Driver initDriver, const math::Size<std::uint32_t, 2>& initSize);
+
+        // starts capturing at the next frame boundary
+        void capture(const std::string& newFilename, std::uint32_t newFrameCount);
+        auto isCapturing() const noexcept { return frameCount != 0; }
+
+        void addCommand(const Command& command);
+
+    private:
+        void trackCommand(const Command& command);
+        void begin();
+        void finish();
+
+        Driver driver;
+        math::Size<std::uint32_t, 2> size;
+        std::map<ResourceId, std::vector<std::unique_ptr<Command>>> resources;
+
+        std::string filename;
+        std::uint32_t frameCount = 0;
+        bool started = false;
+        obf::Value::Array resourceCommands;
+        obf::Value::Array frames;
+        obf::Value::Array frameCommands;
+    };
+
+    // Loads a capture file and submits its frames to a render device
+    class FrameReplay final
+    {
+    public:
+        struct Result final
+        {
+            std::uint32_t frameCount = 0;
+            std::chrono::steady_clock::duration duration{};
+            RenderDevice::CommandTimings commandTimings;
+        };
+
+        explicit FrameReplay(const std::vector<std::uint8_t>& data);
+
+        auto getDriver() const noexcept { return driver; }
+        auto& getSize() const noexcept { return size; }
+        auto getFrameCount() const noexcept { return static_cast<std::uint32_t>(frames.size()); }
+
+        // uploads the captured resources once and then replays all frames the given number of times
+        Result run(RenderDevice& renderDevice, std::uint32_t loopCount) const;
+
+    private:
+        Driver driver;
+        math::Size<std::uint32_t, 2> size;
+        std::vector<std::unique_ptr<Command>> resourceCommands;
+        std::vector<std::vector<std::unique_ptr<Command>>> frames;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_FRAMECAPTURE_HPP
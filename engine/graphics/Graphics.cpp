@@ -3,15 +3,18 @@
 #ifdef __APPLE__
 #  include <TargetConditionals.h>
 #endif
+#include <algorithm>
 #include <stdexcept>
 #include "../core/Setup.h"
 #include "Graphics.hpp"
 #include "Commands.hpp"
 #include "RenderDevice.hpp"
+#include "Texture.hpp"
 #include "../events/EventHandler.hpp"
 #include "../events/EventDispatcher.hpp"
 #include "../core/Engine.hpp"
 #include "../core/Window.hpp"
+#include "../storage/FileSystem.hpp"
 #include "../utils/Log.hpp"
 
 #if TARGET_OS_IOS
@@ -37,6 +40,7 @@
 #include "opengl/OGLRenderDevice.hpp"
 #include "direct3d11/D3D11RenderDevice.hpp"
 #include "metal/MetalRenderDevice.hpp"
+#include "software/SoftwareRenderDevice.hpp"
 
 namespace ouzel::graphics
 {
@@ -47,6 +51,7 @@ namespace ouzel::graphics
         if (availableDrivers.empty())
         {
             availableDrivers.insert(Driver::empty);
+            availableDrivers.insert(Driver::software);
 
 #if OUZEL_COMPILE_OPENGL
             availableDrivers.insert(Driver::openGl);
@@ -86,6 +91,8 @@ namespace ouzel::graphics
             return Driver::direct3D11;
         else if (driver == "metal")
             return Driver::metal;
+        else if (driver == "software")
+            return Driver::software;
         else
             throw std::runtime_error{"Invalid graphics driver"};
     }
@@ -135,6 +142,9 @@ namespace ouzel::graphics
                     return std::make_unique<metal::macos::RenderDevice>(settings, window);
 #  endif
 #endif
+                case Driver::software:
+                    log(Log::Level::info) << "Using software render driver";
+                    return std::make_unique<software::RenderDevice>(settings, window);
                 default:
                     log(Log::Level::info) << "Not using render driver";
                     return std::make_unique<empty::RenderDevice>(settings, window);
@@ -142,6 +152,8 @@ namespace ouzel::graphics
         }
     }
 
+    thread_local std::unique_ptr<Graphics::Recording> Graphics::recording;
+
     Graphics::Graphics(Driver driver,
                        core::Window& initWindow,
                        const Settings& settings):
@@ -150,6 +162,9 @@ namespace ouzel::graphics
         size{initWindow.getResolution()},
         device{createRenderDevice(driver, initWindow, settings)}
     {
+        if (settings.frameCapture)
+            frameCapture = std::make_unique<FrameCapture>(device->getDriver(), size);
+
         device->start();
     }
 
@@ -167,7 +182,29 @@ namespace ouzel::graphics
 
     void Graphics::saveScreenshot(const std::string& filename)
     {
-        device->executeOnRenderThread(std::bind(&RenderDevice::generateScreenshot, device.get(), filename));
+        device->executeOnRenderThread(std::bind(&RenderDevice::queueScreenshot, device.get(), filename));
+    }
+
+    void Graphics::startFrameRecording(const std::string& directory, ImageFileFormat format)
+    {
+        const storage::Path path{directory};
+        if (storage::FileSystem::getFileType(path) == storage::FileType::notFound)
+            storage::FileSystem::createDirectory(path);
+
+        device->executeOnRenderThread(std::bind(&RenderDevice::startFrameRecording, device.get(), directory, format));
+    }
+
+    void Graphics::stopFrameRecording()
+    {
+        device->executeOnRenderThread(std::bind(&RenderDevice::stopFrameRecording, device.get()));
+    }
+
+    void Graphics::captureFrames(const std::string& filename, std::uint32_t captureFrameCount)
+    {
+        if (!frameCapture)
+            throw std::runtime_error{"Frame capture is not enabled"};
+
+        frameCapture->capture(filename, captureFrameCount);
     }
 
     void Graphics::setRenderTarget(std::size_t renderTarget)
@@ -190,6 +227,15 @@ namespace ouzel::graphics
                                                               clearStencil));
     }
 
+    void Graphics::discardRenderTarget(bool discardColorBuffer,
+                                       bool discardDepthBuffer,
+                                       bool discardStencilBuffer)
+    {
+        addCommand(std::make_unique<DiscardRenderTargetCommand>(discardColorBuffer,
+                                                                discardDepthBuffer,
+                                                                discardStencilBuffer));
+    }
+
     void Graphics::setScissorTest(bool enabled, const math::Rect<float>& rectangle)
     {
         addCommand(std::make_unique<SetScissorTestCommand>(enabled, rectangle));
@@ -236,6 +282,31 @@ namespace ouzel::graphics
                                                  startIndex));
     }
 
+    void Graphics::drawInstanced(std::size_t indexBuffer,
+                                 std::uint32_t indexCount,
+                                 std::uint32_t indexSize,
+                                 std::size_t vertexBuffer,
+                                 std::size_t instanceBuffer,
+                                 std::uint32_t instanceCount,
+                                 DrawMode drawMode,
+                                 std::uint32_t startIndex)
+    {
+        if (!indexBuffer || !vertexBuffer || !instanceBuffer)
+            throw std::runtime_error{"Invalid mesh buffer passed to render queue"};
+
+        if (!device->isInstancingSupported())
+            throw std::runtime_error{"Instanced drawing is not supported"};
+
+        addCommand(std::make_unique<DrawInstancedCommand>(indexBuffer,
+                                                          indexCount,
+                                                          indexSize,
+                                                          vertexBuffer,
+                                                          instanceBuffer,
+                                                          instanceCount,
+                                                          drawMode,
+                                                          startIndex));
+    }
+
     void Graphics::setShaderConstants(const std::vector<std::vector<float>>& fragmentShaderConstants,
                                       const std::vector<std::vector<float>>& vertexShaderConstants)
     {
@@ -248,23 +319,212 @@ namespace ouzel::graphics
         addCommand(std::make_unique<SetTexturesCommand>(textures));
     }
 
+    void Graphics::addTextureLoad(const std::shared_ptr<TextureLoad>& textureLoad)
+    {
+        textureLoads.push_back(textureLoad);
+    }
+
+    void Graphics::processTextureLoads()
+    {
+        for (auto i = textureLoads.begin(); i != textureLoads.end();)
+        {
+            const auto textureLoad = i->lock();
+
+            if (!textureLoad || textureLoad->ready)
+            {
+                i = textureLoads.erase(i);
+                continue;
+            }
+
+            if (textureLoad->initialized || !textureLoad->result->finished)
+            {
+                ++i;
+                continue;
+            }
+
+            auto& result = *textureLoad->result;
+
+            if (!result.error.empty())
+            {
+                log(Log::Level::error) << "Failed to load texture: " << result.error;
+                i = textureLoads.erase(i);
+                continue;
+            }
+
+            if (device->isTextureStreamingSupported())
+            {
+                // create the texture without data and let the render device upload the levels over several frames
+                std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levelSizes;
+                for (const auto& level : result.levels)
+                    levelSizes.emplace_back(level.first, std::vector<std::uint8_t>{});
+
+                addCommand(std::make_unique<InitTextureCommand>(textureLoad->resource,
+                                                                levelSizes,
+                                                                TextureType::twoDimensional,
+                                                                textureLoad->flags,
+                                                                1,
+                                                                textureLoad->pixelFormat,
+                                                                textureLoad->filter,
+                                                                textureLoad->maxAnisotropy));
+            }
+            else
+                addCommand(std::make_unique<InitTextureCommand>(textureLoad->resource,
+                                                                result.levels,
+                                                                TextureType::twoDimensional,
+                                                                textureLoad->flags,
+                                                                1,
+                                                                textureLoad->pixelFormat,
+                                                                textureLoad->filter,
+                                                                textureLoad->maxAnisotropy));
+
+            addCommand(std::make_unique<SetTextureParametersCommand>(textureLoad->resource,
+                                                                     textureLoad->filter,
+                                                                     textureLoad->addressX,
+                                                                     textureLoad->addressY,
+                                                                     textureLoad->addressZ,
+                                                                     textureLoad->borderColor,
+                                                                     textureLoad->maxAnisotropy));
+
+            textureLoad->initialized = true;
+
+            if (device->isTextureStreamingSupported())
+            {
+                addCommand(std::make_unique<UploadTextureDataCommand>(textureLoad->resource,
+                                                                      std::move(result.levels)));
+                ++i;
+            }
+            else
+            {
+                textureLoad->ready = true;
+                i = textureLoads.erase(i);
+            }
+        }
+    }
+
+    void Graphics::beginRecording(std::uint64_t orderKey)
+    {
+        if (recording)
+            throw std::runtime_error{"Command recording already started on this thread"};
+
+        recording = std::make_unique<Recording>();
+        recording->orderKey = orderKey;
+        recording->commandBuffer = device->getCommandBuffer();
+    }
+
+    void Graphics::endRecording()
+    {
+        if (!recording)
+            throw std::runtime_error{"Command recording not started on this thread"};
+
+        const auto currentRecording = std::move(recording);
+        submitCommandBuffer(currentRecording->orderKey, std::move(currentRecording->commandBuffer));
+    }
+
+    void Graphics::submitCommandBuffer(std::uint64_t orderKey, CommandBuffer&& recordedCommandBuffer)
+    {
+        std::scoped_lock lock{recordedCommandBuffersMutex};
+        recordedCommandBuffers.emplace_back(orderKey, std::move(recordedCommandBuffer));
+    }
+
     void Graphics::present()
     {
-        addCommand(std::make_unique<PresentCommand>());
-        device->submitCommandBuffer(std::move(commandBuffer));
-        commandBuffer = CommandBuffer();
+        const auto startTime = std::chrono::steady_clock::now();
+
+        processTextureLoads();
+
+        std::unique_lock lock{recordedCommandBuffersMutex};
+        auto recorded = std::move(recordedCommandBuffers);
+        recordedCommandBuffers.clear();
+        lock.unlock();
+
+        // the buffer of the update thread is merged with the recorded ones by its key,
+        // buffers with equal keys keep the order they were submitted in
+        recorded.emplace(recorded.begin(), updateOrderKey, std::move(commandBuffer));
+        commandBuffer = device->getCommandBuffer();
+
+        std::stable_sort(recorded.begin(), recorded.end(),
+                         [](const auto& a, const auto& b) noexcept { return a.first < b.first; });
+
+        std::vector<CommandBuffer> commandBuffers;
+        commandBuffers.reserve(recorded.size());
+
+        for (auto& recordedCommandBuffer : recorded)
+        {
+            // captured in the order they are submitted in
+            if (frameCapture)
+                for (const auto& command : recordedCommandBuffer.second.getCommands())
+                    frameCapture->addCommand(*command);
+
+            commandBuffers.push_back(std::move(recordedCommandBuffer.second));
+        }
+
+        // the resources are deleted after all the commands of the frame that could still use them
+        for (const auto resource : device->takeDeletedResourceIds())
+        {
+            auto deleteResourceCommand = std::make_unique<DeleteResourceCommand>(resource);
+            if (frameCapture) frameCapture->addCommand(*deleteResourceCommand);
+            commandBuffers.back().pushCommand(std::move(deleteResourceCommand));
+        }
+
+        auto presentCommand = std::make_unique<PresentCommand>();
+        if (frameCapture) frameCapture->addCommand(*presentCommand);
+        commandBuffers.back().pushCommand(std::move(presentCommand));
+
+        device->submitCommandBuffers(std::move(commandBuffers));
+
+        queuedInputTimes.push_back(inputTime == std::chrono::steady_clock::time_point{} ? startTime : inputTime);
+        inputTime = std::chrono::steady_clock::time_point{};
+
+        ++frameCount;
+        presentDuration = std::chrono::steady_clock::now() - startTime;
     }
 
-    bool Graphics::getRefillQueue(bool waitForNextFrame) const
+    bool Graphics::getRefillQueue(bool waitForNextFrame)
     {
-        for (;;)
+        while (device->hasEvents())
+            handleDeviceEvent(device->getNextEvent());
+
+        // one frame is being rendered while the others wait in the queue
+        while (frameCount - finishedFrameCount > device->getFramesInFlight())
         {
-            if (!waitForNextFrame && !device->hasEvents())
-                return false;
+            if (!waitForNextFrame) return false;
+            handleDeviceEvent(device->getNextEvent());
+        }
+
+        return true;
+    }
 
-            const auto event = device->getNextEvent();
-            if (event.type == RenderDevice::Event::Type::frame)
-                return true;
+    void Graphics::handleDeviceEvent(const RenderDevice::Event& event)
+    {
+        if (event.type == RenderDevice::Event::Type::frame)
+        {
+            if (frameEventCount)
+            {
+                const auto delta = event.time - lastFrameTime;
+                frameInterval = (frameEventCount == 1) ? delta : (frameInterval * 7 + delta) / 8;
+            }
+
+            lastFrameTime = event.time;
+
+            // the render device starts a frame after finishing the previous one,
+            // but the first frame event is posted before anything was submitted
+            if (frameEventCount++ && finishedFrameCount < frameCount)
+            {
+                ++finishedFrameCount;
+
+                if (!queuedInputTimes.empty())
+                {
+                    inputLatency = event.time - queuedInputTimes.front();
+                    queuedInputTimes.pop_front();
+                }
+            }
+        }
+        else if (event.type == RenderDevice::Event::Type::textureReady)
+        {
+            for (const auto& weakTextureLoad : textureLoads)
+                if (const auto textureLoad = weakTextureLoad.lock())
+                    if (textureLoad->resource == event.resource)
+                        textureLoad->ready = true;
         }
     }
 }
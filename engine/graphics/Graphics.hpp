@@ -3,13 +3,17 @@
 #ifndef OUZEL_GRAPHICS_GRAPHICS_HPP
 #define OUZEL_GRAPHICS_GRAPHICS_HPP
 
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
 #include "Commands.hpp"
 #include "Driver.hpp"
+#include "FrameCapture.hpp"
 #include "RenderDevice.hpp"
 #include "Settings.hpp"
 #include "../math/Rect.hpp"
@@ -25,6 +29,8 @@ namespace ouzel::core
 
 namespace ouzel::graphics
 {
+    class TextureLoad;
+
     std::set<Driver> getAvailableRenderDrivers();
     Driver getDriver(const std::string& driver);
 
@@ -43,8 +49,19 @@ namespace ouzel::graphics
         auto getTextureFilter() const noexcept { return textureFilter; }
         auto getMaxAnisotropy() const noexcept { return maxAnisotropy; }
 
+        // the image is read back at the end of the next frame and written on a worker thread,
+        // the format is chosen by the extension (.png, .qoi or .raw)
         void saveScreenshot(const std::string& filename);
 
+        // writes every presented frame to a numbered file in the directory until stopped,
+        // frames are dropped instead of stalling the rendering if the writing falls behind
+        void startFrameRecording(const std::string& directory, ImageFileFormat format = ImageFileFormat::qoi);
+        void stopFrameRecording();
+
+        // writes the resources and the commands of the next frames to a file,
+        // requires the frame capture setting to be enabled
+        void captureFrames(const std::string& filename, std::uint32_t captureFrameCount = 1);
+
         void setRenderTarget(std::size_t renderTarget);
         void clearRenderTarget(bool clearColorBuffer,
                                bool clearDepthBuffer,
@@ -52,6 +69,9 @@ namespace ouzel::graphics
                                math::Color clearColor,
                                float clearDepth,
                                std::uint32_t clearStencil);
+        void discardRenderTarget(bool discardColorBuffer,
+                                 bool discardDepthBuffer,
+                                 bool discardStencilBuffer);
         void setScissorTest(bool enabled, const math::Rect<float>& rectangle);
         void setViewport(const math::Rect<float>& viewport);
         void setDepthStencilState(std::size_t depthStencilState,
@@ -66,17 +86,64 @@ namespace ouzel::graphics
                   std::size_t vertexBuffer,
                   DrawMode drawMode,
                   std::uint32_t startIndex);
+        void drawInstanced(std::size_t indexBuffer,
+                           std::uint32_t indexCount,
+                           std::uint32_t indexSize,
+                           std::size_t vertexBuffer,
+                           std::size_t instanceBuffer,
+                           std::uint32_t instanceCount,
+                           DrawMode drawMode,
+                           std::uint32_t startIndex);
         void setShaderConstants(const std::vector<std::vector<float>>& fragmentShaderConstants,
                                 const std::vector<std::vector<float>>& vertexShaderConstants);
         void setTextures(const std::vector<std::size_t>& textures);
 
         void addCommand(std::unique_ptr<Command> command)
         {
-            commandBuffer.pushCommand(std::move(command));
+            if (recording)
+                recording->commandBuffer.pushCommand(std::move(command));
+            else
+                commandBuffer.pushCommand(std::move(command));
         }
         void present();
 
-        bool getRefillQueue(bool waitForNextFrame) const;
+        // Commands added on the calling thread (including the ones of the resources created on it)
+        // are recorded into a separate command buffer until endRecording is called. The recorded
+        // buffers and the buffer of the update thread are submitted sorted by their order keys.
+        // Can be called on any thread, but the resources used by a recorded buffer must be initialized
+        // by it or by a buffer that is submitted before it.
+        void beginRecording(std::uint64_t orderKey);
+        void endRecording();
+
+        // order key of the commands added on the update thread outside of a recording, they are
+        // submitted before the recorded buffers with the same key
+        void setOrderKey(std::uint64_t newOrderKey) noexcept { updateOrderKey = newOrderKey; }
+        auto getOrderKey() const noexcept { return updateOrderKey; }
+
+        // hands a command buffer recorded without beginRecording over to the next frame, thread safe
+        void submitCommandBuffer(std::uint64_t orderKey, CommandBuffer&& recordedCommandBuffer);
+
+        // number of frames submitted to the render device and the time spent submitting the last one
+        auto getFrameCount() const noexcept { return frameCount; }
+        auto getPresentDuration() const noexcept { return presentDuration; }
+
+        // returns true when fewer than framesInFlight frames are queued ahead of the one the render device is rendering
+        bool getRefillQueue(bool waitForNextFrame);
+
+        // the time the input of the next presented frame was sampled, used to measure the input latency
+        void setInputTime(std::chrono::steady_clock::time_point time) noexcept { inputTime = time; }
+
+        // time from sampling the input to the render device finishing the presentation of the frame
+        auto getInputLatency() const noexcept { return inputLatency; }
+
+        // average time between the frames of the render device and the time it started the last one
+        auto getFrameInterval() const noexcept { return frameInterval; }
+        auto getLastFrameTime() const noexcept { return lastFrameTime; }
+
+        // frames submitted to the render device that it hasn't finished yet
+        auto getQueuedFrameCount() const noexcept { return frameCount - finishedFrameCount; }
+
+        void addTextureLoad(const std::shared_ptr<TextureLoad>& textureLoad);
 
         math::Vector<float, 2> convertScreenToNormalizedLocation(const math::Vector<float, 2>& position) const noexcept
         {
@@ -97,14 +164,40 @@ namespace ouzel::graphics
     private:
         void changeScreen(const std::uintptr_t screenId);
         void setSize(const math::Size<std::uint32_t, 2>& newSize);
+        void processTextureLoads();
+        void handleDeviceEvent(const RenderDevice::Event& event);
 
         SamplerFilter textureFilter = SamplerFilter::point;
         std::uint32_t maxAnisotropy = 1;
 
+        struct Recording final
+        {
+            std::uint64_t orderKey = 0;
+            CommandBuffer commandBuffer;
+        };
+
         math::Size<std::uint32_t, 2> size;
-        CommandBuffer commandBuffer;
+        CommandBuffer commandBuffer; // commands added on the update thread outside of a recording
+        std::uint64_t updateOrderKey = 0;
+        static thread_local std::unique_ptr<Recording> recording;
+
+        std::vector<std::pair<std::uint64_t, CommandBuffer>> recordedCommandBuffers;
+        std::mutex recordedCommandBuffersMutex;
+        std::vector<std::weak_ptr<TextureLoad>> textureLoads;
+
+        std::uint64_t frameCount = 0;
+        std::chrono::steady_clock::duration presentDuration{};
+
+        std::uint64_t frameEventCount = 0;
+        std::uint64_t finishedFrameCount = 0;
+        std::chrono::steady_clock::time_point inputTime;
+        std::deque<std::chrono::steady_clock::time_point> queuedInputTimes; // of the frames that haven't finished
+        std::chrono::steady_clock::duration inputLatency{};
+        std::chrono::steady_clock::duration frameInterval{};
+        std::chrono::steady_clock::time_point lastFrameTime;
 
         std::unique_ptr<RenderDevice> device;
+        std::unique_ptr<FrameCapture> frameCapture;
     };
 }
 
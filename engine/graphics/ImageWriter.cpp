@@ -0,0 +1,214 @@
+// Ouzel by Elviss Strazdins
+
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include "ImageWriter.hpp"
+
+#ifdef _MSC_VER
+#  pragma warning( push )
+#  pragma warning( disable : 4100 )
+#  pragma warning( disable : 4505 )
+#elif defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wconversion"
+#  pragma GCC diagnostic ignored "-Wdouble-promotion"
+#  pragma GCC diagnostic ignored "-Wold-style-cast"
+#  pragma GCC diagnostic ignored "-Wsign-conversion"
+#  pragma GCC diagnostic ignored "-Wunused-function"
+#  pragma GCC diagnostic ignored "-Wunused-parameter"
+#  ifdef __clang__
+#    pragma GCC diagnostic ignored "-Wcomma"
+#    pragma GCC diagnostic ignored "-Wmissing-prototypes"
+#  endif
+#endif
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#ifdef _MSC_VER
+#  pragma warning( pop )
+#elif defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        void writeFile(const std::string& filename, const std::vector<std::uint8_t>& data)
+        {
+            std::ofstream file{filename, std::ios::binary | std::ios::trunc};
+            if (!file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())))
+                throw std::runtime_error{"Failed to save image to file"};
+        }
+
+        void encodeBigEndian(std::vector<std::uint8_t>& result, std::uint32_t value)
+        {
+            result.push_back(static_cast<std::uint8_t>(value >> 24));
+            result.push_back(static_cast<std::uint8_t>(value >> 16));
+            result.push_back(static_cast<std::uint8_t>(value >> 8));
+            result.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        void encodeLittleEndian(std::vector<std::uint8_t>& result, std::uint32_t value)
+        {
+            result.push_back(static_cast<std::uint8_t>(value));
+            result.push_back(static_cast<std::uint8_t>(value >> 8));
+            result.push_back(static_cast<std::uint8_t>(value >> 16));
+            result.push_back(static_cast<std::uint8_t>(value >> 24));
+        }
+    }
+
+    ImageFileFormat getImageFileFormat(const std::string& filename)
+    {
+        const auto position = filename.find_last_of('.');
+        if (position == std::string::npos) return ImageFileFormat::png;
+
+        const auto extension = filename.substr(position + 1);
+        if (extension == "qoi") return ImageFileFormat::qoi;
+        else if (extension == "raw") return ImageFileFormat::raw;
+        else return ImageFileFormat::png;
+    }
+
+    std::string getImageFileExtension(ImageFileFormat format)
+    {
+        switch (format)
+        {
+            case ImageFileFormat::png: return "png";
+            case ImageFileFormat::qoi: return "qoi";
+            case ImageFileFormat::raw: return "raw";
+            default: throw std::runtime_error{"Invalid image file format"};
+        }
+    }
+
+    std::vector<std::uint8_t> encodeQoi(std::size_t width,
+                                        std::size_t height,
+                                        const std::vector<std::uint8_t>& data)
+    {
+        constexpr std::uint8_t opIndex = 0x00;
+        constexpr std::uint8_t opDiff = 0x40;
+        constexpr std::uint8_t opLuma = 0x80;
+        constexpr std::uint8_t opRun = 0xC0;
+        constexpr std::uint8_t opRgb = 0xFE;
+        constexpr std::uint8_t opRgba = 0xFF;
+        constexpr std::uint32_t maxRun = 62;
+
+        const auto pixelCount = width * height;
+        if (data.size() < pixelCount * 4)
+            throw std::runtime_error{"Invalid image data"};
+
+        std::vector<std::uint8_t> result;
+        result.reserve(14 + pixelCount * 2 + 8);
+
+        result.insert(result.end(), {'q', 'o', 'i', 'f'});
+        encodeBigEndian(result, static_cast<std::uint32_t>(width));
+        encodeBigEndian(result, static_cast<std::uint32_t>(height));
+        result.push_back(4); // channels
+        result.push_back(0); // sRGB with linear alpha
+
+        std::array<std::array<std::uint8_t, 4>, 64> index{};
+        std::array<std::uint8_t, 4> previous{0, 0, 0, 255};
+        std::uint32_t run = 0;
+
+        for (std::size_t i = 0; i < pixelCount; ++i)
+        {
+            const std::array<std::uint8_t, 4> pixel{
+                data[i * 4 + 0], data[i * 4 + 1], data[i * 4 + 2], data[i * 4 + 3]
+            };
+
+            if (pixel == previous)
+            {
+                if (++run == maxRun || i == pixelCount - 1)
+                {
+                    result.push_back(static_cast<std::uint8_t>(opRun | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0)
+            {
+                result.push_back(static_cast<std::uint8_t>(opRun | (run - 1)));
+                run = 0;
+            }
+
+            const auto hash = (pixel[0] * 3U + pixel[1] * 5U + pixel[2] * 7U + pixel[3] * 11U) % 64U;
+
+            if (index[hash] == pixel)
+                result.push_back(static_cast<std::uint8_t>(opIndex | hash));
+            else
+            {
+                index[hash] = pixel;
+
+                if (pixel[3] == previous[3])
+                {
+                    // the differences wrap around like the decoder expects
+                    const auto dr = static_cast<std::int8_t>(static_cast<std::uint8_t>(pixel[0] - previous[0]));
+                    const auto dg = static_cast<std::int8_t>(static_cast<std::uint8_t>(pixel[1] - previous[1]));
+                    const auto db = static_cast<std::int8_t>(static_cast<std::uint8_t>(pixel[2] - previous[2]));
+                    const auto drg = dr - dg;
+                    const auto dbg = db - dg;
+
+                    if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+                        result.push_back(static_cast<std::uint8_t>(opDiff | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+                    else if (drg > -9 && drg < 8 && dg > -33 && dg < 32 && dbg > -9 && dbg < 8)
+                    {
+                        result.push_back(static_cast<std::uint8_t>(opLuma | (dg + 32)));
+                        result.push_back(static_cast<std::uint8_t>(((drg + 8) << 4) | (dbg + 8)));
+                    }
+                    else
+                        result.insert(result.end(), {opRgb, pixel[0], pixel[1], pixel[2]});
+                }
+                else
+                    result.insert(result.end(), {opRgba, pixel[0], pixel[1], pixel[2], pixel[3]});
+            }
+
+            previous = pixel;
+        }
+
+        result.insert(result.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+
+        return result;
+    }
+
+    void writeImage(const std::string& filename,
+                    ImageFileFormat format,
+                    std::size_t width,
+                    std::size_t height,
+                    const std::vector<std::uint8_t>& data)
+    {
+        switch (format)
+        {
+            case ImageFileFormat::png:
+                if (!stbi_write_png(filename.c_str(),
+                                    static_cast<int>(width),
+                                    static_cast<int>(height),
+                                    4,
+                                    data.data(),
+                                    static_cast<int>(width * 4)))
+                    throw std::runtime_error{"Failed to save image to file"};
+                break;
+
+            case ImageFileFormat::qoi:
+                writeFile(filename, encodeQoi(width, height, data));
+                break;
+
+            case ImageFileFormat::raw:
+            {
+                std::vector<std::uint8_t> header;
+                encodeLittleEndian(header, static_cast<std::uint32_t>(width));
+                encodeLittleEndian(header, static_cast<std::uint32_t>(height));
+
+                std::ofstream file{filename, std::ios::binary | std::ios::trunc};
+                if (!file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size())) ||
+                    !file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(width * height * 4)))
+                    throw std::runtime_error{"Failed to save image to file"};
+                break;
+            }
+
+            default:
+                throw std::runtime_error{"Invalid image file format"};
+        }
+    }
+}
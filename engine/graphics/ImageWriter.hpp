@@ -0,0 +1,36 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_IMAGEWRITER_HPP
+#define OUZEL_GRAPHICS_IMAGEWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ouzel::graphics
+{
+    enum class ImageFileFormat
+    {
+        png,
+        qoi, // fast lossless compression, suitable for capturing every frame
+        raw // width and height as 32-bit little endian integers followed by the pixels
+    };
+
+    // returns the format for the extension of the filename, PNG if the extension is unknown
+    ImageFileFormat getImageFileFormat(const std::string& filename);
+    std::string getImageFileExtension(ImageFileFormat format);
+
+    std::vector<std::uint8_t> encodeQoi(std::size_t width,
+                                        std::size_t height,
+                                        const std::vector<std::uint8_t>& data);
+
+    // writes tightly packed RGBA8 pixels, rows top to bottom
+    void writeImage(const std::string& filename,
+                    ImageFileFormat format,
+                    std::size_t width,
+                    std::size_t height,
+                    const std::vector<std::uint8_t>& data);
+}
+
+#endif // OUZEL_GRAPHICS_IMAGEWRITER_HPP
@@ -0,0 +1,26 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_INSTANCE_HPP
+#define OUZEL_GRAPHICS_INSTANCE_HPP
+
+#include "../math/Color.hpp"
+#include "../math/Matrix.hpp"
+
+namespace ouzel::graphics
+{
+    // per-instance data consumed by instanced draws
+    class Instance final
+    {
+    public:
+        constexpr Instance() noexcept = default;
+        constexpr Instance(const math::Matrix<float, 4>& initTransform, math::Color initColor) noexcept:
+            transform{initTransform}, color{initColor}
+        {
+        }
+
+        math::Matrix<float, 4> transform = math::identityMatrix<float, 4>;
+        math::Color color = math::whiteColor;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_INSTANCE_HPP
@@ -0,0 +1,23 @@
+// Ouzel by Elviss Strazdins
+
+#include "Material.hpp"
+#include "../core/Engine.hpp"
+
+namespace ouzel::graphics
+{
+    std::vector<std::size_t> Material::getTextureResources() const
+    {
+        std::vector<std::size_t> result;
+        result.reserve(textureLayers);
+
+        for (const auto& texture : textures)
+            if (!texture)
+                result.push_back(0);
+            else if (!texture->isReady()) // draw with a placeholder until the texture is streamed in
+                result.push_back(engine->getCache().getTexture(textureWhitePixel)->getResource());
+            else
+                result.push_back(texture->getResource());
+
+        return result;
+    }
+}
@@ -4,6 +4,7 @@
 #define OUZEL_GRAPHICS_MATERIAL_HPP
 
 #include <memory>
+#include <vector>
 #include "Graphics.hpp"
 #include "BlendState.hpp"
 #include "Shader.hpp"
@@ -25,13 +26,19 @@ namespace ouzel::graphics
         Material(Material&&) = delete;
         Material& operator=(Material&&) = delete;
 
+        // resources of the texture layers for setTextures, textures that are still loading are replaced by a white pixel
+        std::vector<std::size_t> getTextureResources() const;
+
         const BlendState* blendState = nullptr;
         const Shader* shader = nullptr;
+        const Shader* instancedShader = nullptr; // used when the renderer batches the material
+        const Shader* litShader = nullptr; // used when the layer has lights, the second and third texture layers hold the light data
         std::shared_ptr<Texture> textures[textureLayers];
         CullMode cullMode = CullMode::back;
         math::Color ambientColor = math::whiteColor;
         math::Color diffuseColor = math::whiteColor;
         float opacity = 1.0F;
+        bool opaque = false; // drawn front to back and in the depth pre-pass of depth sorted layers
     };
 }
 
@@ -0,0 +1,288 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+#include "MipmapGenerator.hpp"
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        constexpr float gamma = 2.2F;
+        constexpr float gammaLookup[256] = {
+            0.0F, 5.077051355e-06F, 2.33280025e-05F, 5.692175546e-05F, 0.0001071873558F, 0.0001751239615F, 0.0002615437261F, 0.0003671362065F,
+            0.0004925037501F, 0.0006381827989F, 0.0008046584553F, 0.0009923742618F, 0.001201739418F, 0.001433134428F, 0.001686915057F, 0.001963415882F,
+            0.002262953203F, 0.00258582551F, 0.002932318253F, 0.003302702913F, 0.003697239328F, 0.004116177093F, 0.00455975486F, 0.00502820313F,
+            0.00552174449F, 0.006040593144F, 0.006584956776F, 0.007155036554F, 0.007751026656F, 0.008373117074F, 0.009021490812F, 0.009696328081F,
+            0.01039780304F, 0.01112608239F, 0.01188133471F, 0.01266372018F, 0.01347339712F, 0.01431051921F, 0.01517523825F, 0.01606770046F,
+            0.01698805206F, 0.01793643273F, 0.0189129822F, 0.01991783828F, 0.02095113136F, 0.02201299369F, 0.02310355566F, 0.02422294207F,
+            0.02537127584F, 0.02654868178F, 0.02775527909F, 0.02899118513F, 0.03025651723F, 0.03155139089F, 0.03287591413F, 0.03423020616F,
+            0.03561436757F, 0.03702851385F, 0.03847274557F, 0.03994716704F, 0.04145189002F, 0.04298700765F, 0.04455262423F, 0.04614884034F,
+            0.04777575657F, 0.04943346232F, 0.05112205446F, 0.05284162983F, 0.05459228158F, 0.05637409911F, 0.05818717927F, 0.06003161147F,
+            0.06190747768F, 0.06381487101F, 0.06575388461F, 0.06772459298F, 0.06972708553F, 0.07176145166F, 0.07382776588F, 0.07592612505F,
+            0.07805658877F, 0.08021926135F, 0.08241420984F, 0.08464150876F, 0.08690125495F, 0.08919350803F, 0.0915183574F, 0.09387587011F,
+            0.09626612067F, 0.09868919849F, 0.1011451632F, 0.1036340967F, 0.1061560661F, 0.1087111533F, 0.1112994179F, 0.1139209345F,
+            0.1165757775F, 0.1192640141F, 0.1219857112F, 0.1247409433F, 0.1275297701F, 0.1303522736F, 0.1332085133F, 0.1360985488F,
+            0.1390224546F, 0.1419802904F, 0.1449721307F, 0.1479980201F, 0.151058048F, 0.1541522592F, 0.1572807282F, 0.1604435146F,
+            0.163640663F, 0.166872263F, 0.170138374F, 0.1734390259F, 0.176774323F, 0.1801442802F, 0.1835489869F, 0.1869885027F,
+            0.1904628724F, 0.1939721555F, 0.1975164264F, 0.2010957301F, 0.204710111F, 0.2083596438F, 0.2120443881F, 0.2157643884F,
+            0.2195197344F, 0.2233104259F, 0.2271365523F, 0.2309981436F, 0.234895274F, 0.2388280034F, 0.2427963763F, 0.2468004376F,
+            0.2508402467F, 0.2549158633F, 0.2590273619F, 0.2631747425F, 0.2673580945F, 0.2715774477F, 0.2758328617F, 0.2801243961F,
+            0.2844520807F, 0.288816005F, 0.2932161689F, 0.2976526618F, 0.3021255136F, 0.3066347837F, 0.311180532F, 0.3157627583F,
+            0.3203815818F, 0.3250369728F, 0.3297290504F, 0.3344578147F, 0.3392233551F, 0.3440256715F, 0.3488648534F, 0.3537409306F,
+            0.3586539328F, 0.3636039197F, 0.368590951F, 0.3736150563F, 0.3786762655F, 0.383774668F, 0.3889102638F, 0.3940831423F,
+            0.3992933333F, 0.4045408368F, 0.409825772F, 0.4151481092F, 0.4205079377F, 0.4259053171F, 0.4313402176F, 0.4368127584F,
+            0.4423229694F, 0.4478708506F, 0.4534564912F, 0.4590799212F, 0.4647411406F, 0.4704402685F, 0.4761772752F, 0.48195225F,
+            0.4877652228F, 0.4936162233F, 0.4995052814F, 0.5054324865F, 0.5113978386F, 0.5174013972F, 0.5234431624F, 0.5295232534F,
+            0.5356416106F, 0.5417983532F, 0.5479935408F, 0.5542271137F, 0.5604991913F, 0.5668097734F, 0.5731588602F, 0.5795466304F,
+            0.5859730244F, 0.5924380422F, 0.598941803F, 0.6054843068F, 0.6120656133F, 0.6186857224F, 0.6253447533F, 0.6320426464F,
+            0.6387794614F, 0.6455552578F, 0.6523700953F, 0.6592240334F, 0.6661169529F, 0.6730490923F, 0.6800203323F, 0.6870308518F,
+            0.6940805316F, 0.7011694908F, 0.7082977891F, 0.7154654264F, 0.7226724625F, 0.7299188972F, 0.7372047901F, 0.744530201F,
+            0.7518950701F, 0.7592995763F, 0.7667436004F, 0.7742273211F, 0.781750679F, 0.7893137336F, 0.7969165444F, 0.8045591116F,
+            0.8122414947F, 0.8199636936F, 0.8277258277F, 0.8355277777F, 0.8433697224F, 0.8512516618F, 0.8591735959F, 0.8671355247F,
+            0.8751375675F, 0.8831797242F, 0.8912620544F, 0.8993844986F, 0.9075471759F, 0.9157501459F, 0.9239933491F, 0.932276845F,
+            0.9406006932F, 0.9489649534F, 0.957369566F, 0.9658146501F, 0.9743002057F, 0.9828262329F, 0.9913928509F, 1.0F
+        };
+
+        constexpr std::uint32_t linearMax = 65535;
+
+        // lookup tables between 8-bit gamma encoded values and 16-bit linear values
+        class GammaTables final
+        {
+        public:
+            GammaTables()
+            {
+                for (std::size_t i = 0; i < decode.size(); ++i)
+                    decode[i] = static_cast<std::uint16_t>(std::round(gammaLookup[i] * linearMax));
+
+                for (std::size_t i = 0; i < encode.size(); ++i)
+                    encode[i] = static_cast<std::uint8_t>(std::round(std::pow(static_cast<float>(i) / linearMax, 1.0F / gamma) * 255.0F));
+            }
+
+            std::array<std::uint16_t, 256> decode;
+            std::array<std::uint8_t, linearMax + 1> encode;
+        };
+
+        const GammaTables& getGammaTables()
+        {
+            static const GammaTables gammaTables;
+            return gammaTables;
+        }
+
+        constexpr std::uint16_t decodeLinear(std::uint8_t value) noexcept
+        {
+            return static_cast<std::uint16_t>(value * 257U);
+        }
+
+        constexpr std::uint8_t encodeLinear(std::uint16_t value) noexcept
+        {
+            // rounded division by 257
+            return static_cast<std::uint8_t>((value + 128U - (value >> 8U)) >> 8U);
+        }
+
+        constexpr std::uint16_t average(std::uint16_t a, std::uint16_t b) noexcept
+        {
+            return static_cast<std::uint16_t>((a + b + 1U) >> 1U);
+        }
+
+        // averages 2x2 blocks of the two source rows, one output pixel has channelCount 16-bit values
+        template <std::uint32_t channelCount>
+        void downsampleRow(const std::uint16_t* row0, const std::uint16_t* row1,
+                           std::uint16_t* result, std::uint32_t width) noexcept
+        {
+            std::uint32_t x = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+            constexpr std::uint32_t step = 8 / channelCount;
+
+            for (; x + step <= width; x += step, row0 += 16, row1 += 16, result += 8)
+            {
+                const auto a = _mm_avg_epu16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0)),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1)));
+                const auto b = _mm_avg_epu16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8)),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8)));
+
+                // move the even pixels to the low and the odd pixels to the high half of each register
+                __m128i sortedA;
+                __m128i sortedB;
+                if constexpr (channelCount == 1)
+                {
+                    sortedA = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(a, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+                    sortedB = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(b, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+                }
+                else if constexpr (channelCount == 2)
+                {
+                    sortedA = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 2, 0));
+                    sortedB = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 2, 0));
+                }
+                else
+                {
+                    sortedA = a;
+                    sortedB = b;
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(result),
+                                 _mm_avg_epu16(_mm_unpacklo_epi64(sortedA, sortedB),
+                                               _mm_unpackhi_epi64(sortedA, sortedB)));
+            }
+#elif defined(__ARM_NEON__)
+            constexpr std::uint32_t step = 8 / channelCount;
+
+            for (; x + step <= width; x += step, row0 += 16, row1 += 16, result += 8)
+            {
+                uint16x8_t even;
+                uint16x8_t odd;
+                if constexpr (channelCount == 1)
+                {
+                    const auto a = vld2q_u16(row0);
+                    const auto b = vld2q_u16(row1);
+                    even = vrhaddq_u16(a.val[0], b.val[0]);
+                    odd = vrhaddq_u16(a.val[1], b.val[1]);
+                }
+                else if constexpr (channelCount == 2)
+                {
+                    const auto a = vld2q_u32(reinterpret_cast<const std::uint32_t*>(row0));
+                    const auto b = vld2q_u32(reinterpret_cast<const std::uint32_t*>(row1));
+                    even = vrhaddq_u16(vreinterpretq_u16_u32(a.val[0]), vreinterpretq_u16_u32(b.val[0]));
+                    odd = vrhaddq_u16(vreinterpretq_u16_u32(a.val[1]), vreinterpretq_u16_u32(b.val[1]));
+                }
+                else
+                {
+                    const auto a = vrhaddq_u16(vld1q_u16(row0), vld1q_u16(row1));
+                    const auto b = vrhaddq_u16(vld1q_u16(row0 + 8), vld1q_u16(row1 + 8));
+                    even = vcombine_u16(vget_low_u16(a), vget_low_u16(b));
+                    odd = vcombine_u16(vget_high_u16(a), vget_high_u16(b));
+                }
+
+                vst1q_u16(result, vrhaddq_u16(even, odd));
+            }
+#endif
+
+            for (; x < width; ++x, row0 += channelCount * 2, row1 += channelCount * 2, result += channelCount)
+                for (std::uint32_t c = 0; c < channelCount; ++c)
+                    result[c] = average(average(row0[c], row1[c]),
+                                        average(row0[channelCount + c], row1[channelCount + c]));
+        }
+    }
+
+    MipmapGenerator::MipmapGenerator(PixelFormat pixelFormat, bool luminance)
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::rgba8UnsignedNorm:
+            case PixelFormat::rgba8UnsignedNormSRGB:
+                channelCount = 4;
+                linearAlpha = true;
+                alphaWeighted = true;
+                break;
+
+            case PixelFormat::rg8UnsignedNorm:
+                channelCount = 2;
+                // grey with alpha is filtered like rgba
+                linearAlpha = luminance;
+                alphaWeighted = luminance;
+                break;
+
+            case PixelFormat::r8UnsignedNorm:
+                channelCount = 1;
+                break;
+
+            case PixelFormat::a8UnsignedNorm:
+                channelCount = 1;
+                linearAlpha = true;
+                break;
+
+            default:
+                throw std::runtime_error{"Invalid pixel format"};
+        }
+    }
+
+    void MipmapGenerator::downsample(const math::Size<std::uint32_t, 2>& sourceSize,
+                                     const std::uint8_t* source,
+                                     const math::Size<std::uint32_t, 2>& destinationSize,
+                                     std::uint8_t* destination,
+                                     std::uint32_t firstRow, std::uint32_t lastRow) const
+    {
+        const auto& gammaTables = getGammaTables();
+        const auto sourcePitch = sourceSize.v[0] * channelCount;
+        const auto destinationPitch = destinationSize.v[0] * channelCount;
+
+        std::vector<std::uint16_t> row0(destinationSize.v[0] * 2 * channelCount);
+        std::vector<std::uint16_t> row1(destinationSize.v[0] * 2 * channelCount);
+        std::vector<std::uint16_t> result(destinationPitch);
+
+        // decodes a source row to 16-bit linear values, repeating the last pixel for odd widths
+        const auto decodeRow = [&](std::uint32_t y, std::uint16_t* row) {
+            const auto* sourceRow = source + std::min(y, sourceSize.v[1] - 1) * sourcePitch;
+            for (std::uint32_t x = 0; x < destinationSize.v[0] * 2; ++x, row += channelCount)
+            {
+                const auto* pixel = sourceRow + std::min(x, sourceSize.v[0] - 1) * channelCount;
+                for (std::uint32_t c = 0; c < channelCount; ++c)
+                    row[c] = (linearAlpha && c == channelCount - 1) ? decodeLinear(pixel[c]) : gammaTables.decode[pixel[c]];
+            }
+        };
+
+        for (std::uint32_t y = firstRow; y < lastRow; ++y)
+        {
+            decodeRow(y * 2, row0.data());
+            decodeRow(y * 2 + 1, row1.data());
+
+            switch (channelCount)
+            {
+                case 1: downsampleRow<1>(row0.data(), row1.data(), result.data(), destinationSize.v[0]); break;
+                case 2: downsampleRow<2>(row0.data(), row1.data(), result.data(), destinationSize.v[0]); break;
+                default: downsampleRow<4>(row0.data(), row1.data(), result.data(), destinationSize.v[0]); break;
+            }
+
+            auto* destinationRow = destination + y * destinationPitch;
+            for (std::uint32_t i = 0; i < destinationPitch; i += channelCount)
+                for (std::uint32_t c = 0; c < channelCount; ++c)
+                    destinationRow[i + c] = (linearAlpha && c == channelCount - 1) ? encodeLinear(result[i + c]) : gammaTables.encode[result[i + c]];
+
+            if (alphaWeighted)
+                weightByAlpha(row0.data(), row1.data(), destinationRow, destinationSize.v[0]);
+        }
+    }
+
+    void MipmapGenerator::weightByAlpha(const std::uint16_t* row0, const std::uint16_t* row1,
+                                        std::uint8_t* destinationRow, std::uint32_t width) const
+    {
+        const auto& gammaTables = getGammaTables();
+        const auto alpha = channelCount - 1;
+
+        for (std::uint32_t x = 0; x < width; ++x, row0 += channelCount * 2, row1 += channelCount * 2, destinationRow += channelCount)
+        {
+            if (row0[alpha] && row0[channelCount + alpha] && row1[alpha] && row1[channelCount + alpha]) continue;
+
+            std::uint32_t pixels = 0;
+            std::uint32_t color[3]{};
+
+            for (const auto* pixel : {row0, row0 + channelCount, row1, row1 + channelCount})
+                if (pixel[alpha])
+                {
+                    for (std::uint32_t c = 0; c < alpha; ++c)
+                        color[c] += pixel[c];
+                    ++pixels;
+                }
+
+            if (pixels)
+            {
+                for (std::uint32_t c = 0; c < alpha; ++c)
+                    destinationRow[c] = gammaTables.encode[(color[c] + pixels / 2) / pixels];
+            }
+            else
+            {
+                for (std::uint32_t c = 0; c < channelCount; ++c)
+                    destinationRow[c] = 0;
+            }
+        }
+    }
+}
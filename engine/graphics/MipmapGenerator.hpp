@@ -0,0 +1,39 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_MIPMAPGENERATOR_HPP
+#define OUZEL_GRAPHICS_MIPMAPGENERATOR_HPP
+
+#include <cstdint>
+#include "PixelFormat.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::graphics
+{
+    // Generates mip levels with a gamma correct 2x2 box filter on 16-bit integers
+    // Alpha is filtered linearly and fully transparent pixels don't bleed their color into the level
+    class MipmapGenerator final
+    {
+    public:
+        // throws for formats that can not be downsampled,
+        // luminance rg8 textures hold grey and alpha instead of two color channels
+        explicit MipmapGenerator(PixelFormat pixelFormat, bool luminance = false);
+
+        // generates the rows [firstRow, lastRow) of the destination level,
+        // the last row and column of the source are repeated for odd sizes
+        void downsample(const math::Size<std::uint32_t, 2>& sourceSize,
+                        const std::uint8_t* source,
+                        const math::Size<std::uint32_t, 2>& destinationSize,
+                        std::uint8_t* destination,
+                        std::uint32_t firstRow, std::uint32_t lastRow) const;
+
+    private:
+        void weightByAlpha(const std::uint16_t* row0, const std::uint16_t* row1,
+                           std::uint8_t* destinationRow, std::uint32_t width) const;
+
+        std::uint32_t channelCount = 0;
+        bool linearAlpha = false;
+        bool alphaWeighted = false;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_MIPMAPGENERATOR_HPP
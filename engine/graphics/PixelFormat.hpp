@@ -3,6 +3,8 @@
 #ifndef OUZEL_GRAPHICS_PIXELFORMAT_HPP
 #define OUZEL_GRAPHICS_PIXELFORMAT_HPP
 
+#include <cstdint>
+
 namespace ouzel::graphics
 {
     enum class PixelFormat
@@ -38,9 +40,89 @@ namespace ouzel::graphics
         rgba32SignedInt,
         rgba32Float,
         depth,
-        depthStencil
+        depthStencil,
+        bc1RgbaUnsignedNorm,
+        bc1RgbaUnsignedNormSRGB,
+        bc2RgbaUnsignedNorm,
+        bc2RgbaUnsignedNormSRGB,
+        bc3RgbaUnsignedNorm,
+        bc3RgbaUnsignedNormSRGB,
+        bc4RUnsignedNorm,
+        bc5RgUnsignedNorm,
+        bc6hRgbUnsignedFloat,
+        bc7RgbaUnsignedNorm,
+        bc7RgbaUnsignedNormSRGB,
+        etc2RgbUnsignedNorm,
+        etc2RgbUnsignedNormSRGB,
+        etc2RgbaUnsignedNorm,
+        etc2RgbaUnsignedNormSRGB,
+        eacRUnsignedNorm,
+        eacRgUnsignedNorm,
+        astc4x4RgbaUnsignedNorm,
+        astc4x4RgbaUnsignedNormSRGB
     };
 
+    // block compressed formats store 4x4 pixel blocks
+    inline bool isCompressed(PixelFormat pixelFormat) noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc2RgbaUnsignedNorm:
+            case PixelFormat::bc2RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::bc5RgUnsignedNorm:
+            case PixelFormat::bc6hRgbUnsignedFloat:
+            case PixelFormat::bc7RgbaUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNormSRGB:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+            case PixelFormat::eacRUnsignedNorm:
+            case PixelFormat::eacRgUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNormSRGB:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // size of a 4x4 block in bytes
+    inline std::uint32_t getBlockSize(PixelFormat pixelFormat) noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::eacRUnsignedNorm:
+                return 8;
+            case PixelFormat::bc2RgbaUnsignedNorm:
+            case PixelFormat::bc2RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc5RgUnsignedNorm:
+            case PixelFormat::bc6hRgbUnsignedFloat:
+            case PixelFormat::bc7RgbaUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+            case PixelFormat::eacRgUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNormSRGB:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
     inline std::uint32_t getPixelSize(PixelFormat pixelFormat) noexcept
     {
         switch (pixelFormat)
@@ -175,10 +257,47 @@ namespace ouzel::graphics
             case PixelFormat::depth:
             case PixelFormat::depthStencil:
                 return 1;
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::eacRUnsignedNorm:
+                return 1;
+            case PixelFormat::bc5RgUnsignedNorm:
+            case PixelFormat::eacRgUnsignedNorm:
+                return 2;
+            case PixelFormat::bc6hRgbUnsignedFloat:
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+                return 3;
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc2RgbaUnsignedNorm:
+            case PixelFormat::bc2RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc7RgbaUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+            case PixelFormat::astc4x4RgbaUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNormSRGB:
+                return 4;
             default:
                 return 0;
         }
     }
+
+    // size of one row of pixels (or of 4x4 blocks for compressed formats) in bytes
+    inline std::uint32_t getRowPitch(PixelFormat pixelFormat, std::uint32_t width) noexcept
+    {
+        return isCompressed(pixelFormat) ?
+            ((width + 3) / 4) * getBlockSize(pixelFormat) :
+            width * getPixelSize(pixelFormat);
+    }
+
+    inline std::uint32_t getDataSize(PixelFormat pixelFormat, std::uint32_t width, std::uint32_t height) noexcept
+    {
+        return getRowPitch(pixelFormat, width) *
+            (isCompressed(pixelFormat) ? (height + 3) / 4 : height);
+    }
 }
 
 #endif // OUZEL_GRAPHICS_PIXELFORMAT_HPP
@@ -1,11 +1,36 @@
 // Ouzel by Elviss Strazdins
 
 #include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
 #include "RenderDevice.hpp"
-#include "stb_image_write.h"
+#include "../core/Engine.hpp"
+#include "../storage/Path.hpp"
 
 namespace ouzel::graphics
 {
+    namespace
+    {
+        template <class Extent, class T>
+        std::size_t getLevelsSize(const std::vector<std::pair<Extent, std::vector<T>>>& levels) noexcept
+        {
+            std::size_t result = 0;
+            for (const auto& level : levels)
+                result += level.second.size() * sizeof(T);
+            return result;
+        }
+
+        template <class T>
+        std::size_t getConstantsSize(const std::vector<std::vector<T>>& constants) noexcept
+        {
+            std::size_t result = 0;
+            for (const auto& constant : constants)
+                result += constant.size() * sizeof(T);
+            return result;
+        }
+    }
+
     RenderDevice::RenderDevice(Driver initDriver,
                                const Settings& settings,
                                core::Window& initWindow):
@@ -17,18 +42,180 @@ namespace ouzel::graphics
         depth{settings.depth},
         stencil{settings.stencil},
         debugRenderer{settings.debugRenderer},
+        textureUploadBudget{settings.textureUploadBudget},
         npotTexturesSupported{false},
         anisotropicFilteringSupported{false},
         renderTargetsSupported{false},
         clampToBorderSupported{false},
         multisamplingSupported{false},
         uintIndicesSupported{false},
+        instancingSupported{false},
+        textureStreamingSupported{false},
+        luminanceTexturesSupported{false},
+        bcTexturesSupported{false},
+        bptcTexturesSupported{false},
+        etc2TexturesSupported{false},
+        astcTexturesSupported{false},
+        framesInFlight{settings.framesInFlight},
         previousFrameTime{std::chrono::steady_clock::now()}
     {
+        if (framesInFlight < 1 || framesInFlight > 3)
+            throw std::runtime_error{"Frames in flight must be between 1 and 3"};
+    }
+
+    bool RenderDevice::isPixelFormatSupported(PixelFormat pixelFormat) const noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::bc1RgbaUnsignedNorm:
+            case PixelFormat::bc1RgbaUnsignedNormSRGB:
+            case PixelFormat::bc2RgbaUnsignedNorm:
+            case PixelFormat::bc2RgbaUnsignedNormSRGB:
+            case PixelFormat::bc3RgbaUnsignedNorm:
+            case PixelFormat::bc3RgbaUnsignedNormSRGB:
+            case PixelFormat::bc4RUnsignedNorm:
+            case PixelFormat::bc5RgUnsignedNorm:
+                return bcTexturesSupported;
+            case PixelFormat::bc6hRgbUnsignedFloat:
+            case PixelFormat::bc7RgbaUnsignedNorm:
+            case PixelFormat::bc7RgbaUnsignedNormSRGB:
+                return bptcTexturesSupported;
+            case PixelFormat::etc2RgbUnsignedNorm:
+            case PixelFormat::etc2RgbUnsignedNormSRGB:
+            case PixelFormat::etc2RgbaUnsignedNorm:
+            case PixelFormat::etc2RgbaUnsignedNormSRGB:
+            case PixelFormat::eacRUnsignedNorm:
+            case PixelFormat::eacRgUnsignedNorm:
+                return etc2TexturesSupported;
+            case PixelFormat::astc4x4RgbaUnsignedNorm:
+            case PixelFormat::astc4x4RgbaUnsignedNormSRGB:
+                return astcTexturesSupported;
+            default:
+                return true;
+        }
+    }
+
+    std::string_view RenderDevice::getCommandName(Command::Type type) noexcept
+    {
+        switch (type)
+        {
+            case Command::Type::resize: return "resize";
+            case Command::Type::present: return "present";
+            case Command::Type::deleteResource: return "deleteResource";
+            case Command::Type::initRenderTarget: return "initRenderTarget";
+            case Command::Type::setRenderTarget: return "setRenderTarget";
+            case Command::Type::clearRenderTarget: return "clearRenderTarget";
+            case Command::Type::setScissorTest: return "setScissorTest";
+            case Command::Type::setViewport: return "setViewport";
+            case Command::Type::initDepthStencilState: return "initDepthStencilState";
+            case Command::Type::setDepthStencilState: return "setDepthStencilState";
+            case Command::Type::setPipelineState: return "setPipelineState";
+            case Command::Type::draw: return "draw";
+            case Command::Type::drawInstanced: return "drawInstanced";
+            case Command::Type::initBlendState: return "initBlendState";
+            case Command::Type::initBuffer: return "initBuffer";
+            case Command::Type::setBufferData: return "setBufferData";
+            case Command::Type::initShader: return "initShader";
+            case Command::Type::setShaderConstants: return "setShaderConstants";
+            case Command::Type::initTexture: return "initTexture";
+            case Command::Type::setTextureData: return "setTextureData";
+            case Command::Type::setTextureRegion: return "setTextureRegion";
+            case Command::Type::setTextureParameters: return "setTextureParameters";
+            case Command::Type::uploadTextureData: return "uploadTextureData";
+            case Command::Type::setTextures: return "setTextures";
+            case Command::Type::discardRenderTarget: return "discardRenderTarget";
+            case Command::Type::initRenderPass: return "initRenderPass";
+            case Command::Type::setRenderPassParameters: return "setRenderPassParameters";
+            case Command::Type::initMaterial: return "initMaterial";
+            case Command::Type::setMaterialParameter: return "setMaterialParameter";
+            case Command::Type::initObject: return "initObject";
+            case Command::Type::setObjectParameters: return "setObjectParameters";
+            case Command::Type::initCamera: return "initCamera";
+            case Command::Type::setCameraParameters: return "setCameraParameters";
+            case Command::Type::initLight: return "initLight";
+            case Command::Type::setLightParameters: return "setLightParameters";
+            default: return "unknown";
+        }
+    }
+
+    std::size_t RenderDevice::getCommandSize(const Command& command) noexcept
+    {
+        switch (command.type)
+        {
+            case Command::Type::resize: return sizeof(ResizeCommand);
+            case Command::Type::present: return sizeof(PresentCommand);
+            case Command::Type::deleteResource: return sizeof(DeleteResourceCommand);
+            case Command::Type::initRenderTarget:
+            {
+                const auto& c = static_cast<const InitRenderTargetCommand&>(command);
+                return sizeof(c) + c.colorTextures.size() * sizeof(ResourceId);
+            }
+            case Command::Type::setRenderTarget: return sizeof(SetRenderTargetCommand);
+            case Command::Type::clearRenderTarget: return sizeof(ClearRenderTargetCommand);
+            case Command::Type::discardRenderTarget: return sizeof(DiscardRenderTargetCommand);
+            case Command::Type::setScissorTest: return sizeof(SetScissorTestCommand);
+            case Command::Type::setViewport: return sizeof(SetViewportCommand);
+            case Command::Type::initDepthStencilState: return sizeof(InitDepthStencilStateCommand);
+            case Command::Type::setDepthStencilState: return sizeof(SetDepthStencilStateCommand);
+            case Command::Type::setPipelineState: return sizeof(SetPipelineStateCommand);
+            case Command::Type::draw: return sizeof(DrawCommand);
+            case Command::Type::drawInstanced: return sizeof(DrawInstancedCommand);
+            case Command::Type::initBlendState: return sizeof(InitBlendStateCommand);
+            case Command::Type::initBuffer:
+            {
+                const auto& c = static_cast<const InitBufferCommand&>(command);
+                return sizeof(c) + c.data.size();
+            }
+            case Command::Type::setBufferData:
+            {
+                const auto& c = static_cast<const SetBufferDataCommand&>(command);
+                return sizeof(c) + c.data.size();
+            }
+            case Command::Type::initShader:
+            {
+                const auto& c = static_cast<const InitShaderCommand&>(command);
+                return sizeof(c) + c.fragmentShader.size() + c.vertexShader.size();
+            }
+            case Command::Type::setShaderConstants:
+            {
+                const auto& c = static_cast<const SetShaderConstantsCommand&>(command);
+                return sizeof(c) + getConstantsSize(c.fragmentShaderConstants) + getConstantsSize(c.vertexShaderConstants);
+            }
+            case Command::Type::initTexture:
+            {
+                const auto& c = static_cast<const InitTextureCommand&>(command);
+                return sizeof(c) + getLevelsSize(c.levels);
+            }
+            case Command::Type::setTextureData:
+            {
+                const auto& c = static_cast<const SetTextureDataCommand&>(command);
+                return sizeof(c) + getLevelsSize(c.levels);
+            }
+            case Command::Type::setTextureRegion:
+            {
+                const auto& c = static_cast<const SetTextureRegionCommand&>(command);
+                return sizeof(c) + getLevelsSize(c.levels);
+            }
+            case Command::Type::setTextureParameters: return sizeof(SetTextureParametersCommand);
+            case Command::Type::uploadTextureData:
+            {
+                const auto& c = static_cast<const UploadTextureDataCommand&>(command);
+                return sizeof(c) + getLevelsSize(c.levels);
+            }
+            case Command::Type::setTextures:
+            {
+                const auto& c = static_cast<const SetTexturesCommand&>(command);
+                return sizeof(c) + c.textures.size() * sizeof(ResourceId);
+            }
+            default: return sizeof(Command);
+        }
     }
 
     void RenderDevice::process()
     {
+        ++renderFrame;
+        completedFrame = renderFrame > framesInFlight + 2 ? renderFrame - framesInFlight - 2 : 0;
+
         const auto currentTime = std::chrono::steady_clock::now();
         const auto diff = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - previousFrameTime);
         previousFrameTime = currentTime;
@@ -48,9 +235,154 @@ namespace ouzel::graphics
             currentAccumulatedFps = 0.0F;
         }
 
-        std::unique_lock lock{eventQueueMutex};
+        std::unique_lock frameStatsLock{frameStatsMutex};
+        frameStats = std::move(currentFrameStats);
+        frameStatsLock.unlock();
+        currentFrameStats = FrameStats{};
+
+        if (commandTimingEnabled)
+        {
+            std::unique_lock lock{commandTimingsMutex};
+            commandTimings = currentCommandTimings;
+        }
+
         Event event;
         event.type = Event::Type::frame;
+        event.time = currentTime;
+        postEvent(event);
+    }
+
+    CommandBuffer RenderDevice::getCommandBuffer()
+    {
+        std::scoped_lock lock{commandBufferPoolMutex};
+
+        if (commandBufferPool.empty()) return CommandBuffer{};
+
+        auto result = std::move(commandBufferPool.back());
+        commandBufferPool.pop_back();
+        return result;
+    }
+
+    void RenderDevice::recycleCommandBuffer(CommandBuffer&& commandBuffer)
+    {
+        // keep enough buffers for the frames in flight and the threads recording them
+        constexpr std::size_t maxPooledCommandBuffers = 16;
+
+        if (!commandBuffer.getCapacity()) return;
+
+        std::scoped_lock lock{commandBufferPoolMutex};
+        if (commandBufferPool.size() >= maxPooledCommandBuffers) return;
+
+        commandBuffer.reset();
+        commandBufferPool.push_back(std::move(commandBuffer));
+    }
+
+    void RenderDevice::releaseResourceId(ResourceId id)
+    {
+        std::scoped_lock lock{resourceIdMutex};
+
+        const auto index = getResourceIndex(id);
+        if (index >= resourceGenerations.size() ||
+            (resourceGenerations[index] & resourceGenerationMask) != getResourceGeneration(id))
+            return;
+
+        ++resourceGenerations[index];
+        freeResourceSlots.push_back(index);
+    }
+
+    RenderDevice::FrameStats RenderDevice::getFrameStats() const
+    {
+        std::unique_lock lock{frameStatsMutex};
+        return frameStats;
+    }
+
+    void RenderDevice::countCommand(const Command& command)
+    {
+        if (!currentFrameStats.commandCount) frameStartTime = std::chrono::steady_clock::now();
+
+        ++currentFrameStats.commandCount;
+        currentFrameStats.commandMemory += getCommandSize(command);
+
+        const auto getTriangleCount = [](DrawMode drawMode, std::uint32_t indexCount) noexcept -> std::uint64_t {
+            switch (drawMode)
+            {
+                case DrawMode::triangleList: return indexCount / 3;
+                case DrawMode::triangleStrip: return indexCount > 2 ? indexCount - 2 : 0;
+                default: return 0;
+            }
+        };
+
+        switch (command.type)
+        {
+            case Command::Type::present:
+                currentFrameStats.cpuTime = std::chrono::steady_clock::now() - frameStartTime;
+                break;
+            case Command::Type::draw:
+            {
+                const auto& drawCommand = static_cast<const DrawCommand&>(command);
+                ++currentFrameStats.drawCallCount;
+                currentFrameStats.triangleCount += getTriangleCount(drawCommand.drawMode, drawCommand.indexCount);
+                break;
+            }
+            case Command::Type::drawInstanced:
+            {
+                const auto& drawInstancedCommand = static_cast<const DrawInstancedCommand&>(command);
+                ++currentFrameStats.drawCallCount;
+                currentFrameStats.triangleCount += getTriangleCount(drawInstancedCommand.drawMode, drawInstancedCommand.indexCount) *
+                    drawInstancedCommand.instanceCount;
+                break;
+            }
+            case Command::Type::setRenderTarget:
+                ++currentFrameStats.renderTargetChanges;
+                break;
+            case Command::Type::setPipelineState:
+                ++currentFrameStats.pipelineStateChanges;
+                break;
+            case Command::Type::setDepthStencilState:
+                ++currentFrameStats.depthStencilStateChanges;
+                break;
+            case Command::Type::setTextures:
+                ++currentFrameStats.textureChanges;
+                break;
+            case Command::Type::setShaderConstants:
+                ++currentFrameStats.shaderConstantChanges;
+                break;
+            case Command::Type::setViewport:
+            case Command::Type::setScissorTest:
+                ++currentFrameStats.viewportChanges;
+                break;
+            case Command::Type::initBuffer:
+                currentFrameStats.bufferBytesUploaded += static_cast<const InitBufferCommand&>(command).data.size();
+                break;
+            case Command::Type::setBufferData:
+                currentFrameStats.bufferBytesUploaded += static_cast<const SetBufferDataCommand&>(command).data.size();
+                break;
+            case Command::Type::initTexture:
+                currentFrameStats.textureBytesUploaded += getLevelsSize(static_cast<const InitTextureCommand&>(command).levels);
+                break;
+            case Command::Type::setTextureData:
+                currentFrameStats.textureBytesUploaded += getLevelsSize(static_cast<const SetTextureDataCommand&>(command).levels);
+                break;
+            case Command::Type::setTextureRegion:
+                currentFrameStats.textureBytesUploaded += getLevelsSize(static_cast<const SetTextureRegionCommand&>(command).levels);
+                break;
+            case Command::Type::uploadTextureData:
+                currentFrameStats.textureBytesUploaded += getLevelsSize(static_cast<const UploadTextureDataCommand&>(command).levels);
+                break;
+            default:
+                break;
+        }
+    }
+
+    RenderDevice::CommandTimings RenderDevice::getCommandTimings() const
+    {
+        std::unique_lock lock{commandTimingsMutex};
+        return commandTimings;
+    }
+
+    void RenderDevice::postEvent(const Event& event)
+    {
+        std::unique_lock lock{eventQueueMutex};
         eventQueue.push(event);
         lock.unlock();
         eventQueueCondition.notify_all();
@@ -86,6 +418,22 @@ namespace ouzel::graphics
         executeQueue.push(func);
     }
 
+    void RenderDevice::waitForIdle()
+    {
+        std::unique_lock lock{commandQueueMutex};
+        idleCondition.wait(lock, [this]() noexcept { return idle && commandQueue.empty(); });
+    }
+
+    void RenderDevice::waitForCommands(std::unique_lock<std::mutex>& lock)
+    {
+        if (!commandQueue.empty()) return;
+
+        idle = true;
+        idleCondition.notify_all();
+        commandQueueCondition.wait(lock, [this]() noexcept { return !commandQueue.empty(); });
+        idle = false;
+    }
+
     void RenderDevice::executeAll()
     {
         std::function<void()> func;
@@ -108,14 +456,96 @@ namespace ouzel::graphics
                                       std::size_t height,
                                       std::size_t pixelSize,
                                       const void *data,
-                                      std::size_t stride)
-    {
-        if (!stbi_write_png(filename.c_str(),
-                            static_cast<int>(width),
-                            static_cast<int>(height),
-                            static_cast<int>(pixelSize),
-                            data,
-                            static_cast<int>(stride)))
-            throw std::runtime_error{"Failed to save image to file"};
+                                      std::size_t stride,
+                                      bool flipVertically)
+    {
+        if (pixelSize != 4)
+            throw std::runtime_error{"Unsupported screenshot pixel size"};
+
+        // only the copy is done on the render thread
+        std::vector<std::uint8_t> pixels(width * height * 4);
+        for (std::size_t row = 0; row < height; ++row)
+            std::memcpy(pixels.data() + row * width * 4,
+                        static_cast<const std::uint8_t*>(data) + row * stride,
+                        width * 4);
+
+        writeImageAsync(filename, width, height, std::move(pixels), flipVertically);
+    }
+
+    void RenderDevice::writeImageAsync(const std::string& filename,
+                                       std::size_t width,
+                                       std::size_t height,
+                                       std::vector<std::uint8_t> data,
+                                       bool flipVertically)
+    {
+        ++*pendingImageWrites;
+
+        core::TaskGroup taskGroup;
+        taskGroup.add([filename, width, height, data = std::move(data), flipVertically,
+                       pendingWrites = pendingImageWrites]() mutable {
+            try
+            {
+                if (flipVertically)
+                    for (std::size_t row = 0; row < height / 2; ++row)
+                        std::swap_ranges(data.begin() + static_cast<std::ptrdiff_t>(row * width * 4),
+                                         data.begin() + static_cast<std::ptrdiff_t>((row + 1) * width * 4),
+                                         data.begin() + static_cast<std::ptrdiff_t>((height - row - 1) * width * 4));
+
+                writeImage(filename, getImageFileFormat(filename), width, height, data);
+            }
+            catch (const std::exception& e)
+            {
+                log(Log::Level::error) << "Failed to write " << filename << ": " << e.what();
+            }
+
+            --*pendingWrites;
+        });
+
+        engine->getWorkerPool().run(std::move(taskGroup));
+    }
+
+    void RenderDevice::captureFrameImages()
+    {
+        for (const auto& filename : pendingScreenshots)
+            generateScreenshot(filename);
+        pendingScreenshots.clear();
+
+        if (!frameRecording) return;
+
+        // drop frames instead of stalling the render thread when the encoding falls behind
+        constexpr std::size_t maxPendingImages = 8;
+        if (getPendingImageCount() >= maxPendingImages)
+        {
+            ++droppedFrameCount;
+            return;
+        }
+
+        std::ostringstream name;
+        name << "frame" << std::setw(6) << std::setfill('0') << recordedFrameCount++ <<
+            '.' << getImageFileExtension(frameRecordingFormat);
+
+        generateScreenshot(std::string{storage::Path{frameRecordingDirectory} / storage::Path{name.str()}});
+    }
+
+    void RenderDevice::queueScreenshot(const std::string& filename)
+    {
+        pendingScreenshots.push_back(filename);
+    }
+
+    void RenderDevice::startFrameRecording(const std::string& directory, ImageFileFormat format)
+    {
+        frameRecording = true;
+        frameRecordingDirectory = directory;
+        frameRecordingFormat = format;
+        recordedFrameCount = 0;
+        droppedFrameCount = 0;
+    }
+
+    void RenderDevice::stopFrameRecording()
+    {
+        if (!frameRecording) return;
+
+        frameRecording = false;
+        log(Log::Level::info) << "Recorded " << recordedFrameCount << " frames, dropped " << droppedFrameCount;
     }
 }
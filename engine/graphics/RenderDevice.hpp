@@ -5,13 +5,22 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
-#include <set>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include "Commands.hpp"
 #include "Driver.hpp"
+#include "ImageWriter.hpp"
+#include "Instance.hpp"
+#include "PixelFormat.hpp"
 #include "SamplerFilter.hpp"
 #include "Settings.hpp"
 #include "Vertex.hpp"
@@ -62,6 +71,8 @@ namespace ouzel::graphics
     {
         friend Graphics;
     public:
+        static constexpr std::size_t commandTypeCount = static_cast<std::size_t>(Command::Type::setLightParameters) + 1;
+
         static constexpr std::array<Vertex::Attribute, 5> vertexAttributes{
             Vertex::Attribute{{Vertex::Attribute::Usage::position}, DataType::float32Vector3},
             Vertex::Attribute{{Vertex::Attribute::Usage::color}, DataType::unsignedByteVector4Norm},
@@ -70,14 +81,55 @@ namespace ouzel::graphics
             Vertex::Attribute{{Vertex::Attribute::Usage::normal}, DataType::float32Vector3}
         };
 
+        static constexpr std::array<Vertex::Attribute, 5> instanceAttributes{
+            Vertex::Attribute{{Vertex::Attribute::Usage::instanceTransform, 0U}, DataType::float32Vector4},
+            Vertex::Attribute{{Vertex::Attribute::Usage::instanceTransform, 1U}, DataType::float32Vector4},
+            Vertex::Attribute{{Vertex::Attribute::Usage::instanceTransform, 2U}, DataType::float32Vector4},
+            Vertex::Attribute{{Vertex::Attribute::Usage::instanceTransform, 3U}, DataType::float32Vector4},
+            Vertex::Attribute{{Vertex::Attribute::Usage::instanceColor}, DataType::unsignedByteVector4Norm}
+        };
+
         struct Event final
         {
             enum class Type
             {
-                frame
+                frame,
+                textureReady
             };
 
             Type type;
+            ResourceId resource = 0;
+            std::chrono::steady_clock::time_point time; // when the event was posted
+        };
+
+        // statistics of one frame, published when the render device starts the next frame
+        struct FrameStats final
+        {
+            std::uint32_t commandCount = 0;
+            std::size_t commandMemory = 0; // size of the command objects and of the data they own
+            std::uint32_t drawCallCount = 0;
+            std::uint64_t triangleCount = 0;
+            std::uint32_t renderTargetChanges = 0;
+            std::uint32_t pipelineStateChanges = 0;
+            std::uint32_t depthStencilStateChanges = 0;
+            std::uint32_t textureChanges = 0;
+            std::uint32_t shaderConstantChanges = 0;
+            std::uint32_t viewportChanges = 0; // viewport and scissor test
+            std::uint64_t bufferBytesUploaded = 0;
+            std::uint64_t textureBytesUploaded = 0;
+            std::chrono::steady_clock::duration cpuTime{}; // render thread time from the first command to present
+
+            // GPU time of each render target (0 for the back buffer) in the order they were rendered to,
+            // the timer queries complete asynchronously, so these belong to one of the previous frames
+            bool gpuTimesAvailable = false;
+            std::vector<std::pair<ResourceId, std::chrono::nanoseconds>> gpuTimes;
+        };
+
+        // time the render thread spent processing each command type, published every frame
+        struct CommandTimings final
+        {
+            std::array<std::uint64_t, commandTypeCount> counts{};
+            std::array<std::chrono::steady_clock::duration, commandTypeCount> durations{};
         };
 
         RenderDevice(Driver initDriver,
@@ -97,6 +149,7 @@ namespace ouzel::graphics
         virtual void process();
 
         auto getSampleCount() const noexcept { return sampleCount; }
+        auto getFramesInFlight() const noexcept { return framesInFlight; }
 
         virtual std::vector<math::Size<std::uint32_t, 2>> getSupportedResolutions() const;
 
@@ -108,7 +161,21 @@ namespace ouzel::graphics
             commandQueueCondition.notify_all();
         }
 
-        auto getDrawCallCount() const noexcept { return drawCallCount; }
+        // queues the command buffers of a frame in order, the commands themselves are not copied
+        void submitCommandBuffers(std::vector<CommandBuffer>&& commandBuffers)
+        {
+            std::unique_lock lock{commandQueueMutex};
+            for (auto& commandBuffer : commandBuffers)
+                commandQueue.push(std::move(commandBuffer));
+            lock.unlock();
+            commandQueueCondition.notify_all();
+        }
+
+        // returns an empty command buffer, reusing the storage of the buffers the render thread has finished
+        CommandBuffer getCommandBuffer();
+
+        FrameStats getFrameStats() const;
+        auto getDrawCallCount() const { return getFrameStats().drawCallCount; }
 
         auto getAPIMajorVersion() const noexcept { return apiVersion.v[0]; }
         auto getAPIMinorVersion() const noexcept { return apiVersion.v[1]; }
@@ -116,6 +183,14 @@ namespace ouzel::graphics
         auto isNpotTexturesSupported() const noexcept { return npotTexturesSupported; }
         auto isAnisotropicFilteringSupported() const noexcept { return anisotropicFilteringSupported; }
         auto isRenderTargetsSupported() const noexcept { return renderTargetsSupported; }
+        // the device can draw instanced, the default instanced shader exists only for OpenGL and the CPU devices,
+        // so on Direct3D 11 and Metal the materials have no instancedShader and the meshes are drawn one by one
+        auto isInstancingSupported() const noexcept { return instancingSupported; }
+        auto isTextureStreamingSupported() const noexcept { return textureStreamingSupported; }
+        auto isLuminanceTexturesSupported() const noexcept { return luminanceTexturesSupported; }
+        bool isPixelFormatSupported(PixelFormat pixelFormat) const noexcept;
+
+        auto getTextureUploadBudget() const noexcept { return textureUploadBudget; }
 
         auto& getProjectionTransform(bool renderTarget) const noexcept
         {
@@ -130,6 +205,15 @@ namespace ouzel::graphics
 
         void executeOnRenderThread(const std::function<void()>& func);
 
+        // blocks until the render thread has processed every command buffer submitted before the call
+        void waitForIdle();
+
+        static std::string_view getCommandName(Command::Type type) noexcept;
+        static std::size_t getCommandSize(const Command& command) noexcept;
+
+        void setCommandTimingEnabled(bool enabled) noexcept { commandTimingEnabled = enabled; }
+        CommandTimings getCommandTimings() const;
+
         using ResourceId = std::size_t;
         class Resource final
         {
@@ -176,16 +260,72 @@ namespace ouzel::graphics
         };
 
     protected:
+        // measures the processing of one command if command timing is enabled
+        class CommandTimer final
+        {
+        public:
+            CommandTimer(RenderDevice& initRenderDevice, Command::Type initType) noexcept:
+                renderDevice{initRenderDevice.commandTimingEnabled ? &initRenderDevice : nullptr},
+                type{static_cast<std::size_t>(initType)}
+            {
+                if (renderDevice) startTime = std::chrono::steady_clock::now();
+            }
+
+            ~CommandTimer()
+            {
+                if (renderDevice && type < commandTypeCount)
+                {
+                    ++renderDevice->currentCommandTimings.counts[type];
+                    renderDevice->currentCommandTimings.durations[type] += std::chrono::steady_clock::now() - startTime;
+                }
+            }
+
+            CommandTimer(const CommandTimer&) = delete;
+            CommandTimer& operator=(const CommandTimer&) = delete;
+
+        private:
+            RenderDevice* renderDevice;
+            std::size_t type;
+            std::chrono::steady_clock::time_point startTime;
+        };
+
         void executeAll();
+        // waits on the render thread for the next command buffer, the lock must hold commandQueueMutex
+        void waitForCommands(std::unique_lock<std::mutex>& lock);
+        void postEvent(const Event& event);
+        void countCommand(const Command& command);
+        void recycleCommandBuffer(CommandBuffer&& commandBuffer);
+
+        // makes the slot of a destroyed resource available for new handles, called on the render thread
+        void releaseResourceId(ResourceId id);
 
         virtual void changeScreen(const std::uintptr_t) {}
+        // reads back the back buffer, called before the frame is presented
         virtual void generateScreenshot(const std::string& filename);
         void saveScreenshot(const std::string& filename,
                             std::size_t width,
                             std::size_t height,
                             std::size_t pixelSize,
                             const void *data,
-                            std::size_t stride);
+                            std::size_t stride,
+                            bool flipVertically = false);
+
+        // encodes and writes the RGBA8 image on a worker thread
+        void writeImageAsync(const std::string& filename,
+                             std::size_t width,
+                             std::size_t height,
+                             std::vector<std::uint8_t> data,
+                             bool flipVertically);
+
+        // images that are being read back or written
+        virtual std::size_t getPendingImageCount() const noexcept { return *pendingImageWrites; }
+
+        // takes the requested screenshots and the recorded frame, called by the devices before presenting
+        void captureFrameImages();
+
+        void queueScreenshot(const std::string& filename);
+        void startFrameRecording(const std::string& directory, ImageFileFormat format);
+        void stopFrameRecording();
 
         Driver driver;
         core::Window& window;
@@ -199,6 +339,7 @@ namespace ouzel::graphics
         bool depth = false;
         bool stencil = false;
         bool debugRenderer = false;
+        std::uint32_t textureUploadBudget = 0; // bytes of streamed texture data uploaded per frame, 0 for unlimited
 
         // features
         bool npotTexturesSupported:1;
@@ -207,39 +348,87 @@ namespace ouzel::graphics
         bool clampToBorderSupported:1;
         bool multisamplingSupported:1;
         bool uintIndicesSupported:1;
+        bool instancingSupported:1;
+        bool textureStreamingSupported:1;
+        bool luminanceTexturesSupported:1; // Flags::luminance
+        bool bcTexturesSupported:1; // BC1-BC5
+        bool bptcTexturesSupported:1; // BC6H and BC7
+        bool etc2TexturesSupported:1;
+        bool astcTexturesSupported:1;
 
         math::Matrix<float, 4> projectionTransform = math::identityMatrix<float, 4>;
         math::Matrix<float, 4> renderTargetProjectionTransform = math::identityMatrix<float, 4>;
 
-        std::uint32_t drawCallCount = 0;
+        FrameStats currentFrameStats; // accessed only by the render thread
+
+        // the last frame that the GPU has finished, resources retired in it can be destroyed
+        std::uint64_t getCompletedFrame() const noexcept { return completedFrame; }
+
+        std::uint32_t framesInFlight = 1; // frames that can be queued ahead of the one being rendered
+        std::uint64_t renderFrame = 0; // incremented by process on the render thread
+        // devices with fences update this after process, the others assume
+        // that the GPU lags at most framesInFlight + 1 frames behind
+        std::uint64_t completedFrame = 0;
 
         std::queue<CommandBuffer> commandQueue;
         std::mutex commandQueueMutex;
         std::condition_variable commandQueueCondition;
+        bool idle = false; // the render thread is waiting for commands, guarded by commandQueueMutex
+        std::condition_variable idleCondition;
 
         std::queue<std::function<void()>> executeQueue;
         std::mutex executeMutex;
 
     private:
+        // resources can be created and destroyed on any thread that records commands
         ResourceId createResourceId()
         {
-            if (const auto i = deletedResourceIds.begin(); i != deletedResourceIds.end())
+            std::scoped_lock lock{resourceIdMutex};
+
+            // the slots are reused in FIFO order to maximize the time before a generation repeats
+            if (!freeResourceSlots.empty())
             {
-                const auto resourceId = *i;
-                deletedResourceIds.erase(i);
-                return resourceId;
+                const auto index = freeResourceSlots.front();
+                freeResourceSlots.pop_front();
+                return makeResourceId(index, resourceGenerations[index]);
             }
-            else
-                return ++lastResourceId;
+
+            if (resourceGenerations.size() >= resourceIndexMask)
+                throw std::runtime_error{"Too many resources"};
+
+            resourceGenerations.push_back(0);
+            return makeResourceId(resourceGenerations.size() - 1, 0);
         }
 
+        // the delete commands are added to the end of the frame by Graphics
         void deleteResourceId(ResourceId id)
         {
-            deletedResourceIds.insert(id);
+            std::scoped_lock lock{resourceIdMutex};
+            deletedResourceIds.push_back(id);
+        }
+
+        std::vector<ResourceId> takeDeletedResourceIds()
+        {
+            std::scoped_lock lock{resourceIdMutex};
+            return std::exchange(deletedResourceIds, {});
         }
 
-        ResourceId lastResourceId = 0;
-        std::set<ResourceId> deletedResourceIds;
+        std::vector<std::string> pendingScreenshots;
+        bool frameRecording = false;
+        std::string frameRecordingDirectory;
+        ImageFileFormat frameRecordingFormat = ImageFileFormat::qoi;
+        std::uint32_t recordedFrameCount = 0;
+        std::uint32_t droppedFrameCount = 0;
+        // shared with the worker tasks, which can outlive the render device
+        std::shared_ptr<std::atomic<std::size_t>> pendingImageWrites = std::make_shared<std::atomic<std::size_t>>(0);
+
+        std::vector<CommandBuffer> commandBufferPool;
+        std::mutex commandBufferPoolMutex;
+
+        std::vector<std::uint32_t> resourceGenerations;
+        std::deque<std::size_t> freeResourceSlots;
+        std::vector<ResourceId> deletedResourceIds;
+        std::mutex resourceIdMutex;
 
         std::atomic<float> currentFps{0.0F};
         std::chrono::steady_clock::time_point previousFrameTime;
@@ -248,6 +437,15 @@ namespace ouzel::graphics
         float currentAccumulatedFps = 0.0F;
         std::atomic<float> accumulatedFps{0.0F};
 
+        std::chrono::steady_clock::time_point frameStartTime;
+        FrameStats frameStats;
+        mutable std::mutex frameStatsMutex;
+
+        std::atomic_bool commandTimingEnabled{false};
+        CommandTimings currentCommandTimings; // accessed only by the render thread
+        CommandTimings commandTimings;
+        mutable std::mutex commandTimingsMutex;
+
         std::queue<Event> eventQueue;
         mutable std::mutex eventQueueMutex;
         std::condition_variable eventQueueCondition;
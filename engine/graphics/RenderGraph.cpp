@@ -0,0 +1,229 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <stdexcept>
+#include "RenderGraph.hpp"
+#include "Graphics.hpp"
+
+namespace ouzel::graphics
+{
+    RenderGraph::TextureId RenderGraph::PassBuilder::create(const TextureDescription& description)
+    {
+        renderGraph.textures.push_back(nullptr);
+        return renderGraph.schedule.addTexture(description, false);
+    }
+
+    void RenderGraph::PassBuilder::read(TextureId texture)
+    {
+        renderGraph.schedule.read(pass, texture);
+    }
+
+    void RenderGraph::PassBuilder::write(TextureId texture)
+    {
+        renderGraph.schedule.write(pass, texture);
+    }
+
+    void RenderGraph::PassBuilder::setDepthStencil(TextureId texture)
+    {
+        renderGraph.schedule.setDepthStencil(pass, texture);
+    }
+
+    void RenderGraph::PassBuilder::writeBackBuffer()
+    {
+        renderGraph.schedule.setBackBuffer(pass);
+    }
+
+    void RenderGraph::PassBuilder::setSideEffect() noexcept
+    {
+        renderGraph.schedule.setSideEffect(pass);
+    }
+
+    RenderGraph::RenderGraph(Graphics& initGraphics):
+        graphics{initGraphics}
+    {
+    }
+
+    RenderGraph::TextureId RenderGraph::importTexture(Texture* texture)
+    {
+        if (!texture)
+            throw std::runtime_error{"Invalid texture"};
+
+        textures.push_back(texture);
+        return schedule.addTexture(TextureDescription{texture->getSize(), texture->getPixelFormat(), texture->getSampleCount()}, true);
+    }
+
+    void RenderGraph::addPass(const std::string& name,
+                              const std::function<void(PassBuilder&)>& setup,
+                              const std::function<void(RenderGraph&)>& execute)
+    {
+        if (executing)
+            throw std::runtime_error{"Can not add passes while the render graph is executing"};
+
+        passes.push_back(Pass{name, execute});
+
+        PassBuilder builder{*this, schedule.addPass()};
+        setup(builder);
+
+        const auto& pass = schedule.getPasses().back();
+        if (pass.backBuffer && (!pass.colorAttachments.empty() || pass.hasDepthAttachment))
+            throw std::runtime_error{"Render pass " + name + " writes to both the back buffer and textures"};
+    }
+
+    void RenderGraph::execute()
+    {
+        // the passes of the frame are dropped even if compiling or executing them throws,
+        // so that the graph can be used again in the next frame
+        class Scope final
+        {
+        public:
+            explicit Scope(RenderGraph& initRenderGraph) noexcept: renderGraph{initRenderGraph} {}
+            ~Scope() { renderGraph.endFrame(); }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            RenderGraph& renderGraph;
+        } scope{*this};
+
+        schedule.compile();
+        assignTextures();
+
+        executing = true;
+
+        const auto& order = schedule.getOrder();
+
+        for (std::size_t position = 0; position < order.size(); ++position)
+        {
+            const auto& pass = schedule.getPasses()[order[position]];
+
+            if (!pass.colorAttachments.empty() || pass.hasDepthAttachment)
+            {
+                currentRenderTarget = getPassRenderTarget(pass);
+                graphics.setRenderTarget(currentRenderTarget->getResource());
+            }
+            else
+            {
+                currentRenderTarget = nullptr;
+                if (pass.backBuffer) graphics.setRenderTarget(0);
+            }
+
+            const auto& function = passes[order[position]].execute;
+            if (function) function(*this);
+
+            if (currentRenderTarget)
+            {
+                // attachments that no later pass uses don't have to be stored
+                const auto isDead = [this, position](TextureId texture) noexcept {
+                    return schedule.isDeadAfter(texture, position);
+                };
+
+                const auto discardColor = std::all_of(pass.colorAttachments.begin(), pass.colorAttachments.end(), isDead);
+                const auto discardDepth = pass.hasDepthAttachment && isDead(pass.depthAttachment);
+                const auto discardStencil = discardDepth &&
+                    schedule.getResources()[pass.depthAttachment].description.pixelFormat == PixelFormat::depthStencil;
+
+                if ((discardColor && !pass.colorAttachments.empty()) || discardDepth)
+                    graphics.discardRenderTarget(discardColor && !pass.colorAttachments.empty(),
+                                                 discardDepth,
+                                                 discardStencil);
+            }
+        }
+
+        releaseUnusedResources();
+    }
+
+    void RenderGraph::endFrame() noexcept
+    {
+        executing = false;
+        currentRenderTarget = nullptr;
+        schedule.clear();
+        passes.clear();
+        textures.clear();
+    }
+
+    Texture* RenderGraph::getTexture(TextureId texture) const
+    {
+        if (!executing || texture >= textures.size())
+            throw std::runtime_error{"Invalid render graph texture"};
+
+        return textures[texture];
+    }
+
+    void RenderGraph::assignTextures()
+    {
+        // the schedule only adds slots, the textures of the new ones are created here
+        const auto& slots = schedule.getSlots();
+        for (auto slot = pooledTextures.size(); slot < slots.size(); ++slot)
+        {
+            const auto& description = slots[slot].description;
+            const auto flags = Flags::bindRenderTarget |
+                (description.sampleCount > 1 ? Flags::bindShaderMsaa : Flags::bindShader);
+
+            pooledTextures.push_back(std::make_unique<Texture>(graphics,
+                                                               description.size,
+                                                               flags,
+                                                               1,
+                                                               description.sampleCount,
+                                                               description.pixelFormat));
+        }
+
+        const auto& resources = schedule.getResources();
+        for (std::size_t texture = 0; texture < resources.size(); ++texture)
+            if (!resources[texture].imported && resources[texture].used)
+                textures[texture] = pooledTextures[resources[texture].slot].get();
+    }
+
+    RenderTarget* RenderGraph::getPassRenderTarget(const RenderGraphSchedule::Pass& pass)
+    {
+        std::vector<Texture*> colorTextures;
+        colorTextures.reserve(pass.colorAttachments.size());
+        for (const auto texture : pass.colorAttachments)
+            colorTextures.push_back(textures[texture]);
+
+        const auto depthTexture = pass.hasDepthAttachment ? textures[pass.depthAttachment] : nullptr;
+
+        for (auto& cachedRenderTarget : renderTargets)
+            if (cachedRenderTarget.colorTextures == colorTextures &&
+                cachedRenderTarget.depthTexture == depthTexture)
+            {
+                cachedRenderTarget.unusedFrames = 0;
+                return cachedRenderTarget.renderTarget.get();
+            }
+
+        CachedRenderTarget cachedRenderTarget;
+        cachedRenderTarget.colorTextures = colorTextures;
+        cachedRenderTarget.depthTexture = depthTexture;
+        cachedRenderTarget.renderTarget = std::make_unique<RenderTarget>(graphics, colorTextures, depthTexture);
+        renderTargets.push_back(std::move(cachedRenderTarget));
+
+        return renderTargets.back().renderTarget.get();
+    }
+
+    void RenderGraph::releaseUnusedResources()
+    {
+        for (auto& cachedRenderTarget : renderTargets)
+            ++cachedRenderTarget.unusedFrames;
+
+        // the render targets that use imported textures are dropped too, in case the textures get deleted
+        renderTargets.erase(std::remove_if(renderTargets.begin(), renderTargets.end(),
+                                           [](const CachedRenderTarget& cachedRenderTarget) noexcept {
+                                               return cachedRenderTarget.unusedFrames > maxUnusedFrames;
+                                           }), renderTargets.end());
+
+        schedule.releaseUnusedSlots(maxUnusedFrames, [this](std::size_t slot) {
+            const auto texture = pooledTextures[slot].get();
+
+            // the render targets must be deleted before the textures they use
+            renderTargets.erase(std::remove_if(renderTargets.begin(), renderTargets.end(),
+                                               [texture](const CachedRenderTarget& cachedRenderTarget) {
+                                                   return cachedRenderTarget.depthTexture == texture ||
+                                                       std::find(cachedRenderTarget.colorTextures.begin(),
+                                                                 cachedRenderTarget.colorTextures.end(),
+                                                                 texture) != cachedRenderTarget.colorTextures.end();
+                                               }), renderTargets.end());
+
+            pooledTextures.erase(pooledTextures.begin() + static_cast<std::ptrdiff_t>(slot));
+        });
+    }
+}
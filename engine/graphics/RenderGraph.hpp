@@ -0,0 +1,110 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_RENDERGRAPH_HPP
+#define OUZEL_GRAPHICS_RENDERGRAPH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "RenderGraphSchedule.hpp"
+#include "RenderTarget.hpp"
+#include "Texture.hpp"
+
+namespace ouzel::graphics
+{
+    class Graphics;
+
+    // Per-frame graph of render passes. Passes declare the textures they read and write,
+    // passes whose results are not used are culled and the rest are sorted so that every pass
+    // runs after the passes it depends on. Transient textures are taken from a pool that
+    // persists between frames and the transient textures whose lifetimes don't overlap share
+    // the same pooled texture. The passes are scheduled by RenderGraphSchedule.
+    class RenderGraph final
+    {
+    public:
+        using TextureId = RenderGraphSchedule::TextureId;
+        using TextureDescription = RenderGraphSchedule::TextureDescription;
+
+        class PassBuilder final
+        {
+            friend RenderGraph;
+        public:
+            // creates a transient texture, its contents are undefined before the first write
+            TextureId create(const TextureDescription& description);
+
+            void read(TextureId texture);
+            void write(TextureId texture); // binds the texture as a color attachment
+            void setDepthStencil(TextureId texture);
+            void writeBackBuffer();
+
+            // the pass is never culled, e.g. it reads data back to the CPU
+            void setSideEffect() noexcept;
+
+        private:
+            PassBuilder(RenderGraph& initRenderGraph, RenderGraphSchedule::PassId initPass) noexcept:
+                renderGraph{initRenderGraph}, pass{initPass}
+            {
+            }
+
+            RenderGraph& renderGraph;
+            RenderGraphSchedule::PassId pass;
+        };
+
+        explicit RenderGraph(Graphics& initGraphics);
+
+        // textures that live outside of the graph, passes that write to them are never culled
+        TextureId importTexture(Texture* texture);
+
+        void addPass(const std::string& name,
+                     const std::function<void(PassBuilder&)>& setup,
+                     const std::function<void(RenderGraph&)>& execute);
+
+        // compiles and executes the passes added since the last call
+        void execute();
+
+        // valid only while the passes are being executed
+        Texture* getTexture(TextureId texture) const;
+        RenderTarget* getRenderTarget() const noexcept { return currentRenderTarget; }
+
+        auto getPooledTextureCount() const noexcept { return pooledTextures.size(); }
+        auto getCulledPassCount() const noexcept { return schedule.getCulledPassCount(); }
+
+    private:
+        // pooled textures and cached render targets not used for this many frames are released
+        static constexpr std::uint32_t maxUnusedFrames = 3;
+
+        struct Pass final
+        {
+            std::string name;
+            std::function<void(RenderGraph&)> execute;
+        };
+
+        struct CachedRenderTarget final
+        {
+            std::vector<Texture*> colorTextures;
+            Texture* depthTexture = nullptr;
+            std::unique_ptr<RenderTarget> renderTarget;
+            std::uint32_t unusedFrames = 0;
+        };
+
+        void assignTextures();
+        RenderTarget* getPassRenderTarget(const RenderGraphSchedule::Pass& pass);
+        void releaseUnusedResources();
+        void endFrame() noexcept;
+
+        Graphics& graphics;
+
+        RenderGraphSchedule schedule;
+        std::vector<Pass> passes;
+        std::vector<Texture*> textures; // the imported texture or the pooled texture assigned to the transient one
+
+        std::vector<std::unique_ptr<Texture>> pooledTextures; // for every slot of the schedule
+        std::vector<CachedRenderTarget> renderTargets;
+        RenderTarget* currentRenderTarget = nullptr;
+        bool executing = false;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_RENDERGRAPH_HPP
@@ -0,0 +1,249 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include "RenderGraphSchedule.hpp"
+
+namespace ouzel::graphics
+{
+    RenderGraphSchedule::TextureId RenderGraphSchedule::addTexture(const TextureDescription& description, bool imported)
+    {
+        Resource resource;
+        resource.description = description;
+        resource.imported = imported;
+        resources.push_back(std::move(resource));
+        return resources.size() - 1;
+    }
+
+    RenderGraphSchedule::PassId RenderGraphSchedule::addPass()
+    {
+        passes.emplace_back();
+        return passes.size() - 1;
+    }
+
+    void RenderGraphSchedule::read(PassId pass, TextureId texture)
+    {
+        if (texture >= resources.size())
+            throw std::runtime_error{"Invalid render graph texture"};
+
+        passes[pass].reads.push_back(texture);
+    }
+
+    void RenderGraphSchedule::write(PassId pass, TextureId texture)
+    {
+        if (texture >= resources.size())
+            throw std::runtime_error{"Invalid render graph texture"};
+
+        passes[pass].colorAttachments.push_back(texture);
+        resources[texture].writers.push_back(pass);
+    }
+
+    void RenderGraphSchedule::setDepthStencil(PassId pass, TextureId texture)
+    {
+        if (texture >= resources.size())
+            throw std::runtime_error{"Invalid render graph texture"};
+
+        auto& currentPass = passes[pass];
+        if (currentPass.hasDepthAttachment)
+            throw std::runtime_error{"Render pass already has a depth stencil texture"};
+
+        currentPass.depthAttachment = texture;
+        currentPass.hasDepthAttachment = true;
+        resources[texture].writers.push_back(pass);
+    }
+
+    void RenderGraphSchedule::setBackBuffer(PassId pass)
+    {
+        passes[pass].backBuffer = true;
+    }
+
+    void RenderGraphSchedule::setSideEffect(PassId pass)
+    {
+        passes[pass].sideEffect = true;
+    }
+
+    void RenderGraphSchedule::compile()
+    {
+        sortPasses();
+        assignSlots();
+    }
+
+    void RenderGraphSchedule::clear() noexcept
+    {
+        resources.clear();
+        passes.clear();
+        order.clear();
+    }
+
+    void RenderGraphSchedule::sortPasses()
+    {
+        const auto addDependency = [this](PassId from, PassId to, bool produces) {
+            if (from == to) return;
+            passes[from].successors.push_back(to);
+            if (produces) passes[to].producers.push_back(from);
+        };
+
+        // every write builds on top of the previous one
+        for (const auto& resource : resources)
+            for (std::size_t i = 1; i < resource.writers.size(); ++i)
+                addDependency(resource.writers[i - 1], resource.writers[i], true);
+
+        for (PassId passIndex = 0; passIndex < passes.size(); ++passIndex)
+            for (const auto texture : passes[passIndex].reads)
+            {
+                const auto& writers = resources[texture].writers;
+                const auto nextWriter = std::upper_bound(writers.begin(), writers.end(), passIndex);
+                const auto previousWriter = std::find_if(std::make_reverse_iterator(nextWriter), writers.rend(),
+                                                         [passIndex](PassId writer) noexcept { return writer != passIndex; });
+
+                if (previousWriter != writers.rend())
+                {
+                    // reads the result of the last write added before it and must finish before the next write
+                    addDependency(*previousWriter, passIndex, true);
+                    if (nextWriter != writers.end()) addDependency(passIndex, *nextWriter, false);
+                }
+                else if (!writers.empty())
+                {
+                    if (resources[texture].imported)
+                        addDependency(passIndex, writers.front(), false); // reads the contents of the previous frame
+                    else
+                        addDependency(writers.back(), passIndex, true); // the writers were added after the reader
+                }
+            }
+
+        // only the passes that contribute to the back buffer, imported textures or side effects are executed
+        std::vector<PassId> stack;
+        for (PassId passIndex = 0; passIndex < passes.size(); ++passIndex)
+        {
+            const auto& pass = passes[passIndex];
+            const auto writesImported = std::any_of(pass.colorAttachments.begin(), pass.colorAttachments.end(),
+                                                    [this](TextureId texture) noexcept { return resources[texture].imported; }) ||
+                (pass.hasDepthAttachment && resources[pass.depthAttachment].imported);
+
+            if (pass.sideEffect || pass.backBuffer || writesImported)
+                stack.push_back(passIndex);
+        }
+
+        while (!stack.empty())
+        {
+            const auto passIndex = stack.back();
+            stack.pop_back();
+
+            auto& pass = passes[passIndex];
+            if (pass.needed) continue;
+            pass.needed = true;
+
+            for (const auto producer : pass.producers)
+                if (!passes[producer].needed) stack.push_back(producer);
+        }
+
+        // topological sort that keeps the order in which the independent passes were added
+        std::vector<std::size_t> dependencyCounts(passes.size(), 0);
+        for (const auto& pass : passes)
+            if (pass.needed)
+                for (const auto successor : pass.successors)
+                    if (passes[successor].needed) ++dependencyCounts[successor];
+
+        std::priority_queue<PassId, std::vector<PassId>, std::greater<PassId>> readyPasses;
+        std::size_t neededCount = 0;
+        for (PassId passIndex = 0; passIndex < passes.size(); ++passIndex)
+            if (passes[passIndex].needed)
+            {
+                ++neededCount;
+                if (!dependencyCounts[passIndex]) readyPasses.push(passIndex);
+            }
+
+        order.clear();
+        order.reserve(neededCount);
+
+        while (!readyPasses.empty())
+        {
+            const auto passIndex = readyPasses.top();
+            readyPasses.pop();
+            order.push_back(passIndex);
+
+            for (const auto successor : passes[passIndex].successors)
+                if (passes[successor].needed && --dependencyCounts[successor] == 0)
+                    readyPasses.push(successor);
+        }
+
+        if (order.size() != neededCount)
+            throw std::runtime_error{"Render graph has a dependency cycle"};
+
+        culledPassCount = passes.size() - neededCount;
+    }
+
+    void RenderGraphSchedule::assignSlots()
+    {
+        std::vector<std::vector<TextureId>> passTextures(order.size());
+
+        for (std::size_t position = 0; position < order.size(); ++position)
+        {
+            const auto& pass = passes[order[position]];
+
+            auto& usedTextures = passTextures[position];
+            usedTextures = pass.reads;
+            usedTextures.insert(usedTextures.end(), pass.colorAttachments.begin(), pass.colorAttachments.end());
+            if (pass.hasDepthAttachment) usedTextures.push_back(pass.depthAttachment);
+            std::sort(usedTextures.begin(), usedTextures.end());
+            usedTextures.erase(std::unique(usedTextures.begin(), usedTextures.end()), usedTextures.end());
+
+            for (const auto textureId : usedTextures)
+            {
+                auto& resource = resources[textureId];
+                if (!resource.used)
+                {
+                    resource.used = true;
+                    resource.firstUse = position;
+                }
+                resource.lastUse = position;
+            }
+        }
+
+        std::vector<std::size_t> freeSlots;
+        for (std::size_t slot = 0; slot < slots.size(); ++slot)
+        {
+            ++slots[slot].unusedFrames;
+            freeSlots.push_back(slot);
+        }
+
+        // a slot is returned to the free list after the last pass that uses it,
+        // so that the transient textures created by the later passes can alias it
+        for (std::size_t position = 0; position < order.size(); ++position)
+        {
+            for (const auto textureId : passTextures[position])
+            {
+                auto& resource = resources[textureId];
+                if (!resource.imported && resource.firstUse == position)
+                    resource.slot = acquireSlot(resource.description, freeSlots);
+            }
+
+            for (const auto textureId : passTextures[position])
+                if (isDeadAfter(textureId, position))
+                    freeSlots.push_back(resources[textureId].slot);
+        }
+    }
+
+    std::size_t RenderGraphSchedule::acquireSlot(const TextureDescription& description,
+                                                 std::vector<std::size_t>& freeSlots)
+    {
+        const auto i = std::find_if(freeSlots.begin(), freeSlots.end(),
+                                    [this, &description](std::size_t slot) noexcept {
+                                        return slots[slot].description == description;
+                                    });
+
+        if (i != freeSlots.end())
+        {
+            const auto slot = *i;
+            freeSlots.erase(i);
+            slots[slot].unusedFrames = 0;
+            return slot;
+        }
+
+        slots.push_back(Slot{description, 0});
+        return slots.size() - 1;
+    }
+}
@@ -0,0 +1,120 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_RENDERGRAPHSCHEDULE_HPP
+#define OUZEL_GRAPHICS_RENDERGRAPHSCHEDULE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "PixelFormat.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::graphics
+{
+    // The part of the render graph that doesn't depend on the render device. It culls the passes
+    // whose results are not used, sorts the rest by their dependencies and assigns the slots of
+    // the texture pool to the transient textures, so that the textures whose lifetimes don't
+    // overlap share a slot.
+    class RenderGraphSchedule final
+    {
+    public:
+        using TextureId = std::size_t;
+        using PassId = std::size_t;
+
+        struct TextureDescription final
+        {
+            math::Size<std::uint32_t, 2> size;
+            PixelFormat pixelFormat = PixelFormat::rgba8UnsignedNorm;
+            std::uint32_t sampleCount = 1;
+
+            bool operator==(const TextureDescription& other) const noexcept
+            {
+                return size == other.size &&
+                    pixelFormat == other.pixelFormat &&
+                    sampleCount == other.sampleCount;
+            }
+        };
+
+        struct Resource final
+        {
+            TextureDescription description;
+            bool imported = false;
+            bool used = false;
+            std::size_t firstUse = 0; // positions in the order of the passes
+            std::size_t lastUse = 0;
+            std::size_t slot = 0; // of the transient texture
+            std::vector<PassId> writers; // in the order the passes were added
+        };
+
+        struct Pass final
+        {
+            std::vector<TextureId> reads;
+            std::vector<TextureId> colorAttachments;
+            TextureId depthAttachment = 0;
+            bool hasDepthAttachment = false;
+            bool backBuffer = false;
+            bool sideEffect = false;
+            bool needed = false;
+            std::vector<PassId> producers; // passes whose results this pass uses
+            std::vector<PassId> successors;
+        };
+
+        // the slots stay in the pool between frames
+        struct Slot final
+        {
+            TextureDescription description;
+            std::uint32_t unusedFrames = 0;
+        };
+
+        TextureId addTexture(const TextureDescription& description, bool imported);
+        PassId addPass();
+
+        void read(PassId pass, TextureId texture);
+        void write(PassId pass, TextureId texture); // the texture is a color attachment of the pass
+        void setDepthStencil(PassId pass, TextureId texture);
+        void setBackBuffer(PassId pass);
+        void setSideEffect(PassId pass);
+
+        // sorts the passes and assigns the slots, slots are added when none of the free ones match
+        void compile();
+        // removes the passes and the textures of the frame
+        void clear() noexcept;
+
+        // calls the function with the index of every slot that was not used for more than the given
+        // number of frames before removing it, from the last slot to the first
+        template <class Function>
+        void releaseUnusedSlots(std::uint32_t maxUnusedFrames, Function&& function)
+        {
+            for (auto slot = slots.size(); slot-- > 0;)
+                if (slots[slot].unusedFrames > maxUnusedFrames)
+                {
+                    function(slot);
+                    slots.erase(slots.begin() + static_cast<std::ptrdiff_t>(slot));
+                }
+        }
+
+        // the texture is not used after the pass at the position in the order
+        [[nodiscard]] bool isDeadAfter(TextureId texture, std::size_t position) const noexcept
+        {
+            return !resources[texture].imported && resources[texture].lastUse == position;
+        }
+
+        [[nodiscard]] const auto& getResources() const noexcept { return resources; }
+        [[nodiscard]] const auto& getPasses() const noexcept { return passes; }
+        [[nodiscard]] const auto& getSlots() const noexcept { return slots; }
+        [[nodiscard]] const auto& getOrder() const noexcept { return order; }
+        [[nodiscard]] auto getCulledPassCount() const noexcept { return culledPassCount; }
+
+    private:
+        void sortPasses();
+        void assignSlots();
+        std::size_t acquireSlot(const TextureDescription& description, std::vector<std::size_t>& freeSlots);
+
+        std::vector<Resource> resources;
+        std::vector<Pass> passes;
+        std::vector<Slot> slots;
+        std::vector<PassId> order;
+        std::size_t culledPassCount = 0;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_RENDERGRAPHSCHEDULE_HPP
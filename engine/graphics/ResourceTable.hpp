@@ -0,0 +1,117 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_RESOURCETABLE_HPP
+#define OUZEL_GRAPHICS_RESOURCETABLE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "Commands.hpp"
+
+namespace ouzel::graphics
+{
+    // Render device resources stored in dense slots indexed by the resource handle.
+    // Deleted resources are kept alive until the GPU has finished the frames that could use them.
+    template <class T>
+    class ResourceTable final
+    {
+    public:
+        using iterator = typename std::vector<std::unique_ptr<T>>::iterator;
+        using const_iterator = typename std::vector<std::unique_ptr<T>>::const_iterator;
+
+        ResourceTable() = default;
+        ~ResourceTable()
+        {
+            clear();
+        }
+
+        ResourceTable(const ResourceTable&) = delete;
+        ResourceTable& operator=(const ResourceTable&) = delete;
+
+        T* get(ResourceId id) const
+        {
+            if (!id) return nullptr;
+
+            const auto index = getResourceIndex(id);
+#ifndef NDEBUG
+            if (index >= ids.size() || ids[index] != id)
+                throw std::runtime_error{"Invalid resource handle"};
+#endif
+            return resources[index].get();
+        }
+
+        // returns nullptr instead of failing for handles that don't refer to a live resource
+        T* find(ResourceId id) const noexcept
+        {
+            if (!id) return nullptr;
+
+            const auto index = getResourceIndex(id);
+            return index < ids.size() && ids[index] == id ? resources[index].get() : nullptr;
+        }
+
+        void set(ResourceId id, std::unique_ptr<T> resource)
+        {
+            const auto index = getResourceIndex(id);
+            if (index >= resources.size())
+            {
+                resources.resize(index + 1);
+                ids.resize(index + 1);
+            }
+
+            resources[index] = std::move(resource);
+            ids[index] = id;
+        }
+
+        // moves the resource out of its slot, it is destroyed by collect after the frame has completed
+        void retire(ResourceId id, std::uint64_t frame)
+        {
+            const auto index = getResourceIndex(id);
+
+            // stale handles (e.g. of a replayed frame capture) don't own the slot
+            if (index >= ids.size() || ids[index] != id) return;
+
+            retired.push_back(Retired{frame, id, std::move(resources[index])});
+            ids[index] = 0;
+        }
+
+        // destroys the resources retired in the completed frames and passes their handles to the release function
+        template <class F>
+        void collect(std::uint64_t completedFrame, F release)
+        {
+            while (!retired.empty() && retired.front().frame <= completedFrame)
+            {
+                const auto id = retired.front().id;
+                retired.pop_front();
+                release(id);
+            }
+        }
+
+        void clear()
+        {
+            retired.clear();
+            resources.clear();
+            ids.clear();
+        }
+
+        iterator begin() noexcept { return resources.begin(); }
+        iterator end() noexcept { return resources.end(); }
+        const_iterator begin() const noexcept { return resources.begin(); }
+        const_iterator end() const noexcept { return resources.end(); }
+
+    private:
+        struct Retired final
+        {
+            std::uint64_t frame;
+            ResourceId id;
+            std::unique_ptr<T> resource;
+        };
+
+        std::vector<std::unique_ptr<T>> resources;
+        std::vector<ResourceId> ids;
+        std::deque<Retired> retired;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_RESOURCETABLE_HPP
@@ -4,6 +4,7 @@
 #define OUZEL_GRAPHICS_SETTINGS_HPP
 
 #include <cstdint>
+#include <string>
 #include "SamplerFilter.hpp"
 
 namespace ouzel::graphics
@@ -18,6 +19,11 @@ namespace ouzel::graphics
         bool depth = false;
         bool stencil = false;
         bool debugRenderer = false;
+        std::uint32_t textureUploadBudget = 0;
+        std::uint32_t framesInFlight = 1; // frames the update thread can queue ahead of the one being rendered, 1 to 3
+        std::uint32_t emptyFrameRate = 0; // frame events per second of the empty render device, 0 for unlimited
+        bool frameCapture = false; // track the render resources so that frames can be captured
+        std::string shaderCacheDirectory; // where the compiled shader programs are stored, empty to disable the cache
     };
 }
 
@@ -0,0 +1,131 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SKYLINEPACKER_HPP
+#define OUZEL_GRAPHICS_SKYLINEPACKER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "../math/Size.hpp"
+#include "../math/Vector.hpp"
+
+namespace ouzel::graphics
+{
+    // Packs rectangles into an area by keeping the top edge of the packed rectangles as a list of horizontal segments
+    // Every rectangle is put at the position with the lowest top edge (bottom-left packing)
+    class SkylinePacker final
+    {
+    public:
+        explicit SkylinePacker(const math::Size<std::uint32_t, 2>& initSize):
+            size{initSize},
+            skyline{Node{0, 0, initSize.v[0]}}
+        {
+        }
+
+        // returns false if there is no space left for the rectangle
+        bool pack(std::uint32_t width, std::uint32_t height,
+                  math::Vector<std::uint32_t, 2>& position)
+        {
+            if (width == 0 || height == 0 || width > size.v[0] || height > size.v[1])
+                return false;
+
+            bool found = false;
+            std::size_t bestNode = 0;
+            std::uint32_t bestTop = 0;
+            std::uint32_t bestWidth = 0;
+
+            for (std::size_t i = 0; i < skyline.size(); ++i)
+            {
+                const auto x = skyline[i].x;
+                if (x + width > size.v[0]) break;
+
+                std::uint32_t y = 0;
+                std::uint32_t coveredWidth = 0;
+                for (std::size_t j = i; coveredWidth < width; ++j)
+                {
+                    y = std::max(y, skyline[j].y);
+                    coveredWidth += skyline[j].width;
+                }
+
+                if (y + height > size.v[1]) continue;
+
+                if (!found || y + height < bestTop ||
+                    (y + height == bestTop && skyline[i].width < bestWidth))
+                {
+                    found = true;
+                    bestNode = i;
+                    bestTop = y + height;
+                    bestWidth = skyline[i].width;
+                    position = math::Vector<std::uint32_t, 2>{x, y};
+                }
+            }
+
+            if (found) insert(bestNode, position, width, height);
+
+            return found;
+        }
+
+        void clear()
+        {
+            skyline.assign(1, Node{0, 0, size.v[0]});
+        }
+
+        // area under the skyline, including the space wasted below the packed rectangles
+        std::uint64_t getAllocatedArea() const noexcept
+        {
+            std::uint64_t result = 0;
+            for (const auto& node : skyline)
+                result += static_cast<std::uint64_t>(node.width) * node.y;
+            return result;
+        }
+
+    private:
+        struct Node final
+        {
+            std::uint32_t x;
+            std::uint32_t y;
+            std::uint32_t width;
+        };
+
+        void insert(std::size_t node, const math::Vector<std::uint32_t, 2>& position,
+                    std::uint32_t width, std::uint32_t height)
+        {
+            skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(node),
+                           Node{position.v[0], position.v[1] + height, width});
+
+            // shrink or remove the nodes that are now under the new node
+            for (std::size_t i = node + 1; i < skyline.size();)
+            {
+                const auto& previous = skyline[i - 1];
+                const auto previousRight = previous.x + previous.width;
+                if (skyline[i].x >= previousRight) break;
+
+                const auto shrink = previousRight - skyline[i].x;
+                if (skyline[i].width <= shrink)
+                    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                else
+                {
+                    skyline[i].x += shrink;
+                    skyline[i].width -= shrink;
+                    break;
+                }
+            }
+
+            // merge the neighbours at the same height
+            for (std::size_t i = 1; i < skyline.size();)
+                if (skyline[i - 1].y == skyline[i].y)
+                {
+                    skyline[i - 1].width += skyline[i].width;
+                    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                }
+                else
+                    ++i;
+        }
+
+        math::Size<std::uint32_t, 2> size;
+        std::vector<Node> skyline;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SKYLINEPACKER_HPP
@@ -3,6 +3,10 @@
 #ifndef OUZEL_GRAPHICS_TEXTURE_HPP
 #define OUZEL_GRAPHICS_TEXTURE_HPP
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 #include <utility>
 #include "RenderDevice.hpp"
@@ -13,12 +17,40 @@
 #include "SamplerFilter.hpp"
 #include "TextureType.hpp"
 #include "../math/Color.hpp"
+#include "../math/Rect.hpp"
 #include "../math/Size.hpp"
 
 namespace ouzel::graphics
 {
     class Graphics;
 
+    // State of a texture whose data is decoded on a worker thread and handed to the render device later
+    class TextureLoad final
+    {
+    public:
+        struct Result final
+        {
+            std::atomic<bool> finished{false};
+            std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
+            std::string error;
+        };
+
+        RenderDevice::ResourceId resource = 0;
+        Flags flags = Flags::none;
+        PixelFormat pixelFormat = PixelFormat::rgba8UnsignedNorm;
+        SamplerFilter filter = SamplerFilter::point;
+        SamplerAddressMode addressX = SamplerAddressMode::clampToEdge;
+        SamplerAddressMode addressY = SamplerAddressMode::clampToEdge;
+        SamplerAddressMode addressZ = SamplerAddressMode::clampToEdge;
+        math::Color borderColor;
+        std::uint32_t maxAnisotropy = 0;
+
+        bool initialized = false; // the render device has created the texture
+        bool ready = false; // all of the texture data has been uploaded
+
+        std::shared_ptr<Result> result = std::make_shared<Result>();
+    };
+
     class Texture final
     {
     public:
@@ -42,13 +74,26 @@ namespace ouzel::graphics
                 const math::Size<std::uint32_t, 2>& initSize,
                 Flags initFlags = Flags::none,
                 PixelFormat initPixelFormat = PixelFormat::rgba8UnsignedNorm);
+        Texture(Graphics& initGraphics,
+                const math::Size<std::uint32_t, 2>& initSize,
+                std::function<std::vector<std::uint8_t>()> dataLoader,
+                Flags initFlags = Flags::none,
+                std::uint32_t initMipmaps = 0,
+                PixelFormat initPixelFormat = PixelFormat::rgba8UnsignedNorm);
 
         auto& getResource() const noexcept { return resource; }
 
         auto& getSize() const noexcept { return size; }
 
+        // returns false while the data of an asynchronously loaded texture is not on the GPU yet
+        bool isReady() const noexcept { return !load || load->ready; }
+
         void setData(const std::vector<std::uint8_t>& newData, CubeFace face = CubeFace::positiveX);
 
+        // uploads the data of a rectangle of the first level and generates only the same rectangle of the lower levels,
+        // the rectangle has to be aligned to 2^(mip levels - 1) pixels or end at the edge of the texture
+        void setData(const std::vector<std::uint8_t>& newData, const math::Rect<std::uint32_t>& rectangle);
+
         auto getFlags() const noexcept { return flags; }
         auto getMipmaps() const noexcept { return mipmaps; }
 
@@ -75,6 +120,8 @@ namespace ouzel::graphics
         auto getPixelFormat() const noexcept { return pixelFormat; }
 
     private:
+        void updateParameters();
+
         Graphics* graphics = nullptr;
         RenderDevice::Resource resource;
 
@@ -90,6 +137,8 @@ namespace ouzel::graphics
         SamplerAddressMode addressZ = SamplerAddressMode::clampToEdge;
         math::Color borderColor;
         std::uint32_t maxAnisotropy = 0;
+
+        std::shared_ptr<TextureLoad> load;
     };
 }
 
@@ -0,0 +1,348 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <stdexcept>
+#include "TextureAtlas.hpp"
+#include "Graphics.hpp"
+#include "SkylinePacker.hpp"
+
+namespace ouzel::graphics
+{
+    namespace
+    {
+        constexpr std::uint32_t alignment = 4; // keeps regions on block and lower mip level boundaries
+        constexpr std::uint32_t pixelSize = 4;
+
+        constexpr std::uint32_t align(std::uint32_t value) noexcept
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    class TextureAtlas::Page final
+    {
+    public:
+        explicit Page(const math::Size<std::uint32_t, 2>& size):
+            pixels(static_cast<std::size_t>(size.v[0]) * size.v[1] * pixelSize),
+            packer{size}
+        {
+        }
+
+        std::shared_ptr<Texture> texture;
+        std::vector<std::uint8_t> pixels;
+        SkylinePacker packer;
+        std::vector<std::shared_ptr<Region>> regions;
+        std::uint64_t usedArea = 0;
+        std::uint64_t evictedArea = 0;
+
+        // bounds of the pixels that changed since the last flush
+        bool dirty = false;
+        std::uint32_t dirtyLeft = 0;
+        std::uint32_t dirtyTop = 0;
+        std::uint32_t dirtyRight = 0;
+        std::uint32_t dirtyBottom = 0;
+
+        void markDirty(std::uint32_t left, std::uint32_t top, std::uint32_t right, std::uint32_t bottom) noexcept
+        {
+            if (!dirty)
+            {
+                dirty = true;
+                dirtyLeft = left;
+                dirtyTop = top;
+                dirtyRight = right;
+                dirtyBottom = bottom;
+            }
+            else
+            {
+                dirtyLeft = std::min(dirtyLeft, left);
+                dirtyTop = std::min(dirtyTop, top);
+                dirtyRight = std::max(dirtyRight, right);
+                dirtyBottom = std::max(dirtyBottom, bottom);
+            }
+        }
+    };
+
+    void TextureAtlas::Region::setRectangle(const math::Rect<std::uint32_t>& newRectangle,
+                                            const math::Size<std::uint32_t, 2>& pageSize)
+    {
+        rectangle = newRectangle;
+        textureRectangle = math::Rect<float>{
+            static_cast<float>(rectangle.position.v[0]) / static_cast<float>(pageSize.v[0]),
+            static_cast<float>(rectangle.position.v[1]) / static_cast<float>(pageSize.v[1]),
+            static_cast<float>(rectangle.size.v[0]) / static_cast<float>(pageSize.v[0]),
+            static_cast<float>(rectangle.size.v[1]) / static_cast<float>(pageSize.v[1])
+        };
+    }
+
+    void TextureAtlas::Region::notifyListeners()
+    {
+        listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [this](const Listener& listener) {
+            return !listener(*this);
+        }), listeners.end());
+    }
+
+    TextureAtlas::TextureAtlas(Graphics& initGraphics,
+                               const math::Size<std::uint32_t, 2>& initPageSize,
+                               std::uint32_t initPadding,
+                               std::uint32_t initMipmaps,
+                               std::size_t initMaxPages):
+        graphics{&initGraphics},
+        pageSize{initPageSize},
+        padding{initPadding},
+        mipmaps{initMipmaps},
+        maxPages{initMaxPages}
+    {
+        if (pageSize.v[0] == 0 || pageSize.v[1] == 0)
+            throw std::runtime_error{"Invalid atlas page size"};
+    }
+
+    TextureAtlas::~TextureAtlas()
+    {
+        clear();
+    }
+
+    std::shared_ptr<TextureAtlas::Region> TextureAtlas::add(const math::Size<std::uint32_t, 2>& size,
+                                                            const std::vector<std::uint8_t>& data)
+    {
+        if (size.v[0] == 0 || size.v[1] == 0)
+            throw std::runtime_error{"Invalid region size"};
+
+        if (data.size() != static_cast<std::size_t>(size.v[0]) * size.v[1] * pixelSize)
+            throw std::runtime_error{"Invalid region data size"};
+
+        if (align(size.v[0] + padding * 2) > pageSize.v[0] ||
+            align(size.v[1] + padding * 2) > pageSize.v[1])
+            throw std::runtime_error{"Region does not fit in an atlas page"};
+
+        for (const auto& page : pages)
+            if (auto region = allocate(*page, size, data))
+                return region;
+
+        // reclaim the space of evicted regions before growing
+        for (const auto& page : pages)
+            if (page->evictedArea && defragment(*page))
+                if (auto region = allocate(*page, size, data))
+                    return region;
+
+        if (maxPages && pages.size() >= maxPages)
+            return nullptr;
+
+        auto page = std::make_unique<Page>(pageSize);
+        page->texture = std::make_shared<Texture>(*graphics,
+                                                  page->pixels,
+                                                  pageSize,
+                                                  Flags::dynamic,
+                                                  mipmaps,
+                                                  PixelFormat::rgba8UnsignedNorm);
+        pages.push_back(std::move(page));
+
+        return allocate(*pages.back(), size, data);
+    }
+
+    std::shared_ptr<TextureAtlas::Region> TextureAtlas::allocate(Page& page,
+                                                                 const math::Size<std::uint32_t, 2>& size,
+                                                                 const std::vector<std::uint8_t>& data)
+    {
+        const auto width = align(size.v[0] + padding * 2);
+        const auto height = align(size.v[1] + padding * 2);
+
+        math::Vector<std::uint32_t, 2> position;
+        if (!page.packer.pack(width, height, position))
+            return nullptr;
+
+        auto region = std::make_shared<Region>();
+        region->page = &page;
+        region->texture = page.texture;
+        region->pixels = data;
+        region->setRectangle(math::Rect<std::uint32_t>{position.v[0] + padding, position.v[1] + padding, size.v[0], size.v[1]}, pageSize);
+
+        draw(page, *region);
+        page.regions.push_back(region);
+        page.usedArea += static_cast<std::uint64_t>(width) * height;
+
+        return region;
+    }
+
+    void TextureAtlas::draw(Page& page, const Region& region)
+    {
+        const auto& rectangle = region.rectangle;
+        const auto width = rectangle.size.v[0];
+        const auto height = rectangle.size.v[1];
+        const auto left = rectangle.position.v[0] - padding;
+        const auto top = rectangle.position.v[1] - padding;
+
+        // the gutter repeats the edge pixels of the region
+        for (std::uint32_t y = 0; y < height + padding * 2; ++y)
+        {
+            const auto sourceY = std::min(height - 1, y > padding ? y - padding : 0U);
+            auto destination = page.pixels.data() + ((static_cast<std::size_t>(top) + y) * pageSize.v[0] + left) * pixelSize;
+
+            for (std::uint32_t x = 0; x < width + padding * 2; ++x, destination += pixelSize)
+            {
+                const auto sourceX = std::min(width - 1, x > padding ? x - padding : 0U);
+                const auto source = region.pixels.data() + (static_cast<std::size_t>(sourceY) * width + sourceX) * pixelSize;
+                std::copy(source, source + pixelSize, destination);
+            }
+        }
+
+        page.markDirty(left, top, left + width + padding * 2, top + height + padding * 2);
+    }
+
+    void TextureAtlas::remove(const std::shared_ptr<Region>& region)
+    {
+        if (region && region->page)
+            removeFromPage(*region);
+    }
+
+    void TextureAtlas::removeFromPage(Region& region)
+    {
+        auto& page = *region.page;
+
+        const auto area = static_cast<std::uint64_t>(align(region.rectangle.size.v[0] + padding * 2)) *
+            align(region.rectangle.size.v[1] + padding * 2);
+        page.usedArea -= area;
+        page.evictedArea += area;
+
+        page.regions.erase(std::remove_if(page.regions.begin(), page.regions.end(), [&region](const auto& pageRegion) noexcept {
+            return pageRegion.get() == &region;
+        }), page.regions.end());
+
+        region.page = nullptr;
+        region.pixels.clear();
+    }
+
+    std::size_t TextureAtlas::evictUnused()
+    {
+        std::size_t count = 0;
+
+        for (const auto& page : pages)
+        {
+            std::vector<std::shared_ptr<Region>> unused;
+            for (const auto& region : page->regions)
+                if (region.use_count() == 1)
+                    unused.push_back(region);
+
+            for (const auto& region : unused)
+                removeFromPage(*region);
+
+            count += unused.size();
+        }
+
+        return count;
+    }
+
+    void TextureAtlas::defragment()
+    {
+        for (const auto& page : pages)
+            if (page->evictedArea)
+                defragment(*page);
+    }
+
+    bool TextureAtlas::defragment(Page& page)
+    {
+        // repacking tallest first usually gives a tighter skyline, regions stay on their page so that their texture doesn't change
+        auto regions = page.regions;
+        std::stable_sort(regions.begin(), regions.end(), [](const auto& a, const auto& b) noexcept {
+            return a->rectangle.size.v[1] > b->rectangle.size.v[1] ||
+                (a->rectangle.size.v[1] == b->rectangle.size.v[1] && a->rectangle.size.v[0] > b->rectangle.size.v[0]);
+        });
+
+        SkylinePacker packer{pageSize};
+        std::vector<math::Rect<std::uint32_t>> rectangles;
+        rectangles.reserve(regions.size());
+
+        for (const auto& region : regions)
+        {
+            const auto width = align(region->rectangle.size.v[0] + padding * 2);
+            const auto height = align(region->rectangle.size.v[1] + padding * 2);
+
+            math::Vector<std::uint32_t, 2> position;
+            if (!packer.pack(width, height, position))
+                return false; // keep the old layout
+
+            rectangles.emplace_back(position.v[0] + padding, position.v[1] + padding,
+                                    region->rectangle.size.v[0], region->rectangle.size.v[1]);
+        }
+
+        page.packer = std::move(packer);
+        page.evictedArea = 0;
+        std::fill(page.pixels.begin(), page.pixels.end(), std::uint8_t(0));
+
+        for (std::size_t i = 0; i < regions.size(); ++i)
+        {
+            regions[i]->setRectangle(rectangles[i], pageSize);
+            draw(page, *regions[i]);
+        }
+
+        // the space freed by the evicted regions has to be uploaded too
+        page.markDirty(0, 0, pageSize.v[0], pageSize.v[1]);
+
+        for (const auto& region : regions)
+            region->notifyListeners();
+
+        return true;
+    }
+
+    void TextureAtlas::clear()
+    {
+        for (const auto& page : pages)
+            for (const auto& region : page->regions)
+            {
+                region->page = nullptr;
+                region->pixels.clear();
+            }
+
+        pages.clear();
+    }
+
+    void TextureAtlas::flush()
+    {
+        // the lower mip levels of the dirty rectangle are generated only from the rectangle if it is aligned to them
+        const auto mipAlignment = mipmaps ? 1U << std::min(mipmaps - 1, 31U) : std::max(pageSize.v[0], pageSize.v[1]);
+
+        for (const auto& page : pages)
+            if (page->dirty)
+            {
+                const auto left = page->dirtyLeft / mipAlignment * mipAlignment;
+                const auto top = page->dirtyTop / mipAlignment * mipAlignment;
+                const auto right = std::min(pageSize.v[0], (page->dirtyRight + mipAlignment - 1) / mipAlignment * mipAlignment);
+                const auto bottom = std::min(pageSize.v[1], (page->dirtyBottom + mipAlignment - 1) / mipAlignment * mipAlignment);
+                page->dirty = false;
+
+                if (left == 0 && top == 0 && right == pageSize.v[0] && bottom == pageSize.v[1])
+                {
+                    page->texture->setData(page->pixels);
+                    continue;
+                }
+
+                const auto rowSize = static_cast<std::size_t>(right - left) * pixelSize;
+                std::vector<std::uint8_t> data(rowSize * (bottom - top));
+
+                for (auto y = top; y < bottom; ++y)
+                {
+                    const auto source = page->pixels.begin() + static_cast<std::ptrdiff_t>((static_cast<std::size_t>(y) * pageSize.v[0] + left) * pixelSize);
+                    std::copy(source, source + static_cast<std::ptrdiff_t>(rowSize),
+                              data.begin() + static_cast<std::ptrdiff_t>((y - top) * rowSize));
+                }
+
+                page->texture->setData(data, math::Rect<std::uint32_t>{left, top, right - left, bottom - top});
+            }
+    }
+
+    TextureAtlas::Stats TextureAtlas::getStats() const
+    {
+        Stats stats;
+        stats.pageCount = pages.size();
+
+        for (const auto& page : pages)
+        {
+            stats.regionCount += page->regions.size();
+            stats.pageArea += static_cast<std::uint64_t>(pageSize.v[0]) * pageSize.v[1];
+            stats.usedArea += page->usedArea;
+
+            stats.allocatedArea += page->packer.getAllocatedArea();
+        }
+
+        return stats;
+    }
+}
@@ -0,0 +1,130 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_TEXTUREATLAS_HPP
+#define OUZEL_GRAPHICS_TEXTUREATLAS_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Texture.hpp"
+#include "../math/Rect.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::graphics
+{
+    class Graphics;
+
+    // Packs small RGBA8 images into shared texture pages, so that draws using them can share a texture
+    class TextureAtlas final
+    {
+    public:
+        class Page;
+
+        class Region final
+        {
+            friend TextureAtlas;
+        public:
+            // called when defragmentation moves the region, return false to stop listening
+            using Listener = std::function<bool(const Region&)>;
+
+            auto& getTexture() const noexcept { return texture; }
+
+            // position and size in pixels inside of the page, without the gutters
+            auto& getRectangle() const noexcept { return rectangle; }
+
+            // normalized texture coordinates of the region
+            auto& getTextureRectangle() const noexcept { return textureRectangle; }
+
+            // returns false after the region was evicted or the atlas was cleared
+            bool isValid() const noexcept { return page != nullptr; }
+
+            void addListener(Listener listener) { listeners.push_back(std::move(listener)); }
+
+        private:
+            void setRectangle(const math::Rect<std::uint32_t>& newRectangle,
+                              const math::Size<std::uint32_t, 2>& pageSize);
+            void notifyListeners();
+
+            Page* page = nullptr;
+            std::shared_ptr<Texture> texture;
+            math::Rect<std::uint32_t> rectangle;
+            math::Rect<float> textureRectangle;
+            std::vector<std::uint8_t> pixels; // kept for defragmentation
+            std::vector<Listener> listeners;
+        };
+
+        struct Stats final
+        {
+            std::size_t pageCount = 0;
+            std::size_t regionCount = 0;
+            std::uint64_t pageArea = 0; // pixels in all pages
+            std::uint64_t usedArea = 0; // pixels of live regions including gutters
+            std::uint64_t allocatedArea = 0; // pixels under the skyline, including evicted regions and waste
+
+            float getOccupancy() const noexcept
+            {
+                return pageArea ? static_cast<float>(usedArea) / static_cast<float>(pageArea) : 0.0F;
+            }
+
+            float getFragmentation() const noexcept
+            {
+                return pageArea ? static_cast<float>(allocatedArea - usedArea) / static_cast<float>(pageArea) : 0.0F;
+            }
+        };
+
+        // padding is the width of the gutter around each region, it is filled with the edge pixels of the region
+        // so that filtering and the first padding-bit mip levels don't bleed neighbours into each other
+        TextureAtlas(Graphics& initGraphics,
+                     const math::Size<std::uint32_t, 2>& initPageSize,
+                     std::uint32_t initPadding = 2,
+                     std::uint32_t initMipmaps = 1,
+                     std::size_t initMaxPages = 0);
+        ~TextureAtlas();
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+        TextureAtlas(TextureAtlas&&) = delete;
+        TextureAtlas& operator=(TextureAtlas&&) = delete;
+
+        auto& getPageSize() const noexcept { return pageSize; }
+        auto getPadding() const noexcept { return padding; }
+
+        // returns nullptr if the image does not fit in any page and no more pages can be created
+        std::shared_ptr<Region> add(const math::Size<std::uint32_t, 2>& size,
+                                    const std::vector<std::uint8_t>& data);
+        void remove(const std::shared_ptr<Region>& region);
+
+        // removes the regions that are referenced only by the atlas
+        std::size_t evictUnused();
+
+        // repacks the live regions of pages that have evicted space
+        void defragment();
+
+        void clear();
+
+        // uploads the changed rectangle of each page and generates only its mip levels
+        void flush();
+
+        Stats getStats() const;
+
+    private:
+        std::shared_ptr<Region> allocate(Page& page,
+                                         const math::Size<std::uint32_t, 2>& size,
+                                         const std::vector<std::uint8_t>& data);
+        bool defragment(Page& page);
+        void removeFromPage(Region& region);
+        void draw(Page& page, const Region& region);
+
+        Graphics* graphics = nullptr;
+        math::Size<std::uint32_t, 2> pageSize;
+        std::uint32_t padding = 2;
+        std::uint32_t mipmaps = 1;
+        std::size_t maxPages = 0;
+
+        std::vector<std::unique_ptr<Page>> pages;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_TEXTUREATLAS_HPP
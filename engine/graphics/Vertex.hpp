@@ -22,6 +22,8 @@ namespace ouzel::graphics
                 blendIndices,
                 blendWeight,
                 color,
+                instanceColor,
+                instanceTransform,
                 normal,
                 position,
                 positionTransformed,
@@ -77,6 +77,9 @@ namespace ouzel::graphics::d3d11
         clampToBorderSupported = true;
         multisamplingSupported = true;
         uintIndicesSupported = true;
+        instancingSupported = true;
+        bcTexturesSupported = true;
+        bptcTexturesSupported = true;
 
         UINT deviceCreationFlags = 0U;
 
@@ -302,6 +305,7 @@ namespace ouzel::graphics::d3d11
     void RenderDevice::process()
     {
         graphics::RenderDevice::process();
+        resources.collect(getCompletedFrame(), [this](ResourceId id) { releaseResourceId(id); });
         executeAll();
 
         std::vector<float> shaderData;
@@ -321,7 +325,8 @@ namespace ouzel::graphics::d3d11
         for (;;)
         {
             std::unique_lock lock{commandQueueMutex};
-            commandQueueCondition.wait(lock, [this]() noexcept { return !commandQueue.empty(); });
+            waitForCommands(lock);
+            recycleCommandBuffer(std::move(commandBuffer));
             commandBuffer = std::move(commandQueue.front());
             commandQueue.pop();
             lock.unlock();
@@ -329,6 +334,8 @@ namespace ouzel::graphics::d3d11
             while (!commandBuffer.isEmpty())
             {
                 command = commandBuffer.popCommand();
+                countCommand(*command);
+                const CommandTimer commandTimer{*this, command->type};
 
                 switch (command->type)
                 {
@@ -345,6 +352,7 @@ namespace ouzel::graphics::d3d11
                         if (currentRenderTarget)
                             currentRenderTarget->resolve();
 
+                        captureFrameImages();
                         swapChain->Present(swapInterval, 0);
                         break;
                     }
@@ -352,7 +360,7 @@ namespace ouzel::graphics::d3d11
                     case Command::Type::deleteResource:
                     {
                         const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
-                        resources[deleteResourceCommand->resource - 1].reset();
+                        resources.retire(deleteResourceCommand->resource, renderFrame);
                         break;
                     }
 
@@ -368,9 +376,7 @@ namespace ouzel::graphics::d3d11
                                                                            colorTextures,
                                                                            getResource<Texture>(initRenderTargetCommand->depthTexture));
 
-                        if (initRenderTargetCommand->renderTarget > resources.size())
-                            resources.resize(initRenderTargetCommand->renderTarget);
-                        resources[initRenderTargetCommand->renderTarget - 1] = std::move(renderTarget);
+                        resources.set(initRenderTargetCommand->renderTarget, std::move(renderTarget));
                         break;
                     }
 
@@ -437,6 +443,10 @@ namespace ouzel::graphics::d3d11
                         break;
                     }
 
+                    case Command::Type::discardRenderTarget:
+                        // ID3D11DeviceContext1::DiscardView is not available on the Direct3D 11.0 context
+                        break;
+
                     case Command::Type::setScissorTest:
                     {
                         const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
@@ -494,9 +504,7 @@ namespace ouzel::graphics::d3d11
                                                                                      initDepthStencilStateCommand->backFaceStencilPassOperation,
                                                                                      initDepthStencilStateCommand->backFaceStencilCompareFunction);
 
-                        if (initDepthStencilStateCommand->depthStencilState > resources.size())
-                            resources.resize(initDepthStencilStateCommand->depthStencilState);
-                        resources[initDepthStencilStateCommand->depthStencilState - 1] = std::move(depthStencilState);
+                        resources.set(initDepthStencilStateCommand->depthStencilState, std::move(depthStencilState));
                         break;
                     }
 
@@ -597,6 +605,40 @@ namespace ouzel::graphics::d3d11
                         break;
                     }
 
+                    case Command::Type::drawInstanced:
+                    {
+                        const auto drawInstancedCommand = static_cast<const DrawInstancedCommand*>(command.get());
+
+                        // draw mesh buffer
+                        const auto indexBuffer = getResource<Buffer>(drawInstancedCommand->indexBuffer);
+                        const auto vertexBuffer = getResource<Buffer>(drawInstancedCommand->vertexBuffer);
+                        const auto instanceBuffer = getResource<Buffer>(drawInstancedCommand->instanceBuffer);
+
+                        assert(indexBuffer);
+                        assert(indexBuffer->getBuffer());
+                        assert(vertexBuffer);
+                        assert(vertexBuffer->getBuffer());
+                        assert(instanceBuffer);
+                        assert(instanceBuffer->getBuffer());
+
+                        ID3D11Buffer* buffers[] = {vertexBuffer->getBuffer().get(), instanceBuffer->getBuffer().get()};
+                        UINT strides[] = {sizeof(Vertex), sizeof(Instance)};
+                        UINT offsets[] = {0U, 0U};
+                        context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+                        context->IASetIndexBuffer(indexBuffer->getBuffer().get(),
+                                                  getIndexFormat(drawInstancedCommand->indexSize), 0);
+                        context->IASetPrimitiveTopology(getPrimitiveTopology(drawInstancedCommand->drawMode));
+
+                        assert(drawInstancedCommand->indexCount);
+                        assert(drawInstancedCommand->instanceCount);
+
+                        context->DrawIndexedInstanced(drawInstancedCommand->indexCount,
+                                                      drawInstancedCommand->instanceCount,
+                                                      drawInstancedCommand->startIndex, 0, 0);
+
+                        break;
+                    }
+
                     case Command::Type::initBlendState:
                     {
                         const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
@@ -611,9 +653,7 @@ namespace ouzel::graphics::d3d11
                                                                        initBlendStateCommand->alphaOperation,
                                                                        initBlendStateCommand->colorMask);
 
-                        if (initBlendStateCommand->blendState > resources.size())
-                            resources.resize(initBlendStateCommand->blendState);
-                        resources[initBlendStateCommand->blendState - 1] = std::move(blendState);
+                        resources.set(initBlendStateCommand->blendState, std::move(blendState));
                         break;
                     }
 
@@ -627,9 +667,7 @@ namespace ouzel::graphics::d3d11
                                                                initBufferCommand->data,
                                                                initBufferCommand->size);
 
-                        if (initBufferCommand->buffer > resources.size())
-                            resources.resize(initBufferCommand->buffer);
-                        resources[initBufferCommand->buffer - 1] = std::move(buffer);
+                        resources.set(initBufferCommand->buffer, std::move(buffer));
                         break;
                     }
 
@@ -655,9 +693,7 @@ namespace ouzel::graphics::d3d11
                                                                initShaderCommand->fragmentShaderFunction,
                                                                initShaderCommand->vertexShaderFunction);
 
-                        if (initShaderCommand->shader > resources.size())
-                            resources.resize(initShaderCommand->shader);
-                        resources[initShaderCommand->shader - 1] = std::move(shader);
+                        resources.set(initShaderCommand->shader, std::move(shader));
                         break;
                     }
 
@@ -736,9 +772,7 @@ namespace ouzel::graphics::d3d11
                                                                  initTextureCommand->filter,
                                                                  initTextureCommand->maxAnisotropy);
 
-                        if (initTextureCommand->texture > resources.size())
-                            resources.resize(initTextureCommand->texture);
-                        resources[initTextureCommand->texture - 1] = std::move(texture);
+                        resources.set(initTextureCommand->texture, std::move(texture));
                         break;
                     }
 
@@ -752,6 +786,16 @@ namespace ouzel::graphics::d3d11
                         break;
                     }
 
+                    case Command::Type::setTextureRegion:
+                    {
+                        const auto setTextureRegionCommand = static_cast<const SetTextureRegionCommand*>(command.get());
+
+                        const auto texture = getResource<Texture>(setTextureRegionCommand->texture);
+                        texture->setRegion(setTextureRegionCommand->levels);
+
+                        break;
+                    }
+
                     case Command::Type::setTextureParameters:
                     {
                         const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
@@ -795,7 +839,11 @@ namespace ouzel::graphics::d3d11
                         throw std::runtime_error{"Invalid command"};
                 }
 
-                if (command->type == Command::Type::present) return;
+                if (command->type == Command::Type::present)
+                {
+                    recycleCommandBuffer(std::move(commandBuffer));
+                    return;
+                }
             }
         }
     }
@@ -28,6 +28,7 @@
 #pragma pop_macro("NOMINMAX")
 
 #include "../RenderDevice.hpp"
+#include "../ResourceTable.hpp"
 #include "D3D11Pointer.hpp"
 #include "D3D11Texture.hpp"
 #include "../../thread/Thread.hpp"
@@ -54,7 +55,7 @@ namespace ouzel::graphics::d3d11
         template <class T>
         auto getResource(std::size_t id) const
         {
-            return id ? static_cast<T*>(resources[id - 1].get()) : nullptr;
+            return static_cast<T*>(resources.get(id));
         }
 
     private:
@@ -86,7 +87,7 @@ namespace ouzel::graphics::d3d11
         std::atomic_bool running{false};
         thread::Thread renderThread;
 
-        std::vector<std::unique_ptr<RenderResource>> resources;
+        ResourceTable<RenderResource> resources;
     };
 }
 #endif
@@ -88,6 +88,8 @@ namespace ouzel::graphics::d3d11
                 case Vertex::Attribute::Usage::blendIndices: return {"BLENDINDICES", static_cast<UINT>(semantic.index)};
                 case Vertex::Attribute::Usage::blendWeight: return {"BLENDWEIGHT", static_cast<UINT>(semantic.index)};
                 case Vertex::Attribute::Usage::color: return {"COLOR", static_cast<UINT>(semantic.index)};
+                case Vertex::Attribute::Usage::instanceColor: return {"INSTANCECOLOR", static_cast<UINT>(semantic.index)};
+                case Vertex::Attribute::Usage::instanceTransform: return {"INSTANCETRANSFORM", static_cast<UINT>(semantic.index)};
                 case Vertex::Attribute::Usage::normal: return {"NORMAL", static_cast<UINT>(semantic.index)};
                 case Vertex::Attribute::Usage::position: return {"POSITION", static_cast<UINT>(semantic.index)};
                 case Vertex::Attribute::Usage::positionTransformed: return {"POSITIONT", 0};
@@ -150,6 +152,30 @@ namespace ouzel::graphics::d3d11
             offset += getDataTypeSize(vertexAttribute.dataType);
         }
 
+        // per-instance data is read from the second vertex buffer slot
+        UINT instanceOffset = 0;
+
+        for (const auto& instanceAttribute : RenderDevice::instanceAttributes)
+        {
+            if (vertexAttributes.find(instanceAttribute.semantic) != vertexAttributes.end())
+            {
+                DXGI_FORMAT instanceFormat = getVertexFormat(instanceAttribute.dataType);
+
+                if (instanceFormat == DXGI_FORMAT_UNKNOWN)
+                    throw std::runtime_error{"Invalid instance format"};
+
+                const auto [semantic, index] = semanticToString(instanceAttribute.semantic);
+
+                vertexInputElements.push_back({
+                    semantic, index,
+                    instanceFormat,
+                    1, instanceOffset, D3D11_INPUT_PER_INSTANCE_DATA, 1
+                });
+            }
+
+            instanceOffset += getDataTypeSize(instanceAttribute.dataType);
+        }
+
         ID3D11InputLayout* newInputLayout;
 
         if (const auto hr = renderDevice.getDevice()->CreateInputLayout(vertexInputElements.data(),
@@ -4,11 +4,9 @@
 
 #if OUZEL_COMPILE_DIRECT3D11
 
-#include <cstring>
 #include <stdexcept>
 #include "D3D11Texture.hpp"
 #include "D3D11ErrorCategory.hpp"
-#include "D3D11MappedSubresource.hpp"
 #include "D3D11RenderDevice.hpp"
 
 namespace ouzel::graphics::d3d11
@@ -51,6 +49,17 @@ namespace ouzel::graphics::d3d11
                 case PixelFormat::rgba32Float: return DXGI_FORMAT_R32G32B32A32_FLOAT;
                 case PixelFormat::depth: return DXGI_FORMAT_D32_FLOAT;
                 case PixelFormat::depthStencil: return DXGI_FORMAT_D24_UNORM_S8_UINT;
+                case PixelFormat::bc1RgbaUnsignedNorm: return DXGI_FORMAT_BC1_UNORM;
+                case PixelFormat::bc1RgbaUnsignedNormSRGB: return DXGI_FORMAT_BC1_UNORM_SRGB;
+                case PixelFormat::bc2RgbaUnsignedNorm: return DXGI_FORMAT_BC2_UNORM;
+                case PixelFormat::bc2RgbaUnsignedNormSRGB: return DXGI_FORMAT_BC2_UNORM_SRGB;
+                case PixelFormat::bc3RgbaUnsignedNorm: return DXGI_FORMAT_BC3_UNORM;
+                case PixelFormat::bc3RgbaUnsignedNormSRGB: return DXGI_FORMAT_BC3_UNORM_SRGB;
+                case PixelFormat::bc4RUnsignedNorm: return DXGI_FORMAT_BC4_UNORM;
+                case PixelFormat::bc5RgUnsignedNorm: return DXGI_FORMAT_BC5_UNORM;
+                case PixelFormat::bc6hRgbUnsignedFloat: return DXGI_FORMAT_BC6H_UF16;
+                case PixelFormat::bc7RgbaUnsignedNorm: return DXGI_FORMAT_BC7_UNORM;
+                case PixelFormat::bc7RgbaUnsignedNormSRGB: return DXGI_FORMAT_BC7_UNORM_SRGB;
                 default: throw std::runtime_error{"Invalid pixel format"};
             }
         }
@@ -148,8 +157,9 @@ namespace ouzel::graphics::d3d11
         textureDescriptor.Format = texturePixelFormat;
         textureDescriptor.SampleDesc.Count = 1;
         textureDescriptor.SampleDesc.Quality = 0;
-        if ((flags & Flags::bindRenderTarget) == Flags::bindRenderTarget) textureDescriptor.Usage = D3D11_USAGE_DEFAULT;
-        else if ((flags & Flags::dynamic) == Flags::dynamic) textureDescriptor.Usage = D3D11_USAGE_DYNAMIC;
+        // dynamic textures are updated with UpdateSubresource, because mapping a dynamic texture discards the pixels outside of an updated region
+        if ((flags & Flags::bindRenderTarget) == Flags::bindRenderTarget ||
+            (flags & Flags::dynamic) == Flags::dynamic) textureDescriptor.Usage = D3D11_USAGE_DEFAULT;
         else textureDescriptor.Usage = D3D11_USAGE_IMMUTABLE;
 
         if ((flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
@@ -166,7 +176,7 @@ namespace ouzel::graphics::d3d11
         else
             textureDescriptor.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 
-        textureDescriptor.CPUAccessFlags = ((flags & Flags::dynamic) == Flags::dynamic && (flags & Flags::bindRenderTarget) != Flags::bindRenderTarget) ? D3D11_CPU_ACCESS_WRITE : 0;
+        textureDescriptor.CPUAccessFlags = 0;
         textureDescriptor.MiscFlags = 0;
 
         if (levels.empty() ||
@@ -185,7 +195,7 @@ namespace ouzel::graphics::d3d11
             for (std::size_t level = 0; level < levels.size(); ++level)
             {
                 subresourceData[level].pSysMem = levels[level].second.data();
-                subresourceData[level].SysMemPitch = static_cast<UINT>(levels[level].first.v[0] * pixelSize);
+                subresourceData[level].SysMemPitch = getRowPitch(initPixelFormat, levels[level].first.v[0]);
                 subresourceData[level].SysMemSlicePitch = 0;
             }
 
@@ -332,37 +342,34 @@ namespace ouzel::graphics::d3d11
             throw std::runtime_error{"Texture is not dynamic"};
 
         for (std::size_t level = 0; level < levels.size(); ++level)
-        {
             if (!levels[level].second.empty())
-            {
-                MappedSubresource mapped{renderDevice.getContext().get()};
-                const auto mappedSubresource = mapped.map(texture.get(), level,
-                                                          (level == 0) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE);
+                renderDevice.getContext()->UpdateSubresource(texture.get(), static_cast<UINT>(level), nullptr,
+                                                             levels[level].second.data(),
+                                                             static_cast<UINT>(levels[level].first.v[0] * pixelSize), 0);
+    }
 
-                if (mappedSubresource.RowPitch == levels[level].first.v[0] * pixelSize)
-                {
-                    std::memcpy(mappedSubresource.pData,
-                                levels[level].second.data(),
-                                levels[level].second.size());
-                }
-                else
-                {
-                    const auto rowSize = levels[level].first.v[0] * pixelSize;
-                    const auto rows = static_cast<UINT>(levels[level].first.v[1]);
-                    auto source = levels[level].second.data();
-                    auto destination = static_cast<BYTE*>(mappedSubresource.pData);
-
-                    for (UINT row = 0; row < rows; ++row)
-                    {
-                        std::memcpy(destination,
-                                    source,
-                                    rowSize);
-
-                        source += rowSize;
-                        destination += mappedSubresource.RowPitch;
-                    }
-                }
-            }
+    void Texture::setRegion(const std::vector<std::pair<math::Rect<std::uint32_t>, std::vector<std::uint8_t>>>& levels)
+    {
+        if ((flags & Flags::dynamic) != Flags::dynamic ||
+            (flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
+            throw std::runtime_error{"Texture is not dynamic"};
+
+        for (std::size_t level = 0; level < levels.size(); ++level)
+        {
+            const auto& [rectangle, data] = levels[level];
+            if (data.empty()) continue;
+
+            D3D11_BOX box;
+            box.left = static_cast<UINT>(rectangle.position.v[0]);
+            box.top = static_cast<UINT>(rectangle.position.v[1]);
+            box.front = 0;
+            box.right = static_cast<UINT>(rectangle.position.v[0] + rectangle.size.v[0]);
+            box.bottom = static_cast<UINT>(rectangle.position.v[1] + rectangle.size.v[1]);
+            box.back = 1;
+
+            renderDevice.getContext()->UpdateSubresource(texture.get(), static_cast<UINT>(level), &box,
+                                                         data.data(),
+                                                         static_cast<UINT>(rectangle.size.v[0] * pixelSize), 0);
         }
     }
 
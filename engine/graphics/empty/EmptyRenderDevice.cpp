@@ -0,0 +1,353 @@
+// Ouzel by Elviss Strazdins
+
+#include <thread>
+#include "EmptyRenderDevice.hpp"
+
+namespace ouzel::graphics::empty
+{
+    RenderDevice::RenderDevice(const Settings& settings,
+                               core::Window& initWindow):
+        graphics::RenderDevice{Driver::empty, settings, initWindow},
+        frameRate{settings.emptyFrameRate}
+    {
+        apiVersion = ApiVersion{1, 0};
+
+        npotTexturesSupported = true;
+        anisotropicFilteringSupported = true;
+        renderTargetsSupported = true;
+        clampToBorderSupported = true;
+        multisamplingSupported = true;
+        uintIndicesSupported = true;
+        instancingSupported = true;
+        textureStreamingSupported = true;
+        luminanceTexturesSupported = true;
+        bcTexturesSupported = true;
+        bptcTexturesSupported = true;
+        etc2TexturesSupported = true;
+        astcTexturesSupported = true;
+    }
+
+    RenderDevice::~RenderDevice()
+    {
+        running = false;
+        CommandBuffer commandBuffer;
+        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
+        submitCommandBuffer(std::move(commandBuffer));
+
+#ifndef __EMSCRIPTEN__
+        if (renderThread.isJoinable()) renderThread.join();
+#endif
+    }
+
+    void RenderDevice::start()
+    {
+        running = true;
+        nextFrameTime = std::chrono::steady_clock::now();
+
+#ifndef __EMSCRIPTEN__
+        renderThread = thread::Thread{&RenderDevice::renderMain, this};
+#endif
+    }
+
+    RenderDevice::Stats RenderDevice::getStats() const
+    {
+        std::scoped_lock lock{statsMutex};
+        return stats;
+    }
+
+    void RenderDevice::process()
+    {
+        if (frameRate)
+        {
+            // pace the frame events as a display with the given refresh rate would
+            const auto currentTime = std::chrono::steady_clock::now();
+            if (nextFrameTime > currentTime)
+                std::this_thread::sleep_until(nextFrameTime);
+            else
+                nextFrameTime = currentTime;
+
+            nextFrameTime += std::chrono::microseconds(1000000 / frameRate);
+        }
+
+        graphics::RenderDevice::process();
+        executeAll();
+
+        CommandBuffer commandBuffer;
+
+        for (;;)
+        {
+            std::unique_lock lock{commandQueueMutex};
+#ifdef __EMSCRIPTEN__
+            if (commandQueue.empty()) return;
+#else
+            waitForCommands(lock);
+#endif
+            recycleCommandBuffer(std::move(commandBuffer));
+            commandBuffer = std::move(commandQueue.front());
+            commandQueue.pop();
+            lock.unlock();
+
+            while (!commandBuffer.isEmpty())
+            {
+                const auto command = commandBuffer.popCommand();
+                countCommand(*command);
+                const CommandTimer commandTimer{*this, command->type};
+
+                processCommand(*command);
+
+                if (command->type == Command::Type::present)
+                {
+                    std::scoped_lock statsLock{statsMutex};
+                    ++stats.frameCount;
+                    recycleCommandBuffer(std::move(commandBuffer));
+                    return;
+                }
+            }
+        }
+    }
+
+    void RenderDevice::processCommand(const Command& command)
+    {
+        const auto typeIndex = static_cast<std::size_t>(command.type);
+
+        if (typeIndex >= commandTypeCount)
+        {
+            reportError("Invalid command");
+            return;
+        }
+
+        {
+            std::scoped_lock lock{statsMutex};
+            ++stats.commandCounts[typeIndex];
+            stats.commandBytes[typeIndex] += getCommandSize(command);
+        }
+
+        switch (command.type)
+        {
+            case Command::Type::resize:
+            {
+                const auto& resizeCommand = static_cast<const ResizeCommand&>(command);
+                if (resizeCommand.size.v[0] == 0 || resizeCommand.size.v[1] == 0)
+                    reportError("Invalid frame buffer size");
+                break;
+            }
+
+            case Command::Type::present:
+                break;
+
+            case Command::Type::deleteResource:
+            {
+                const auto& deleteResourceCommand = static_cast<const DeleteResourceCommand&>(command);
+                // there is no GPU that could still use the resource, so its slot is reused right away
+                if (resources.erase(deleteResourceCommand.resource))
+                    releaseResourceId(deleteResourceCommand.resource);
+                break;
+            }
+
+            case Command::Type::initRenderTarget:
+            {
+                const auto& initRenderTargetCommand = static_cast<const InitRenderTargetCommand&>(command);
+                for (const auto colorTexture : initRenderTargetCommand.colorTextures)
+                    validateResource(colorTexture, Command::Type::initTexture, false);
+                validateResource(initRenderTargetCommand.depthTexture, Command::Type::initTexture, true);
+                initResource(initRenderTargetCommand.renderTarget, command.type);
+                break;
+            }
+
+            case Command::Type::setRenderTarget:
+            {
+                const auto& setRenderTargetCommand = static_cast<const SetRenderTargetCommand&>(command);
+                validateResource(setRenderTargetCommand.renderTarget, Command::Type::initRenderTarget, true);
+                break;
+            }
+
+            case Command::Type::clearRenderTarget:
+            case Command::Type::discardRenderTarget:
+            case Command::Type::setScissorTest:
+            case Command::Type::setViewport:
+                break;
+
+            case Command::Type::initDepthStencilState:
+            {
+                const auto& initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand&>(command);
+                initResource(initDepthStencilStateCommand.depthStencilState, command.type);
+                break;
+            }
+
+            case Command::Type::setDepthStencilState:
+            {
+                const auto& setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand&>(command);
+                validateResource(setDepthStencilStateCommand.depthStencilState, Command::Type::initDepthStencilState, true);
+                break;
+            }
+
+            case Command::Type::setPipelineState:
+            {
+                const auto& setPipelineStateCommand = static_cast<const SetPipelineStateCommand&>(command);
+                validateResource(setPipelineStateCommand.blendState, Command::Type::initBlendState, true);
+                validateResource(setPipelineStateCommand.shader, Command::Type::initShader, true);
+                break;
+            }
+
+            case Command::Type::draw:
+            {
+                const auto& drawCommand = static_cast<const DrawCommand&>(command);
+                validateResource(drawCommand.indexBuffer, Command::Type::initBuffer, false);
+                validateResource(drawCommand.vertexBuffer, Command::Type::initBuffer, false);
+                if (drawCommand.indexCount == 0) reportError("Invalid index count");
+                if (drawCommand.indexSize != 2 && drawCommand.indexSize != 4) reportError("Invalid index size");
+                break;
+            }
+
+            case Command::Type::drawInstanced:
+            {
+                const auto& drawInstancedCommand = static_cast<const DrawInstancedCommand&>(command);
+                validateResource(drawInstancedCommand.indexBuffer, Command::Type::initBuffer, false);
+                validateResource(drawInstancedCommand.vertexBuffer, Command::Type::initBuffer, false);
+                validateResource(drawInstancedCommand.instanceBuffer, Command::Type::initBuffer, false);
+                if (drawInstancedCommand.indexCount == 0) reportError("Invalid index count");
+                if (drawInstancedCommand.indexSize != 2 && drawInstancedCommand.indexSize != 4) reportError("Invalid index size");
+                if (drawInstancedCommand.instanceCount == 0) reportError("Invalid instance count");
+                break;
+            }
+
+            case Command::Type::initBlendState:
+            {
+                const auto& initBlendStateCommand = static_cast<const InitBlendStateCommand&>(command);
+                initResource(initBlendStateCommand.blendState, command.type);
+                break;
+            }
+
+            case Command::Type::initBuffer:
+            {
+                const auto& initBufferCommand = static_cast<const InitBufferCommand&>(command);
+                if (!initBufferCommand.data.empty() && initBufferCommand.data.size() > initBufferCommand.size)
+                    reportError("Buffer data is larger than the buffer");
+                initResource(initBufferCommand.buffer, command.type);
+                break;
+            }
+
+            case Command::Type::setBufferData:
+            {
+                const auto& setBufferDataCommand = static_cast<const SetBufferDataCommand&>(command);
+                validateResource(setBufferDataCommand.buffer, Command::Type::initBuffer, false);
+                break;
+            }
+
+            case Command::Type::initShader:
+            {
+                const auto& initShaderCommand = static_cast<const InitShaderCommand&>(command);
+                initResource(initShaderCommand.shader, command.type);
+                break;
+            }
+
+            case Command::Type::setShaderConstants:
+                break;
+
+            case Command::Type::initTexture:
+            {
+                const auto& initTextureCommand = static_cast<const InitTextureCommand&>(command);
+                if (initTextureCommand.levels.empty()) reportError("Texture has no levels");
+                initResource(initTextureCommand.texture, command.type);
+                break;
+            }
+
+            case Command::Type::setTextureData:
+            {
+                const auto& setTextureDataCommand = static_cast<const SetTextureDataCommand&>(command);
+                validateResource(setTextureDataCommand.texture, Command::Type::initTexture, false);
+                break;
+            }
+
+            case Command::Type::setTextureRegion:
+            {
+                const auto& setTextureRegionCommand = static_cast<const SetTextureRegionCommand&>(command);
+                validateResource(setTextureRegionCommand.texture, Command::Type::initTexture, false);
+                break;
+            }
+
+            case Command::Type::setTextureParameters:
+            {
+                const auto& setTextureParametersCommand = static_cast<const SetTextureParametersCommand&>(command);
+                validateResource(setTextureParametersCommand.texture, Command::Type::initTexture, false);
+                break;
+            }
+
+            case Command::Type::uploadTextureData:
+            {
+                const auto& uploadTextureDataCommand = static_cast<const UploadTextureDataCommand&>(command);
+                validateResource(uploadTextureDataCommand.texture, Command::Type::initTexture, false);
+
+                Event event;
+                event.type = Event::Type::textureReady;
+                event.resource = uploadTextureDataCommand.texture;
+                postEvent(event);
+                break;
+            }
+
+            case Command::Type::setTextures:
+            {
+                const auto& setTexturesCommand = static_cast<const SetTexturesCommand&>(command);
+                for (const auto texture : setTexturesCommand.textures)
+                    validateResource(texture, Command::Type::initTexture, true);
+                break;
+            }
+
+            default:
+                reportError("Unsupported command");
+        }
+    }
+
+    void RenderDevice::validateResource(ResourceId resource, Command::Type initType, bool allowNone)
+    {
+        if (!resource)
+        {
+            if (!allowNone) reportError("Missing resource");
+            return;
+        }
+
+        const auto i = resources.find(resource);
+        if (i == resources.end())
+            reportError("Resource is not initialized");
+        else if (i->second != initType)
+            reportError("Resource has a wrong type");
+    }
+
+    void RenderDevice::initResource(ResourceId resource, Command::Type initType)
+    {
+        // resource ids are reused after the resource is destroyed, so initializing a live id replaces it
+        if (!resource)
+            reportError("Invalid resource");
+        else
+            resources[resource] = initType;
+    }
+
+    void RenderDevice::reportError(const char* message)
+    {
+        std::uint64_t errorCount;
+
+        {
+            std::scoped_lock lock{statsMutex};
+            errorCount = ++stats.errorCount;
+        }
+
+        // only the first errors are logged, so that a broken frame doesn't flood the log every frame
+        if (errorCount <= 16)
+            log(Log::Level::error) << "Invalid command buffer: " << message;
+    }
+
+    void RenderDevice::renderMain()
+    {
+        while (running)
+        {
+            try
+            {
+                process();
+            }
+            catch (const std::exception& e)
+            {
+                log(Log::Level::error) << e.what();
+            }
+        }
+    }
+}
@@ -3,23 +3,57 @@
 #ifndef OUZEL_GRAPHICS_EMPTYRENDERDEVICE_HPP
 #define OUZEL_GRAPHICS_EMPTYRENDERDEVICE_HPP
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
 #include "../RenderDevice.hpp"
+#include "../../thread/Thread.hpp"
 
 namespace ouzel::graphics::empty
 {
+    // Consumes and validates the command buffers without rendering anything,
+    // used for headless runs and for measuring the CPU cost of the engine
     class RenderDevice final: public graphics::RenderDevice
     {
     public:
-        RenderDevice(const Settings& settings,
-                     core::Window& initWindow):
-            graphics::RenderDevice{Driver::empty, settings, initWindow}
+        struct Stats final
         {
-        }
+            std::uint64_t frameCount = 0;
+            std::uint64_t errorCount = 0; // commands that failed validation
+            std::array<std::uint64_t, commandTypeCount> commandCounts{};
+            std::array<std::uint64_t, commandTypeCount> commandBytes{};
+        };
+
+        RenderDevice(const Settings& settings,
+                     core::Window& initWindow);
+        ~RenderDevice() override;
+
+        void start() final;
 
-        void start() final {}
+        Stats getStats() const;
 
     private:
-        void process() final {}
+        void process() final;
+        void processCommand(const Command& command);
+        void validateResource(ResourceId resource, Command::Type initType, bool allowNone);
+        void initResource(ResourceId resource, Command::Type initType);
+        void reportError(const char* message);
+        void renderMain();
+
+        std::uint32_t frameRate = 0; // frame events per second, 0 for as fast as frames are submitted
+        std::chrono::steady_clock::time_point nextFrameTime;
+
+        std::map<ResourceId, Command::Type> resources; // live resources and the commands that created them
+
+        Stats stats;
+        mutable std::mutex statsMutex;
+
+        std::atomic_bool running{false};
+#ifndef __EMSCRIPTEN__
+        thread::Thread renderThread;
+#endif
     };
 }
 
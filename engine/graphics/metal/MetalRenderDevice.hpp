@@ -43,6 +43,7 @@ using MTLPixelFormat = NSUInteger;
 #endif
 
 #include "../RenderDevice.hpp"
+#include "../ResourceTable.hpp"
 #include "MetalShader.hpp"
 #include "MetalTexture.hpp"
 #include "../../platform/dispatch/Semaphore.hpp"
@@ -69,7 +70,7 @@ namespace ouzel::graphics::metal
         template <class T>
         auto getResource(std::size_t id) const
         {
-            return id ? static_cast<T*>(resources[id - 1].get()) : nullptr;
+            return static_cast<T*>(resources.get(id));
         }
 
     protected:
@@ -128,7 +129,7 @@ namespace ouzel::graphics::metal
 
         std::map<PipelineStateDesc, platform::objc::Pointer<MTLRenderPipelineStatePtr>> pipelineStates;
 
-        std::vector<std::unique_ptr<RenderResource>> resources;
+        ResourceTable<RenderResource> resources;
     };
 }
 
@@ -111,6 +111,14 @@ namespace ouzel::graphics::metal
         renderTargetsSupported = true;
         multisamplingSupported = true;
         uintIndicesSupported = true;
+        instancingSupported = true;
+#if TARGET_OS_IOS || TARGET_OS_TV
+        etc2TexturesSupported = true;
+        astcTexturesSupported = true;
+#else
+        bcTexturesSupported = true;
+        bptcTexturesSupported = true;
+#endif
 
         device = MTLCreateSystemDefaultDevice();
 
@@ -126,6 +134,14 @@ namespace ouzel::graphics::metal
             clampToBorderSupported = true;
 #endif
 
+#if (defined(__MAC_10_15) && __MAC_OS_X_VERSION_MAX_ALLOWED >= __MAC_10_15) || \
+    (defined(__IPHONE_13_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_13_0) || \
+    (defined(__TVOS_13_0) && __TV_OS_VERSION_MAX_ALLOWED >= __TVOS_13_0)
+        // MTLTextureDescriptor.swizzle is not available in SDKs older than macOS 10.15 and iOS 13
+        if (@available(macOS 10.15, iOS 13.0, tvOS 13.0, *))
+            luminanceTexturesSupported = true;
+#endif
+
         metalCommandQueue = [device.get() newCommandQueue];
 
         if (!metalCommandQueue)
@@ -166,8 +182,12 @@ namespace ouzel::graphics::metal
     void RenderDevice::process()
     {
         graphics::RenderDevice::process();
+        resources.collect(getCompletedFrame(), [this](ResourceId id) { releaseResourceId(id); });
         executeAll();
 
+        // the drawable can be read only after its commands have run, so the images are taken from the previous frame
+        if (currentMetalTexture) captureFrameImages();
+
         id<CAMetalDrawable> currentMetalDrawable = [metalLayer nextDrawable];
 
         if (!currentMetalDrawable)
@@ -263,7 +283,8 @@ namespace ouzel::graphics::metal
         for (;;)
         {
             std::unique_lock lock{commandQueueMutex};
-            commandQueueCondition.wait(lock, [this]() noexcept { return !commandQueue.empty(); });
+            waitForCommands(lock);
+            recycleCommandBuffer(std::move(commandBuffer));
             commandBuffer = std::move(commandQueue.front());
             commandQueue.pop();
             lock.unlock();
@@ -271,6 +292,8 @@ namespace ouzel::graphics::metal
             while (!commandBuffer.isEmpty())
             {
                 command = commandBuffer.popCommand();
+                countCommand(*command);
+                const CommandTimer commandTimer{*this, command->type};
 
                 switch (command->type)
                 {
@@ -299,7 +322,7 @@ namespace ouzel::graphics::metal
                     case Command::Type::deleteResource:
                     {
                         const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
-                        resources[deleteResourceCommand->resource - 1].reset();
+                        resources.retire(deleteResourceCommand->resource, renderFrame);
                         break;
                     }
 
@@ -315,9 +338,7 @@ namespace ouzel::graphics::metal
                                                                            colorTextures,
                                                                            getResource<Texture>(initRenderTargetCommand->depthTexture));
 
-                        if (initRenderTargetCommand->renderTarget > resources.size())
-                            resources.resize(initRenderTargetCommand->renderTarget);
-                        resources[initRenderTargetCommand->renderTarget - 1] = std::move(renderTarget);
+                        resources.set(initRenderTargetCommand->renderTarget, std::move(renderTarget));
                         break;
                     }
 
@@ -403,6 +424,10 @@ namespace ouzel::graphics::metal
                         break;
                     }
 
+                    case Command::Type::discardRenderTarget:
+                        // the store actions of the render pass descriptors are decided when the pass is created
+                        break;
+
                     case Command::Type::setScissorTest:
                     {
                         const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
@@ -464,9 +489,7 @@ namespace ouzel::graphics::metal
                                                                                      initDepthStencilStateCommand->backFaceStencilPassOperation,
                                                                                      initDepthStencilStateCommand->backFaceStencilCompareFunction);
 
-                        if (initDepthStencilStateCommand->depthStencilState > resources.size())
-                            resources.resize(initDepthStencilStateCommand->depthStencilState);
-                        resources[initDepthStencilStateCommand->depthStencilState - 1] = std::move(depthStencilState);
+                        resources.set(initDepthStencilStateCommand->depthStencilState, std::move(depthStencilState));
 
                         break;
                     }
@@ -547,6 +570,42 @@ namespace ouzel::graphics::metal
                         break;
                     }
 
+                    case Command::Type::drawInstanced:
+                    {
+                        const auto drawInstancedCommand = static_cast<const DrawInstancedCommand*>(command.get());
+
+                        if (!currentRenderCommandEncoder)
+                            throw Error{"Metal render command encoder not initialized"};
+
+                        // mesh buffer
+                        const auto indexBuffer = getResource<Buffer>(drawInstancedCommand->indexBuffer);
+                        const auto vertexBuffer = getResource<Buffer>(drawInstancedCommand->vertexBuffer);
+                        const auto instanceBuffer = getResource<Buffer>(drawInstancedCommand->instanceBuffer);
+
+                        assert(indexBuffer);
+                        assert(indexBuffer->getBuffer());
+                        assert(vertexBuffer);
+                        assert(vertexBuffer->getBuffer());
+                        assert(instanceBuffer);
+                        assert(instanceBuffer->getBuffer());
+
+                        [currentRenderCommandEncoder setVertexBuffer:vertexBuffer->getBuffer().get() offset:0 atIndex:0];
+                        [currentRenderCommandEncoder setVertexBuffer:instanceBuffer->getBuffer().get() offset:0 atIndex:2];
+
+                        // draw
+                        assert(drawInstancedCommand->indexCount);
+                        assert(drawInstancedCommand->instanceCount);
+
+                        [currentRenderCommandEncoder drawIndexedPrimitives:getPrimitiveType(drawInstancedCommand->drawMode)
+                                                                indexCount:drawInstancedCommand->indexCount
+                                                                 indexType:getIndexType(drawInstancedCommand->indexSize)
+                                                               indexBuffer:indexBuffer->getBuffer().get()
+                                                         indexBufferOffset:drawInstancedCommand->startIndex * drawInstancedCommand->indexSize
+                                                             instanceCount:drawInstancedCommand->instanceCount];
+
+                        break;
+                    }
+
                     case Command::Type::initBlendState:
                     {
                         const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
@@ -561,9 +620,7 @@ namespace ouzel::graphics::metal
                                                                        initBlendStateCommand->alphaOperation,
                                                                        initBlendStateCommand->colorMask);
 
-                        if (initBlendStateCommand->blendState > resources.size())
-                            resources.resize(initBlendStateCommand->blendState);
-                        resources[initBlendStateCommand->blendState - 1] = std::move(blendState);
+                        resources.set(initBlendStateCommand->blendState, std::move(blendState));
                         break;
                     }
 
@@ -577,9 +634,7 @@ namespace ouzel::graphics::metal
                                                                 initBufferCommand->data,
                                                                 initBufferCommand->size);
 
-                        if (initBufferCommand->buffer > resources.size())
-                            resources.resize(initBufferCommand->buffer);
-                        resources[initBufferCommand->buffer - 1] = std::move(buffer);
+                        resources.set(initBufferCommand->buffer, std::move(buffer));
                         break;
                     }
 
@@ -605,9 +660,7 @@ namespace ouzel::graphics::metal
                                                                initShaderCommand->fragmentShaderFunction,
                                                                initShaderCommand->vertexShaderFunction);
 
-                        if (initShaderCommand->shader > resources.size())
-                            resources.resize(initShaderCommand->shader);
-                        resources[initShaderCommand->shader - 1] = std::move(shader);
+                        resources.set(initShaderCommand->shader, std::move(shader));
                         break;
                     }
 
@@ -737,9 +790,7 @@ namespace ouzel::graphics::metal
                                                                  initTextureCommand->filter,
                                                                  initTextureCommand->maxAnisotropy);
 
-                        if (initTextureCommand->texture > resources.size())
-                            resources.resize(initTextureCommand->texture);
-                        resources[initTextureCommand->texture - 1] = std::move(texture);
+                        resources.set(initTextureCommand->texture, std::move(texture));
                         break;
                     }
 
@@ -753,6 +804,16 @@ namespace ouzel::graphics::metal
                         break;
                     }
 
+                    case Command::Type::setTextureRegion:
+                    {
+                        const auto setTextureRegionCommand = static_cast<const SetTextureRegionCommand*>(command.get());
+
+                        const auto texture = getResource<Texture>(setTextureRegionCommand->texture);
+                        texture->setRegion(setTextureRegionCommand->levels);
+
+                        break;
+                    }
+
                     case Command::Type::setTextureParameters:
                     {
                         const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
@@ -794,7 +855,11 @@ namespace ouzel::graphics::metal
                     default: throw Error{"Invalid command"};
                 }
 
-                if (command->type == Command::Type::present) return;
+                if (command->type == Command::Type::present)
+                {
+                    recycleCommandBuffer(std::move(commandBuffer));
+                    return;
+                }
             }
         }
     }
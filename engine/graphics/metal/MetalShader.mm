@@ -123,6 +123,31 @@ namespace ouzel::graphics::metal
         vertexDescriptor.get().layouts[0].stepRate = 1;
         vertexDescriptor.get().layouts[0].stepFunction = MTLVertexStepFunctionPerVertex;
 
+        // per-instance data is read from buffer index 2 (index 1 holds the shader constants)
+        NSUInteger instanceOffset = 0;
+
+        for (const auto& instanceAttribute : RenderDevice::instanceAttributes)
+        {
+            if (vertexAttributes.find(instanceAttribute.semantic) != vertexAttributes.end())
+            {
+                const MTLVertexFormat instanceFormat = getVertexFormat(instanceAttribute.dataType);
+
+                if (instanceFormat == MTLVertexFormatInvalid)
+                    throw Error{"Invalid instance format"};
+
+                vertexDescriptor.get().attributes[index].format = instanceFormat;
+                vertexDescriptor.get().attributes[index].offset = instanceOffset;
+                vertexDescriptor.get().attributes[index].bufferIndex = 2;
+                ++index;
+            }
+
+            instanceOffset += getDataTypeSize(instanceAttribute.dataType);
+        }
+
+        vertexDescriptor.get().layouts[2].stride = sizeof(Instance);
+        vertexDescriptor.get().layouts[2].stepRate = 1;
+        vertexDescriptor.get().layouts[2].stepFunction = MTLVertexStepFunctionPerInstance;
+
         NSError* err;
 
         const platform::dispatch::Data fragmentShaderDispatchData{
@@ -30,6 +30,7 @@ using MTLLoadAction = NSUInteger;
 #include "../SamplerAddressMode.hpp"
 #include "../SamplerFilter.hpp"
 #include "../TextureType.hpp"
+#include "../../math/Rect.hpp"
 #include "../../math/Size.hpp"
 #include "../../platform/objc/Pointer.hpp"
 
@@ -66,6 +67,7 @@ namespace ouzel::graphics::metal
                 std::uint32_t initMaxAnisotropy);
 
         void setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels);
+        void setRegion(const std::vector<std::pair<math::Rect<std::uint32_t>, std::vector<std::uint8_t>>>& levels);
         void setFilter(SamplerFilter filter);
         void setAddressX(SamplerAddressMode addressX);
         void setAddressY(SamplerAddressMode addressY);
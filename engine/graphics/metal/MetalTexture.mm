@@ -49,6 +49,28 @@ namespace ouzel::graphics::metal
                 case PixelFormat::rgba32Float: return MTLPixelFormatRGBA32Float;
                 case PixelFormat::depth: return MTLPixelFormatDepth32Float;
                 case PixelFormat::depthStencil: return MTLPixelFormatDepth32Float_Stencil8; // MTLPixelFormatDepth24Unorm_Stencil8 is only available on macOS
+#if TARGET_OS_IOS || TARGET_OS_TV
+                case PixelFormat::etc2RgbUnsignedNorm: return MTLPixelFormatETC2_RGB8;
+                case PixelFormat::etc2RgbUnsignedNormSRGB: return MTLPixelFormatETC2_RGB8_sRGB;
+                case PixelFormat::etc2RgbaUnsignedNorm: return MTLPixelFormatEAC_RGBA8;
+                case PixelFormat::etc2RgbaUnsignedNormSRGB: return MTLPixelFormatEAC_RGBA8_sRGB;
+                case PixelFormat::eacRUnsignedNorm: return MTLPixelFormatEAC_R11Unorm;
+                case PixelFormat::eacRgUnsignedNorm: return MTLPixelFormatEAC_RG11Unorm;
+                case PixelFormat::astc4x4RgbaUnsignedNorm: return MTLPixelFormatASTC_4x4_LDR;
+                case PixelFormat::astc4x4RgbaUnsignedNormSRGB: return MTLPixelFormatASTC_4x4_sRGB;
+#else
+                case PixelFormat::bc1RgbaUnsignedNorm: return MTLPixelFormatBC1_RGBA;
+                case PixelFormat::bc1RgbaUnsignedNormSRGB: return MTLPixelFormatBC1_RGBA_sRGB;
+                case PixelFormat::bc2RgbaUnsignedNorm: return MTLPixelFormatBC2_RGBA;
+                case PixelFormat::bc2RgbaUnsignedNormSRGB: return MTLPixelFormatBC2_RGBA_sRGB;
+                case PixelFormat::bc3RgbaUnsignedNorm: return MTLPixelFormatBC3_RGBA;
+                case PixelFormat::bc3RgbaUnsignedNormSRGB: return MTLPixelFormatBC3_RGBA_sRGB;
+                case PixelFormat::bc4RUnsignedNorm: return MTLPixelFormatBC4_RUnorm;
+                case PixelFormat::bc5RgUnsignedNorm: return MTLPixelFormatBC5_RGUnorm;
+                case PixelFormat::bc6hRgbUnsignedFloat: return MTLPixelFormatBC6H_RGBUfloat;
+                case PixelFormat::bc7RgbaUnsignedNorm: return MTLPixelFormatBC7_RGBAUnorm;
+                case PixelFormat::bc7RgbaUnsignedNormSRGB: return MTLPixelFormatBC7_RGBAUnorm_sRGB;
+#endif
                 default: throw std::runtime_error{"Invalid pixel format"};
             }
         }
@@ -144,6 +166,17 @@ namespace ouzel::graphics::metal
         else
             textureDescriptor.get().usage = MTLTextureUsageShaderRead;
 
+#if (defined(__MAC_10_15) && __MAC_OS_X_VERSION_MAX_ALLOWED >= __MAC_10_15) || \
+    (defined(__IPHONE_13_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_13_0) || \
+    (defined(__TVOS_13_0) && __TV_OS_VERSION_MAX_ALLOWED >= __TVOS_13_0)
+        if ((flags & Flags::luminance) == Flags::luminance)
+            if (@available(macOS 10.15, iOS 13.0, tvOS 13.0, *))
+                textureDescriptor.get().swizzle = MTLTextureSwizzleChannelsMake(MTLTextureSwizzleRed,
+                                                                                MTLTextureSwizzleRed,
+                                                                                MTLTextureSwizzleRed,
+                                                                                (pixelFormat == MTLPixelFormatRG8Unorm) ? MTLTextureSwizzleGreen : MTLTextureSwizzleOne);
+#endif
+
         texture = [renderDevice.getDevice().get() newTextureWithDescriptor:textureDescriptor.get()];
 
         if (!texture)
@@ -182,7 +215,7 @@ namespace ouzel::graphics::metal
                                                                  static_cast<NSUInteger>(levels[level].first.v[1]))
                                      mipmapLevel:level
                                        withBytes:levels[level].second.data()
-                                     bytesPerRow:static_cast<NSUInteger>(levels[level].first.v[0] * pixelSize)];
+                                     bytesPerRow:getRowPitch(initPixelFormat, levels[level].first.v[0])];
             }
         }
 
@@ -213,6 +246,27 @@ namespace ouzel::graphics::metal
         }
     }
 
+    void Texture::setRegion(const std::vector<std::pair<math::Rect<std::uint32_t>, std::vector<std::uint8_t>>>& levels)
+    {
+        if ((flags & Flags::dynamic) != Flags::dynamic ||
+            (flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
+            throw Error{"Texture is not dynamic"};
+
+        for (std::size_t level = 0; level < levels.size(); ++level)
+        {
+            const auto& [rectangle, data] = levels[level];
+
+            if (!data.empty())
+                [texture.get() replaceRegion:MTLRegionMake2D(static_cast<NSUInteger>(rectangle.position.v[0]),
+                                                             static_cast<NSUInteger>(rectangle.position.v[1]),
+                                                             static_cast<NSUInteger>(rectangle.size.v[0]),
+                                                             static_cast<NSUInteger>(rectangle.size.v[1]))
+                                 mipmapLevel:level
+                                   withBytes:data.data()
+                                 bytesPerRow:static_cast<NSUInteger>(rectangle.size.v[0] * pixelSize)];
+        }
+    }
+
     void Texture::setFilter(SamplerFilter filter)
     {
         samplerDescriptor.filter = filter;
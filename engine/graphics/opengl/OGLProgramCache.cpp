@@ -0,0 +1,122 @@
+// Ouzel by Elviss Strazdins
+
+#include "../../core/Setup.h"
+
+#if OUZEL_COMPILE_OPENGL
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "OGLProgramCache.hpp"
+#include "OGLRenderDevice.hpp"
+#include "../../hash/Fnv1.hpp"
+#include "../../storage/FileSystem.hpp"
+#include "../../utils/Log.hpp"
+
+namespace ouzel::graphics::opengl
+{
+    namespace
+    {
+        constexpr std::uint32_t cacheVersion = 1;
+
+        // version, driver hash and binary format
+        constexpr std::size_t headerSize = sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(std::uint32_t);
+
+        std::uint64_t hashString(const std::string& value) noexcept
+        {
+            auto result = hash::fnv1::Constants<std::uint64_t>::offsetBasis;
+            for (const auto c : value)
+                result = hash::fnv1::hash<std::uint64_t>(static_cast<std::uint8_t>(c), 0, result);
+            return result;
+        }
+    }
+
+    ProgramCache::ProgramCache(RenderDevice& initRenderDevice,
+                               const std::string& initDirectory,
+                               const std::string& driverName):
+        renderDevice{initRenderDevice},
+        directory{initDirectory},
+        driverHash{hashString(driverName)}
+    {
+        const storage::Path path{directory};
+        if (storage::FileSystem::getFileType(path) == storage::FileType::notFound)
+            storage::FileSystem::createDirectory(path);
+    }
+
+    bool ProgramCache::load(GLuint programId, std::uint64_t key) const
+    {
+        std::ifstream file{getFilename(key), std::ios::binary};
+        if (!file) return false;
+
+        const std::vector<char> data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        if (data.size() <= headerSize) return false;
+
+        std::uint32_t version;
+        std::uint64_t fileDriverHash;
+        std::uint32_t format;
+        std::memcpy(&version, data.data(), sizeof(version));
+        std::memcpy(&fileDriverHash, data.data() + sizeof(version), sizeof(fileDriverHash));
+        std::memcpy(&format, data.data() + sizeof(version) + sizeof(fileDriverHash), sizeof(format));
+
+        if (version != cacheVersion || fileDriverHash != driverHash) return false;
+
+        renderDevice.glProgramBinaryProc(programId,
+                                         static_cast<GLenum>(format),
+                                         data.data() + headerSize,
+                                         static_cast<GLsizei>(data.size() - headerSize));
+
+        GLint status = GL_FALSE;
+        renderDevice.glGetProgramivProc(programId, GL_LINK_STATUS, &status);
+
+        // drivers reject the binaries after updates, which is not an error
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR || status != GL_TRUE)
+        {
+            log(Log::Level::info) << "Program binary rejected, compiling shader from source";
+            return false;
+        }
+
+        return true;
+    }
+
+    void ProgramCache::store(GLuint programId, std::uint64_t key) const
+    {
+        GLint length = 0;
+        renderDevice.glGetProgramivProc(programId, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return;
+
+        std::vector<char> data(headerSize + static_cast<std::size_t>(length));
+        GLsizei binaryLength = 0;
+        GLenum format = GL_NONE;
+        renderDevice.glGetProgramBinaryProc(programId, length, &binaryLength, &format, data.data() + headerSize);
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR || binaryLength <= 0)
+        {
+            log(Log::Level::warning) << "Failed to get program binary";
+            return;
+        }
+
+        const auto format32 = static_cast<std::uint32_t>(format);
+        std::memcpy(data.data(), &cacheVersion, sizeof(cacheVersion));
+        std::memcpy(data.data() + sizeof(cacheVersion), &driverHash, sizeof(driverHash));
+        std::memcpy(data.data() + sizeof(cacheVersion) + sizeof(driverHash), &format32, sizeof(format32));
+
+        // a failure to write the cache only costs a compilation on the next launch
+        std::ofstream file{getFilename(key), std::ios::binary | std::ios::trunc};
+        if (!file.write(data.data(), static_cast<std::streamsize>(headerSize + static_cast<std::size_t>(binaryLength))))
+            log(Log::Level::warning) << "Failed to write program binary";
+    }
+
+    std::string ProgramCache::getFilename(std::uint64_t key) const
+    {
+        constexpr char digits[] = "0123456789abcdef";
+
+        std::string name(16, '0');
+        for (std::size_t i = 0; i < 16; ++i)
+            name[15 - i] = digits[(key >> (i * 4)) & 0x0FU];
+
+        return std::string{storage::Path{directory} / storage::Path{name + ".bin"}};
+    }
+}
+
+#endif
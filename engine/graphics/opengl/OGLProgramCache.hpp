@@ -0,0 +1,54 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_OGLPROGRAMCACHE_HPP
+#define OUZEL_GRAPHICS_OGLPROGRAMCACHE_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "../../core/Setup.h"
+
+#if OUZEL_COMPILE_OPENGL
+
+#include "OGL.h"
+
+#if OUZEL_OPENGLES
+#  include "GLES/gl.h"
+#  include "GLES2/gl2.h"
+#  include "GLES2/gl2ext.h"
+#  include "GLES3/gl3.h"
+#else
+#  include "GL/glcorearb.h"
+#  include "GL/glext.h"
+#endif
+
+namespace ouzel::graphics::opengl
+{
+    class RenderDevice;
+
+    // Stores the linked program binaries in files, so that the shaders don't have to be compiled
+    // on the next launch. The binaries of a different driver are ignored and replaced.
+    class ProgramCache final
+    {
+    public:
+        ProgramCache(RenderDevice& initRenderDevice,
+                     const std::string& initDirectory,
+                     const std::string& driverName);
+
+        // returns false if there is no binary for the key or the driver rejected it,
+        // in which case the program has to be compiled and linked from source
+        bool load(GLuint programId, std::uint64_t key) const;
+        void store(GLuint programId, std::uint64_t key) const;
+
+    private:
+        std::string getFilename(std::uint64_t key) const;
+
+        RenderDevice& renderDevice;
+        std::string directory;
+        std::uint64_t driverHash;
+    };
+}
+
+#endif
+
+#endif // OUZEL_GRAPHICS_OGLPROGRAMCACHE_HPP
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 #include "OGL.h"
 
@@ -261,7 +262,9 @@ namespace ouzel::graphics::opengl
                                core::Window& newWindow):
         graphics::RenderDevice{Driver::openGl, settings, newWindow},
         textureBaseLevelSupported{false},
-        textureMaxLevelSupported{false}
+        textureMaxLevelSupported{false},
+        pixelBufferObjectsSupported{false},
+        shaderCacheDirectory{settings.shaderCacheDirectory}
     {
         projectionTransform = math::Matrix<float, 4>{
             1.0F, 0.0F, 0.0F, 0.0F,
@@ -281,6 +284,26 @@ namespace ouzel::graphics::opengl
     RenderDevice::~RenderDevice()
     {
         if (vertexArrayId) glDeleteVertexArraysProc(1, &vertexArrayId);
+        if (pixelUnpackBufferId) glDeleteBuffersProc(1, &pixelUnpackBufferId);
+
+        for (const auto& queries : pendingTimerQueries)
+            for (const auto& timerQuery : queries)
+                freeTimerQueries.push_back(timerQuery.query);
+        for (const auto& timerQuery : frameTimerQueries)
+            freeTimerQueries.push_back(timerQuery.query);
+        if (!freeTimerQueries.empty())
+            glDeleteQueriesProc(static_cast<GLsizei>(freeTimerQueries.size()), freeTimerQueries.data());
+
+        for (const auto& frameFence : frameFences)
+            glDeleteSyncProc(frameFence.second);
+
+        for (const auto& pixelReadback : pixelReadbacks)
+        {
+            glDeleteSyncProc(pixelReadback.fence);
+            freeReadbackBuffers.push_back(pixelReadback.buffer);
+        }
+        if (!freeReadbackBuffers.empty())
+            glDeleteBuffersProc(static_cast<GLsizei>(freeReadbackBuffers.size()), freeReadbackBuffers.data());
 
         resources.clear();
     }
@@ -318,6 +341,10 @@ namespace ouzel::graphics::opengl
 
         log(Log::Level::info) << "Using " << rendererName << " by " << vendorName << " for rendering";
 
+        std::string versionName;
+        if (const auto versionNamePointer = glGetStringProc(GL_VERSION))
+            versionName = reinterpret_cast<const char*>(versionNamePointer);
+
 #if OUZEL_OPENGLES
         npotTexturesSupported = apiVersion >= ApiVersion{3, 0} || getter.hasExtension("GL_OES_texture_npot");
         renderTargetsSupported = apiVersion >= ApiVersion{3, 0};
@@ -328,8 +355,15 @@ namespace ouzel::graphics::opengl
             getter.hasExtension("GL_IMG_multisampled_render_to_texture");
         textureBaseLevelSupported = apiVersion >= ApiVersion{3, 0};
         textureMaxLevelSupported = apiVersion >= ApiVersion{3, 0} || getter.hasExtension("GL_APPLE_texture_max_level");
+        pixelBufferObjectsSupported = apiVersion >= ApiVersion{3, 0} || getter.hasExtension("GL_NV_pixel_buffer_object");
         uintIndicesSupported = apiVersion >= ApiVersion{3, 0} || getter.hasExtension("OES_element_index_uint");
         anisotropicFilteringSupported = getter.hasExtension("GL_EXT_texture_filter_anisotropic");
+        bcTexturesSupported = getter.hasExtension("GL_EXT_texture_compression_s3tc") &&
+            getter.hasExtension("GL_EXT_texture_compression_rgtc");
+        bptcTexturesSupported = getter.hasExtension("GL_EXT_texture_compression_bptc");
+        etc2TexturesSupported = apiVersion >= ApiVersion{3, 0};
+        luminanceTexturesSupported = apiVersion >= ApiVersion{3, 0};
+        astcTexturesSupported = apiVersion >= ApiVersion{3, 2} || getter.hasExtension("GL_KHR_texture_compression_astc_ldr");
 
         glEnableProc = getter.get<PFNGLENABLEPROC>("glEnable", ApiVersion{1, 0});
         glDisableProc = getter.get<PFNGLDISABLEPROC>("glDisable", ApiVersion{1, 0});
@@ -343,6 +377,7 @@ namespace ouzel::graphics::opengl
         glTexParameterfvProc = getter.get<PFNGLTEXPARAMETERFVPROC>("glTexParameterfv", ApiVersion{1, 0});
         glTexImage2DProc = getter.get<PFNGLTEXIMAGE2DPROC>("glTexImage2D", ApiVersion{1, 0});
         glTexSubImage2DProc = getter.get<PFNGLTEXSUBIMAGE2DPROC>("glTexSubImage2D", ApiVersion{1, 0});
+        glCompressedTexImage2DProc = getter.get<PFNGLCOMPRESSEDTEXIMAGE2DPROC>("glCompressedTexImage2D", ApiVersion{2, 0});
         glViewportProc = getter.get<PFNGLVIEWPORTPROC>("glViewport", ApiVersion{1, 0});
         glClearProc = getter.get<PFNGLCLEARPROC>("glClear", ApiVersion{1, 0});
         glClearColorProc = getter.get<PFNGLCLEARCOLORPROC>("glClearColor", ApiVersion{1, 0});
@@ -391,6 +426,11 @@ namespace ouzel::graphics::opengl
         glUseProgramProc = getter.get<PFNGLUSEPROGRAMPROC>("glUseProgram", ApiVersion{2, 0});
         glLinkProgramProc = getter.get<PFNGLLINKPROGRAMPROC>("glLinkProgram", ApiVersion{2, 0});
         glGetProgramivProc = getter.get<PFNGLGETPROGRAMIVPROC>("glGetProgramiv", ApiVersion{2, 0});
+        glGetProgramBinaryProc = getter.get<PFNGLGETPROGRAMBINARYPROC>("glGetProgramBinary", ApiVersion{3, 0},
+                                                                       {{"glGetProgramBinaryOES", "GL_OES_get_program_binary"}});
+        glProgramBinaryProc = getter.get<PFNGLPROGRAMBINARYPROC>("glProgramBinary", ApiVersion{3, 0},
+                                                                 {{"glProgramBinaryOES", "GL_OES_get_program_binary"}});
+        glProgramParameteriProc = getter.get<PFNGLPROGRAMPARAMETERIPROC>("glProgramParameteri", ApiVersion{3, 0});
         glGetProgramInfoLogProc = getter.get<PFNGLGETPROGRAMINFOLOGPROC>("glGetProgramInfoLog", ApiVersion{2, 0});
         glGetUniformLocationProc = getter.get<PFNGLGETUNIFORMLOCATIONPROC>("glGetUniformLocation", ApiVersion{2, 0});
 
@@ -438,10 +478,33 @@ namespace ouzel::graphics::opengl
         glDeleteVertexArraysProc = getter.get<PFNGLDELETEVERTEXARRAYSPROC>("glDeleteVertexArrays", ApiVersion{3, 0},
                                                                            {{"glDeleteVertexArraysOES", "GL_OES_vertex_array_object"}});
 
+        glVertexAttribDivisorProc = getter.get<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisor", ApiVersion{3, 0},
+                                                                             {{"glVertexAttribDivisorEXT", "GL_EXT_instanced_arrays"},
+                                                                              {"glVertexAttribDivisorANGLE", "GL_ANGLE_instanced_arrays"}});
+        glDrawElementsInstancedProc = getter.get<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstanced", ApiVersion{3, 0},
+                                                                                 {{"glDrawElementsInstancedEXT", "GL_EXT_instanced_arrays"},
+                                                                                  {"glDrawElementsInstancedANGLE", "GL_ANGLE_instanced_arrays"}});
+
         glPushGroupMarkerEXTProc = getter.get<PFNGLPUSHGROUPMARKEREXTPROC>("glPushGroupMarkerEXT", "GL_EXT_debug_marker");
         glPopGroupMarkerEXTProc = getter.get<PFNGLPOPGROUPMARKEREXTPROC>("glPopGroupMarkerEXT", "GL_EXT_debug_marker");
 
         glCopyImageSubDataProc = getter.get<PFNGLCOPYIMAGESUBDATAPROC>("glCopyImageSubData", ApiVersion{3, 2});
+        glInvalidateFramebufferProc = getter.get<PFNGLINVALIDATEFRAMEBUFFERPROC>("glInvalidateFramebuffer", ApiVersion{3, 0},
+                                                                                 {{"glDiscardFramebufferEXT", "GL_EXT_discard_framebuffer"}});
+
+        glFenceSyncProc = getter.get<PFNGLFENCESYNCPROC>("glFenceSync", ApiVersion{3, 0},
+                                                         {{"glFenceSyncAPPLE", "GL_APPLE_sync"}});
+        glClientWaitSyncProc = getter.get<PFNGLCLIENTWAITSYNCPROC>("glClientWaitSync", ApiVersion{3, 0},
+                                                                   {{"glClientWaitSyncAPPLE", "GL_APPLE_sync"}});
+        glDeleteSyncProc = getter.get<PFNGLDELETESYNCPROC>("glDeleteSync", ApiVersion{3, 0},
+                                                           {{"glDeleteSyncAPPLE", "GL_APPLE_sync"}});
+
+        glGenQueriesProc = getter.get<PFNGLGENQUERIESEXTPROC>("glGenQueriesEXT", "GL_EXT_disjoint_timer_query");
+        glDeleteQueriesProc = getter.get<PFNGLDELETEQUERIESEXTPROC>("glDeleteQueriesEXT", "GL_EXT_disjoint_timer_query");
+        glBeginQueryProc = getter.get<PFNGLBEGINQUERYEXTPROC>("glBeginQueryEXT", "GL_EXT_disjoint_timer_query");
+        glEndQueryProc = getter.get<PFNGLENDQUERYEXTPROC>("glEndQueryEXT", "GL_EXT_disjoint_timer_query");
+        glGetQueryObjectuivProc = getter.get<PFNGLGETQUERYOBJECTUIVEXTPROC>("glGetQueryObjectuivEXT", "GL_EXT_disjoint_timer_query");
+        glGetQueryObjectui64vProc = getter.get<PFNGLGETQUERYOBJECTUI64VEXTPROC>("glGetQueryObjectui64vEXT", "GL_EXT_disjoint_timer_query");
 
         glRenderbufferStorageMultisampleProc = getter.get<PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC>("glRenderbufferStorageMultisample", ApiVersion{3, 0},
                                                                                                    {{"glRenderbufferStorageMultisampleEXT", "GL_EXT_multisampled_render_to_texture"},
@@ -468,6 +531,7 @@ namespace ouzel::graphics::opengl
         clampToBorderSupported = apiVersion >= ApiVersion{1, 3} || getter.hasExtension("GL_EXT_texture_mirror_clamp");
         textureBaseLevelSupported = apiVersion >= ApiVersion{1, 3};
         textureMaxLevelSupported = apiVersion >= ApiVersion{1, 3};
+        pixelBufferObjectsSupported = apiVersion >= ApiVersion{2, 1} || getter.hasExtension("GL_ARB_pixel_buffer_object");
         uintIndicesSupported = apiVersion >= ApiVersion{2, 0};
         npotTexturesSupported = apiVersion >= ApiVersion{2, 0};
         renderTargetsSupported = apiVersion >= ApiVersion{3, 0} ||
@@ -477,6 +541,13 @@ namespace ouzel::graphics::opengl
         anisotropicFilteringSupported = apiVersion >= ApiVersion{4, 6} ||
             getter.hasExtension("GL_EXT_texture_filter_anisotropic") ||
             getter.hasExtension("GL_ARB_texture_filter_anisotropic");
+        bcTexturesSupported = getter.hasExtension("GL_EXT_texture_compression_s3tc") &&
+            (apiVersion >= ApiVersion{3, 0} || getter.hasExtension("GL_ARB_texture_compression_rgtc"));
+        bptcTexturesSupported = apiVersion >= ApiVersion{4, 2} || getter.hasExtension("GL_ARB_texture_compression_bptc");
+        luminanceTexturesSupported = (apiVersion >= ApiVersion{3, 0} || getter.hasExtension("GL_ARB_texture_rg")) &&
+            (apiVersion >= ApiVersion{3, 3} || getter.hasExtension("GL_ARB_texture_swizzle") || getter.hasExtension("GL_EXT_texture_swizzle"));
+        etc2TexturesSupported = apiVersion >= ApiVersion{4, 3} || getter.hasExtension("GL_ARB_ES3_compatibility");
+        astcTexturesSupported = getter.hasExtension("GL_KHR_texture_compression_astc_ldr");
 
         glEnableProc = getter.get<PFNGLENABLEPROC>("glEnable", ApiVersion{1, 0});
         glDisableProc = getter.get<PFNGLDISABLEPROC>("glDisable", ApiVersion{1, 0});
@@ -490,6 +561,8 @@ namespace ouzel::graphics::opengl
         glTexParameterfvProc = getter.get<PFNGLTEXPARAMETERFVPROC>("glTexParameterfv", ApiVersion{1, 0});
         glTexImage2DProc = getter.get<PFNGLTEXIMAGE2DPROC>("glTexImage2D", ApiVersion{1, 0});
         glTexSubImage2DProc = getter.get<PFNGLTEXSUBIMAGE2DPROC>("glTexSubImage2D", ApiVersion{1, 1});
+        glCompressedTexImage2DProc = getter.get<PFNGLCOMPRESSEDTEXIMAGE2DPROC>("glCompressedTexImage2D", ApiVersion{1, 3},
+                                                                              {{"glCompressedTexImage2DARB", "GL_ARB_texture_compression"}});
         glViewportProc = getter.get<PFNGLVIEWPORTPROC>("glViewport", ApiVersion{1, 0});
         glClearProc = getter.get<PFNGLCLEARPROC>("glClear", ApiVersion{1, 0});
         glClearColorProc = getter.get<PFNGLCLEARCOLORPROC>("glClearColor", ApiVersion{1, 0});
@@ -540,6 +613,12 @@ namespace ouzel::graphics::opengl
         glUseProgramProc = getter.get<PFNGLUSEPROGRAMPROC>("glUseProgram", ApiVersion{2, 0});
         glLinkProgramProc = getter.get<PFNGLLINKPROGRAMPROC>("glLinkProgram", ApiVersion{2, 0});
         glGetProgramivProc = getter.get<PFNGLGETPROGRAMIVPROC>("glGetProgramiv", ApiVersion{2, 0});
+        glGetProgramBinaryProc = getter.get<PFNGLGETPROGRAMBINARYPROC>("glGetProgramBinary", ApiVersion{4, 1},
+                                                                       {{"glGetProgramBinary", "GL_ARB_get_program_binary"}});
+        glProgramBinaryProc = getter.get<PFNGLPROGRAMBINARYPROC>("glProgramBinary", ApiVersion{4, 1},
+                                                                 {{"glProgramBinary", "GL_ARB_get_program_binary"}});
+        glProgramParameteriProc = getter.get<PFNGLPROGRAMPARAMETERIPROC>("glProgramParameteri", ApiVersion{4, 1},
+                                                                         {{"glProgramParameteri", "GL_ARB_get_program_binary"}});
         glGetProgramInfoLogProc = getter.get<PFNGLGETPROGRAMINFOLOGPROC>("glGetProgramInfoLog", ApiVersion{2, 0});
         glGetUniformLocationProc = getter.get<PFNGLGETUNIFORMLOCATIONPROC>("glGetUniformLocation", ApiVersion{2, 0});
 
@@ -618,13 +697,68 @@ namespace ouzel::graphics::opengl
         glDeleteVertexArraysProc = getter.get<PFNGLDELETEVERTEXARRAYSPROC>("glDeleteVertexArrays", ApiVersion{3, 0},
                                                                            {{"glDeleteVertexArrays", "GL_ARB_vertex_array_object"}});
 
+        glVertexAttribDivisorProc = getter.get<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisor", ApiVersion{3, 3},
+                                                                             {{"glVertexAttribDivisorARB", "GL_ARB_instanced_arrays"}});
+        glDrawElementsInstancedProc = getter.get<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstanced", ApiVersion{3, 1},
+                                                                                 {{"glDrawElementsInstancedARB", "GL_ARB_draw_instanced"}});
+
         glCopyImageSubDataProc = getter.get<PFNGLCOPYIMAGESUBDATAPROC>("glCopyImageSubData", ApiVersion{4, 3},
                                                                        {{"glCopyImageSubData", "GL_ARB_copy_image"}, {"glCopyImageSubDataEXT", "GL_EXT_copy_image"}});
+        glInvalidateFramebufferProc = getter.get<PFNGLINVALIDATEFRAMEBUFFERPROC>("glInvalidateFramebuffer", ApiVersion{4, 3},
+                                                                                 {{"glInvalidateFramebuffer", "GL_ARB_invalidate_subdata"}});
 
         glPushGroupMarkerEXTProc = getter.get<PFNGLPUSHGROUPMARKEREXTPROC>("glPushGroupMarkerEXT", "GL_EXT_debug_marker");
         glPopGroupMarkerEXTProc = getter.get<PFNGLPOPGROUPMARKEREXTPROC>("glPopGroupMarkerEXT", "GL_EXT_debug_marker");
+
+        glFenceSyncProc = getter.get<PFNGLFENCESYNCPROC>("glFenceSync", ApiVersion{3, 2},
+                                                         {{"glFenceSync", "GL_ARB_sync"}});
+        glClientWaitSyncProc = getter.get<PFNGLCLIENTWAITSYNCPROC>("glClientWaitSync", ApiVersion{3, 2},
+                                                                   {{"glClientWaitSync", "GL_ARB_sync"}});
+        glDeleteSyncProc = getter.get<PFNGLDELETESYNCPROC>("glDeleteSync", ApiVersion{3, 2},
+                                                           {{"glDeleteSync", "GL_ARB_sync"}});
+
+        glGenQueriesProc = getter.get<PFNGLGENQUERIESPROC>("glGenQueries", ApiVersion{1, 5});
+        glDeleteQueriesProc = getter.get<PFNGLDELETEQUERIESPROC>("glDeleteQueries", ApiVersion{1, 5});
+        glBeginQueryProc = getter.get<PFNGLBEGINQUERYPROC>("glBeginQuery", ApiVersion{1, 5});
+        glEndQueryProc = getter.get<PFNGLENDQUERYPROC>("glEndQuery", ApiVersion{1, 5});
+        glGetQueryObjectuivProc = getter.get<PFNGLGETQUERYOBJECTUIVPROC>("glGetQueryObjectuiv", ApiVersion{1, 5});
+        glGetQueryObjectui64vProc = getter.get<PFNGLGETQUERYOBJECTUI64VPROC>("glGetQueryObjectui64v", ApiVersion{3, 3},
+                                                                             {{"glGetQueryObjectui64v", "GL_ARB_timer_query"},
+                                                                              {"glGetQueryObjectui64vEXT", "GL_EXT_timer_query"}});
 #endif
 
+        instancingSupported = glVertexAttribDivisorProc && glDrawElementsInstancedProc;
+        if (!shaderCacheDirectory.empty() && glGetProgramBinaryProc && glProgramBinaryProc)
+        {
+            GLint binaryFormatCount = 0;
+            glGetIntegervProc(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+            // some drivers expose the functions without supporting any binary format
+            if (glGetErrorProc() == GL_NO_ERROR && binaryFormatCount > 0)
+            {
+                try
+                {
+                    programCache = std::make_unique<ProgramCache>(*this, shaderCacheDirectory,
+                                                                  vendorName + '\n' + rendererName + '\n' + versionName);
+                }
+                catch (const std::exception& e)
+                {
+                    log(Log::Level::warning) << "Failed to create shader cache: " << e.what();
+                }
+            }
+        }
+
+        timerQueriesSupported = glGenQueriesProc && glDeleteQueriesProc && glBeginQueryProc &&
+            glEndQueryProc && glGetQueryObjectuivProc && glGetQueryObjectui64vProc;
+        fencesSupported = glFenceSyncProc && glClientWaitSyncProc && glDeleteSyncProc;
+#if OUZEL_OPENGLES
+        asyncReadbackSupported = pixelBufferObjectsSupported && fencesSupported && glMapBufferRangeProc && glUnmapBufferProc;
+#else
+        asyncReadbackSupported = pixelBufferObjectsSupported && fencesSupported &&
+            (glMapBufferRangeProc || glMapBufferProc) && glUnmapBufferProc;
+#endif
+        textureStreamingSupported = true;
+
         if (!multisamplingSupported) sampleCount = 1;
 
         glDisableProc(GL_DITHER);
@@ -719,6 +853,9 @@ namespace ouzel::graphics::opengl
     void RenderDevice::process()
     {
         graphics::RenderDevice::process();
+        if (fencesSupported) waitForFrameFences();
+        if (!pixelReadbacks.empty()) finishPixelReadbacks();
+        resources.collect(getCompletedFrame(), [this](ResourceId id) { releaseResourceId(id); });
         executeAll();
 
         const RenderTarget* currentRenderTarget = nullptr;
@@ -730,14 +867,20 @@ namespace ouzel::graphics::opengl
         for (;;)
         {
             std::unique_lock lock{commandQueueMutex};
-            commandQueueCondition.wait(lock, [this]() noexcept { return !commandQueue.empty(); });
+            waitForCommands(lock);
+            recycleCommandBuffer(std::move(commandBuffer));
             commandBuffer = std::move(commandQueue.front());
             commandQueue.pop();
             lock.unlock();
 
+            // frames always start rendering to the back buffer
+            if (timerQueriesSupported && !timerQueryActive) beginTimerQuery(0);
+
             while (!commandBuffer.isEmpty())
             {
                 command = commandBuffer.popCommand();
+                countCommand(*command);
+                const CommandTimer commandTimer{*this, command->type};
 
                 switch (command->type)
                 {
@@ -752,14 +895,28 @@ namespace ouzel::graphics::opengl
 
                     case Command::Type::present:
                     {
+                        uploadPendingTextures();
+
+                        if (timerQueriesSupported)
+                        {
+                            endTimerQuery();
+                            readTimerQueries();
+                        }
+
+                        captureFrameImages();
                         present();
+
+                        if (fencesSupported)
+                            if (const auto fence = glFenceSyncProc(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+                                frameFences.emplace_back(renderFrame, fence);
                         break;
                     }
 
                     case Command::Type::deleteResource:
                     {
                         const auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
-                        resources[deleteResourceCommand->resource - 1].reset();
+                        cancelTextureUpload(deleteResourceCommand->resource);
+                        resources.retire(deleteResourceCommand->resource, renderFrame);
                         break;
                     }
 
@@ -775,9 +932,7 @@ namespace ouzel::graphics::opengl
                                                                            colorTextures,
                                                                            getResource<Texture>(initRenderTargetCommand->depthTexture));
 
-                        if (initRenderTargetCommand->renderTarget > resources.size())
-                            resources.resize(initRenderTargetCommand->renderTarget);
-                        resources[initRenderTargetCommand->renderTarget - 1] = std::move(renderTarget);
+                        resources.set(initRenderTargetCommand->renderTarget, std::move(renderTarget));
                         break;
                     }
 
@@ -785,6 +940,8 @@ namespace ouzel::graphics::opengl
                     {
                         const auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
 
+                        if (timerQueriesSupported) beginTimerQuery(setRenderTargetCommand->renderTarget);
+
                         if (setRenderTargetCommand->renderTarget)
                         {
                             currentRenderTarget = getResource<RenderTarget>(setRenderTargetCommand->renderTarget);
@@ -856,6 +1013,40 @@ namespace ouzel::graphics::opengl
                         break;
                     }
 
+                    case Command::Type::discardRenderTarget:
+                    {
+                        const auto discardCommand = static_cast<const DiscardRenderTargetCommand*>(command.get());
+
+                        if (!glInvalidateFramebufferProc) break;
+                        if (currentRenderTarget && !currentRenderTarget->getFrameBufferId()) break;
+
+                        // the default frame buffer uses different attachment names than the frame buffer objects
+                        std::vector<GLenum> attachments;
+                        if (discardCommand->discardColorBuffer)
+                        {
+                            if (!currentRenderTarget)
+                                attachments.push_back(GL_COLOR);
+                            else
+                                for (std::size_t i = 0; i < currentRenderTarget->getColorTextureCount(); ++i)
+                                    attachments.push_back(static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + i));
+                        }
+                        if (discardCommand->discardDepthBuffer)
+                            attachments.push_back(currentRenderTarget ? GL_DEPTH_ATTACHMENT : GL_DEPTH);
+                        if (discardCommand->discardStencilBuffer)
+                            attachments.push_back(currentRenderTarget ? GL_STENCIL_ATTACHMENT : GL_STENCIL);
+
+                        if (!attachments.empty())
+                        {
+                            glInvalidateFramebufferProc(GL_FRAMEBUFFER,
+                                                        static_cast<GLsizei>(attachments.size()),
+                                                        attachments.data());
+
+                            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                                throw std::system_error{makeErrorCode(error), "Failed to discard frame buffer"};
+                        }
+                        break;
+                    }
+
                     case Command::Type::setScissorTest:
                     {
                         const auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
@@ -900,9 +1091,7 @@ namespace ouzel::graphics::opengl
                                                                                      initDepthStencilStateCommand->backFaceStencilPassOperation,
                                                                                      initDepthStencilStateCommand->backFaceStencilCompareFunction);
 
-                        if (initDepthStencilStateCommand->depthStencilState > resources.size())
-                            resources.resize(initDepthStencilStateCommand->depthStencilState);
-                        resources[initDepthStencilStateCommand->depthStencilState - 1] = std::move(depthStencilState);
+                        resources.set(initDepthStencilStateCommand->depthStencilState, std::move(depthStencilState));
                         break;
                     }
 
@@ -1056,6 +1245,96 @@ namespace ouzel::graphics::opengl
                         break;
                     }
 
+                    case Command::Type::drawInstanced:
+                    {
+                        const auto drawInstancedCommand = static_cast<const DrawInstancedCommand*>(command.get());
+
+                        // mesh buffer
+                        const auto indexBuffer = getResource<Buffer>(drawInstancedCommand->indexBuffer);
+                        const auto vertexBuffer = getResource<Buffer>(drawInstancedCommand->vertexBuffer);
+                        const auto instanceBuffer = getResource<Buffer>(drawInstancedCommand->instanceBuffer);
+
+                        assert(indexBuffer);
+                        assert(indexBuffer->getBufferId());
+                        assert(vertexBuffer);
+                        assert(vertexBuffer->getBufferId());
+                        assert(instanceBuffer);
+                        assert(instanceBuffer->getBufferId());
+
+                        // draw
+                        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->getBufferId());
+                        bindBuffer(GL_ARRAY_BUFFER, vertexBuffer->getBufferId());
+
+                        const std::byte* vertexOffset = nullptr;
+
+                        for (GLuint index = 0; index < RenderDevice::vertexAttributes.size(); ++index)
+                        {
+                            const auto& vertexAttribute = RenderDevice::vertexAttributes[index];
+
+                            glEnableVertexAttribArrayProc(index);
+                            glVertexAttribPointerProc(index,
+                                                      getArraySize(vertexAttribute.dataType),
+                                                      getVertexType(vertexAttribute.dataType),
+                                                      isNormalized(vertexAttribute.dataType),
+                                                      static_cast<GLsizei>(sizeof(Vertex)),
+                                                      vertexOffset);
+
+                            vertexOffset += getDataTypeSize(vertexAttribute.dataType);
+                        }
+
+                        bindBuffer(GL_ARRAY_BUFFER, instanceBuffer->getBufferId());
+
+                        const std::byte* instanceOffset = nullptr;
+
+                        for (GLuint i = 0; i < RenderDevice::instanceAttributes.size(); ++i)
+                        {
+                            const auto& instanceAttribute = RenderDevice::instanceAttributes[i];
+                            const auto index = static_cast<GLuint>(RenderDevice::vertexAttributes.size()) + i;
+
+                            glEnableVertexAttribArrayProc(index);
+                            glVertexAttribPointerProc(index,
+                                                      getArraySize(instanceAttribute.dataType),
+                                                      getVertexType(instanceAttribute.dataType),
+                                                      isNormalized(instanceAttribute.dataType),
+                                                      static_cast<GLsizei>(sizeof(Instance)),
+                                                      instanceOffset);
+                            glVertexAttribDivisorProc(index, 1);
+
+                            instanceOffset += getDataTypeSize(instanceAttribute.dataType);
+                        }
+
+                        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                            throw std::system_error{makeErrorCode(error), "Failed to update vertex attributes"};
+
+                        assert(drawInstancedCommand->indexCount);
+                        assert(drawInstancedCommand->instanceCount);
+
+                        const std::byte* indexOffset = nullptr;
+                        indexOffset += drawInstancedCommand->startIndex * drawInstancedCommand->indexSize;
+
+                        glDrawElementsInstancedProc(getDrawMode(drawInstancedCommand->drawMode),
+                                                    static_cast<GLsizei>(drawInstancedCommand->indexCount),
+                                                    getIndexType(drawInstancedCommand->indexSize),
+                                                    indexOffset,
+                                                    static_cast<GLsizei>(drawInstancedCommand->instanceCount));
+
+                        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                            throw std::system_error{makeErrorCode(error), "Failed to draw instanced elements"};
+
+                        // non-instanced draws expect per-vertex attributes only
+                        for (GLuint i = 0; i < RenderDevice::instanceAttributes.size(); ++i)
+                        {
+                            const auto index = static_cast<GLuint>(RenderDevice::vertexAttributes.size()) + i;
+                            glVertexAttribDivisorProc(index, 0);
+                            glDisableVertexAttribArrayProc(index);
+                        }
+
+                        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                            throw std::system_error{makeErrorCode(error), "Failed to reset instance attributes"};
+
+                        break;
+                    }
+
                     case Command::Type::initBlendState:
                     {
                         const auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
@@ -1070,9 +1349,7 @@ namespace ouzel::graphics::opengl
                                                                        initBlendStateCommand->alphaOperation,
                                                                        initBlendStateCommand->colorMask);
 
-                        if (initBlendStateCommand->blendState > resources.size())
-                            resources.resize(initBlendStateCommand->blendState);
-                        resources[initBlendStateCommand->blendState - 1] = std::move(blendState);
+                        resources.set(initBlendStateCommand->blendState, std::move(blendState));
                         break;
                     }
 
@@ -1086,9 +1363,7 @@ namespace ouzel::graphics::opengl
                                                                initBufferCommand->data,
                                                                initBufferCommand->size);
 
-                        if (initBufferCommand->buffer > resources.size())
-                            resources.resize(initBufferCommand->buffer);
-                        resources[initBufferCommand->buffer - 1] = std::move(buffer);
+                        resources.set(initBufferCommand->buffer, std::move(buffer));
                         break;
                     }
 
@@ -1114,9 +1389,7 @@ namespace ouzel::graphics::opengl
                                                                initShaderCommand->fragmentShaderFunction,
                                                                initShaderCommand->vertexShaderFunction);
 
-                        if (initShaderCommand->shader > resources.size())
-                            resources.resize(initShaderCommand->shader);
-                        resources[initShaderCommand->shader - 1] = std::move(shader);
+                        resources.set(initShaderCommand->shader, std::move(shader));
                         break;
                     }
 
@@ -1166,6 +1439,8 @@ namespace ouzel::graphics::opengl
                     {
                         const auto initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
 
+                        cancelTextureUpload(initTextureCommand->texture);
+
                         auto texture = std::make_unique<Texture>(*this,
                                                                  initTextureCommand->levels,
                                                                  initTextureCommand->textureType,
@@ -1175,9 +1450,7 @@ namespace ouzel::graphics::opengl
                                                                  initTextureCommand->filter,
                                                                  initTextureCommand->maxAnisotropy);
 
-                        if (initTextureCommand->texture > resources.size())
-                            resources.resize(initTextureCommand->texture);
-                        resources[initTextureCommand->texture - 1] = std::move(texture);
+                        resources.set(initTextureCommand->texture, std::move(texture));
                         break;
                     }
 
@@ -1191,6 +1464,28 @@ namespace ouzel::graphics::opengl
                         break;
                     }
 
+                    case Command::Type::setTextureRegion:
+                    {
+                        const auto setTextureRegionCommand = static_cast<const SetTextureRegionCommand*>(command.get());
+
+                        const auto texture = getResource<Texture>(setTextureRegionCommand->texture);
+                        texture->setRegion(setTextureRegionCommand->levels);
+
+                        break;
+                    }
+
+                    case Command::Type::uploadTextureData:
+                    {
+                        const auto uploadTextureDataCommand = static_cast<UploadTextureDataCommand*>(command.get());
+
+                        const auto texture = getResource<Texture>(uploadTextureDataCommand->texture);
+                        texture->beginUpload(std::move(uploadTextureDataCommand->levels));
+
+                        cancelTextureUpload(uploadTextureDataCommand->texture);
+                        pendingTextureUploads.push_back(uploadTextureDataCommand->texture);
+                        break;
+                    }
+
                     case Command::Type::setTextureParameters:
                     {
                         const auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
@@ -1221,7 +1516,11 @@ namespace ouzel::graphics::opengl
                         throw Error{"Invalid command"};
                 }
 
-                if (command->type == Command::Type::present) return;
+                if (command->type == Command::Type::present)
+                {
+                    recycleCommandBuffer(std::move(commandBuffer));
+                    return;
+                }
             }
         }
     }
@@ -1230,46 +1529,256 @@ namespace ouzel::graphics::opengl
     {
     }
 
+    void RenderDevice::uploadPendingTextures()
+    {
+        std::size_t uploaded = 0;
+
+        for (auto i = pendingTextureUploads.begin(); i != pendingTextureUploads.end();)
+        {
+            if (textureUploadBudget && uploaded >= textureUploadBudget) break;
+
+            const auto texture = getResource<Texture>(*i);
+            uploaded += texture->uploadPending(textureUploadBudget ? textureUploadBudget - uploaded :
+                                               std::numeric_limits<std::size_t>::max());
+
+            if (!texture->isUploadPending())
+            {
+                Event event;
+                event.type = Event::Type::textureReady;
+                event.resource = *i;
+                postEvent(event);
+
+                i = pendingTextureUploads.erase(i);
+            }
+            else
+                ++i;
+        }
+    }
+
+    void RenderDevice::cancelTextureUpload(std::size_t texture)
+    {
+        pendingTextureUploads.erase(std::remove(pendingTextureUploads.begin(),
+                                                pendingTextureUploads.end(),
+                                                texture),
+                                    pendingTextureUploads.end());
+    }
+
+    void RenderDevice::waitForFrameFences()
+    {
+        while (!frameFences.empty())
+        {
+            const auto fence = frameFences.front().second;
+
+            // block only if the GPU is more than framesInFlight frames behind, otherwise just poll
+            const auto timeout = frameFences.size() > framesInFlight ? GLuint64{1000000000} : GLuint64{0};
+            const auto result = glClientWaitSyncProc(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+
+            if (result == GL_TIMEOUT_EXPIRED) break;
+            if (result == GL_WAIT_FAILED)
+                log(Log::Level::warning) << "Failed to wait for frame fence";
+
+            glDeleteSyncProc(fence);
+            frameFences.pop_front();
+        }
+
+        // all the frames before the oldest unfinished one have completed
+        completedFrame = frameFences.empty() ? renderFrame - 1 : frameFences.front().first - 1;
+    }
+
+    void RenderDevice::beginTimerQuery(ResourceId renderTarget)
+    {
+        if (timerQueryActive) endTimerQuery();
+
+        GLuint query;
+        if (freeTimerQueries.empty())
+        {
+            glGenQueriesProc(1, &query);
+
+            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error{makeErrorCode(error), "Failed to create timer query"};
+        }
+        else
+        {
+            query = freeTimerQueries.back();
+            freeTimerQueries.pop_back();
+        }
+
+#if OUZEL_OPENGLES
+        glBeginQueryProc(GL_TIME_ELAPSED_EXT, query);
+#else
+        glBeginQueryProc(GL_TIME_ELAPSED, query);
+#endif
+
+        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to begin timer query"};
+
+        frameTimerQueries.push_back(TimerQuery{query, renderTarget});
+        timerQueryActive = true;
+    }
+
+    void RenderDevice::endTimerQuery()
+    {
+        if (!timerQueryActive) return;
+
+#if OUZEL_OPENGLES
+        glEndQueryProc(GL_TIME_ELAPSED_EXT);
+#else
+        glEndQueryProc(GL_TIME_ELAPSED);
+#endif
+
+        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to end timer query"};
+
+        timerQueryActive = false;
+    }
+
+    void RenderDevice::readTimerQueries()
+    {
+        // results are read without stalling unless the GPU falls this many frames behind
+        constexpr std::size_t maxPendingFrames = 4;
+
+        if (!frameTimerQueries.empty())
+        {
+            pendingTimerQueries.push_back(std::move(frameTimerQueries));
+            frameTimerQueries.clear();
+        }
+
+#if OUZEL_OPENGLES
+        // the results of the queries in flight are invalid if the GPU was reset or its clock changed
+        GLint disjoint = GL_FALSE;
+        glGetIntegervProc(GL_GPU_DISJOINT_EXT, &disjoint);
+#else
+        constexpr GLint disjoint = GL_FALSE;
+#endif
+
+        while (!pendingTimerQueries.empty())
+        {
+            const auto& queries = pendingTimerQueries.front();
+
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuivProc(queries.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available && pendingTimerQueries.size() <= maxPendingFrames) break;
+
+            currentFrameStats.gpuTimesAvailable = !disjoint;
+            currentFrameStats.gpuTimes.clear();
+
+            for (const auto& timerQuery : queries)
+            {
+                GLuint64 elapsed = 0;
+                glGetQueryObjectui64vProc(timerQuery.query, GL_QUERY_RESULT, &elapsed);
+                currentFrameStats.gpuTimes.emplace_back(timerQuery.renderTarget, std::chrono::nanoseconds(elapsed));
+                freeTimerQueries.push_back(timerQuery.query);
+            }
+
+            pendingTimerQueries.pop_front();
+        }
+
+        if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to read timer queries"};
+    }
+
     void RenderDevice::generateScreenshot(const std::string& filename)
     {
         bindFrameBuffer(frameBufferId);
 
         const GLsizei pixelSize = 4;
+        const auto dataSize = static_cast<std::size_t>(frameBufferWidth * frameBufferHeight * pixelSize);
+
+        if (!asyncReadbackSupported)
+        {
+            std::vector<std::uint8_t> data(dataSize);
 
-        std::vector<std::uint8_t> data(static_cast<std::size_t>(frameBufferWidth * frameBufferHeight * pixelSize));
+            glReadPixelsProc(0, 0, frameBufferWidth, frameBufferHeight,
+                             GL_RGBA, GL_UNSIGNED_BYTE, data.data());
 
+            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error{makeErrorCode(error), "Failed to read pixels from frame buffer"};
+
+            // the rows are bottom to top, they are flipped on the worker thread
+            writeImageAsync(filename,
+                            static_cast<std::size_t>(frameBufferWidth),
+                            static_cast<std::size_t>(frameBufferHeight),
+                            std::move(data), true);
+            return;
+        }
+
+        // the readback buffers are mapped after the GPU has written them, so the render thread doesn't wait for it
+        GLuint buffer = 0;
+        if (!freeReadbackBuffers.empty())
+        {
+            buffer = freeReadbackBuffers.back();
+            freeReadbackBuffers.pop_back();
+        }
+        else
+        {
+            glGenBuffersProc(1, &buffer);
+
+            if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error{makeErrorCode(error), "Failed to create pixel pack buffer"};
+        }
+
+        bindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferDataProc(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(dataSize), nullptr, GL_STREAM_READ);
         glReadPixelsProc(0, 0, frameBufferWidth, frameBufferHeight,
-                         GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
         if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+        {
+            freeReadbackBuffers.push_back(buffer);
             throw std::system_error{makeErrorCode(error), "Failed to read pixels from frame buffer"};
+        }
 
-        // flip the image vertically
-        const auto rowSize = frameBufferWidth * pixelSize;
-        std::vector<std::uint8_t> temp(static_cast<std::size_t>(rowSize));
-        for (GLsizei row = 0; row < frameBufferHeight / 2; ++row)
+        pixelReadbacks.push_back(PixelReadback{
+            buffer,
+            glFenceSyncProc(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+            frameBufferWidth,
+            frameBufferHeight,
+            filename
+        });
+    }
+
+    void RenderDevice::finishPixelReadbacks()
+    {
+        while (!pixelReadbacks.empty())
         {
-            const auto topRowOffset = row * rowSize;
-            const auto bottomRowOffset = (frameBufferHeight - row - 1) * rowSize;
+            auto& pixelReadback = pixelReadbacks.front();
 
-            std::copy(data.begin() + topRowOffset,
-                      data.begin() + topRowOffset + rowSize,
-                      temp.begin());
+            // the readbacks are finished in order, so the first unfinished one stops the polling
+            if (glClientWaitSyncProc(pixelReadback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+                break;
 
-            std::copy(data.begin() + bottomRowOffset,
-                      data.begin() + bottomRowOffset + rowSize,
-                      data.begin() + topRowOffset);
+            glDeleteSyncProc(pixelReadback.fence);
 
-            std::copy(temp.begin(), temp.end(),
-                      data.begin() + bottomRowOffset);
-        }
+            const auto dataSize = static_cast<std::size_t>(pixelReadback.width * pixelReadback.height * 4);
+            bindBuffer(GL_PIXEL_PACK_BUFFER, pixelReadback.buffer);
 
-        saveScreenshot(filename,
-                       static_cast<std::size_t>(frameBufferWidth),
-                       static_cast<std::size_t>(frameBufferHeight),
-                       static_cast<std::size_t>(pixelSize),
-                       data.data(),
-                       static_cast<std::size_t>(frameBufferWidth * pixelSize));
+#if OUZEL_OPENGLES
+            const auto mapped = glMapBufferRangeProc(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(dataSize), GL_MAP_READ_BIT);
+#else
+            const auto mapped = glMapBufferRangeProc ?
+                glMapBufferRangeProc(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(dataSize), GL_MAP_READ_BIT) :
+                glMapBufferProc(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+#endif
+
+            if (mapped)
+            {
+                std::vector<std::uint8_t> data(static_cast<const std::uint8_t*>(mapped),
+                                               static_cast<const std::uint8_t*>(mapped) + dataSize);
+                glUnmapBufferProc(GL_PIXEL_PACK_BUFFER);
+
+                writeImageAsync(pixelReadback.filename,
+                                static_cast<std::size_t>(pixelReadback.width),
+                                static_cast<std::size_t>(pixelReadback.height),
+                                std::move(data), true);
+            }
+            else
+                log(Log::Level::error) << "Failed to map pixel pack buffer";
+
+            bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            freeReadbackBuffers.push_back(pixelReadback.buffer);
+            pixelReadbacks.pop_front();
+        }
     }
 }
 
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <array>
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <queue>
 #include <system_error>
@@ -31,7 +32,9 @@
 #endif
 
 #include "../RenderDevice.hpp"
+#include "../ResourceTable.hpp"
 #include "OGLErrorCategory.hpp"
+#include "OGLProgramCache.hpp"
 #include "OGLShader.hpp"
 #include "OGLStateCache.hpp"
 
@@ -56,6 +59,7 @@ namespace ouzel::graphics::opengl
         PFNGLTEXPARAMETERFVPROC glTexParameterfvProc = nullptr;
         PFNGLTEXIMAGE2DPROC glTexImage2DProc = nullptr;
         PFNGLTEXSUBIMAGE2DPROC glTexSubImage2DProc = nullptr;
+        PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2DProc = nullptr;
         PFNGLVIEWPORTPROC glViewportProc = nullptr;
         PFNGLCLEARPROC glClearProc = nullptr;
         PFNGLCLEARCOLORPROC glClearColorProc = nullptr;
@@ -111,6 +115,7 @@ namespace ouzel::graphics::opengl
         PFNGLUNMAPBUFFERPROC glUnmapBufferProc = nullptr;
 
         PFNGLCOPYIMAGESUBDATAPROC glCopyImageSubDataProc = nullptr;
+        PFNGLINVALIDATEFRAMEBUFFERPROC glInvalidateFramebufferProc = nullptr;
 
 #if OUZEL_OPENGLES
         PFNGLCLEARDEPTHFPROC glClearDepthfProc = nullptr;
@@ -141,6 +146,9 @@ namespace ouzel::graphics::opengl
         PFNGLUSEPROGRAMPROC glUseProgramProc = nullptr;
         PFNGLLINKPROGRAMPROC glLinkProgramProc = nullptr;
         PFNGLGETPROGRAMIVPROC glGetProgramivProc = nullptr;
+        PFNGLGETPROGRAMBINARYPROC glGetProgramBinaryProc = nullptr;
+        PFNGLPROGRAMBINARYPROC glProgramBinaryProc = nullptr;
+        PFNGLPROGRAMPARAMETERIPROC glProgramParameteriProc = nullptr;
         PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLogProc = nullptr;
         PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocationProc = nullptr;
 
@@ -156,16 +164,54 @@ namespace ouzel::graphics::opengl
         PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc = nullptr;
         PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc = nullptr;
         PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc = nullptr;
+        PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc = nullptr;
+        PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc = nullptr;
 
         PFNGLGETSTRINGIPROC glGetStringiProc = nullptr;
         PFNGLPUSHGROUPMARKEREXTPROC glPushGroupMarkerEXTProc = nullptr;
         PFNGLPOPGROUPMARKEREXTPROC glPopGroupMarkerEXTProc = nullptr;
 
+        PFNGLFENCESYNCPROC glFenceSyncProc = nullptr;
+        PFNGLCLIENTWAITSYNCPROC glClientWaitSyncProc = nullptr;
+        PFNGLDELETESYNCPROC glDeleteSyncProc = nullptr;
+
+#if OUZEL_OPENGLES
+        PFNGLGENQUERIESEXTPROC glGenQueriesProc = nullptr;
+        PFNGLDELETEQUERIESEXTPROC glDeleteQueriesProc = nullptr;
+        PFNGLBEGINQUERYEXTPROC glBeginQueryProc = nullptr;
+        PFNGLENDQUERYEXTPROC glEndQueryProc = nullptr;
+        PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivProc = nullptr;
+        PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vProc = nullptr;
+#else
+        PFNGLGENQUERIESPROC glGenQueriesProc = nullptr;
+        PFNGLDELETEQUERIESPROC glDeleteQueriesProc = nullptr;
+        PFNGLBEGINQUERYPROC glBeginQueryProc = nullptr;
+        PFNGLENDQUERYPROC glEndQueryProc = nullptr;
+        PFNGLGETQUERYOBJECTUIVPROC glGetQueryObjectuivProc = nullptr;
+        PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64vProc = nullptr;
+#endif
+
         RenderDevice(const Settings& settings,
                      core::Window& newWindow);
         ~RenderDevice() override;
 
         auto isTextureBaseLevelSupported() const noexcept { return textureBaseLevelSupported; }
+        auto isPixelBufferObjectsSupported() const noexcept { return pixelBufferObjectsSupported; }
+
+        GLuint getPixelUnpackBufferId()
+        {
+            if (!pixelBufferObjectsSupported) return 0;
+
+            if (!pixelUnpackBufferId)
+            {
+                glGenBuffersProc(1, &pixelUnpackBufferId);
+
+                if (const auto error = glGetErrorProc(); error != GL_NO_ERROR)
+                    throw std::system_error{makeErrorCode(error), "Failed to create pixel unpack buffer"};
+            }
+
+            return pixelUnpackBufferId;
+        }
         auto isTextureMaxLevelSupported() const noexcept { return textureMaxLevelSupported; }
 
         void setFrontFace(GLenum mode)
@@ -193,6 +239,8 @@ namespace ouzel::graphics::opengl
             }
         }
 
+        auto getProgramCache() const noexcept { return programCache.get(); }
+
         void useProgram(GLuint programId)
         {
             if (stateCache.programId != programId)
@@ -560,7 +608,7 @@ namespace ouzel::graphics::opengl
         template <class T>
         auto getResource(std::size_t id) const
         {
-            return id ? static_cast<T*>(resources[id - 1].get()) : nullptr;
+            return static_cast<T*>(resources.get(id));
         }
 
     protected:
@@ -571,6 +619,17 @@ namespace ouzel::graphics::opengl
         virtual void present();
         void generateScreenshot(const std::string& filename) override;
         void setUniform(GLint location, DataType dataType, const void* data);
+        void uploadPendingTextures();
+        void cancelTextureUpload(std::size_t texture);
+        void beginTimerQuery(ResourceId renderTarget);
+        void endTimerQuery();
+        void readTimerQueries();
+        void waitForFrameFences();
+        void finishPixelReadbacks();
+        std::size_t getPendingImageCount() const noexcept override
+        {
+            return graphics::RenderDevice::getPendingImageCount() + pixelReadbacks.size();
+        }
 
         bool embedded = false;
 
@@ -581,10 +640,45 @@ namespace ouzel::graphics::opengl
 
         bool textureBaseLevelSupported:1;
         bool textureMaxLevelSupported:1;
+        bool pixelBufferObjectsSupported:1;
+
+        GLuint pixelUnpackBufferId = 0;
+        std::vector<std::size_t> pendingTextureUploads;
+
+        struct TimerQuery final
+        {
+            GLuint query;
+            ResourceId renderTarget;
+        };
+
+        std::string shaderCacheDirectory;
+        std::unique_ptr<ProgramCache> programCache;
+
+        bool timerQueriesSupported = false;
+        bool timerQueryActive = false;
+        std::vector<GLuint> freeTimerQueries;
+        std::vector<TimerQuery> frameTimerQueries;
+        std::deque<std::vector<TimerQuery>> pendingTimerQueries; // frames whose results have not been read yet
+
+        bool fencesSupported = false;
+        std::deque<std::pair<std::uint64_t, GLsync>> frameFences; // presented frames that the GPU hasn't finished
+
+        struct PixelReadback final
+        {
+            GLuint buffer;
+            GLsync fence;
+            GLsizei width;
+            GLsizei height;
+            std::string filename;
+        };
+
+        bool asyncReadbackSupported = false;
+        std::vector<GLuint> freeReadbackBuffers;
+        std::deque<PixelReadback> pixelReadbacks;
 
         StateCache stateCache;
 
-        std::vector<std::unique_ptr<RenderResource>> resources;
+        ResourceTable<RenderResource> resources;
     };
 }
 
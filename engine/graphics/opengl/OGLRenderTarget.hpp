@@ -39,6 +39,7 @@ namespace ouzel::graphics::opengl
         void reload() final;
 
         auto getFrameBufferId() const noexcept { return frameBufferId; }
+        auto getColorTextureCount() const noexcept { return colorTextures.size(); }
 
     private:
         void createFrameBuffer();
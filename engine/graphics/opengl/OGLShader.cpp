@@ -7,6 +7,7 @@
 #include "OGLShader.hpp"
 #include "OGLError.hpp"
 #include "OGLRenderDevice.hpp"
+#include "../../hash/Fnv1.hpp"
 
 namespace ouzel::graphics::opengl
 {
@@ -86,6 +87,8 @@ namespace ouzel::graphics::opengl
                 case Vertex::Attribute::Usage::blendIndices: return "blendIndices" + std::to_string(semantic.index);
                 case Vertex::Attribute::Usage::blendWeight: return "blendWeight" + std::to_string(semantic.index);
                 case Vertex::Attribute::Usage::color: return "color" + std::to_string(semantic.index);
+                case Vertex::Attribute::Usage::instanceColor: return "instanceColor" + std::to_string(semantic.index);
+                case Vertex::Attribute::Usage::instanceTransform: return "instanceTransform" + std::to_string(semantic.index);
                 case Vertex::Attribute::Usage::normal: return "normal" + std::to_string(semantic.index);
                 case Vertex::Attribute::Usage::position: return "position" + std::to_string(semantic.index);
                 case Vertex::Attribute::Usage::positionTransformed: return "positionT";
@@ -96,9 +99,33 @@ namespace ouzel::graphics::opengl
                     throw Error{"Invalid vertex attribute usage"};
             }
         }
+
+        // identifies the linked program, the attribute locations are a part of the binary
+        std::uint64_t getProgramKey(const std::vector<std::uint8_t>& fragmentShader,
+                                    const std::vector<std::uint8_t>& vertexShader,
+                                    const std::set<Vertex::Attribute::Semantic>& vertexAttributes)
+        {
+            auto result = hash::fnv1::Constants<std::uint64_t>::offsetBasis;
+
+            result = hash::fnv1::hash<std::uint64_t>(static_cast<std::uint64_t>(fragmentShader.size()), 0, result);
+            for (const auto c : fragmentShader)
+                result = hash::fnv1::hash<std::uint64_t>(c, 0, result);
+
+            result = hash::fnv1::hash<std::uint64_t>(static_cast<std::uint64_t>(vertexShader.size()), 0, result);
+            for (const auto c : vertexShader)
+                result = hash::fnv1::hash<std::uint64_t>(c, 0, result);
+
+            for (const auto& semantic : vertexAttributes)
+            {
+                result = hash::fnv1::hash<std::uint64_t>(static_cast<std::uint32_t>(semantic.usage), 0, result);
+                result = hash::fnv1::hash<std::uint64_t>(static_cast<std::uint32_t>(semantic.index), 0, result);
+            }
+
+            return result;
+        }
     }
 
-    void Shader::compileShader()
+    void Shader::linkProgram(std::uint64_t programKey)
     {
         fragmentShaderId = renderDevice.glCreateShaderProc(GL_FRAGMENT_SHADER);
 
@@ -128,8 +155,6 @@ namespace ouzel::graphics::opengl
         if (status == GL_FALSE)
             throw Error{"Failed to compile vertex shader, error: " + getShaderMessage(vertexShaderId)};
 
-        programId = renderDevice.glCreateProgramProc();
-
         renderDevice.glAttachShaderProc(programId, vertexShaderId);
         renderDevice.glAttachShaderProc(programId, fragmentShaderId);
 
@@ -143,6 +168,24 @@ namespace ouzel::graphics::opengl
                 ++index;
             }
 
+        // instance attributes use fixed locations after the vertex attributes
+        for (std::size_t i = 0; i < RenderDevice::instanceAttributes.size(); ++i)
+        {
+            const auto& instanceAttribute = RenderDevice::instanceAttributes[i];
+            if (vertexAttributes.find(instanceAttribute.semantic) != vertexAttributes.end())
+            {
+                const auto usage = semanticToString(instanceAttribute.semantic);
+                renderDevice.glBindAttribLocationProc(programId,
+                                                      static_cast<GLuint>(RenderDevice::vertexAttributes.size() + i),
+                                                      usage.c_str());
+            }
+        }
+
+        const auto programCache = renderDevice.getProgramCache();
+
+        if (programCache && renderDevice.glProgramParameteriProc)
+            renderDevice.glProgramParameteriProc(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
         renderDevice.glLinkProgramProc(programId);
 
         renderDevice.glGetProgramivProc(programId, GL_LINK_STATUS, &status);
@@ -163,6 +206,20 @@ namespace ouzel::graphics::opengl
         if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
             throw std::system_error{makeErrorCode(error), "Failed to detach shader"};
 
+        if (programCache) programCache->store(programId, programKey);
+    }
+
+    void Shader::compileShader()
+    {
+        const auto programCache = renderDevice.getProgramCache();
+        const auto programKey = programCache ? getProgramKey(fragmentShaderData, vertexShaderData, vertexAttributes) : 0;
+
+        programId = renderDevice.glCreateProgramProc();
+
+        // a rejected binary leaves the program unlinked, so it can still be linked from source
+        if (!programCache || !programCache->load(programId, programKey))
+            linkProgram(programKey);
+
         renderDevice.useProgram(programId);
 
         const auto texture0Location = renderDevice.glGetUniformLocationProc(programId, "texture0");
@@ -171,6 +228,9 @@ namespace ouzel::graphics::opengl
         const auto texture1Location = renderDevice.glGetUniformLocationProc(programId, "texture1");
         if (texture1Location != -1) renderDevice.glUniform1iProc(texture1Location, 1);
 
+        const auto texture2Location = renderDevice.glGetUniformLocationProc(programId, "texture2");
+        if (texture2Location != -1) renderDevice.glUniform1iProc(texture2Location, 2);
+
         if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
             throw std::system_error{makeErrorCode(error), "Failed to get uniform location"};
 
@@ -64,6 +64,7 @@ namespace ouzel::graphics::opengl
 
     private:
         void compileShader();
+        void linkProgram(std::uint64_t programKey);
         std::string getShaderMessage(GLuint shaderId) const;
         std::string getProgramMessage() const;
 
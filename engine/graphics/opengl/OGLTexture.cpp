@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <algorithm>
 #include "OGLTexture.hpp"
 #include "OGLError.hpp"
 #include "OGLRenderDevice.hpp"
@@ -52,6 +53,25 @@ namespace ouzel::graphics::opengl
                     case PixelFormat::rgba32Float: return GL_RGBA32F;
                     case PixelFormat::depth: return GL_DEPTH_COMPONENT24;
                     case PixelFormat::depthStencil: return GL_DEPTH24_STENCIL8;
+                    case PixelFormat::bc1RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                    case PixelFormat::bc1RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+                    case PixelFormat::bc2RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+                    case PixelFormat::bc2RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+                    case PixelFormat::bc3RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                    case PixelFormat::bc3RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+                    case PixelFormat::bc4RUnsignedNorm: return GL_COMPRESSED_RED_RGTC1_EXT;
+                    case PixelFormat::bc5RgUnsignedNorm: return GL_COMPRESSED_RED_GREEN_RGTC2_EXT;
+                    case PixelFormat::bc6hRgbUnsignedFloat: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_EXT;
+                    case PixelFormat::bc7RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_BPTC_UNORM_EXT;
+                    case PixelFormat::bc7RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_EXT;
+                    case PixelFormat::etc2RgbUnsignedNorm: return GL_COMPRESSED_RGB8_ETC2;
+                    case PixelFormat::etc2RgbUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ETC2;
+                    case PixelFormat::etc2RgbaUnsignedNorm: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+                    case PixelFormat::etc2RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+                    case PixelFormat::eacRUnsignedNorm: return GL_COMPRESSED_R11_EAC;
+                    case PixelFormat::eacRgUnsignedNorm: return GL_COMPRESSED_RG11_EAC;
+                    case PixelFormat::astc4x4RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+                    case PixelFormat::astc4x4RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
                     default: throw Error{"Invalid pixel format"};
                 }
             }
@@ -63,6 +83,25 @@ namespace ouzel::graphics::opengl
                     case PixelFormat::rgba8UnsignedNorm: return GL_RGBA;
                     case PixelFormat::depth: return GL_DEPTH_COMPONENT24;
                     case PixelFormat::depthStencil: return GL_DEPTH24_STENCIL8;
+                    case PixelFormat::bc1RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                    case PixelFormat::bc1RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+                    case PixelFormat::bc2RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+                    case PixelFormat::bc2RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+                    case PixelFormat::bc3RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                    case PixelFormat::bc3RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+                    case PixelFormat::bc4RUnsignedNorm: return GL_COMPRESSED_RED_RGTC1_EXT;
+                    case PixelFormat::bc5RgUnsignedNorm: return GL_COMPRESSED_RED_GREEN_RGTC2_EXT;
+                    case PixelFormat::bc6hRgbUnsignedFloat: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_EXT;
+                    case PixelFormat::bc7RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_BPTC_UNORM_EXT;
+                    case PixelFormat::bc7RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_EXT;
+                    case PixelFormat::etc2RgbUnsignedNorm: return GL_COMPRESSED_RGB8_ETC2;
+                    case PixelFormat::etc2RgbUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ETC2;
+                    case PixelFormat::etc2RgbaUnsignedNorm: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+                    case PixelFormat::etc2RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+                    case PixelFormat::eacRUnsignedNorm: return GL_COMPRESSED_R11_EAC;
+                    case PixelFormat::eacRgUnsignedNorm: return GL_COMPRESSED_RG11_EAC;
+                    case PixelFormat::astc4x4RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+                    case PixelFormat::astc4x4RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
                     default: throw Error{"Invalid pixel format"};
                 }
             }
@@ -102,6 +141,25 @@ namespace ouzel::graphics::opengl
                 case PixelFormat::rgba32Float: return GL_RGBA32F;
                 case PixelFormat::depth: return GL_DEPTH_COMPONENT24;
                 case PixelFormat::depthStencil: return GL_DEPTH24_STENCIL8;
+                case PixelFormat::bc1RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                case PixelFormat::bc1RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+                case PixelFormat::bc2RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+                case PixelFormat::bc2RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+                case PixelFormat::bc3RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case PixelFormat::bc3RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+                case PixelFormat::bc4RUnsignedNorm: return GL_COMPRESSED_RED_RGTC1;
+                case PixelFormat::bc5RgUnsignedNorm: return GL_COMPRESSED_RG_RGTC2;
+                case PixelFormat::bc6hRgbUnsignedFloat: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+                case PixelFormat::bc7RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+                case PixelFormat::bc7RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+                case PixelFormat::etc2RgbUnsignedNorm: return GL_COMPRESSED_RGB8_ETC2;
+                case PixelFormat::etc2RgbUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ETC2;
+                case PixelFormat::etc2RgbaUnsignedNorm: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+                case PixelFormat::etc2RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+                case PixelFormat::eacRUnsignedNorm: return GL_COMPRESSED_R11_EAC;
+                case PixelFormat::eacRgUnsignedNorm: return GL_COMPRESSED_RG11_EAC;
+                case PixelFormat::astc4x4RgbaUnsignedNorm: return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+                case PixelFormat::astc4x4RgbaUnsignedNormSRGB: return GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
                 default: throw Error{"Invalid pixel format"};
             }
 #endif
@@ -269,8 +327,9 @@ namespace ouzel::graphics::opengl
         maxAnisotropy{static_cast<GLint>(initMaxAnisotropy)},
         textureTarget{getTextureTarget(type)},
         internalPixelFormat{getOpenGlInternalPixelFormat(initPixelFormat, renderDevice.getAPIMajorVersion())},
-        pixelFormat{getOpenGlPixelFormat(initPixelFormat)},
-        pixelType{getOpenGlPixelType(initPixelFormat)}
+        pixelFormat{isCompressed(initPixelFormat) ? GL_NONE : getOpenGlPixelFormat(initPixelFormat)},
+        pixelType{isCompressed(initPixelFormat) ? GL_NONE : getOpenGlPixelType(initPixelFormat)},
+        blockSize{getBlockSize(initPixelFormat)}
     {
         if ((flags & Flags::bindRenderTarget) == Flags::bindRenderTarget &&
             (mipmaps == 0 || mipmaps > 1))
@@ -279,11 +338,22 @@ namespace ouzel::graphics::opengl
         if (internalPixelFormat == GL_NONE)
             throw Error{"Invalid pixel format"};
 
-        if (pixelFormat == GL_NONE)
-            throw Error{"Invalid pixel format"};
+        if (blockSize)
+        {
+            if ((flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
+                throw Error{"Compressed textures can not be render targets"};
 
-        if (pixelType == GL_NONE)
-            throw Error{"Invalid pixel format"};
+            if (!renderDevice.isPixelFormatSupported(initPixelFormat))
+                throw Error{"Compressed pixel format not supported"};
+        }
+        else
+        {
+            if (pixelFormat == GL_NONE)
+                throw Error{"Invalid pixel format"};
+
+            if (pixelType == GL_NONE)
+                throw Error{"Invalid pixel format"};
+        }
 
         createTexture();
 
@@ -300,22 +370,7 @@ namespace ouzel::graphics::opengl
                     throw std::system_error{makeErrorCode(error), "Failed to set texture base and max levels"};
             }
 
-            for (std::size_t level = 0; level < levels.size(); ++level)
-            {
-                if (!levels[level].second.empty())
-                    renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
-                                                  static_cast<GLsizei>(levels[level].first.v[0]),
-                                                  static_cast<GLsizei>(levels[level].first.v[1]), 0,
-                                                  pixelFormat, pixelType, levels[level].second.data());
-                else
-                    renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
-                                                  static_cast<GLsizei>(levels[level].first.v[0]),
-                                                  static_cast<GLsizei>(levels[level].first.v[1]), 0,
-                                                  pixelFormat, pixelType, nullptr);
-            }
-
-            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
-                throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
+            uploadLevels();
         }
 
         setTextureParameters();
@@ -350,27 +405,39 @@ namespace ouzel::graphics::opengl
                     throw std::system_error{makeErrorCode(error), "Failed to set texture base and max levels"};
             }
 
-            for (std::size_t level = 0; level < levels.size(); ++level)
-            {
-                if (!levels[level].second.empty())
-                    renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
-                                                  static_cast<GLsizei>(levels[level].first.v[0]),
-                                                  static_cast<GLsizei>(levels[level].first.v[1]), 0,
-                                                  pixelFormat, pixelType, levels[level].second.data());
-                else
-                    renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
-                                                  static_cast<GLsizei>(levels[level].first.v[0]),
-                                                  static_cast<GLsizei>(levels[level].first.v[1]), 0,
-                                                  pixelFormat, pixelType, nullptr);
-            }
-
-            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
-                throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
+            uploadLevels();
 
             setTextureParameters();
         }
     }
 
+    void Texture::uploadLevels()
+    {
+        for (std::size_t level = 0; level < levels.size(); ++level)
+        {
+            const auto levelWidth = static_cast<GLsizei>(levels[level].first.v[0]);
+            const auto levelHeight = static_cast<GLsizei>(levels[level].first.v[1]);
+            const auto data = levels[level].second.empty() ? nullptr : levels[level].second.data();
+
+            if (blockSize)
+            {
+                // compressed levels have to be allocated with their full size even when there is no data
+                const auto dataSize = static_cast<GLsizei>(((levels[level].first.v[0] + 3) / 4) *
+                                                           ((levels[level].first.v[1] + 3) / 4) * blockSize);
+                renderDevice.glCompressedTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), internalPixelFormat,
+                                                        levelWidth, levelHeight, 0,
+                                                        dataSize, data);
+            }
+            else
+                renderDevice.glTexImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalPixelFormat),
+                                              levelWidth, levelHeight, 0,
+                                              pixelFormat, pixelType, data);
+        }
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
+    }
+
     void Texture::setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>,
                           std::vector<std::uint8_t>>>& newLevels)
     {
@@ -383,6 +450,9 @@ namespace ouzel::graphics::opengl
         if (!textureId)
             throw Error{"Texture not initialized"};
 
+        if (blockSize)
+            throw Error{"Compressed texture data can not be updated"};
+
         renderDevice.bindTexture(textureTarget, 0, textureId);
 
         for (std::size_t level = 0; level < levels.size(); ++level)
@@ -397,6 +467,133 @@ namespace ouzel::graphics::opengl
             throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
     }
 
+    void Texture::setRegion(const std::vector<std::pair<math::Rect<std::uint32_t>,
+                            std::vector<std::uint8_t>>>& newLevels)
+    {
+        if ((flags & Flags::dynamic) != Flags::dynamic ||
+            (flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
+            throw Error{"Texture is not dynamic"};
+
+        if (!textureId)
+            throw Error{"Texture not initialized"};
+
+        if (blockSize)
+            throw Error{"Compressed texture data can not be updated"};
+
+        renderDevice.bindTexture(textureTarget, 0, textureId);
+
+        for (std::size_t level = 0; level < newLevels.size() && level < levels.size(); ++level)
+        {
+            const auto& [rectangle, data] = newLevels[level];
+            if (data.empty()) continue;
+
+            const auto regionWidth = rectangle.size.v[0];
+            const auto regionHeight = rectangle.size.v[1];
+            auto& [levelSize, levelData] = levels[level];
+
+            if (rectangle.position.v[0] + regionWidth > levelSize.v[0] ||
+                rectangle.position.v[1] + regionHeight > levelSize.v[1])
+                throw Error{"Invalid texture region"};
+
+            renderDevice.glTexSubImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(level),
+                                             static_cast<GLint>(rectangle.position.v[0]),
+                                             static_cast<GLint>(rectangle.position.v[1]),
+                                             static_cast<GLsizei>(regionWidth),
+                                             static_cast<GLsizei>(regionHeight),
+                                             pixelFormat, pixelType,
+                                             data.data());
+
+            if (!levelData.empty() && regionWidth && regionHeight)
+            {
+                const auto pixelSize = data.size() / (static_cast<std::size_t>(regionWidth) * regionHeight);
+                const auto rowSize = regionWidth * pixelSize;
+
+                for (std::uint32_t y = 0; y < regionHeight; ++y)
+                    std::copy(data.begin() + static_cast<std::ptrdiff_t>(y * rowSize),
+                              data.begin() + static_cast<std::ptrdiff_t>((y + 1) * rowSize),
+                              levelData.begin() + static_cast<std::ptrdiff_t>(((rectangle.position.v[1] + y) * levelSize.v[0] + rectangle.position.v[0]) * pixelSize));
+            }
+        }
+
+        if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+            throw std::system_error{makeErrorCode(error), "Failed to upload texture region"};
+    }
+
+    void Texture::beginUpload(std::vector<std::pair<math::Size<std::uint32_t, 2>,
+                              std::vector<std::uint8_t>>> newLevels)
+    {
+        if ((flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
+            throw Error{"Render target texture data can not be uploaded"};
+
+        if (blockSize)
+            throw Error{"Compressed texture data can not be streamed"};
+
+        levels = std::move(newLevels);
+        uploadLevel = 0;
+        uploadRow = 0;
+    }
+
+    std::size_t Texture::uploadPending(std::size_t budget)
+    {
+        if (!textureId)
+            throw Error{"Texture not initialized"};
+
+        renderDevice.bindTexture(textureTarget, 0, textureId);
+
+        const auto pixelBufferId = renderDevice.getPixelUnpackBufferId();
+        std::size_t uploaded = 0;
+
+        while (uploadLevel < levels.size() && uploaded < budget)
+        {
+            const auto& level = levels[uploadLevel];
+            const auto levelWidth = static_cast<GLsizei>(level.first.v[0]);
+            const auto levelHeight = static_cast<GLsizei>(level.first.v[1]);
+
+            if (level.second.empty() || levelHeight == 0)
+            {
+                ++uploadLevel;
+                continue;
+            }
+
+            // upload a band of rows, at least one row per call so that the upload always progresses
+            const auto rowSize = level.second.size() / static_cast<std::size_t>(levelHeight);
+            const auto remainingRows = levelHeight - uploadRow;
+            const auto budgetRows = static_cast<GLsizei>(std::min(static_cast<std::size_t>(remainingRows),
+                                                                  std::max(std::size_t(1), (budget - uploaded) / rowSize)));
+            const auto data = level.second.data() + static_cast<std::size_t>(uploadRow) * rowSize;
+            const auto dataSize = static_cast<std::size_t>(budgetRows) * rowSize;
+
+            if (pixelBufferId)
+            {
+                // stage the rows in a pixel buffer object so that the driver can copy them to the texture asynchronously
+                renderDevice.bindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBufferId);
+                renderDevice.glBufferDataProc(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(dataSize), data, GL_STREAM_DRAW);
+                renderDevice.glTexSubImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(uploadLevel), 0, uploadRow,
+                                                 levelWidth, budgetRows,
+                                                 pixelFormat, pixelType, nullptr);
+                renderDevice.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+            else
+                renderDevice.glTexSubImage2DProc(GL_TEXTURE_2D, static_cast<GLint>(uploadLevel), 0, uploadRow,
+                                                 levelWidth, budgetRows,
+                                                 pixelFormat, pixelType, data);
+
+            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error{makeErrorCode(error), "Failed to upload texture data"};
+
+            uploaded += dataSize;
+            uploadRow += budgetRows;
+
+            if (uploadRow == levelHeight)
+            {
+                ++uploadLevel;
+                uploadRow = 0;
+            }
+        }
+
+        return uploaded;
+    }
+
     void Texture::setFilter(SamplerFilter newFilter)
     {
         filter = newFilter;
@@ -616,6 +813,18 @@ namespace ouzel::graphics::opengl
             if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
                 throw std::system_error{makeErrorCode(error), "Failed to set texture max anisotrophy"};
         }
+
+        if ((flags & Flags::luminance) == Flags::luminance)
+        {
+            // replicate the red channel into rgb and use green (or one) as alpha
+            renderDevice.glTexParameteriProc(textureTarget, GL_TEXTURE_SWIZZLE_R, GL_RED);
+            renderDevice.glTexParameteriProc(textureTarget, GL_TEXTURE_SWIZZLE_G, GL_RED);
+            renderDevice.glTexParameteriProc(textureTarget, GL_TEXTURE_SWIZZLE_B, GL_RED);
+            renderDevice.glTexParameteriProc(textureTarget, GL_TEXTURE_SWIZZLE_A, (pixelFormat == GL_RG) ? GL_GREEN : GL_ONE);
+
+            if (const auto error = renderDevice.glGetErrorProc(); error != GL_NO_ERROR)
+                throw std::system_error{makeErrorCode(error), "Failed to set texture swizzle"};
+        }
     }
 }
 
@@ -4,6 +4,7 @@
 #define OUZEL_GRAPHICS_OGLTEXTURE_HPP
 
 #include <array>
+#include <cstddef>
 #include <utility>
 
 #include "../../core/Setup.h"
@@ -28,6 +29,7 @@
 #include "../SamplerAddressMode.hpp"
 #include "../SamplerFilter.hpp"
 #include "../TextureType.hpp"
+#include "../../math/Rect.hpp"
 #include "../../math/Size.hpp"
 
 namespace ouzel::graphics::opengl
@@ -52,6 +54,15 @@ namespace ouzel::graphics::opengl
 
         void setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>,
                      std::vector<std::uint8_t>>>& newLevels);
+
+        // updates a rectangle of each level, the copy kept for reloading is updated too
+        void setRegion(const std::vector<std::pair<math::Rect<std::uint32_t>,
+                       std::vector<std::uint8_t>>>& newLevels);
+
+        void beginUpload(std::vector<std::pair<math::Size<std::uint32_t, 2>,
+                         std::vector<std::uint8_t>>> newLevels);
+        std::size_t uploadPending(std::size_t budget);
+        auto isUploadPending() const noexcept { return uploadLevel < levels.size(); }
         void setFilter(SamplerFilter newFilter);
         void setAddressX(SamplerAddressMode newAddressX);
         void setAddressY(SamplerAddressMode newAddressY);
@@ -78,6 +89,7 @@ namespace ouzel::graphics::opengl
     private:
         void createTexture();
         void setTextureParameters();
+        void uploadLevels();
 
         std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
         Flags flags = Flags::none;
@@ -98,6 +110,10 @@ namespace ouzel::graphics::opengl
         GLenum internalPixelFormat = GL_NONE;
         GLenum pixelFormat = GL_NONE;
         GLenum pixelType = GL_NONE;
+        std::uint32_t blockSize = 0; // non-zero for block compressed formats
+
+        std::size_t uploadLevel = 0;
+        GLsizei uploadRow = 0;
     };
 }
 #endif
@@ -5,6 +5,7 @@
 #if defined(__ANDROID__) && OUZEL_COMPILE_OPENGL
 
 #include <algorithm>
+#include <limits>
 #include "OGLRenderDeviceAndroid.hpp"
 #include "../EGLErrorCategory.hpp"
 #include "../../../core/Engine.hpp"
@@ -311,6 +312,10 @@ namespace ouzel::graphics::opengl::android
         frameBufferHeight = surfaceHeight;
 
         stateCache = StateCache();
+        pixelUnpackBufferId = 0;
+        frameFences.clear(); // the sync objects and buffers were destroyed with the old context
+        pixelReadbacks.clear();
+        freeReadbackBuffers.clear();
 
         glDisableProc(GL_DITHER);
         glDepthFuncProc(GL_LEQUAL);
@@ -320,6 +325,9 @@ namespace ouzel::graphics::opengl::android
 
         if (glGenVertexArraysProc) glGenVertexArraysProc(1, &vertexArrayId);
 
+        // the new context has no objects yet, so deleting the names of the old context is harmless
+        resources.collect(std::numeric_limits<std::uint64_t>::max(), [this](ResourceId id) { releaseResourceId(id); });
+
         for (const auto& resource : resources)
             if (resource) resource->invalidate();
 
@@ -5,6 +5,7 @@
 #if defined(__EMSCRIPTEN__) && OUZEL_COMPILE_OPENGL
 
 #include <array>
+#include <limits>
 #include <utility>
 #include "OGLRenderDeviceEm.hpp"
 #include "../../../core/Window.hpp"
@@ -91,6 +92,9 @@ namespace ouzel::graphics::opengl::emscripten
 
     void RenderDevice::handleContextLost()
     {
+        // the retired resources can't be used anymore, so they are destroyed without waiting for the frames
+        resources.collect(std::numeric_limits<std::uint64_t>::max(), [this](ResourceId id) { releaseResourceId(id); });
+
         for (const auto& resource : resources)
             if (resource) resource->invalidate();
     }
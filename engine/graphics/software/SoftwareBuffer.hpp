@@ -0,0 +1,51 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SOFTWAREBUFFER_HPP
+#define OUZEL_GRAPHICS_SOFTWAREBUFFER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "SoftwareRenderResource.hpp"
+#include "../BufferType.hpp"
+#include "../Flags.hpp"
+
+namespace ouzel::graphics::software
+{
+    class Buffer final: public RenderResource
+    {
+    public:
+        Buffer(RenderDevice& initRenderDevice,
+               BufferType initType,
+               Flags initFlags,
+               const std::vector<std::uint8_t>& initData,
+               std::uint32_t initSize):
+            RenderResource{initRenderDevice},
+            type{initType},
+            flags{initFlags},
+            data(initData)
+        {
+            if (data.size() < initSize) data.resize(initSize);
+        }
+
+        void setData(const std::vector<std::uint8_t>& newData)
+        {
+            if ((flags & Flags::dynamic) != Flags::dynamic)
+                throw std::runtime_error{"Buffer is not dynamic"};
+
+            if (newData.size() > data.size()) data.resize(newData.size());
+            std::copy(newData.begin(), newData.end(), data.begin());
+        }
+
+        auto getType() const noexcept { return type; }
+        auto& getData() const noexcept { return data; }
+
+    private:
+        BufferType type;
+        Flags flags = Flags::none;
+        std::vector<std::uint8_t> data;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SOFTWAREBUFFER_HPP
@@ -0,0 +1,975 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+#include "SoftwareRasterizer.hpp"
+
+namespace ouzel::graphics::software
+{
+    namespace
+    {
+        constexpr std::int64_t subpixelSteps = 256; // sub-pixel precision of the triangle edges
+        constexpr float guardBand = 4.0F; // triangles are only clipped when they exceed four viewports
+        constexpr std::size_t clipPlaneCount = 7;
+        constexpr std::size_t maxClipVertices = 3 + clipPlaneCount;
+
+        // RGBA pixel operations, one pixel per vector
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+        using Float4 = __m128;
+
+        inline Float4 load4(const float* values) noexcept { return _mm_loadu_ps(values); }
+        inline Float4 splat4(float value) noexcept { return _mm_set1_ps(value); }
+        inline Float4 add4(Float4 a, Float4 b) noexcept { return _mm_add_ps(a, b); }
+        inline Float4 sub4(Float4 a, Float4 b) noexcept { return _mm_sub_ps(a, b); }
+        inline Float4 mul4(Float4 a, Float4 b) noexcept { return _mm_mul_ps(a, b); }
+        inline Float4 min4(Float4 a, Float4 b) noexcept { return _mm_min_ps(a, b); }
+        inline Float4 max4(Float4 a, Float4 b) noexcept { return _mm_max_ps(a, b); }
+        inline Float4 splatAlpha4(Float4 a) noexcept { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)); }
+        inline void store4(float* values, Float4 a) noexcept { _mm_storeu_ps(values, a); }
+
+        inline Float4 unpackColor(const std::uint8_t* pixel) noexcept
+        {
+            std::int32_t value;
+            std::memcpy(&value, pixel, sizeof(value));
+            const auto zero = _mm_setzero_si128();
+            auto result = _mm_cvtsi32_si128(value);
+            result = _mm_unpacklo_epi8(result, zero);
+            result = _mm_unpacklo_epi16(result, zero);
+            return _mm_mul_ps(_mm_cvtepi32_ps(result), _mm_set1_ps(1.0F / 255.0F));
+        }
+
+        inline void packColor(std::uint8_t* pixel, Float4 color) noexcept
+        {
+            color = _mm_min_ps(_mm_max_ps(color, _mm_setzero_ps()), _mm_set1_ps(1.0F));
+            color = _mm_add_ps(_mm_mul_ps(color, _mm_set1_ps(255.0F)), _mm_set1_ps(0.5F));
+            auto result = _mm_cvttps_epi32(color);
+            result = _mm_packs_epi32(result, result);
+            result = _mm_packus_epi16(result, result);
+            const std::int32_t value = _mm_cvtsi128_si32(result);
+            std::memcpy(pixel, &value, sizeof(value));
+        }
+#elif defined(__ARM_NEON__)
+        using Float4 = float32x4_t;
+
+        inline Float4 load4(const float* values) noexcept { return vld1q_f32(values); }
+        inline Float4 splat4(float value) noexcept { return vdupq_n_f32(value); }
+        inline Float4 add4(Float4 a, Float4 b) noexcept { return vaddq_f32(a, b); }
+        inline Float4 sub4(Float4 a, Float4 b) noexcept { return vsubq_f32(a, b); }
+        inline Float4 mul4(Float4 a, Float4 b) noexcept { return vmulq_f32(a, b); }
+        inline Float4 min4(Float4 a, Float4 b) noexcept { return vminq_f32(a, b); }
+        inline Float4 max4(Float4 a, Float4 b) noexcept { return vmaxq_f32(a, b); }
+        inline Float4 splatAlpha4(Float4 a) noexcept { return vdupq_n_f32(vgetq_lane_f32(a, 3)); }
+        inline void store4(float* values, Float4 a) noexcept { vst1q_f32(values, a); }
+
+        inline Float4 unpackColor(const std::uint8_t* pixel) noexcept
+        {
+            std::uint32_t value;
+            std::memcpy(&value, pixel, sizeof(value));
+            const auto bytes = vreinterpret_u8_u32(vdup_n_u32(value));
+            const auto words = vget_low_u16(vmovl_u8(bytes));
+            return vmulq_f32(vcvtq_f32_u32(vmovl_u16(words)), vdupq_n_f32(1.0F / 255.0F));
+        }
+
+        inline void packColor(std::uint8_t* pixel, Float4 color) noexcept
+        {
+            color = vminq_f32(vmaxq_f32(color, vdupq_n_f32(0.0F)), vdupq_n_f32(1.0F));
+            color = vaddq_f32(vmulq_f32(color, vdupq_n_f32(255.0F)), vdupq_n_f32(0.5F));
+            const auto words = vmovn_u32(vcvtq_u32_f32(color));
+            const auto bytes = vmovn_u16(vcombine_u16(words, words));
+            const std::uint32_t value = vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+            std::memcpy(pixel, &value, sizeof(value));
+        }
+#else
+        using Float4 = std::array<float, 4>;
+
+        inline Float4 load4(const float* values) noexcept { return {values[0], values[1], values[2], values[3]}; }
+        inline Float4 splat4(float value) noexcept { return {value, value, value, value}; }
+        inline Float4 add4(const Float4& a, const Float4& b) noexcept { return {a[0] + b[0], a[1] + b[1], a[2] + b[2], a[3] + b[3]}; }
+        inline Float4 sub4(const Float4& a, const Float4& b) noexcept { return {a[0] - b[0], a[1] - b[1], a[2] - b[2], a[3] - b[3]}; }
+        inline Float4 mul4(const Float4& a, const Float4& b) noexcept { return {a[0] * b[0], a[1] * b[1], a[2] * b[2], a[3] * b[3]}; }
+        inline Float4 min4(const Float4& a, const Float4& b) noexcept
+        {
+            return {std::min(a[0], b[0]), std::min(a[1], b[1]), std::min(a[2], b[2]), std::min(a[3], b[3])};
+        }
+        inline Float4 max4(const Float4& a, const Float4& b) noexcept
+        {
+            return {std::max(a[0], b[0]), std::max(a[1], b[1]), std::max(a[2], b[2]), std::max(a[3], b[3])};
+        }
+        inline Float4 splatAlpha4(const Float4& a) noexcept { return {a[3], a[3], a[3], a[3]}; }
+        inline void store4(float* values, const Float4& a) noexcept { std::copy(a.begin(), a.end(), values); }
+
+        inline Float4 unpackColor(const std::uint8_t* pixel) noexcept
+        {
+            return {pixel[0] / 255.0F, pixel[1] / 255.0F, pixel[2] / 255.0F, pixel[3] / 255.0F};
+        }
+
+        inline void packColor(std::uint8_t* pixel, const Float4& color) noexcept
+        {
+            for (std::size_t c = 0; c < 4; ++c)
+                pixel[c] = static_cast<std::uint8_t>(std::clamp(color[c], 0.0F, 1.0F) * 255.0F + 0.5F);
+        }
+#endif
+
+        inline Float4 load4(const std::array<float, 4>& values) noexcept { return load4(values.data()); }
+
+        std::int64_t floorDiv(std::int64_t a, std::int64_t b) noexcept
+        {
+            const auto quotient = a / b;
+            const auto remainder = a % b;
+            return (remainder != 0 && ((remainder < 0) != (b < 0))) ? quotient - 1 : quotient;
+        }
+
+        std::int64_t ceilDiv(std::int64_t a, std::int64_t b) noexcept
+        {
+            return -floorDiv(-a, b);
+        }
+
+        template <class T>
+        bool compare(CompareFunction compareFunction, T a, T b) noexcept
+        {
+            switch (compareFunction)
+            {
+                case CompareFunction::never: return false;
+                case CompareFunction::less: return a < b;
+                case CompareFunction::equal: return a == b;
+                case CompareFunction::lessEqual: return a <= b;
+                case CompareFunction::greater: return a > b;
+                case CompareFunction::notEqual: return a != b;
+                case CompareFunction::greaterEqual: return a >= b;
+                case CompareFunction::always:
+                default: return true;
+            }
+        }
+
+        std::uint8_t applyStencilOperation(StencilOperation stencilOperation,
+                                           std::uint8_t value,
+                                           std::uint8_t reference) noexcept
+        {
+            switch (stencilOperation)
+            {
+                case StencilOperation::zero: return 0;
+                case StencilOperation::replace: return reference;
+                case StencilOperation::incrementClamp: return value < 255 ? static_cast<std::uint8_t>(value + 1) : value;
+                case StencilOperation::decrementClamp: return value > 0 ? static_cast<std::uint8_t>(value - 1) : value;
+                case StencilOperation::invert: return static_cast<std::uint8_t>(~value);
+                case StencilOperation::incrementWrap: return static_cast<std::uint8_t>(value + 1);
+                case StencilOperation::decrementWrap: return static_cast<std::uint8_t>(value - 1);
+                case StencilOperation::keep:
+                default: return value;
+            }
+        }
+
+        Float4 getBlendFactor(BlendFactor blendFactor, Float4 source, Float4 destination) noexcept
+        {
+            // the blend factor constant is not exposed by the command set, so it is always zero
+            switch (blendFactor)
+            {
+                case BlendFactor::zero: return splat4(0.0F);
+                case BlendFactor::srcColor: return source;
+                case BlendFactor::invSrcColor: return sub4(splat4(1.0F), source);
+                case BlendFactor::srcAlpha: return splatAlpha4(source);
+                case BlendFactor::invSrcAlpha: return sub4(splat4(1.0F), splatAlpha4(source));
+                case BlendFactor::destAlpha: return splatAlpha4(destination);
+                case BlendFactor::invDestAlpha: return sub4(splat4(1.0F), splatAlpha4(destination));
+                case BlendFactor::destColor: return destination;
+                case BlendFactor::invDestColor: return sub4(splat4(1.0F), destination);
+                case BlendFactor::srcAlphaSat:
+                {
+                    const float one[4] = {1.0F, 1.0F, 1.0F, 1.0F};
+                    alignas(16) float factor[4];
+                    store4(factor, min4(splatAlpha4(source), sub4(load4(one), splatAlpha4(destination))));
+                    factor[3] = 1.0F;
+                    return load4(factor);
+                }
+                case BlendFactor::blendFactor: return splat4(0.0F);
+                case BlendFactor::invBlendFactor: return splat4(1.0F);
+                case BlendFactor::one:
+                default: return splat4(1.0F);
+            }
+        }
+
+        Float4 applyBlendOperation(BlendOperation blendOperation,
+                                   Float4 source, Float4 sourceFactor,
+                                   Float4 destination, Float4 destinationFactor) noexcept
+        {
+            switch (blendOperation)
+            {
+                case BlendOperation::subtract: return sub4(mul4(source, sourceFactor), mul4(destination, destinationFactor));
+                case BlendOperation::reverseSubtract: return sub4(mul4(destination, destinationFactor), mul4(source, sourceFactor));
+                case BlendOperation::min: return min4(source, destination);
+                case BlendOperation::max: return max4(source, destination);
+                case BlendOperation::add:
+                default: return add4(mul4(source, sourceFactor), mul4(destination, destinationFactor));
+            }
+        }
+
+        // per-primitive copy of the state that the pixel loop needs
+        struct PixelPipeline final
+        {
+            PixelPipeline(const Rasterizer::State& state, const Rasterizer::Target& target, bool frontFacing) noexcept:
+                color{target.color},
+                depth{target.depth},
+                stencil{target.stencil},
+                width{target.width},
+                texture{state.shaderType == Shader::Type::color ? nullptr : state.texture},
+                textured{state.shaderType != Shader::Type::color},
+                constantColor{load4(state.color)}
+            {
+                if (const auto blendState = state.blendState)
+                {
+                    blending = blendState->isBlendEnabled();
+                    colorBlendSource = blendState->getColorBlendSource();
+                    colorBlendDest = blendState->getColorBlendDest();
+                    colorOperation = blendState->getColorOperation();
+                    alphaBlendSource = blendState->getAlphaBlendSource();
+                    alphaBlendDest = blendState->getAlphaBlendDest();
+                    alphaOperation = blendState->getAlphaOperation();
+
+                    const auto colorMask = blendState->getColorMask();
+                    const float mask[4] = {
+                        (colorMask & ColorMask::red) == ColorMask::red ? 1.0F : 0.0F,
+                        (colorMask & ColorMask::green) == ColorMask::green ? 1.0F : 0.0F,
+                        (colorMask & ColorMask::blue) == ColorMask::blue ? 1.0F : 0.0F,
+                        (colorMask & ColorMask::alpha) == ColorMask::alpha ? 1.0F : 0.0F
+                    };
+                    writeMask = load4(mask);
+                    fullWriteMask = colorMask == ColorMask::all;
+                    if (colorMask == ColorMask::none) color = nullptr;
+                }
+
+                if (const auto depthStencilState = state.depthStencilState)
+                {
+                    depthTest = depthStencilState->getDepthTest() && depth;
+                    depthWrite = depthStencilState->getDepthWrite() && depth;
+                    depthFunction = depthStencilState->getCompareFunction();
+
+                    stencilTest = depthStencilState->getStencilTest() && stencil;
+                    stencilReadMask = static_cast<std::uint8_t>(depthStencilState->getStencilReadMask());
+                    stencilWriteMask = static_cast<std::uint8_t>(depthStencilState->getStencilWriteMask());
+                    stencilReference = static_cast<std::uint8_t>(state.stencilReferenceValue);
+                    stencilFace = frontFacing ? depthStencilState->getFrontFace() : depthStencilState->getBackFace();
+                }
+            }
+
+            void writeStencil(std::uint8_t& value, StencilOperation stencilOperation) const noexcept
+            {
+                const auto result = applyStencilOperation(stencilOperation, value, stencilReference);
+                value = static_cast<std::uint8_t>((value & ~stencilWriteMask) | (result & stencilWriteMask));
+            }
+
+            // depth and stencil tests, returns false if the pixel is discarded
+            bool test(std::size_t index, float z) const noexcept
+            {
+                if (stencilTest)
+                {
+                    auto& stencilValue = stencil[index];
+
+                    if (!compare(stencilFace.compareFunction,
+                                 static_cast<std::uint8_t>(stencilReference & stencilReadMask),
+                                 static_cast<std::uint8_t>(stencilValue & stencilReadMask)))
+                    {
+                        writeStencil(stencilValue, stencilFace.failureOperation);
+                        return false;
+                    }
+
+                    if (depthTest && !compare(depthFunction, z, depth[index]))
+                    {
+                        writeStencil(stencilValue, stencilFace.depthFailureOperation);
+                        return false;
+                    }
+
+                    writeStencil(stencilValue, stencilFace.passOperation);
+                }
+                else if (depthTest && !compare(depthFunction, z, depth[index]))
+                    return false;
+
+                if (depthWrite) depth[index] = z;
+
+                return true;
+            }
+
+            void shade(std::size_t index, Float4 vertexColor, float u, float v, float lod) const noexcept
+            {
+                if (!color) return;
+
+                // the built-in shaders: texture * color * color constant and color * color constant
+                auto source = mul4(vertexColor, constantColor);
+                if (textured)
+                    source = mul4(source, texture ? load4(texture->sample(u, v, lod)) : splat4(0.0F));
+
+                const auto pixel = color + index * 4;
+
+                if (!blending && fullWriteMask)
+                {
+                    packColor(pixel, source);
+                    return;
+                }
+
+                const auto destination = unpackColor(pixel);
+                auto result = source;
+
+                if (blending)
+                {
+                    const float colorLanes[4] = {1.0F, 1.0F, 1.0F, 0.0F};
+                    const float alphaLanes[4] = {0.0F, 0.0F, 0.0F, 1.0F};
+                    const auto colorMask = load4(colorLanes);
+                    const auto alphaMask = load4(alphaLanes);
+
+                    const auto sourceFactor = add4(mul4(getBlendFactor(colorBlendSource, source, destination), colorMask),
+                                                   mul4(getBlendFactor(alphaBlendSource, source, destination), alphaMask));
+                    const auto destinationFactor = add4(mul4(getBlendFactor(colorBlendDest, source, destination), colorMask),
+                                                        mul4(getBlendFactor(alphaBlendDest, source, destination), alphaMask));
+
+                    result = add4(mul4(applyBlendOperation(colorOperation, source, sourceFactor, destination, destinationFactor), colorMask),
+                                  mul4(applyBlendOperation(alphaOperation, source, sourceFactor, destination, destinationFactor), alphaMask));
+                }
+
+                if (!fullWriteMask)
+                    result = add4(mul4(result, writeMask), mul4(destination, sub4(splat4(1.0F), writeMask)));
+
+                packColor(pixel, result);
+            }
+
+            std::uint8_t* color;
+            float* depth;
+            std::uint8_t* stencil;
+            std::uint32_t width;
+
+            const Texture* texture;
+            bool textured;
+            Float4 constantColor;
+
+            bool blending = false;
+            BlendFactor colorBlendSource = BlendFactor::one;
+            BlendFactor colorBlendDest = BlendFactor::zero;
+            BlendOperation colorOperation = BlendOperation::add;
+            BlendFactor alphaBlendSource = BlendFactor::one;
+            BlendFactor alphaBlendDest = BlendFactor::zero;
+            BlendOperation alphaOperation = BlendOperation::add;
+            Float4 writeMask = splat4(1.0F);
+            bool fullWriteMask = true;
+
+            bool depthTest = false;
+            bool depthWrite = false;
+            CompareFunction depthFunction = CompareFunction::less;
+            bool stencilTest = false;
+            std::uint8_t stencilReadMask = 0xFF;
+            std::uint8_t stencilWriteMask = 0xFF;
+            std::uint8_t stencilReference = 0;
+            DepthStencilState::StencilFace stencilFace;
+        };
+
+        float getClipDistance(const Rasterizer::Vertex& vertex, std::size_t plane) noexcept
+        {
+            const auto& p = vertex.position;
+            switch (plane)
+            {
+                case 0: return p[2]; // near, z >= 0
+                case 1: return p[3] - p[2]; // far, z <= w
+                case 2: return p[3] - 1e-5F; // w > 0
+                case 3: return guardBand * p[3] + p[0];
+                case 4: return guardBand * p[3] - p[0];
+                case 5: return guardBand * p[3] + p[1];
+                case 6: return guardBand * p[3] - p[1];
+                default: return 0.0F;
+            }
+        }
+
+        Rasterizer::Vertex lerp(const Rasterizer::Vertex& a, const Rasterizer::Vertex& b, float t) noexcept
+        {
+            Rasterizer::Vertex result;
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                result.position[i] = a.position[i] + (b.position[i] - a.position[i]) * t;
+                result.color[i] = a.color[i] + (b.color[i] - a.color[i]) * t;
+            }
+            for (std::size_t i = 0; i < 2; ++i)
+                result.texCoord[i] = a.texCoord[i] + (b.texCoord[i] - a.texCoord[i]) * t;
+            return result;
+        }
+
+        // Sutherland-Hodgman clipping of a convex polygon, returns the new vertex count
+        std::size_t clipPolygon(std::array<Rasterizer::Vertex, maxClipVertices>& polygon, std::size_t count)
+        {
+            std::array<Rasterizer::Vertex, maxClipVertices> result;
+
+            for (std::size_t plane = 0; plane < clipPlaneCount && count > 0; ++plane)
+            {
+                std::size_t resultCount = 0;
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const auto& current = polygon[i];
+                    const auto& next = polygon[(i + 1) % count];
+                    const auto currentDistance = getClipDistance(current, plane);
+                    const auto nextDistance = getClipDistance(next, plane);
+
+                    if (currentDistance >= 0.0F)
+                        result[resultCount++] = current;
+
+                    if ((currentDistance >= 0.0F) != (nextDistance >= 0.0F) && resultCount < maxClipVertices)
+                        result[resultCount++] = lerp(current, next, currentDistance / (currentDistance - nextDistance));
+                }
+
+                polygon = result;
+                count = resultCount;
+            }
+
+            return count;
+        }
+    }
+
+    Rasterizer::Rasterizer()
+    {
+#ifndef __EMSCRIPTEN__
+        // the thread that flushes the rasterizer works on the tiles too
+        const std::size_t cpuCount = std::thread::hardware_concurrency();
+        for (std::size_t i = 1; i < cpuCount; ++i)
+            workers.emplace_back(&Rasterizer::workerMain, this);
+#endif
+    }
+
+    Rasterizer::~Rasterizer()
+    {
+        std::unique_lock lock{jobMutex};
+        running = false;
+        lock.unlock();
+        jobCondition.notify_all();
+
+        for (auto& worker : workers)
+            if (worker.isJoinable()) worker.join();
+    }
+
+    void Rasterizer::setTarget(const Target& newTarget)
+    {
+        flush();
+
+        target = newTarget;
+        tileCountX = static_cast<std::int32_t>((target.width + tileSize - 1) / tileSize);
+        tileCountY = static_cast<std::int32_t>((target.height + tileSize - 1) / tileSize);
+        tilePrimitives.resize(static_cast<std::size_t>(tileCountX) * static_cast<std::size_t>(tileCountY));
+    }
+
+    void Rasterizer::setState(const State& newState)
+    {
+        currentState = newState;
+        stateChanged = true;
+    }
+
+    std::size_t Rasterizer::getStateIndex()
+    {
+        if (stateChanged || states.empty())
+        {
+            states.push_back(currentState);
+            stateChanged = false;
+        }
+
+        return states.size() - 1;
+    }
+
+    Rasterizer::ScreenVertex Rasterizer::toScreen(const Vertex& vertex) const noexcept
+    {
+        // Direct3D viewport transform, y points down and depth is in the range [0, 1]
+        const auto& viewport = currentState.viewport;
+        const auto invW = 1.0F / vertex.position[3];
+
+        ScreenVertex result;
+        result.x = viewport.position.v[0] + (vertex.position[0] * invW + 1.0F) * 0.5F * viewport.size.v[0];
+        result.y = viewport.position.v[1] + (1.0F - vertex.position[1] * invW) * 0.5F * viewport.size.v[1];
+        result.z = std::clamp(vertex.position[2] * invW, 0.0F, 1.0F);
+        result.invW = invW;
+        for (std::size_t i = 0; i < 4; ++i)
+            result.color[i] = vertex.color[i] * invW;
+        for (std::size_t i = 0; i < 2; ++i)
+            result.texCoord[i] = vertex.texCoord[i] * invW;
+        return result;
+    }
+
+    void Rasterizer::drawTriangle(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2)
+    {
+        if (!target.width || !target.height) return;
+
+        std::array<Vertex, maxClipVertices> polygon;
+        polygon[0] = vertex0;
+        polygon[1] = vertex1;
+        polygon[2] = vertex2;
+        std::size_t count = 3;
+
+        // only triangles that cross a clip plane are clipped
+        bool inside = true;
+        for (std::size_t plane = 0; plane < clipPlaneCount; ++plane)
+        {
+            const auto distance0 = getClipDistance(vertex0, plane);
+            const auto distance1 = getClipDistance(vertex1, plane);
+            const auto distance2 = getClipDistance(vertex2, plane);
+
+            if (distance0 < 0.0F && distance1 < 0.0F && distance2 < 0.0F) return;
+            if (distance0 < 0.0F || distance1 < 0.0F || distance2 < 0.0F) inside = false;
+        }
+
+        if (!inside)
+        {
+            count = clipPolygon(polygon, count);
+            if (count < 3) return;
+        }
+
+        std::array<ScreenVertex, maxClipVertices> screenVertices;
+        for (std::size_t i = 0; i < count; ++i)
+            screenVertices[i] = toScreen(polygon[i]);
+
+        if (currentState.fillMode == FillMode::wireframe)
+        {
+            // the clipped polygon is planar, so its signed area decides the facing of all of its edges
+            float area = 0.0F;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto& current = screenVertices[i];
+                const auto& next = screenVertices[(i + 1) % count];
+                area += current.x * next.y - next.x * current.y;
+            }
+
+            const bool frontFacing = area > 0.0F;
+            if ((currentState.cullMode == CullMode::back && !frontFacing) ||
+                (currentState.cullMode == CullMode::front && frontFacing))
+                return;
+
+            for (std::size_t i = 0; i < count; ++i)
+                setupLine(screenVertices[i], screenVertices[(i + 1) % count], frontFacing);
+        }
+        else
+        {
+            for (std::size_t i = 1; i + 1 < count; ++i)
+                setupTriangle(screenVertices[0], screenVertices[i], screenVertices[i + 1]);
+        }
+    }
+
+    void Rasterizer::drawLine(const Vertex& vertex0, const Vertex& vertex1)
+    {
+        if (!target.width || !target.height) return;
+
+        auto start = vertex0;
+        auto end = vertex1;
+
+        for (std::size_t plane = 0; plane < clipPlaneCount; ++plane)
+        {
+            const auto startDistance = getClipDistance(start, plane);
+            const auto endDistance = getClipDistance(end, plane);
+
+            if (startDistance < 0.0F && endDistance < 0.0F) return;
+
+            if (startDistance < 0.0F)
+                start = lerp(start, end, startDistance / (startDistance - endDistance));
+            else if (endDistance < 0.0F)
+                end = lerp(start, end, startDistance / (startDistance - endDistance));
+        }
+
+        setupLine(toScreen(start), toScreen(end), true);
+    }
+
+    void Rasterizer::drawPoint(const Vertex& vertex)
+    {
+        if (!target.width || !target.height) return;
+
+        for (std::size_t plane = 0; plane < clipPlaneCount; ++plane)
+            if (getClipDistance(vertex, plane) < 0.0F) return;
+
+        Primitive primitive;
+        primitive.type = Primitive::Type::point;
+        primitive.frontFacing = true;
+        primitive.lod = 0.0F;
+        primitive.vertices[0] = toScreen(vertex);
+        primitive.minX = primitive.maxX = static_cast<std::int32_t>(std::floor(primitive.vertices[0].x));
+        primitive.minY = primitive.maxY = static_cast<std::int32_t>(std::floor(primitive.vertices[0].y));
+        binPrimitive(std::move(primitive));
+    }
+
+    void Rasterizer::setupTriangle(const ScreenVertex& vertex0, const ScreenVertex& vertex1, const ScreenVertex& vertex2)
+    {
+        Primitive primitive;
+        primitive.type = Primitive::Type::triangle;
+        primitive.vertices = {vertex0, vertex1, vertex2};
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            primitive.fixedX[i] = std::llround(primitive.vertices[i].x * static_cast<float>(subpixelSteps));
+            primitive.fixedY[i] = std::llround(primitive.vertices[i].y * static_cast<float>(subpixelSteps));
+        }
+
+        const auto area = (primitive.fixedX[1] - primitive.fixedX[0]) * (primitive.fixedY[2] - primitive.fixedY[0]) -
+            (primitive.fixedY[1] - primitive.fixedY[0]) * (primitive.fixedX[2] - primitive.fixedX[0]);
+
+        if (area == 0) return;
+
+        // clockwise triangles on the screen are front facing, like in Direct3D
+        primitive.frontFacing = area > 0;
+        if ((currentState.cullMode == CullMode::back && !primitive.frontFacing) ||
+            (currentState.cullMode == CullMode::front && primitive.frontFacing))
+            return;
+
+        // the edge functions expect clockwise triangles
+        if (!primitive.frontFacing)
+        {
+            std::swap(primitive.vertices[1], primitive.vertices[2]);
+            std::swap(primitive.fixedX[1], primitive.fixedX[2]);
+            std::swap(primitive.fixedY[1], primitive.fixedY[2]);
+        }
+
+        primitive.lod = 0.0F;
+        if (currentState.shaderType != Shader::Type::color && currentState.texture)
+        {
+            // ratio of the texel area to the pixel area of the whole triangle
+            const auto& size = currentState.texture->getSize();
+            std::array<std::array<float, 2>, 3> texCoords;
+            for (std::size_t i = 0; i < 3; ++i)
+                texCoords[i] = {
+                    primitive.vertices[i].texCoord[0] / primitive.vertices[i].invW * static_cast<float>(size.v[0]),
+                    primitive.vertices[i].texCoord[1] / primitive.vertices[i].invW * static_cast<float>(size.v[1])
+                };
+
+            const auto texelArea = std::fabs((texCoords[1][0] - texCoords[0][0]) * (texCoords[2][1] - texCoords[0][1]) -
+                                             (texCoords[2][0] - texCoords[0][0]) * (texCoords[1][1] - texCoords[0][1]));
+            const auto pixelArea = static_cast<float>(std::llabs(area)) / static_cast<float>(subpixelSteps * subpixelSteps);
+
+            if (texelArea > 0.0F) primitive.lod = 0.5F * std::log2(texelArea / pixelArea);
+        }
+
+        primitive.minX = static_cast<std::int32_t>(floorDiv(std::min({primitive.fixedX[0], primitive.fixedX[1], primitive.fixedX[2]}), subpixelSteps));
+        primitive.minY = static_cast<std::int32_t>(floorDiv(std::min({primitive.fixedY[0], primitive.fixedY[1], primitive.fixedY[2]}), subpixelSteps));
+        primitive.maxX = static_cast<std::int32_t>(floorDiv(std::max({primitive.fixedX[0], primitive.fixedX[1], primitive.fixedX[2]}), subpixelSteps));
+        primitive.maxY = static_cast<std::int32_t>(floorDiv(std::max({primitive.fixedY[0], primitive.fixedY[1], primitive.fixedY[2]}), subpixelSteps));
+
+        binPrimitive(std::move(primitive));
+    }
+
+    void Rasterizer::setupLine(const ScreenVertex& vertex0, const ScreenVertex& vertex1, bool frontFacing)
+    {
+        Primitive primitive;
+        primitive.type = Primitive::Type::line;
+        primitive.frontFacing = frontFacing;
+        primitive.lod = 0.0F;
+        primitive.vertices[0] = vertex0;
+        primitive.vertices[1] = vertex1;
+        primitive.minX = static_cast<std::int32_t>(std::floor(std::min(vertex0.x, vertex1.x)));
+        primitive.minY = static_cast<std::int32_t>(std::floor(std::min(vertex0.y, vertex1.y)));
+        primitive.maxX = static_cast<std::int32_t>(std::floor(std::max(vertex0.x, vertex1.x)));
+        primitive.maxY = static_cast<std::int32_t>(std::floor(std::max(vertex0.y, vertex1.y)));
+        binPrimitive(std::move(primitive));
+    }
+
+    void Rasterizer::binPrimitive(Primitive&& primitive)
+    {
+        std::int32_t minX = 0;
+        std::int32_t minY = 0;
+        std::int32_t maxX = static_cast<std::int32_t>(target.width) - 1;
+        std::int32_t maxY = static_cast<std::int32_t>(target.height) - 1;
+
+        if (currentState.scissorTest)
+        {
+            const auto& rectangle = currentState.scissorRectangle;
+            minX = std::max(minX, static_cast<std::int32_t>(rectangle.position.v[0]));
+            minY = std::max(minY, static_cast<std::int32_t>(rectangle.position.v[1]));
+            maxX = std::min(maxX, static_cast<std::int32_t>(rectangle.position.v[0] + rectangle.size.v[0]) - 1);
+            maxY = std::min(maxY, static_cast<std::int32_t>(rectangle.position.v[1] + rectangle.size.v[1]) - 1);
+        }
+
+        primitive.minX = std::max(primitive.minX, minX);
+        primitive.minY = std::max(primitive.minY, minY);
+        primitive.maxX = std::min(primitive.maxX, maxX);
+        primitive.maxY = std::min(primitive.maxY, maxY);
+
+        if (primitive.minX > primitive.maxX || primitive.minY > primitive.maxY) return;
+
+        primitive.state = getStateIndex();
+
+        const auto primitiveIndex = static_cast<std::uint32_t>(primitives.size());
+        primitives.push_back(std::move(primitive));
+        const auto& binnedPrimitive = primitives.back();
+
+        for (auto tileY = binnedPrimitive.minY / tileSize; tileY <= binnedPrimitive.maxY / tileSize; ++tileY)
+            for (auto tileX = binnedPrimitive.minX / tileSize; tileX <= binnedPrimitive.maxX / tileSize; ++tileX)
+            {
+                const auto tile = static_cast<std::size_t>(tileY * tileCountX + tileX);
+                if (tilePrimitives[tile].empty()) activeTiles.push_back(tile);
+                tilePrimitives[tile].push_back(primitiveIndex);
+            }
+    }
+
+    void Rasterizer::clear(bool clearColor, bool clearDepth, bool clearStencil,
+                           const std::array<float, 4>& color, float depth, std::uint8_t stencil)
+    {
+        flush();
+
+        const auto pixelCount = static_cast<std::size_t>(target.width) * target.height;
+
+        if (clearColor && target.color)
+        {
+            std::uint8_t pixel[4];
+            packColor(pixel, load4(color));
+            for (std::size_t i = 0; i < pixelCount; ++i)
+                std::memcpy(target.color + i * 4, pixel, sizeof(pixel));
+        }
+
+        if (clearDepth && target.depth)
+            std::fill(target.depth, target.depth + pixelCount, depth);
+
+        if (clearStencil && target.stencil)
+            std::fill(target.stencil, target.stencil + pixelCount, stencil);
+    }
+
+    void Rasterizer::flush()
+    {
+        if (!activeTiles.empty())
+        {
+            nextTile = 0;
+
+            if (!workers.empty())
+            {
+                std::unique_lock lock{jobMutex};
+                activeWorkers = workers.size();
+                ++jobGeneration;
+                lock.unlock();
+                jobCondition.notify_all();
+            }
+
+            processTiles();
+
+            if (!workers.empty())
+            {
+                std::unique_lock lock{jobMutex};
+                jobFinishedCondition.wait(lock, [this]() noexcept { return activeWorkers == 0; });
+            }
+
+            for (const auto tile : activeTiles)
+                tilePrimitives[tile].clear();
+            activeTiles.clear();
+        }
+
+        primitives.clear();
+        states.clear();
+        stateChanged = true;
+    }
+
+    void Rasterizer::processTiles()
+    {
+        for (;;)
+        {
+            const auto index = nextTile++;
+            if (index >= activeTiles.size()) break;
+            rasterizeTile(activeTiles[index]);
+        }
+    }
+
+    void Rasterizer::rasterizeTile(std::size_t tile)
+    {
+        const auto tileX = static_cast<std::int32_t>(tile % static_cast<std::size_t>(tileCountX)) * tileSize;
+        const auto tileY = static_cast<std::int32_t>(tile / static_cast<std::size_t>(tileCountX)) * tileSize;
+
+        // primitives are rasterized in the order they were submitted, so blending stays correct
+        for (const auto primitiveIndex : tilePrimitives[tile])
+        {
+            const auto& primitive = primitives[primitiveIndex];
+
+            const auto x0 = std::max(primitive.minX, tileX);
+            const auto y0 = std::max(primitive.minY, tileY);
+            const auto x1 = std::min(primitive.maxX, tileX + tileSize - 1);
+            const auto y1 = std::min(primitive.maxY, tileY + tileSize - 1);
+            if (x0 > x1 || y0 > y1) continue;
+
+            switch (primitive.type)
+            {
+                case Primitive::Type::triangle: rasterizeTriangle(primitive, x0, y0, x1, y1); break;
+                case Primitive::Type::line: rasterizeLine(primitive, x0, y0, x1, y1); break;
+                case Primitive::Type::point: rasterizePoint(primitive, x0, y0, x1, y1); break;
+            }
+        }
+    }
+
+    void Rasterizer::rasterizeTriangle(const Primitive& primitive,
+                                       std::int32_t x0, std::int32_t y0,
+                                       std::int32_t x1, std::int32_t y1) const
+    {
+        const PixelPipeline pipeline{states[primitive.state], target, primitive.frontFacing};
+        const auto& v = primitive.vertices;
+
+        // edge functions with the top-left fill rule
+        struct Edge final
+        {
+            std::int64_t x;
+            std::int64_t y;
+            std::int64_t dx;
+            std::int64_t dy;
+            std::int64_t bias;
+        };
+
+        std::array<Edge, 3> edges;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            const auto next = (i + 1) % 3;
+            auto& edge = edges[i];
+            edge.x = primitive.fixedX[i];
+            edge.y = primitive.fixedY[i];
+            edge.dx = primitive.fixedX[next] - primitive.fixedX[i];
+            edge.dy = primitive.fixedY[next] - primitive.fixedY[i];
+            edge.bias = (edge.dy < 0 || (edge.dy == 0 && edge.dx > 0)) ? 0 : -1;
+        }
+
+        // attribute planes, z, 1/w and texture coordinates in one vector and the color in another
+        const auto fx0 = static_cast<float>(primitive.fixedX[0]) / static_cast<float>(subpixelSteps);
+        const auto fy0 = static_cast<float>(primitive.fixedY[0]) / static_cast<float>(subpixelSteps);
+        const auto fx1 = static_cast<float>(primitive.fixedX[1]) / static_cast<float>(subpixelSteps) - fx0;
+        const auto fy1 = static_cast<float>(primitive.fixedY[1]) / static_cast<float>(subpixelSteps) - fy0;
+        const auto fx2 = static_cast<float>(primitive.fixedX[2]) / static_cast<float>(subpixelSteps) - fx0;
+        const auto fy2 = static_cast<float>(primitive.fixedY[2]) / static_cast<float>(subpixelSteps) - fy0;
+        const auto invArea = 1.0F / (fx1 * fy2 - fx2 * fy1);
+
+        const float attributes0[4] = {v[0].z, v[0].invW, v[0].texCoord[0], v[0].texCoord[1]};
+        const float attributes1[4] = {v[1].z, v[1].invW, v[1].texCoord[0], v[1].texCoord[1]};
+        const float attributes2[4] = {v[2].z, v[2].invW, v[2].texCoord[0], v[2].texCoord[1]};
+
+        const auto a0 = load4(attributes0);
+        const auto a1 = sub4(load4(attributes1), a0);
+        const auto a2 = sub4(load4(attributes2), a0);
+        const auto attributeDx = mul4(sub4(mul4(a1, splat4(fy2)), mul4(a2, splat4(fy1))), splat4(invArea));
+        const auto attributeDy = mul4(sub4(mul4(a2, splat4(fx1)), mul4(a1, splat4(fx2))), splat4(invArea));
+
+        const auto c0 = load4(v[0].color);
+        const auto c1 = sub4(load4(v[1].color), c0);
+        const auto c2 = sub4(load4(v[2].color), c0);
+        const auto colorDx = mul4(sub4(mul4(c1, splat4(fy2)), mul4(c2, splat4(fy1))), splat4(invArea));
+        const auto colorDy = mul4(sub4(mul4(c2, splat4(fx1)), mul4(c1, splat4(fx2))), splat4(invArea));
+
+        for (auto y = y0; y <= y1; ++y)
+        {
+            // exact span of the row from the edge functions at the pixel centers
+            const auto pixelY = static_cast<std::int64_t>(y) * subpixelSteps + subpixelSteps / 2;
+            std::int64_t spanStart = x0;
+            std::int64_t spanEnd = x1;
+
+            for (const auto& edge : edges)
+            {
+                const auto k = edge.dx * (pixelY - edge.y) + edge.dy * edge.x - edge.dy * (subpixelSteps / 2) + edge.bias;
+
+                if (edge.dy == 0)
+                {
+                    if (k < 0) spanEnd = spanStart - 1;
+                }
+                else if (edge.dy > 0)
+                    spanEnd = std::min(spanEnd, floorDiv(k, edge.dy * subpixelSteps));
+                else
+                    spanStart = std::max(spanStart, ceilDiv(k, edge.dy * subpixelSteps));
+            }
+
+            if (spanStart > spanEnd) continue;
+
+            const auto offsetX = static_cast<float>(spanStart) + 0.5F - fx0;
+            const auto offsetY = static_cast<float>(y) + 0.5F - fy0;
+            auto attributes = add4(a0, add4(mul4(attributeDx, splat4(offsetX)), mul4(attributeDy, splat4(offsetY))));
+            auto color = add4(c0, add4(mul4(colorDx, splat4(offsetX)), mul4(colorDy, splat4(offsetY))));
+
+            auto index = static_cast<std::size_t>(y) * target.width + static_cast<std::size_t>(spanStart);
+
+            for (auto x = spanStart; x <= spanEnd; ++x, ++index)
+            {
+                alignas(16) float values[4];
+                store4(values, attributes);
+
+                if (pipeline.test(index, values[0]))
+                {
+                    const auto w = 1.0F / values[1];
+                    pipeline.shade(index, mul4(color, splat4(w)), values[2] * w, values[3] * w, primitive.lod);
+                }
+
+                attributes = add4(attributes, attributeDx);
+                color = add4(color, colorDx);
+            }
+        }
+    }
+
+    void Rasterizer::rasterizeLine(const Primitive& primitive,
+                                   std::int32_t x0, std::int32_t y0,
+                                   std::int32_t x1, std::int32_t y1) const
+    {
+        const PixelPipeline pipeline{states[primitive.state], target, primitive.frontFacing};
+        const auto& start = primitive.vertices[0];
+        const auto& end = primitive.vertices[1];
+
+        const auto dx = end.x - start.x;
+        const auto dy = end.y - start.y;
+        const auto steps = std::max(1, static_cast<std::int32_t>(std::lround(std::max(std::fabs(dx), std::fabs(dy)))));
+
+        const float attributes0[4] = {start.z, start.invW, start.texCoord[0], start.texCoord[1]};
+        const float attributes1[4] = {end.z, end.invW, end.texCoord[0], end.texCoord[1]};
+        const auto a0 = load4(attributes0);
+        const auto attributeDelta = sub4(load4(attributes1), a0);
+        const auto c0 = load4(start.color);
+        const auto colorDelta = sub4(load4(end.color), c0);
+
+        // one pixel per step along the major axis, sampled at the middle of the step
+        for (std::int32_t step = 0; step < steps; ++step)
+        {
+            const auto t = (static_cast<float>(step) + 0.5F) / static_cast<float>(steps);
+            const auto x = static_cast<std::int32_t>(std::floor(start.x + dx * t));
+            const auto y = static_cast<std::int32_t>(std::floor(start.y + dy * t));
+            if (x < x0 || x > x1 || y < y0 || y > y1) continue;
+
+            const auto index = static_cast<std::size_t>(y) * target.width + static_cast<std::size_t>(x);
+
+            alignas(16) float values[4];
+            store4(values, add4(a0, mul4(attributeDelta, splat4(t))));
+
+            if (pipeline.test(index, values[0]))
+            {
+                const auto w = 1.0F / values[1];
+                const auto color = mul4(add4(c0, mul4(colorDelta, splat4(t))), splat4(w));
+                pipeline.shade(index, color, values[2] * w, values[3] * w, primitive.lod);
+            }
+        }
+    }
+
+    void Rasterizer::rasterizePoint(const Primitive& primitive,
+                                    std::int32_t x0, std::int32_t y0,
+                                    std::int32_t, std::int32_t) const
+    {
+        // the bounds of a point are a single pixel, so the tile bounds are the pixel itself
+        const PixelPipeline pipeline{states[primitive.state], target, primitive.frontFacing};
+        const auto& vertex = primitive.vertices[0];
+        const auto index = static_cast<std::size_t>(y0) * target.width + static_cast<std::size_t>(x0);
+
+        if (pipeline.test(index, vertex.z))
+        {
+            const auto w = 1.0F / vertex.invW;
+            pipeline.shade(index, mul4(load4(vertex.color), splat4(w)),
+                           vertex.texCoord[0] * w, vertex.texCoord[1] * w, primitive.lod);
+        }
+    }
+
+    void Rasterizer::workerMain()
+    {
+        std::uint64_t generation = 0;
+
+        for (;;)
+        {
+            std::unique_lock lock{jobMutex};
+            jobCondition.wait(lock, [this, generation]() noexcept { return !running || jobGeneration != generation; });
+            if (!running) break;
+            generation = jobGeneration;
+            lock.unlock();
+
+            processTiles();
+
+            lock.lock();
+            if (--activeWorkers == 0)
+            {
+                lock.unlock();
+                jobFinishedCondition.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,154 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SOFTWARERASTERIZER_HPP
+#define OUZEL_GRAPHICS_SOFTWARERASTERIZER_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "SoftwareBlendState.hpp"
+#include "SoftwareDepthStencilState.hpp"
+#include "SoftwareShader.hpp"
+#include "SoftwareTexture.hpp"
+#include "../RasterizerState.hpp"
+#include "../../math/Rect.hpp"
+#include "../../thread/Thread.hpp"
+
+namespace ouzel::graphics::software
+{
+    // Clips and sets up the primitives on the calling thread, bins them into screen tiles
+    // and rasterizes the tiles on worker threads when the rasterizer is flushed
+    class Rasterizer final
+    {
+    public:
+        static constexpr std::int32_t tileSize = 64;
+
+        struct Target final
+        {
+            std::uint32_t width = 0;
+            std::uint32_t height = 0;
+            std::uint8_t* color = nullptr; // RGBA8, top row first
+            float* depth = nullptr;
+            std::uint8_t* stencil = nullptr;
+        };
+
+        struct State final
+        {
+            const BlendState* blendState = nullptr;
+            const DepthStencilState* depthStencilState = nullptr;
+            std::uint32_t stencilReferenceValue = 0;
+            CullMode cullMode = CullMode::none;
+            FillMode fillMode = FillMode::solid;
+            math::Rect<float> viewport;
+            bool scissorTest = false;
+            math::Rect<float> scissorRectangle;
+            Shader::Type shaderType = Shader::Type::color;
+            const Texture* texture = nullptr;
+            std::array<float, 4> color{1.0F, 1.0F, 1.0F, 1.0F};
+        };
+
+        // output of the vertex shader
+        struct Vertex final
+        {
+            std::array<float, 4> position; // clip space
+            std::array<float, 4> color;
+            std::array<float, 2> texCoord;
+        };
+
+        Rasterizer();
+        ~Rasterizer();
+
+        Rasterizer(const Rasterizer&) = delete;
+        Rasterizer& operator=(const Rasterizer&) = delete;
+
+        Rasterizer(Rasterizer&&) = delete;
+        Rasterizer& operator=(Rasterizer&&) = delete;
+
+        void setTarget(const Target& newTarget);
+        void setState(const State& newState);
+        auto& getState() const noexcept { return currentState; }
+
+        void drawTriangle(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2);
+        void drawLine(const Vertex& vertex0, const Vertex& vertex1);
+        void drawPoint(const Vertex& vertex);
+
+        // clears the whole target, ignoring the scissor test and the write masks
+        void clear(bool clearColor, bool clearDepth, bool clearStencil,
+                   const std::array<float, 4>& color, float depth, std::uint8_t stencil);
+
+        // rasterizes all binned primitives
+        void flush();
+
+    private:
+        struct ScreenVertex final
+        {
+            float x;
+            float y;
+            float z;
+            float invW;
+            std::array<float, 4> color; // divided by w
+            std::array<float, 2> texCoord; // divided by w
+        };
+
+        struct Primitive final
+        {
+            enum class Type
+            {
+                triangle,
+                line,
+                point
+            };
+
+            Type type;
+            std::size_t state;
+            bool frontFacing;
+            float lod; // texture level of detail
+            std::array<ScreenVertex, 3> vertices;
+            std::array<std::int64_t, 3> fixedX; // sub-pixel positions of triangle vertices
+            std::array<std::int64_t, 3> fixedY;
+            std::int32_t minX;
+            std::int32_t minY;
+            std::int32_t maxX;
+            std::int32_t maxY;
+        };
+
+        std::size_t getStateIndex();
+        void setupTriangle(const ScreenVertex& vertex0, const ScreenVertex& vertex1, const ScreenVertex& vertex2);
+        void setupLine(const ScreenVertex& vertex0, const ScreenVertex& vertex1, bool frontFacing);
+        void binPrimitive(Primitive&& primitive);
+        ScreenVertex toScreen(const Vertex& vertex) const noexcept;
+
+        void processTiles();
+        void rasterizeTile(std::size_t tile);
+        void rasterizeTriangle(const Primitive& primitive, std::int32_t x0, std::int32_t y0, std::int32_t x1, std::int32_t y1) const;
+        void rasterizeLine(const Primitive& primitive, std::int32_t x0, std::int32_t y0, std::int32_t x1, std::int32_t y1) const;
+        void rasterizePoint(const Primitive& primitive, std::int32_t x0, std::int32_t y0, std::int32_t x1, std::int32_t y1) const;
+        void workerMain();
+
+        Target target;
+        std::int32_t tileCountX = 0;
+        std::int32_t tileCountY = 0;
+
+        State currentState;
+        bool stateChanged = true;
+        std::deque<State> states;
+        std::vector<Primitive> primitives;
+        std::vector<std::vector<std::uint32_t>> tilePrimitives;
+        std::vector<std::size_t> activeTiles;
+
+        std::vector<thread::Thread> workers;
+        bool running = true;
+        std::uint64_t jobGeneration = 0;
+        std::size_t activeWorkers = 0;
+        std::atomic_size_t nextTile{0};
+        std::mutex jobMutex;
+        std::condition_variable jobCondition;
+        std::condition_variable jobFinishedCondition;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SOFTWARERASTERIZER_HPP
@@ -0,0 +1,678 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstring>
+#include <stdexcept>
+#include "SoftwareRenderDevice.hpp"
+#include "SoftwareBlendState.hpp"
+#include "SoftwareBuffer.hpp"
+#include "SoftwareDepthStencilState.hpp"
+#include "SoftwareRenderTarget.hpp"
+#include "SoftwareShader.hpp"
+#include "SoftwareTexture.hpp"
+#include "../../core/Window.hpp"
+
+namespace ouzel::graphics::software
+{
+    namespace
+    {
+        // the same layout as the shader constants, so (row, column) is at column * 4 + row
+        std::array<float, 4> transformPosition(const float* matrix, const std::array<float, 4>& position) noexcept
+        {
+            std::array<float, 4> result;
+            for (std::size_t row = 0; row < 4; ++row)
+                result[row] = matrix[row] * position[0] +
+                    matrix[4 + row] * position[1] +
+                    matrix[8 + row] * position[2] +
+                    matrix[12 + row] * position[3];
+            return result;
+        }
+
+        std::array<float, 16> multiply(const float* a, const float* b) noexcept
+        {
+            std::array<float, 16> result;
+            for (std::size_t column = 0; column < 4; ++column)
+                for (std::size_t row = 0; row < 4; ++row)
+                    result[column * 4 + row] = a[row] * b[column * 4] +
+                        a[4 + row] * b[column * 4 + 1] +
+                        a[8 + row] * b[column * 4 + 2] +
+                        a[12 + row] * b[column * 4 + 3];
+            return result;
+        }
+
+        std::uint32_t readIndex(const std::vector<std::uint8_t>& data, std::size_t index, std::uint32_t indexSize) noexcept
+        {
+            if (indexSize == sizeof(std::uint16_t))
+            {
+                std::uint16_t result;
+                std::memcpy(&result, data.data() + index * sizeof(result), sizeof(result));
+                return result;
+            }
+            else
+            {
+                std::uint32_t result;
+                std::memcpy(&result, data.data() + index * sizeof(result), sizeof(result));
+                return result;
+            }
+        }
+    }
+
+    RenderDevice::RenderDevice(const Settings& settings,
+                               core::Window& initWindow):
+        graphics::RenderDevice{Driver::software, settings, initWindow}
+    {
+        apiVersion = ApiVersion{1, 0};
+
+        // compressed textures are decoded by the engine and multisampling is not supported
+        npotTexturesSupported = true;
+        renderTargetsSupported = true;
+        clampToBorderSupported = true;
+        uintIndicesSupported = true;
+        instancingSupported = true;
+        textureStreamingSupported = true;
+        luminanceTexturesSupported = true;
+
+        resizeFrameBuffer(window.getResolution());
+    }
+
+    RenderDevice::~RenderDevice()
+    {
+        running = false;
+        CommandBuffer commandBuffer;
+        commandBuffer.pushCommand(std::make_unique<PresentCommand>());
+        submitCommandBuffer(std::move(commandBuffer));
+
+#ifndef __EMSCRIPTEN__
+        if (renderThread.isJoinable()) renderThread.join();
+#endif
+    }
+
+    void RenderDevice::start()
+    {
+        running = true;
+
+#ifndef __EMSCRIPTEN__
+        renderThread = thread::Thread{&RenderDevice::renderMain, this};
+#endif
+    }
+
+    void RenderDevice::process()
+    {
+        graphics::RenderDevice::process();
+        resources.collect(getCompletedFrame(), [this](ResourceId id) { releaseResourceId(id); });
+        executeAll();
+
+        CommandBuffer commandBuffer;
+
+        for (;;)
+        {
+            std::unique_lock lock{commandQueueMutex};
+#ifdef __EMSCRIPTEN__
+            if (commandQueue.empty()) return;
+#else
+            waitForCommands(lock);
+#endif
+            recycleCommandBuffer(std::move(commandBuffer));
+            commandBuffer = std::move(commandQueue.front());
+            commandQueue.pop();
+            lock.unlock();
+
+            while (!commandBuffer.isEmpty())
+            {
+                const auto command = commandBuffer.popCommand();
+                countCommand(*command);
+                const CommandTimer commandTimer{*this, command->type};
+
+                processCommand(*command);
+
+                if (command->type == Command::Type::present)
+                {
+                    recycleCommandBuffer(std::move(commandBuffer));
+                    return;
+                }
+            }
+        }
+    }
+
+    void RenderDevice::processCommand(Command& command)
+    {
+        switch (command.type)
+        {
+            case Command::Type::resize:
+            {
+                const auto& resizeCommand = static_cast<const ResizeCommand&>(command);
+                resizeFrameBuffer(resizeCommand.size);
+                break;
+            }
+
+            case Command::Type::present:
+            {
+                rasterizer.flush();
+                captureFrameImages();
+                break;
+            }
+
+            case Command::Type::deleteResource:
+            {
+                const auto& deleteResourceCommand = static_cast<const DeleteResourceCommand&>(command);
+                releaseResource(deleteResourceCommand.resource);
+                resources.retire(deleteResourceCommand.resource, renderFrame);
+                break;
+            }
+
+            case Command::Type::initRenderTarget:
+            {
+                const auto& initRenderTargetCommand = static_cast<const InitRenderTargetCommand&>(command);
+
+                std::set<Texture*> colorTextures;
+                for (const auto colorTextureId : initRenderTargetCommand.colorTextures)
+                    colorTextures.insert(getResource<Texture>(colorTextureId));
+
+                auto renderTarget = std::make_unique<RenderTarget>(*this,
+                                                                   colorTextures,
+                                                                   getResource<Texture>(initRenderTargetCommand.depthTexture));
+
+                setResource(initRenderTargetCommand.renderTarget, std::move(renderTarget));
+                break;
+            }
+
+            case Command::Type::setRenderTarget:
+            {
+                const auto& setRenderTargetCommand = static_cast<const SetRenderTargetCommand&>(command);
+                setRenderTarget(getResource<RenderTarget>(setRenderTargetCommand.renderTarget));
+                break;
+            }
+
+            case Command::Type::clearRenderTarget:
+            {
+                const auto& clearCommand = static_cast<const ClearRenderTargetCommand&>(command);
+
+                rasterizer.clear(clearCommand.clearColorBuffer,
+                                 clearCommand.clearDepthBuffer,
+                                 clearCommand.clearStencilBuffer,
+                                 clearCommand.clearColor.norm(),
+                                 clearCommand.clearDepth,
+                                 static_cast<std::uint8_t>(clearCommand.clearStencil));
+                break;
+            }
+
+            case Command::Type::discardRenderTarget:
+                // the render targets live in system memory, so there is nothing to skip
+                break;
+
+            case Command::Type::setScissorTest:
+            {
+                const auto& setScissorTestCommand = static_cast<const SetScissorTestCommand&>(command);
+                state.scissorTest = setScissorTestCommand.enabled;
+                state.scissorRectangle = setScissorTestCommand.rectangle;
+                rasterizer.setState(state);
+                break;
+            }
+
+            case Command::Type::setViewport:
+            {
+                const auto& setViewportCommand = static_cast<const SetViewportCommand&>(command);
+                state.viewport = setViewportCommand.viewport;
+                rasterizer.setState(state);
+                break;
+            }
+
+            case Command::Type::initDepthStencilState:
+            {
+                const auto& initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand&>(command);
+                auto depthStencilState = std::make_unique<DepthStencilState>(*this,
+                                                                             initDepthStencilStateCommand.depthTest,
+                                                                             initDepthStencilStateCommand.depthWrite,
+                                                                             initDepthStencilStateCommand.compareFunction,
+                                                                             initDepthStencilStateCommand.stencilEnabled,
+                                                                             initDepthStencilStateCommand.stencilReadMask,
+                                                                             initDepthStencilStateCommand.stencilWriteMask,
+                                                                             DepthStencilState::StencilFace{
+                                                                                 initDepthStencilStateCommand.frontFaceStencilFailureOperation,
+                                                                                 initDepthStencilStateCommand.frontFaceStencilDepthFailureOperation,
+                                                                                 initDepthStencilStateCommand.frontFaceStencilPassOperation,
+                                                                                 initDepthStencilStateCommand.frontFaceStencilCompareFunction
+                                                                             },
+                                                                             DepthStencilState::StencilFace{
+                                                                                 initDepthStencilStateCommand.backFaceStencilFailureOperation,
+                                                                                 initDepthStencilStateCommand.backFaceStencilDepthFailureOperation,
+                                                                                 initDepthStencilStateCommand.backFaceStencilPassOperation,
+                                                                                 initDepthStencilStateCommand.backFaceStencilCompareFunction
+                                                                             });
+
+                setResource(initDepthStencilStateCommand.depthStencilState, std::move(depthStencilState));
+                break;
+            }
+
+            case Command::Type::setDepthStencilState:
+            {
+                const auto& setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand&>(command);
+                state.depthStencilState = getResource<DepthStencilState>(setDepthStencilStateCommand.depthStencilState);
+                state.stencilReferenceValue = setDepthStencilStateCommand.stencilReferenceValue;
+                rasterizer.setState(state);
+                break;
+            }
+
+            case Command::Type::setPipelineState:
+            {
+                const auto& setPipelineStateCommand = static_cast<const SetPipelineStateCommand&>(command);
+                currentShader = getResource<Shader>(setPipelineStateCommand.shader);
+                state.blendState = getResource<BlendState>(setPipelineStateCommand.blendState);
+                state.shaderType = currentShader ? currentShader->getType() : Shader::Type::color;
+                state.cullMode = setPipelineStateCommand.cullMode;
+                state.fillMode = setPipelineStateCommand.fillMode;
+                rasterizer.setState(state);
+                break;
+            }
+
+            case Command::Type::draw:
+            {
+                const auto& drawCommand = static_cast<const DrawCommand&>(command);
+                draw(drawCommand.indexBuffer,
+                     drawCommand.indexCount,
+                     drawCommand.indexSize,
+                     drawCommand.vertexBuffer,
+                     0, 0,
+                     drawCommand.drawMode,
+                     drawCommand.startIndex);
+                break;
+            }
+
+            case Command::Type::drawInstanced:
+            {
+                const auto& drawInstancedCommand = static_cast<const DrawInstancedCommand&>(command);
+                draw(drawInstancedCommand.indexBuffer,
+                     drawInstancedCommand.indexCount,
+                     drawInstancedCommand.indexSize,
+                     drawInstancedCommand.vertexBuffer,
+                     drawInstancedCommand.instanceBuffer,
+                     drawInstancedCommand.instanceCount,
+                     drawInstancedCommand.drawMode,
+                     drawInstancedCommand.startIndex);
+                break;
+            }
+
+            case Command::Type::initBlendState:
+            {
+                const auto& initBlendStateCommand = static_cast<const InitBlendStateCommand&>(command);
+                auto blendState = std::make_unique<BlendState>(*this,
+                                                               initBlendStateCommand.enableBlending,
+                                                               initBlendStateCommand.colorBlendSource,
+                                                               initBlendStateCommand.colorBlendDest,
+                                                               initBlendStateCommand.colorOperation,
+                                                               initBlendStateCommand.alphaBlendSource,
+                                                               initBlendStateCommand.alphaBlendDest,
+                                                               initBlendStateCommand.alphaOperation,
+                                                               initBlendStateCommand.colorMask);
+
+                setResource(initBlendStateCommand.blendState, std::move(blendState));
+                break;
+            }
+
+            case Command::Type::initBuffer:
+            {
+                const auto& initBufferCommand = static_cast<const InitBufferCommand&>(command);
+                auto buffer = std::make_unique<Buffer>(*this,
+                                                       initBufferCommand.bufferType,
+                                                       initBufferCommand.flags,
+                                                       initBufferCommand.data,
+                                                       initBufferCommand.size);
+
+                setResource(initBufferCommand.buffer, std::move(buffer));
+                break;
+            }
+
+            case Command::Type::setBufferData:
+            {
+                // vertices are transformed when they are drawn, so the binned primitives don't refer to buffers
+                const auto& setBufferDataCommand = static_cast<const SetBufferDataCommand&>(command);
+                auto buffer = getResource<Buffer>(setBufferDataCommand.buffer);
+                buffer->setData(setBufferDataCommand.data);
+                break;
+            }
+
+            case Command::Type::initShader:
+            {
+                const auto& initShaderCommand = static_cast<const InitShaderCommand&>(command);
+                auto shader = std::make_unique<Shader>(*this, initShaderCommand.vertexAttributes);
+
+                setResource(initShaderCommand.shader, std::move(shader));
+                break;
+            }
+
+            case Command::Type::setShaderConstants:
+            {
+                const auto& setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand&>(command);
+
+                if (!currentShader)
+                    throw std::runtime_error{"No shader set"};
+
+                // the built-in shaders have a color fragment constant and a matrix vertex constant
+                if (!setShaderConstantsCommand.fragmentShaderConstants.empty())
+                {
+                    const auto& color = setShaderConstantsCommand.fragmentShaderConstants.front();
+                    for (std::size_t i = 0; i < state.color.size(); ++i)
+                        state.color[i] = i < color.size() ? color[i] : 1.0F;
+                    rasterizer.setState(state);
+                }
+
+                if (!setShaderConstantsCommand.vertexShaderConstants.empty())
+                {
+                    const auto& matrix = setShaderConstantsCommand.vertexShaderConstants.front();
+                    if (matrix.size() < vertexShaderConstant.size())
+                        throw std::runtime_error{"Invalid vertex shader constant size"};
+                    std::copy(matrix.begin(), matrix.begin() + vertexShaderConstant.size(), vertexShaderConstant.begin());
+                }
+
+                break;
+            }
+
+            case Command::Type::initTexture:
+            {
+                const auto& initTextureCommand = static_cast<const InitTextureCommand&>(command);
+                auto texture = std::make_unique<Texture>(*this,
+                                                         initTextureCommand.levels,
+                                                         initTextureCommand.textureType,
+                                                         initTextureCommand.flags,
+                                                         initTextureCommand.sampleCount,
+                                                         initTextureCommand.pixelFormat,
+                                                         initTextureCommand.filter,
+                                                         initTextureCommand.maxAnisotropy);
+
+                setResource(initTextureCommand.texture, std::move(texture));
+                break;
+            }
+
+            case Command::Type::setTextureData:
+            {
+                const auto& setTextureDataCommand = static_cast<const SetTextureDataCommand&>(command);
+                rasterizer.flush();
+                auto texture = getResource<Texture>(setTextureDataCommand.texture);
+                texture->setData(setTextureDataCommand.levels);
+                break;
+            }
+
+            case Command::Type::setTextureRegion:
+            {
+                const auto& setTextureRegionCommand = static_cast<const SetTextureRegionCommand&>(command);
+                rasterizer.flush();
+                auto texture = getResource<Texture>(setTextureRegionCommand.texture);
+                texture->setRegion(setTextureRegionCommand.levels);
+                break;
+            }
+
+            case Command::Type::setTextureParameters:
+            {
+                const auto& setTextureParametersCommand = static_cast<const SetTextureParametersCommand&>(command);
+                rasterizer.flush();
+                auto texture = getResource<Texture>(setTextureParametersCommand.texture);
+                texture->setFilter(setTextureParametersCommand.filter);
+                texture->setAddressX(setTextureParametersCommand.addressX);
+                texture->setAddressY(setTextureParametersCommand.addressY);
+                texture->setBorderColor(setTextureParametersCommand.borderColor);
+                texture->setMaxAnisotropy(setTextureParametersCommand.maxAnisotropy);
+                break;
+            }
+
+            case Command::Type::uploadTextureData:
+            {
+                auto& uploadTextureDataCommand = static_cast<UploadTextureDataCommand&>(command);
+                rasterizer.flush();
+                auto texture = getResource<Texture>(uploadTextureDataCommand.texture);
+                texture->upload(uploadTextureDataCommand.levels);
+
+                Event event;
+                event.type = Event::Type::textureReady;
+                event.resource = uploadTextureDataCommand.texture;
+                postEvent(event);
+                break;
+            }
+
+            case Command::Type::setTextures:
+            {
+                // the built-in shaders sample only the first texture
+                const auto& setTexturesCommand = static_cast<const SetTexturesCommand&>(command);
+                state.texture = setTexturesCommand.textures.empty() ?
+                    nullptr : getResource<Texture>(setTexturesCommand.textures.front());
+                rasterizer.setState(state);
+                break;
+            }
+
+            default:
+                throw std::runtime_error{"Invalid command"};
+        }
+    }
+
+    void RenderDevice::releaseResource(ResourceId id)
+    {
+        const auto resource = resources.find(id);
+        if (!resource) return;
+
+        // the binned primitives and the current state must not refer to the released resource
+        rasterizer.flush();
+
+        bool stateChanged = false;
+
+        if (state.blendState == resource)
+        {
+            state.blendState = nullptr;
+            stateChanged = true;
+        }
+
+        if (state.depthStencilState == resource)
+        {
+            state.depthStencilState = nullptr;
+            stateChanged = true;
+        }
+
+        if (state.texture == resource)
+        {
+            state.texture = nullptr;
+            stateChanged = true;
+        }
+
+        if (currentShader == resource)
+        {
+            currentShader = nullptr;
+            state.shaderType = Shader::Type::color;
+            stateChanged = true;
+        }
+
+        if (stateChanged) rasterizer.setState(state);
+
+        if (currentRenderTarget)
+        {
+            bool attached = currentRenderTarget == resource || currentRenderTarget->getDepthTexture() == resource;
+            for (const auto colorTexture : currentRenderTarget->getColorTextures())
+                if (colorTexture == resource) attached = true;
+
+            if (attached) setRenderTarget(nullptr);
+        }
+    }
+
+    void RenderDevice::resizeFrameBuffer(const math::Size<std::uint32_t, 2>& size)
+    {
+        rasterizer.flush();
+
+        frameBufferSize = size;
+        const auto pixelCount = static_cast<std::size_t>(size.v[0]) * size.v[1];
+
+        colorBuffer.assign(pixelCount * 4, 0);
+        if (depth) depthBuffer.assign(pixelCount, 1.0F);
+        if (stencil) stencilBuffer.assign(pixelCount, 0);
+
+        if (!currentRenderTarget) setRenderTarget(nullptr);
+    }
+
+    void RenderDevice::setRenderTarget(const RenderTarget* renderTarget)
+    {
+        Rasterizer::Target target;
+
+        if (renderTarget)
+        {
+            // only the first color attachment is rendered to
+            const auto& colorTextures = renderTarget->getColorTextures();
+            const auto colorTexture = colorTextures.empty() ? nullptr : *colorTextures.begin();
+            const auto depthTexture = renderTarget->getDepthTexture();
+
+            if (colorTexture)
+            {
+                auto& level = colorTexture->getLevels().front();
+                target.width = level.size.v[0];
+                target.height = level.size.v[1];
+                target.color = level.pixels.data();
+            }
+
+            if (depthTexture)
+            {
+                const auto& size = depthTexture->getSize();
+                if (!colorTexture)
+                {
+                    target.width = size.v[0];
+                    target.height = size.v[1];
+                }
+                else if (size.v[0] != target.width || size.v[1] != target.height)
+                    throw std::runtime_error{"Render target attachments have different sizes"};
+
+                target.depth = depthTexture->getDepth().empty() ? nullptr : depthTexture->getDepth().data();
+                target.stencil = depthTexture->getStencil().empty() ? nullptr : depthTexture->getStencil().data();
+            }
+        }
+        else
+        {
+            target.width = frameBufferSize.v[0];
+            target.height = frameBufferSize.v[1];
+            target.color = colorBuffer.empty() ? nullptr : colorBuffer.data();
+            target.depth = depthBuffer.empty() ? nullptr : depthBuffer.data();
+            target.stencil = stencilBuffer.empty() ? nullptr : stencilBuffer.data();
+        }
+
+        currentRenderTarget = renderTarget;
+        rasterizer.setTarget(target);
+    }
+
+    void RenderDevice::draw(ResourceId indexBufferId,
+                            std::uint32_t indexCount,
+                            std::uint32_t indexSize,
+                            ResourceId vertexBufferId,
+                            ResourceId instanceBufferId,
+                            std::uint32_t instanceCount,
+                            DrawMode drawMode,
+                            std::uint32_t startIndex)
+    {
+        const auto indexBuffer = getResource<Buffer>(indexBufferId);
+        const auto vertexBuffer = getResource<Buffer>(vertexBufferId);
+        const auto instanceBuffer = getResource<Buffer>(instanceBufferId);
+
+        if (!indexBuffer || !vertexBuffer)
+            throw std::runtime_error{"Invalid mesh buffer"};
+
+        if (!currentShader)
+            throw std::runtime_error{"No shader set"};
+
+        if (indexSize != sizeof(std::uint16_t) && indexSize != sizeof(std::uint32_t))
+            throw std::runtime_error{"Invalid index size"};
+
+        const auto& indexData = indexBuffer->getData();
+        const auto& vertexData = vertexBuffer->getData();
+
+        if ((static_cast<std::size_t>(startIndex) + indexCount) * indexSize > indexData.size())
+            throw std::runtime_error{"Index buffer is too small"};
+
+        const auto vertexCount = vertexData.size() / sizeof(graphics::Vertex);
+        const bool instanced = instanceBuffer && currentShader->getType() == Shader::Type::textureInstanced;
+
+        if (instanced && static_cast<std::size_t>(instanceCount) * sizeof(Instance) > instanceBuffer->getData().size())
+            throw std::runtime_error{"Instance buffer is too small"};
+
+        for (std::uint32_t instanceIndex = 0; instanceIndex < (instanced ? instanceCount : 1); ++instanceIndex)
+        {
+            auto matrix = vertexShaderConstant;
+            std::array<float, 4> instanceColor{1.0F, 1.0F, 1.0F, 1.0F};
+
+            if (instanced)
+            {
+                Instance instance;
+                std::memcpy(&instance, instanceBuffer->getData().data() + instanceIndex * sizeof(Instance), sizeof(Instance));
+                matrix = multiply(vertexShaderConstant.data(), instance.transform.m.v);
+                instanceColor = instance.color.norm();
+            }
+
+            // vertex shader
+            vertices.resize(indexCount);
+            for (std::uint32_t i = 0; i < indexCount; ++i)
+            {
+                const auto index = readIndex(indexData, static_cast<std::size_t>(startIndex) + i, indexSize);
+                if (index >= vertexCount)
+                    throw std::runtime_error{"Invalid index"};
+
+                graphics::Vertex vertex;
+                std::memcpy(&vertex, vertexData.data() + index * sizeof(graphics::Vertex), sizeof(graphics::Vertex));
+
+                auto& result = vertices[i];
+                result.position = transformPosition(matrix.data(), {vertex.position.v[0], vertex.position.v[1], vertex.position.v[2], 1.0F});
+                result.color = vertex.color.norm();
+                for (std::size_t c = 0; c < 4; ++c)
+                    result.color[c] *= instanceColor[c];
+                result.texCoord = {vertex.texCoords[0].v[0], vertex.texCoords[0].v[1]};
+            }
+
+            // primitive assembly
+            switch (drawMode)
+            {
+                case DrawMode::pointList:
+                    for (std::uint32_t i = 0; i < indexCount; ++i)
+                        rasterizer.drawPoint(vertices[i]);
+                    break;
+                case DrawMode::lineList:
+                    for (std::uint32_t i = 0; i + 1 < indexCount; i += 2)
+                        rasterizer.drawLine(vertices[i], vertices[i + 1]);
+                    break;
+                case DrawMode::lineStrip:
+                    for (std::uint32_t i = 0; i + 1 < indexCount; ++i)
+                        rasterizer.drawLine(vertices[i], vertices[i + 1]);
+                    break;
+                case DrawMode::triangleList:
+                    for (std::uint32_t i = 0; i + 2 < indexCount; i += 3)
+                        rasterizer.drawTriangle(vertices[i], vertices[i + 1], vertices[i + 2]);
+                    break;
+                case DrawMode::triangleStrip:
+                    // every other triangle of a strip is flipped to keep the winding
+                    for (std::uint32_t i = 0; i + 2 < indexCount; ++i)
+                        if (i % 2)
+                            rasterizer.drawTriangle(vertices[i + 1], vertices[i], vertices[i + 2]);
+                        else
+                            rasterizer.drawTriangle(vertices[i], vertices[i + 1], vertices[i + 2]);
+                    break;
+                default:
+                    throw std::runtime_error{"Invalid draw mode"};
+            }
+        }
+    }
+
+    void RenderDevice::generateScreenshot(const std::string& filename)
+    {
+        rasterizer.flush();
+
+        saveScreenshot(filename,
+                       frameBufferSize.v[0],
+                       frameBufferSize.v[1],
+                       4,
+                       colorBuffer.data(),
+                       static_cast<std::size_t>(frameBufferSize.v[0]) * 4);
+    }
+
+    void RenderDevice::renderMain()
+    {
+        while (running)
+        {
+            try
+            {
+                process();
+            }
+            catch (const std::exception& e)
+            {
+                log(Log::Level::error) << e.what();
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SOFTWARERENDERDEVICE_HPP
+#define OUZEL_GRAPHICS_SOFTWARERENDERDEVICE_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "../RenderDevice.hpp"
+#include "../ResourceTable.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "SoftwareRenderResource.hpp"
+#include "../../thread/Thread.hpp"
+
+namespace ouzel::graphics::software
+{
+    class RenderTarget;
+
+    // Renders the command buffers on the CPU into an offscreen frame buffer,
+    // used on machines without a GPU and for comparing the output of the other drivers
+    class RenderDevice final: public graphics::RenderDevice
+    {
+    public:
+        RenderDevice(const Settings& settings,
+                     core::Window& initWindow);
+        ~RenderDevice() override;
+
+        void start() final;
+
+        template <class T>
+        auto getResource(std::size_t id) const
+        {
+            return static_cast<T*>(resources.get(id));
+        }
+
+    private:
+        void process() final;
+        void processCommand(Command& command);
+        void generateScreenshot(const std::string& filename) final;
+        void resizeFrameBuffer(const math::Size<std::uint32_t, 2>& size);
+        void setRenderTarget(const RenderTarget* renderTarget);
+        void draw(ResourceId indexBufferId,
+                  std::uint32_t indexCount,
+                  std::uint32_t indexSize,
+                  ResourceId vertexBufferId,
+                  ResourceId instanceBufferId,
+                  std::uint32_t instanceCount,
+                  DrawMode drawMode,
+                  std::uint32_t startIndex);
+        void releaseResource(ResourceId id);
+        void renderMain();
+
+        template <class T>
+        void setResource(ResourceId id, std::unique_ptr<T> resource)
+        {
+            // a replayed frame capture can initialize a live id again, which replaces the resource
+            releaseResource(id);
+            resources.set(id, std::move(resource));
+        }
+
+        math::Size<std::uint32_t, 2> frameBufferSize;
+        std::vector<std::uint8_t> colorBuffer;
+        std::vector<float> depthBuffer;
+        std::vector<std::uint8_t> stencilBuffer;
+
+        Rasterizer rasterizer;
+        Rasterizer::State state;
+        const RenderTarget* currentRenderTarget = nullptr;
+        const Shader* currentShader = nullptr;
+        std::array<float, 16> vertexShaderConstant{};
+        std::vector<Rasterizer::Vertex> vertices; // vertex shader output of the current draw call
+
+        ResourceTable<RenderResource> resources;
+
+        std::atomic_bool running{false};
+#ifndef __EMSCRIPTEN__
+        thread::Thread renderThread;
+#endif
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SOFTWARERENDERDEVICE_HPP
@@ -0,0 +1,31 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SOFTWARERENDERRESOURCE_HPP
+#define OUZEL_GRAPHICS_SOFTWARERENDERRESOURCE_HPP
+
+namespace ouzel::graphics::software
+{
+    class RenderDevice;
+
+    class RenderResource
+    {
+    public:
+        explicit RenderResource(RenderDevice& initRenderDevice):
+            renderDevice(initRenderDevice)
+        {
+        }
+
+        virtual ~RenderResource() = default;
+
+        RenderResource(const RenderResource&) = delete;
+        RenderResource& operator=(const RenderResource&) = delete;
+
+        RenderResource(RenderResource&&) = delete;
+        RenderResource& operator=(RenderResource&&) = delete;
+
+    protected:
+        RenderDevice& renderDevice;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SOFTWARERENDERRESOURCE_HPP
@@ -0,0 +1,33 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SOFTWARERENDERTARGET_HPP
+#define OUZEL_GRAPHICS_SOFTWARERENDERTARGET_HPP
+
+#include <set>
+#include "SoftwareRenderResource.hpp"
+#include "SoftwareTexture.hpp"
+
+namespace ouzel::graphics::software
+{
+    class RenderTarget final: public RenderResource
+    {
+    public:
+        RenderTarget(RenderDevice& initRenderDevice,
+                     const std::set<Texture*>& initColorTextures,
+                     Texture* initDepthTexture):
+            RenderResource{initRenderDevice},
+            colorTextures{initColorTextures},
+            depthTexture{initDepthTexture}
+        {
+        }
+
+        auto& getColorTextures() const noexcept { return colorTextures; }
+        auto getDepthTexture() const noexcept { return depthTexture; }
+
+    private:
+        std::set<Texture*> colorTextures;
+        Texture* depthTexture = nullptr;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SOFTWARERENDERTARGET_HPP
@@ -0,0 +1,48 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SOFTWARESHADER_HPP
+#define OUZEL_GRAPHICS_SOFTWARESHADER_HPP
+
+#include <set>
+#include "SoftwareRenderResource.hpp"
+#include "../Vertex.hpp"
+
+namespace ouzel::graphics::software
+{
+    // The software renderer can't run shader byte code, so shaders are matched to
+    // the built-in C++ shader functions by their vertex attributes
+    class Shader final: public RenderResource
+    {
+    public:
+        enum class Type
+        {
+            color, // vertex color times the color constant
+            texture, // texture times vertex color times the color constant
+            textureInstanced // texture shader with per-instance transforms and colors
+        };
+
+        Shader(RenderDevice& initRenderDevice,
+               const std::set<Vertex::Attribute::Semantic>& vertexAttributes):
+            RenderResource{initRenderDevice},
+            type{getType(vertexAttributes)}
+        {
+        }
+
+        auto getType() const noexcept { return type; }
+
+    private:
+        static Type getType(const std::set<Vertex::Attribute::Semantic>& vertexAttributes) noexcept
+        {
+            if (vertexAttributes.find(Vertex::Attribute::Semantic{Vertex::Attribute::Usage::instanceTransform, 0U}) != vertexAttributes.end())
+                return Type::textureInstanced;
+            else if (vertexAttributes.find(Vertex::Attribute::Semantic{Vertex::Attribute::Usage::textureCoordinates, 0U}) != vertexAttributes.end())
+                return Type::texture;
+            else
+                return Type::color;
+        }
+
+        Type type = Type::color;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SOFTWARESHADER_HPP
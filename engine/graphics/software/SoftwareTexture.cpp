@@ -0,0 +1,290 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "SoftwareTexture.hpp"
+
+namespace ouzel::graphics::software
+{
+    namespace
+    {
+        void convertLevel(PixelFormat pixelFormat,
+                          bool luminance,
+                          const math::Size<std::uint32_t, 2>& size,
+                          const std::vector<std::uint8_t>& data,
+                          std::vector<std::uint8_t>& result)
+        {
+            const std::size_t pixelCount = static_cast<std::size_t>(size.v[0]) * size.v[1];
+            result.resize(pixelCount * 4);
+
+            // levels without data (render targets and streamed textures) start transparent black
+            if (data.empty())
+            {
+                std::fill(result.begin(), result.end(), std::uint8_t(0));
+                return;
+            }
+
+            if (data.size() < pixelCount * getPixelSize(pixelFormat))
+                throw std::runtime_error{"Invalid texture data size"};
+
+            switch (pixelFormat)
+            {
+                case PixelFormat::rgba8UnsignedNorm:
+                case PixelFormat::rgba8UnsignedNormSRGB:
+                    std::copy(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(pixelCount * 4), result.begin());
+                    break;
+                case PixelFormat::a8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i)
+                    {
+                        result[i * 4 + 0] = 0;
+                        result[i * 4 + 1] = 0;
+                        result[i * 4 + 2] = 0;
+                        result[i * 4 + 3] = data[i];
+                    }
+                    break;
+                case PixelFormat::r8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i)
+                    {
+                        result[i * 4 + 0] = data[i];
+                        result[i * 4 + 1] = luminance ? data[i] : 0;
+                        result[i * 4 + 2] = luminance ? data[i] : 0;
+                        result[i * 4 + 3] = 255;
+                    }
+                    break;
+                case PixelFormat::rg8UnsignedNorm:
+                    for (std::size_t i = 0; i < pixelCount; ++i)
+                    {
+                        result[i * 4 + 0] = data[i * 2 + 0];
+                        result[i * 4 + 1] = luminance ? data[i * 2 + 0] : data[i * 2 + 1];
+                        result[i * 4 + 2] = luminance ? data[i * 2 + 0] : 0;
+                        result[i * 4 + 3] = luminance ? data[i * 2 + 1] : 255;
+                    }
+                    break;
+                default:
+                    throw std::runtime_error{"Unsupported pixel format"};
+            }
+        }
+
+        std::int32_t applyAddressMode(SamplerAddressMode addressMode, std::int32_t coordinate, std::int32_t size) noexcept
+        {
+            switch (addressMode)
+            {
+                case SamplerAddressMode::repeat:
+                {
+                    const auto result = coordinate % size;
+                    return result < 0 ? result + size : result;
+                }
+                case SamplerAddressMode::mirrorRepeat:
+                {
+                    auto result = coordinate % (size * 2);
+                    if (result < 0) result += size * 2;
+                    return result < size ? result : size * 2 - 1 - result;
+                }
+                case SamplerAddressMode::clampToBorder:
+                    return (coordinate < 0 || coordinate >= size) ? -1 : coordinate;
+                case SamplerAddressMode::clampToEdge:
+                default:
+                    return std::clamp(coordinate, 0, size - 1);
+            }
+        }
+    }
+
+    Texture::Texture(RenderDevice& initRenderDevice,
+                     const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& initLevels,
+                     TextureType type,
+                     Flags initFlags,
+                     std::uint32_t,
+                     PixelFormat initPixelFormat,
+                     SamplerFilter initFilter,
+                     std::uint32_t initMaxAnisotropy):
+        RenderResource{initRenderDevice},
+        flags{initFlags},
+        pixelFormat{initPixelFormat},
+        filter{initFilter},
+        maxAnisotropy{initMaxAnisotropy}
+    {
+        if (type != TextureType::twoDimensional)
+            throw std::runtime_error{"Unsupported texture type"};
+
+        if (initLevels.empty())
+            throw std::runtime_error{"Invalid mip map count"};
+
+        if (isDepth())
+        {
+            // depth textures are only attached to render targets, so only the base level is kept
+            const auto& size = initLevels.front().first;
+            const std::size_t pixelCount = static_cast<std::size_t>(size.v[0]) * size.v[1];
+            levels.push_back(Level{size, {}});
+            depth.resize(pixelCount, 1.0F);
+            if (pixelFormat == PixelFormat::depthStencil)
+                stencil.resize(pixelCount, 0);
+            return;
+        }
+
+        levels.resize(initLevels.size());
+        for (std::size_t level = 0; level < initLevels.size(); ++level)
+        {
+            levels[level].size = initLevels[level].first;
+            convertLevel(pixelFormat, isLuminance(), initLevels[level].first, initLevels[level].second, levels[level].pixels);
+        }
+    }
+
+    void Texture::setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& newLevels)
+    {
+        if ((flags & Flags::dynamic) != Flags::dynamic ||
+            (flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
+            throw std::runtime_error{"Texture is not dynamic"};
+
+        setLevels(newLevels);
+    }
+
+    void Texture::setRegion(const std::vector<std::pair<math::Rect<std::uint32_t>, std::vector<std::uint8_t>>>& newLevels)
+    {
+        if ((flags & Flags::dynamic) != Flags::dynamic ||
+            (flags & Flags::bindRenderTarget) == Flags::bindRenderTarget)
+            throw std::runtime_error{"Texture is not dynamic"};
+
+        std::vector<std::uint8_t> pixels;
+
+        for (std::size_t level = 0; level < newLevels.size() && level < levels.size(); ++level)
+        {
+            const auto& [rectangle, data] = newLevels[level];
+            if (data.empty()) continue;
+
+            const auto width = rectangle.size.v[0];
+            const auto height = rectangle.size.v[1];
+            const auto left = rectangle.position.v[0];
+            const auto top = rectangle.position.v[1];
+            auto& levelData = levels[level];
+
+            if (left + width > levelData.size.v[0] || top + height > levelData.size.v[1])
+                throw std::runtime_error{"Invalid texture region"};
+
+            convertLevel(pixelFormat, isLuminance(), math::Size<std::uint32_t, 2>{width, height}, data, pixels);
+
+            for (std::uint32_t y = 0; y < height; ++y)
+                std::copy(pixels.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(y) * width * 4),
+                          pixels.begin() + static_cast<std::ptrdiff_t>((static_cast<std::size_t>(y) + 1) * width * 4),
+                          levelData.pixels.begin() + static_cast<std::ptrdiff_t>(((static_cast<std::size_t>(top) + y) * levelData.size.v[0] + left) * 4));
+        }
+    }
+
+    void Texture::upload(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& newLevels)
+    {
+        // streamed textures are uploaded at once, because the memory is shared with the rasterizer anyway
+        if (isDepth())
+            throw std::runtime_error{"Depth textures can not be uploaded"};
+
+        setLevels(newLevels);
+    }
+
+    void Texture::setLevels(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& newLevels)
+    {
+        for (std::size_t level = 0; level < newLevels.size() && level < levels.size(); ++level)
+            if (!newLevels[level].second.empty())
+            {
+                levels[level].size = newLevels[level].first;
+                convertLevel(pixelFormat, isLuminance(), newLevels[level].first, newLevels[level].second, levels[level].pixels);
+            }
+    }
+
+    std::array<float, 4> Texture::fetch(const Level& level, std::int32_t x, std::int32_t y) const noexcept
+    {
+        const auto width = static_cast<std::int32_t>(level.size.v[0]);
+        const auto height = static_cast<std::int32_t>(level.size.v[1]);
+        if (width == 0 || height == 0) return borderColor;
+
+        x = applyAddressMode(addressX, x, width);
+        y = applyAddressMode(addressY, y, height);
+
+        if (x < 0 || y < 0) return borderColor;
+
+        const auto pixel = &level.pixels[(static_cast<std::size_t>(y) * level.size.v[0] + static_cast<std::size_t>(x)) * 4];
+        return {
+            pixel[0] / 255.0F,
+            pixel[1] / 255.0F,
+            pixel[2] / 255.0F,
+            pixel[3] / 255.0F
+        };
+    }
+
+    std::array<float, 4> Texture::sampleNearest(const Level& level, float u, float v) const noexcept
+    {
+        return fetch(level,
+                     static_cast<std::int32_t>(std::floor(u * static_cast<float>(level.size.v[0]))),
+                     static_cast<std::int32_t>(std::floor(v * static_cast<float>(level.size.v[1]))));
+    }
+
+    std::array<float, 4> Texture::sampleLinear(const Level& level, float u, float v) const noexcept
+    {
+        const auto x = u * static_cast<float>(level.size.v[0]) - 0.5F;
+        const auto y = v * static_cast<float>(level.size.v[1]) - 0.5F;
+        const auto x0 = std::floor(x);
+        const auto y0 = std::floor(y);
+        const auto fx = x - x0;
+        const auto fy = y - y0;
+        const auto ix = static_cast<std::int32_t>(x0);
+        const auto iy = static_cast<std::int32_t>(y0);
+
+        const auto c00 = fetch(level, ix, iy);
+        const auto c10 = fetch(level, ix + 1, iy);
+        const auto c01 = fetch(level, ix, iy + 1);
+        const auto c11 = fetch(level, ix + 1, iy + 1);
+
+        std::array<float, 4> result;
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            const auto top = c00[c] + (c10[c] - c00[c]) * fx;
+            const auto bottom = c01[c] + (c11[c] - c01[c]) * fx;
+            result[c] = top + (bottom - top) * fy;
+        }
+        return result;
+    }
+
+    std::array<float, 4> Texture::sampleLevel(std::size_t level, float u, float v, bool linear) const noexcept
+    {
+        const auto& textureLevel = levels[std::min(level, levels.size() - 1)];
+        return linear ? sampleLinear(textureLevel, u, v) : sampleNearest(textureLevel, u, v);
+    }
+
+    std::array<float, 4> Texture::sample(float u, float v, float lod) const noexcept
+    {
+        if (isDepth()) return {1.0F, 1.0F, 1.0F, 1.0F};
+
+        // the same filters as the OpenGL render device
+        if (lod <= 0.0F || levels.size() == 1)
+        {
+            const bool linear = (lod <= 0.0F) ?
+                (filter == SamplerFilter::bilinear || filter == SamplerFilter::trilinear) :
+                filter != SamplerFilter::point;
+            return sampleLevel(0, u, v, linear);
+        }
+
+        const auto maxLevel = static_cast<float>(levels.size() - 1);
+
+        switch (filter)
+        {
+            case SamplerFilter::point:
+                return sampleLevel(static_cast<std::size_t>(std::min(std::floor(lod + 0.5F), maxLevel)), u, v, false);
+            case SamplerFilter::linear:
+            case SamplerFilter::bilinear:
+                return sampleLevel(static_cast<std::size_t>(std::min(std::floor(lod + 0.5F), maxLevel)), u, v, true);
+            case SamplerFilter::trilinear:
+            default:
+            {
+                const auto clampedLod = std::min(lod, maxLevel);
+                const auto level0 = static_cast<std::size_t>(std::floor(clampedLod));
+                const auto factor = clampedLod - std::floor(clampedLod);
+                const auto c0 = sampleLevel(level0, u, v, true);
+                if (factor <= 0.0F) return c0;
+                const auto c1 = sampleLevel(level0 + 1, u, v, true);
+
+                std::array<float, 4> result;
+                for (std::size_t c = 0; c < 4; ++c)
+                    result[c] = c0[c] + (c1[c] - c0[c]) * factor;
+                return result;
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_SOFTWARETEXTURE_HPP
+#define OUZEL_GRAPHICS_SOFTWARETEXTURE_HPP
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "SoftwareRenderResource.hpp"
+#include "../Flags.hpp"
+#include "../PixelFormat.hpp"
+#include "../SamplerAddressMode.hpp"
+#include "../SamplerFilter.hpp"
+#include "../TextureType.hpp"
+#include "../../math/Color.hpp"
+#include "../../math/Rect.hpp"
+#include "../../math/Size.hpp"
+
+namespace ouzel::graphics::software
+{
+    class Texture final: public RenderResource
+    {
+    public:
+        // all color formats are expanded to RGBA8 when they are uploaded
+        struct Level final
+        {
+            math::Size<std::uint32_t, 2> size;
+            std::vector<std::uint8_t> pixels;
+        };
+
+        Texture(RenderDevice& initRenderDevice,
+                const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& initLevels,
+                TextureType type,
+                Flags initFlags,
+                std::uint32_t initSampleCount,
+                PixelFormat initPixelFormat,
+                SamplerFilter initFilter,
+                std::uint32_t initMaxAnisotropy);
+
+        void setData(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& newLevels);
+        void setRegion(const std::vector<std::pair<math::Rect<std::uint32_t>, std::vector<std::uint8_t>>>& newLevels);
+        void upload(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& newLevels);
+        void setFilter(SamplerFilter newFilter) noexcept { filter = newFilter; }
+        void setAddressX(SamplerAddressMode newAddressX) noexcept { addressX = newAddressX; }
+        void setAddressY(SamplerAddressMode newAddressY) noexcept { addressY = newAddressY; }
+        void setBorderColor(math::Color newBorderColor) noexcept { borderColor = newBorderColor.norm(); }
+        void setMaxAnisotropy(std::uint32_t newMaxAnisotropy) noexcept { maxAnisotropy = newMaxAnisotropy; }
+
+        auto getFlags() const noexcept { return flags; }
+        auto getPixelFormat() const noexcept { return pixelFormat; }
+        auto& getSize() const noexcept { return levels.front().size; }
+
+        auto& getLevels() noexcept { return levels; }
+        auto& getLevels() const noexcept { return levels; }
+
+        // depth and stencil planes of depth textures
+        auto& getDepth() noexcept { return depth; }
+        auto& getStencil() noexcept { return stencil; }
+        bool isDepth() const noexcept
+        {
+            return pixelFormat == PixelFormat::depth || pixelFormat == PixelFormat::depthStencil;
+        }
+
+        bool isLuminance() const noexcept
+        {
+            return (flags & Flags::luminance) == Flags::luminance;
+        }
+
+        // lod is the base two logarithm of texels per pixel, so the filter can choose between the
+        // magnification and minification filters like the GPU does
+        std::array<float, 4> sample(float u, float v, float lod) const noexcept;
+
+    private:
+        void setLevels(const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& newLevels);
+
+        std::array<float, 4> fetch(const Level& level, std::int32_t x, std::int32_t y) const noexcept;
+        std::array<float, 4> sampleNearest(const Level& level, float u, float v) const noexcept;
+        std::array<float, 4> sampleLinear(const Level& level, float u, float v) const noexcept;
+        std::array<float, 4> sampleLevel(std::size_t level, float u, float v, bool linear) const noexcept;
+
+        Flags flags = Flags::none;
+        PixelFormat pixelFormat = PixelFormat::rgba8UnsignedNorm;
+        SamplerFilter filter = SamplerFilter::point;
+        SamplerAddressMode addressX = SamplerAddressMode::clampToEdge;
+        SamplerAddressMode addressY = SamplerAddressMode::clampToEdge;
+        std::array<float, 4> borderColor{0.0F, 0.0F, 0.0F, 0.0F};
+        std::uint32_t maxAnisotropy = 1;
+
+        std::vector<Level> levels;
+        std::vector<float> depth;
+        std::vector<std::uint8_t> stencil;
+    };
+}
+
+#endif // OUZEL_GRAPHICS_SOFTWARETEXTURE_HPP
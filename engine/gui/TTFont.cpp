@@ -42,53 +42,35 @@ namespace ouzel::gui
             throw std::runtime_error{"Failed to load font"};
     }
 
-    Font::RenderData TTFont::getRenderData(const std::string_view& text,
-                                           math::Color color,
-                                           float fontSize,
-                                           const math::Vector<float, 2>& anchor) const
+    bool TTFont::cacheGlyphs(const std::u32string& text, float fontSize) const
     {
-        if (!font)
-            throw std::runtime_error{"Font not loaded"};
-
-        constexpr std::uint32_t spacing = 2U;
+        // the atlas has a single page, so that every text is drawn with one texture
+        if (!atlas)
+            atlas = std::make_unique<graphics::TextureAtlas>(engine->getGraphics(),
+                                                             math::Size<std::uint32_t, 2>{1024, 1024},
+                                                             4U,
+                                                             mipmaps ? 3U : 1U,
+                                                             1U);
 
         const auto s = stbtt_ScaleForPixelHeight(font.get(), fontSize);
 
-        const auto utf32Text = utf8::toUtf32(text);
-
-        std::set<char32_t> glyphs;
-        for (const auto i : utf32Text)
-            glyphs.insert(i);
-
-        std::uint16_t width = 0;
-        std::uint16_t height = 0;
-
         int ascent;
         int descent;
         int lineGap;
         stbtt_GetFontVMetrics(font.get(), &ascent, &descent, &lineGap);
 
-        struct CharDescriptor final
+        for (const char32_t c : text)
         {
-            std::uint16_t x = 0;
-            std::uint16_t y = 0;
-            std::uint16_t width = 0;
-            std::uint16_t height = 0;
-            math::Vector<float, 2> offset{};
-            float advance = 0;
-            std::vector<std::uint8_t> bitmap;
-        };
-
-        std::unordered_map<std::uint32_t, CharDescriptor> chars;
-
-        for (const char32_t c : glyphs)
+            const auto key = std::make_pair(c, fontSize);
+            if (glyphs.find(key) != glyphs.end()) continue;
+
             if (const auto index = stbtt_FindGlyphIndex(font.get(), static_cast<int>(c)))
             {
                 int advance;
                 int leftBearing;
                 stbtt_GetGlyphHMetrics(font.get(), index, &advance, &leftBearing);
 
-                CharDescriptor charDesc;
+                Glyph glyph;
                 int w;
                 int h;
                 int xoff;
@@ -96,57 +78,74 @@ namespace ouzel::gui
 
                 if (const auto bitmap = stbtt_GetGlyphBitmapSubpixel(font.get(), s, s, 0.0F, 0.0F, index, &w, &h, &xoff, &yoff))
                 {
-                    charDesc.width = static_cast<std::uint16_t>(w);
-                    charDesc.height = static_cast<std::uint16_t>(h);
-                    charDesc.offset.v[0] = static_cast<float>(leftBearing * s);
-                    charDesc.offset.v[1] = static_cast<float>(yoff + (ascent - descent) * s);
-                    charDesc.bitmap = std::vector<std::uint8_t>(bitmap, bitmap + h * w);
-                    charDesc.x = width;
+                    std::vector<std::uint8_t> textureData(static_cast<std::size_t>(w * h) * 4);
 
-                    width += static_cast<std::uint16_t>(w);
-                    height = std::max(height, static_cast<std::uint16_t>(h));
+                    for (int i = 0; i < w * h; ++i)
+                    {
+                        textureData[static_cast<std::size_t>(i) * 4 + 0] = 255;
+                        textureData[static_cast<std::size_t>(i) * 4 + 1] = 255;
+                        textureData[static_cast<std::size_t>(i) * 4 + 2] = 255;
+                        textureData[static_cast<std::size_t>(i) * 4 + 3] = bitmap[i];
+                    }
 
                     stbtt_FreeBitmap(bitmap, nullptr);
-                }
 
-                charDesc.advance = static_cast<float>(advance * s);
+                    if (w > 0 && h > 0)
+                    {
+                        glyph.region = atlas->add(math::Size<std::uint32_t, 2>{
+                            static_cast<std::uint32_t>(w),
+                            static_cast<std::uint32_t>(h)
+                        }, textureData);
+
+                        if (!glyph.region)
+                            return false;
+                    }
+
+                    glyph.width = static_cast<float>(w);
+                    glyph.height = static_cast<float>(h);
+                    glyph.offset.v[0] = static_cast<float>(leftBearing * s);
+                    glyph.offset.v[1] = static_cast<float>(yoff + (ascent - descent) * s);
+                }
 
-                if (!chars.empty())
-                    width += spacing;
+                glyph.advance = static_cast<float>(advance * s);
 
-                chars[c] = charDesc;
+                glyphs[key] = std::move(glyph);
             }
+        }
 
-        std::vector<std::uint8_t> textureData(width * height * 4);
+        return true;
+    }
 
-        for (std::uint16_t posX = 0; posX < width; ++posX)
-            for (std::uint16_t posY = 0; posY < height; ++posY)
-            {
-                textureData[(posY * width + posX) * 4 + 0] = 255;
-                textureData[(posY * width + posX) * 4 + 1] = 255;
-                textureData[(posY * width + posX) * 4 + 2] = 255;
-                textureData[(posY * width + posX) * 4 + 3] = 0;
-            }
+    Font::RenderData TTFont::getRenderData(const std::string_view& text,
+                                           math::Color color,
+                                           float fontSize,
+                                           const math::Vector<float, 2>& anchor) const
+    {
+        if (!font)
+            throw std::runtime_error{"Font not loaded"};
 
-        for (const auto& c : chars)
+        const auto s = stbtt_ScaleForPixelHeight(font.get(), fontSize);
+
+        const auto utf32Text = utf8::toUtf32(text);
+
+        if (!cacheGlyphs(utf32Text, fontSize))
         {
-            const auto& charDesc = c.second;
+            // start over with an empty atlas, textures returned earlier keep their pages alive
+            atlas->clear();
+            glyphs.clear();
 
-            for (std::uint16_t posX = 0; posX < charDesc.width; ++posX)
-                for (std::uint16_t posY = 0; posY < charDesc.height; ++posY)
-                {
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 0] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 1] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 2] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 3] = charDesc.bitmap[posY * charDesc.width + posX];
-                }
+            if (!cacheGlyphs(utf32Text, fontSize))
+                throw std::runtime_error{"Text does not fit in the glyph atlas"};
         }
 
-        auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
-                                                           textureData,
-                                                           math::Size<std::uint32_t, 2>{width, height},
-                                                           graphics::Flags::none,
-                                                           mipmaps ? 0 : 1);
+        atlas->flush();
+
+        int ascent;
+        int descent;
+        int lineGap;
+        stbtt_GetFontVMetrics(font.get(), &ascent, &descent, &lineGap);
+
+        std::shared_ptr<graphics::Texture> texture;
 
         math::Vector<float, 2> position{};
 
@@ -159,44 +158,52 @@ namespace ouzel::gui
 
         for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
         {
-            if (auto iterator = chars.find(*i); iterator != chars.end())
+            if (auto iterator = glyphs.find(std::make_pair(*i, fontSize)); iterator != glyphs.end())
             {
                 const auto& f = iterator->second;
 
-                const auto startIndex = static_cast<std::uint16_t>(vertices.size());
-                indices.push_back(startIndex + 0);
-                indices.push_back(startIndex + 1);
-                indices.push_back(startIndex + 2);
-
-                indices.push_back(startIndex + 1);
-                indices.push_back(startIndex + 3);
-                indices.push_back(startIndex + 2);
-
-                const math::Vector<float, 2> leftTop{
-                    f.x / static_cast<float>(width),
-                    f.y / static_cast<float>(height)
-                };
-
-                const math::Vector<float, 2> rightBottom{
-                    (f.x + f.width) / static_cast<float>(width),
-                    (f.y + f.height) / static_cast<float>(height)
-                };
-
-                const std::array<math::Vector<float, 2>, 4> textCoords{
-                    math::Vector<float, 2>{leftTop.v[0], rightBottom.v[1]},
-                    math::Vector<float, 2>{rightBottom.v[0], rightBottom.v[1]},
-                    math::Vector<float, 2>{leftTop.v[0], leftTop.v[1]},
-                    math::Vector<float, 2>{rightBottom.v[0], leftTop.v[1]}
-                };
-
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0], -position.v[1] - f.offset.v[1] - f.height, 0.0F},
-                                      color, textCoords[0], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0] + f.width, -position.v[1] - f.offset.v[1] - f.height, 0.0F},
-                                      color, textCoords[1], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0], -position.v[1] - f.offset.v[1], 0.0F},
-                                      color, textCoords[2], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0] + f.width, -position.v[1] - f.offset.v[1], 0.0F},
-                                      color, textCoords[3], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                if (f.region)
+                {
+                    assert(!texture || texture == f.region->getTexture());
+                    texture = f.region->getTexture();
+
+                    const auto startIndex = static_cast<std::uint16_t>(vertices.size());
+                    indices.push_back(startIndex + 0);
+                    indices.push_back(startIndex + 1);
+                    indices.push_back(startIndex + 2);
+
+                    indices.push_back(startIndex + 1);
+                    indices.push_back(startIndex + 3);
+                    indices.push_back(startIndex + 2);
+
+                    const auto& textureRectangle = f.region->getTextureRectangle();
+
+                    const math::Vector<float, 2> leftTop{
+                        textureRectangle.position.v[0],
+                        textureRectangle.position.v[1]
+                    };
+
+                    const math::Vector<float, 2> rightBottom{
+                        textureRectangle.position.v[0] + textureRectangle.size.v[0],
+                        textureRectangle.position.v[1] + textureRectangle.size.v[1]
+                    };
+
+                    const std::array<math::Vector<float, 2>, 4> textCoords{
+                        math::Vector<float, 2>{leftTop.v[0], rightBottom.v[1]},
+                        math::Vector<float, 2>{rightBottom.v[0], rightBottom.v[1]},
+                        math::Vector<float, 2>{leftTop.v[0], leftTop.v[1]},
+                        math::Vector<float, 2>{rightBottom.v[0], leftTop.v[1]}
+                    };
+
+                    vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0], -position.v[1] - f.offset.v[1] - f.height, 0.0F},
+                                          color, textCoords[0], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                    vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0] + f.width, -position.v[1] - f.offset.v[1] - f.height, 0.0F},
+                                          color, textCoords[1], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                    vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0], -position.v[1] - f.offset.v[1], 0.0F},
+                                          color, textCoords[2], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                    vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0] + f.width, -position.v[1] - f.offset.v[1], 0.0F},
+                                          color, textCoords[3], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                }
 
                 if ((i + 1) != utf32Text.end())
                 {
@@ -3,7 +3,11 @@
 #ifndef OUZEL_GUI_TTFONT_HPP
 #define OUZEL_GUI_TTFONT_HPP
 
+#include <map>
+#include <memory>
+#include <utility>
 #include "../gui/Font.hpp"
+#include "../graphics/TextureAtlas.hpp"
 
 struct stbtt_fontinfo;
 
@@ -21,9 +25,25 @@ namespace ouzel::gui
                                  const math::Vector<float, 2>& anchor) const override;
 
     private:
+        struct Glyph final
+        {
+            std::shared_ptr<graphics::TextureAtlas::Region> region; // nullptr for glyphs without a bitmap
+            float width = 0.0F;
+            float height = 0.0F;
+            math::Vector<float, 2> offset{};
+            float advance = 0.0F;
+        };
+
+        // rasterizes the missing glyphs into the atlas, returns false if the atlas is full
+        bool cacheGlyphs(const std::u32string& text, float fontSize) const;
+
         std::unique_ptr<stbtt_fontinfo> font;
         std::vector<std::byte> data;
         bool mipmaps = true;
+
+        // glyphs are cached per code point and pixel height, so that texts share one texture
+        mutable std::unique_ptr<graphics::TextureAtlas> atlas;
+        mutable std::map<std::pair<char32_t, float>, Glyph> glyphs;
     };
 }
 
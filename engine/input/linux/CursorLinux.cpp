@@ -16,6 +16,7 @@ namespace ouzel::input::linux
 #if OUZEL_SUPPORTS_X11
         const auto engineLinux = static_cast<core::linux::Engine*>(engine);
         auto display = engineLinux->getDisplay();
+        if (!display) return;
 
         switch (systemCursor)
         {
@@ -50,7 +51,7 @@ namespace ouzel::input::linux
         const auto engineLinux = static_cast<core::linux::Engine*>(engine);
         auto display = engineLinux->getDisplay();
 
-        if (!data.empty())
+        if (display && !data.empty())
         {
             const auto width = static_cast<int>(size.v[0]);
             const auto height = static_cast<int>(size.v[1]);
@@ -29,19 +29,21 @@ namespace ouzel::input::linux
 #endif
     {
 #if OUZEL_SUPPORTS_X11
+        // there is no display while the engine is constructed or if it runs without a window
         const auto engineLinux = static_cast<core::linux::Engine*>(engine);
-        auto display = engineLinux->getDisplay();
-
-        char data[1] = {0};
-
-        Pixmap pixmap = XCreateBitmapFromData(display, DefaultRootWindow(display), data, 1, 1);
-        if (pixmap)
+        if (auto display = engineLinux ? engineLinux->getDisplay() : nullptr)
         {
-            XColor color;
-            color.red = color.green = color.blue = 0;
+            char data[1] = {0};
 
-            emptyCursor = XCreatePixmapCursor(display, pixmap, pixmap, &color, &color, 0, 0);
-            XFreePixmap(display, pixmap);
+            Pixmap pixmap = XCreateBitmapFromData(display, DefaultRootWindow(display), data, 1, 1);
+            if (pixmap)
+            {
+                XColor color;
+                color.red = color.green = color.blue = 0;
+
+                emptyCursor = XCreatePixmapCursor(display, pixmap, pixmap, &color, &color, 0, 0);
+                XFreePixmap(display, pixmap);
+            }
         }
 #endif
 
@@ -251,6 +253,8 @@ namespace ouzel::input::linux
         auto display = engineLinux->getDisplay();
         auto window = windowLinux.getNativeWindow();
 
+        if (!display) return;
+
         if (mouseDevice->isCursorVisible())
         {
             if (mouseDevice->getCursor())
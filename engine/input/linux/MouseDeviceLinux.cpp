@@ -23,6 +23,8 @@ namespace ouzel::input::linux
         auto display = engineLinux->getDisplay();
         auto window = windowLinux.getNativeWindow();
 
+        if (!display) return;
+
         XWindowAttributes attributes;
         XGetWindowAttributes(display, window, &attributes);
 
@@ -48,6 +50,8 @@ namespace ouzel::input::linux
         auto display = engineLinux->getDisplay();
         auto window = windowLinux.getNativeWindow();
 
+        if (!display) return;
+
         if (locked)
         {
             if (XGrabPointer(display, window, False,
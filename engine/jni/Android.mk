@@ -16,7 +16,10 @@ LOCAL_C_INCLUDES += $(LOCAL_PATH)/.. \
 
 LOCAL_SRC_FILES := ../assets/Bundle.cpp \
     ../assets/Cache.cpp \
+    ../assets/DdsLoader.cpp \
+    ../assets/GltfLoader.cpp \
     ../assets/ImageLoader.cpp \
+    ../assets/KtxLoader.cpp \
     ../assets/MtlLoader.cpp \
     ../assets/ObjLoader.cpp \
     ../assets/WaveLoader.cpp \
@@ -47,22 +50,35 @@ LOCAL_SRC_FILES := ../assets/Bundle.cpp \
     ../core/System.cpp \
     ../core/Window.cpp \
     ../events/EventDispatcher.cpp \
+    ../graphics/empty/EmptyRenderDevice.cpp \
     ../graphics/opengl/android/OGLRenderDeviceAndroid.cpp \
     ../graphics/opengl/OGLBlendState.cpp \
     ../graphics/opengl/OGLBuffer.cpp \
     ../graphics/opengl/OGLDepthStencilState.cpp \
     ../graphics/opengl/OGLRenderDevice.cpp \
+    ../graphics/opengl/OGLProgramCache.cpp \
     ../graphics/opengl/OGLRenderTarget.cpp \
     ../graphics/opengl/OGLShader.cpp \
     ../graphics/opengl/OGLTexture.cpp \
+    ../graphics/software/SoftwareRasterizer.cpp \
+    ../graphics/software/SoftwareRenderDevice.cpp \
+    ../graphics/software/SoftwareTexture.cpp \
     ../graphics/BlendState.cpp \
+    ../graphics/BlockDecoder.cpp \
     ../graphics/Buffer.cpp \
     ../graphics/DepthStencilState.cpp \
+    ../graphics/FrameCapture.cpp \
     ../graphics/Graphics.cpp \
+    ../graphics/ImageWriter.cpp \
+    ../graphics/Material.cpp \
+    ../graphics/MipmapGenerator.cpp \
     ../graphics/RenderDevice.cpp \
+    ../graphics/RenderGraph.cpp \
+    ../graphics/RenderGraphSchedule.cpp \
     ../graphics/RenderTarget.cpp \
     ../graphics/Shader.cpp \
     ../graphics/Texture.cpp \
+    ../graphics/TextureAtlas.cpp \
     ../gui/BMFont.cpp \
     ../gui/TTFont.cpp \
     ../gui/Widgets.cpp \
@@ -85,20 +101,31 @@ LOCAL_SRC_FILES := ../assets/Bundle.cpp \
     ../network/Network.cpp \
     ../network/Server.cpp \
     ../scene/Actor.cpp \
+    ../scene/AnimationSystem.cpp \
     ../scene/Animator.cpp \
     ../scene/Animators.cpp \
     ../scene/Camera.cpp \
+    ../scene/ClusterGrid.cpp \
     ../scene/Component.cpp \
+    ../scene/InstanceBatch.cpp \
     ../scene/Layer.cpp \
     ../scene/Light.cpp \
+    ../scene/LightClusters.cpp \
     ../scene/ParticleSystem.cpp \
     ../scene/Scene.cpp \
+    ../scene/SceneData.cpp \
+    ../scene/SceneInstance.cpp \
     ../scene/SceneManager.cpp \
     ../scene/ShapeRenderer.cpp \
+    ../scene/SkeletalAnimation.cpp \
     ../scene/SkinnedMeshRenderer.cpp \
     ../scene/SpriteRenderer.cpp \
     ../scene/StaticMeshRenderer.cpp \
+    ../scene/StaticBatch.cpp \
+    ../scene/StaticBatchLayout.cpp \
     ../scene/TextRenderer.cpp \
+    ../scene/TileAnimation.cpp \
+    ../scene/TileMapRenderer.cpp \
     ../storage/FileSystem.cpp \
     ../utils/Log.cpp
 
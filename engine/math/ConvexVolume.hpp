@@ -3,12 +3,22 @@
 #ifndef OUZEL_MATH_CONVEXVOLUME_HPP
 #define OUZEL_MATH_CONVEXVOLUME_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <vector>
 #include "Box.hpp"
 #include "Plane.hpp"
 #include "Vector.hpp"
 
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+#  include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+
 namespace ouzel::math
 {
     template <typename T> class ConvexVolume final
@@ -73,6 +83,140 @@ namespace ouzel::math
 
         return true;
     }
+
+    // Tests the boxes against the volume and sets the bit of every box that is at least partially inside
+    // A box is outside when the corner that lies furthest along the normal of a plane is behind that plane
+    inline void cullBoxes(const ConvexVolume<float>& volume,
+                          const Box<float, 3>* boxes,
+                          std::size_t count,
+                          std::vector<std::uint32_t>& visibility)
+    {
+        visibility.assign((count + 31) / 32, 0);
+
+        std::size_t i = 0;
+
+#if defined(__AVX__)
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto* b = boxes + i;
+            const auto minX = _mm256_set_ps(b[7].min.v[0], b[6].min.v[0], b[5].min.v[0], b[4].min.v[0], b[3].min.v[0], b[2].min.v[0], b[1].min.v[0], b[0].min.v[0]);
+            const auto minY = _mm256_set_ps(b[7].min.v[1], b[6].min.v[1], b[5].min.v[1], b[4].min.v[1], b[3].min.v[1], b[2].min.v[1], b[1].min.v[1], b[0].min.v[1]);
+            const auto minZ = _mm256_set_ps(b[7].min.v[2], b[6].min.v[2], b[5].min.v[2], b[4].min.v[2], b[3].min.v[2], b[2].min.v[2], b[1].min.v[2], b[0].min.v[2]);
+            const auto maxX = _mm256_set_ps(b[7].max.v[0], b[6].max.v[0], b[5].max.v[0], b[4].max.v[0], b[3].max.v[0], b[2].max.v[0], b[1].max.v[0], b[0].max.v[0]);
+            const auto maxY = _mm256_set_ps(b[7].max.v[1], b[6].max.v[1], b[5].max.v[1], b[4].max.v[1], b[3].max.v[1], b[2].max.v[1], b[1].max.v[1], b[0].max.v[1]);
+            const auto maxZ = _mm256_set_ps(b[7].max.v[2], b[6].max.v[2], b[5].max.v[2], b[4].max.v[2], b[3].max.v[2], b[2].max.v[2], b[1].max.v[2], b[0].max.v[2]);
+
+            auto outside = _mm256_setzero_ps();
+
+            for (const auto& plane : volume.planes)
+            {
+                const auto x = plane.v[0] >= 0.0F ? maxX : minX;
+                const auto y = plane.v[1] >= 0.0F ? maxY : minY;
+                const auto z = plane.v[2] >= 0.0F ? maxZ : minZ;
+
+                const auto distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.v[0]), x),
+                                                                  _mm256_mul_ps(_mm256_set1_ps(plane.v[1]), y)),
+                                                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.v[2]), z),
+                                                                  _mm256_set1_ps(plane.v[3])));
+
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+
+            const auto mask = static_cast<std::uint32_t>(~_mm256_movemask_ps(outside) & 0xFF);
+            visibility[i / 32] |= mask << (i % 32);
+        }
+#elif defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+        for (; i + 4 <= count; i += 4)
+        {
+            const auto* b = boxes + i;
+            const auto minX = _mm_set_ps(b[3].min.v[0], b[2].min.v[0], b[1].min.v[0], b[0].min.v[0]);
+            const auto minY = _mm_set_ps(b[3].min.v[1], b[2].min.v[1], b[1].min.v[1], b[0].min.v[1]);
+            const auto minZ = _mm_set_ps(b[3].min.v[2], b[2].min.v[2], b[1].min.v[2], b[0].min.v[2]);
+            const auto maxX = _mm_set_ps(b[3].max.v[0], b[2].max.v[0], b[1].max.v[0], b[0].max.v[0]);
+            const auto maxY = _mm_set_ps(b[3].max.v[1], b[2].max.v[1], b[1].max.v[1], b[0].max.v[1]);
+            const auto maxZ = _mm_set_ps(b[3].max.v[2], b[2].max.v[2], b[1].max.v[2], b[0].max.v[2]);
+
+            auto outside = _mm_setzero_ps();
+
+            for (const auto& plane : volume.planes)
+            {
+                const auto x = plane.v[0] >= 0.0F ? maxX : minX;
+                const auto y = plane.v[1] >= 0.0F ? maxY : minY;
+                const auto z = plane.v[2] >= 0.0F ? maxZ : minZ;
+
+                const auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.v[0]), x),
+                                                            _mm_mul_ps(_mm_set1_ps(plane.v[1]), y)),
+                                                 _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.v[2]), z),
+                                                            _mm_set1_ps(plane.v[3])));
+
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+            }
+
+            const auto mask = static_cast<std::uint32_t>(~_mm_movemask_ps(outside) & 0x0F);
+            visibility[i / 32] |= mask << (i % 32);
+        }
+#elif defined(__ARM_NEON__)
+        const std::uint32_t bitValues[4] = {1, 2, 4, 8};
+        const auto bits = vld1q_u32(bitValues);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const auto* b = boxes + i;
+            const float minXValues[4] = {b[0].min.v[0], b[1].min.v[0], b[2].min.v[0], b[3].min.v[0]};
+            const float minYValues[4] = {b[0].min.v[1], b[1].min.v[1], b[2].min.v[1], b[3].min.v[1]};
+            const float minZValues[4] = {b[0].min.v[2], b[1].min.v[2], b[2].min.v[2], b[3].min.v[2]};
+            const float maxXValues[4] = {b[0].max.v[0], b[1].max.v[0], b[2].max.v[0], b[3].max.v[0]};
+            const float maxYValues[4] = {b[0].max.v[1], b[1].max.v[1], b[2].max.v[1], b[3].max.v[1]};
+            const float maxZValues[4] = {b[0].max.v[2], b[1].max.v[2], b[2].max.v[2], b[3].max.v[2]};
+            const auto minX = vld1q_f32(minXValues);
+            const auto minY = vld1q_f32(minYValues);
+            const auto minZ = vld1q_f32(minZValues);
+            const auto maxX = vld1q_f32(maxXValues);
+            const auto maxY = vld1q_f32(maxYValues);
+            const auto maxZ = vld1q_f32(maxZValues);
+
+            auto outside = vdupq_n_u32(0);
+
+            for (const auto& plane : volume.planes)
+            {
+                const auto x = plane.v[0] >= 0.0F ? maxX : minX;
+                const auto y = plane.v[1] >= 0.0F ? maxY : minY;
+                const auto z = plane.v[2] >= 0.0F ? maxZ : minZ;
+
+                auto distance = vdupq_n_f32(plane.v[3]);
+                distance = vmlaq_n_f32(distance, x, plane.v[0]);
+                distance = vmlaq_n_f32(distance, y, plane.v[1]);
+                distance = vmlaq_n_f32(distance, z, plane.v[2]);
+
+                outside = vorrq_u32(outside, vcltq_f32(distance, vdupq_n_f32(0.0F)));
+            }
+
+            const auto outsideBits = vandq_u32(outside, bits);
+            const auto outsideMask = vgetq_lane_u32(outsideBits, 0) | vgetq_lane_u32(outsideBits, 1) |
+                vgetq_lane_u32(outsideBits, 2) | vgetq_lane_u32(outsideBits, 3);
+            const auto mask = ~outsideMask & 0x0F;
+            visibility[i / 32] |= mask << (i % 32);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            const auto& box = boxes[i];
+            bool inside = true;
+
+            for (const auto& plane : volume.planes)
+                if (plane.v[0] * (plane.v[0] >= 0.0F ? box.max.v[0] : box.min.v[0]) +
+                    plane.v[1] * (plane.v[1] >= 0.0F ? box.max.v[1] : box.min.v[1]) +
+                    plane.v[2] * (plane.v[2] >= 0.0F ? box.max.v[2] : box.min.v[2]) +
+                    plane.v[3] < 0.0F)
+                {
+                    inside = false;
+                    break;
+                }
+
+            if (inside) visibility[i / 32] |= 1U << (i % 32);
+        }
+    }
 }
 
 #endif // OUZEL_MATH_CONVEXVOLUME_HPP
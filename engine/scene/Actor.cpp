@@ -250,20 +250,8 @@ namespace ouzel::scene
         if (parentTransformDirty) updateTransform(newParentTransform);
         if (transformDirty) calculateTransform();
 
-        if (!worldHidden)
-        {
-            const auto boundingBox = getBoundingBox();
-
-            if (cullDisabled || (!isEmpty(boundingBox) && camera->checkVisibility(getTransform(), boundingBox)))
-            {
-                const auto upperBound = std::upper_bound(drawQueue.begin(), drawQueue.end(), this,
-                                                         [](const auto a, const auto b) noexcept {
-                                                             return a->worldOrder > b->worldOrder;
-                                                         });
-
-                drawQueue.insert(upperBound, this);
-            }
-        }
+        // the layer culls and sorts the queue after all the actors have been visited
+        if (!worldHidden) drawQueue.push_back(this);
 
         for (const auto actor : children)
             actor->visit(drawQueue, transform, updateChildrenTransform, camera, worldOrder, worldHidden);
@@ -284,6 +272,16 @@ namespace ouzel::scene
                                 wireframe);
     }
 
+    void Actor::drawDepth(Camera* camera)
+    {
+        if (transformDirty)
+            calculateTransform();
+
+        for (const auto component : components)
+            if (!component->isHidden())
+                component->drawDepth(transform, camera->getRenderViewProjection());
+    }
+
     void Actor::addChild(Actor& actor)
     {
         ActorContainer::addChild(actor);
@@ -76,6 +76,7 @@ namespace ouzel::scene
                            Order parentOrder,
                            bool parentHidden);
         virtual void draw(Camera* camera, bool wireframe);
+        virtual void drawDepth(Camera* camera);
 
         virtual const math::Vector<float, 3>& getPosition() const noexcept { return position; }
         virtual void setPosition(const math::Vector<float, 2>& newPosition);
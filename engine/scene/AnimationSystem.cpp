@@ -0,0 +1,234 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <limits>
+#include "AnimationSystem.hpp"
+#include "Animators.hpp"
+#include "SkinnedMeshRenderer.hpp"
+#include "TileMapRenderer.hpp"
+#include "../core/Engine.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        constexpr std::size_t pendingIndex = std::numeric_limits<std::size_t>::max();
+    }
+
+    AnimationSystem::~AnimationSystem()
+    {
+        for (auto& group : groups)
+            for (auto animator : group.animators)
+                if (animator) animator->animationSystem = nullptr;
+
+        for (auto animator : addedAnimators)
+            animator->animationSystem = nullptr;
+
+        skinnedMeshes.forEach([](SkinnedMeshSlot& slot) noexcept {
+            slot.skinnedMesh->animationSystem = nullptr;
+        });
+
+        tileMaps.forEach([](TileMapRenderer* tileMap) noexcept {
+            tileMap->animationSystem = nullptr;
+        });
+    }
+
+    void AnimationSystem::addAnimator(Animator& animator)
+    {
+        if (animator.animationSystem == this) return;
+        if (animator.animationSystem) animator.animationSystem->removeAnimator(animator);
+
+        animator.animationSystem = this;
+
+        if (updating)
+        {
+            animator.animationSystemIndex = pendingIndex;
+            addedAnimators.push_back(&animator);
+        }
+        else
+            insert(animator);
+    }
+
+    void AnimationSystem::removeAnimator(Animator& animator)
+    {
+        if (animator.animationSystem != this) return;
+
+        animator.animationSystem = nullptr;
+
+        if (animator.animationSystemIndex == pendingIndex)
+        {
+            if (const auto i = std::find(addedAnimators.begin(), addedAnimators.end(), &animator); i != addedAnimators.end())
+                addedAnimators.erase(i);
+            return;
+        }
+
+        auto& animators = groups[static_cast<std::size_t>(animator.type)].animators;
+
+        // the arrays are compacted after the update
+        if (updating)
+            animators[animator.animationSystemIndex] = nullptr;
+        else
+        {
+            const auto last = animators.back();
+            animators[animator.animationSystemIndex] = last;
+            last->animationSystemIndex = animator.animationSystemIndex;
+            animators.pop_back();
+        }
+    }
+
+    void AnimationSystem::addSkinnedMesh(SkinnedMeshRenderer& skinnedMesh)
+    {
+        if (skinnedMesh.animationSystem == this) return;
+        if (skinnedMesh.animationSystem) skinnedMesh.animationSystem->removeSkinnedMesh(skinnedMesh);
+
+        // meshes added during the update start with the next update
+        skinnedMesh.animationSystem = this;
+        skinnedMesh.animationSystemHandle = skinnedMeshes.create(SkinnedMeshSlot{&skinnedMesh, updating});
+        if (updating) pendingSkinnedMeshes = true;
+    }
+
+    void AnimationSystem::removeSkinnedMesh(SkinnedMeshRenderer& skinnedMesh)
+    {
+        if (skinnedMesh.animationSystem != this) return;
+
+        skinnedMesh.animationSystem = nullptr;
+
+        // the slots of the pool don't move, so meshes can be removed during the update
+        skinnedMeshes.destroy(skinnedMesh.animationSystemHandle);
+        skinnedMesh.animationSystemHandle = 0;
+    }
+
+    void AnimationSystem::addTileMap(TileMapRenderer& tileMap)
+    {
+        if (tileMap.animationSystem == this) return;
+        if (tileMap.animationSystem) tileMap.animationSystem->removeTileMap(tileMap);
+
+        tileMap.animationSystem = this;
+        tileMap.animationSystemHandle = tileMaps.create(&tileMap);
+    }
+
+    void AnimationSystem::removeTileMap(TileMapRenderer& tileMap)
+    {
+        if (tileMap.animationSystem != this) return;
+
+        tileMap.animationSystem = nullptr;
+
+        tileMaps.destroy(tileMap.animationSystemHandle);
+        tileMap.animationSystemHandle = 0;
+    }
+
+    void AnimationSystem::update(float delta)
+    {
+        updating = true;
+
+        for (std::size_t type = 0; type < groups.size(); ++type)
+        {
+            auto& group = groups[type];
+            auto& animators = group.animators;
+            const auto count = animators.size();
+
+            // generic animators can be subclassed, so they go through the virtual update,
+            // which dispatches the finish event itself
+            if (static_cast<Animator::Type>(type) == Animator::Type::generic)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                    if (const auto animator = animators[i]; animator && animator->running)
+                        animator->update(delta);
+                continue;
+            }
+
+            group.finished.resize(count);
+            for (std::size_t i = 0; i < count; ++i)
+                group.finished[i] = animators[i] && animators[i]->running && animators[i]->advance(delta);
+
+            if (static_cast<Animator::Type>(type) == Animator::Type::ease)
+            {
+                // evaluate the easing of all the animators before applying it
+                group.progress.resize(count);
+                for (std::size_t i = 0; i < count; ++i)
+                    if (const auto ease = static_cast<Ease*>(animators[i]))
+                        group.progress[i] = easing::ease(ease->func, ease->mode, ease->progress);
+
+                for (std::size_t i = 0; i < count; ++i)
+                    if (const auto ease = static_cast<Ease*>(animators[i]); ease && (ease->running || group.finished[i]))
+                    {
+                        ease->progress = group.progress[i];
+                        if (!ease->animators.empty()) ease->animators.front()->setProgress(ease->progress);
+                    }
+            }
+            else
+            {
+                // the animators of a group share the same implementation of updateProgress
+                for (std::size_t i = 0; i < count; ++i)
+                    if (const auto animator = animators[i]; animator && (animator->running || group.finished[i]))
+                        animator->updateProgress();
+            }
+
+            // the event handlers can destroy animators, which sets them to nullptr in the array,
+            // so each one is checked right before its event is dispatched
+            for (std::size_t i = 0; i < count; ++i)
+                if (group.finished[i] && animators[i])
+                {
+                    auto finishEvent = std::make_unique<AnimationEvent>();
+                    finishEvent->type = Event::Type::animationFinish;
+                    finishEvent->component = animators[i];
+                    engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                }
+        }
+
+        // only the frame table of a tile map changes, its chunks pick up the new frames when they are drawn
+        tileMaps.forEach([delta](TileMapRenderer* tileMap) {
+            tileMap->animation.update(delta);
+        });
+
+        // the finish events of the meshes are dispatched during their update, so handlers can remove any of them
+        skinnedMeshes.forEach([delta](SkinnedMeshSlot& slot) {
+            if (!slot.pending) slot.skinnedMesh->update(delta);
+        });
+
+        updating = false;
+
+        if (pendingSkinnedMeshes)
+        {
+            skinnedMeshes.forEach([](SkinnedMeshSlot& slot) noexcept { slot.pending = false; });
+            pendingSkinnedMeshes = false;
+        }
+
+        // drop the removed and the stopped animators
+        for (auto& group : groups)
+        {
+            auto& animators = group.animators;
+
+            for (std::size_t i = 0; i < animators.size();)
+                if (const auto animator = animators[i]; !animator || !animator->running)
+                {
+                    if (animator) animator->animationSystem = nullptr;
+
+                    animators[i] = animators.back();
+                    if (animators[i]) animators[i]->animationSystemIndex = i;
+                    animators.pop_back();
+                }
+                else
+                    ++i;
+        }
+
+        for (auto animator : addedAnimators)
+            insert(*animator);
+        addedAnimators.clear();
+    }
+
+    std::size_t AnimationSystem::getAnimatorCount() const noexcept
+    {
+        std::size_t result = addedAnimators.size();
+        for (const auto& group : groups)
+            result += group.animators.size();
+        return result;
+    }
+
+    void AnimationSystem::insert(Animator& animator)
+    {
+        auto& animators = groups[static_cast<std::size_t>(animator.type)].animators;
+        animator.animationSystemIndex = animators.size();
+        animators.push_back(&animator);
+    }
+}
@@ -0,0 +1,72 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_ANIMATIONSYSTEM_HPP
+#define OUZEL_SCENE_ANIMATIONSYSTEM_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Animator.hpp"
+#include "ComponentPool.hpp"
+
+namespace ouzel::scene
+{
+    class SkinnedMeshRenderer;
+    class TileMapRenderer;
+
+    // Updates the started animators, the animated tiles of tile maps and the playing skinned meshes once per frame.
+    // Animators of the same type are kept in a dense array and updated together.
+    // Generic animators are updated through Animator::update, so that subclasses can override it.
+    class AnimationSystem final
+    {
+    public:
+        AnimationSystem() = default;
+        ~AnimationSystem();
+
+        AnimationSystem(const AnimationSystem&) = delete;
+        AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+        AnimationSystem(AnimationSystem&&) = delete;
+        AnimationSystem& operator=(AnimationSystem&&) = delete;
+
+        void addAnimator(Animator& animator);
+        void removeAnimator(Animator& animator);
+
+        void addSkinnedMesh(SkinnedMeshRenderer& skinnedMesh);
+        void removeSkinnedMesh(SkinnedMeshRenderer& skinnedMesh);
+
+        void addTileMap(TileMapRenderer& tileMap);
+        void removeTileMap(TileMapRenderer& tileMap);
+
+        void update(float delta);
+
+        [[nodiscard]] std::size_t getAnimatorCount() const noexcept;
+        [[nodiscard]] auto getSkinnedMeshCount() const noexcept { return skinnedMeshes.getSize(); }
+        [[nodiscard]] auto getTileMapCount() const noexcept { return tileMaps.getSize(); }
+
+    private:
+        struct Group final
+        {
+            std::vector<Animator*> animators; // removed animators are set to nullptr during the update
+            std::vector<std::uint8_t> finished;
+            std::vector<float> progress;
+        };
+
+        struct SkinnedMeshSlot final
+        {
+            SkinnedMeshRenderer* skinnedMesh;
+            bool pending; // added during the update, starts with the next one
+        };
+
+        void insert(Animator& animator);
+
+        std::array<Group, static_cast<std::size_t>(Animator::Type::count)> groups;
+        std::vector<Animator*> addedAnimators; // animators started during the update
+        ComponentPool<SkinnedMeshSlot> skinnedMeshes; // iterated linearly, slots of removed meshes are reused
+        bool pendingSkinnedMeshes = false;
+        ComponentPool<TileMapRenderer*> tileMaps; // tile maps with animated tiles
+        bool updating = false;
+    };
+}
+
+#endif // OUZEL_SCENE_ANIMATIONSYSTEM_HPP
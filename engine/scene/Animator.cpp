@@ -3,64 +3,73 @@
 #include <algorithm>
 #include <cassert>
 #include "Animator.hpp"
+#include "AnimationSystem.hpp"
 #include "Actor.hpp"
 #include "../core/Engine.hpp"
 
 namespace ouzel::scene
 {
-    Animator::Animator(float initLength):
-        length{initLength}
+    Animator::Animator(float initLength, Type initType):
+        length{initLength},
+        type{initType}
     {
-        updateHandler.updateHandler = [this](const UpdateEvent& event) {
-            update(event.delta);
-            return false;
-        };
     }
 
     Animator::~Animator()
     {
+        if (animationSystem) animationSystem->removeAnimator(*this);
+
         if (parent) parent->removeAnimator(*this);
 
         for (const auto& animator : animators)
             animator->parent = nullptr;
     }
 
+    bool Animator::advance(float delta)
+    {
+        if (length == 0.0F) // never-ending animation
+        {
+            currentTime += delta;
+            progress = 0.0F;
+            return false;
+        }
+        else if (currentTime + delta >= length)
+        {
+            done = true;
+            running = false;
+            progress = 1.0F;
+            currentTime = length;
+            return true;
+        }
+        else
+        {
+            currentTime += delta;
+            progress = currentTime / length;
+            return false;
+        }
+    }
+
     void Animator::update(float delta)
     {
         if (running)
         {
-            if (length == 0.0F) // never-ending animation
-            {
-                currentTime += delta;
-                progress = 0.0F;
-            }
-            else if (currentTime + delta >= length)
-            {
-                done = true;
-                running = false;
-                progress = 1.0F;
-                currentTime = length;
+            const auto finished = advance(delta);
 
+            updateProgress();
+
+            if (finished)
+            {
                 auto finishEvent = std::make_unique<AnimationEvent>();
                 finishEvent->type = Event::Type::animationFinish;
                 finishEvent->component = this;
                 engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
             }
-            else
-            {
-                currentTime += delta;
-                progress = currentTime / length;
-            }
-
-            updateProgress();
         }
-        else
-            updateHandler.remove();
     }
 
     void Animator::start()
     {
-        engine->getEventDispatcher().addEventHandler(updateHandler);
+        engine->getAnimationSystem().addAnimator(*this);
         play();
 
         auto startEvent = std::make_unique<AnimationEvent>();
@@ -87,6 +96,9 @@ namespace ouzel::scene
     void Animator::resume()
     {
         running = true;
+
+        // the child animators are updated by their parents
+        if (!parent) engine->getAnimationSystem().addAnimator(*this);
     }
 
     void Animator::stop(bool resetAnimation)
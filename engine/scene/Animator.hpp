@@ -6,17 +6,33 @@
 #include <memory>
 #include <vector>
 #include "Component.hpp"
-#include "../events/EventHandler.hpp"
 
 namespace ouzel::scene
 {
+    class AnimationSystem;
+
     class Animator: public Component
     {
         friend Actor;
+        friend AnimationSystem;
     public:
-        explicit Animator(float initLength);
+        // animators are grouped by the type in the animation system
+        enum class Type
+        {
+            generic,
+            ease,
+            fade,
+            move,
+            rotate,
+            scale,
+            shake,
+            count
+        };
+
+        explicit Animator(float initLength, Type initType = Type::generic);
         ~Animator() override;
 
+        // called by the animation system for generic animators, the typed animators are final
         virtual void update(float delta);
 
         void start();
@@ -45,7 +61,11 @@ namespace ouzel::scene
         auto getParent() const noexcept { return parent; }
         void removeFromParent();
 
+        auto getType() const noexcept { return type; }
+
     protected:
+        // advances the time without dispatching events, returns true if the animation has finished
+        bool advance(float delta);
         virtual void updateProgress() {}
 
         float length = 0.0F;
@@ -57,10 +77,13 @@ namespace ouzel::scene
         Animator* parent = nullptr;
         Actor* targetActor = nullptr;
 
-        EventHandler updateHandler;
-
         std::vector<Animator*> animators;
         std::vector<std::unique_ptr<Animator>> ownedAnimators;
+
+    private:
+        Type type = Type::generic;
+        AnimationSystem* animationSystem = nullptr;
+        std::size_t animationSystemIndex = 0;
     };
 }
 
@@ -11,7 +11,7 @@
 namespace ouzel::scene
 {
     Ease::Ease(Animator& animator, easing::Func initFunc, easing::Mode initMode):
-        Animator{animator.getLength()}, func{initFunc}, mode{initMode}
+        Animator{animator.getLength(), Type::ease}, func{initFunc}, mode{initMode}
     {
         addAnimator(animator);
     }
@@ -28,7 +28,7 @@ namespace ouzel::scene
     }
 
     Fade::Fade(float initLength, float initOpacity, bool initRelative):
-        Animator{initLength}, opacity{initOpacity}, relative{initRelative}
+        Animator{initLength, Type::fade}, opacity{initOpacity}, relative{initRelative}
     {
     }
 
@@ -54,7 +54,7 @@ namespace ouzel::scene
     }
 
     Move::Move(float initLength, const math::Vector<float, 3>& initPosition, bool initRelative):
-        Animator{initLength}, position{initPosition}, relative{initRelative}
+        Animator{initLength, Type::move}, position{initPosition}, relative{initRelative}
     {
     }
 
@@ -172,7 +172,7 @@ namespace ouzel::scene
     }
 
     Rotate::Rotate(float initLength, const math::Vector<float, 3>& initRotation, bool initRelative):
-        Animator{initLength}, rotation{initRotation}, relative{initRelative}
+        Animator{initLength, Type::rotate}, rotation{initRotation}, relative{initRelative}
     {
     }
 
@@ -199,7 +199,7 @@ namespace ouzel::scene
     }
 
     Scale::Scale(float initLength, const math::Vector<float, 3>& initScale, bool initRelative):
-        Animator{initLength}, scale{initScale}, relative{initRelative}
+        Animator{initLength, Type::scale}, scale{initScale}, relative{initRelative}
     {
     }
 
@@ -298,7 +298,7 @@ namespace ouzel::scene
     }
 
     Shake::Shake(float initLength, const math::Vector<float, 3>& initDistance, float initTimeScale):
-        Animator{initLength}, distance{initDistance}, timeScale{initTimeScale}
+        Animator{initLength, Type::shake}, distance{initDistance}, timeScale{initTimeScale}
     {
         seedX = std::uniform_int_distribution<std::uint32_t>{0, std::numeric_limits<std::uint32_t>::max()}(core::randomEngine);
         seedY = std::uniform_int_distribution<std::uint32_t>{0, std::numeric_limits<std::uint32_t>::max()}(core::randomEngine);
@@ -18,6 +18,7 @@ namespace ouzel::scene
 {
     class Ease final: public Animator
     {
+        friend AnimationSystem;
     public:
         Ease(Animator& animator, easing::Func initFunc, easing::Mode initModee);
 
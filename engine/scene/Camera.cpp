@@ -284,6 +284,21 @@ namespace ouzel::scene
         }
     }
 
+    math::ConvexVolume<float> Camera::getCullingVolume() const
+    {
+        const auto& matrix = getViewProjection();
+
+        if (projectionMode == ProjectionMode::orthographic)
+            return math::ConvexVolume<float>{{
+                math::getFrustumLeftPlane(matrix),
+                math::getFrustumRightPlane(matrix),
+                math::getFrustumBottomPlane(matrix),
+                math::getFrustumTopPlane(matrix)
+            }};
+        else
+            return math::getFrustum(matrix);
+    }
+
     void Camera::setViewport(const math::Rect<float>& newViewport)
     {
         viewport = newViewport;
@@ -34,6 +34,12 @@ namespace ouzel::scene
             showAll
         };
 
+        enum class LodMetric
+        {
+            screenSize,
+            distance
+        };
+
         explicit Camera(const math::Matrix<float, 4>& initProjection);
         explicit Camera(const math::Size<float, 2>& initTargetContentSize = math::Size<float, 2>{},
                         ScaleMode initScaleMode = ScaleMode::noScale);
@@ -88,6 +94,8 @@ namespace ouzel::scene
         [[nodiscard]] math::Vector<float, 2> convertWorldToNormalized(const math::Vector<float, 3>& worldPosition) const noexcept;
 
         [[nodiscard]] bool checkVisibility(const math::Matrix<float, 4>& boxTransform, const math::Box<float, 3>& box) const;
+        // world space planes for testing many bounding boxes at once, orthographic cameras are not limited in depth
+        [[nodiscard]] math::ConvexVolume<float> getCullingVolume() const;
 
         [[nodiscard]] auto& getViewport() const noexcept { return viewport; }
         void setViewport(const math::Rect<float>& newViewport);
@@ -116,6 +124,14 @@ namespace ouzel::scene
         [[nodiscard]] auto getWireframe() const noexcept { return wireframe; }
         void setWireframe(bool newWireframe) { wireframe = newWireframe; }
 
+        // the metric that meshes use to pick their level of detail
+        [[nodiscard]] auto getLodMetric() const noexcept { return lodMetric; }
+        void setLodMetric(LodMetric newLodMetric) { lodMetric = newLodMetric; }
+
+        // values above 1 keep the detailed levels longer, values below 1 switch to simpler levels sooner
+        [[nodiscard]] auto getLodBias() const noexcept { return lodBias; }
+        void setLodBias(float newLodBias) { lodBias = newLodBias; }
+
         [[nodiscard]] auto getClearColorBuffer() const noexcept { return clearColorBuffer; }
         void setClearColorBuffer(bool clear) { clearColorBuffer = clear; }
 
@@ -173,6 +189,9 @@ namespace ouzel::scene
         std::unique_ptr<graphics::DepthStencilState> depthStencilState;
         std::uint32_t stencilReferenceValue = 0;
 
+        LodMetric lodMetric = LodMetric::screenSize;
+        float lodBias = 1.0F;
+
         bool clearColorBuffer = false;
         bool clearDepthBuffer = false;
         bool clearStencilBuffer = false;
@@ -0,0 +1,243 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+#  include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+#include "ClusterGrid.hpp"
+#include "../math/Constants.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        // flags the tiles whose horizontal range is closer to x than the square root of distanceSquared
+        void testTiles(const float* minX, const float* maxX, std::uint32_t count,
+                       float x, float distanceSquared, std::uint8_t* hits) noexcept
+        {
+            std::uint32_t i = 0;
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+            const auto center = _mm_set1_ps(x);
+            const auto limit = _mm_set1_ps(distanceSquared);
+            const auto zero = _mm_setzero_ps();
+
+            for (; i + 4 <= count; i += 4)
+            {
+                const auto distance = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minX + i), center),
+                                                            _mm_sub_ps(center, _mm_loadu_ps(maxX + i))),
+                                                 zero);
+                const auto mask = _mm_movemask_ps(_mm_cmple_ps(_mm_mul_ps(distance, distance), limit));
+
+                hits[i + 0] = static_cast<std::uint8_t>(mask & 0x01);
+                hits[i + 1] = static_cast<std::uint8_t>((mask >> 1) & 0x01);
+                hits[i + 2] = static_cast<std::uint8_t>((mask >> 2) & 0x01);
+                hits[i + 3] = static_cast<std::uint8_t>((mask >> 3) & 0x01);
+            }
+#elif defined(__ARM_NEON__)
+            const auto center = vdupq_n_f32(x);
+            const auto limit = vdupq_n_f32(distanceSquared);
+            const auto zero = vdupq_n_f32(0.0F);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                const auto distance = vmaxq_f32(vmaxq_f32(vsubq_f32(vld1q_f32(minX + i), center),
+                                                          vsubq_f32(center, vld1q_f32(maxX + i))),
+                                                zero);
+                std::uint32_t mask[4];
+                vst1q_u32(mask, vcleq_f32(vmulq_f32(distance, distance), limit));
+
+                hits[i + 0] = mask[0] ? 1 : 0;
+                hits[i + 1] = mask[1] ? 1 : 0;
+                hits[i + 2] = mask[2] ? 1 : 0;
+                hits[i + 3] = mask[3] ? 1 : 0;
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                const auto distance = std::max(std::max(minX[i] - x, x - maxX[i]), 0.0F);
+                hits[i] = distance * distance <= distanceSquared ? 1 : 0;
+            }
+        }
+    }
+
+    void ClusterGrid::setViewport(const math::Size<float, 2>& viewportSize,
+                                  const math::Matrix<float, 4>& projection,
+                                  float nearDepth, float farDepth)
+    {
+        gridWidth = static_cast<std::uint32_t>(std::ceil(viewportSize.v[0] / tileSize));
+        gridHeight = static_cast<std::uint32_t>(std::ceil(viewportSize.v[1] / tileSize));
+
+        farDepth = std::max(farDepth, nearDepth + std::numeric_limits<float>::epsilon());
+        const auto logarithmic = projection.m.v[11] != 0.0F && nearDepth > 0.0F;
+
+        depthParameters = logarithmic ?
+            math::Vector<float, 4>{nearDepth, sliceCount / std::log(farDepth / nearDepth), 1.0F, 0.0F} :
+            math::Vector<float, 4>{nearDepth, sliceCount / (farDepth - nearDepth), 0.0F, 0.0F};
+
+        const auto getSliceDepth = [logarithmic, nearDepth, farDepth](std::uint32_t z) {
+            const auto fraction = static_cast<float>(z) / sliceCount;
+            return logarithmic ?
+                nearDepth * std::pow(farDepth / nearDepth, fraction) :
+                nearDepth + (farDepth - nearDepth) * fraction;
+        };
+
+        // view space coordinate of the clip space coordinate at the depth
+        const auto unproject = [](float clip, float scale, float skew, float offset, float w, float depth) {
+            return (clip * w + skew * depth - offset) / scale;
+        };
+
+        const auto tileClipWidth = 2.0F * tileSize / viewportSize.v[0];
+        const auto tileClipHeight = 2.0F * tileSize / viewportSize.v[1];
+
+        for (std::uint32_t z = 0; z < sliceCount; ++z)
+        {
+            auto& slice = slices[z];
+            slice.nearDepth = getSliceDepth(z);
+            slice.farDepth = getSliceDepth(z + 1);
+
+            const auto nearW = projection.m.v[15] - projection.m.v[11] * slice.nearDepth;
+            const auto farW = projection.m.v[15] - projection.m.v[11] * slice.farDepth;
+
+            slice.tileMinX.resize(gridWidth);
+            slice.tileMaxX.resize(gridWidth);
+
+            for (std::uint32_t x = 0; x < gridWidth; ++x)
+            {
+                const auto left = -1.0F + x * tileClipWidth;
+                const auto right = std::min(left + tileClipWidth, 1.0F);
+                const float values[] = {
+                    unproject(left, projection.m.v[0], projection.m.v[8], projection.m.v[12], nearW, slice.nearDepth),
+                    unproject(left, projection.m.v[0], projection.m.v[8], projection.m.v[12], farW, slice.farDepth),
+                    unproject(right, projection.m.v[0], projection.m.v[8], projection.m.v[12], nearW, slice.nearDepth),
+                    unproject(right, projection.m.v[0], projection.m.v[8], projection.m.v[12], farW, slice.farDepth)
+                };
+
+                slice.tileMinX[x] = *std::min_element(std::begin(values), std::end(values));
+                slice.tileMaxX[x] = *std::max_element(std::begin(values), std::end(values));
+            }
+
+            slice.tileMinY.resize(gridHeight);
+            slice.tileMaxY.resize(gridHeight);
+
+            for (std::uint32_t y = 0; y < gridHeight; ++y)
+            {
+                const auto bottom = -1.0F + y * tileClipHeight;
+                const auto top = std::min(bottom + tileClipHeight, 1.0F);
+                const float values[] = {
+                    unproject(bottom, projection.m.v[5], projection.m.v[9], projection.m.v[13], nearW, slice.nearDepth),
+                    unproject(bottom, projection.m.v[5], projection.m.v[9], projection.m.v[13], farW, slice.farDepth),
+                    unproject(top, projection.m.v[5], projection.m.v[9], projection.m.v[13], nearW, slice.nearDepth),
+                    unproject(top, projection.m.v[5], projection.m.v[9], projection.m.v[13], farW, slice.farDepth)
+                };
+
+                slice.tileMinY[y] = *std::min_element(std::begin(values), std::end(values));
+                slice.tileMaxY[y] = *std::max_element(std::begin(values), std::end(values));
+            }
+        }
+    }
+
+    void ClusterGrid::addPointLight(const math::Vector<float, 3>& position, float range, std::uint32_t index)
+    {
+        lights.push_back(Light{position, range, index});
+    }
+
+    void ClusterGrid::addSpotLight(const math::Vector<float, 3>& position, const math::Vector<float, 3>& direction,
+                                   float range, float angle, std::uint32_t index)
+    {
+        const auto halfAngle = angle / 2.0F;
+
+        // wide cones are bounded by the sphere around their base, narrow ones by the sphere through the apex
+        if (halfAngle >= math::tau<float> / 4.0F)
+            lights.push_back(Light{position, range, index});
+        else if (halfAngle > math::tau<float> / 8.0F)
+            lights.push_back(Light{position + direction * (range * std::cos(halfAngle)), range * std::sin(halfAngle), index});
+        else
+        {
+            const auto radius = range / (2.0F * std::cos(halfAngle));
+            lights.push_back(Light{position + direction * radius, radius, index});
+        }
+    }
+
+    void ClusterGrid::binSlice(std::uint32_t z)
+    {
+        auto& slice = slices[z];
+        const auto clustersPerSlice = gridWidth * gridHeight;
+
+        slice.hits.resize(gridWidth);
+        slice.entries.clear();
+        slice.offsets.assign(clustersPerSlice + 1, 0);
+
+        for (const auto& light : lights)
+        {
+            // the bounds of the clusters are separable, so the squared distances along the axes are subtracted one by one
+            const auto depth = -light.center.v[2];
+            const auto depthDistance = depth < slice.nearDepth ? slice.nearDepth - depth :
+                depth > slice.farDepth ? depth - slice.farDepth : 0.0F;
+            const auto sliceRadiusSquared = light.radius * light.radius - depthDistance * depthDistance;
+            if (sliceRadiusSquared < 0.0F) continue;
+
+            for (std::uint32_t y = 0; y < gridHeight; ++y)
+            {
+                const auto yDistance = std::max(std::max(slice.tileMinY[y] - light.center.v[1],
+                                                         light.center.v[1] - slice.tileMaxY[y]), 0.0F);
+                const auto rowRadiusSquared = sliceRadiusSquared - yDistance * yDistance;
+                if (rowRadiusSquared < 0.0F) continue;
+
+                testTiles(slice.tileMinX.data(), slice.tileMaxX.data(), gridWidth,
+                          light.center.v[0], rowRadiusSquared, slice.hits.data());
+
+                for (std::uint32_t x = 0; x < gridWidth; ++x)
+                    if (slice.hits[x])
+                    {
+                        const auto cluster = y * gridWidth + x;
+                        ++slice.offsets[cluster + 1];
+                        slice.entries.push_back(cluster);
+                        slice.entries.push_back(light.index);
+                    }
+            }
+        }
+
+        // counting sort of the found lights by cluster
+        for (std::uint32_t cluster = 0; cluster < clustersPerSlice; ++cluster)
+            slice.offsets[cluster + 1] += slice.offsets[cluster];
+
+        slice.cursors.assign(slice.offsets.begin(), slice.offsets.end() - 1);
+        slice.lightIndices.resize(slice.entries.size() / 2);
+
+        for (std::size_t i = 0; i < slice.entries.size(); i += 2)
+            slice.lightIndices[slice.cursors[slice.entries[i]]++] = slice.entries[i + 1];
+    }
+
+    void ClusterGrid::getClusterData(std::vector<float>& data) const
+    {
+        const auto clustersPerSlice = gridWidth * gridHeight;
+        const auto clusterCount = clustersPerSlice * sliceCount;
+
+        std::size_t indexCount = 0;
+        for (const auto& slice : slices)
+            indexCount += slice.lightIndices.size();
+
+        data.assign((clusterCount + (indexCount + 3) / 4) * 4, 0.0F);
+
+        std::uint32_t cluster = 0;
+        std::uint32_t sliceOffset = 0;
+        for (const auto& slice : slices)
+        {
+            for (std::uint32_t i = 0; i < clustersPerSlice; ++i, ++cluster)
+            {
+                data[cluster * 4 + 0] = static_cast<float>(sliceOffset + slice.offsets[i]);
+                data[cluster * 4 + 1] = static_cast<float>(slice.offsets[i + 1] - slice.offsets[i]);
+            }
+
+            for (const auto index : slice.lightIndices)
+                data[clusterCount * 4 + sliceOffset++] = static_cast<float>(index);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_CLUSTERGRID_HPP
+#define OUZEL_SCENE_CLUSTERGRID_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../math/Matrix.hpp"
+#include "../math/Size.hpp"
+#include "../math/Vector.hpp"
+
+namespace ouzel::scene
+{
+    // The part of the light clusters that doesn't depend on the engine. It splits the view frustum
+    // into clusters and finds the point and spot lights whose bounding spheres reach every cluster.
+    class ClusterGrid final
+    {
+    public:
+        static constexpr std::uint32_t tileSize = 64; // width and height of a cluster in pixels
+        static constexpr std::uint32_t sliceCount = 24;
+
+        struct Light final
+        {
+            math::Vector<float, 3> center; // of the bounding sphere in view space
+            float radius;
+            std::uint32_t index; // in the light data
+        };
+
+        struct Slice final
+        {
+            float nearDepth;
+            float farDepth;
+            std::vector<float> tileMinX; // view space bounds of the tiles in this slice
+            std::vector<float> tileMaxX;
+            std::vector<float> tileMinY;
+            std::vector<float> tileMaxY;
+            std::vector<std::uint8_t> hits;
+            std::vector<std::uint32_t> entries; // pairs of cluster and light in the order they were found
+            std::vector<std::uint32_t> offsets; // first light of every cluster in lightIndices
+            std::vector<std::uint32_t> cursors;
+            std::vector<std::uint32_t> lightIndices; // sorted by cluster
+        };
+
+        // splits the viewport into tiles and the depth range into slices, which are logarithmic for perspective
+        // projections and linear for orthographic ones, and unprojects the tile bounds of every slice
+        void setViewport(const math::Size<float, 2>& viewportSize,
+                         const math::Matrix<float, 4>& projection,
+                         float nearDepth, float farDepth);
+
+        void clearLights() noexcept { lights.clear(); }
+
+        // the position and the direction are in view space
+        void addPointLight(const math::Vector<float, 3>& position, float range, std::uint32_t index);
+        // the angle is the full angle of the cone
+        void addSpotLight(const math::Vector<float, 3>& position, const math::Vector<float, 3>& direction,
+                          float range, float angle, std::uint32_t index);
+
+        // finds the lights of every cluster of the slice, different slices can be binned on different threads
+        void binSlice(std::uint32_t z);
+
+        // every cluster has the offset and the count of its lights, the light indices follow the clusters
+        void getClusterData(std::vector<float>& data) const;
+
+        [[nodiscard]] auto getGridWidth() const noexcept { return gridWidth; }
+        [[nodiscard]] auto getGridHeight() const noexcept { return gridHeight; }
+        [[nodiscard]] auto& getDepthParameters() const noexcept { return depthParameters; }
+        [[nodiscard]] auto& getLights() const noexcept { return lights; }
+        [[nodiscard]] auto& getSlices() const noexcept { return slices; }
+
+    private:
+        std::uint32_t gridWidth = 1;
+        std::uint32_t gridHeight = 1;
+        math::Vector<float, 4> depthParameters{}; // near plane, slices per unit, logarithmic
+
+        std::vector<Light> lights;
+        std::vector<Slice> slices = std::vector<Slice>(sliceCount);
+    };
+}
+
+#endif // OUZEL_SCENE_CLUSTERGRID_HPP
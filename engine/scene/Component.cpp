@@ -2,11 +2,13 @@
 
 #include "Component.hpp"
 #include "Actor.hpp"
+#include "StaticBatch.hpp"
 
 namespace ouzel::scene
 {
     Component::~Component()
     {
+        if (staticBatch) staticBatch->removeRenderer(*this);
         if (actor) actor->removeComponent(*this);
     }
 
@@ -17,6 +19,11 @@ namespace ouzel::scene
     {
     }
 
+    void Component::drawDepth(const math::Matrix<float, 4>&,
+                              const math::Matrix<float, 4>&)
+    {
+    }
+
     bool Component::pointOn(const math::Vector<float, 2>& position) const noexcept
     {
         return containsPoint(boundingBox, math::Vector<float, 3>{position});
@@ -11,14 +11,21 @@
 #include "../math/Color.hpp"
 #include "../math/Rect.hpp"
 
+namespace ouzel::graphics
+{
+    class Material;
+}
+
 namespace ouzel::scene
 {
     class Actor;
     class Layer;
+    class StaticBatch;
 
     class Component
     {
         friend Actor;
+        friend StaticBatch;
     public:
         Component() = default;
         virtual ~Component();
@@ -34,6 +41,13 @@ namespace ouzel::scene
                           const math::Matrix<float, 4>& renderViewProjection,
                           bool wireframe);
 
+        // draws only to the depth buffer in the depth pre-pass, components that don't support it are skipped
+        virtual void drawDepth(const math::Matrix<float, 4>& transformMatrix,
+                               const math::Matrix<float, 4>& renderViewProjection);
+
+        // material used for ordering the draws of depth sorted layers, nullptr if the component has none
+        [[nodiscard]] virtual const graphics::Material* getDrawMaterial() const noexcept { return nullptr; }
+
         [[nodiscard]] const auto& getBoundingBox() const noexcept { return boundingBox; }
         void setBoundingBox(const math::Box<float, 3>& newBoundingBox) noexcept
         {
@@ -59,6 +73,9 @@ namespace ouzel::scene
 
         Layer* layer = nullptr;
         Actor* actor = nullptr;
+
+    private:
+        StaticBatch* staticBatch = nullptr; // the batch that draws the geometry of the renderer
     };
 }
 
@@ -0,0 +1,230 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_COMPONENTPOOL_HPP
+#define OUZEL_SCENE_COMPONENTPOOL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+#include "../graphics/Commands.hpp"
+
+namespace ouzel::scene
+{
+    class ComponentPoolBase
+    {
+    public:
+        ComponentPoolBase() = default;
+        virtual ~ComponentPoolBase() = default;
+
+        ComponentPoolBase(const ComponentPoolBase&) = delete;
+        ComponentPoolBase& operator=(const ComponentPoolBase&) = delete;
+
+        ComponentPoolBase(ComponentPoolBase&&) = delete;
+        ComponentPoolBase& operator=(ComponentPoolBase&&) = delete;
+
+        virtual void clear() = 0;
+    };
+
+    // Allocates components of one type in fixed size chunks, so that systems can iterate them linearly
+    // Components never move, they can be attached to actors like components allocated in any other way
+    // Any other type can be pooled the same way
+    template <class T, std::size_t chunkSize = 256>
+    class ComponentPool final: public ComponentPoolBase
+    {
+    public:
+        // refers to a slot of the pool like graphics resource ids do, the slot index in the low bits and
+        // the generation of the slot in the high bits, the handle becomes invalid when the component is destroyed
+        // 0 is never a valid handle
+        using Handle = graphics::ResourceId;
+
+        ComponentPool() = default;
+        ~ComponentPool() override { clear(); }
+
+        template <class ...Args>
+        Handle create(Args&&... args)
+        {
+            std::uint32_t index;
+
+            if (freeSlots.empty())
+            {
+                if (slotCount >= graphics::resourceIndexMask)
+                    throw std::runtime_error{"Too many components in the pool"};
+
+                if (slotCount % chunkSize == 0)
+                    chunks.push_back(std::make_unique<Chunk>());
+
+                index = static_cast<std::uint32_t>(slotCount++);
+            }
+            else
+            {
+                index = freeSlots.back();
+                freeSlots.pop_back();
+            }
+
+            auto& chunk = *chunks[index / chunkSize];
+            const auto slot = index % chunkSize;
+
+            try
+            {
+                new (&chunk.storage[slot]) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                freeSlots.push_back(index);
+                throw;
+            }
+
+            chunk.alive[slot] = true;
+            ++size;
+
+            return graphics::makeResourceId(index, chunk.generations[slot]);
+        }
+
+        void destroy(const Handle& handle)
+        {
+            const auto component = get(handle);
+            if (!component)
+                throw std::runtime_error{"Invalid component handle"};
+
+            const auto index = graphics::getResourceIndex(handle);
+            auto& chunk = *chunks[index / chunkSize];
+            const auto slot = index % chunkSize;
+
+            // the component removes itself from its actor
+            component->~T();
+            chunk.alive[slot] = false;
+            ++chunk.generations[slot];
+            freeSlots.push_back(static_cast<std::uint32_t>(index));
+            --size;
+        }
+
+        // returns nullptr if the component was destroyed
+        T* get(const Handle& handle) const noexcept
+        {
+            const auto index = graphics::getResourceIndex(handle);
+            if (index >= slotCount) return nullptr;
+
+            auto& chunk = *chunks[index / chunkSize];
+            const auto slot = index % chunkSize;
+
+            // the handle keeps only the low bits of the generation if the id is narrower than 64 bits
+            if (!chunk.alive[slot] ||
+                (chunk.generations[slot] & graphics::resourceGenerationMask) != graphics::getResourceGeneration(handle))
+                return nullptr;
+
+            return std::launder(reinterpret_cast<T*>(&chunk.storage[slot]));
+        }
+
+        // calls the function for every live component in the order of the slots
+        // the function can create and destroy components, the destroyed ones are not visited
+        template <class Function>
+        void forEach(Function function) const
+        {
+            for (std::size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex)
+            {
+                auto& chunk = *chunks[chunkIndex];
+                const auto used = std::min(chunkSize, slotCount - chunkIndex * chunkSize);
+
+                for (std::size_t slot = 0; slot < used; ++slot)
+                    if (chunk.alive[slot])
+                        function(*std::launder(reinterpret_cast<T*>(&chunk.storage[slot])));
+            }
+        }
+
+        [[nodiscard]] auto getSize() const noexcept { return size; }
+
+        void clear() override
+        {
+            for (std::size_t index = 0; index < slotCount; ++index)
+            {
+                auto& chunk = *chunks[index / chunkSize];
+                const auto slot = index % chunkSize;
+
+                if (chunk.alive[slot])
+                {
+                    std::launder(reinterpret_cast<T*>(&chunk.storage[slot]))->~T();
+                    chunk.alive[slot] = false;
+                    ++chunk.generations[slot];
+                }
+            }
+
+            // chunks are kept, so that handles from before the clear stay invalid
+            freeSlots.clear();
+            for (auto index = slotCount; index > 0; --index)
+                freeSlots.push_back(static_cast<std::uint32_t>(index - 1));
+
+            size = 0;
+        }
+
+    private:
+        struct Chunk final
+        {
+            std::aligned_storage_t<sizeof(T), alignof(T)> storage[chunkSize];
+            bool alive[chunkSize]{};
+            std::uint32_t generations[chunkSize]{};
+        };
+
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        std::vector<std::uint32_t> freeSlots;
+        std::size_t slotCount = 0;
+        std::size_t size = 0;
+    };
+
+    // Component pools keyed by the type of the component
+    // Pooled components can be destroyed before or after the actors they are attached to
+    class ComponentStorage final
+    {
+    public:
+        template <class T>
+        ComponentPool<T>& getPool()
+        {
+            auto& pool = pools[std::type_index{typeid(T)}];
+            if (!pool) pool = std::make_unique<ComponentPool<T>>();
+
+            return static_cast<ComponentPool<T>&>(*pool);
+        }
+
+        template <class T, class ...Args>
+        auto create(Args&&... args)
+        {
+            return getPool<T>().create(std::forward<Args>(args)...);
+        }
+
+        template <class T>
+        T* get(const typename ComponentPool<T>::Handle& handle)
+        {
+            return getPool<T>().get(handle);
+        }
+
+        template <class T>
+        void destroy(const typename ComponentPool<T>::Handle& handle)
+        {
+            getPool<T>().destroy(handle);
+        }
+
+        template <class T, class Function>
+        void forEach(Function function)
+        {
+            getPool<T>().forEach(function);
+        }
+
+        // destroys all of the components, the pools are kept so that old handles stay invalid
+        void clear()
+        {
+            for (const auto& pool : pools)
+                pool.second->clear();
+        }
+
+    private:
+        std::map<std::type_index, std::unique_ptr<ComponentPoolBase>> pools;
+    };
+}
+
+#endif // OUZEL_SCENE_COMPONENTPOOL_HPP
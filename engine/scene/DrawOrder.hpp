@@ -0,0 +1,71 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_DRAWORDER_HPP
+#define OUZEL_SCENE_DRAWORDER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "../graphics/Material.hpp"
+
+namespace ouzel::scene
+{
+    class Actor;
+
+    // Draw of an actor in a depth sorted layer
+    struct DrawEntry final
+    {
+        Actor* actor;
+        std::int32_t order; // world order of the actor
+        const graphics::Material* material; // of the first component, opaque draws are grouped by it
+        float depth; // of the bounding box center in view space
+        bool transparent;
+        std::int32_t depthBucket = 0;
+    };
+
+    // opaque draws are sorted front to back by buckets that double in depth every two steps
+    // and by material inside a bucket, which keeps most of the early depth rejection with fewer state changes
+    constexpr float depthBucketsPerOctave = 2.0F;
+
+    inline std::int32_t getDepthBucket(float depth) noexcept
+    {
+        return depth > 1.0F ? static_cast<std::int32_t>(std::log2(depth) * depthBucketsPerOctave) : 0;
+    }
+
+    // only materials marked as opaque take part in the front to back sorting and the depth pre-pass
+    inline bool isOpaque(const graphics::Material* material) noexcept
+    {
+        return material && material->opaque;
+    }
+
+    // by world order, then opaque draws front to back and transparent draws back to front
+    inline void sortDrawEntries(std::vector<DrawEntry>& entries)
+    {
+        for (auto& entry : entries)
+            entry.depthBucket = getDepthBucket(entry.depth);
+
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const auto& a, const auto& b) noexcept {
+                             if (a.order != b.order)
+                                 return a.order > b.order;
+
+                             if (a.transparent != b.transparent)
+                                 return b.transparent;
+
+                             if (a.transparent)
+                                 return a.depth > b.depth;
+
+                             if (a.depthBucket != b.depthBucket)
+                                 return a.depthBucket < b.depthBucket;
+
+                             if (a.material != b.material)
+                                 return std::less<const graphics::Material*>{}(a.material, b.material);
+
+                             return a.depth < b.depth;
+                         });
+    }
+}
+
+#endif // OUZEL_SCENE_DRAWORDER_HPP
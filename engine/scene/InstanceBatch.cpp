@@ -0,0 +1,85 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include "InstanceBatch.hpp"
+#include "StaticMeshRenderer.hpp"
+#include "../core/Engine.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::scene
+{
+    void InstanceBatch::begin(const math::Matrix<float, 4>& newRenderViewProjection, bool newWireframe)
+    {
+        groups.clear();
+        usedInstanceBuffers = 0;
+        renderViewProjection = newRenderViewProjection;
+        wireframe = newWireframe;
+    }
+
+    void InstanceBatch::add(const StaticMeshData& meshData,
+                            std::size_t lod,
+                            const graphics::Material& material,
+                            const graphics::Instance& instance)
+    {
+        const auto i = std::find_if(groups.begin(), groups.end(), [&meshData, lod, &material](const auto& group) noexcept {
+            return group.meshData == &meshData && group.lod == lod && group.material == &material;
+        });
+
+        if (i != groups.end())
+            i->instances.push_back(instance);
+        else
+            groups.push_back(Group{&meshData, lod, &material, {instance}});
+    }
+
+    void InstanceBatch::flush()
+    {
+        for (const auto& group : groups)
+        {
+            const auto& material = *group.material;
+            const auto& lod = group.meshData->lods[group.lod];
+
+            if (usedInstanceBuffers == instanceBuffers.size())
+                instanceBuffers.emplace_back(engine->getGraphics(),
+                                             graphics::BufferType::vertex,
+                                             graphics::Flags::dynamic,
+                                             static_cast<std::uint32_t>(getVectorSize(group.instances)));
+
+            auto& instanceBuffer = instanceBuffers[usedInstanceBuffers++];
+
+            const auto instanceData = reinterpret_cast<const std::uint8_t*>(group.instances.data());
+            instanceBuffer.setData(std::vector<std::uint8_t>(instanceData, instanceData + getVectorSize(group.instances)));
+
+            const auto colorVector = {
+                material.diffuseColor.normR(),
+                material.diffuseColor.normG(),
+                material.diffuseColor.normB(),
+                material.diffuseColor.normA() * material.opacity
+            };
+
+            std::vector<std::vector<float>> fragmentShaderConstants(1);
+            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = {std::begin(renderViewProjection.m.v), std::end(renderViewProjection.m.v)};
+
+            const auto textures = material.getTextureResources();
+
+            engine->getGraphics().setPipelineState(material.blendState->getResource(),
+                                                   material.instancedShader->getResource(),
+                                                   material.cullMode,
+                                                   wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
+            engine->getGraphics().setShaderConstants(fragmentShaderConstants, vertexShaderConstants);
+            engine->getGraphics().setTextures(textures);
+            engine->getGraphics().drawInstanced(lod.indexBuffer.getResource(),
+                                                lod.indexCount,
+                                                lod.indexSize,
+                                                lod.vertexBuffer.getResource(),
+                                                instanceBuffer.getResource(),
+                                                static_cast<std::uint32_t>(group.instances.size()),
+                                                graphics::DrawMode::triangleList,
+                                                0);
+        }
+
+        groups.clear();
+    }
+}
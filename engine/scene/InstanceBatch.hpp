@@ -0,0 +1,47 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_INSTANCEBATCH_HPP
+#define OUZEL_SCENE_INSTANCEBATCH_HPP
+
+#include <cstddef>
+#include <vector>
+#include "../graphics/Buffer.hpp"
+#include "../graphics/Instance.hpp"
+#include "../graphics/Material.hpp"
+#include "../math/Matrix.hpp"
+
+namespace ouzel::scene
+{
+    class StaticMeshData;
+
+    // Collects the meshes that share mesh data, level of detail and material during a camera pass and draws them with one instanced draw call
+    // The batches are drawn at the end of the pass, so only opaque meshes are added to them
+    class InstanceBatch final
+    {
+    public:
+        void begin(const math::Matrix<float, 4>& newRenderViewProjection, bool newWireframe);
+        void add(const StaticMeshData& meshData,
+                 std::size_t lod,
+                 const graphics::Material& material,
+                 const graphics::Instance& instance);
+        void flush();
+
+    private:
+        struct Group final
+        {
+            const StaticMeshData* meshData;
+            std::size_t lod;
+            const graphics::Material* material;
+            std::vector<graphics::Instance> instances;
+        };
+
+        math::Matrix<float, 4> renderViewProjection = math::identityMatrix<float, 4>;
+        bool wireframe = false;
+
+        std::vector<Group> groups;
+        std::vector<graphics::Buffer> instanceBuffers;
+        std::size_t usedInstanceBuffers = 0;
+    };
+}
+
+#endif // OUZEL_SCENE_INSTANCEBATCH_HPP
@@ -2,15 +2,43 @@
 
 #include <cassert>
 #include <algorithm>
+#include <cmath>
 #include "Layer.hpp"
 #include "Scene.hpp"
 #include "Component.hpp"
 #include "../core/Engine.hpp"
 #include "../graphics/Graphics.hpp"
+#include "../math/ConvexVolume.hpp"
 #include "../math/Matrix.hpp"
 
 namespace ouzel::scene
 {
+    namespace
+    {
+        // axis aligned box that encloses the transformed box
+        math::Box<float, 3> transformBox(const math::Matrix<float, 4>& transform, const math::Box<float, 3>& box) noexcept
+        {
+            if (isEmpty(box)) return box;
+
+            auto center = box.getCenter();
+            transformPoint(transform, center);
+
+            math::Box<float, 3> result{center, center};
+
+            for (std::size_t row = 0; row < 3; ++row)
+            {
+                float extent = 0.0F;
+                for (std::size_t column = 0; column < 3; ++column)
+                    extent += std::fabs(transform.m.v[column * 4 + row]) * (box.max.v[column] - box.min.v[column]) / 2.0F;
+
+                result.min.v[row] -= extent;
+                result.max.v[row] += extent;
+            }
+
+            return result;
+        }
+    }
+
     Layer::Layer()
     {
         layer = this;
@@ -25,18 +53,118 @@ namespace ouzel::scene
     {
         for (const auto camera : cameras)
         {
-            std::vector<Actor*> drawQueue;
+            drawQueue.clear();
 
             for (const auto actor : children)
                 actor->visit(drawQueue, math::identityMatrix<float, 4>, false, camera, 0, false);
 
+            cullDrawQueue(*camera);
+            sortDrawQueue(*camera);
+            lightClusters.update(*camera, lights);
+
             engine->getGraphics().setRenderTarget(camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0);
             engine->getGraphics().setViewport(camera->getRenderViewport());
             engine->getGraphics().setDepthStencilState(camera->getDepthStencilState() ? camera->getDepthStencilState()->getResource() : 0,
                                                         camera->getStencilReferenceValue());
 
+            currentCamera = camera;
+            depthPrePassActive = sortMode == SortMode::depth && depthPrePass && camera->getDepthTest();
+
+            if (depthPrePassActive)
+                for (const auto actor : opaqueQueue)
+                    actor->drawDepth(camera);
+
+            instanceBatch.begin(camera->getRenderViewProjection(), camera->getWireframe());
+
             for (const auto actor : drawQueue)
                 actor->draw(camera, camera->getWireframe());
+
+            // batched meshes are drawn after the rest of the pass
+            instanceBatch.flush();
+        }
+
+        currentCamera = nullptr;
+        depthPrePassActive = false;
+    }
+
+    void Layer::cullDrawQueue(const Camera& camera)
+    {
+        boundingBoxes.clear();
+        for (const auto actor : drawQueue)
+            boundingBoxes.push_back(transformBox(actor->getTransform(), actor->getBoundingBox()));
+
+        math::cullBoxes(camera.getCullingVolume(), boundingBoxes.data(), boundingBoxes.size(), visibility);
+
+        std::size_t visibleCount = 0;
+        for (std::size_t i = 0; i < drawQueue.size(); ++i)
+        {
+            const auto actor = drawQueue[i];
+            const auto visible = (visibility[i / 32] >> (i % 32)) & 1U;
+
+            if (actor->cullDisabled || (visible && !isEmpty(boundingBoxes[i])))
+            {
+                boundingBoxes[visibleCount] = boundingBoxes[i];
+                drawQueue[visibleCount++] = actor;
+            }
+        }
+
+        drawQueue.resize(visibleCount);
+        boundingBoxes.resize(visibleCount);
+    }
+
+    void Layer::sortDrawQueue(const Camera& camera)
+    {
+        opaqueQueue.clear();
+
+        if (sortMode == SortMode::order)
+        {
+            // actors with the same order are drawn in the order they were visited
+            std::stable_sort(drawQueue.begin(), drawQueue.end(),
+                             [](const auto a, const auto b) noexcept {
+                                 return a->worldOrder > b->worldOrder;
+                             });
+            return;
+        }
+
+        const auto cameraActor = camera.getActor();
+        const auto& viewMatrix = cameraActor ? cameraActor->getInverseTransform() : math::identityMatrix<float, 4>;
+
+        drawEntries.clear();
+        for (std::size_t i = 0; i < drawQueue.size(); ++i)
+        {
+            const auto actor = drawQueue[i];
+
+            // actors with culling disabled can have an empty bounding box
+            auto center = isEmpty(boundingBoxes[i]) ? actor->getWorldPosition() : boundingBoxes[i].getCenter();
+            transformPoint(viewMatrix, center);
+
+            DrawEntry entry{actor, actor->worldOrder, nullptr, -center.v[2], actor->getOpacity() < 1.0F};
+
+            // components without a material or with a material that isn't opaque are drawn back to front
+            for (const auto component : actor->getComponents())
+                if (!component->isHidden())
+                {
+                    const auto material = component->getDrawMaterial();
+
+                    if (!isOpaque(material))
+                        entry.transparent = true;
+                    else if (!entry.material)
+                        entry.material = material;
+                }
+
+            if (!entry.material) entry.transparent = true;
+
+            drawEntries.push_back(entry);
+        }
+
+        sortDrawEntries(drawEntries);
+
+        for (std::size_t i = 0; i < drawEntries.size(); ++i)
+        {
+            drawQueue[i] = drawEntries[i].actor;
+
+            if (!drawEntries[i].transparent)
+                opaqueQueue.push_back(drawEntries[i].actor);
         }
     }
 
@@ -7,7 +7,11 @@
 #include <vector>
 #include "Actor.hpp"
 #include "Camera.hpp"
+#include "DrawOrder.hpp"
+#include "InstanceBatch.hpp"
 #include "Light.hpp"
+#include "LightClusters.hpp"
+#include "../math/Box.hpp"
 #include "../math/Vector.hpp"
 
 namespace ouzel::scene
@@ -22,6 +26,12 @@ namespace ouzel::scene
     public:
         using Order = std::int32_t;
 
+        enum class SortMode
+        {
+            order, // by the world order, actors with the same order in the order they were visited
+            depth // by the world order, then opaque actors front to back and transparent actors back to front
+        };
+
         Layer();
         ~Layer() override;
 
@@ -30,11 +40,27 @@ namespace ouzel::scene
         void addChild(Actor& actor) override;
 
         auto& getCameras() const noexcept { return cameras; }
+        // the camera whose pass is being drawn
+        [[nodiscard]] auto getCurrentCamera() const noexcept { return currentCamera; }
+
+        auto& getInstanceBatch() noexcept { return instanceBatch; }
+        // lights binned for the camera whose pass is being drawn
+        auto& getLightClusters() const noexcept { return lightClusters; }
 
         std::pair<Actor*, math::Vector<float, 3>> pickActor(const math::Vector<float, 2>& position, bool renderTargets = false) const;
         std::vector<std::pair<Actor*, math::Vector<float, 3>>> pickActors(const math::Vector<float, 2>& position, bool renderTargets = false) const;
         std::vector<Actor*> pickActors(const std::vector<math::Vector<float, 2>>& edges, bool renderTargets = false) const;
 
+        [[nodiscard]] auto getSortMode() const noexcept { return sortMode; }
+        void setSortMode(SortMode newSortMode) noexcept { sortMode = newSortMode; }
+
+        // opaque actors are drawn to the depth buffer before the main pass, so that heavy shaders run only for visible fragments
+        // used in the depth sort mode for cameras with depth test
+        [[nodiscard]] auto getDepthPrePass() const noexcept { return depthPrePass; }
+        void setDepthPrePass(bool newDepthPrePass) noexcept { depthPrePass = newDepthPrePass; }
+        // true while drawing the main pass after a depth pre-pass
+        [[nodiscard]] auto isDepthPrePassActive() const noexcept { return depthPrePassActive; }
+
         [[nodiscard]] auto getOrder() const noexcept { return order; }
         void setOrder(Order newOrder) noexcept;
 
@@ -54,9 +80,27 @@ namespace ouzel::scene
         Scene* scene = nullptr;
 
         std::vector<Camera*> cameras;
+        Camera* currentCamera = nullptr;
         std::vector<Light*> lights;
 
+        InstanceBatch instanceBatch;
+        LightClusters lightClusters;
+
+    private:
+        void cullDrawQueue(const Camera& camera);
+        void sortDrawQueue(const Camera& camera);
+
+        // kept between frames to avoid reallocating them
+        std::vector<Actor*> drawQueue;
+        std::vector<Actor*> opaqueQueue;
+        std::vector<DrawEntry> drawEntries;
+        std::vector<math::Box<float, 3>> boundingBoxes;
+        std::vector<std::uint32_t> visibility;
+
         Order order = 0;
+        SortMode sortMode = SortMode::order;
+        bool depthPrePass = false;
+        bool depthPrePassActive = false;
     };
 }
 
@@ -18,10 +18,10 @@ namespace ouzel::scene
 
     void Light::setLayer(Layer* newLayer)
     {
-        if (layer) layer->addLight(*this);
+        if (layer) layer->removeLight(*this);
 
         Component::setLayer(newLayer);
 
-        if (layer) layer->removeLight(*this);
+        if (layer) layer->addLight(*this);
     }
 }
@@ -46,8 +46,8 @@ namespace ouzel::scene
 
         Type type = Type::point;
         math::Color color = math::whiteColor;
-        math::Quaternion<float> direction = math::identityQuaternion<float>; // for spot and directional light
-        float angle = 0.0F; // for spot light
+        math::Quaternion<float> direction = math::identityQuaternion<float>; // rotation of the forward vector, for spot and directional light
+        float angle = 0.0F; // angle of the cone, for spot light
         float range = 0.0F; // for point and spot light
         float intensity = 1.0F;
     };
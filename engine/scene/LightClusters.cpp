@@ -0,0 +1,199 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <utility>
+#include "LightClusters.hpp"
+#include "Actor.hpp"
+#include "Camera.hpp"
+#include "Light.hpp"
+#include "../core/Engine.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        constexpr std::size_t parallelLightCount = 64; // with more point and spot lights the slices are binned on the worker pool
+        constexpr std::uint32_t sliceTaskCount = 5; // the calling thread bins slices as well
+
+        float getTypeValue(Light::Type type) noexcept
+        {
+            switch (type)
+            {
+                case Light::Type::point: return 0.0F;
+                case Light::Type::spot: return 1.0F;
+                case Light::Type::directional: return 2.0F;
+                default: return 0.0F;
+            }
+        }
+    }
+
+    void LightClusters::update(const Camera& camera, const std::vector<Light*>& lights)
+    {
+        active = false;
+        grid.clearLights();
+        lightData.clear();
+        directionalLightCount = 0;
+
+        // only the OpenGL drivers have the lit shaders, so the lights are not binned for the others
+        const auto& viewport = camera.getRenderViewport();
+        if (lights.empty() || viewport.size.v[0] <= 0.0F || viewport.size.v[1] <= 0.0F ||
+            !engine->getCache().getShader(shaderTextureLit))
+            return;
+
+        const auto cameraActor = camera.getActor();
+        viewMatrix = cameraActor ? cameraActor->getInverseTransform() : math::identityMatrix<float, 4>;
+
+        const auto addLight = [this](const Light& light) {
+            const auto& transform = light.getActor()->getTransform();
+
+            math::Vector<float, 3> position{};
+            transformPoint(transform, position);
+            transformPoint(viewMatrix, position);
+
+            auto direction = math::getForwardVector(light.getDirection());
+            transformVector(transform, direction);
+            transformVector(viewMatrix, direction);
+            math::normalize(direction);
+
+            const auto color = light.getColor();
+            const auto intensity = light.getIntensity();
+
+            lightData.insert(lightData.end(), std::initializer_list<float>{
+                position.v[0], position.v[1], position.v[2], light.getRange(),
+                color.normR() * intensity, color.normG() * intensity, color.normB() * intensity, getTypeValue(light.getType()),
+                direction.v[0], direction.v[1], direction.v[2], std::cos(light.getAngle() / 2.0F)
+            });
+
+            return std::pair{position, direction};
+        };
+
+        // directional lights are stored first, because they light every fragment
+        for (const auto light : lights)
+            if (light->getActor() && !light->isHidden() &&
+                light->getType() == Light::Type::directional)
+            {
+                addLight(*light);
+                ++directionalLightCount;
+            }
+
+        for (const auto light : lights)
+            if (light->getActor() && !light->isHidden() &&
+                light->getType() != Light::Type::directional &&
+                light->getRange() > 0.0F)
+            {
+                const auto index = static_cast<std::uint32_t>(lightData.size() / 12);
+                const auto [position, direction] = addLight(*light);
+
+                if (light->getType() == Light::Type::spot)
+                    grid.addSpotLight(position, direction, light->getRange(), light->getAngle(), index);
+                else
+                    grid.addPointLight(position, light->getRange(), index);
+            }
+
+        if (lightData.empty()) return;
+
+        active = true;
+
+        viewportParameters = math::Vector<float, 4>{
+            viewport.position.v[0],
+            viewport.position.v[1],
+            1.0F / ClusterGrid::tileSize,
+            1.0F / ClusterGrid::tileSize
+        };
+
+        const auto projection = engine->getGraphics().getDevice()->getProjectionTransform(camera.getRenderTarget() != nullptr) *
+            camera.getProjection();
+        grid.setViewport(viewport.size, projection, camera.getNearPlane(), camera.getFarPlane());
+
+        if (grid.getLights().size() < parallelLightCount)
+        {
+            for (std::uint32_t z = 0; z < ClusterGrid::sliceCount; ++z)
+                grid.binSlice(z);
+        }
+        else
+        {
+            struct State final
+            {
+                std::atomic<std::uint32_t> nextSlice{0};
+                std::uint32_t finishedSlices = 0;
+                std::mutex mutex;
+                std::condition_variable condition;
+            };
+
+            auto state = std::make_shared<State>();
+
+            // tasks that start after all the slices are taken return without touching this object
+            const auto run = [this, state]() {
+                for (auto z = state->nextSlice++; z < ClusterGrid::sliceCount; z = state->nextSlice++)
+                {
+                    grid.binSlice(z);
+
+                    std::unique_lock lock{state->mutex};
+                    if (++state->finishedSlices == ClusterGrid::sliceCount)
+                    {
+                        lock.unlock();
+                        state->condition.notify_all();
+                    }
+                }
+            };
+
+            core::TaskGroup taskGroup;
+            for (std::uint32_t i = 0; i < sliceTaskCount; ++i)
+                taskGroup.add(run);
+            engine->getWorkerPool().run(std::move(taskGroup));
+
+            run();
+
+            std::unique_lock lock{state->mutex};
+            state->condition.wait(lock, [&state]() noexcept { return state->finishedSlices == ClusterGrid::sliceCount; });
+        }
+
+        grid.getClusterData(clusterData);
+
+        uploadData(lightTexture, lightData);
+        uploadData(clusterTexture, clusterData);
+    }
+
+    void LightClusters::getShaderConstants(std::vector<std::vector<float>>& fragmentShaderConstants) const
+    {
+        fragmentShaderConstants.push_back({
+            static_cast<float>(grid.getGridWidth()),
+            static_cast<float>(grid.getGridHeight()),
+            static_cast<float>(ClusterGrid::sliceCount),
+            static_cast<float>(directionalLightCount)
+        });
+        fragmentShaderConstants.emplace_back(std::begin(viewportParameters.v), std::end(viewportParameters.v));
+        fragmentShaderConstants.emplace_back(std::begin(grid.getDepthParameters().v), std::end(grid.getDepthParameters().v));
+    }
+
+    void LightClusters::uploadData(std::unique_ptr<graphics::Texture>& texture, std::vector<float>& data)
+    {
+        const auto texelCount = std::max<std::size_t>(data.size() / 4, 1);
+        const auto height = static_cast<std::uint32_t>((texelCount + dataWidth - 1) / dataWidth);
+
+        // the texture is recreated only when it has to grow
+        if (!texture || texture->getSize().v[1] < height)
+        {
+            std::uint32_t textureHeight = 1;
+            while (textureHeight < height) textureHeight <<= 1;
+
+            texture = std::make_unique<graphics::Texture>(engine->getGraphics(),
+                                                          math::Size<std::uint32_t, 2>{dataWidth, textureHeight},
+                                                          graphics::Flags::dynamic,
+                                                          1, 1,
+                                                          graphics::PixelFormat::rgba32Float);
+        }
+
+        data.resize(static_cast<std::size_t>(dataWidth) * texture->getSize().v[1] * 4);
+
+        std::vector<std::uint8_t> bytes(data.size() * sizeof(float));
+        std::memcpy(bytes.data(), data.data(), bytes.size());
+        texture->setData(bytes);
+    }
+}
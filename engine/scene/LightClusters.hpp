@@ -0,0 +1,66 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_LIGHTCLUSTERS_HPP
+#define OUZEL_SCENE_LIGHTCLUSTERS_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ClusterGrid.hpp"
+#include "../graphics/Texture.hpp"
+#include "../math/Matrix.hpp"
+#include "../math/Vector.hpp"
+
+namespace ouzel::scene
+{
+    class Camera;
+    class Light;
+
+    // Bins the lights of a layer into view space clusters for forward shading
+    // The viewport is split into tiles and the depth range into slices, every cluster lists the point and spot lights that reach it
+    class LightClusters final
+    {
+    public:
+        static constexpr std::uint32_t dataWidth = 1024; // width of the data textures in texels
+
+        LightClusters() = default;
+
+        LightClusters(const LightClusters&) = delete;
+        LightClusters& operator=(const LightClusters&) = delete;
+
+        LightClusters(LightClusters&&) = delete;
+        LightClusters& operator=(LightClusters&&) = delete;
+
+        // bins the lights for the camera and uploads the data textures
+        void update(const Camera& camera, const std::vector<Light*>& lights);
+
+        // false if there were no lights to bin in the last update
+        [[nodiscard]] auto isActive() const noexcept { return active; }
+
+        [[nodiscard]] auto& getViewMatrix() const noexcept { return viewMatrix; }
+
+        // light data and cluster light lists, lit shaders read them from the second and third texture layer
+        [[nodiscard]] auto& getLightTexture() const noexcept { return lightTexture; }
+        [[nodiscard]] auto& getClusterTexture() const noexcept { return clusterTexture; }
+
+        // appends the clusterGrid, clusterViewport and clusterDepth constants of the lit shaders
+        void getShaderConstants(std::vector<std::vector<float>>& fragmentShaderConstants) const;
+
+    private:
+        static void uploadData(std::unique_ptr<graphics::Texture>& texture, std::vector<float>& data);
+
+        bool active = false;
+        math::Matrix<float, 4> viewMatrix = math::identityMatrix<float, 4>;
+
+        std::uint32_t directionalLightCount = 0;
+        math::Vector<float, 4> viewportParameters{}; // position of the viewport and inverse tile size in pixels
+        ClusterGrid grid;
+
+        std::vector<float> lightData;
+        std::vector<float> clusterData;
+        std::unique_ptr<graphics::Texture> lightTexture;
+        std::unique_ptr<graphics::Texture> clusterTexture;
+    };
+}
+
+#endif // OUZEL_SCENE_LIGHTCLUSTERS_HPP
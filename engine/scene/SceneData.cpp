@@ -0,0 +1,297 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstring>
+#include <stdexcept>
+#include "SceneData.hpp"
+#include "../formats/Obf.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        // keys of the root object
+        constexpr std::uint32_t versionKey = 0;
+        constexpr std::uint32_t referencesKey = 1;
+        constexpr std::uint32_t actorsKey = 2;
+        constexpr std::uint32_t staticMeshRenderersKey = 3;
+        constexpr std::uint32_t spriteRenderersKey = 4;
+        constexpr std::uint32_t particleSystemsKey = 5;
+        constexpr std::uint32_t lightsKey = 6;
+
+        // number of 32-bit words in the records
+        constexpr std::size_t actorRecordSize = 14;
+        constexpr std::size_t staticMeshRendererRecordSize = 3;
+        constexpr std::size_t spriteRendererRecordSize = 2;
+        constexpr std::size_t particleSystemRecordSize = 2;
+        constexpr std::size_t lightRecordSize = 10;
+
+        constexpr std::uint32_t hiddenFlag = 0x01;
+        constexpr std::uint32_t pickableFlag = 0x02;
+        constexpr std::uint32_t cullDisabledFlag = 0x04;
+
+        void writeUInt32(std::vector<std::uint8_t>& buffer, std::uint32_t value)
+        {
+            const auto offset = buffer.size();
+            buffer.resize(offset + sizeof(value));
+            encodeBigEndian<std::uint32_t>(buffer.data() + offset, value);
+        }
+
+        void writeFloat(std::vector<std::uint8_t>& buffer, float value)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            writeUInt32(buffer, bits);
+        }
+
+        std::uint32_t readUInt32(const std::vector<std::uint8_t>& buffer, std::size_t& offset) noexcept
+        {
+            const auto result = decodeBigEndian<std::uint32_t>(buffer.data() + offset);
+            offset += sizeof(result);
+            return result;
+        }
+
+        float readFloat(const std::vector<std::uint8_t>& buffer, std::size_t& offset) noexcept
+        {
+            const auto bits = readUInt32(buffer, offset);
+            float result;
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        // returns an empty buffer if the section is missing, which lets older files skip newer sections
+        const std::vector<std::uint8_t>& getRecords(const obf::Value& root,
+                                                    std::uint32_t key,
+                                                    std::size_t recordSize,
+                                                    std::size_t& count)
+        {
+            static const std::vector<std::uint8_t> empty;
+
+            if (!root.hasElement(key))
+            {
+                count = 0;
+                return empty;
+            }
+
+            const auto& buffer = root[key].as<obf::Value::ByteArray>();
+            const auto recordBytes = recordSize * sizeof(std::uint32_t);
+
+            if (buffer.size() % recordBytes != 0)
+                throw std::runtime_error{"Invalid scene record data"};
+
+            count = buffer.size() / recordBytes;
+            return buffer;
+        }
+
+        void checkReference(std::uint32_t reference, std::size_t referenceCount)
+        {
+            if (reference != SceneData::none && reference >= referenceCount)
+                throw std::runtime_error{"Invalid scene asset reference"};
+        }
+
+        void checkActor(std::uint32_t actor, std::size_t actorCount)
+        {
+            if (actor >= actorCount)
+                throw std::runtime_error{"Invalid scene component actor"};
+        }
+
+        Light::Type getLightType(std::uint32_t value)
+        {
+            switch (value)
+            {
+                case static_cast<std::uint32_t>(Light::Type::point): return Light::Type::point;
+                case static_cast<std::uint32_t>(Light::Type::spot): return Light::Type::spot;
+                case static_cast<std::uint32_t>(Light::Type::directional): return Light::Type::directional;
+                default: throw std::runtime_error{"Invalid scene light type"};
+            }
+        }
+    }
+
+    SceneData::SceneData(const std::vector<std::uint8_t>& data)
+    {
+        obf::Value root;
+        root.decode(data, 0);
+
+        if (root[versionKey].as<std::uint32_t>() > version)
+            throw std::runtime_error{"Unsupported scene version"};
+
+        if (root.hasElement(referencesKey))
+        {
+            const auto& referenceValues = root[referencesKey].as<obf::Value::Array>();
+            references.reserve(referenceValues.size());
+
+            for (const auto& referenceValue : referenceValues)
+                references.push_back(Reference{
+                    static_cast<assets::Asset::Type>(referenceValue[0].as<std::uint32_t>()),
+                    referenceValue[1].as<std::string>()
+                });
+        }
+
+        std::size_t count;
+        std::size_t offset = 0;
+
+        const auto& actorBuffer = getRecords(root, actorsKey, actorRecordSize, count);
+        actors.resize(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto& actor = actors[i];
+            actor.parent = readUInt32(actorBuffer, offset);
+
+            if (actor.parent != none && actor.parent >= i)
+                throw std::runtime_error{"Invalid scene actor parent"};
+
+            for (auto& value : actor.position.v) value = readFloat(actorBuffer, offset);
+            for (auto& value : actor.rotation.v) value = readFloat(actorBuffer, offset);
+            for (auto& value : actor.scale.v) value = readFloat(actorBuffer, offset);
+            actor.opacity = readFloat(actorBuffer, offset);
+            actor.order = static_cast<Actor::Order>(readUInt32(actorBuffer, offset));
+
+            const auto flags = readUInt32(actorBuffer, offset);
+            actor.hidden = (flags & hiddenFlag) != 0;
+            actor.pickable = (flags & pickableFlag) != 0;
+            actor.cullDisabled = (flags & cullDisabledFlag) != 0;
+        }
+
+        offset = 0;
+        const auto& staticMeshRendererBuffer = getRecords(root, staticMeshRenderersKey, staticMeshRendererRecordSize, count);
+        staticMeshRenderers.resize(count);
+
+        for (auto& record : staticMeshRenderers)
+        {
+            record.actor = readUInt32(staticMeshRendererBuffer, offset);
+            record.meshData = readUInt32(staticMeshRendererBuffer, offset);
+            record.material = readUInt32(staticMeshRendererBuffer, offset);
+
+            checkActor(record.actor, actors.size());
+            checkReference(record.meshData, references.size());
+            checkReference(record.material, references.size());
+        }
+
+        offset = 0;
+        const auto& spriteRendererBuffer = getRecords(root, spriteRenderersKey, spriteRendererRecordSize, count);
+        spriteRenderers.resize(count);
+
+        for (auto& record : spriteRenderers)
+        {
+            record.actor = readUInt32(spriteRendererBuffer, offset);
+            record.spriteData = readUInt32(spriteRendererBuffer, offset);
+
+            checkActor(record.actor, actors.size());
+            checkReference(record.spriteData, references.size());
+        }
+
+        offset = 0;
+        const auto& particleSystemBuffer = getRecords(root, particleSystemsKey, particleSystemRecordSize, count);
+        particleSystems.resize(count);
+
+        for (auto& record : particleSystems)
+        {
+            record.actor = readUInt32(particleSystemBuffer, offset);
+            record.particleSystemData = readUInt32(particleSystemBuffer, offset);
+
+            checkActor(record.actor, actors.size());
+            checkReference(record.particleSystemData, references.size());
+        }
+
+        offset = 0;
+        const auto& lightBuffer = getRecords(root, lightsKey, lightRecordSize, count);
+        lights.resize(count);
+
+        for (auto& record : lights)
+        {
+            record.actor = readUInt32(lightBuffer, offset);
+            record.type = getLightType(readUInt32(lightBuffer, offset));
+            record.color = math::Color{readUInt32(lightBuffer, offset)};
+            for (auto& value : record.direction.v) value = readFloat(lightBuffer, offset);
+            record.angle = readFloat(lightBuffer, offset);
+            record.range = readFloat(lightBuffer, offset);
+            record.intensity = readFloat(lightBuffer, offset);
+
+            checkActor(record.actor, actors.size());
+        }
+    }
+
+    std::vector<std::uint8_t> SceneData::encode() const
+    {
+        obf::Value root{obf::Type::object};
+        root[versionKey] = version;
+
+        obf::Value::Array referenceValues;
+        referenceValues.reserve(references.size());
+        for (const auto& reference : references)
+            referenceValues.push_back(obf::Value::Array{
+                obf::Value{static_cast<std::uint32_t>(reference.type)},
+                obf::Value{reference.name}
+            });
+        root[referencesKey] = referenceValues;
+
+        obf::Value::ByteArray buffer;
+        buffer.reserve(actors.size() * actorRecordSize * sizeof(std::uint32_t));
+        for (const auto& actor : actors)
+        {
+            writeUInt32(buffer, actor.parent);
+            for (const auto value : actor.position.v) writeFloat(buffer, value);
+            for (const auto value : actor.rotation.v) writeFloat(buffer, value);
+            for (const auto value : actor.scale.v) writeFloat(buffer, value);
+            writeFloat(buffer, actor.opacity);
+            writeUInt32(buffer, static_cast<std::uint32_t>(actor.order));
+            writeUInt32(buffer, (actor.hidden ? hiddenFlag : 0U) |
+                        (actor.pickable ? pickableFlag : 0U) |
+                        (actor.cullDisabled ? cullDisabledFlag : 0U));
+        }
+        root[actorsKey] = buffer;
+
+        buffer.clear();
+        for (const auto& record : staticMeshRenderers)
+        {
+            writeUInt32(buffer, record.actor);
+            writeUInt32(buffer, record.meshData);
+            writeUInt32(buffer, record.material);
+        }
+        root[staticMeshRenderersKey] = buffer;
+
+        buffer.clear();
+        for (const auto& record : spriteRenderers)
+        {
+            writeUInt32(buffer, record.actor);
+            writeUInt32(buffer, record.spriteData);
+        }
+        root[spriteRenderersKey] = buffer;
+
+        buffer.clear();
+        for (const auto& record : particleSystems)
+        {
+            writeUInt32(buffer, record.actor);
+            writeUInt32(buffer, record.particleSystemData);
+        }
+        root[particleSystemsKey] = buffer;
+
+        buffer.clear();
+        for (const auto& record : lights)
+        {
+            writeUInt32(buffer, record.actor);
+            writeUInt32(buffer, static_cast<std::uint32_t>(record.type));
+            writeUInt32(buffer, record.color.getIntValue());
+            for (const auto value : record.direction.v) writeFloat(buffer, value);
+            writeFloat(buffer, record.angle);
+            writeFloat(buffer, record.range);
+            writeFloat(buffer, record.intensity);
+        }
+        root[lightsKey] = buffer;
+
+        std::vector<std::uint8_t> result;
+        root.encode(result);
+        return result;
+    }
+
+    std::uint32_t SceneData::addReference(assets::Asset::Type type, const std::string& name)
+    {
+        for (std::uint32_t i = 0; i < references.size(); ++i)
+            if (references[i].type == type && references[i].name == name)
+                return i;
+
+        references.push_back(Reference{type, name});
+        return static_cast<std::uint32_t>(references.size() - 1);
+    }
+}
@@ -0,0 +1,93 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_SCENEDATA_HPP
+#define OUZEL_SCENE_SCENEDATA_HPP
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Actor.hpp"
+#include "Light.hpp"
+#include "../assets/Asset.hpp"
+#include "../math/Color.hpp"
+#include "../math/Quaternion.hpp"
+#include "../math/Vector.hpp"
+
+namespace ouzel::scene
+{
+    // Actor hierarchy of a level or a sub-scene in the binary scene format
+    // The file is an obf object, actors and components are packed into byte arrays of fixed size records
+    class SceneData final
+    {
+    public:
+        static constexpr std::uint32_t version = 1;
+        static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max(); // no parent or no asset
+
+        struct Reference final
+        {
+            assets::Asset::Type type;
+            std::string name;
+        };
+
+        struct ActorRecord final
+        {
+            std::uint32_t parent = none; // parents are stored before their children
+            math::Vector<float, 3> position{};
+            math::Quaternion<float> rotation = math::identityQuaternion<float>;
+            math::Vector<float, 3> scale = math::Vector<float, 3>{1.0F, 1.0F, 1.0F};
+            float opacity = 1.0F;
+            Actor::Order order = 0;
+            bool hidden = false;
+            bool pickable = false;
+            bool cullDisabled = false;
+        };
+
+        struct StaticMeshRendererRecord final
+        {
+            std::uint32_t actor = 0;
+            std::uint32_t meshData = none; // index in the references
+            std::uint32_t material = none; // overrides the material of the mesh
+        };
+
+        struct SpriteRendererRecord final
+        {
+            std::uint32_t actor = 0;
+            std::uint32_t spriteData = none;
+        };
+
+        struct ParticleSystemRecord final
+        {
+            std::uint32_t actor = 0;
+            std::uint32_t particleSystemData = none;
+        };
+
+        struct LightRecord final
+        {
+            std::uint32_t actor = 0;
+            Light::Type type = Light::Type::point;
+            math::Color color = math::whiteColor;
+            math::Quaternion<float> direction = math::identityQuaternion<float>;
+            float angle = 0.0F;
+            float range = 0.0F;
+            float intensity = 1.0F;
+        };
+
+        SceneData() = default;
+        explicit SceneData(const std::vector<std::uint8_t>& data);
+
+        std::vector<std::uint8_t> encode() const;
+
+        // adds the asset to the reference table if it is not there yet
+        std::uint32_t addReference(assets::Asset::Type type, const std::string& name);
+
+        std::vector<Reference> references;
+        std::vector<ActorRecord> actors;
+        std::vector<StaticMeshRendererRecord> staticMeshRenderers;
+        std::vector<SpriteRendererRecord> spriteRenderers;
+        std::vector<ParticleSystemRecord> particleSystems;
+        std::vector<LightRecord> lights;
+    };
+}
+
+#endif // OUZEL_SCENE_SCENEDATA_HPP
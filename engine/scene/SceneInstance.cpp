@@ -0,0 +1,162 @@
+// Ouzel by Elviss Strazdins
+
+#include <stdexcept>
+#include "SceneInstance.hpp"
+#include "../assets/Cache.hpp"
+#include "../core/Engine.hpp"
+
+namespace ouzel::scene
+{
+    SceneInstance::SceneInstance(const SceneData& data, const assets::Cache& cache):
+        actorCount{data.actors.size()},
+        actors{std::make_unique<Actor[]>(data.actors.size())},
+        staticMeshRenderers{std::make_unique<StaticMeshRenderer[]>(data.staticMeshRenderers.size())},
+        spriteRenderers{std::make_unique<SpriteRenderer[]>(data.spriteRenderers.size())},
+        particleSystems{std::make_unique<ParticleSystem[]>(data.particleSystems.size())},
+        lights{std::make_unique<Light[]>(data.lights.size())}
+    {
+        // every asset is looked up only once, no matter how many components use it
+        std::vector<const void*> resolvedAssets(data.references.size());
+
+        for (std::size_t i = 0; i < data.references.size(); ++i)
+        {
+            const auto& reference = data.references[i];
+
+            switch (reference.type)
+            {
+                case assets::Asset::Type::staticMesh: resolvedAssets[i] = cache.getStaticMeshData(reference.name); break;
+                case assets::Asset::Type::material: resolvedAssets[i] = cache.getMaterial(reference.name); break;
+                case assets::Asset::Type::sprite: resolvedAssets[i] = cache.getSpriteData(reference.name); break;
+                case assets::Asset::Type::particleSystem: resolvedAssets[i] = cache.getParticleSystemData(reference.name); break;
+                default: throw std::runtime_error{"Unsupported scene asset type"};
+            }
+
+            if (!resolvedAssets[i])
+                throw std::runtime_error{"Scene asset " + reference.name + " is not loaded"};
+        }
+
+        const auto getAsset = [&data, &resolvedAssets](std::uint32_t reference, assets::Asset::Type type) {
+            if (reference == SceneData::none)
+                throw std::runtime_error{"Scene component is missing an asset"};
+
+            if (data.references[reference].type != type)
+                throw std::runtime_error{"Scene asset " + data.references[reference].name + " has a wrong type"};
+
+            return resolvedAssets[reference];
+        };
+
+        for (std::size_t i = 0; i < actorCount; ++i)
+        {
+            const auto& record = data.actors[i];
+            auto& actor = actors[i];
+
+            actor.setPosition(record.position);
+            actor.setRotation(record.rotation);
+            actor.setScale(record.scale);
+            actor.setOpacity(record.opacity);
+            actor.setOrder(record.order);
+            actor.setHidden(record.hidden);
+            actor.setPickable(record.pickable);
+            actor.setCullDisabled(record.cullDisabled);
+
+            if (record.parent == SceneData::none)
+                rootActors.push_back(&actor);
+            else
+                actors[record.parent].addChild(actor);
+        }
+
+        for (std::size_t i = 0; i < data.staticMeshRenderers.size(); ++i)
+        {
+            const auto& record = data.staticMeshRenderers[i];
+            auto& renderer = staticMeshRenderers[i];
+
+            renderer.init(*static_cast<const StaticMeshData*>(getAsset(record.meshData, assets::Asset::Type::staticMesh)));
+
+            if (record.material != SceneData::none)
+                renderer.setMaterial(static_cast<const graphics::Material*>(getAsset(record.material, assets::Asset::Type::material)));
+
+            actors[record.actor].addComponent(renderer);
+        }
+
+        for (std::size_t i = 0; i < data.spriteRenderers.size(); ++i)
+        {
+            const auto& record = data.spriteRenderers[i];
+            auto& renderer = spriteRenderers[i];
+
+            renderer.init(*static_cast<const SpriteData*>(getAsset(record.spriteData, assets::Asset::Type::sprite)));
+            actors[record.actor].addComponent(renderer);
+        }
+
+        for (std::size_t i = 0; i < data.particleSystems.size(); ++i)
+        {
+            const auto& record = data.particleSystems[i];
+            auto& particleSystem = particleSystems[i];
+
+            particleSystem.init(*static_cast<const scene::ParticleSystemData*>(getAsset(record.particleSystemData, assets::Asset::Type::particleSystem)));
+            actors[record.actor].addComponent(particleSystem);
+        }
+
+        for (std::size_t i = 0; i < data.lights.size(); ++i)
+        {
+            const auto& record = data.lights[i];
+            auto& light = lights[i];
+
+            light.setType(record.type);
+            light.setColor(record.color);
+            light.setDirection(record.direction);
+            light.setAngle(record.angle);
+            light.setRange(record.range);
+            light.setIntensity(record.intensity);
+            actors[record.actor].addComponent(light);
+        }
+    }
+
+    Actor& SceneInstance::getActor(std::size_t index) const
+    {
+        if (index >= actorCount)
+            throw std::out_of_range{"Invalid actor index"};
+
+        return actors[index];
+    }
+
+    void SceneInstance::addTo(ActorContainer& container) const
+    {
+        for (const auto actor : rootActors)
+            container.addChild(*actor);
+    }
+
+    SceneStream::SceneStream(const std::string& filename)
+    {
+        core::TaskGroup taskGroup;
+        taskGroup.add([streamResult = result, filename]() {
+            // the stream was destroyed before the task started
+            if (streamResult.use_count() == 1) return;
+
+            try
+            {
+                const auto fileData = engine->getFileSystem().readFile(filename);
+                const auto begin = reinterpret_cast<const std::uint8_t*>(fileData.data());
+                streamResult->data = SceneData{std::vector<std::uint8_t>(begin, begin + fileData.size())};
+            }
+            catch (const std::exception& e)
+            {
+                streamResult->error = e.what();
+            }
+
+            streamResult->finished = true;
+        });
+
+        engine->getWorkerPool().run(std::move(taskGroup));
+    }
+
+    const SceneData& SceneStream::getSceneData() const
+    {
+        if (!result->finished)
+            throw std::runtime_error{"Scene is still loading"};
+
+        if (!result->error.empty())
+            throw std::runtime_error{"Failed to load scene, reason: " + result->error};
+
+        return result->data;
+    }
+}
@@ -0,0 +1,79 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_SCENEINSTANCE_HPP
+#define OUZEL_SCENE_SCENEINSTANCE_HPP
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "SceneData.hpp"
+#include "Actor.hpp"
+#include "Light.hpp"
+#include "ParticleSystem.hpp"
+#include "SpriteRenderer.hpp"
+#include "StaticMeshRenderer.hpp"
+
+namespace ouzel::assets
+{
+    class Cache;
+}
+
+namespace ouzel::scene
+{
+    // Actors and components created from scene data
+    // Every kind of object is allocated in a single block and owned by the instance
+    class SceneInstance final
+    {
+    public:
+        // all of the referenced assets have to be loaded in the cache
+        SceneInstance(const SceneData& data, const assets::Cache& cache);
+
+        SceneInstance(const SceneInstance&) = delete;
+        SceneInstance& operator=(const SceneInstance&) = delete;
+
+        SceneInstance(SceneInstance&&) = delete;
+        SceneInstance& operator=(SceneInstance&&) = delete;
+
+        [[nodiscard]] auto getActorCount() const noexcept { return actorCount; }
+        Actor& getActor(std::size_t index) const;
+
+        // actors without a parent in the scene data
+        [[nodiscard]] auto& getRootActors() const noexcept { return rootActors; }
+        void addTo(ActorContainer& container) const;
+
+    private:
+        // actors are declared first so that the components are removed from them before they get destroyed
+        std::size_t actorCount = 0;
+        std::unique_ptr<Actor[]> actors;
+        std::unique_ptr<StaticMeshRenderer[]> staticMeshRenderers;
+        std::unique_ptr<SpriteRenderer[]> spriteRenderers;
+        std::unique_ptr<ParticleSystem[]> particleSystems;
+        std::unique_ptr<Light[]> lights;
+        std::vector<Actor*> rootActors;
+    };
+
+    // Reads and decodes a scene file on a worker thread, used for streaming in sub-scenes during gameplay
+    class SceneStream final
+    {
+    public:
+        explicit SceneStream(const std::string& filename);
+
+        [[nodiscard]] bool isFinished() const noexcept { return result->finished; }
+
+        // throws if the stream has not finished or the file could not be decoded
+        const SceneData& getSceneData() const;
+
+    private:
+        struct Result final
+        {
+            std::atomic<bool> finished{false};
+            SceneData data;
+            std::string error;
+        };
+
+        std::shared_ptr<Result> result = std::make_shared<Result>();
+    };
+}
+
+#endif // OUZEL_SCENE_SCENEINSTANCE_HPP
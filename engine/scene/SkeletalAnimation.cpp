@@ -0,0 +1,316 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include "SkeletalAnimation.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+#  include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        constexpr auto getComponentCount(AnimationClip::Path path) noexcept
+        {
+            return path == AnimationClip::Path::rotation ? std::size_t(4) : std::size_t(3);
+        }
+
+        // normalized linear interpolation along the shortest arc
+        auto nlerp(const math::Quaternion<float>& quat1,
+                   const math::Quaternion<float>& quat2,
+                   float t) noexcept
+        {
+            const auto dot = quat1.v[0] * quat2.v[0] + quat1.v[1] * quat2.v[1] +
+                quat1.v[2] * quat2.v[2] + quat1.v[3] * quat2.v[3];
+            const auto t2 = dot < 0.0F ? -t : t;
+            const auto t1 = 1.0F - t;
+
+            math::Quaternion<float> result{
+                quat1.v[0] * t1 + quat2.v[0] * t2,
+                quat1.v[1] * t1 + quat2.v[1] * t2,
+                quat1.v[2] * t1 + quat2.v[2] * t2,
+                quat1.v[3] * t1 + quat2.v[3] * t2
+            };
+
+            const auto length = std::sqrt(result.v[0] * result.v[0] + result.v[1] * result.v[1] +
+                                          result.v[2] * result.v[2] + result.v[3] * result.v[3]);
+            if (length > std::numeric_limits<float>::min())
+                for (auto& v : result.v) v /= length;
+
+            return result;
+        }
+
+        auto getTransformMatrix(const JointTransform& transform) noexcept
+        {
+            const auto& rotation = transform.rotation;
+            const auto& scale = transform.scale;
+
+            const auto wx = rotation.v[3] * rotation.v[0];
+            const auto wy = rotation.v[3] * rotation.v[1];
+            const auto wz = rotation.v[3] * rotation.v[2];
+            const auto xx = rotation.v[0] * rotation.v[0];
+            const auto xy = rotation.v[0] * rotation.v[1];
+            const auto xz = rotation.v[0] * rotation.v[2];
+            const auto yy = rotation.v[1] * rotation.v[1];
+            const auto yz = rotation.v[1] * rotation.v[2];
+            const auto zz = rotation.v[2] * rotation.v[2];
+
+            // translation * rotation * scale
+            math::Matrix<float, 4> result;
+            result.m.v[0] = (1.0F - 2.0F * (yy + zz)) * scale.v[0];
+            result.m.v[1] = 2.0F * (xy + wz) * scale.v[0];
+            result.m.v[2] = 2.0F * (xz - wy) * scale.v[0];
+            result.m.v[3] = 0.0F;
+
+            result.m.v[4] = 2.0F * (xy - wz) * scale.v[1];
+            result.m.v[5] = (1.0F - 2.0F * (xx + zz)) * scale.v[1];
+            result.m.v[6] = 2.0F * (yz + wx) * scale.v[1];
+            result.m.v[7] = 0.0F;
+
+            result.m.v[8] = 2.0F * (xz + wy) * scale.v[2];
+            result.m.v[9] = 2.0F * (yz - wx) * scale.v[2];
+            result.m.v[10] = (1.0F - 2.0F * (xx + yy)) * scale.v[2];
+            result.m.v[11] = 0.0F;
+
+            result.m.v[12] = transform.translation.v[0];
+            result.m.v[13] = transform.translation.v[1];
+            result.m.v[14] = transform.translation.v[2];
+            result.m.v[15] = 1.0F;
+
+            return result;
+        }
+
+        void setValue(JointTransform& transform, AnimationClip::Path path, const float* value) noexcept
+        {
+            switch (path)
+            {
+                case AnimationClip::Path::translation:
+                    transform.translation = math::Vector<float, 3>{value[0], value[1], value[2]};
+                    break;
+                case AnimationClip::Path::rotation:
+                    transform.rotation = math::Quaternion<float>{value[0], value[1], value[2], value[3]};
+                    break;
+                case AnimationClip::Path::scale:
+                    transform.scale = math::Vector<float, 3>{value[0], value[1], value[2]};
+                    break;
+            }
+        }
+    }
+
+    Pose Skeleton::getBindPose() const
+    {
+        Pose result(joints.size());
+        for (std::size_t i = 0; i < joints.size(); ++i)
+            result[i] = joints[i].bindPose;
+        return result;
+    }
+
+    void sampleClip(const AnimationClip& clip, float time, Pose& pose, KeyframeCache& cache)
+    {
+        cache.resize(clip.channels.size());
+
+        for (std::size_t c = 0; c < clip.channels.size(); ++c)
+        {
+            const auto& channel = clip.channels[c];
+            const auto& times = channel.times;
+            if (times.empty() || channel.joint >= pose.size()) continue;
+
+            // the time only moves backwards when the clip loops or is rewound
+            auto& key = cache[c];
+            if (key >= times.size() || times[key] > time)
+            {
+                const auto i = std::upper_bound(times.begin(), times.end(), time);
+                key = i == times.begin() ? 0 : static_cast<std::size_t>(i - times.begin()) - 1;
+            }
+            else
+                while (key + 1 < times.size() && times[key + 1] <= time) ++key;
+
+            const auto components = getComponentCount(channel.path);
+            const auto cubic = channel.interpolation == AnimationClip::Interpolation::cubicSpline;
+            const auto stride = cubic ? components * 3 : components;
+            const auto offset = cubic ? components : 0;
+            const float* value1 = &channel.values[key * stride + offset];
+
+            if (channel.interpolation == AnimationClip::Interpolation::step ||
+                key + 1 >= times.size() || time <= times[key])
+            {
+                setValue(pose[channel.joint], channel.path, value1);
+                continue;
+            }
+
+            const float* value2 = &channel.values[(key + 1) * stride + offset];
+            const auto duration = times[key + 1] - times[key];
+            const auto t = (time - times[key]) / duration;
+            float result[4];
+
+            if (cubic)
+            {
+                // Hermite spline, the tangents are scaled by the duration between the keys
+                const float* outTangent = value1 + components;
+                const float* inTangent = value2 - components;
+                const auto t2 = t * t;
+                const auto t3 = t2 * t;
+                const auto h1 = 2.0F * t3 - 3.0F * t2 + 1.0F;
+                const auto h2 = (t3 - 2.0F * t2 + t) * duration;
+                const auto h3 = -2.0F * t3 + 3.0F * t2;
+                const auto h4 = (t3 - t2) * duration;
+
+                for (std::size_t i = 0; i < components; ++i)
+                    result[i] = h1 * value1[i] + h2 * outTangent[i] + h3 * value2[i] + h4 * inTangent[i];
+
+                if (channel.path == AnimationClip::Path::rotation)
+                {
+                    const auto length = std::sqrt(result[0] * result[0] + result[1] * result[1] +
+                                                  result[2] * result[2] + result[3] * result[3]);
+                    if (length > std::numeric_limits<float>::min())
+                        for (auto& v : result) v /= length;
+                }
+            }
+            else if (channel.path == AnimationClip::Path::rotation)
+            {
+                const auto rotation = nlerp(math::Quaternion<float>{value1[0], value1[1], value1[2], value1[3]},
+                                            math::Quaternion<float>{value2[0], value2[1], value2[2], value2[3]},
+                                            t);
+                std::copy(std::begin(rotation.v), std::end(rotation.v), result);
+            }
+            else
+                for (std::size_t i = 0; i < components; ++i)
+                    result[i] = value1[i] + (value2[i] - value1[i]) * t;
+
+            setValue(pose[channel.joint], channel.path, result);
+        }
+    }
+
+    void blendPoses(const Pose& pose1, const Pose& pose2, float weight, Pose& result)
+    {
+        const auto count = std::min(pose1.size(), pose2.size());
+        result.resize(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            result[i].translation = pose1[i].translation + (pose2[i].translation - pose1[i].translation) * weight;
+            result[i].rotation = nlerp(pose1[i].rotation, pose2[i].rotation, weight);
+            result[i].scale = pose1[i].scale + (pose2[i].scale - pose1[i].scale) * weight;
+        }
+    }
+
+    void calculateSkinMatrices(const Skeleton& skeleton,
+                               const Pose& pose,
+                               std::vector<math::Matrix<float, 4>>& skinMatrices)
+    {
+        const auto& joints = skeleton.joints;
+        skinMatrices.resize(joints.size());
+
+        // model space transforms first, the parents are calculated before their children
+        for (std::size_t i = 0; i < joints.size(); ++i)
+        {
+            const auto localTransform = getTransformMatrix(i < pose.size() ? pose[i] : joints[i].bindPose);
+            const auto& parentTransform = joints[i].parent == Skeleton::noParent ?
+                skeleton.rootTransform : skinMatrices[joints[i].parent];
+            skinMatrices[i] = parentTransform * localTransform;
+        }
+
+        for (std::size_t i = 0; i < joints.size(); ++i)
+            skinMatrices[i] *= joints[i].inverseBindMatrix;
+    }
+
+    void skinVertices(const SkinnedVertices& source,
+                      const std::vector<math::Matrix<float, 4>>& skinMatrices,
+                      std::vector<graphics::Vertex>& vertices)
+    {
+        const auto count = std::min(vertices.size(), source.positions.size());
+        const auto hasNormals = source.normals.size() >= count;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& joints = source.joints[i];
+            const auto& weights = source.weights[i];
+            const auto& position = source.positions[i];
+            auto& vertex = vertices[i];
+
+#if defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
+            // blend the columns of the four joint matrices
+            __m128 columns[4];
+            const auto weight0 = _mm_set1_ps(weights[0]);
+            const auto& matrix0 = skinMatrices[joints[0]];
+            for (std::size_t c = 0; c < 4; ++c)
+                columns[c] = _mm_mul_ps(_mm_load_ps(&matrix0.m.v[c * 4]), weight0);
+
+            for (std::size_t j = 1; j < 4; ++j)
+            {
+                if (weights[j] == 0.0F) continue;
+
+                const auto weight = _mm_set1_ps(weights[j]);
+                const auto& matrix = skinMatrices[joints[j]];
+                for (std::size_t c = 0; c < 4; ++c)
+                    columns[c] = _mm_add_ps(columns[c], _mm_mul_ps(_mm_load_ps(&matrix.m.v[c * 4]), weight));
+            }
+
+            alignas(16) float result[4];
+            _mm_store_ps(result, _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(position.v[0])),
+                                                       _mm_mul_ps(columns[1], _mm_set1_ps(position.v[1]))),
+                                            _mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(position.v[2])),
+                                                       columns[3])));
+            vertex.position = math::Vector<float, 3>{result[0], result[1], result[2]};
+
+            if (hasNormals)
+            {
+                const auto& normal = source.normals[i];
+                _mm_store_ps(result, _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(normal.v[0])),
+                                                           _mm_mul_ps(columns[1], _mm_set1_ps(normal.v[1]))),
+                                                _mm_mul_ps(columns[2], _mm_set1_ps(normal.v[2]))));
+                vertex.normal = math::Vector<float, 3>{result[0], result[1], result[2]};
+            }
+#elif defined(__ARM_NEON__)
+            float32x4_t columns[4];
+            const auto& matrix0 = skinMatrices[joints[0]];
+            for (std::size_t c = 0; c < 4; ++c)
+                columns[c] = vmulq_n_f32(vld1q_f32(&matrix0.m.v[c * 4]), weights[0]);
+
+            for (std::size_t j = 1; j < 4; ++j)
+            {
+                if (weights[j] == 0.0F) continue;
+
+                const auto& matrix = skinMatrices[joints[j]];
+                for (std::size_t c = 0; c < 4; ++c)
+                    columns[c] = vmlaq_n_f32(columns[c], vld1q_f32(&matrix.m.v[c * 4]), weights[j]);
+            }
+
+            float result[4];
+            vst1q_f32(result, vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(columns[3], columns[0], position.v[0]),
+                                                      columns[1], position.v[1]),
+                                          columns[2], position.v[2]));
+            vertex.position = math::Vector<float, 3>{result[0], result[1], result[2]};
+
+            if (hasNormals)
+            {
+                const auto& normal = source.normals[i];
+                vst1q_f32(result, vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(columns[0], normal.v[0]),
+                                                          columns[1], normal.v[1]),
+                                              columns[2], normal.v[2]));
+                vertex.normal = math::Vector<float, 3>{result[0], result[1], result[2]};
+            }
+#else
+            math::Matrix<float, 4> matrix = skinMatrices[joints[0]] * weights[0];
+            for (std::size_t j = 1; j < 4; ++j)
+                if (weights[j] != 0.0F)
+                    matrix += skinMatrices[joints[j]] * weights[j];
+
+            vertex.position = position;
+            transformPoint(matrix, vertex.position);
+
+            if (hasNormals)
+            {
+                vertex.normal = source.normals[i];
+                transformVector(matrix, vertex.normal);
+            }
+#endif
+
+            if (hasNormals) normalize(vertex.normal);
+        }
+    }
+}
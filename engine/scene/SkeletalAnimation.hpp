@@ -0,0 +1,101 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_SKELETALANIMATION_HPP
+#define OUZEL_SCENE_SKELETALANIMATION_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "../graphics/Vertex.hpp"
+#include "../math/Matrix.hpp"
+#include "../math/Quaternion.hpp"
+#include "../math/Vector.hpp"
+
+namespace ouzel::scene
+{
+    struct JointTransform final
+    {
+        math::Vector<float, 3> translation{};
+        math::Quaternion<float> rotation = math::identityQuaternion<float>;
+        math::Vector<float, 3> scale{1.0F, 1.0F, 1.0F};
+    };
+
+    using Pose = std::vector<JointTransform>;
+
+    class Skeleton final
+    {
+    public:
+        static constexpr std::size_t noParent = std::numeric_limits<std::size_t>::max();
+
+        struct Joint final
+        {
+            std::string name;
+            std::size_t parent = noParent; // parents always precede their children
+            math::Matrix<float, 4> inverseBindMatrix = math::identityMatrix<float, 4>;
+            JointTransform bindPose;
+        };
+
+        [[nodiscard]] Pose getBindPose() const;
+
+        std::vector<Joint> joints;
+        math::Matrix<float, 4> rootTransform = math::identityMatrix<float, 4>; // transform of the nodes above the root joints
+    };
+
+    class AnimationClip final
+    {
+    public:
+        enum class Path
+        {
+            translation,
+            rotation,
+            scale
+        };
+
+        enum class Interpolation
+        {
+            step,
+            linear,
+            cubicSpline
+        };
+
+        struct Channel final
+        {
+            std::size_t joint = 0;
+            Path path = Path::translation;
+            Interpolation interpolation = Interpolation::linear;
+            std::vector<float> times;
+            std::vector<float> values; // cubic spline keys store the in-tangent, the value and the out-tangent
+        };
+
+        std::string name;
+        float duration = 0.0F;
+        std::vector<Channel> channels;
+    };
+
+    // the last keyframe of every channel, so that playing a clip forward doesn't search the keys
+    using KeyframeCache = std::vector<std::size_t>;
+
+    void sampleClip(const AnimationClip& clip, float time, Pose& pose, KeyframeCache& cache);
+    void blendPoses(const Pose& pose1, const Pose& pose2, float weight, Pose& result);
+    void calculateSkinMatrices(const Skeleton& skeleton,
+                               const Pose& pose,
+                               std::vector<math::Matrix<float, 4>>& skinMatrices);
+
+    // vertex streams that skinning reads, kept apart from the rest of the vertex attributes
+    struct SkinnedVertices final
+    {
+        std::vector<math::Vector<float, 3>> positions;
+        std::vector<math::Vector<float, 3>> normals;
+        std::vector<std::array<std::uint16_t, 4>> joints;
+        std::vector<std::array<float, 4>> weights; // the weights of every vertex add up to 1
+    };
+
+    // writes the skinned positions and normals to the vertices, the other attributes are left untouched
+    void skinVertices(const SkinnedVertices& source,
+                      const std::vector<math::Matrix<float, 4>>& skinMatrices,
+                      std::vector<graphics::Vertex>& vertices);
+}
+
+#endif // OUZEL_SCENE_SKELETALANIMATION_HPP
@@ -1,23 +1,296 @@
 // Ouzel by Elviss Strazdins
 
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include "SkinnedMeshRenderer.hpp"
+#include "../assets/Cache.hpp"
 #include "../core/Engine.hpp"
+#include "../utils/Utils.hpp"
 
 namespace ouzel::scene
 {
-    SkinnedMeshRenderer::SkinnedMeshRenderer()
+    namespace
     {
+        // returns true if a clip that doesn't repeat has reached its end
+        bool advanceTime(float& time, float step, const AnimationClip& animation, bool repeat) noexcept
+        {
+            time += step;
+
+            if (animation.duration <= 0.0F)
+            {
+                time = 0.0F;
+                return !repeat;
+            }
+
+            if (repeat)
+            {
+                time = std::fmod(time, animation.duration);
+                if (time < 0.0F) time += animation.duration;
+                return false;
+            }
+            else if (time >= animation.duration)
+            {
+                time = animation.duration;
+                return step >= 0.0F;
+            }
+            else if (time <= 0.0F)
+            {
+                time = 0.0F;
+                return step <= 0.0F;
+            }
+            else
+                return false;
+        }
+    }
+
+    SkinnedMeshData::SkinnedMeshData(const math::Box<float, 3>& initBoundingBox,
+                                     const std::vector<std::uint32_t>& indices,
+                                     const std::vector<graphics::Vertex>& initVertices,
+                                     const SkinnedVertices& initSkinnedVertices,
+                                     const Skeleton& initSkeleton,
+                                     const std::vector<AnimationClip>& initAnimations,
+                                     const std::vector<Primitive>& initPrimitives):
+        boundingBox{initBoundingBox},
+        primitives{initPrimitives},
+        vertices{initVertices},
+        skinnedVertices{initSkinnedVertices},
+        skeleton{initSkeleton},
+        animations{initAnimations}
+    {
+        if (skinnedVertices.positions.size() != vertices.size() ||
+            skinnedVertices.joints.size() != vertices.size() ||
+            skinnedVertices.weights.size() != vertices.size())
+            throw std::runtime_error{"Invalid skinned vertex data"};
+
+        jointBoundingBoxes.resize(skeleton.joints.size());
+
+        for (std::size_t vertex = 0; vertex < skinnedVertices.joints.size(); ++vertex)
+            for (std::size_t influence = 0; influence < 4; ++influence)
+            {
+                const auto joint = skinnedVertices.joints[vertex][influence];
+                if (joint >= skeleton.joints.size())
+                    throw std::runtime_error{"Invalid joint index"};
+
+                if (skinnedVertices.weights[vertex][influence] > 0.0F)
+                    insertPoint(jointBoundingBoxes[joint], skinnedVertices.positions[vertex]);
+            }
+
+        indexCount = static_cast<std::uint32_t>(indices.size());
+
+        for (const auto& primitive : primitives)
+            if (primitive.startIndex > indexCount || primitive.indexCount > indexCount - primitive.startIndex)
+                throw std::runtime_error{"Invalid primitive index range"};
+
+        indexSize = sizeof(std::uint16_t);
+
+        for (const auto index : indices)
+            if (index > std::numeric_limits<std::uint16_t>::max())
+            {
+                indexSize = sizeof(std::uint32_t);
+                break;
+            }
+
+        if (indexSize == sizeof(std::uint16_t))
+        {
+            std::vector<std::uint16_t> convertedIndices;
+            convertedIndices.reserve(indices.size());
+
+            for (const auto index : indices)
+                convertedIndices.push_back(static_cast<std::uint16_t>(index));
+
+            indexBuffer = graphics::Buffer(engine->getGraphics(),
+                                           graphics::BufferType::index,
+                                           graphics::Flags::none,
+                                           convertedIndices.data(),
+                                           static_cast<std::uint32_t>(getVectorSize(convertedIndices)));
+        }
+        else if (indexSize == sizeof(std::uint32_t))
+            indexBuffer = graphics::Buffer(engine->getGraphics(),
+                                           graphics::BufferType::index,
+                                           graphics::Flags::none,
+                                           indices.data(),
+                                           static_cast<std::uint32_t>(getVectorSize(indices)));
+    }
+
+    const AnimationClip* SkinnedMeshData::getAnimation(std::string_view name) const noexcept
+    {
+        for (const auto& animation : animations)
+            if (animation.name == name)
+                return &animation;
+
+        return nullptr;
+    }
+
+    SkinnedMeshRenderer::SkinnedMeshRenderer(const SkinnedMeshData& initMeshData)
+    {
+        init(initMeshData);
+    }
+
+    SkinnedMeshRenderer::~SkinnedMeshRenderer()
+    {
+        if (animationSystem) animationSystem->removeSkinnedMesh(*this);
+    }
+
+    void SkinnedMeshRenderer::init(const SkinnedMeshData& newMeshData)
+    {
+        stop();
+
+        meshData = &newMeshData;
+        boundingBox = newMeshData.boundingBox;
+        material = nullptr;
+        vertices = newMeshData.vertices;
+        pose = newMeshData.skeleton.getBindPose();
+        currentAnimation = nullptr;
+        previousAnimation = nullptr;
+        time = 0.0F;
+        fadeTime = 0.0F;
+        keyframeCache.clear();
+
+        vertexBuffer = std::make_unique<graphics::Buffer>(engine->getGraphics(),
+                                                          graphics::BufferType::vertex,
+                                                          graphics::Flags::dynamic,
+                                                          vertices.data(),
+                                                          static_cast<std::uint32_t>(getVectorSize(vertices)));
+
+        updatePose();
+    }
+
+    void SkinnedMeshRenderer::play(std::string_view animationName, bool newRepeat, float newFadeTime)
+    {
+        if (!meshData) return;
+
+        const auto animation = meshData->getAnimation(animationName);
+        if (!animation)
+            throw std::runtime_error{"Animation " + std::string{animationName} + " does not exist"};
+
+        if (newFadeTime > 0.0F)
+        {
+            // keep playing the previous animation while fading out of it
+            previousAnimation = playing ? currentAnimation : nullptr;
+            previousRepeat = repeat;
+            previousTime = time;
+            previousPose = fadeElapsed < fadeTime ? blendedPose : pose;
+            previousKeyframeCache = keyframeCache;
+            fadeTime = newFadeTime;
+            fadeElapsed = 0.0F;
+        }
+        else
+        {
+            previousAnimation = nullptr;
+            fadeTime = 0.0F;
+        }
+
+        currentAnimation = animation;
+        repeat = newRepeat;
+        time = speed < 0.0F ? animation->duration : 0.0F;
+        pose = meshData->skeleton.getBindPose();
+        keyframeCache.clear();
+
+        if (!playing)
+        {
+            playing = true;
+            engine->getAnimationSystem().addSkinnedMesh(*this);
+        }
+
+        updatePose();
+
+        auto startEvent = std::make_unique<AnimationEvent>();
+        startEvent->type = Event::Type::animationStart;
+        startEvent->component = this;
+        engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+    }
+
+    void SkinnedMeshRenderer::stop()
+    {
+        if (playing)
+        {
+            playing = false;
+            engine->getAnimationSystem().removeSkinnedMesh(*this);
+        }
+    }
+
+    const graphics::Material* SkinnedMeshRenderer::getDrawMaterial() const noexcept
+    {
+        if (material) return material;
+        return meshData && !meshData->primitives.empty() ? meshData->primitives.front().material : nullptr;
     }
 
-    SkinnedMeshRenderer::SkinnedMeshRenderer(const SkinnedMeshData& meshData)
+    void SkinnedMeshRenderer::setTime(float newTime)
     {
-        init(meshData);
+        time = newTime;
+        if (meshData) updatePose();
+    }
+
+    void SkinnedMeshRenderer::update(float delta)
+    {
+        if (!currentAnimation) return;
+
+        const auto step = delta * speed;
+
+        if (previousAnimation &&
+            advanceTime(previousTime, step, *previousAnimation, previousRepeat))
+            previousAnimation = nullptr;
+
+        if (fadeElapsed < fadeTime) fadeElapsed += delta;
+
+        const auto finished = advanceTime(time, step, *currentAnimation, repeat);
+
+        // the pose is needed for culling, so it is sampled even if the mesh is not drawn
+        updatePose();
+
+        if (finished)
+        {
+            stop();
+
+            auto finishEvent = std::make_unique<AnimationEvent>();
+            finishEvent->type = Event::Type::animationFinish;
+            finishEvent->component = this;
+            engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+        }
     }
 
-    void SkinnedMeshRenderer::init(const SkinnedMeshData& meshData)
+    void SkinnedMeshRenderer::updatePose()
     {
-        boundingBox = meshData.boundingBox;
-        material = meshData.material;
+        if (currentAnimation) sampleClip(*currentAnimation, time, pose, keyframeCache);
+
+        if (fadeElapsed < fadeTime)
+        {
+            if (previousAnimation)
+                sampleClip(*previousAnimation, previousTime, previousPose, previousKeyframeCache);
+
+            blendPoses(previousPose, pose, fadeElapsed / fadeTime, blendedPose);
+            calculateSkinMatrices(meshData->skeleton, blendedPose, skinMatrices);
+        }
+        else
+        {
+            previousAnimation = nullptr;
+            calculateSkinMatrices(meshData->skeleton, pose, skinMatrices);
+        }
+
+        // the vertices are a weighted sum of their joint transforms, so they stay inside the joint boxes transformed by the pose
+        math::reset(boundingBox);
+
+        for (std::size_t joint = 0; joint < skinMatrices.size(); ++joint)
+        {
+            const auto& jointBox = meshData->jointBoundingBoxes[joint];
+            if (isEmpty(jointBox)) continue;
+
+            for (std::uint32_t corner = 0; corner < 8; ++corner)
+            {
+                math::Vector<float, 3> point{
+                    (corner & 1) ? jointBox.max.v[0] : jointBox.min.v[0],
+                    (corner & 2) ? jointBox.max.v[1] : jointBox.min.v[1],
+                    (corner & 4) ? jointBox.max.v[2] : jointBox.min.v[2]
+                };
+                transformPoint(skinMatrices[joint], point);
+                insertPoint(boundingBox, point);
+            }
+        }
+
+        if (isEmpty(boundingBox)) boundingBox = meshData->boundingBox;
+
+        verticesDirty = true;
     }
 
     void SkinnedMeshRenderer::draw(const math::Matrix<float, 4>& transformMatrix,
@@ -29,5 +302,51 @@ namespace ouzel::scene
                         opacity,
                         renderViewProjection,
                         wireframe);
+
+        if (!meshData) return;
+
+        // only visible meshes are skinned
+        if (verticesDirty)
+        {
+            skinVertices(meshData->skinnedVertices, skinMatrices, vertices);
+            vertexBuffer->setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
+            verticesDirty = false;
+        }
+
+        const auto modelViewProj = renderViewProjection * transformMatrix;
+
+        std::vector<std::vector<float>> vertexShaderConstants(1);
+        vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
+
+        for (const auto& primitive : meshData->primitives)
+        {
+            const auto drawMaterial = material ? material : primitive.material;
+            if (!drawMaterial) continue;
+
+            const auto colorVector = {
+                drawMaterial->diffuseColor.normR(),
+                drawMaterial->diffuseColor.normG(),
+                drawMaterial->diffuseColor.normB(),
+                drawMaterial->diffuseColor.normA() * opacity * drawMaterial->opacity
+            };
+
+            std::vector<std::vector<float>> fragmentShaderConstants(1);
+            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+            const auto textures = drawMaterial->getTextureResources();
+
+            engine->getGraphics().setPipelineState(drawMaterial->blendState->getResource(),
+                                                   drawMaterial->shader->getResource(),
+                                                   drawMaterial->cullMode,
+                                                   wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
+            engine->getGraphics().setShaderConstants(fragmentShaderConstants, vertexShaderConstants);
+            engine->getGraphics().setTextures(textures);
+            engine->getGraphics().draw(meshData->indexBuffer.getResource(),
+                                       primitive.indexCount,
+                                       meshData->indexSize,
+                                       vertexBuffer->getResource(),
+                                       graphics::DrawMode::triangleList,
+                                       primitive.startIndex);
+        }
     }
 }
@@ -4,52 +4,120 @@
 #define OUZEL_SCENE_SKINNEDMESHRENDERER_HPP
 
 #include <memory>
+#include <string_view>
 #include <vector>
 #include "Component.hpp"
+#include "SkeletalAnimation.hpp"
+#include "../graphics/Buffer.hpp"
 #include "../graphics/Material.hpp"
+#include "../graphics/Vertex.hpp"
 
 namespace ouzel::scene
 {
     class SkinnedMeshData final
     {
     public:
-        struct Bone final
+        // range of the indices drawn with one material
+        struct Primitive final
         {
-            Bone* parent = nullptr;
-            math::Vector<float, 3> position{};
-            math::Quaternion<float> rotation = math::identityQuaternion<float>;
+            const graphics::Material* material = nullptr;
+            std::uint32_t startIndex = 0;
+            std::uint32_t indexCount = 0;
         };
 
         SkinnedMeshData() = default;
         SkinnedMeshData(const math::Box<float, 3>& initBoundingBox,
-                        const std::shared_ptr<graphics::Material>& initMaterial):
-            boundingBox{initBoundingBox},
-            material{initMaterial}
-        {
-        }
+                        const std::vector<std::uint32_t>& indices,
+                        const std::vector<graphics::Vertex>& initVertices,
+                        const SkinnedVertices& initSkinnedVertices,
+                        const Skeleton& initSkeleton,
+                        const std::vector<AnimationClip>& initAnimations,
+                        const std::vector<Primitive>& initPrimitives);
+
+        const AnimationClip* getAnimation(std::string_view name) const noexcept;
 
-        math::Box<float, 3> boundingBox;
-        std::shared_ptr<graphics::Material> material;
+        math::Box<float, 3> boundingBox; // of the bind pose
+        std::vector<math::Box<float, 3>> jointBoundingBoxes; // of the vertices influenced by each joint, in the bind pose
+        std::vector<Primitive> primitives;
+        std::vector<graphics::Vertex> vertices; // in the bind pose
+        SkinnedVertices skinnedVertices;
+        Skeleton skeleton;
+        std::vector<AnimationClip> animations;
+        std::uint32_t indexCount = 0;
+        std::uint32_t indexSize = 0;
+        graphics::Buffer indexBuffer;
     };
 
+    class AnimationSystem;
+
     class SkinnedMeshRenderer: public Component
     {
+        friend AnimationSystem;
     public:
-        SkinnedMeshRenderer();
-        explicit SkinnedMeshRenderer(const SkinnedMeshData& meshData);
+        SkinnedMeshRenderer() = default;
+        explicit SkinnedMeshRenderer(const SkinnedMeshData& initMeshData);
+        ~SkinnedMeshRenderer() override;
 
-        void init(const SkinnedMeshData& meshData);
+        void init(const SkinnedMeshData& newMeshData);
 
         void draw(const math::Matrix<float, 4>& transformMatrix,
                   float opacity,
                   const math::Matrix<float, 4>& renderViewProjection,
                   bool wireframe) override;
 
+        // the material that overrides the materials of all the primitives, nullptr if each primitive uses its own
         auto& getMaterial() const noexcept { return material; }
-        void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
+        const graphics::Material* getDrawMaterial() const noexcept override;
+        void setMaterial(const graphics::Material* newMaterial) { material = newMaterial; }
+
+        // starts the animation from the beginning, blending from the current pose during the fade time
+        void play(std::string_view animationName, bool repeat = true, float fadeTime = 0.0F);
+        void stop();
+
+        auto isPlaying() const noexcept { return playing; }
+        auto getCurrentAnimation() const noexcept { return currentAnimation; }
+
+        auto getSpeed() const noexcept { return speed; }
+        void setSpeed(float newSpeed) noexcept { speed = newSpeed; }
+
+        auto getTime() const noexcept { return time; }
+        void setTime(float newTime);
+
+        // joint matrices of the current pose, for skinning in a vertex shader
+        auto& getSkinMatrices() const noexcept { return skinMatrices; }
 
     private:
-        std::shared_ptr<graphics::Material> material;
+        // called by the animation system while the animation is playing
+        void update(float delta);
+        // samples the animations and updates the skin matrices and the bounding box, the vertices are skinned when drawn
+        void updatePose();
+
+        const SkinnedMeshData* meshData = nullptr;
+        const graphics::Material* material = nullptr;
+        std::unique_ptr<graphics::Buffer> vertexBuffer;
+        std::vector<graphics::Vertex> vertices;
+
+        const AnimationClip* currentAnimation = nullptr;
+        const AnimationClip* previousAnimation = nullptr;
+        bool playing = false;
+        bool repeat = true;
+        bool previousRepeat = true;
+        float time = 0.0F;
+        float previousTime = 0.0F;
+        float speed = 1.0F;
+        float fadeTime = 0.0F;
+        float fadeElapsed = 0.0F;
+
+        Pose pose;
+        Pose previousPose;
+        Pose blendedPose;
+        KeyframeCache keyframeCache;
+        KeyframeCache previousKeyframeCache;
+        std::vector<math::Matrix<float, 4>> skinMatrices;
+        bool verticesDirty = true;
+
+        AnimationSystem* animationSystem = nullptr;
+        graphics::ResourceId animationSystemHandle = 0; // in the skinned mesh pool of the animation system
     };
 }
 
@@ -19,9 +19,9 @@ namespace ouzel::scene
                              const math::Size<float, 2>& sourceSize,
                              const math::Vector<float, 2>& sourceOffset,
                              const math::Vector<float, 2>& pivot):
-        name{frameName}
+        name{frameName},
+        indices{0, 1, 2, 1, 3, 2}
     {
-        const std::vector<std::uint16_t> indices = {0, 1, 2, 1, 3, 2};
         indexCount = static_cast<std::uint32_t>(indices.size());
 
         math::Vector<float, 2> textCoords[4];
@@ -65,7 +65,7 @@ namespace ouzel::scene
             textCoords[3] = math::Vector<float, 2>{rightBottom.v[0], rightBottom.v[1]};
         }
 
-        const std::vector<graphics::Vertex> vertices{
+        vertices = {
             graphics::Vertex{
                 math::Vector<float, 3>{finalOffset.v[0], finalOffset.v[1], 0.0F}, math::whiteColor,
                 textCoords[0], math::Vector<float, 3>{0.0F, 0.0F, -1.0F}
@@ -101,9 +101,11 @@ namespace ouzel::scene
     }
 
     SpriteData::Frame::Frame(const std::string& frameName,
-                             const std::vector<std::uint16_t>& indices,
-                             const std::vector<graphics::Vertex>& vertices):
-        name{frameName}
+                             const std::vector<std::uint16_t>& initIndices,
+                             const std::vector<graphics::Vertex>& initVertices):
+        name{frameName},
+        indices{initIndices},
+        vertices{initVertices}
     {
         indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -124,13 +126,15 @@ namespace ouzel::scene
     }
 
     SpriteData::Frame::Frame(const std::string& frameName,
-                             const std::vector<std::uint16_t>& indices,
-                             const std::vector<graphics::Vertex>& vertices,
+                             const std::vector<std::uint16_t>& initIndices,
+                             const std::vector<graphics::Vertex>& initVertices,
                              const math::Rect<float>& frameRectangle,
                              const math::Size<float, 2>& sourceSize,
                              const math::Vector<float, 2>& sourceOffset,
                              const math::Vector<float, 2>& pivot):
-        name{frameName}
+        name{frameName},
+        indices{initIndices},
+        vertices{initVertices}
     {
         indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -156,6 +160,58 @@ namespace ouzel::scene
                                                           static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
+    namespace
+    {
+        std::vector<graphics::Vertex> mapToRegion(std::vector<graphics::Vertex> vertices,
+                                                  const math::Rect<float>& textureRectangle)
+        {
+            for (auto& vertex : vertices)
+            {
+                vertex.texCoords[0].v[0] = textureRectangle.position.v[0] + vertex.texCoords[0].v[0] * textureRectangle.size.v[0];
+                vertex.texCoords[0].v[1] = textureRectangle.position.v[1] + vertex.texCoords[0].v[1] * textureRectangle.size.v[1];
+            }
+
+            return vertices;
+        }
+    }
+
+    void SpriteData::Frame::setTextureRegion(const std::shared_ptr<graphics::TextureAtlas::Region>& region)
+    {
+        textureRegion = region;
+
+        const auto regionVertices = mapToRegion(vertices, region->getTextureRectangle());
+        vertexBuffer = std::make_shared<graphics::Buffer>(engine->getGraphics(),
+                                                          graphics::BufferType::vertex,
+                                                          graphics::Flags::dynamic,
+                                                          regionVertices.data(),
+                                                          static_cast<std::uint32_t>(getVectorSize(regionVertices)));
+
+        // copies of the frame share the buffer, so updating it moves all of them
+        region->addListener([buffer = std::weak_ptr<graphics::Buffer>{vertexBuffer}, sourceVertices = vertices](const graphics::TextureAtlas::Region& movedRegion) {
+            const auto bufferPointer = buffer.lock();
+            if (!bufferPointer) return false;
+
+            const auto movedVertices = mapToRegion(sourceVertices, movedRegion.getTextureRectangle());
+            bufferPointer->setData(movedVertices.data(), static_cast<std::uint32_t>(getVectorSize(movedVertices)));
+            return true;
+        });
+    }
+
+    std::vector<graphics::Vertex> SpriteData::Frame::getVertices() const
+    {
+        return textureRegion ? mapToRegion(vertices, textureRegion->getTextureRectangle()) : vertices;
+    }
+
+    void SpriteData::setTextureRegion(const std::shared_ptr<graphics::TextureAtlas::Region>& region)
+    {
+        texture = region->getTexture();
+        textureRegion = region;
+
+        for (auto& animation : animations)
+            for (auto& frame : animation.second.frames)
+                frame.setTextureRegion(region);
+    }
+
     SpriteRenderer::SpriteRenderer()
     {
         updateHandler.updateHandler = [this](const UpdateEvent& event) {
@@ -382,10 +438,7 @@ namespace ouzel::scene
             std::vector<std::vector<float>> vertexShaderConstants(1);
             vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
 
-            std::vector<std::size_t> textures;
-            textures.reserve(graphics::Material::textureLayers);
-            for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
-                textures.push_back(texture ? texture->getResource() : 0);
+            const auto textures = material->getTextureResources();
 
             engine->getGraphics().setPipelineState(material->blendState->getResource(),
                                                    material->shader->getResource(),
@@ -514,21 +567,27 @@ namespace ouzel::scene
         running = true;
     }
 
-    void SpriteRenderer::updateBoundingBox()
+    const SpriteData::Frame* SpriteRenderer::getCurrentFrame() const noexcept
     {
-        if (currentAnimation != animationQueue.end() &&
-            !currentAnimation->animation->frames.empty())
-        {
-            std::size_t currentFrame = 0;
+        if (currentAnimation == animationQueue.end() ||
+            currentAnimation->animation->frames.empty())
+            return nullptr;
 
-            if (currentAnimation->animation->frameInterval >= 0.0F)
-                currentFrame = static_cast<std::size_t>(currentTime / currentAnimation->animation->frameInterval);
+        std::size_t currentFrame = 0;
 
-            if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+        if (currentAnimation->animation->frameInterval >= 0.0F)
+            currentFrame = static_cast<std::size_t>(currentTime / currentAnimation->animation->frameInterval);
 
-            const auto& frame = currentAnimation->animation->frames[currentFrame];
+        if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+
+        return &currentAnimation->animation->frames[currentFrame];
+    }
 
-            boundingBox = math::Box<float, 3>{frame.getBoundingBox()};
+    void SpriteRenderer::updateBoundingBox()
+    {
+        if (const auto frame = getCurrentFrame())
+        {
+            boundingBox = math::Box<float, 3>{frame->getBoundingBox()};
             boundingBox.min.v[0] += offset.v[0];
             boundingBox.min.v[1] += offset.v[1];
 
@@ -14,6 +14,7 @@
 #include "../graphics/Material.hpp"
 #include "../graphics/Shader.hpp"
 #include "../graphics/Texture.hpp"
+#include "../graphics/TextureAtlas.hpp"
 #include "../graphics/Vertex.hpp"
 #include "../math/Box.hpp"
 #include "../math/Rect.hpp"
@@ -37,12 +38,12 @@ namespace ouzel::scene
                   const math::Vector<float, 2>& pivot);
 
             Frame(const std::string& frameName,
-                  const std::vector<std::uint16_t>& indices,
-                  const std::vector<graphics::Vertex>& vertices);
+                  const std::vector<std::uint16_t>& initIndices,
+                  const std::vector<graphics::Vertex>& initVertices);
 
             Frame(const std::string& frameName,
-                  const std::vector<std::uint16_t>& indices,
-                  const std::vector<graphics::Vertex>& vertices,
+                  const std::vector<std::uint16_t>& initIndices,
+                  const std::vector<graphics::Vertex>& initVertices,
                   const math::Rect<float>& frameRectangle,
                   const math::Size<float, 2>& sourceSize,
                   const math::Vector<float, 2>& sourceOffset,
@@ -55,10 +56,20 @@ namespace ouzel::scene
             auto& getIndexBuffer() const noexcept { return indexBuffer; }
             auto& getVertexBuffer() const noexcept { return vertexBuffer; }
 
+            auto& getIndices() const noexcept { return indices; }
+            // vertices with the texture coordinates mapped into the atlas region
+            std::vector<graphics::Vertex> getVertices() const;
+
+            // maps the texture coordinates of the frame into an atlas region and follows the region when it is moved
+            void setTextureRegion(const std::shared_ptr<graphics::TextureAtlas::Region>& region);
+
         private:
             std::string name;
             math::Box<float, 2> boundingBox;
             std::uint32_t indexCount = 0;
+            std::vector<std::uint16_t> indices;
+            std::vector<graphics::Vertex> vertices; // texture coordinates relative to the source image
+            std::shared_ptr<graphics::TextureAtlas::Region> textureRegion;
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
         };
@@ -70,14 +81,21 @@ namespace ouzel::scene
             float frameInterval = 0.1F;
         };
 
+        // points the sprite at an atlas page and maps the texture coordinates of all frames into the region
+        void setTextureRegion(const std::shared_ptr<graphics::TextureAtlas::Region>& region);
+
         std::map<std::string, Animation> animations;
         std::shared_ptr<graphics::Texture> texture;
+        std::shared_ptr<graphics::TextureAtlas::Region> textureRegion; // set when the texture is an atlas page
         const graphics::BlendState* blendState = nullptr;
         const graphics::Shader* shader = nullptr;
     };
 
+    class StaticBatch;
+
     class SpriteRenderer: public Component
     {
+        friend StaticBatch;
     public:
         SpriteRenderer();
         explicit SpriteRenderer(const SpriteData& spriteData);
@@ -100,6 +118,7 @@ namespace ouzel::scene
                   bool wireframe) override;
 
         auto& getMaterial() const noexcept { return material; }
+        const graphics::Material* getDrawMaterial() const noexcept override { return material.get(); }
         void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
 
         auto& getOffset() const noexcept { return offset; }
@@ -120,6 +139,7 @@ namespace ouzel::scene
         void setAnimationTime(float time);
 
     private:
+        const SpriteData::Frame* getCurrentFrame() const noexcept;
         void updateBoundingBox();
 
         std::shared_ptr<graphics::Material> material;
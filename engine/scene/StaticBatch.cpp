@@ -0,0 +1,249 @@
+// Ouzel by Elviss Strazdins
+
+#include <limits>
+#include <stdexcept>
+#include "StaticBatch.hpp"
+#include "Actor.hpp"
+#include "SpriteRenderer.hpp"
+#include "StaticMeshRenderer.hpp"
+#include "../core/Engine.hpp"
+#include "../math/ConvexVolume.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        // textures that are still loading are replaced by a white pixel
+        std::vector<std::size_t> getTextureResources(const StaticBatchLayout::Material& material)
+        {
+            std::vector<std::size_t> result;
+            result.reserve(graphics::Material::textureLayers);
+
+            for (const auto& texture : material.textures)
+                if (!texture)
+                    result.push_back(0);
+                else if (!texture->isReady())
+                    result.push_back(engine->getCache().getTexture(textureWhitePixel)->getResource());
+                else
+                    result.push_back(texture->getResource());
+
+            return result;
+        }
+    }
+
+    StaticBatch::StaticBatch(float initCellSize):
+        layout{initCellSize}
+    {
+    }
+
+    StaticBatch::~StaticBatch()
+    {
+        clear();
+    }
+
+    StaticBatch::MemberId StaticBatch::add(StaticMeshRenderer& renderer)
+    {
+        if (!renderer.meshData || !renderer.material)
+            throw std::runtime_error{"Static mesh renderer is not initialized"};
+
+        if (!renderer.getActor())
+            throw std::runtime_error{"Static mesh renderer is not attached to an actor"};
+
+        if (renderer.staticBatch) renderer.staticBatch->removeRenderer(renderer);
+        renderer.staticBatch = this;
+
+        return addMember(renderer,
+                         *renderer.material,
+                         renderer.getActor()->getTransform(),
+                         renderer.meshData->indices,
+                         renderer.meshData->vertices);
+    }
+
+    StaticBatch::MemberId StaticBatch::add(SpriteRenderer& renderer)
+    {
+        const auto frame = renderer.getCurrentFrame();
+
+        if (!frame || !renderer.material)
+            throw std::runtime_error{"Sprite renderer is not initialized"};
+
+        if (!renderer.getActor())
+            throw std::runtime_error{"Sprite renderer is not attached to an actor"};
+
+        if (renderer.staticBatch) renderer.staticBatch->removeRenderer(renderer);
+        renderer.staticBatch = this;
+
+        const auto& frameIndices = frame->getIndices();
+
+        return addMember(renderer,
+                         *renderer.material,
+                         renderer.getActor()->getTransform() * renderer.offsetMatrix,
+                         std::vector<std::uint32_t>(frameIndices.begin(), frameIndices.end()),
+                         frame->getVertices());
+    }
+
+    StaticBatch::MemberId StaticBatch::addMember(Component& renderer,
+                                                 const graphics::Material& material,
+                                                 const math::Matrix<float, 4>& transform,
+                                                 const std::vector<std::uint32_t>& indices,
+                                                 const std::vector<graphics::Vertex>& vertices)
+    {
+        const auto memberId = layout.addMember(material, transform, indices, vertices);
+        renderers.push_back(&renderer);
+
+        renderer.setHidden(true);
+
+        return memberId;
+    }
+
+    void StaticBatch::build()
+    {
+        // the vertices are stored relative to the actor of the batch
+        layout.build(actor ? actor->getInverseTransform() : math::identityMatrix<float, 4>);
+        boundingBox = layout.getBoundingBox();
+
+        buffers.clear();
+
+        for (const auto& cell : layout.getCells())
+        {
+            auto& cellBuffers = buffers.emplace_back();
+
+            for (const auto& group : cell.groups)
+            {
+                auto& groupBuffers = cellBuffers.emplace_back();
+
+                if (group.vertices.size() > std::numeric_limits<std::uint16_t>::max() + 1U)
+                {
+                    groupBuffers.indexSize = sizeof(std::uint32_t);
+                    groupBuffers.indexBuffer = graphics::Buffer(engine->getGraphics(),
+                                                                graphics::BufferType::index,
+                                                                graphics::Flags::none,
+                                                                group.indices.data(),
+                                                                static_cast<std::uint32_t>(getVectorSize(group.indices)));
+                }
+                else
+                {
+                    std::vector<std::uint16_t> convertedIndices;
+                    convertedIndices.reserve(group.indices.size());
+
+                    for (const auto index : group.indices)
+                        convertedIndices.push_back(static_cast<std::uint16_t>(index));
+
+                    groupBuffers.indexSize = sizeof(std::uint16_t);
+                    groupBuffers.indexBuffer = graphics::Buffer(engine->getGraphics(),
+                                                                graphics::BufferType::index,
+                                                                graphics::Flags::none,
+                                                                convertedIndices.data(),
+                                                                static_cast<std::uint32_t>(getVectorSize(convertedIndices)));
+                }
+
+                groupBuffers.vertexBuffer = graphics::Buffer(engine->getGraphics(),
+                                                             graphics::BufferType::vertex,
+                                                             graphics::Flags::none,
+                                                             group.vertices.data(),
+                                                             static_cast<std::uint32_t>(getVectorSize(group.vertices)));
+            }
+        }
+
+        layout.releaseGeometry();
+    }
+
+    void StaticBatch::removeRenderer(const Component& renderer)
+    {
+        for (MemberId memberId = 0; memberId < renderers.size(); ++memberId)
+            if (renderers[memberId] == &renderer)
+            {
+                renderers[memberId] = nullptr;
+                layout.setMemberHidden(memberId, true);
+            }
+    }
+
+    void StaticBatch::clear()
+    {
+        for (const auto renderer : renderers)
+            if (renderer)
+            {
+                renderer->setHidden(false);
+                renderer->staticBatch = nullptr;
+            }
+
+        renderers.clear();
+        buffers.clear();
+        layout.clear();
+        math::reset(boundingBox);
+    }
+
+    bool StaticBatch::isMemberHidden(MemberId member) const
+    {
+        return layout.isMemberHidden(member);
+    }
+
+    void StaticBatch::setMemberHidden(MemberId member, bool memberHidden)
+    {
+        if (member >= renderers.size())
+            throw std::out_of_range{"Invalid member"};
+
+        // members whose renderer was destroyed stay hidden
+        if (renderers[member])
+            layout.setMemberHidden(member, memberHidden);
+    }
+
+    void StaticBatch::draw(const math::Matrix<float, 4>& transformMatrix,
+                           float opacity,
+                           const math::Matrix<float, 4>& renderViewProjection,
+                           bool wireframe)
+    {
+        Component::draw(transformMatrix,
+                        opacity,
+                        renderViewProjection,
+                        wireframe);
+
+        const auto modelViewProj = renderViewProjection * transformMatrix;
+        const auto frustum = math::getFrustum(modelViewProj);
+
+        std::vector<std::vector<float>> vertexShaderConstants(1);
+        vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
+
+        const auto& cells = layout.getCells();
+
+        for (std::size_t cellIndex = 0; cellIndex < cells.size(); ++cellIndex)
+        {
+            const auto& cell = cells[cellIndex];
+            if (!isBoxInside(frustum, cell.boundingBox)) continue;
+
+            for (std::size_t groupIndex = 0; groupIndex < cell.groups.size(); ++groupIndex)
+            {
+                const auto& material = cell.groups[groupIndex].material;
+                const auto& groupBuffers = buffers[cellIndex][groupIndex];
+                const auto colorVector = {
+                    material.diffuseColor.normR(),
+                    material.diffuseColor.normG(),
+                    material.diffuseColor.normB(),
+                    material.diffuseColor.normA() * opacity * material.opacity
+                };
+
+                std::vector<std::vector<float>> fragmentShaderConstants(1);
+                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+                const auto textures = getTextureResources(material);
+
+                engine->getGraphics().setPipelineState(material.blendState->getResource(),
+                                                       material.shader->getResource(),
+                                                       material.cullMode,
+                                                       wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
+                engine->getGraphics().setShaderConstants(fragmentShaderConstants, vertexShaderConstants);
+                engine->getGraphics().setTextures(textures);
+
+                // consecutive visible members are drawn with one draw call
+                layout.forEachDrawRange(cell.groups[groupIndex], [&groupBuffers](std::uint32_t startIndex, std::uint32_t indexCount) {
+                    engine->getGraphics().draw(groupBuffers.indexBuffer.getResource(),
+                                               indexCount,
+                                               groupBuffers.indexSize,
+                                               groupBuffers.vertexBuffer.getResource(),
+                                               graphics::DrawMode::triangleList,
+                                               startIndex);
+                });
+            }
+        }
+    }
+}
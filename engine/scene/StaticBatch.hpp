@@ -0,0 +1,70 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_STATICBATCH_HPP
+#define OUZEL_SCENE_STATICBATCH_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Component.hpp"
+#include "StaticBatchLayout.hpp"
+#include "../graphics/Buffer.hpp"
+
+namespace ouzel::scene
+{
+    class SpriteRenderer;
+    class StaticMeshRenderer;
+
+    // Merges the geometry of renderers whose actors never move into pre-transformed buffers
+    // The geometry is split into cells of the given size and every cell is culled as a unit
+    class StaticBatch: public Component
+    {
+    public:
+        using MemberId = StaticBatchLayout::MemberId;
+
+        explicit StaticBatch(float initCellSize = 1024.0F);
+        ~StaticBatch() override;
+
+        // copies the geometry of the renderer and hides it, the batch draws it after build() is called
+        // a renderer can be in one batch at a time
+        MemberId add(StaticMeshRenderer& renderer);
+        MemberId add(SpriteRenderer& renderer);
+
+        // called when a batched renderer is destroyed, its geometry stays in the buffers but is not drawn anymore
+        void removeRenderer(const Component& renderer);
+
+        void build();
+        // shows the batched renderers again and removes all the members
+        void clear();
+
+        [[nodiscard]] bool isMemberHidden(MemberId member) const;
+        void setMemberHidden(MemberId member, bool memberHidden);
+
+        [[nodiscard]] auto getCellSize() const noexcept { return layout.getCellSize(); }
+        [[nodiscard]] auto getCellCount() const noexcept { return layout.getCells().size(); }
+
+        void draw(const math::Matrix<float, 4>& transformMatrix,
+                  float opacity,
+                  const math::Matrix<float, 4>& renderViewProjection,
+                  bool wireframe) override;
+
+    private:
+        struct GroupBuffers final
+        {
+            graphics::Buffer indexBuffer;
+            graphics::Buffer vertexBuffer;
+            std::uint32_t indexSize;
+        };
+
+        MemberId addMember(Component& renderer,
+                           const graphics::Material& material,
+                           const math::Matrix<float, 4>& transform,
+                           const std::vector<std::uint32_t>& indices,
+                           const std::vector<graphics::Vertex>& vertices);
+
+        StaticBatchLayout layout;
+        std::vector<Component*> renderers; // for every member, nullptr after the renderer is destroyed
+        std::vector<std::vector<GroupBuffers>> buffers; // for every group of every cell
+    };
+}
+
+#endif // OUZEL_SCENE_STATICBATCH_HPP
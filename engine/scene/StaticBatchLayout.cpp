@@ -0,0 +1,186 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include "StaticBatchLayout.hpp"
+
+namespace ouzel::scene
+{
+    namespace
+    {
+        // materials that result in the same pipeline state and shader constants can share a draw call
+        bool isCompatible(const StaticBatchLayout::Material& material1,
+                          const StaticBatchLayout::Material& material2) noexcept
+        {
+            if (material1.blendState != material2.blendState ||
+                material1.shader != material2.shader ||
+                material1.cullMode != material2.cullMode ||
+                material1.diffuseColor != material2.diffuseColor ||
+                material1.opacity != material2.opacity)
+                return false;
+
+            for (std::size_t layer = 0; layer < graphics::Material::textureLayers; ++layer)
+                if (material1.textures[layer] != material2.textures[layer])
+                    return false;
+
+            return true;
+        }
+    }
+
+    StaticBatchLayout::Material::Material(const graphics::Material& material):
+        blendState{material.blendState},
+        shader{material.shader},
+        cullMode{material.cullMode},
+        diffuseColor{material.diffuseColor},
+        opacity{material.opacity}
+    {
+        std::copy(std::begin(material.textures), std::end(material.textures), std::begin(textures));
+    }
+
+    StaticBatchLayout::StaticBatchLayout(float initCellSize):
+        cellSize{initCellSize}
+    {
+        if (cellSize <= 0.0F)
+            throw std::runtime_error{"Invalid cell size"};
+    }
+
+    StaticBatchLayout::MemberId StaticBatchLayout::addMember(const graphics::Material& material,
+                                                             const math::Matrix<float, 4>& transform,
+                                                             const std::vector<std::uint32_t>& indices,
+                                                             const std::vector<graphics::Vertex>& vertices)
+    {
+        if (!material.blendState || !material.shader)
+            throw std::runtime_error{"Material is not initialized"};
+
+        Member member{Material{material}, indices, vertices, 0, 0, false};
+
+        // normals are transformed by the inverse transpose, so that they stay perpendicular under non-uniform scaling
+        const auto normalTransform = transposed(inverse(transform));
+
+        for (auto& vertex : member.vertices)
+        {
+            transformPoint(transform, vertex.position);
+            transformVector(normalTransform, vertex.normal);
+            normalize(vertex.normal);
+        }
+
+        members.push_back(std::move(member));
+        return members.size() - 1;
+    }
+
+    void StaticBatchLayout::build(const math::Matrix<float, 4>& inverseTransform)
+    {
+        cells.clear();
+        math::reset(boundingBox);
+
+        const auto normalTransform = transposed(inverse(inverseTransform));
+
+        std::map<std::array<std::int64_t, 3>, std::size_t> cellIndices;
+        std::vector<std::vector<graphics::Vertex>> memberVertices(members.size());
+
+        for (MemberId memberId = 0; memberId < members.size(); ++memberId)
+        {
+            auto& vertices = memberVertices[memberId];
+            vertices = members[memberId].vertices;
+
+            math::Box<float, 3> memberBox;
+            for (auto& vertex : vertices)
+            {
+                transformPoint(inverseTransform, vertex.position);
+                transformVector(normalTransform, vertex.normal);
+                normalize(vertex.normal);
+                insertPoint(memberBox, vertex.position);
+            }
+
+            if (vertices.empty()) continue;
+
+            // members are assigned to the cell that contains the center of their bounding box
+            const auto center = memberBox.getCenter();
+            const std::array<std::int64_t, 3> cellKey{
+                static_cast<std::int64_t>(std::floor(center.v[0] / cellSize)),
+                static_cast<std::int64_t>(std::floor(center.v[1] / cellSize)),
+                static_cast<std::int64_t>(std::floor(center.v[2] / cellSize))
+            };
+
+            auto cellIterator = cellIndices.find(cellKey);
+            if (cellIterator == cellIndices.end())
+            {
+                cellIterator = cellIndices.insert(std::pair(cellKey, cells.size())).first;
+                cells.emplace_back();
+            }
+
+            auto& cell = cells[cellIterator->second];
+            insertPoint(cell.boundingBox, memberBox.min);
+            insertPoint(cell.boundingBox, memberBox.max);
+
+            const auto& material = members[memberId].material;
+
+            auto groupIterator = std::find_if(cell.groups.begin(), cell.groups.end(),
+                                              [&material](const auto& group) noexcept {
+                                                  return isCompatible(group.material, material);
+                                              });
+
+            if (groupIterator == cell.groups.end())
+                groupIterator = cell.groups.insert(cell.groups.end(), Group{material, {}, {}, {}});
+
+            groupIterator->members.push_back(memberId);
+        }
+
+        for (auto& cell : cells)
+        {
+            insertPoint(boundingBox, cell.boundingBox.min);
+            insertPoint(boundingBox, cell.boundingBox.max);
+
+            for (auto& group : cell.groups)
+                for (const auto memberId : group.members)
+                {
+                    auto& member = members[memberId];
+                    const auto baseVertex = static_cast<std::uint32_t>(group.vertices.size());
+
+                    member.startIndex = static_cast<std::uint32_t>(group.indices.size());
+                    member.indexCount = static_cast<std::uint32_t>(member.indices.size());
+
+                    for (const auto index : member.indices)
+                        group.indices.push_back(baseVertex + index);
+
+                    group.vertices.insert(group.vertices.end(), memberVertices[memberId].begin(), memberVertices[memberId].end());
+                }
+        }
+    }
+
+    void StaticBatchLayout::releaseGeometry()
+    {
+        for (auto& cell : cells)
+            for (auto& group : cell.groups)
+            {
+                group.indices = std::vector<std::uint32_t>{};
+                group.vertices = std::vector<graphics::Vertex>{};
+            }
+    }
+
+    void StaticBatchLayout::clear()
+    {
+        members.clear();
+        cells.clear();
+        math::reset(boundingBox);
+    }
+
+    bool StaticBatchLayout::isMemberHidden(MemberId member) const
+    {
+        if (member >= members.size())
+            throw std::out_of_range{"Invalid member"};
+
+        return members[member].hidden;
+    }
+
+    void StaticBatchLayout::setMemberHidden(MemberId member, bool memberHidden)
+    {
+        if (member >= members.size())
+            throw std::out_of_range{"Invalid member"};
+
+        members[member].hidden = memberHidden;
+    }
+}
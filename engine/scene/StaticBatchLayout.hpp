@@ -0,0 +1,114 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_STATICBATCHLAYOUT_HPP
+#define OUZEL_SCENE_STATICBATCHLAYOUT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../graphics/Material.hpp"
+#include "../graphics/Vertex.hpp"
+#include "../math/Box.hpp"
+#include "../math/Matrix.hpp"
+
+namespace ouzel::scene
+{
+    // Splits the geometry of a static batch into cells and groups of members that share a draw call
+    class StaticBatchLayout final
+    {
+    public:
+        using MemberId = std::size_t;
+
+        // the part of a material that the batch draws with
+        // it is copied, so that the batch does not depend on the lifetime of the materials of the renderers
+        struct Material final
+        {
+            explicit Material(const graphics::Material& material);
+
+            const graphics::BlendState* blendState;
+            const graphics::Shader* shader;
+            std::shared_ptr<graphics::Texture> textures[graphics::Material::textureLayers];
+            graphics::CullMode cullMode;
+            math::Color diffuseColor;
+            float opacity;
+        };
+
+        struct Member final
+        {
+            Material material;
+            std::vector<std::uint32_t> indices; // kept, so that the batch can be rebuilt after it is moved or members are added
+            std::vector<graphics::Vertex> vertices; // in world space
+            std::uint32_t startIndex;
+            std::uint32_t indexCount;
+            bool hidden;
+        };
+
+        struct Group final
+        {
+            Material material;
+            std::vector<MemberId> members; // in the order of their index ranges
+            std::vector<std::uint32_t> indices; // released after they are uploaded
+            std::vector<graphics::Vertex> vertices; // relative to the batch, released after they are uploaded
+        };
+
+        struct Cell final
+        {
+            math::Box<float, 3> boundingBox;
+            std::vector<Group> groups; // one for every material
+        };
+
+        explicit StaticBatchLayout(float initCellSize);
+
+        MemberId addMember(const graphics::Material& material,
+                           const math::Matrix<float, 4>& transform,
+                           const std::vector<std::uint32_t>& indices,
+                           const std::vector<graphics::Vertex>& vertices);
+
+        // assigns the members to cells and groups and fills the geometry of the groups
+        void build(const math::Matrix<float, 4>& inverseTransform);
+        void releaseGeometry();
+        void clear();
+
+        [[nodiscard]] bool isMemberHidden(MemberId member) const;
+        void setMemberHidden(MemberId member, bool memberHidden);
+
+        // calls the function with the start index and index count of every run of consecutive visible members
+        template <class Function>
+        void forEachDrawRange(const Group& group, Function&& function) const
+        {
+            std::uint32_t startIndex = 0;
+            std::uint32_t indexCount = 0;
+
+            for (const auto memberId : group.members)
+            {
+                const auto& member = members[memberId];
+
+                if (!member.hidden)
+                {
+                    if (indexCount == 0) startIndex = member.startIndex;
+                    indexCount += member.indexCount;
+                }
+                else if (indexCount > 0)
+                {
+                    function(startIndex, indexCount);
+                    indexCount = 0;
+                }
+            }
+
+            if (indexCount > 0) function(startIndex, indexCount);
+        }
+
+        [[nodiscard]] auto getCellSize() const noexcept { return cellSize; }
+        [[nodiscard]] const auto& getCells() const noexcept { return cells; }
+        [[nodiscard]] auto getMemberCount() const noexcept { return members.size(); }
+        [[nodiscard]] const auto& getBoundingBox() const noexcept { return boundingBox; }
+
+    private:
+        float cellSize;
+        std::vector<Member> members;
+        std::vector<Cell> cells;
+        math::Box<float, 3> boundingBox;
+    };
+}
+
+#endif // OUZEL_SCENE_STATICBATCHLAYOUT_HPP
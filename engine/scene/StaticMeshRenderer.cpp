@@ -1,18 +1,24 @@
 // Ouzel by Elviss Strazdins
 
+#include <cassert>
+#include <algorithm>
 #include <limits>
+#include <stdexcept>
 #include "StaticMeshRenderer.hpp"
+#include "Camera.hpp"
+#include "Layer.hpp"
+#include "../assets/Cache.hpp"
 #include "../core/Engine.hpp"
 #include "../utils/Utils.hpp"
 
 namespace ouzel::scene
 {
-    StaticMeshData::StaticMeshData(const math::Box<float, 3>& initBoundingBox,
-                                   const std::vector<std::uint32_t> indices,
-                                   const std::vector<graphics::Vertex>& vertices,
-                                   const graphics::Material* initMaterial):
-        boundingBox{initBoundingBox},
-        material{initMaterial}
+    StaticMeshData::Lod::Lod(float initScreenSize,
+                             float initDistance,
+                             const std::vector<std::uint32_t>& indices,
+                             const std::vector<graphics::Vertex>& vertices):
+        screenSize{initScreenSize},
+        distance{initDistance}
     {
         indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -53,19 +59,104 @@ namespace ouzel::scene
                                         static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
-    StaticMeshRenderer::StaticMeshRenderer(const StaticMeshData& meshData)
+    StaticMeshData::StaticMeshData(const math::Box<float, 3>& initBoundingBox,
+                                   const std::vector<std::uint32_t>& initIndices,
+                                   const std::vector<graphics::Vertex>& initVertices,
+                                   const graphics::Material* initMaterial):
+        boundingBox{initBoundingBox},
+        material{initMaterial},
+        indices{initIndices},
+        vertices{initVertices}
+    {
+        lods.emplace_back(std::numeric_limits<float>::max(), 0.0F, indices, vertices);
+    }
+
+    void StaticMeshData::addLod(float screenSize,
+                                float distance,
+                                const std::vector<std::uint32_t>& lodIndices,
+                                const std::vector<graphics::Vertex>& lodVertices)
+    {
+        if (!lods.empty() && (screenSize > lods.back().screenSize || distance < lods.back().distance))
+            throw std::runtime_error{"Levels of detail must be added from the most detailed one"};
+
+        lods.emplace_back(screenSize, distance, lodIndices, lodVertices);
+    }
+
+    StaticMeshRenderer::StaticMeshRenderer(const StaticMeshData& initMeshData)
+    {
+        init(initMeshData);
+    }
+
+    void StaticMeshRenderer::init(const StaticMeshData& newMeshData)
     {
-        init(meshData);
+        meshData = &newMeshData;
+        boundingBox = newMeshData.boundingBox;
+        material = newMeshData.material;
+        lodStates.clear();
     }
 
-    void StaticMeshRenderer::init(const StaticMeshData& meshData)
+    void StaticMeshRenderer::selectLod(LodState& state,
+                                       const Camera& camera,
+                                       const math::Matrix<float, 4>& transformMatrix,
+                                       const math::Matrix<float, 4>& renderViewProjection) const
     {
-        boundingBox = meshData.boundingBox;
-        material = meshData.material;
-        indexCount = meshData.indexCount;
-        indexSize = meshData.indexSize;
-        indexBuffer = &meshData.indexBuffer;
-        vertexBuffer = &meshData.vertexBuffer;
+        const auto& lods = meshData->lods;
+
+        // radius of the bounding sphere in world space
+        float scale = 0.0F;
+        for (std::size_t column = 0; column < 3; ++column)
+            scale = std::max(scale, length(math::Vector<float, 3>{
+                transformMatrix.m.v[column * 4 + 0],
+                transformMatrix.m.v[column * 4 + 1],
+                transformMatrix.m.v[column * 4 + 2]
+            }));
+
+        const auto radius = length(boundingBox.max - boundingBox.min) * scale / 2.0F;
+        const auto center = boundingBox.getCenter();
+        const auto clipCenter = renderViewProjection * transformMatrix * math::Vector<float, 4>{center.v[0], center.v[1], center.v[2], 1.0F};
+
+        // w of the clip space position is the depth in view space
+        const auto distance = clipCenter.v[3] / camera.getLodBias();
+
+        // half height of the viewport in clip space per unit of the view space
+        const auto verticalScale = length(math::Vector<float, 3>{
+            renderViewProjection.m.v[0 * 4 + 1],
+            renderViewProjection.m.v[1 * 4 + 1],
+            renderViewProjection.m.v[2 * 4 + 1]
+        });
+
+        const auto screenSize = (clipCenter.v[3] > std::numeric_limits<float>::epsilon()) ?
+            radius * verticalScale / clipCenter.v[3] * camera.getLodBias() :
+            std::numeric_limits<float>::max();
+
+        // the hysteresis keeps meshes near a threshold from switching every frame
+        const auto isCoarser = [&](std::size_t level) noexcept {
+            return camera.getLodMetric() == Camera::LodMetric::distance ?
+                distance > lods[level].distance * (1.0F + lodHysteresis) :
+                screenSize < lods[level].screenSize * (1.0F - lodHysteresis);
+        };
+
+        const auto isFiner = [&](std::size_t level) noexcept {
+            return camera.getLodMetric() == Camera::LodMetric::distance ?
+                distance < lods[level].distance * (1.0F - lodHysteresis) :
+                screenSize > lods[level].screenSize * (1.0F + lodHysteresis);
+        };
+
+        auto level = std::min(state.level, lods.size() - 1);
+        while (level + 1 < lods.size() && isCoarser(level + 1)) ++level;
+        while (level > 0 && isFiner(level)) --level;
+
+        if (level != state.level)
+        {
+            if (lodFadeTime > 0.0F)
+            {
+                state.previousLevel = state.level;
+                state.fadeStart = engine->getUpdateTime();
+                state.fading = true;
+            }
+
+            state.level = level;
+        }
     }
 
     void StaticMeshRenderer::draw(const math::Matrix<float, 4>& transformMatrix,
@@ -78,6 +169,125 @@ namespace ouzel::scene
                         renderViewProjection,
                         wireframe);
 
+        if (!meshData || meshData->lods.empty() || !material) return;
+
+        const auto camera = layer ? layer->getCurrentCamera() : nullptr;
+        if (!camera || meshData->lods.size() == 1)
+        {
+            drawLod(0, transformMatrix, opacity, renderViewProjection, wireframe);
+            return;
+        }
+
+        auto& state = getLodState(*camera);
+        selectLod(state, *camera, transformMatrix, renderViewProjection);
+
+        if (state.fading)
+        {
+            // the update time advances with the fixed delta of benchmarks, so the fade is deterministic
+            const auto elapsed = static_cast<float>(engine->getUpdateTime() - state.fadeStart);
+            const auto progress = lodFadeTime > 0.0F ? elapsed / lodFadeTime : 1.0F;
+
+            if (progress < 1.0F)
+            {
+                drawLod(state.previousLevel, transformMatrix, opacity * (1.0F - progress), renderViewProjection, wireframe);
+                drawLod(state.level, transformMatrix, opacity * progress, renderViewProjection, wireframe);
+                return;
+            }
+
+            state.fading = false;
+        }
+
+        drawLod(state.level, transformMatrix, opacity, renderViewProjection, wireframe);
+    }
+
+    void StaticMeshRenderer::drawDepth(const math::Matrix<float, 4>& transformMatrix,
+                                       const math::Matrix<float, 4>& renderViewProjection)
+    {
+        if (!meshData || meshData->lods.empty() || !material) return;
+
+        const auto blendState = engine->getCache().getBlendState(blendNoColor);
+        const auto shader = engine->getCache().getShader(shaderColor);
+        if (!blendState || !shader) return;
+
+        std::size_t level = 0;
+
+        // the level is selected the same way as in the main pass, so that both passes write the same depth
+        if (const auto camera = layer ? layer->getCurrentCamera() : nullptr; camera && meshData->lods.size() > 1)
+        {
+            auto& state = getLodState(*camera);
+            selectLod(state, *camera, transformMatrix, renderViewProjection);
+
+            // levels that are being blended are not opaque
+            if (state.fading) return;
+
+            level = state.level;
+        }
+
+        const auto& lod = meshData->lods[level];
+        const auto modelViewProj = renderViewProjection * transformMatrix;
+
+        std::vector<std::vector<float>> fragmentShaderConstants(1);
+        fragmentShaderConstants[0] = {1.0F, 1.0F, 1.0F, 1.0F};
+
+        std::vector<std::vector<float>> vertexShaderConstants(1);
+        vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
+
+        engine->getGraphics().setPipelineState(blendState->getResource(),
+                                               shader->getResource(),
+                                               material->cullMode,
+                                               graphics::FillMode::solid);
+        engine->getGraphics().setShaderConstants(fragmentShaderConstants, vertexShaderConstants);
+        engine->getGraphics().setTextures({});
+        engine->getGraphics().draw(lod.indexBuffer.getResource(),
+                                   lod.indexCount,
+                                   lod.indexSize,
+                                   lod.vertexBuffer.getResource(),
+                                   graphics::DrawMode::triangleList,
+                                   0);
+    }
+
+    StaticMeshRenderer::LodState& StaticMeshRenderer::getLodState(const Camera& camera)
+    {
+        // drop the states of the cameras that were removed from the layer
+        if (layer)
+        {
+            const auto& cameras = layer->getCameras();
+            lodStates.erase(std::remove_if(lodStates.begin(), lodStates.end(), [&cameras](const auto& lodState) noexcept {
+                return std::find(cameras.begin(), cameras.end(), lodState.camera) == cameras.end();
+            }), lodStates.end());
+        }
+
+        auto state = std::find_if(lodStates.begin(), lodStates.end(), [&camera](const auto& lodState) noexcept {
+            return lodState.camera == &camera;
+        });
+
+        if (state == lodStates.end())
+            state = lodStates.insert(lodStates.end(), LodState{&camera, 0, 0, 0.0, false});
+
+        return *state;
+    }
+
+    void StaticMeshRenderer::drawLod(std::size_t level,
+                                     const math::Matrix<float, 4>& transformMatrix,
+                                     float opacity,
+                                     const math::Matrix<float, 4>& renderViewProjection,
+                                     bool wireframe)
+    {
+        const auto& lod = meshData->lods[level];
+        const auto lit = layer && material->litShader && layer->getLightClusters().isActive();
+
+        // opaque meshes sharing mesh data, level and material are drawn with a single instanced draw call
+        // at the end of the pass, blended meshes are drawn in place so that they keep the draw order
+        // after a depth pre-pass the mesh is drawn with the same transform math as in the pre-pass, so that the depth matches
+        if (!lit && layer && !layer->isDepthPrePassActive() &&
+            material->opaque && opacity >= 1.0F && material->instancedShader &&
+            engine->getGraphics().getDevice()->isInstancingSupported())
+        {
+            const graphics::Instance instance{transformMatrix, math::Color{1.0F, 1.0F, 1.0F, opacity}};
+            layer->getInstanceBatch().add(*meshData, level, *material, instance);
+            return;
+        }
+
         const auto modelViewProj = renderViewProjection * transformMatrix;
         const auto colorVector = {
             material->diffuseColor.normR(),
@@ -92,20 +302,39 @@ namespace ouzel::scene
         std::vector<std::vector<float>> vertexShaderConstants(1);
         vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
 
-        std::vector<std::size_t> textures;
-        for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
-            textures.push_back(texture ? texture->getResource() : 0);
+        auto textures = material->getTextureResources();
+
+        if (lit)
+        {
+            const auto& lightClusters = layer->getLightClusters();
+            // the clusters are only active when the driver has the lit shaders (only GLSL ones exist)
+            assert(lightClusters.getLightTexture() && lightClusters.getClusterTexture());
+
+            const auto modelView = lightClusters.getViewMatrix() * transformMatrix;
+            vertexShaderConstants.emplace_back(std::begin(modelView.m.v), std::end(modelView.m.v));
+
+            fragmentShaderConstants.push_back({
+                material->ambientColor.normR(),
+                material->ambientColor.normG(),
+                material->ambientColor.normB(),
+                material->ambientColor.normA()
+            });
+            lightClusters.getShaderConstants(fragmentShaderConstants);
+
+            textures[1] = lightClusters.getLightTexture()->getResource();
+            textures[2] = lightClusters.getClusterTexture()->getResource();
+        }
 
         engine->getGraphics().setPipelineState(material->blendState->getResource(),
-                                               material->shader->getResource(),
+                                               lit ? material->litShader->getResource() : material->shader->getResource(),
                                                material->cullMode,
                                                wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
         engine->getGraphics().setShaderConstants(fragmentShaderConstants, vertexShaderConstants);
         engine->getGraphics().setTextures(textures);
-        engine->getGraphics().draw(indexBuffer->getResource(),
-                                   indexCount,
-                                   indexSize,
-                                   vertexBuffer->getResource(),
+        engine->getGraphics().draw(lod.indexBuffer.getResource(),
+                                   lod.indexCount,
+                                   lod.indexSize,
+                                   lod.vertexBuffer.getResource(),
                                    graphics::DrawMode::triangleList,
                                    0);
     }
@@ -11,48 +11,106 @@
 
 namespace ouzel::scene
 {
+    class Camera;
+
     class StaticMeshData final
     {
     public:
+        class Lod final
+        {
+        public:
+            Lod(float initScreenSize,
+                float initDistance,
+                const std::vector<std::uint32_t>& indices,
+                const std::vector<graphics::Vertex>& vertices);
+
+            float screenSize; // the level is used when the mesh covers less than this part of the viewport height
+            float distance; // the level is used when the mesh is further away from the camera
+            std::uint32_t indexCount = 0;
+            std::uint32_t indexSize = 0;
+            graphics::Buffer indexBuffer;
+            graphics::Buffer vertexBuffer;
+        };
+
         StaticMeshData() = default;
         StaticMeshData(const math::Box<float, 3>& initBoundingBox,
-                       const std::vector<std::uint32_t> indices,
-                       const std::vector<graphics::Vertex>& vertices,
+                       const std::vector<std::uint32_t>& initIndices,
+                       const std::vector<graphics::Vertex>& initVertices,
                        const graphics::Material* initMaterial);
 
+        // levels have to be added from the most detailed to the least detailed one
+        void addLod(float screenSize,
+                    float distance,
+                    const std::vector<std::uint32_t>& lodIndices,
+                    const std::vector<graphics::Vertex>& lodVertices);
+
         math::Box<float, 3> boundingBox;
         const graphics::Material* material = nullptr;
-        std::uint32_t indexCount = 0;
-        std::uint32_t indexSize = 0;
-        graphics::Buffer indexBuffer;
-        graphics::Buffer vertexBuffer;
+        std::vector<std::uint32_t> indices; // kept for merging the mesh into static batches
+        std::vector<graphics::Vertex> vertices;
+        std::vector<Lod> lods; // the first level is the full mesh
     };
 
+    class StaticBatch;
+
     class StaticMeshRenderer: public Component
     {
+        friend StaticBatch;
     public:
         StaticMeshRenderer() = default;
-        explicit StaticMeshRenderer(const StaticMeshData& meshData);
+        explicit StaticMeshRenderer(const StaticMeshData& initMeshData);
 
-        void init(const StaticMeshData& meshData);
+        void init(const StaticMeshData& newMeshData);
 
         void draw(const math::Matrix<float, 4>& transformMatrix,
                   float opacity,
                   const math::Matrix<float, 4>& renderViewProjection,
                   bool wireframe) override;
+        void drawDepth(const math::Matrix<float, 4>& transformMatrix,
+                       const math::Matrix<float, 4>& renderViewProjection) override;
 
         auto& getMaterial() const noexcept { return material; }
+        const graphics::Material* getDrawMaterial() const noexcept override { return material; }
         void setMaterial(const graphics::Material* newMaterial)
         {
             material = newMaterial;
         }
 
+        // how far past a threshold the mesh has to get before the level changes, relative to the threshold
+        [[nodiscard]] auto getLodHysteresis() const noexcept { return lodHysteresis; }
+        void setLodHysteresis(float newLodHysteresis) noexcept { lodHysteresis = newLodHysteresis; }
+
+        // time in seconds to blend between levels, zero switches them instantly
+        [[nodiscard]] auto getLodFadeTime() const noexcept { return lodFadeTime; }
+        void setLodFadeTime(float newLodFadeTime) noexcept { lodFadeTime = newLodFadeTime; }
+
     private:
+        struct LodState final
+        {
+            const Camera* camera;
+            std::size_t level;
+            std::size_t previousLevel;
+            double fadeStart; // engine update time
+            bool fading;
+        };
+
+        LodState& getLodState(const Camera& camera);
+        void selectLod(LodState& state,
+                       const Camera& camera,
+                       const math::Matrix<float, 4>& transformMatrix,
+                       const math::Matrix<float, 4>& renderViewProjection) const;
+        void drawLod(std::size_t level,
+                     const math::Matrix<float, 4>& transformMatrix,
+                     float opacity,
+                     const math::Matrix<float, 4>& renderViewProjection,
+                     bool wireframe);
+
+        const StaticMeshData* meshData = nullptr;
         const graphics::Material* material = nullptr;
-        std::uint32_t indexCount = 0;
-        std::uint32_t indexSize = 0;
-        const graphics::Buffer* indexBuffer = nullptr;
-        const graphics::Buffer* vertexBuffer = nullptr;
+
+        float lodHysteresis = 0.1F;
+        float lodFadeTime = 0.0F;
+        std::vector<LodState> lodStates; // levels are selected separately for every camera
     };
 }
 
@@ -0,0 +1,83 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <stdexcept>
+#include "TileAnimation.hpp"
+
+namespace ouzel::scene
+{
+    void TileAnimation::reset(std::size_t tileCount)
+    {
+        tileFrames.resize(tileCount + 1);
+        for (std::size_t i = 0; i < tileFrames.size(); ++i)
+            tileFrames[i] = static_cast<TileId>(i);
+
+        animatedTiles.clear();
+        time = 0.0F;
+        ++version;
+    }
+
+    void TileAnimation::setAnimatedTile(TileId tile, const std::vector<TileId>& frames, float frameInterval)
+    {
+        if (tile == 0 || !isValidTile(tile))
+            throw std::runtime_error{"Invalid tile"};
+
+        if (frames.empty() || frameInterval <= 0.0F)
+            throw std::runtime_error{"Invalid tile animation"};
+
+        for (const auto frame : frames)
+            if (frame == 0 || !isValidTile(frame))
+                throw std::runtime_error{"Invalid tile"};
+
+        removeAnimatedTile(tile);
+        animatedTiles.push_back({tile, frames, frameInterval, 0});
+        setFrame(tile, frames.front());
+    }
+
+    bool TileAnimation::removeAnimatedTile(TileId tile)
+    {
+        const auto i = std::find_if(animatedTiles.begin(), animatedTiles.end(),
+                                    [tile](const auto& animatedTile) noexcept {
+                                        return animatedTile.tile == tile;
+                                    });
+
+        if (i == animatedTiles.end()) return false;
+
+        animatedTiles.erase(i);
+        setFrame(tile, tile);
+        return true;
+    }
+
+    void TileAnimation::update(float delta)
+    {
+        time += delta;
+
+        for (auto& animatedTile : animatedTiles)
+        {
+            const auto frame = static_cast<std::size_t>(time / animatedTile.frameInterval) % animatedTile.frames.size();
+
+            if (animatedTile.currentFrame != frame)
+            {
+                animatedTile.currentFrame = frame;
+                setFrame(animatedTile.tile, animatedTile.frames[frame]);
+            }
+        }
+    }
+
+    bool TileAnimation::isAnimated(TileId tile) const noexcept
+    {
+        return std::any_of(animatedTiles.begin(), animatedTiles.end(),
+                           [tile](const auto& animatedTile) noexcept {
+                               return animatedTile.tile == tile;
+                           });
+    }
+
+    void TileAnimation::setFrame(TileId tile, TileId frame)
+    {
+        if (tileFrames[tile] != frame)
+        {
+            tileFrames[tile] = frame;
+            ++version; // the animated chunks pick up the new frames when they are drawn
+        }
+    }
+}
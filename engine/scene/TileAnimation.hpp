@@ -0,0 +1,69 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_TILEANIMATION_HPP
+#define OUZEL_SCENE_TILEANIMATION_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace ouzel::scene
+{
+    // The animated tiles of a tile map and the UV indirection table, which maps every tile to the
+    // tileset tile that is currently shown. It decides how the chunks of the map have to be updated.
+    class TileAnimation final
+    {
+    public:
+        using TileId = std::uint16_t;
+
+        enum class ChunkUpdate
+        {
+            none,
+            frames, // only the texture coordinates of the tiles changed
+            rebuild
+        };
+
+        // tiles from 1 to tileCount show themselves, the animations are removed
+        void reset(std::size_t tileCount);
+
+        // the tile cycles through the given tiles
+        void setAnimatedTile(TileId tile, const std::vector<TileId>& frames, float frameInterval);
+        // returns false if the tile was not animated
+        bool removeAnimatedTile(TileId tile);
+
+        void update(float delta);
+
+        [[nodiscard]] bool isAnimated(TileId tile) const noexcept;
+        [[nodiscard]] bool isValidTile(TileId tile) const noexcept { return tile < tileFrames.size(); }
+        [[nodiscard]] auto getFrame(TileId tile) const noexcept { return tileFrames[tile]; }
+        [[nodiscard]] auto hasAnimatedTiles() const noexcept { return !animatedTiles.empty(); }
+
+        // changes every time a tile shows a different frame
+        [[nodiscard]] auto getVersion() const noexcept { return version; }
+
+        // a chunk that was built at the given version
+        [[nodiscard]] ChunkUpdate getChunkUpdate(bool dirty, bool animated, std::uint32_t chunkVersion) const noexcept
+        {
+            if (dirty) return ChunkUpdate::rebuild;
+            if (animated && chunkVersion != version) return ChunkUpdate::frames;
+            return ChunkUpdate::none;
+        }
+
+    private:
+        struct AnimatedTile final
+        {
+            TileId tile;
+            std::vector<TileId> frames;
+            float frameInterval;
+            std::size_t currentFrame;
+        };
+
+        void setFrame(TileId tile, TileId frame);
+
+        std::vector<TileId> tileFrames;
+        std::vector<AnimatedTile> animatedTiles;
+        std::uint32_t version = 0;
+        float time = 0.0F;
+    };
+}
+
+#endif // OUZEL_SCENE_TILEANIMATION_HPP
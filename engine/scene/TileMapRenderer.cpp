@@ -0,0 +1,323 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "TileMapRenderer.hpp"
+#include "../assets/Cache.hpp"
+#include "../core/Engine.hpp"
+#include "../math/ConvexVolume.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::scene
+{
+    TileMapRenderer::TileMapRenderer(std::shared_ptr<graphics::Texture> tileset,
+                                     const math::Size<std::uint32_t, 2>& newTileSize,
+                                     const math::Size<std::uint32_t, 2>& newMapSize,
+                                     std::size_t layerCount)
+    {
+        init(tileset, newTileSize, newMapSize, layerCount);
+    }
+
+    TileMapRenderer::~TileMapRenderer()
+    {
+        if (animationSystem) animationSystem->removeTileMap(*this);
+    }
+
+    void TileMapRenderer::init(std::shared_ptr<graphics::Texture> tileset,
+                               const math::Size<std::uint32_t, 2>& newTileSize,
+                               const math::Size<std::uint32_t, 2>& newMapSize,
+                               std::size_t layerCount)
+    {
+        if (!tileset)
+            throw std::runtime_error{"Invalid tileset"};
+
+        if (newTileSize.v[0] == 0 || newTileSize.v[1] == 0)
+            throw std::runtime_error{"Invalid tile size"};
+
+        tilesetColumns = tileset->getSize().v[0] / newTileSize.v[0];
+        tilesetRows = tileset->getSize().v[1] / newTileSize.v[1];
+
+        if (tilesetColumns * tilesetRows > std::numeric_limits<TileId>::max())
+            throw std::runtime_error{"Too many tiles in the tileset"};
+
+        material = std::make_shared<graphics::Material>();
+        material->cullMode = graphics::CullMode::none;
+        material->shader = engine->getCache().getShader(shaderTexture);
+        material->blendState = engine->getCache().getBlendState(blendAlpha);
+        material->textures[0] = tileset;
+
+        tileSize = newTileSize;
+        mapSize = newMapSize;
+        chunkCount = math::Size<std::uint32_t, 2>{
+            (mapSize.v[0] + chunkSize - 1) / chunkSize,
+            (mapSize.v[1] + chunkSize - 1) / chunkSize
+        };
+
+        layers.clear();
+        layers.resize(layerCount);
+
+        for (auto& tileLayer : layers)
+        {
+            tileLayer.chunks.resize(chunkCount.v[0] * chunkCount.v[1]);
+
+            for (std::uint32_t chunkY = 0; chunkY < chunkCount.v[1]; ++chunkY)
+                for (std::uint32_t chunkX = 0; chunkX < chunkCount.v[0]; ++chunkX)
+                {
+                    auto& chunk = tileLayer.chunks[chunkY * chunkCount.v[0] + chunkX];
+                    chunk.boundingBox.min = math::Vector<float, 3>{
+                        static_cast<float>(chunkX * chunkSize * tileSize.v[0]),
+                        static_cast<float>(chunkY * chunkSize * tileSize.v[1]),
+                        0.0F
+                    };
+                    chunk.boundingBox.max = math::Vector<float, 3>{
+                        static_cast<float>(std::min((chunkX + 1) * chunkSize, mapSize.v[0]) * tileSize.v[0]),
+                        static_cast<float>(std::min((chunkY + 1) * chunkSize, mapSize.v[1]) * tileSize.v[1]),
+                        0.0F
+                    };
+                }
+        }
+
+        animation.reset(tilesetColumns * tilesetRows);
+        if (animationSystem) animationSystem->removeTileMap(*this);
+
+        // all the chunks draw the quads with the same indices
+        std::vector<std::uint16_t> indices;
+        indices.reserve(chunkSize * chunkSize * 6);
+
+        for (std::uint32_t i = 0; i < chunkSize * chunkSize; ++i)
+        {
+            const auto first = static_cast<std::uint16_t>(i * 4);
+            for (const std::uint16_t index : {0, 1, 2, 1, 3, 2})
+                indices.push_back(static_cast<std::uint16_t>(first + index));
+        }
+
+        indexBuffer = graphics::Buffer(engine->getGraphics(),
+                                       graphics::BufferType::index,
+                                       graphics::Flags::none,
+                                       indices.data(),
+                                       static_cast<std::uint32_t>(getVectorSize(indices)));
+
+        boundingBox.min = math::Vector<float, 3>{0.0F, 0.0F, 0.0F};
+        boundingBox.max = math::Vector<float, 3>{
+            static_cast<float>(mapSize.v[0] * tileSize.v[0]),
+            static_cast<float>(mapSize.v[1] * tileSize.v[1]),
+            0.0F
+        };
+    }
+
+    TileMapRenderer::TileId TileMapRenderer::getTile(std::size_t layerIndex, std::uint32_t x, std::uint32_t y) const
+    {
+        return getChunk(layerIndex, x, y).tiles[(y % chunkSize) * chunkSize + x % chunkSize];
+    }
+
+    void TileMapRenderer::setTile(std::size_t layerIndex, std::uint32_t x, std::uint32_t y, TileId tile)
+    {
+        if (!animation.isValidTile(tile))
+            throw std::runtime_error{"Invalid tile"};
+
+        auto& chunk = getChunk(layerIndex, x, y);
+        auto& currentTile = chunk.tiles[(y % chunkSize) * chunkSize + x % chunkSize];
+
+        if (currentTile != tile)
+        {
+            currentTile = tile;
+            chunk.dirty = true;
+        }
+    }
+
+    void TileMapRenderer::setTiles(std::size_t layerIndex, const std::vector<TileId>& tiles)
+    {
+        if (tiles.size() != static_cast<std::size_t>(mapSize.v[0]) * mapSize.v[1])
+            throw std::runtime_error{"Invalid tile count"};
+
+        for (std::uint32_t y = 0; y < mapSize.v[1]; ++y)
+            for (std::uint32_t x = 0; x < mapSize.v[0]; ++x)
+                setTile(layerIndex, x, y, tiles[y * mapSize.v[0] + x]);
+    }
+
+    bool TileMapRenderer::isLayerHidden(std::size_t layerIndex) const
+    {
+        if (layerIndex >= layers.size())
+            throw std::out_of_range{"Invalid layer"};
+
+        return layers[layerIndex].hidden;
+    }
+
+    void TileMapRenderer::setLayerHidden(std::size_t layerIndex, bool layerHidden)
+    {
+        if (layerIndex >= layers.size())
+            throw std::out_of_range{"Invalid layer"};
+
+        layers[layerIndex].hidden = layerHidden;
+    }
+
+    void TileMapRenderer::setAnimatedTile(TileId tile, const std::vector<TileId>& frames, float frameInterval)
+    {
+        animation.setAnimatedTile(tile, frames, frameInterval);
+
+        // the chunks have to know which of them contain animated tiles
+        for (auto& tileLayer : layers)
+            for (auto& chunk : tileLayer.chunks)
+                if (!chunk.animated && std::find(chunk.tiles.begin(), chunk.tiles.end(), tile) != chunk.tiles.end())
+                    chunk.dirty = true;
+
+        if (!animationSystem) engine->getAnimationSystem().addTileMap(*this);
+    }
+
+    void TileMapRenderer::removeAnimatedTile(TileId tile)
+    {
+        if (animation.removeAnimatedTile(tile) && !animation.hasAnimatedTiles() && animationSystem)
+            animationSystem->removeTileMap(*this);
+    }
+
+    TileMapRenderer::Chunk& TileMapRenderer::getChunk(std::size_t layerIndex, std::uint32_t x, std::uint32_t y)
+    {
+        if (layerIndex >= layers.size() || x >= mapSize.v[0] || y >= mapSize.v[1])
+            throw std::out_of_range{"Invalid tile position"};
+
+        return layers[layerIndex].chunks[(y / chunkSize) * chunkCount.v[0] + x / chunkSize];
+    }
+
+    const TileMapRenderer::Chunk& TileMapRenderer::getChunk(std::size_t layerIndex, std::uint32_t x, std::uint32_t y) const
+    {
+        if (layerIndex >= layers.size() || x >= mapSize.v[0] || y >= mapSize.v[1])
+            throw std::out_of_range{"Invalid tile position"};
+
+        return layers[layerIndex].chunks[(y / chunkSize) * chunkCount.v[0] + x / chunkSize];
+    }
+
+    void TileMapRenderer::buildChunk(Chunk& chunk, TileAnimation::ChunkUpdate update)
+    {
+        const auto& textureSize = material->textures[0]->getSize();
+        const math::Vector<float, 2> tileTextureSize{
+            static_cast<float>(tileSize.v[0]) / static_cast<float>(textureSize.v[0]),
+            static_cast<float>(tileSize.v[1]) / static_cast<float>(textureSize.v[1])
+        };
+
+        vertices.clear();
+        chunk.animated = false;
+
+        for (std::uint32_t y = 0; y < chunkSize; ++y)
+            for (std::uint32_t x = 0; x < chunkSize; ++x)
+            {
+                const auto tile = chunk.tiles[y * chunkSize + x];
+                if (tile == emptyTile) continue;
+
+                if (animation.isAnimated(tile)) chunk.animated = true;
+
+                const std::uint32_t frame = animation.getFrame(tile) - 1U;
+                const math::Vector<float, 2> leftTop{
+                    static_cast<float>(frame % tilesetColumns) * tileTextureSize.v[0],
+                    static_cast<float>(frame / tilesetColumns) * tileTextureSize.v[1]
+                };
+                const math::Vector<float, 2> rightBottom = leftTop + tileTextureSize;
+
+                const auto left = chunk.boundingBox.min.v[0] + static_cast<float>(x * tileSize.v[0]);
+                const auto bottom = chunk.boundingBox.min.v[1] + static_cast<float>(y * tileSize.v[1]);
+                const auto right = left + static_cast<float>(tileSize.v[0]);
+                const auto top = bottom + static_cast<float>(tileSize.v[1]);
+
+                vertices.emplace_back(math::Vector<float, 3>{left, bottom, 0.0F}, math::whiteColor,
+                                      math::Vector<float, 2>{leftTop.v[0], rightBottom.v[1]},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                vertices.emplace_back(math::Vector<float, 3>{left, top, 0.0F}, math::whiteColor,
+                                      math::Vector<float, 2>{leftTop.v[0], leftTop.v[1]},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                vertices.emplace_back(math::Vector<float, 3>{right, bottom, 0.0F}, math::whiteColor,
+                                      math::Vector<float, 2>{rightBottom.v[0], rightBottom.v[1]},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+                vertices.emplace_back(math::Vector<float, 3>{right, top, 0.0F}, math::whiteColor,
+                                      math::Vector<float, 2>{rightBottom.v[0], leftTop.v[1]},
+                                      math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+            }
+
+        const auto quadCount = static_cast<std::uint32_t>(vertices.size() / 4);
+
+        // only the texture coordinates of an animated chunk change, so its buffer is updated in place
+        if (update == TileAnimation::ChunkUpdate::frames)
+            chunk.vertexBuffer.setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
+        else if (quadCount > 0)
+            chunk.vertexBuffer = graphics::Buffer(engine->getGraphics(),
+                                                  graphics::BufferType::vertex,
+                                                  chunk.animated ? graphics::Flags::dynamic : graphics::Flags::none,
+                                                  vertices.data(),
+                                                  static_cast<std::uint32_t>(getVectorSize(vertices)));
+        else
+            chunk.vertexBuffer = graphics::Buffer{};
+
+        chunk.quadCount = quadCount;
+        chunk.animationVersion = animation.getVersion();
+        chunk.dirty = false;
+    }
+
+    void TileMapRenderer::draw(const math::Matrix<float, 4>& transformMatrix,
+                               float opacity,
+                               const math::Matrix<float, 4>& renderViewProjection,
+                               bool wireframe)
+    {
+        Component::draw(transformMatrix,
+                        opacity,
+                        renderViewProjection,
+                        wireframe);
+
+        if (!material || layers.empty()) return;
+
+        const auto modelViewProj = renderViewProjection * transformMatrix;
+
+        // the map is flat, so the chunks are tested only against the side planes
+        const math::ConvexVolume<float> frustum{{
+            math::getFrustumLeftPlane(modelViewProj),
+            math::getFrustumRightPlane(modelViewProj),
+            math::getFrustumBottomPlane(modelViewProj),
+            math::getFrustumTopPlane(modelViewProj)
+        }};
+
+        const auto colorVector = {
+            material->diffuseColor.normR(),
+            material->diffuseColor.normG(),
+            material->diffuseColor.normB(),
+            material->diffuseColor.normA() * opacity * material->opacity
+        };
+
+        std::vector<std::vector<float>> fragmentShaderConstants(1);
+        fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+        std::vector<std::vector<float>> vertexShaderConstants(1);
+        vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
+
+        const auto textures = material->getTextureResources();
+
+        engine->getGraphics().setPipelineState(material->blendState->getResource(),
+                                               material->shader->getResource(),
+                                               material->cullMode,
+                                               wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
+        engine->getGraphics().setShaderConstants(fragmentShaderConstants,
+                                                 vertexShaderConstants);
+        engine->getGraphics().setTextures(textures);
+
+        for (auto& tileLayer : layers)
+        {
+            if (tileLayer.hidden) continue;
+
+            for (auto& chunk : tileLayer.chunks)
+            {
+                if (!isBoxInside(frustum, chunk.boundingBox)) continue;
+
+                // chunks are rebuilt only when they get visible
+                if (const auto update = animation.getChunkUpdate(chunk.dirty, chunk.animated, chunk.animationVersion);
+                    update != TileAnimation::ChunkUpdate::none)
+                    buildChunk(chunk, update);
+
+                if (chunk.quadCount == 0) continue;
+
+                engine->getGraphics().draw(indexBuffer.getResource(),
+                                           chunk.quadCount * 6,
+                                           sizeof(std::uint16_t),
+                                           chunk.vertexBuffer.getResource(),
+                                           graphics::DrawMode::triangleList,
+                                           0);
+            }
+        }
+    }
+}
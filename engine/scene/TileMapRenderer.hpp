@@ -0,0 +1,118 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_SCENE_TILEMAPRENDERER_HPP
+#define OUZEL_SCENE_TILEMAPRENDERER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Component.hpp"
+#include "TileAnimation.hpp"
+#include "../graphics/Buffer.hpp"
+#include "../graphics/Material.hpp"
+#include "../graphics/Texture.hpp"
+#include "../graphics/Vertex.hpp"
+#include "../math/Box.hpp"
+#include "../math/Size.hpp"
+
+namespace ouzel::scene
+{
+    class AnimationSystem;
+
+    // Renders a grid of tiles from a tileset atlas
+    // Tiles are stored in chunks and every chunk of a layer is drawn with one draw call
+    class TileMapRenderer: public Component
+    {
+        friend AnimationSystem;
+    public:
+        using TileId = TileAnimation::TileId;
+
+        static constexpr TileId emptyTile = 0; // tile n refers to the n-th tile of the tileset (counting from 1)
+        static constexpr std::uint32_t chunkSize = 64; // width and height of a chunk in tiles
+
+        TileMapRenderer() = default;
+        TileMapRenderer(std::shared_ptr<graphics::Texture> tileset,
+                        const math::Size<std::uint32_t, 2>& newTileSize,
+                        const math::Size<std::uint32_t, 2>& newMapSize,
+                        std::size_t layerCount = 1);
+        ~TileMapRenderer() override;
+
+        TileMapRenderer(const TileMapRenderer&) = delete;
+        TileMapRenderer& operator=(const TileMapRenderer&) = delete;
+
+        TileMapRenderer(TileMapRenderer&&) = delete;
+        TileMapRenderer& operator=(TileMapRenderer&&) = delete;
+
+        void init(std::shared_ptr<graphics::Texture> tileset,
+                  const math::Size<std::uint32_t, 2>& newTileSize,
+                  const math::Size<std::uint32_t, 2>& newMapSize,
+                  std::size_t layerCount = 1);
+
+        void draw(const math::Matrix<float, 4>& transformMatrix,
+                  float opacity,
+                  const math::Matrix<float, 4>& renderViewProjection,
+                  bool wireframe) override;
+
+        [[nodiscard]] auto& getMaterial() const noexcept { return material; }
+        void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
+
+        [[nodiscard]] auto& getTileSize() const noexcept { return tileSize; }
+        [[nodiscard]] auto& getMapSize() const noexcept { return mapSize; }
+        [[nodiscard]] auto getLayerCount() const noexcept { return layers.size(); }
+
+        // tile (0, 0) is in the bottom left corner of the map
+        [[nodiscard]] TileId getTile(std::size_t layerIndex, std::uint32_t x, std::uint32_t y) const;
+        void setTile(std::size_t layerIndex, std::uint32_t x, std::uint32_t y, TileId tile);
+        // sets all the tiles of a layer, row by row starting from the bottom
+        void setTiles(std::size_t layerIndex, const std::vector<TileId>& tiles);
+
+        [[nodiscard]] bool isLayerHidden(std::size_t layerIndex) const;
+        void setLayerHidden(std::size_t layerIndex, bool layerHidden);
+
+        // the tile cycles through the given tiles of the tileset, the animation system advances the frames
+        void setAnimatedTile(TileId tile, const std::vector<TileId>& frames, float frameInterval);
+        void removeAnimatedTile(TileId tile);
+
+    private:
+        struct Chunk final
+        {
+            std::vector<TileId> tiles = std::vector<TileId>(chunkSize * chunkSize, emptyTile);
+            math::Box<float, 3> boundingBox;
+            graphics::Buffer vertexBuffer;
+            std::uint32_t quadCount = 0;
+            std::uint32_t animationVersion = 0; // version of the animation when the texture coordinates were written
+            bool dirty = false;
+            bool animated = false; // has tiles with animations
+        };
+
+        struct TileLayer final
+        {
+            std::vector<Chunk> chunks;
+            bool hidden = false;
+        };
+
+        Chunk& getChunk(std::size_t layerIndex, std::uint32_t x, std::uint32_t y);
+        const Chunk& getChunk(std::size_t layerIndex, std::uint32_t x, std::uint32_t y) const;
+
+        void buildChunk(Chunk& chunk, TileAnimation::ChunkUpdate update);
+
+        std::shared_ptr<graphics::Material> material;
+        math::Size<std::uint32_t, 2> tileSize;
+        math::Size<std::uint32_t, 2> mapSize;
+        math::Size<std::uint32_t, 2> chunkCount;
+        std::uint32_t tilesetColumns = 0;
+        std::uint32_t tilesetRows = 0;
+
+        std::vector<TileLayer> layers;
+        graphics::Buffer indexBuffer; // shared by all the chunks
+
+        TileAnimation animation;
+
+        std::vector<graphics::Vertex> vertices;
+
+        AnimationSystem* animationSystem = nullptr; // set while the map has animated tiles
+        graphics::ResourceId animationSystemHandle = 0; // in the tile map pool of the animation system
+    };
+}
+
+#endif // OUZEL_SCENE_TILEMAPRENDERER_HPP
@@ -378,6 +378,13 @@ namespace ouzel::storage
 
     bool FileSystem::resourceFileExists(const Path& filename) const
     {
+        // readFile looks in the archives first
+        const auto& genericPath = filename.getGeneric();
+
+        for (const auto& archive : archives)
+            if (archive.second.fileExists(genericPath))
+                return true;
+
         if (filename.isAbsolute())
             return fileExists(filename);
         else
@@ -157,6 +157,9 @@ namespace samples
         cameraActor.setPosition(Vector<float, 3>{0.0F, 0.0F, 400.0F});
         cameraActor.addComponent(camera);
         layer.addChild(cameraActor);
+        // the box is drawn front to back and lays down depth before the sprites are blended
+        layer.setSortMode(scene::Layer::SortMode::depth);
+        layer.setDepthPrePass(true);
         addLayer(layer);
 
         // floor
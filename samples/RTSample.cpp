@@ -17,8 +17,7 @@ namespace samples
                                                           math::Size<std::uint32_t, 2>{256U, 256U},
                                                           graphics::Flags::bindRenderTarget |
                                                           graphics::Flags::bindShader, 1, 1)},
-        depthTexture{engine->getGraphics(), math::Size<std::uint32_t, 2>{256U, 256U}, graphics::Flags::bindRenderTarget | graphics::Flags::bindShader, 1, 1, graphics::PixelFormat::depth},
-        renderTarget{engine->getGraphics(), {renderTexture.get()}, &depthTexture}
+        renderGraph{engine->getGraphics()}
     {
         handler.gamepadHandler = [](const GamepadEvent& event) {
             if (event.type == Event::Type::gamepadButtonChange)
@@ -72,13 +71,9 @@ namespace samples
 
         addLayer(rtLayer);
 
-        rtCamera.setRenderTarget(&renderTarget);
-        rtCamera.setClearColorBuffer(true);
-        rtCamera.setClearColor(Color{0, 64, 0});
         rtCameraActor.addComponent(rtCamera);
         rtLayer.addChild(rtCameraActor);
 
-        camera1.setClearColorBuffer(true);
         camera1.setScaleMode(scene::Camera::ScaleMode::showAll);
         camera1.setTargetContentSize(math::Size<float, 2>{400.0F, 600.0F});
         camera1.setViewport(math::Rect<float>{0.0F, 0.0F, 0.5F, 1.0F});
@@ -113,4 +108,32 @@ namespace samples
         backButton.setPosition(Vector<float, 2>{-200.0F, -200.0F});
         menu.addWidget(backButton);
     }
+
+    void RTSample::draw()
+    {
+        // the render texture is sampled by a sprite, so it lives outside of the graph, but the depth
+        // texture is only needed while the character is drawn and comes from the pool of the graph
+        const auto renderTextureId = renderGraph.importTexture(renderTexture.get());
+
+        renderGraph.addPass("character", [this, renderTextureId](graphics::RenderGraph::PassBuilder& builder) {
+            builder.write(renderTextureId);
+            builder.setDepthStencil(builder.create({renderTexture->getSize(), graphics::PixelFormat::depth}));
+        }, [this](graphics::RenderGraph& graph) {
+            rtCamera.setRenderTarget(graph.getRenderTarget());
+            engine->getGraphics().clearRenderTarget(true, true, false, Color{0, 64, 0}, 1.0F, 0);
+            rtLayer.draw();
+        });
+
+        renderGraph.addPass("scene", [renderTextureId](graphics::RenderGraph::PassBuilder& builder) {
+            builder.read(renderTextureId);
+            builder.writeBackBuffer();
+        }, [this](graphics::RenderGraph&) {
+            engine->getGraphics().clearRenderTarget(true, false, false, blackColor, 1.0F, 0);
+            layer.draw();
+            guiLayer.draw();
+        });
+
+        renderGraph.execute();
+        engine->getGraphics().present();
+    }
 }
@@ -3,6 +3,7 @@
 #ifndef RTSAMPLE_HPP
 #define RTSAMPLE_HPP
 
+#include "graphics/RenderGraph.hpp"
 #include "gui/Widgets.hpp"
 #include "scene/Camera.hpp"
 #include "scene/Layer.hpp"
@@ -15,6 +16,8 @@ namespace samples
     public:
         RTSample();
 
+        void draw() override;
+
     private:
         ouzel::scene::Layer layer;
         ouzel::scene::Camera camera;
@@ -44,8 +47,7 @@ namespace samples
         ouzel::gui::Button backButton;
 
         std::shared_ptr<ouzel::graphics::Texture> renderTexture;
-        ouzel::graphics::Texture depthTexture;
-        ouzel::graphics::RenderTarget renderTarget;
+        ouzel::graphics::RenderGraph renderGraph;
     };
 }
 
@@ -0,0 +1,205 @@
+unsigned char TextureLitPSGL3_glsl[] = {
+  0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x33, 0x33, 0x30,
+  0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x76, 0x65, 0x63,
+  0x34, 0x20, 0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x3b, 0x0a, 0x75, 0x6e, 0x69,
+  0x66, 0x6f, 0x72, 0x6d, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x61, 0x6d,
+  0x62, 0x69, 0x65, 0x6e, 0x74, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x3b, 0x0a,
+  0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x76, 0x65, 0x63, 0x34,
+  0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x47, 0x72, 0x69, 0x64,
+  0x3b, 0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x76, 0x65,
+  0x63, 0x34, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x56, 0x69,
+  0x65, 0x77, 0x70, 0x6f, 0x72, 0x74, 0x3b, 0x0a, 0x75, 0x6e, 0x69, 0x66,
+  0x6f, 0x72, 0x6d, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x63, 0x6c, 0x75,
+  0x73, 0x74, 0x65, 0x72, 0x44, 0x65, 0x70, 0x74, 0x68, 0x3b, 0x0a, 0x75,
+  0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x73, 0x61, 0x6d, 0x70, 0x6c,
+  0x65, 0x72, 0x32, 0x44, 0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65,
+  0x30, 0x3b, 0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x73,
+  0x61, 0x6d, 0x70, 0x6c, 0x65, 0x72, 0x32, 0x44, 0x20, 0x74, 0x65, 0x78,
+  0x74, 0x75, 0x72, 0x65, 0x31, 0x3b, 0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f,
+  0x72, 0x6d, 0x20, 0x73, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x72, 0x32, 0x44,
+  0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x32, 0x3b, 0x0a, 0x69,
+  0x6e, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x65, 0x78, 0x43, 0x6f, 0x6c,
+  0x6f, 0x72, 0x3b, 0x0a, 0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20,
+  0x65, 0x78, 0x54, 0x65, 0x78, 0x43, 0x6f, 0x6f, 0x72, 0x64, 0x3b, 0x0a,
+  0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x65, 0x78, 0x56, 0x69,
+  0x65, 0x77, 0x50, 0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x3b, 0x0a,
+  0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x65, 0x78, 0x56, 0x69,
+  0x65, 0x77, 0x4e, 0x6f, 0x72, 0x6d, 0x61, 0x6c, 0x3b, 0x0a, 0x6f, 0x75,
+  0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x6f, 0x75, 0x74, 0x43, 0x6f,
+  0x6c, 0x6f, 0x72, 0x3b, 0x0a, 0x63, 0x6f, 0x6e, 0x73, 0x74, 0x20, 0x69,
+  0x6e, 0x74, 0x20, 0x64, 0x61, 0x74, 0x61, 0x57, 0x69, 0x64, 0x74, 0x68,
+  0x20, 0x3d, 0x20, 0x31, 0x30, 0x32, 0x34, 0x3b, 0x0a, 0x76, 0x65, 0x63,
+  0x34, 0x20, 0x66, 0x65, 0x74, 0x63, 0x68, 0x44, 0x61, 0x74, 0x61, 0x28,
+  0x73, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x72, 0x32, 0x44, 0x20, 0x64, 0x61,
+  0x74, 0x61, 0x2c, 0x20, 0x69, 0x6e, 0x74, 0x20, 0x69, 0x6e, 0x64, 0x65,
+  0x78, 0x29, 0x0a, 0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74,
+  0x75, 0x72, 0x6e, 0x20, 0x74, 0x65, 0x78, 0x65, 0x6c, 0x46, 0x65, 0x74,
+  0x63, 0x68, 0x28, 0x64, 0x61, 0x74, 0x61, 0x2c, 0x20, 0x69, 0x76, 0x65,
+  0x63, 0x32, 0x28, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x20, 0x25, 0x20, 0x64,
+  0x61, 0x74, 0x61, 0x57, 0x69, 0x64, 0x74, 0x68, 0x2c, 0x20, 0x69, 0x6e,
+  0x64, 0x65, 0x78, 0x20, 0x2f, 0x20, 0x64, 0x61, 0x74, 0x61, 0x57, 0x69,
+  0x64, 0x74, 0x68, 0x29, 0x2c, 0x20, 0x30, 0x29, 0x3b, 0x0a, 0x7d, 0x0a,
+  0x76, 0x65, 0x63, 0x33, 0x20, 0x67, 0x65, 0x74, 0x4c, 0x69, 0x67, 0x68,
+  0x74, 0x28, 0x69, 0x6e, 0x74, 0x20, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x2c,
+  0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x6e, 0x6f, 0x72, 0x6d, 0x61, 0x6c,
+  0x29, 0x0a, 0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34,
+  0x20, 0x70, 0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x52, 0x61, 0x6e,
+  0x67, 0x65, 0x20, 0x3d, 0x20, 0x66, 0x65, 0x74, 0x63, 0x68, 0x44, 0x61,
+  0x74, 0x61, 0x28, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x31, 0x2c,
+  0x20, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x20, 0x2a, 0x20, 0x33, 0x29, 0x3b,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x63, 0x6f,
+  0x6c, 0x6f, 0x72, 0x54, 0x79, 0x70, 0x65, 0x20, 0x3d, 0x20, 0x66, 0x65,
+  0x74, 0x63, 0x68, 0x44, 0x61, 0x74, 0x61, 0x28, 0x74, 0x65, 0x78, 0x74,
+  0x75, 0x72, 0x65, 0x31, 0x2c, 0x20, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x20,
+  0x2a, 0x20, 0x33, 0x20, 0x2b, 0x20, 0x31, 0x29, 0x3b, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x64, 0x69, 0x72, 0x65, 0x63,
+  0x74, 0x69, 0x6f, 0x6e, 0x41, 0x6e, 0x67, 0x6c, 0x65, 0x20, 0x3d, 0x20,
+  0x66, 0x65, 0x74, 0x63, 0x68, 0x44, 0x61, 0x74, 0x61, 0x28, 0x74, 0x65,
+  0x78, 0x74, 0x75, 0x72, 0x65, 0x31, 0x2c, 0x20, 0x69, 0x6e, 0x64, 0x65,
+  0x78, 0x20, 0x2a, 0x20, 0x33, 0x20, 0x2b, 0x20, 0x32, 0x29, 0x3b, 0x0a,
+  0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x6c, 0x69, 0x67,
+  0x68, 0x74, 0x44, 0x69, 0x72, 0x65, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20,
+  0x3d, 0x20, 0x2d, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74, 0x69, 0x6f, 0x6e,
+  0x41, 0x6e, 0x67, 0x6c, 0x65, 0x2e, 0x78, 0x79, 0x7a, 0x3b, 0x0a, 0x20,
+  0x20, 0x20, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 0x61, 0x74, 0x74,
+  0x65, 0x6e, 0x75, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x3d, 0x20, 0x31,
+  0x2e, 0x30, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x28,
+  0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x54, 0x79, 0x70, 0x65, 0x2e, 0x77, 0x20,
+  0x3c, 0x20, 0x31, 0x2e, 0x35, 0x29, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x7b,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63,
+  0x33, 0x20, 0x6f, 0x66, 0x66, 0x73, 0x65, 0x74, 0x20, 0x3d, 0x20, 0x70,
+  0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x52, 0x61, 0x6e, 0x67, 0x65,
+  0x2e, 0x78, 0x79, 0x7a, 0x20, 0x2d, 0x20, 0x65, 0x78, 0x56, 0x69, 0x65,
+  0x77, 0x50, 0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x3b, 0x0a, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74,
+  0x20, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x44, 0x69, 0x73, 0x74, 0x61, 0x6e,
+  0x63, 0x65, 0x20, 0x3d, 0x20, 0x6c, 0x65, 0x6e, 0x67, 0x74, 0x68, 0x28,
+  0x6f, 0x66, 0x66, 0x73, 0x65, 0x74, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x44, 0x69,
+  0x72, 0x65, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x3d, 0x20, 0x6f, 0x66,
+  0x66, 0x73, 0x65, 0x74, 0x20, 0x2f, 0x20, 0x6d, 0x61, 0x78, 0x28, 0x6c,
+  0x69, 0x67, 0x68, 0x74, 0x44, 0x69, 0x73, 0x74, 0x61, 0x6e, 0x63, 0x65,
+  0x2c, 0x20, 0x30, 0x2e, 0x30, 0x30, 0x30, 0x31, 0x29, 0x3b, 0x0a, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74,
+  0x20, 0x66, 0x61, 0x6c, 0x6c, 0x6f, 0x66, 0x66, 0x20, 0x3d, 0x20, 0x63,
+  0x6c, 0x61, 0x6d, 0x70, 0x28, 0x31, 0x2e, 0x30, 0x20, 0x2d, 0x20, 0x6c,
+  0x69, 0x67, 0x68, 0x74, 0x44, 0x69, 0x73, 0x74, 0x61, 0x6e, 0x63, 0x65,
+  0x20, 0x2f, 0x20, 0x70, 0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x52,
+  0x61, 0x6e, 0x67, 0x65, 0x2e, 0x77, 0x2c, 0x20, 0x30, 0x2e, 0x30, 0x2c,
+  0x20, 0x31, 0x2e, 0x30, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x61, 0x74, 0x74, 0x65, 0x6e, 0x75, 0x61, 0x74, 0x69,
+  0x6f, 0x6e, 0x20, 0x3d, 0x20, 0x66, 0x61, 0x6c, 0x6c, 0x6f, 0x66, 0x66,
+  0x20, 0x2a, 0x20, 0x66, 0x61, 0x6c, 0x6c, 0x6f, 0x66, 0x66, 0x3b, 0x0a,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x28,
+  0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x54, 0x79, 0x70, 0x65, 0x2e, 0x77, 0x20,
+  0x3e, 0x20, 0x30, 0x2e, 0x35, 0x29, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x61, 0x74, 0x74, 0x65, 0x6e,
+  0x75, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x2a, 0x3d, 0x20, 0x73, 0x6d,
+  0x6f, 0x6f, 0x74, 0x68, 0x73, 0x74, 0x65, 0x70, 0x28, 0x64, 0x69, 0x72,
+  0x65, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x41, 0x6e, 0x67, 0x6c, 0x65, 0x2e,
+  0x77, 0x2c, 0x20, 0x6d, 0x69, 0x78, 0x28, 0x64, 0x69, 0x72, 0x65, 0x63,
+  0x74, 0x69, 0x6f, 0x6e, 0x41, 0x6e, 0x67, 0x6c, 0x65, 0x2e, 0x77, 0x2c,
+  0x20, 0x31, 0x2e, 0x30, 0x2c, 0x20, 0x30, 0x2e, 0x31, 0x29, 0x2c, 0x20,
+  0x64, 0x6f, 0x74, 0x28, 0x2d, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x44, 0x69,
+  0x72, 0x65, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x2c, 0x20, 0x64, 0x69, 0x72,
+  0x65, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x41, 0x6e, 0x67, 0x6c, 0x65, 0x2e,
+  0x78, 0x79, 0x7a, 0x29, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x7d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x20,
+  0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x54, 0x79, 0x70, 0x65, 0x2e, 0x72, 0x67,
+  0x62, 0x20, 0x2a, 0x20, 0x61, 0x74, 0x74, 0x65, 0x6e, 0x75, 0x61, 0x74,
+  0x69, 0x6f, 0x6e, 0x20, 0x2a, 0x20, 0x6d, 0x61, 0x78, 0x28, 0x64, 0x6f,
+  0x74, 0x28, 0x6e, 0x6f, 0x72, 0x6d, 0x61, 0x6c, 0x2c, 0x20, 0x6c, 0x69,
+  0x67, 0x68, 0x74, 0x44, 0x69, 0x72, 0x65, 0x63, 0x74, 0x69, 0x6f, 0x6e,
+  0x29, 0x2c, 0x20, 0x30, 0x2e, 0x30, 0x29, 0x3b, 0x0a, 0x7d, 0x0a, 0x76,
+  0x6f, 0x69, 0x64, 0x20, 0x6d, 0x61, 0x69, 0x6e, 0x28, 0x29, 0x0a, 0x7b,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x6e, 0x6f,
+  0x72, 0x6d, 0x61, 0x6c, 0x20, 0x3d, 0x20, 0x6e, 0x6f, 0x72, 0x6d, 0x61,
+  0x6c, 0x69, 0x7a, 0x65, 0x28, 0x65, 0x78, 0x56, 0x69, 0x65, 0x77, 0x4e,
+  0x6f, 0x72, 0x6d, 0x61, 0x6c, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x76, 0x65, 0x63, 0x33, 0x20, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x20, 0x3d,
+  0x20, 0x61, 0x6d, 0x62, 0x69, 0x65, 0x6e, 0x74, 0x43, 0x6f, 0x6c, 0x6f,
+  0x72, 0x2e, 0x72, 0x67, 0x62, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x69,
+  0x6e, 0x74, 0x20, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74, 0x69, 0x6f, 0x6e,
+  0x61, 0x6c, 0x43, 0x6f, 0x75, 0x6e, 0x74, 0x20, 0x3d, 0x20, 0x69, 0x6e,
+  0x74, 0x28, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x47, 0x72, 0x69,
+  0x64, 0x2e, 0x77, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6f,
+  0x72, 0x20, 0x28, 0x69, 0x6e, 0x74, 0x20, 0x69, 0x20, 0x3d, 0x20, 0x30,
+  0x3b, 0x20, 0x69, 0x20, 0x3c, 0x20, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74,
+  0x69, 0x6f, 0x6e, 0x61, 0x6c, 0x43, 0x6f, 0x75, 0x6e, 0x74, 0x3b, 0x20,
+  0x2b, 0x2b, 0x69, 0x29, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x20, 0x2b, 0x3d, 0x20, 0x67, 0x65,
+  0x74, 0x4c, 0x69, 0x67, 0x68, 0x74, 0x28, 0x69, 0x2c, 0x20, 0x6e, 0x6f,
+  0x72, 0x6d, 0x61, 0x6c, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x66,
+  0x6c, 0x6f, 0x61, 0x74, 0x20, 0x64, 0x65, 0x70, 0x74, 0x68, 0x20, 0x3d,
+  0x20, 0x2d, 0x65, 0x78, 0x56, 0x69, 0x65, 0x77, 0x50, 0x6f, 0x73, 0x69,
+  0x74, 0x69, 0x6f, 0x6e, 0x2e, 0x7a, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 0x73, 0x6c, 0x69, 0x63, 0x65, 0x20,
+  0x3d, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x44, 0x65, 0x70,
+  0x74, 0x68, 0x2e, 0x7a, 0x20, 0x3e, 0x20, 0x30, 0x2e, 0x35, 0x20, 0x3f,
+  0x20, 0x6c, 0x6f, 0x67, 0x28, 0x6d, 0x61, 0x78, 0x28, 0x64, 0x65, 0x70,
+  0x74, 0x68, 0x20, 0x2f, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72,
+  0x44, 0x65, 0x70, 0x74, 0x68, 0x2e, 0x78, 0x2c, 0x20, 0x31, 0x2e, 0x30,
+  0x29, 0x29, 0x20, 0x3a, 0x20, 0x64, 0x65, 0x70, 0x74, 0x68, 0x20, 0x2d,
+  0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x44, 0x65, 0x70, 0x74,
+  0x68, 0x2e, 0x78, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x69, 0x76, 0x65,
+  0x63, 0x33, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x20, 0x3d,
+  0x20, 0x69, 0x76, 0x65, 0x63, 0x33, 0x28, 0x69, 0x76, 0x65, 0x63, 0x32,
+  0x28, 0x28, 0x67, 0x6c, 0x5f, 0x46, 0x72, 0x61, 0x67, 0x43, 0x6f, 0x6f,
+  0x72, 0x64, 0x2e, 0x78, 0x79, 0x20, 0x2d, 0x20, 0x63, 0x6c, 0x75, 0x73,
+  0x74, 0x65, 0x72, 0x56, 0x69, 0x65, 0x77, 0x70, 0x6f, 0x72, 0x74, 0x2e,
+  0x78, 0x79, 0x29, 0x20, 0x2a, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65,
+  0x72, 0x56, 0x69, 0x65, 0x77, 0x70, 0x6f, 0x72, 0x74, 0x2e, 0x7a, 0x77,
+  0x29, 0x2c, 0x20, 0x69, 0x6e, 0x74, 0x28, 0x73, 0x6c, 0x69, 0x63, 0x65,
+  0x20, 0x2a, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x44, 0x65,
+  0x70, 0x74, 0x68, 0x2e, 0x79, 0x29, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x20, 0x3d, 0x20, 0x63,
+  0x6c, 0x61, 0x6d, 0x70, 0x28, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72,
+  0x2c, 0x20, 0x69, 0x76, 0x65, 0x63, 0x33, 0x28, 0x30, 0x29, 0x2c, 0x20,
+  0x69, 0x76, 0x65, 0x63, 0x33, 0x28, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65,
+  0x72, 0x47, 0x72, 0x69, 0x64, 0x2e, 0x78, 0x79, 0x7a, 0x29, 0x20, 0x2d,
+  0x20, 0x31, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x69, 0x6e, 0x74,
+  0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x43, 0x6f, 0x75, 0x6e,
+  0x74, 0x20, 0x3d, 0x20, 0x69, 0x6e, 0x74, 0x28, 0x63, 0x6c, 0x75, 0x73,
+  0x74, 0x65, 0x72, 0x47, 0x72, 0x69, 0x64, 0x2e, 0x78, 0x20, 0x2a, 0x20,
+  0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x47, 0x72, 0x69, 0x64, 0x2e,
+  0x79, 0x20, 0x2a, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x47,
+  0x72, 0x69, 0x64, 0x2e, 0x7a, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x76, 0x65, 0x63, 0x34, 0x20, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x4c, 0x69,
+  0x73, 0x74, 0x20, 0x3d, 0x20, 0x66, 0x65, 0x74, 0x63, 0x68, 0x44, 0x61,
+  0x74, 0x61, 0x28, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x32, 0x2c,
+  0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x2e, 0x78, 0x20, 0x2b,
+  0x20, 0x28, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x2e, 0x79, 0x20,
+  0x2b, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x2e, 0x7a, 0x20,
+  0x2a, 0x20, 0x69, 0x6e, 0x74, 0x28, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65,
+  0x72, 0x47, 0x72, 0x69, 0x64, 0x2e, 0x79, 0x29, 0x29, 0x20, 0x2a, 0x20,
+  0x69, 0x6e, 0x74, 0x28, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x47,
+  0x72, 0x69, 0x64, 0x2e, 0x78, 0x29, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x66, 0x6f, 0x72, 0x20, 0x28, 0x69, 0x6e, 0x74, 0x20, 0x69, 0x20,
+  0x3d, 0x20, 0x30, 0x3b, 0x20, 0x69, 0x20, 0x3c, 0x20, 0x69, 0x6e, 0x74,
+  0x28, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x4c, 0x69, 0x73, 0x74, 0x2e, 0x79,
+  0x29, 0x3b, 0x20, 0x2b, 0x2b, 0x69, 0x29, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x6e,
+  0x74, 0x20, 0x65, 0x6e, 0x74, 0x72, 0x79, 0x20, 0x3d, 0x20, 0x69, 0x6e,
+  0x74, 0x28, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x4c, 0x69, 0x73, 0x74, 0x2e,
+  0x78, 0x29, 0x20, 0x2b, 0x20, 0x69, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x69, 0x6e, 0x64,
+  0x69, 0x63, 0x65, 0x73, 0x20, 0x3d, 0x20, 0x66, 0x65, 0x74, 0x63, 0x68,
+  0x44, 0x61, 0x74, 0x61, 0x28, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65,
+  0x32, 0x2c, 0x20, 0x63, 0x6c, 0x75, 0x73, 0x74, 0x65, 0x72, 0x43, 0x6f,
+  0x75, 0x6e, 0x74, 0x20, 0x2b, 0x20, 0x65, 0x6e, 0x74, 0x72, 0x79, 0x20,
+  0x2f, 0x20, 0x34, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x6c, 0x69, 0x67, 0x68, 0x74, 0x20, 0x2b, 0x3d, 0x20, 0x67,
+  0x65, 0x74, 0x4c, 0x69, 0x67, 0x68, 0x74, 0x28, 0x69, 0x6e, 0x74, 0x28,
+  0x69, 0x6e, 0x64, 0x69, 0x63, 0x65, 0x73, 0x5b, 0x65, 0x6e, 0x74, 0x72,
+  0x79, 0x20, 0x25, 0x20, 0x34, 0x5d, 0x29, 0x2c, 0x20, 0x6e, 0x6f, 0x72,
+  0x6d, 0x61, 0x6c, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x7d, 0x0a,
+  0x20, 0x20, 0x20, 0x20, 0x6f, 0x75, 0x74, 0x43, 0x6f, 0x6c, 0x6f, 0x72,
+  0x20, 0x3d, 0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x28, 0x74,
+  0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x30, 0x2c, 0x20, 0x65, 0x78, 0x54,
+  0x65, 0x78, 0x43, 0x6f, 0x6f, 0x72, 0x64, 0x29, 0x20, 0x2a, 0x20, 0x65,
+  0x78, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x2a, 0x20, 0x63, 0x6f, 0x6c,
+  0x6f, 0x72, 0x20, 0x2a, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x6c, 0x69,
+  0x67, 0x68, 0x74, 0x2c, 0x20, 0x31, 0x2e, 0x30, 0x29, 0x3b, 0x0a, 0x7d,
+  0x0a
+};
+unsigned int TextureLitPSGL3_glsl_len = 2413;
@@ -0,0 +1,61 @@
+#version 300 es
+precision highp float;
+precision highp int;
+uniform lowp vec4 color;
+uniform lowp vec4 ambientColor;
+uniform vec4 clusterGrid;
+uniform vec4 clusterViewport;
+uniform vec4 clusterDepth;
+uniform lowp sampler2D texture0;
+uniform highp sampler2D texture1;
+uniform highp sampler2D texture2;
+in lowp vec4 exColor;
+in vec2 exTexCoord;
+in vec3 exViewPosition;
+in vec3 exViewNormal;
+out vec4 outColor;
+const int dataWidth = 1024;
+vec4 fetchData(highp sampler2D data, int index)
+{
+    return texelFetch(data, ivec2(index % dataWidth, index / dataWidth), 0);
+}
+vec3 getLight(int index, vec3 normal)
+{
+    vec4 positionRange = fetchData(texture1, index * 3);
+    vec4 colorType = fetchData(texture1, index * 3 + 1);
+    vec4 directionAngle = fetchData(texture1, index * 3 + 2);
+    vec3 lightDirection = -directionAngle.xyz;
+    float attenuation = 1.0;
+    if (colorType.w < 1.5)
+    {
+        vec3 offset = positionRange.xyz - exViewPosition;
+        float lightDistance = length(offset);
+        lightDirection = offset / max(lightDistance, 0.0001);
+        float falloff = clamp(1.0 - lightDistance / positionRange.w, 0.0, 1.0);
+        attenuation = falloff * falloff;
+        if (colorType.w > 0.5)
+            attenuation *= smoothstep(directionAngle.w, mix(directionAngle.w, 1.0, 0.1), dot(-lightDirection, directionAngle.xyz));
+    }
+    return colorType.rgb * attenuation * max(dot(normal, lightDirection), 0.0);
+}
+void main()
+{
+    vec3 normal = normalize(exViewNormal);
+    vec3 light = ambientColor.rgb;
+    int directionalCount = int(clusterGrid.w);
+    for (int i = 0; i < directionalCount; ++i)
+        light += getLight(i, normal);
+    float depth = -exViewPosition.z;
+    float slice = clusterDepth.z > 0.5 ? log(max(depth / clusterDepth.x, 1.0)) : depth - clusterDepth.x;
+    ivec3 cluster = ivec3(ivec2((gl_FragCoord.xy - clusterViewport.xy) * clusterViewport.zw), int(slice * clusterDepth.y));
+    cluster = clamp(cluster, ivec3(0), ivec3(clusterGrid.xyz) - 1);
+    int clusterCount = int(clusterGrid.x * clusterGrid.y * clusterGrid.z);
+    vec4 lightList = fetchData(texture2, cluster.x + (cluster.y + cluster.z * int(clusterGrid.y)) * int(clusterGrid.x));
+    for (int i = 0; i < int(lightList.y); ++i)
+    {
+        int entry = int(lightList.x) + i;
+        vec4 indices = fetchData(texture2, clusterCount + entry / 4);
+        light += getLight(int(indices[entry % 4]), normal);
+    }
+    outColor = texture(texture0, exTexCoord) * exColor * color * vec4(light, 1.0);
+}
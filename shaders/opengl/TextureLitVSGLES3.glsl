@@ -0,0 +1,20 @@
+#version 300 es
+precision highp float;
+in vec3 position0;
+in vec4 color0;
+in vec2 texCoord0;
+in vec3 normal0;
+uniform mat4 modelViewProj;
+uniform mat4 modelView;
+out lowp vec4 exColor;
+out vec2 exTexCoord;
+out vec3 exViewPosition;
+out vec3 exViewNormal;
+void main()
+{
+    gl_Position = modelViewProj * vec4(position0, 1.0);
+    exColor = color0;
+    exTexCoord = texCoord0;
+    exViewPosition = (modelView * vec4(position0, 1.0)).xyz;
+    exViewNormal = mat3(modelView) * normal0;
+}
@@ -9,12 +9,18 @@ xxd -i ColorPSGL3.glsl ColorPSGL3.h
 xxd -i ColorVSGL3.glsl ColorVSGL3.h
 xxd -i TexturePSGL3.glsl TexturePSGL3.h
 xxd -i TextureVSGL3.glsl TextureVSGL3.h
+xxd -i TextureInstancedVSGL3.glsl TextureInstancedVSGL3.h
+xxd -i TextureLitPSGL3.glsl TextureLitPSGL3.h
+xxd -i TextureLitVSGL3.glsl TextureLitVSGL3.h
 
 # OpenGL 4
 xxd -i ColorPSGL4.glsl ColorPSGL4.h
 xxd -i ColorVSGL4.glsl ColorVSGL4.h
 xxd -i TexturePSGL4.glsl TexturePSGL4.h
 xxd -i TextureVSGL4.glsl TextureVSGL4.h
+xxd -i TextureInstancedVSGL4.glsl TextureInstancedVSGL4.h
+xxd -i TextureLitPSGL4.glsl TextureLitPSGL4.h
+xxd -i TextureLitVSGL4.glsl TextureLitVSGL4.h
 
 # OpenGL ES 2
 xxd -i ColorPSGLES2.glsl ColorPSGLES2.h
@@ -26,4 +32,7 @@ xxd -i TextureVSGLES2.glsl TextureVSGLES2.h
 xxd -i ColorPSGLES3.glsl ColorPSGLES3.h
 xxd -i ColorVSGLES3.glsl ColorVSGLES3.h
 xxd -i TexturePSGLES3.glsl TexturePSGLES3.h
-xxd -i TextureVSGLES3.glsl TextureVSGLES3.h
\ No newline at end of file
+xxd -i TextureVSGLES3.glsl TextureVSGLES3.h
+xxd -i TextureInstancedVSGLES3.glsl TextureInstancedVSGLES3.h
+xxd -i TextureLitPSGLES3.glsl TextureLitPSGLES3.h
+xxd -i TextureLitVSGLES3.glsl TextureLitVSGLES3.h
\ No newline at end of file
@@ -0,0 +1,96 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "Test.hpp"
+#include "graphics/BlockDecoder.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        std::vector<std::uint8_t> getPixel(const std::vector<std::uint8_t>& pixels,
+                                           std::uint32_t width,
+                                           std::uint32_t x,
+                                           std::uint32_t y,
+                                           std::uint32_t pixelSize)
+        {
+            const auto begin = pixels.begin() + (y * width + x) * pixelSize;
+            return std::vector<std::uint8_t>(begin, begin + pixelSize);
+        }
+    }
+
+    void testBlockDecoder()
+    {
+        const math::Size<std::uint32_t, 2> blockSize{4U, 4U};
+
+        // red and blue end points, the first four pixels use each of the palette entries
+        const std::vector<std::uint8_t> bc1{0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00};
+        const auto bc1Pixels = graphics::decompress(graphics::PixelFormat::bc1RgbaUnsignedNorm, blockSize, bc1);
+        expect(bc1Pixels.size() == 4 * 4 * 4, "Wrong BC1 output size");
+        expect(getPixel(bc1Pixels, 4, 0, 0, 4) == std::vector<std::uint8_t>{255, 0, 0, 255}, "Wrong BC1 first color");
+        expect(getPixel(bc1Pixels, 4, 1, 0, 4) == std::vector<std::uint8_t>{0, 0, 255, 255}, "Wrong BC1 second color");
+        expect(getPixel(bc1Pixels, 4, 2, 0, 4) == std::vector<std::uint8_t>{170, 0, 85, 255}, "Wrong BC1 interpolated color");
+        expect(getPixel(bc1Pixels, 4, 3, 0, 4) == std::vector<std::uint8_t>{85, 0, 170, 255}, "Wrong BC1 interpolated color");
+
+        // end points in the reverse order select the three color mode with a transparent entry
+        const std::vector<std::uint8_t> bc1Transparent{0x1F, 0x00, 0x00, 0xF8, 0xFF, 0x00, 0x00, 0x00};
+        const auto bc1TransparentPixels = graphics::decompress(graphics::PixelFormat::bc1RgbaUnsignedNorm, blockSize, bc1Transparent);
+        expect(getPixel(bc1TransparentPixels, 4, 0, 0, 4) == std::vector<std::uint8_t>{0, 0, 0, 0}, "BC1 pixel not transparent");
+        expect(getPixel(bc1TransparentPixels, 4, 0, 1, 4) == std::vector<std::uint8_t>{0, 0, 255, 255}, "Wrong BC1 color");
+
+        // explicit alpha of 0xF in the first pixel and 0x0 in the others
+        std::vector<std::uint8_t> bc2(16, 0);
+        bc2[0] = 0x0F;
+        const auto bc2Pixels = graphics::decompress(graphics::PixelFormat::bc2RgbaUnsignedNorm, blockSize, bc2);
+        expect(bc2Pixels[3] == 255 && bc2Pixels[7] == 0, "Wrong BC2 alpha");
+
+        // end points 255 and 0, indices 0, 1, 0 and 7
+        const std::vector<std::uint8_t> bc4{255, 0, 0x08, 0x0E, 0x00, 0x00, 0x00, 0x00};
+        const auto bc4Pixels = graphics::decompress(graphics::PixelFormat::bc4RUnsignedNorm, blockSize, bc4);
+        expect(bc4Pixels.size() == 16, "Wrong BC4 output size");
+        expect(bc4Pixels[0] == 255 && bc4Pixels[1] == 0 && bc4Pixels[2] == 255 && bc4Pixels[3] == 36, "Wrong BC4 values");
+
+        const std::vector<std::uint8_t> bc3{255, 0, 0x08, 0x0E, 0x00, 0x00, 0x00, 0x00,
+                                            0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00};
+        const auto bc3Pixels = graphics::decompress(graphics::PixelFormat::bc3RgbaUnsignedNorm, blockSize, bc3);
+        expect(getPixel(bc3Pixels, 4, 0, 0, 4) == std::vector<std::uint8_t>{255, 0, 0, 255}, "Wrong BC3 pixel");
+        expect(getPixel(bc3Pixels, 4, 3, 0, 4) == std::vector<std::uint8_t>{85, 0, 170, 36}, "Wrong BC3 pixel");
+
+        // individual mode with the same base color in both sub-blocks, all pixels get the small positive modifier
+        const std::vector<std::uint8_t> etcIndividual{0x88, 0x88, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00};
+        const auto etcIndividualPixels = graphics::decompress(graphics::PixelFormat::etc2RgbUnsignedNorm, blockSize, etcIndividual);
+        for (std::uint32_t i = 0; i < 16; ++i)
+            expect(getPixel(etcIndividualPixels, 4, i % 4, i / 4, 4) == std::vector<std::uint8_t>{138, 138, 138, 255}, "Wrong ETC individual mode pixel");
+
+        // differential mode, the right sub-block is one step brighter
+        const std::vector<std::uint8_t> etcDifferential{0x81, 0x81, 0x81, 0x02, 0x00, 0x00, 0x00, 0x00};
+        const auto etcDifferentialPixels = graphics::decompress(graphics::PixelFormat::etc2RgbUnsignedNorm, blockSize, etcDifferential);
+        expect(getPixel(etcDifferentialPixels, 4, 1, 3, 4) == std::vector<std::uint8_t>{134, 134, 134, 255}, "Wrong ETC differential mode pixel");
+        expect(getPixel(etcDifferentialPixels, 4, 2, 0, 4) == std::vector<std::uint8_t>{142, 142, 142, 255}, "Wrong ETC differential mode pixel");
+
+        // EAC alpha with a zero multiplier is the base value
+        const std::vector<std::uint8_t> etcAlpha{200, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                 0x88, 0x88, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00};
+        const auto etcAlphaPixels = graphics::decompress(graphics::PixelFormat::etc2RgbaUnsignedNorm, blockSize, etcAlpha);
+        expect(getPixel(etcAlphaPixels, 4, 3, 3, 4) == std::vector<std::uint8_t>{138, 138, 138, 200}, "Wrong ETC2 RGBA pixel");
+
+        // blocks sticking out of the image are clipped
+        const std::vector<std::uint8_t> twoBlocks{255, 0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                                  0, 0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+        const auto clippedPixels = graphics::decompress(graphics::PixelFormat::bc4RUnsignedNorm, math::Size<std::uint32_t, 2>{5U, 3U}, twoBlocks);
+        expect(clippedPixels.size() == 15, "Wrong size of a clipped image");
+        expect(clippedPixels[3] == 255 && clippedPixels[4] == 0 && clippedPixels[14] == 0 && clippedPixels[13] == 255, "Wrong clipped pixels");
+
+        expectThrow<std::runtime_error>([&]{
+            graphics::decompress(graphics::PixelFormat::bc1RgbaUnsignedNorm, math::Size<std::uint32_t, 2>{8U, 4U}, bc1);
+        }, "Truncated data decompressed");
+
+        // ASTC has to be sampled by the GPU
+        expect(!graphics::isDecompressionSupported(graphics::PixelFormat::astc4x4RgbaUnsignedNorm), "ASTC reported as decompressible");
+        expectThrow<std::runtime_error>([&]{
+            graphics::decompress(graphics::PixelFormat::astc4x4RgbaUnsignedNorm, blockSize, bc3);
+        }, "ASTC decompressed");
+    }
+}
@@ -0,0 +1,159 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Test.hpp"
+#include "math/Constants.hpp"
+#include "scene/ClusterGrid.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // 5x2 tiles, the view space x of a point at depth d is 2.5 * clip x * d and y is clip y * d
+        const math::Size<float, 2> viewportSize{320.0F, 128.0F};
+
+        math::Matrix<float, 4> makePerspective()
+        {
+            math::Matrix<float, 4> projection = math::identityMatrix<float, 4>;
+            setPerspective(projection, math::tau<float> / 4.0F, viewportSize.v[0] / viewportSize.v[1], 1.0F, 100.0F);
+            return projection;
+        }
+
+        bool isNear(float a, float b) noexcept
+        {
+            return std::fabs(a - b) <= 0.001F * std::max(1.0F, std::fabs(b));
+        }
+
+        std::vector<std::uint32_t> getClusterLights(const scene::ClusterGrid& grid,
+                                                    std::uint32_t z, std::uint32_t x, std::uint32_t y)
+        {
+            const auto& slice = grid.getSlices()[z];
+            const auto cluster = y * grid.getGridWidth() + x;
+            return {slice.lightIndices.begin() + slice.offsets[cluster], slice.lightIndices.begin() + slice.offsets[cluster + 1]};
+        }
+
+        // tiles of the row in the slice that list the light
+        std::vector<std::uint32_t> getLitTiles(const scene::ClusterGrid& grid, std::uint32_t z, std::uint32_t y, std::uint32_t light)
+        {
+            std::vector<std::uint32_t> tiles;
+            for (std::uint32_t x = 0; x < grid.getGridWidth(); ++x)
+            {
+                const auto lights = getClusterLights(grid, z, x, y);
+                if (std::find(lights.begin(), lights.end(), light) != lights.end()) tiles.push_back(x);
+            }
+            return tiles;
+        }
+
+        void binAll(scene::ClusterGrid& grid)
+        {
+            for (std::uint32_t z = 0; z < scene::ClusterGrid::sliceCount; ++z)
+                grid.binSlice(z);
+        }
+
+        void testTiles()
+        {
+            scene::ClusterGrid grid;
+            grid.setViewport(viewportSize, makePerspective(), 1.0F, 100.0F);
+
+            expect(grid.getGridWidth() == 5 && grid.getGridHeight() == 2, "Wrong grid size");
+            expect(isNear(grid.getDepthParameters().v[1], scene::ClusterGrid::sliceCount / std::log(100.0F)) &&
+                   grid.getDepthParameters().v[2] == 1.0F, "Perspective slices not logarithmic");
+
+            const auto& slices = grid.getSlices();
+            expect(isNear(slices[0].nearDepth, 1.0F) && isNear(slices[12].nearDepth, 10.0F) &&
+                   isNear(slices[scene::ClusterGrid::sliceCount - 1].farDepth, 100.0F), "Wrong slice depths");
+
+            // a tile of a slice spans the frustum between the near and the far depth of the slice
+            for (const auto& slice : slices)
+            {
+                expect(isNear(slice.tileMinX[0], -2.5F * slice.farDepth) && isNear(slice.tileMaxX[0], -1.5F * slice.nearDepth),
+                       "Wrong bounds of the left tile");
+                expect(isNear(slice.tileMinX[2], -0.5F * slice.farDepth) && isNear(slice.tileMaxX[2], 0.5F * slice.farDepth),
+                       "Wrong bounds of the center tile");
+                expect(isNear(slice.tileMaxX[4], 2.5F * slice.farDepth), "Wrong bounds of the right tile");
+                expect(isNear(slice.tileMinY[0], -slice.farDepth) && std::fabs(slice.tileMaxY[0]) < 0.001F &&
+                       isNear(slice.tileMaxY[1], slice.farDepth), "Wrong vertical bounds");
+            }
+
+            // orthographic tiles have the same bounds in every slice
+            math::Matrix<float, 4> orthographic = math::identityMatrix<float, 4>;
+            setOrthographic(orthographic, viewportSize.v[0], viewportSize.v[1], 0.0F, 96.0F);
+            grid.setViewport(viewportSize, orthographic, 0.0F, 96.0F);
+
+            expect(grid.getDepthParameters().v[2] == 0.0F, "Orthographic slices not linear");
+            expect(isNear(slices[1].nearDepth, 4.0F) && isNear(slices[1].farDepth, 8.0F), "Wrong linear slice depths");
+            expect(isNear(slices[5].tileMinX[0], -160.0F) && isNear(slices[5].tileMaxX[0], -96.0F) &&
+                   isNear(slices[5].tileMinY[1], 0.0F) && isNear(slices[5].tileMaxY[1], 64.0F), "Wrong orthographic bounds");
+        }
+
+        void testPointLights()
+        {
+            scene::ClusterGrid grid;
+            grid.setViewport(viewportSize, makePerspective(), 1.0F, 100.0F);
+
+            // on the border of the 11th and the 12th slice and of the two rows
+            grid.addPointLight(math::Vector<float, 3>{0.0F, 0.0F, -10.0F}, 1.0F, 3);
+            // behind the camera
+            grid.addPointLight(math::Vector<float, 3>{0.0F, 0.0F, 5.0F}, 1.0F, 4);
+            binAll(grid);
+
+            for (std::uint32_t z = 0; z < scene::ClusterGrid::sliceCount; ++z)
+                for (std::uint32_t y = 0; y < grid.getGridHeight(); ++y)
+                    for (std::uint32_t x = 0; x < grid.getGridWidth(); ++x)
+                    {
+                        const auto expected = (z == 11 || z == 12) && x == 2 ?
+                            std::vector<std::uint32_t>{3} : std::vector<std::uint32_t>{};
+                        expect(getClusterLights(grid, z, x, y) == expected, "Wrong lights of a cluster");
+                    }
+
+            std::vector<float> data;
+            grid.getClusterData(data);
+
+            // offset and count of every cluster, followed by the light indices
+            const auto clusterCount = grid.getGridWidth() * grid.getGridHeight() * scene::ClusterGrid::sliceCount;
+            const auto cluster = (12 * grid.getGridHeight() + 1) * grid.getGridWidth() + 2;
+            expect(data.size() == (clusterCount + 1) * 4, "Wrong cluster data size");
+            expect(data[cluster * 4 + 0] == 3.0F && data[cluster * 4 + 1] == 1.0F, "Wrong cluster offset or count");
+            expect(data[clusterCount * 4 + 3] == 3.0F, "Wrong light index");
+        }
+
+        void testSpotLights()
+        {
+            // to the right of the view, shining further right
+            const math::Vector<float, 3> position{30.0F, 0.0F, -20.0F};
+            const math::Vector<float, 3> direction{1.0F, 0.0F, 0.0F};
+            constexpr std::uint32_t slice = 15; // from 17.8 to 21.5
+
+            scene::ClusterGrid grid;
+            grid.setViewport(viewportSize, makePerspective(), 1.0F, 100.0F);
+            grid.addPointLight(position, 20.0F, 0);
+            grid.addSpotLight(position, direction, 20.0F, math::tau<float> / 6.0F, 1); // bounded through the apex
+            grid.addSpotLight(position, direction, 20.0F, math::tau<float> / 3.0F, 2); // bounded around the base
+            grid.addSpotLight(position, direction, 20.0F, math::tau<float> / 2.0F, 3); // as wide as a point light
+            binAll(grid);
+
+            expect(getLitTiles(grid, slice, 0, 0) == std::vector<std::uint32_t>{2, 3, 4}, "Wrong tiles of a point light");
+            expect(getLitTiles(grid, slice, 0, 1) == std::vector<std::uint32_t>{3, 4}, "Narrow spot light reaches behind its apex");
+            expect(getLitTiles(grid, slice, 0, 2) == std::vector<std::uint32_t>{3, 4}, "Wide spot light reaches behind its apex");
+            expect(getLitTiles(grid, slice, 0, 3) == std::vector<std::uint32_t>{2, 3, 4}, "Hemisphere spot light not bounded like a point light");
+
+            // the bounding sphere of a narrow cone goes through its apex
+            const auto& narrow = grid.getLights()[1];
+            expect(isNear(narrow.center.v[0] - narrow.radius, 30.0F) &&
+                   isNear(narrow.radius, 10.0F / std::cos(math::tau<float> / 12.0F)), "Wrong bounding sphere of a narrow spot light");
+
+            grid.clearLights();
+            binAll(grid);
+            expect(getLitTiles(grid, slice, 0, 0).empty(), "Cleared lights binned");
+        }
+    }
+
+    void testClusterGrid()
+    {
+        testTiles();
+        testPointLights();
+        testSpotLights();
+    }
+}
@@ -0,0 +1,95 @@
+// Ouzel by Elviss Strazdins
+
+#include <stdexcept>
+#include "Test.hpp"
+#include "scene/ComponentPool.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        struct Counter final
+        {
+            explicit Counter(int initValue) noexcept: value{initValue} { ++instances; }
+            ~Counter() { --instances; }
+
+            Counter(const Counter&) = delete;
+            Counter& operator=(const Counter&) = delete;
+
+            int value;
+            static inline int instances = 0;
+        };
+    }
+
+    void testComponentPool()
+    {
+        {
+            scene::ComponentPool<Counter, 4> pool;
+
+            const auto first = pool.create(1);
+            const auto second = pool.create(2);
+            expect(pool.get(first) && pool.get(first)->value == 1, "Created component not found");
+            expect(pool.getSize() == 2, "Wrong pool size");
+
+            // the slot of a destroyed component is reused with a new generation
+            pool.destroy(first);
+            expect(!pool.get(first), "Destroyed component still accessible");
+            expectThrow<std::runtime_error>([&]{ pool.destroy(first); }, "Stale handle destroyed twice");
+
+            const auto reused = pool.create(3);
+            expect(!pool.get(first), "Stale handle resolves to the reused slot");
+            expect(pool.get(reused) && pool.get(reused)->value == 3, "Reused slot not accessible");
+            expect(reused != first, "Reused handle equals the stale one");
+
+            // the handles are encoded like graphics resource ids
+            expect(graphics::getResourceIndex(reused) == graphics::getResourceIndex(first) &&
+                   graphics::getResourceGeneration(reused) == graphics::getResourceGeneration(first) + 1,
+                   "Reused slot keeps its generation");
+
+            // handles from before the clear stay invalid after the slots are reused
+            pool.clear();
+            expect(pool.getSize() == 0 && Counter::instances == 0, "Clear didn't destroy the components");
+            expect(!pool.get(second) && !pool.get(reused), "Handle valid after clear");
+
+            const auto afterClear = pool.create(4);
+            const auto afterClear2 = pool.create(5);
+            expect(!pool.get(second) && !pool.get(reused), "Handle from before clear resolves to a new component");
+            expect(pool.get(afterClear)->value == 4 && pool.get(afterClear2)->value == 5, "Components after clear not accessible");
+
+            // more components than fit in a chunk
+            for (int i = 0; i < 10; ++i) pool.create(i);
+
+            int sum = 0;
+            pool.forEach([&sum](const Counter& counter) { sum += counter.value; });
+            expect(sum == 4 + 5 + 45, "forEach didn't visit every component");
+
+            // components destroyed by the function are not visited, created ones don't move the others
+            sum = 0;
+            const auto firstComponent = pool.get(afterClear);
+            pool.forEach([&](const Counter& counter) {
+                if (&counter == firstComponent)
+                {
+                    pool.destroy(afterClear2);
+                    pool.create(100);
+                }
+                sum += counter.value;
+            });
+            expect(!pool.get(afterClear2) && pool.get(afterClear) == firstComponent, "Wrong component destroyed during forEach");
+            expect(sum == 4 + 45 || sum == 4 + 45 + 100, "forEach visited a destroyed component");
+            expect(!pool.get(scene::ComponentPool<Counter, 4>::Handle{}), "Default handle is valid");
+        }
+
+        expect(Counter::instances == 0, "Pool destructor didn't destroy the components");
+
+        scene::ComponentStorage storage;
+        const auto handle = storage.create<Counter>(1);
+        storage.clear();
+        expect(!storage.get<Counter>(handle), "Handle valid after the storage was cleared");
+
+        const auto newHandle = storage.create<Counter>(2);
+        expect(!storage.get<Counter>(handle), "Handle from before clear resolves to a new component");
+        expect(storage.get<Counter>(newHandle)->value == 2, "Component after clear not accessible");
+        storage.destroy<Counter>(newHandle);
+        expect(Counter::instances == 0, "Destroy didn't destroy the component");
+    }
+}
@@ -0,0 +1,60 @@
+// Ouzel by Elviss Strazdins
+
+#include <random>
+#include <string>
+#include <vector>
+#include "Test.hpp"
+#include "math/ConvexVolume.hpp"
+
+namespace ouzel::test
+{
+    void testCullBoxes()
+    {
+        // integer coordinates keep the plane distances exact, so the vector paths have to match isBoxInside bit for bit
+        const math::ConvexVolume<float> volume{{
+            math::Plane<float>{{1.0F, 0.0F, 0.0F, 16.0F}},
+            math::Plane<float>{{-1.0F, 0.0F, 0.0F, 16.0F}},
+            math::Plane<float>{{0.0F, 1.0F, 0.0F, 8.0F}},
+            math::Plane<float>{{0.0F, -1.0F, 0.0F, 8.0F}},
+            math::Plane<float>{{1.0F, -1.0F, 2.0F, 4.0F}},
+            math::Plane<float>{{-2.0F, 1.0F, -1.0F, 12.0F}}
+        }};
+
+        std::mt19937 generator{1};
+        std::uniform_int_distribution<int> position{-32, 32};
+        std::uniform_int_distribution<int> size{0, 8};
+
+        // not a multiple of the vector width, so that the scalar tail is covered as well
+        std::vector<math::Box<float, 3>> boxes(203);
+        for (auto& box : boxes)
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                box.min.v[axis] = static_cast<float>(position(generator));
+                box.max.v[axis] = box.min.v[axis] + static_cast<float>(size(generator));
+            }
+
+        // touches the first plane
+        boxes[5] = math::Box<float, 3>{math::Vector<float, 3>{-20.0F, 0.0F, 6.0F}, math::Vector<float, 3>{-16.0F, 1.0F, 7.0F}};
+
+        std::vector<std::uint32_t> visibility;
+        math::cullBoxes(volume, boxes.data(), boxes.size(), visibility);
+        expect(visibility.size() == (boxes.size() + 31) / 32, "Wrong visibility size");
+
+        std::size_t visible = 0;
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+        {
+            const auto inside = (visibility[i / 32] & (1U << (i % 32))) != 0;
+            expect(inside == math::isBoxInside(volume, boxes[i]), "Culling differs from isBoxInside for box " + std::to_string(i));
+            if (inside) ++visible;
+        }
+
+        expect(visible > 0 && visible < boxes.size(), "Test boxes are all inside or all outside");
+        expect((visibility[0] & (1U << 5)) != 0, "Box touching a plane culled");
+
+        // bits past the last box stay cleared
+        expect((visibility.back() >> (boxes.size() % 32)) == 0, "Visibility bits set past the last box");
+
+        math::cullBoxes(volume, boxes.data(), 0, visibility);
+        expect(visibility.empty(), "Visibility not cleared");
+    }
+}
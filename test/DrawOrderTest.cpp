@@ -0,0 +1,40 @@
+// Ouzel by Elviss Strazdins
+
+#include <vector>
+#include "Test.hpp"
+#include "scene/DrawOrder.hpp"
+
+namespace ouzel::test
+{
+    void testDrawOrder()
+    {
+        graphics::Material opaque;
+        opaque.opaque = true;
+        graphics::Material blended; // materials are blended unless marked as opaque
+
+        expect(scene::isOpaque(&opaque), "Opaque material not classified as opaque");
+        expect(!scene::isOpaque(&blended), "Blended material classified as opaque");
+        expect(!scene::isOpaque(nullptr), "Missing material classified as opaque");
+
+        expect(scene::getDepthBucket(0.5F) == 0, "Near depth not in the first bucket");
+        expect(scene::getDepthBucket(4.0F) == 4, "Wrong depth bucket");
+        expect(scene::getDepthBucket(4.0F) < scene::getDepthBucket(16.0F), "Depth buckets not increasing");
+
+        std::vector<scene::DrawEntry> entries = {
+            {nullptr, 0, &blended, 10.0F, true},
+            {nullptr, 0, &opaque, 100.0F, false},
+            {nullptr, 0, &blended, 50.0F, true},
+            {nullptr, 0, &opaque, 5.0F, false},
+            {nullptr, 1, &blended, 1.0F, true}
+        };
+
+        scene::sortDrawEntries(entries);
+
+        // higher order first, then opaque front to back, then transparent back to front
+        expect(entries[0].order == 1, "World order not respected");
+        expect(!entries[1].transparent && entries[1].depth == 5.0F, "Opaque draws not sorted front to back");
+        expect(!entries[2].transparent && entries[2].depth == 100.0F, "Opaque draws not sorted front to back");
+        expect(entries[3].transparent && entries[3].depth == 50.0F, "Transparent draws not sorted back to front");
+        expect(entries[4].transparent && entries[4].depth == 10.0F, "Transparent draws not sorted back to front");
+    }
+}
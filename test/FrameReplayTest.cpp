@@ -0,0 +1,87 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "Test.hpp"
+#include "core/Window.hpp"
+#include "graphics/FrameCapture.hpp"
+#include "graphics/empty/EmptyRenderDevice.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        // the empty render device never uses its window, so the window is not created
+        union WindowStorage
+        {
+            WindowStorage() noexcept {}
+            ~WindowStorage() {}
+
+            core::Window window;
+        };
+
+        std::vector<std::uint8_t> readFile(const char* filename)
+        {
+            std::ifstream file{filename, std::ios::binary};
+            return std::vector<std::uint8_t>{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        }
+    }
+
+    void testFrameReplay()
+    {
+        constexpr auto filename = "FrameReplayTest.capture";
+
+        WindowStorage windowStorage;
+        graphics::Settings settings;
+        graphics::empty::RenderDevice renderDevice{settings, windowStorage.window};
+        renderDevice.start();
+
+        const graphics::RenderDevice::Resource buffer{renderDevice};
+
+        {
+            graphics::FrameCapture frameCapture{graphics::Driver::empty, math::Size<std::uint32_t, 2>{64, 32}};
+
+            // the buffer is created before the capture starts, so it is written with the resources
+            frameCapture.addCommand(graphics::InitBufferCommand{buffer, graphics::BufferType::vertex, graphics::Flags::dynamic, {1, 2, 3, 4}, 4});
+            frameCapture.capture(filename, 2);
+            frameCapture.addCommand(graphics::PresentCommand{});
+            expect(frameCapture.isCapturing(), "Capture stopped before the frames");
+
+            for (int frame = 0; frame < 2; ++frame)
+            {
+                frameCapture.addCommand(graphics::SetViewportCommand{math::Rect<float>{0.0F, 0.0F, 64.0F, 32.0F}});
+                frameCapture.addCommand(graphics::SetBufferDataCommand{buffer, {5, 6, 7, 8}});
+                frameCapture.addCommand(graphics::PresentCommand{});
+            }
+
+            expect(!frameCapture.isCapturing(), "Capture not finished after the requested frames");
+        }
+
+        const auto data = readFile(filename);
+        std::remove(filename);
+
+        const graphics::FrameReplay frameReplay{data};
+        expect(frameReplay.getDriver() == graphics::Driver::empty, "Wrong capture driver");
+        expect(frameReplay.getSize() == math::Size<std::uint32_t, 2>{64, 32}, "Wrong capture size");
+        expect(frameReplay.getFrameCount() == 2, "Wrong captured frame count");
+
+        // the replay waits for the render thread twice, which must not wait for a frame that is never submitted
+        const auto result = frameReplay.run(renderDevice, 3);
+        expect(result.frameCount == 6, "Wrong replayed frame count");
+
+        const auto countOf = [&result](graphics::Command::Type type) {
+            return result.commandTimings.counts[static_cast<std::size_t>(type)];
+        };
+        expect(countOf(graphics::Command::Type::present) == 6, "Replayed frames not timed");
+        expect(countOf(graphics::Command::Type::setBufferData) == 6, "Replayed commands not timed");
+        expect(countOf(graphics::Command::Type::initBuffer) == 0, "Resource upload counted in the replay timings");
+
+        const auto stats = renderDevice.getStats();
+        expect(stats.errorCount == 0, "Replayed commands failed validation");
+        expect(stats.commandCounts[static_cast<std::size_t>(graphics::Command::Type::initBuffer)] == 1, "Resources not uploaded once");
+        expect(stats.frameCount == 7, "Replayed frames not presented");
+    }
+}
@@ -0,0 +1,178 @@
+// Ouzel by Elviss Strazdins
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "Test.hpp"
+#include "graphics/ImageWriter.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        std::uint32_t decodeBigEndian(const std::vector<std::uint8_t>& data, std::size_t offset)
+        {
+            return (static_cast<std::uint32_t>(data[offset + 0]) << 24) |
+                (static_cast<std::uint32_t>(data[offset + 1]) << 16) |
+                (static_cast<std::uint32_t>(data[offset + 2]) << 8) |
+                static_cast<std::uint32_t>(data[offset + 3]);
+        }
+
+        // decoder from the QOI specification
+        std::vector<std::uint8_t> decodeQoi(const std::vector<std::uint8_t>& data)
+        {
+            expect(data.size() >= 22 && data[0] == 'q' && data[1] == 'o' && data[2] == 'i' && data[3] == 'f',
+                   "Invalid QOI header");
+            expect(data[12] == 4 && data[13] == 0, "Invalid QOI channels or color space");
+
+            const auto pixelCount = static_cast<std::size_t>(decodeBigEndian(data, 4)) * decodeBigEndian(data, 8);
+            const auto end = data.size() - 8;
+            expect(std::vector<std::uint8_t>(data.begin() + static_cast<std::ptrdiff_t>(end), data.end()) ==
+                   std::vector<std::uint8_t>{0, 0, 0, 0, 0, 0, 0, 1}, "Invalid QOI end marker");
+
+            std::vector<std::uint8_t> result;
+            std::array<std::array<std::uint8_t, 4>, 64> index{};
+            std::array<std::uint8_t, 4> pixel{0, 0, 0, 255};
+            std::size_t offset = 14;
+
+            while (result.size() < pixelCount * 4)
+            {
+                expect(offset < end, "QOI data ends before the last pixel");
+                const auto tag = data[offset++];
+                std::size_t run = 1;
+
+                if (tag == 0xFE)
+                {
+                    pixel = {data[offset], data[offset + 1], data[offset + 2], pixel[3]};
+                    offset += 3;
+                }
+                else if (tag == 0xFF)
+                {
+                    pixel = {data[offset], data[offset + 1], data[offset + 2], data[offset + 3]};
+                    offset += 4;
+                }
+                else if ((tag & 0xC0) == 0x00)
+                    pixel = index[tag];
+                else if ((tag & 0xC0) == 0x40)
+                {
+                    pixel[0] = static_cast<std::uint8_t>(pixel[0] + ((tag >> 4) & 0x03) - 2);
+                    pixel[1] = static_cast<std::uint8_t>(pixel[1] + ((tag >> 2) & 0x03) - 2);
+                    pixel[2] = static_cast<std::uint8_t>(pixel[2] + (tag & 0x03) - 2);
+                }
+                else if ((tag & 0xC0) == 0x80)
+                {
+                    const auto dg = (tag & 0x3F) - 32;
+                    const auto next = data[offset++];
+                    pixel[0] = static_cast<std::uint8_t>(pixel[0] + dg + ((next >> 4) & 0x0F) - 8);
+                    pixel[1] = static_cast<std::uint8_t>(pixel[1] + dg);
+                    pixel[2] = static_cast<std::uint8_t>(pixel[2] + dg + (next & 0x0F) - 8);
+                }
+                else
+                    run = (tag & 0x3F) + 1U;
+
+                index[(pixel[0] * 3U + pixel[1] * 5U + pixel[2] * 7U + pixel[3] * 11U) % 64U] = pixel;
+
+                for (std::size_t i = 0; i < run; ++i)
+                    result.insert(result.end(), pixel.begin(), pixel.end());
+            }
+
+            expect(offset == end && result.size() == pixelCount * 4, "QOI data after the last pixel");
+            return result;
+        }
+
+        void testOps()
+        {
+            const std::vector<std::uint8_t> pixels{
+                0, 0, 0, 255, // same as the initial pixel
+                1, 0, 255, 255, // small difference, wraps around
+                3, 0, 255, 255, // just too far for a small difference
+                11, 5, 255, 255, // difference relative to green
+                100, 50, 20, 255, // too far for a difference
+                100, 50, 20, 128, // alpha changed
+                1, 0, 255, 255, // seen before
+                1, 0, 255, 255,
+                1, 0, 255, 255 // run that ends with the image
+            };
+
+            const std::vector<std::uint8_t> expected{
+                'q', 'o', 'i', 'f', 0, 0, 0, 9, 0, 0, 0, 1, 4, 0,
+                0xC0,
+                0x79,
+                0xA0, 0xA8,
+                0xA5, 0xB3,
+                0xFE, 100, 50, 20,
+                0xFF, 100, 50, 20, 128,
+                0x31,
+                0xC1,
+                0, 0, 0, 0, 0, 0, 0, 1
+            };
+
+            expect(graphics::encodeQoi(9, 1, pixels) == expected, "Wrong QOI encoding");
+        }
+
+        void testRuns()
+        {
+            // a run stores at most 62 pixels
+            std::vector<std::uint8_t> pixels;
+            for (std::size_t i = 0; i < 100; ++i)
+                pixels.insert(pixels.end(), {0, 0, 0, 255});
+
+            const auto data = graphics::encodeQoi(10, 10, pixels);
+            expect(data.size() == 14 + 2 + 8 && data[14] == 0xFD && data[15] == 0xC0 + 37, "Wrong QOI runs");
+            expect(decodeQoi(data) == pixels, "Wrong decoded QOI runs");
+        }
+
+        void testRoundTrip()
+        {
+            // gradients for the difference ops, repeated colors for the index and rows of runs
+            constexpr std::size_t width = 37;
+            constexpr std::size_t height = 23;
+
+            std::vector<std::uint8_t> pixels;
+            std::uint32_t seed = 12345;
+            for (std::size_t y = 0; y < height; ++y)
+                for (std::size_t x = 0; x < width; ++x)
+                {
+                    seed = seed * 1664525U + 1013904223U;
+
+                    if (y % 5 == 0)
+                        pixels.insert(pixels.end(), {40, 80, 120, 255});
+                    else if (y % 5 == 1)
+                        pixels.insert(pixels.end(), {
+                            static_cast<std::uint8_t>(x * 3),
+                            static_cast<std::uint8_t>(x * 2 + y),
+                            static_cast<std::uint8_t>(255 - x),
+                            255
+                        });
+                    else if (y % 5 == 2)
+                        pixels.insert(pixels.end(), {
+                            static_cast<std::uint8_t>(seed >> 24),
+                            static_cast<std::uint8_t>(seed >> 16),
+                            static_cast<std::uint8_t>(seed >> 8),
+                            static_cast<std::uint8_t>((seed >> 28) * 17)
+                        });
+                    else
+                    {
+                        const auto color = static_cast<std::uint8_t>((seed >> 29) * 30);
+                        pixels.insert(pixels.end(), {color, static_cast<std::uint8_t>(color + 1), color, 255});
+                    }
+                }
+
+            const auto data = graphics::encodeQoi(width, height, pixels);
+            expect(decodeBigEndian(data, 4) == width && decodeBigEndian(data, 8) == height, "Wrong QOI size");
+            expect(decodeQoi(data) == pixels, "Wrong decoded QOI image");
+            expect(data.size() < pixels.size(), "QOI image not compressed");
+
+            expectThrow<std::runtime_error>([&pixels]() {
+                graphics::encodeQoi(width, height + 1, pixels);
+            }, "Missing pixels accepted");
+        }
+    }
+
+    void testImageWriter()
+    {
+        testOps();
+        testRuns();
+        testRoundTrip();
+    }
+}
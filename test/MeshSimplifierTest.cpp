@@ -0,0 +1,126 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "Test.hpp"
+#include "ouzel/MeshSimplifier.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        constexpr std::uint32_t gridSize = 8; // quads along each side
+        constexpr std::uint32_t seamColumn = 4;
+        constexpr std::uint32_t columnsPerHalf = seamColumn + 1;
+
+        // the texture coordinates differ on both sides of the seam, so the left and the right half
+        // have their own vertices on the seam column, like the OBJ exporter splits them
+        struct Grid final
+        {
+            std::vector<MeshSimplifier::Position> positions;
+            std::vector<MeshSimplifier::Triangle> triangles;
+        };
+
+        std::uint32_t getVertex(std::uint32_t half, std::uint32_t column, std::uint32_t row) noexcept
+        {
+            return half * columnsPerHalf * (gridSize + 1) + row * columnsPerHalf + column;
+        }
+
+        Grid makeGrid()
+        {
+            Grid grid;
+
+            for (std::uint32_t half = 0; half < 2; ++half)
+                for (std::uint32_t row = 0; row <= gridSize; ++row)
+                    for (std::uint32_t column = 0; column < columnsPerHalf; ++column)
+                        grid.positions.push_back(MeshSimplifier::Position{
+                            static_cast<double>(half * seamColumn + column), static_cast<double>(row), 0.0
+                        });
+
+            for (std::uint32_t half = 0; half < 2; ++half)
+                for (std::uint32_t row = 0; row < gridSize; ++row)
+                    for (std::uint32_t column = 0; column < seamColumn; ++column)
+                    {
+                        const auto v0 = getVertex(half, column, row);
+                        const auto v1 = getVertex(half, column + 1, row);
+                        const auto v2 = getVertex(half, column, row + 1);
+                        const auto v3 = getVertex(half, column + 1, row + 1);
+                        grid.triangles.push_back({v0, v1, v2});
+                        grid.triangles.push_back({v1, v3, v2});
+                    }
+
+            return grid;
+        }
+
+        // the edges of the half that lie on the seam must still cover the whole seam
+        bool isSeamCovered(const Grid& grid, const std::vector<MeshSimplifier::Triangle>& triangles, std::uint32_t half)
+        {
+            const auto isOnSeam = [&grid, half](std::uint32_t vertex) {
+                const auto firstVertex = getVertex(half, 0, 0);
+                return vertex >= firstVertex && vertex < firstVertex + columnsPerHalf * (gridSize + 1) &&
+                    grid.positions[vertex][0] == static_cast<double>(seamColumn);
+            };
+
+            std::vector<std::pair<double, double>> spans;
+            for (const auto& triangle : triangles)
+                for (std::size_t edge = 0; edge < 3; ++edge)
+                {
+                    const auto vertex1 = triangle[edge];
+                    const auto vertex2 = triangle[(edge + 1) % 3];
+                    if (isOnSeam(vertex1) && isOnSeam(vertex2))
+                        spans.emplace_back(std::min(grid.positions[vertex1][1], grid.positions[vertex2][1]),
+                                           std::max(grid.positions[vertex1][1], grid.positions[vertex2][1]));
+                }
+
+            std::sort(spans.begin(), spans.end());
+
+            double end = 0.0;
+            for (const auto& span : spans)
+            {
+                if (span.first > end) return false;
+                end = std::max(end, span.second);
+            }
+
+            return end == static_cast<double>(gridSize);
+        }
+
+        bool isFacingUp(const Grid& grid, const MeshSimplifier::Triangle& triangle) noexcept
+        {
+            const auto& p0 = grid.positions[triangle[0]];
+            const auto& p1 = grid.positions[triangle[1]];
+            const auto& p2 = grid.positions[triangle[2]];
+            return (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]) > 0.0;
+        }
+    }
+
+    void testMeshSimplifier()
+    {
+        const auto grid = makeGrid();
+        expect(grid.triangles.size() == 2 * gridSize * gridSize, "Wrong grid triangle count");
+
+        MeshSimplifier simplifier{grid.positions, grid.triangles};
+
+        // every level halves the triangle count like the exporter does
+        for (std::size_t targetTriangleCount = grid.triangles.size() / 2; targetTriangleCount >= 16; targetTriangleCount /= 2)
+        {
+            const auto triangles = simplifier.simplify(targetTriangleCount);
+
+            // a collapse removes one triangle on the outline and two inside
+            expect(triangles.size() <= targetTriangleCount && triangles.size() + 2 > targetTriangleCount,
+                   "Wrong simplified triangle count");
+            expect(std::all_of(triangles.begin(), triangles.end(),
+                               [&grid](const auto& triangle) { return isFacingUp(grid, triangle); }),
+                   "Triangle flipped or degenerated");
+
+            expect(isSeamCovered(grid, triangles, 0) && isSeamCovered(grid, triangles, 1), "Texture seam not kept");
+        }
+
+        // the triangles that are already removed stay removed
+        expect(simplifier.simplify(grid.triangles.size()).size() <= 16, "Removed triangles restored");
+
+        expectThrow<std::runtime_error>([]() {
+            MeshSimplifier{std::vector<MeshSimplifier::Position>(2), std::vector<MeshSimplifier::Triangle>{{0, 1, 2}}};
+        }, "Invalid vertex index accepted");
+    }
+}
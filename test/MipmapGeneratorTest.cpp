@@ -0,0 +1,118 @@
+// Ouzel by Elviss Strazdins
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "Test.hpp"
+#include "graphics/MipmapGenerator.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        using Size = math::Size<std::uint32_t, 2>;
+
+        std::vector<std::uint8_t> downsample(graphics::PixelFormat pixelFormat,
+                                             std::uint32_t channelCount,
+                                             const Size& sourceSize,
+                                             const std::vector<std::uint8_t>& source,
+                                             const Size& destinationSize)
+        {
+            std::vector<std::uint8_t> result(destinationSize.v[0] * destinationSize.v[1] * channelCount);
+            graphics::MipmapGenerator{pixelFormat}.downsample(sourceSize, source.data(),
+                                                              destinationSize, result.data(),
+                                                              0, destinationSize.v[1]);
+            return result;
+        }
+
+        // every pixel of a wide level has to match the downsample of its 2x2 block alone,
+        // which goes through the scalar path instead of the vector one
+        void testWideRows(graphics::PixelFormat pixelFormat, std::uint32_t channelCount)
+        {
+            const Size destinationSize{37, 3};
+            const Size sourceSize{destinationSize.v[0] * 2, destinationSize.v[1] * 2};
+
+            std::mt19937 generator{channelCount};
+            std::uniform_int_distribution<int> distribution{0, 255};
+
+            std::vector<std::uint8_t> source(sourceSize.v[0] * sourceSize.v[1] * channelCount);
+            for (auto& value : source)
+            {
+                value = static_cast<std::uint8_t>(distribution(generator));
+                if (value < 64) value = 0; // fully transparent pixels
+            }
+
+            const auto result = downsample(pixelFormat, channelCount, sourceSize, source, destinationSize);
+
+            // the rows of a level can be generated in separate bands
+            std::vector<std::uint8_t> bands(result.size());
+            const graphics::MipmapGenerator mipmapGenerator{pixelFormat};
+            mipmapGenerator.downsample(sourceSize, source.data(), destinationSize, bands.data(), 0, 1);
+            mipmapGenerator.downsample(sourceSize, source.data(), destinationSize, bands.data(), 1, destinationSize.v[1]);
+            expect(bands == result, "Downsampling in bands differs from the whole level");
+
+            for (std::uint32_t y = 0; y < destinationSize.v[1]; ++y)
+                for (std::uint32_t x = 0; x < destinationSize.v[0]; ++x)
+                {
+                    std::vector<std::uint8_t> block;
+                    for (std::uint32_t row = y * 2; row < y * 2 + 2; ++row)
+                    {
+                        const auto begin = source.begin() + (row * sourceSize.v[0] + x * 2) * channelCount;
+                        block.insert(block.end(), begin, begin + channelCount * 2);
+                    }
+
+                    const auto pixel = downsample(pixelFormat, channelCount, Size{2, 2}, block, Size{1, 1});
+                    for (std::uint32_t c = 0; c < channelCount; ++c)
+                        expect(result[(y * destinationSize.v[0] + x) * channelCount + c] == pixel[c],
+                               "Vector path differs from the scalar path");
+                }
+        }
+    }
+
+    void testMipmapGenerator()
+    {
+        expectThrow<std::runtime_error>([]{ graphics::MipmapGenerator{graphics::PixelFormat::bc1RgbaUnsignedNorm}; }, "Compressed format accepted");
+
+        // averaging the same color returns it unchanged
+        expect(downsample(graphics::PixelFormat::rgba8UnsignedNorm, 4, Size{2, 2},
+                          {10, 128, 250, 255, 10, 128, 250, 255, 10, 128, 250, 255, 10, 128, 250, 255},
+                          Size{1, 1}) == std::vector<std::uint8_t>{10, 128, 250, 255}, "Uniform color changed");
+
+        // alpha is averaged linearly
+        expect(downsample(graphics::PixelFormat::a8UnsignedNorm, 1, Size{2, 2}, {0, 255, 255, 0}, Size{1, 1})[0] == 128,
+               "Alpha not averaged linearly");
+
+        // color is averaged in linear space, so the average of black and white is brighter than 128
+        const auto gray = downsample(graphics::PixelFormat::r8UnsignedNorm, 1, Size{2, 2}, {0, 255, 255, 0}, Size{1, 1})[0];
+        expect(gray > 180 && gray < 190, "Color not averaged in linear space");
+
+        // transparent pixels don't bleed their color
+        expect(downsample(graphics::PixelFormat::rgba8UnsignedNorm, 4, Size{2, 2},
+                          {255, 0, 0, 255, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0},
+                          Size{1, 1}) == std::vector<std::uint8_t>{255, 0, 0, 64}, "Transparent pixels bleed their color");
+        expect(downsample(graphics::PixelFormat::rgba8UnsignedNorm, 4, Size{2, 2},
+                          {255, 0, 0, 0, 0, 255, 0, 0, 0, 0, 255, 0, 9, 9, 9, 0},
+                          Size{1, 1}) == std::vector<std::uint8_t>{0, 0, 0, 0}, "Transparent block not cleared");
+
+        // grey with alpha keeps alpha linear and transparent pixels out of the grey value
+        std::vector<std::uint8_t> greyAlpha(2);
+        graphics::MipmapGenerator{graphics::PixelFormat::rg8UnsignedNorm, true}.downsample(Size{2, 2}, std::vector<std::uint8_t>{200, 255, 0, 0, 0, 0, 0, 0}.data(),
+                                                                                           Size{1, 1}, greyAlpha.data(), 0, 1);
+        expect(greyAlpha == std::vector<std::uint8_t>{200, 64}, "Transparent grey pixels bleed their value");
+
+        // the last row of an odd height is repeated
+        expect(downsample(graphics::PixelFormat::a8UnsignedNorm, 1, Size{4, 1}, {0, 255, 255, 255}, Size{2, 1}) ==
+               std::vector<std::uint8_t>{128, 255}, "Last row not repeated");
+
+        // the last column of an odd width is repeated
+        expect(downsample(graphics::PixelFormat::a8UnsignedNorm, 1, Size{1, 4}, {0, 255, 255, 255}, Size{1, 2}) ==
+               std::vector<std::uint8_t>{128, 255}, "Last column not repeated");
+
+        testWideRows(graphics::PixelFormat::r8UnsignedNorm, 1);
+        testWideRows(graphics::PixelFormat::a8UnsignedNorm, 1);
+        testWideRows(graphics::PixelFormat::rg8UnsignedNorm, 2);
+        testWideRows(graphics::PixelFormat::rgba8UnsignedNorm, 4);
+        testWideRows(graphics::PixelFormat::rgba8UnsignedNormSRGB, 4);
+    }
+}
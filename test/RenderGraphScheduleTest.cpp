@@ -0,0 +1,177 @@
+// Ouzel by Elviss Strazdins
+
+#include <stdexcept>
+#include <vector>
+#include "Test.hpp"
+#include "graphics/RenderGraphSchedule.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        using Schedule = graphics::RenderGraphSchedule;
+
+        const Schedule::TextureDescription colorDescription{
+            math::Size<std::uint32_t, 2>{256, 256}, graphics::PixelFormat::rgba8UnsignedNorm, 1
+        };
+
+        void testCulling()
+        {
+            Schedule schedule;
+            const auto unused = schedule.addTexture(colorDescription, false);
+            const auto color = schedule.addTexture(colorDescription, false);
+
+            const auto unusedPass = schedule.addPass();
+            schedule.write(unusedPass, unused);
+
+            const auto colorPass = schedule.addPass();
+            schedule.write(colorPass, color);
+
+            const auto presentPass = schedule.addPass();
+            schedule.read(presentPass, color);
+            schedule.setBackBuffer(presentPass);
+
+            // reads data back to the CPU, so it is kept without writing anything
+            const auto readbackPass = schedule.addPass();
+            schedule.setSideEffect(readbackPass);
+
+            schedule.compile();
+
+            expect(schedule.getCulledPassCount() == 1, "Wrong culled pass count");
+            expect(schedule.getOrder() == std::vector<Schedule::PassId>{colorPass, presentPass, readbackPass}, "Unused pass not culled");
+            expect(!schedule.getResources()[unused].used, "Texture of a culled pass used");
+            expect(schedule.getSlots().size() == 1, "Texture of a culled pass allocated");
+        }
+
+        void testOrdering()
+        {
+            Schedule schedule;
+            const auto blur = schedule.addTexture(colorDescription, false);
+            const auto history = schedule.addTexture(colorDescription, true);
+
+            // added before the pass that writes the texture it reads
+            const auto presentPass = schedule.addPass();
+            schedule.read(presentPass, blur);
+            schedule.setBackBuffer(presentPass);
+
+            // reads the contents of the previous frame, so it runs before the pass that overwrites them
+            const auto blurPass = schedule.addPass();
+            schedule.read(blurPass, history);
+            schedule.write(blurPass, blur);
+
+            const auto historyPass = schedule.addPass();
+            schedule.write(historyPass, history);
+
+            schedule.compile();
+
+            expect(schedule.getCulledPassCount() == 0, "Needed pass culled");
+            expect(schedule.getOrder() == std::vector<Schedule::PassId>{blurPass, presentPass, historyPass}, "Wrong pass order");
+
+            // every write builds on top of the previous one
+            Schedule writeSchedule;
+            const auto target = writeSchedule.addTexture(colorDescription, true);
+            const auto firstPass = writeSchedule.addPass();
+            writeSchedule.write(firstPass, target);
+            const auto secondPass = writeSchedule.addPass();
+            writeSchedule.read(secondPass, target);
+            writeSchedule.write(secondPass, target);
+            writeSchedule.compile();
+
+            expect(writeSchedule.getOrder() == std::vector<Schedule::PassId>{firstPass, secondPass}, "Writes reordered");
+
+            Schedule cycleSchedule;
+            const auto first = cycleSchedule.addTexture(colorDescription, false);
+            const auto second = cycleSchedule.addTexture(colorDescription, false);
+            const auto pass1 = cycleSchedule.addPass();
+            cycleSchedule.read(pass1, first);
+            cycleSchedule.write(pass1, second);
+            cycleSchedule.setSideEffect(pass1);
+            const auto pass2 = cycleSchedule.addPass();
+            cycleSchedule.read(pass2, second);
+            cycleSchedule.write(pass2, first);
+
+            expectThrow<std::runtime_error>([&cycleSchedule]() { cycleSchedule.compile(); }, "Dependency cycle not detected");
+        }
+
+        // a chain of passes where every pass reads the texture of the previous one
+        std::vector<Schedule::TextureId> addChain(Schedule& schedule, const std::vector<Schedule::TextureDescription>& descriptions)
+        {
+            std::vector<Schedule::TextureId> textures;
+
+            for (const auto& description : descriptions)
+            {
+                const auto pass = schedule.addPass();
+                if (!textures.empty()) schedule.read(pass, textures.back());
+                textures.push_back(schedule.addTexture(description, false));
+                schedule.write(pass, textures.back());
+            }
+
+            const auto presentPass = schedule.addPass();
+            schedule.read(presentPass, textures.back());
+            schedule.setBackBuffer(presentPass);
+
+            return textures;
+        }
+
+        void testAliasing()
+        {
+            Schedule schedule;
+            auto textures = addChain(schedule, {colorDescription, colorDescription, colorDescription});
+            schedule.compile();
+
+            // the first texture is dead after the second pass, so the third texture reuses its slot
+            const auto& resources = schedule.getResources();
+            expect(schedule.getSlots().size() == 2, "Transient textures not aliased");
+            expect(resources[textures[0]].slot == resources[textures[2]].slot, "Texture with a finished lifetime not reused");
+            expect(resources[textures[0]].slot != resources[textures[1]].slot, "Textures with overlapping lifetimes aliased");
+            expect(schedule.isDeadAfter(textures[0], 1) && !schedule.isDeadAfter(textures[0], 0), "Wrong texture lifetime");
+
+            // the slots are reused in the next frame
+            schedule.clear();
+            textures = addChain(schedule, {colorDescription, colorDescription, colorDescription});
+            schedule.compile();
+            expect(schedule.getSlots().size() == 2, "Slots not reused in the next frame");
+
+            // textures with different descriptions never share a slot
+            schedule.clear();
+            auto depthDescription = colorDescription;
+            depthDescription.pixelFormat = graphics::PixelFormat::depth;
+            textures = addChain(schedule, {colorDescription, colorDescription, depthDescription});
+            schedule.compile();
+            expect(schedule.getSlots().size() == 3, "Textures with different descriptions aliased");
+
+            // imported textures don't take slots
+            schedule.clear();
+            const auto imported = schedule.addTexture(colorDescription, true);
+            const auto pass = schedule.addPass();
+            schedule.write(pass, imported);
+            schedule.compile();
+            expect(schedule.getSlots().size() == 3, "Slot taken by an imported texture");
+
+            for (std::uint32_t frame = 0; frame < 2; ++frame)
+            {
+                schedule.clear();
+                schedule.compile();
+            }
+
+            std::vector<std::size_t> releasedSlots;
+            const auto release = [&releasedSlots](std::size_t slot) { releasedSlots.push_back(slot); };
+
+            schedule.releaseUnusedSlots(3, release);
+            expect(releasedSlots.empty(), "Slots released too early");
+
+            schedule.clear();
+            schedule.compile();
+            schedule.releaseUnusedSlots(3, release);
+            expect(releasedSlots == std::vector<std::size_t>{2, 1, 0}, "Unused slots not released from the last one");
+            expect(schedule.getSlots().empty(), "Released slots kept");
+        }
+    }
+
+    void testRenderGraphSchedule()
+    {
+        testCulling();
+        testOrdering();
+        testAliasing();
+    }
+}
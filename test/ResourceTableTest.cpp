@@ -0,0 +1,81 @@
+// Ouzel by Elviss Strazdins
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "Test.hpp"
+#include "graphics/ResourceTable.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        struct Resource final
+        {
+            explicit Resource(int initValue) noexcept: value{initValue} { ++instances; }
+            ~Resource() { --instances; }
+
+            Resource(const Resource&) = delete;
+            Resource& operator=(const Resource&) = delete;
+
+            int value;
+            static inline int instances = 0;
+        };
+    }
+
+    void testResourceTable()
+    {
+        const auto id = graphics::makeResourceId(5, 3);
+        expect(id != 0, "Resource handle of the first generation is invalid");
+        expect(graphics::getResourceIndex(id) == 5 && graphics::getResourceGeneration(id) == 3, "Resource handle not decoded");
+        expect(graphics::makeResourceId(0, 0) != 0, "Handle of the first slot is invalid");
+        expect(graphics::makeResourceId(5, 4) != id, "Generation doesn't change the handle");
+
+        {
+            graphics::ResourceTable<Resource> table;
+
+            const auto first = graphics::makeResourceId(0, 0);
+            const auto second = graphics::makeResourceId(1, 0);
+            table.set(first, std::make_unique<Resource>(1));
+            table.set(second, std::make_unique<Resource>(2));
+
+            expect(table.get(first)->value == 1 && table.find(second)->value == 2, "Resource not found");
+            expect(!table.get(0) && !table.find(0), "Null handle resolves to a resource");
+            expect(!table.find(graphics::makeResourceId(7, 0)), "Handle past the end resolves to a resource");
+
+            // the resource stays alive until its frame has completed
+            table.retire(first, 10);
+            expect(!table.find(first) && Resource::instances == 2, "Retired resource destroyed too early");
+
+            // the slot is reused with the next generation while the old resource is still retired
+            const auto reused = graphics::makeResourceId(0, 1);
+            table.set(reused, std::make_unique<Resource>(3));
+            expect(!table.find(first), "Stale handle resolves to the reused slot");
+            expect(table.find(reused)->value == 3, "Reused slot not accessible");
+#ifndef NDEBUG
+            expectThrow<std::runtime_error>([&table, first]{ table.get(first); }, "Stale handle accepted");
+#endif
+
+            // retiring a stale handle must not take the resource of the new generation
+            table.retire(first, 11);
+            expect(table.find(reused) && table.find(reused)->value == 3, "Stale handle retired the reused slot");
+
+            std::vector<graphics::ResourceId> released;
+            const auto release = [&released](graphics::ResourceId releasedId) { released.push_back(releasedId); };
+
+            table.collect(9, release);
+            expect(released.empty() && Resource::instances == 3, "Resource collected before its frame completed");
+
+            table.retire(second, 12);
+            table.collect(11, release);
+            expect(released.size() == 1 && released[0] == first && Resource::instances == 2, "Retired resource not collected");
+
+            table.collect(12, release);
+            expect(released.size() == 2 && released[1] == second && Resource::instances == 1, "Resources not collected in order");
+
+            table.retire(reused, 13);
+        }
+
+        expect(Resource::instances == 0, "Retired resources not destroyed with the table");
+    }
+}
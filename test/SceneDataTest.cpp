@@ -0,0 +1,111 @@
+// Ouzel by Elviss Strazdins
+
+#include <exception>
+#include <stdexcept>
+#include "Test.hpp"
+#include "scene/SceneData.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        scene::SceneData createSceneData()
+        {
+            scene::SceneData data;
+
+            scene::SceneData::ActorRecord root;
+            root.position = math::Vector<float, 3>{1.0F, 2.0F, 3.0F};
+            root.scale = math::Vector<float, 3>{2.0F, 2.0F, 2.0F};
+            root.order = -3;
+            root.pickable = true;
+            data.actors.push_back(root);
+
+            scene::SceneData::ActorRecord child;
+            child.parent = 0;
+            child.opacity = 0.5F;
+            child.hidden = true;
+            child.cullDisabled = true;
+            data.actors.push_back(child);
+
+            const auto mesh = data.addReference(assets::Asset::Type::staticMesh, "mesh");
+            const auto material = data.addReference(assets::Asset::Type::material, "material");
+            expect(data.addReference(assets::Asset::Type::staticMesh, "mesh") == mesh, "Reference added twice");
+
+            data.staticMeshRenderers.push_back({1, mesh, material});
+            data.spriteRenderers.push_back({0, data.addReference(assets::Asset::Type::sprite, "sprite")});
+            data.particleSystems.push_back({1, data.addReference(assets::Asset::Type::particleSystem, "particles")});
+
+            scene::SceneData::LightRecord light;
+            light.actor = 1;
+            light.type = scene::Light::Type::spot;
+            light.color = math::Color{0x10203040U};
+            light.angle = 0.25F;
+            light.range = 10.0F;
+            light.intensity = 2.0F;
+            data.lights.push_back(light);
+
+            return data;
+        }
+    }
+
+    void testSceneData()
+    {
+        const auto original = createSceneData();
+        const scene::SceneData decoded{original.encode()};
+
+        expect(decoded.references.size() == 4 &&
+               decoded.references[1].type == assets::Asset::Type::material &&
+               decoded.references[1].name == "material", "References not restored");
+
+        expect(decoded.actors.size() == 2, "Wrong actor count");
+        expect(decoded.actors[0].parent == scene::SceneData::none &&
+               decoded.actors[0].position == original.actors[0].position &&
+               decoded.actors[0].scale == original.actors[0].scale &&
+               decoded.actors[0].order == -3 &&
+               decoded.actors[0].pickable &&
+               !decoded.actors[0].hidden, "Root actor not restored");
+        expect(decoded.actors[1].parent == 0 &&
+               decoded.actors[1].opacity == 0.5F &&
+               decoded.actors[1].hidden &&
+               decoded.actors[1].cullDisabled &&
+               !decoded.actors[1].pickable, "Child actor not restored");
+
+        expect(decoded.staticMeshRenderers.size() == 1 &&
+               decoded.staticMeshRenderers[0].actor == 1 &&
+               decoded.staticMeshRenderers[0].meshData == 0 &&
+               decoded.staticMeshRenderers[0].material == 1, "Static mesh renderer not restored");
+        expect(decoded.spriteRenderers.size() == 1 &&
+               decoded.spriteRenderers[0].spriteData == 2, "Sprite renderer not restored");
+        expect(decoded.particleSystems.size() == 1 &&
+               decoded.particleSystems[0].particleSystemData == 3, "Particle system not restored");
+
+        expect(decoded.lights.size() == 1 &&
+               decoded.lights[0].type == scene::Light::Type::spot &&
+               decoded.lights[0].color.getIntValue() == 0x10203040U &&
+               decoded.lights[0].angle == 0.25F &&
+               decoded.lights[0].range == 10.0F &&
+               decoded.lights[0].intensity == 2.0F, "Light not restored");
+
+        // truncated file
+        auto encoded = original.encode();
+        encoded.resize(encoded.size() / 2);
+        expectThrow<std::exception>([&encoded]{ scene::SceneData{encoded}; }, "Truncated scene accepted");
+
+        // parents have to be stored before their children
+        auto invalidParent = createSceneData();
+        invalidParent.actors[0].parent = 1;
+        expectThrow<std::runtime_error>([&invalidParent]{ scene::SceneData{invalidParent.encode()}; }, "Invalid parent accepted");
+
+        auto invalidReference = createSceneData();
+        invalidReference.staticMeshRenderers[0].meshData = 4;
+        expectThrow<std::runtime_error>([&invalidReference]{ scene::SceneData{invalidReference.encode()}; }, "Invalid reference accepted");
+
+        auto invalidActor = createSceneData();
+        invalidActor.spriteRenderers[0].actor = 2;
+        expectThrow<std::runtime_error>([&invalidActor]{ scene::SceneData{invalidActor.encode()}; }, "Invalid component actor accepted");
+
+        auto invalidLight = createSceneData();
+        invalidLight.lights[0].type = static_cast<scene::Light::Type>(3);
+        expectThrow<std::runtime_error>([&invalidLight]{ scene::SceneData{invalidLight.encode()}; }, "Invalid light type accepted");
+    }
+}
@@ -0,0 +1,219 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Test.hpp"
+#include "math/Constants.hpp"
+#include "scene/SkeletalAnimation.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        bool isNear(float a, float b) noexcept
+        {
+            return std::fabs(a - b) <= 0.0001F * std::max(1.0F, std::fabs(b));
+        }
+
+        template <std::size_t dims>
+        bool isNear(const math::Vector<float, dims>& a, const math::Vector<float, dims>& b) noexcept
+        {
+            for (std::size_t i = 0; i < dims; ++i)
+                if (!isNear(a.v[i], b.v[i])) return false;
+            return true;
+        }
+
+        bool isNear(const math::Quaternion<float>& a, const math::Quaternion<float>& b) noexcept
+        {
+            for (std::size_t i = 0; i < 4; ++i)
+                if (!isNear(a.v[i], b.v[i])) return false;
+            return true;
+        }
+
+        math::Quaternion<float> makeRotation(float angle, const math::Vector<float, 3>& axis) noexcept
+        {
+            const auto length = std::sqrt(axis.v[0] * axis.v[0] + axis.v[1] * axis.v[1] + axis.v[2] * axis.v[2]);
+            const auto sine = std::sin(angle / 2.0F) / length;
+            return math::Quaternion<float>{axis.v[0] * sine, axis.v[1] * sine, axis.v[2] * sine, std::cos(angle / 2.0F)};
+        }
+
+        // the vertex is transformed by the matrices of its joints, blended by its weights
+        void skinReference(const scene::SkinnedVertices& source,
+                           const std::vector<math::Matrix<float, 4>>& skinMatrices,
+                           std::vector<graphics::Vertex>& vertices)
+        {
+            for (std::size_t i = 0; i < vertices.size(); ++i)
+            {
+                auto matrix = skinMatrices[source.joints[i][0]] * source.weights[i][0];
+                for (std::size_t j = 1; j < 4; ++j)
+                    matrix += skinMatrices[source.joints[i][j]] * source.weights[i][j];
+
+                vertices[i].position = source.positions[i];
+                transformPoint(matrix, vertices[i].position);
+
+                vertices[i].normal = source.normals[i];
+                transformVector(matrix, vertices[i].normal);
+                normalize(vertices[i].normal);
+            }
+        }
+
+        void testSkinning()
+        {
+            scene::Skeleton skeleton;
+            skeleton.joints.resize(3);
+            skeleton.joints[1].parent = 0;
+            skeleton.joints[2].parent = 1;
+            setTranslation(skeleton.joints[1].inverseBindMatrix, math::Vector<float, 3>{0.0F, -1.0F, 0.0F});
+            setTranslation(skeleton.joints[2].inverseBindMatrix, math::Vector<float, 3>{0.0F, -2.0F, 0.0F});
+            setTranslation(skeleton.rootTransform, math::Vector<float, 3>{0.5F, 0.0F, -3.0F});
+
+            scene::Pose pose(3);
+            pose[0].rotation = makeRotation(math::tau<float> / 12.0F, math::Vector<float, 3>{0.0F, 0.0F, 1.0F});
+            pose[0].scale = math::Vector<float, 3>{1.5F, 1.5F, 1.5F};
+            pose[1].translation = math::Vector<float, 3>{0.0F, 1.0F, 0.0F};
+            pose[1].rotation = makeRotation(math::tau<float> / 5.0F, math::Vector<float, 3>{1.0F, 2.0F, 0.5F});
+            pose[2].translation = math::Vector<float, 3>{0.25F, 1.0F, 0.0F};
+            pose[2].scale = math::Vector<float, 3>{1.0F, 2.0F, 0.5F};
+
+            std::vector<math::Matrix<float, 4>> skinMatrices;
+            scene::calculateSkinMatrices(skeleton, pose, skinMatrices);
+
+            // single joints, pairs and weights that skip a joint in the middle
+            scene::SkinnedVertices source;
+            source.joints = {{0, 0, 0, 0}, {1, 0, 0, 0}, {2, 0, 0, 0}, {0, 1, 0, 0},
+                             {2, 1, 0, 0}, {0, 2, 1, 0}, {1, 0, 2, 0}, {0, 1, 2, 1}};
+            source.weights = {{1.0F, 0.0F, 0.0F, 0.0F}, {1.0F, 0.0F, 0.0F, 0.0F}, {1.0F, 0.0F, 0.0F, 0.0F}, {0.5F, 0.5F, 0.0F, 0.0F},
+                              {0.75F, 0.25F, 0.0F, 0.0F}, {0.2F, 0.0F, 0.8F, 0.0F}, {0.3F, 0.0F, 0.2F, 0.5F}, {0.1F, 0.2F, 0.3F, 0.4F}};
+
+            for (std::size_t i = 0; i < source.joints.size(); ++i)
+            {
+                const auto f = static_cast<float>(i);
+                source.positions.push_back(math::Vector<float, 3>{f * 0.25F - 1.0F, f * 0.5F, 1.0F - f * 0.125F});
+                auto& normal = source.normals.emplace_back(math::Vector<float, 3>{1.0F, f - 3.0F, 0.5F});
+                normalize(normal);
+            }
+
+            const graphics::Vertex initVertex{
+                math::Vector<float, 3>{}, math::Color{0x102030FFU},
+                math::Vector<float, 2>{0.25F, 0.75F}, math::Vector<float, 3>{}
+            };
+
+            std::vector<graphics::Vertex> vertices(source.positions.size(), initVertex);
+            std::vector<graphics::Vertex> expected(source.positions.size(), initVertex);
+            scene::skinVertices(source, skinMatrices, vertices);
+            skinReference(source, skinMatrices, expected);
+
+            for (std::size_t i = 0; i < vertices.size(); ++i)
+            {
+                expect(isNear(vertices[i].position, expected[i].position), "Wrong skinned position");
+                expect(isNear(vertices[i].normal, expected[i].normal), "Wrong skinned normal");
+                expect(vertices[i].color == initVertex.color && vertices[i].texCoords == initVertex.texCoords,
+                       "Attributes besides the position and the normal changed");
+            }
+        }
+
+        float sampleX(const scene::AnimationClip& clip, float time, scene::KeyframeCache& cache)
+        {
+            scene::Pose pose(1);
+            scene::sampleClip(clip, time, pose, cache);
+            return pose[0].translation.v[0];
+        }
+
+        void testSampling()
+        {
+            scene::AnimationClip clip;
+            clip.duration = 3.0F;
+            auto& channel = clip.channels.emplace_back();
+            channel.times = {1.0F, 2.0F, 3.0F};
+            channel.values = {10.0F, 0.0F, 0.0F, 20.0F, 0.0F, 0.0F, 40.0F, 0.0F, 0.0F};
+
+            // the first and the last key hold outside of the keyed time range
+            scene::KeyframeCache cache;
+            expect(sampleX(clip, 0.0F, cache) == 10.0F, "Wrong value before the first key");
+            expect(sampleX(clip, 1.0F, cache) == 10.0F, "Wrong value at the first key");
+            expect(isNear(sampleX(clip, 1.5F, cache), 15.0F), "Wrong interpolated value");
+            expect(sampleX(clip, 2.0F, cache) == 20.0F, "Wrong value at a key");
+            expect(isNear(sampleX(clip, 2.5F, cache), 30.0F), "Wrong interpolated value after a key");
+            expect(sampleX(clip, 3.0F, cache) == 40.0F, "Wrong value at the last key");
+            expect(sampleX(clip, 5.0F, cache) == 40.0F, "Wrong value after the last key");
+
+            // rewinding searches the keys again
+            expect(isNear(sampleX(clip, 1.25F, cache), 12.5F), "Wrong value after rewinding");
+            expect(sampleX(clip, 0.5F, cache) == 10.0F, "Wrong value after rewinding before the first key");
+
+            scene::KeyframeCache staleCache{7};
+            expect(isNear(sampleX(clip, 2.5F, staleCache), 30.0F), "Stale keyframe cache used");
+
+            channel.interpolation = scene::AnimationClip::Interpolation::step;
+            expect(sampleX(clip, 1.99F, cache) == 10.0F && sampleX(clip, 2.0F, cache) == 20.0F,
+                   "Step interpolation between keys");
+
+            // the tangents are per second, so they are scaled by the two seconds between the keys
+            channel.interpolation = scene::AnimationClip::Interpolation::cubicSpline;
+            channel.times = {0.0F, 2.0F};
+            channel.values = {
+                0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F,
+                0.0F, 0.0F, 0.0F, 4.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F
+            };
+            expect(sampleX(clip, 0.0F, cache) == 0.0F && sampleX(clip, 2.0F, cache) == 4.0F,
+                   "Wrong cubic spline value at a key");
+            expect(isNear(sampleX(clip, 1.0F, cache), 2.25F), "Wrong cubic spline value");
+
+            // rotations are interpolated along the shortest arc, channels of missing joints are skipped
+            auto& rotationChannel = clip.channels.emplace_back();
+            rotationChannel.path = scene::AnimationClip::Path::rotation;
+            rotationChannel.times = {0.0F, 1.0F};
+            const auto rotation = makeRotation(math::tau<float> / 4.0F, math::Vector<float, 3>{0.0F, 0.0F, 1.0F});
+            rotationChannel.values = {0.0F, 0.0F, 0.0F, 1.0F, -rotation.v[0], -rotation.v[1], -rotation.v[2], -rotation.v[3]};
+
+            auto& missingChannel = clip.channels.emplace_back();
+            missingChannel.joint = 1;
+            missingChannel.times = {0.0F};
+            missingChannel.values = {1.0F, 1.0F, 1.0F};
+
+            scene::Pose pose(1);
+            scene::sampleClip(clip, 0.5F, pose, cache);
+            expect(cache.size() == clip.channels.size(), "Keyframe cache not resized");
+            expect(isNear(pose[0].rotation, makeRotation(math::tau<float> / 8.0F, math::Vector<float, 3>{0.0F, 0.0F, 1.0F})),
+                   "Rotation not interpolated along the shortest arc");
+        }
+
+        void testBlending()
+        {
+            scene::Pose pose1(2);
+            pose1[0].translation = math::Vector<float, 3>{1.0F, 2.0F, 3.0F};
+
+            scene::Pose pose2(3);
+            pose2[0].translation = math::Vector<float, 3>{3.0F, 2.0F, 1.0F};
+            pose2[0].scale = math::Vector<float, 3>{2.0F, 3.0F, 1.0F};
+            // the same rotation as a quarter turn, with the opposite sign
+            const auto rotation = makeRotation(math::tau<float> / 4.0F, math::Vector<float, 3>{0.0F, 0.0F, 1.0F});
+            pose2[0].rotation = math::Quaternion<float>{-rotation.v[0], -rotation.v[1], -rotation.v[2], -rotation.v[3]};
+
+            scene::Pose result;
+            scene::blendPoses(pose1, pose2, 0.5F, result);
+            expect(result.size() == 2, "Wrong blended pose size");
+            expect(isNear(result[0].translation, math::Vector<float, 3>{2.0F, 2.0F, 2.0F}), "Wrong blended translation");
+            expect(isNear(result[0].scale, math::Vector<float, 3>{1.5F, 2.0F, 1.0F}), "Wrong blended scale");
+            expect(isNear(result[0].rotation, makeRotation(math::tau<float> / 8.0F, math::Vector<float, 3>{0.0F, 0.0F, 1.0F})),
+                   "Rotation not blended along the shortest arc");
+            expect(isNear(result[1].rotation, math::identityQuaternion<float>), "Wrong blended identity rotation");
+
+            scene::blendPoses(pose1, pose2, 0.0F, result);
+            expect(isNear(result[0].translation, pose1[0].translation) && isNear(result[0].rotation, pose1[0].rotation),
+                   "Zero weight not the first pose");
+
+            scene::blendPoses(pose1, pose2, 1.0F, result);
+            expect(isNear(result[0].translation, pose2[0].translation) && isNear(result[0].scale, pose2[0].scale),
+                   "Full weight not the second pose");
+        }
+    }
+
+    void testSkeletalAnimation()
+    {
+        testSkinning();
+        testSampling();
+        testBlending();
+    }
+}
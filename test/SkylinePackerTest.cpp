@@ -0,0 +1,75 @@
+// Ouzel by Elviss Strazdins
+
+#include <vector>
+#include "Test.hpp"
+#include "graphics/SkylinePacker.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        struct Packed final
+        {
+            std::uint32_t x;
+            std::uint32_t y;
+            std::uint32_t width;
+            std::uint32_t height;
+        };
+
+        bool overlap(const Packed& a, const Packed& b) noexcept
+        {
+            return a.x < b.x + b.width && b.x < a.x + a.width &&
+                a.y < b.y + b.height && b.y < a.y + a.height;
+        }
+    }
+
+    void testSkylinePacker()
+    {
+        graphics::SkylinePacker packer{math::Size<std::uint32_t, 2>{64, 64}};
+        math::Vector<std::uint32_t, 2> position;
+
+        expect(!packer.pack(0, 8, position), "Empty rectangle packed");
+        expect(!packer.pack(65, 8, position), "Too wide rectangle packed");
+
+        // the first rectangles go along the bottom edge
+        expect(packer.pack(16, 8, position) && position.v[0] == 0 && position.v[1] == 0, "First rectangle not at the origin");
+        expect(packer.pack(16, 4, position) && position.v[0] == 16 && position.v[1] == 0, "Second rectangle not next to the first");
+
+        // the lowest top edge is preferred, so the next one goes on the shorter neighbour
+        expect(packer.pack(32, 4, position) && position.v[0] == 32 && position.v[1] == 0, "Rectangle not put on the lowest position");
+        expect(packer.pack(16, 4, position) && position.v[0] == 16 && position.v[1] == 4, "Rectangle not put on the lowest segment");
+        expect(packer.getAllocatedArea() == 16 * 8 + 16 * 8 + 32 * 4, "Wrong allocated area");
+
+        packer.clear();
+        expect(packer.getAllocatedArea() == 0, "Allocated area not reset by clear");
+
+        // fill the area with rectangles of different sizes and check that none overlap or leave the area
+        std::vector<Packed> packed;
+        const std::uint32_t sizes[][2] = {{12, 20}, {8, 8}, {20, 4}, {4, 28}, {16, 12}, {24, 8}, {8, 16}};
+
+        for (std::size_t i = 0; i < 64; ++i)
+        {
+            const auto width = sizes[i % std::size(sizes)][0];
+            const auto height = sizes[i % std::size(sizes)][1];
+
+            if (!packer.pack(width, height, position)) continue;
+
+            const Packed rectangle{position.v[0], position.v[1], width, height};
+            expect(rectangle.x + width <= 64 && rectangle.y + height <= 64, "Rectangle packed outside of the area");
+
+            for (const auto& other : packed)
+                expect(!overlap(rectangle, other), "Packed rectangles overlap");
+
+            packed.push_back(rectangle);
+        }
+
+        expect(packed.size() > 10, "Too few rectangles packed");
+
+        std::uint64_t packedArea = 0;
+        for (const auto& rectangle : packed)
+            packedArea += static_cast<std::uint64_t>(rectangle.width) * rectangle.height;
+
+        expect(packer.getAllocatedArea() >= packedArea, "Allocated area smaller than the packed area");
+        expect(!packer.pack(64, 64, position), "Rectangle packed into a full area");
+    }
+}
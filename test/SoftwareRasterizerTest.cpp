@@ -0,0 +1,423 @@
+// Ouzel by Elviss Strazdins
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Test.hpp"
+#include "core/Window.hpp"
+#include "graphics/software/SoftwareRasterizer.hpp"
+#include "graphics/software/SoftwareRenderDevice.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        using graphics::software::Rasterizer;
+
+        constexpr std::uint32_t width = 8;
+        constexpr std::uint32_t height = 8;
+
+        // the resources only keep a reference to their render device, so the device is not created
+        union DeviceStorage
+        {
+            DeviceStorage() noexcept {}
+            ~DeviceStorage() {}
+
+            graphics::software::RenderDevice renderDevice;
+        };
+
+        using Color = std::array<std::uint8_t, 4>;
+        using Palette = std::vector<std::pair<char, Color>>;
+
+        const Palette palette{
+            {'.', {0, 0, 0, 0}},
+            {'x', {64, 64, 64, 64}}, // a quarter of white, added once
+            {'2', {128, 128, 128, 128}}, // a quarter of white, added twice
+            {'K', {0, 0, 0, 255}},
+            {'R', {255, 0, 0, 255}},
+            {'G', {0, 255, 0, 255}},
+            {'B', {0, 0, 255, 255}},
+            {'Y', {255, 255, 0, 255}},
+            {'C', {0, 255, 255, 255}},
+            {'P', {128, 0, 128, 128}},
+            {'W', {255, 255, 255, 255}}
+        };
+
+        constexpr std::array<float, 4> quarter{0.25F, 0.25F, 0.25F, 0.25F};
+        constexpr std::array<float, 4> red{1.0F, 0.0F, 0.0F, 1.0F};
+        constexpr std::array<float, 4> green{0.0F, 1.0F, 0.0F, 1.0F};
+        constexpr std::array<float, 4> blue{0.0F, 0.0F, 1.0F, 1.0F};
+        constexpr std::array<float, 4> white{1.0F, 1.0F, 1.0F, 1.0F};
+
+        struct FrameBuffer final
+        {
+            std::vector<std::uint8_t> color = std::vector<std::uint8_t>(width * height * 4);
+            std::vector<float> depth = std::vector<float>(width * height);
+            std::vector<std::uint8_t> stencil = std::vector<std::uint8_t>(width * height);
+
+            Rasterizer::Target getTarget() noexcept
+            {
+                return Rasterizer::Target{width, height, color.data(), depth.data(), stencil.data()};
+            }
+        };
+
+        // the position is in pixels of the viewport, that covers the whole target
+        Rasterizer::Vertex makeVertex(float x, float y, float z,
+                                      const std::array<float, 4>& color,
+                                      const std::array<float, 2>& texCoord = {0.0F, 0.0F})
+        {
+            return Rasterizer::Vertex{
+                {x / static_cast<float>(width) * 2.0F - 1.0F, 1.0F - y / static_cast<float>(height) * 2.0F, z, 1.0F},
+                color,
+                texCoord
+            };
+        }
+
+        Rasterizer::State makeState()
+        {
+            Rasterizer::State state;
+            state.viewport = math::Rect<float>{0.0F, 0.0F, static_cast<float>(width), static_cast<float>(height)};
+            return state;
+        }
+
+        // two triangles that share the diagonal from the top-left to the bottom-right corner
+        void drawQuad(Rasterizer& rasterizer, float x0, float y0, float x1, float y1, float z,
+                      const std::array<float, 4>& color)
+        {
+            rasterizer.drawTriangle(makeVertex(x0, y0, z, color, {0.0F, 0.0F}),
+                                    makeVertex(x1, y0, z, color, {1.0F, 0.0F}),
+                                    makeVertex(x1, y1, z, color, {1.0F, 1.0F}));
+            rasterizer.drawTriangle(makeVertex(x0, y0, z, color, {0.0F, 0.0F}),
+                                    makeVertex(x1, y1, z, color, {1.0F, 1.0F}),
+                                    makeVertex(x0, y1, z, color, {0.0F, 1.0F}));
+        }
+
+        void expectImage(const FrameBuffer& frameBuffer,
+                         const std::vector<std::string>& expected,
+                         const std::string& message)
+        {
+            std::vector<std::string> image(height, std::string(width, '?'));
+
+            for (std::uint32_t y = 0; y < height; ++y)
+                for (std::uint32_t x = 0; x < width; ++x)
+                {
+                    const auto pixel = &frameBuffer.color[(y * width + x) * 4];
+                    for (const auto& [character, color] : palette)
+                        if (pixel[0] == color[0] && pixel[1] == color[1] &&
+                            pixel[2] == color[2] && pixel[3] == color[3])
+                            image[y][x] = character;
+                }
+
+            if (image != expected)
+            {
+                std::string result = message + ", got:";
+                for (const auto& row : image) result += "\n" + row;
+                throw TestError{result};
+            }
+        }
+
+        void testFillRule(graphics::software::RenderDevice& renderDevice)
+        {
+            const graphics::software::BlendState additive{renderDevice, true,
+                graphics::BlendFactor::one, graphics::BlendFactor::one, graphics::BlendOperation::add,
+                graphics::BlendFactor::one, graphics::BlendFactor::one, graphics::BlendOperation::add,
+                graphics::ColorMask::all};
+
+            FrameBuffer frameBuffer;
+            Rasterizer rasterizer;
+            rasterizer.setTarget(frameBuffer.getTarget());
+
+            auto state = makeState();
+            state.blendState = &additive;
+            rasterizer.setState(state);
+
+            // the pixel centers on the diagonal belong to the triangle whose left edge it is
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 0.0F}, 1.0F, 0);
+            rasterizer.drawTriangle(makeVertex(0.0F, 0.0F, 0.0F, red),
+                                    makeVertex(8.0F, 0.0F, 0.0F, red),
+                                    makeVertex(8.0F, 8.0F, 0.0F, red));
+            rasterizer.drawTriangle(makeVertex(0.0F, 0.0F, 0.0F, green),
+                                    makeVertex(8.0F, 8.0F, 0.0F, green),
+                                    makeVertex(0.0F, 8.0F, 0.0F, green));
+            rasterizer.flush();
+
+            expectImage(frameBuffer, {
+                "RRRRRRRR",
+                "GRRRRRRR",
+                "GGRRRRRR",
+                "GGGRRRRR",
+                "GGGGRRRR",
+                "GGGGGRRR",
+                "GGGGGGRR",
+                "GGGGGGGR"
+            }, "Shared diagonal edge not drawn exactly once");
+
+            // the edges go through the pixel centers, the top and left ones are inside
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 0.0F}, 1.0F, 0);
+            drawQuad(rasterizer, 1.5F, 1.5F, 5.5F, 4.5F, 0.0F, quarter);
+            rasterizer.flush();
+
+            expectImage(frameBuffer, {
+                "........",
+                ".xxxx...",
+                ".xxxx...",
+                ".xxxx...",
+                "........",
+                "........",
+                "........",
+                "........"
+            }, "Wrong top-left rule");
+
+            // the opposite winding covers the same pixels
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 0.0F}, 1.0F, 0);
+            rasterizer.drawTriangle(makeVertex(1.5F, 1.5F, 0.0F, quarter),
+                                    makeVertex(1.5F, 4.5F, 0.0F, quarter),
+                                    makeVertex(5.5F, 4.5F, 0.0F, quarter));
+            rasterizer.drawTriangle(makeVertex(1.5F, 1.5F, 0.0F, quarter),
+                                    makeVertex(5.5F, 4.5F, 0.0F, quarter),
+                                    makeVertex(5.5F, 1.5F, 0.0F, quarter));
+            rasterizer.flush();
+
+            expectImage(frameBuffer, {
+                "........",
+                ".xxxx...",
+                ".xxxx...",
+                ".xxxx...",
+                "........",
+                "........",
+                "........",
+                "........"
+            }, "Wrong top-left rule for counter-clockwise triangles");
+        }
+
+        void testClipping(graphics::software::RenderDevice& renderDevice)
+        {
+            const graphics::software::BlendState additive{renderDevice, true,
+                graphics::BlendFactor::one, graphics::BlendFactor::one, graphics::BlendOperation::add,
+                graphics::BlendFactor::one, graphics::BlendFactor::one, graphics::BlendOperation::add,
+                graphics::ColorMask::all};
+
+            FrameBuffer frameBuffer;
+            Rasterizer rasterizer;
+            rasterizer.setTarget(frameBuffer.getTarget());
+
+            auto state = makeState();
+            state.blendState = &additive;
+            rasterizer.setState(state);
+
+            // outside of the guard band, so it is clipped into a polygon that is drawn as a fan
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 0.0F}, 1.0F, 0);
+            rasterizer.drawTriangle(makeVertex(0.0F, 0.0F, 0.0F, quarter),
+                                    makeVertex(124.0F, 0.0F, 0.0F, quarter),
+                                    makeVertex(0.0F, 124.0F, 0.0F, quarter));
+            rasterizer.flush();
+
+            expectImage(frameBuffer, std::vector<std::string>(height, std::string(width, 'x')),
+                        "Triangle clipped by the guard band not drawn exactly once");
+
+            // the first vertex is in front of the near plane, which cuts the triangle at x + y = 4
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 0.0F}, 1.0F, 0);
+            rasterizer.drawTriangle(makeVertex(0.0F, 0.0F, -1.0F, quarter),
+                                    makeVertex(8.0F, 0.0F, 1.0F, quarter),
+                                    makeVertex(0.0F, 8.0F, 1.0F, quarter));
+            rasterizer.flush();
+
+            expectImage(frameBuffer, {
+                "...xxxx.",
+                "..xxxx..",
+                ".xxxx...",
+                "xxxx....",
+                "xxx.....",
+                "xx......",
+                "x.......",
+                "........"
+            }, "Wrong near plane clipping");
+
+            // triangles behind the far plane are dropped without clipping
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 0.0F}, 1.0F, 0);
+            rasterizer.drawTriangle(makeVertex(0.0F, 0.0F, 2.0F, quarter),
+                                    makeVertex(8.0F, 0.0F, 2.0F, quarter),
+                                    makeVertex(0.0F, 8.0F, 2.0F, quarter));
+            rasterizer.flush();
+
+            expectImage(frameBuffer, std::vector<std::string>(height, std::string(width, '.')),
+                        "Triangle behind the far plane drawn");
+        }
+
+        void testBlending(graphics::software::RenderDevice& renderDevice)
+        {
+            // the color is blended by the alpha and the alpha is written as it is
+            const graphics::software::BlendState alphaBlend{renderDevice, true,
+                graphics::BlendFactor::srcAlpha, graphics::BlendFactor::invSrcAlpha, graphics::BlendOperation::add,
+                graphics::BlendFactor::one, graphics::BlendFactor::zero, graphics::BlendOperation::add,
+                graphics::ColorMask::all};
+            const graphics::software::BlendState greenOnly{renderDevice, false,
+                graphics::BlendFactor::one, graphics::BlendFactor::zero, graphics::BlendOperation::add,
+                graphics::BlendFactor::one, graphics::BlendFactor::zero, graphics::BlendOperation::add,
+                graphics::ColorMask::green};
+
+            FrameBuffer frameBuffer;
+            Rasterizer rasterizer;
+            rasterizer.setTarget(frameBuffer.getTarget());
+            rasterizer.clear(true, true, true, blue, 1.0F, 0);
+
+            auto state = makeState();
+            state.blendState = &alphaBlend;
+            rasterizer.setState(state);
+            drawQuad(rasterizer, 0.0F, 0.0F, 4.0F, 8.0F, 0.0F, {1.0F, 0.0F, 0.0F, 0.5F});
+
+            state.blendState = &greenOnly;
+            rasterizer.setState(state);
+            drawQuad(rasterizer, 4.0F, 0.0F, 8.0F, 8.0F, 0.0F, white);
+
+            // the color constant is multiplied with the vertex color
+            state.blendState = nullptr;
+            state.color = {0.0F, 1.0F, 1.0F, 1.0F};
+            rasterizer.setState(state);
+            drawQuad(rasterizer, 0.0F, 7.0F, 8.0F, 8.0F, 0.0F, {1.0F, 1.0F, 0.0F, 1.0F});
+            rasterizer.flush();
+
+            expectImage(frameBuffer, {
+                "PPPPCCCC",
+                "PPPPCCCC",
+                "PPPPCCCC",
+                "PPPPCCCC",
+                "PPPPCCCC",
+                "PPPPCCCC",
+                "PPPPCCCC",
+                "GGGGGGGG"
+            }, "Wrong blending");
+        }
+
+        void testDepthStencil(graphics::software::RenderDevice& renderDevice)
+        {
+            const graphics::software::DepthStencilState depthLess{renderDevice, true, true,
+                graphics::CompareFunction::less, false, 0xFFU, 0xFFU, {}, {}};
+
+            FrameBuffer frameBuffer;
+            Rasterizer rasterizer;
+            rasterizer.setTarget(frameBuffer.getTarget());
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 1.0F}, 1.0F, 0);
+
+            auto state = makeState();
+            state.depthStencilState = &depthLess;
+            rasterizer.setState(state);
+
+            // the nearer green quad is drawn over the red one and hides the blue one behind both
+            drawQuad(rasterizer, 0.0F, 0.0F, 6.0F, 6.0F, 0.5F, red);
+            drawQuad(rasterizer, 2.0F, 0.0F, 8.0F, 6.0F, 0.25F, green);
+            drawQuad(rasterizer, 0.0F, 0.0F, 8.0F, 8.0F, 0.75F, blue);
+            rasterizer.flush();
+
+            expectImage(frameBuffer, {
+                "RRGGGGGG",
+                "RRGGGGGG",
+                "RRGGGGGG",
+                "RRGGGGGG",
+                "RRGGGGGG",
+                "RRGGGGGG",
+                "BBBBBBBB",
+                "BBBBBBBB"
+            }, "Wrong depth test");
+
+            expect(frameBuffer.depth[0] == 0.5F && frameBuffer.depth[2] == 0.25F && frameBuffer.depth[63] == 0.75F,
+                   "Wrong depth written");
+
+            // the first pass only writes the reference value to the stencil buffer
+            graphics::software::DepthStencilState::StencilFace replace;
+            replace.passOperation = graphics::StencilOperation::replace;
+            const graphics::software::DepthStencilState writeStencil{renderDevice, false, false,
+                graphics::CompareFunction::always, true, 0xFFU, 0xFFU, replace, replace};
+
+            graphics::software::DepthStencilState::StencilFace equal;
+            equal.compareFunction = graphics::CompareFunction::equal;
+            const graphics::software::DepthStencilState testStencil{renderDevice, false, false,
+                graphics::CompareFunction::always, true, 0xFFU, 0xFFU, equal, equal};
+
+            const graphics::software::BlendState noColor{renderDevice, false,
+                graphics::BlendFactor::one, graphics::BlendFactor::zero, graphics::BlendOperation::add,
+                graphics::BlendFactor::one, graphics::BlendFactor::zero, graphics::BlendOperation::add,
+                graphics::ColorMask::none};
+
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 1.0F}, 1.0F, 0);
+
+            state = makeState();
+            state.blendState = &noColor;
+            state.depthStencilState = &writeStencil;
+            state.stencilReferenceValue = 1;
+            rasterizer.setState(state);
+            drawQuad(rasterizer, 2.0F, 2.0F, 6.0F, 6.0F, 0.0F, white);
+
+            state.blendState = nullptr;
+            state.depthStencilState = &testStencil;
+            rasterizer.setState(state);
+            drawQuad(rasterizer, 0.0F, 0.0F, 8.0F, 8.0F, 0.0F, white);
+            rasterizer.flush();
+
+            expectImage(frameBuffer, {
+                "KKKKKKKK",
+                "KKKKKKKK",
+                "KKWWWWKK",
+                "KKWWWWKK",
+                "KKWWWWKK",
+                "KKWWWWKK",
+                "KKKKKKKK",
+                "KKKKKKKK"
+            }, "Wrong stencil test");
+
+            expect(frameBuffer.stencil[0] == 0 && frameBuffer.stencil[2 * width + 2] == 1, "Wrong stencil written");
+        }
+
+        void testTexture(graphics::software::RenderDevice& renderDevice)
+        {
+            const graphics::software::Texture texture{renderDevice,
+                {{math::Size<std::uint32_t, 2>{2, 2}, {
+                    255, 0, 0, 255, 0, 255, 0, 255,
+                    0, 0, 255, 255, 255, 255, 255, 255
+                }}},
+                graphics::TextureType::twoDimensional,
+                graphics::Flags::none,
+                1,
+                graphics::PixelFormat::rgba8UnsignedNorm,
+                graphics::SamplerFilter::point,
+                1};
+
+            FrameBuffer frameBuffer;
+            Rasterizer rasterizer;
+            rasterizer.setTarget(frameBuffer.getTarget());
+            rasterizer.clear(true, true, true, {0.0F, 0.0F, 0.0F, 0.0F}, 1.0F, 0);
+
+            // every texel covers two by two pixels, the first row of the texture is at the top
+            auto state = makeState();
+            state.shaderType = graphics::software::Shader::Type::texture;
+            state.texture = &texture;
+            rasterizer.setState(state);
+            drawQuad(rasterizer, 2.0F, 2.0F, 6.0F, 6.0F, 0.0F, white);
+            rasterizer.flush();
+
+            expectImage(frameBuffer, {
+                "........",
+                "........",
+                "..RRGG..",
+                "..RRGG..",
+                "..BBWW..",
+                "..BBWW..",
+                "........",
+                "........"
+            }, "Wrong texture shader");
+        }
+    }
+
+    void testSoftwareRasterizer()
+    {
+        DeviceStorage deviceStorage;
+
+        testFillRule(deviceStorage.renderDevice);
+        testClipping(deviceStorage.renderDevice);
+        testBlending(deviceStorage.renderDevice);
+        testDepthStencil(deviceStorage.renderDevice);
+        testTexture(deviceStorage.renderDevice);
+    }
+}
@@ -0,0 +1,91 @@
+// Ouzel by Elviss Strazdins
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Test.hpp"
+#include "scene/StaticBatchLayout.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        std::vector<graphics::Vertex> makeQuad(float x)
+        {
+            std::vector<graphics::Vertex> vertices(4);
+            vertices[0].position = math::Vector<float, 3>{x, 0.0F, 0.0F};
+            vertices[1].position = math::Vector<float, 3>{x + 1.0F, 0.0F, 0.0F};
+            vertices[2].position = math::Vector<float, 3>{x, 1.0F, 0.0F};
+            vertices[3].position = math::Vector<float, 3>{x + 1.0F, 1.0F, 0.0F};
+            return vertices;
+        }
+    }
+
+    void testStaticBatchLayout()
+    {
+        // the material objects are never dereferenced by the layout
+        const auto blendState = reinterpret_cast<const graphics::BlendState*>(alignof(graphics::BlendState));
+        const auto shader = reinterpret_cast<const graphics::Shader*>(alignof(graphics::Shader));
+
+        const std::vector<std::uint32_t> indices{0, 1, 2, 1, 3, 2};
+
+        scene::StaticBatchLayout layout{1024.0F};
+
+        {
+            // the material is owned by the first renderer and destroyed with it
+            auto material = std::make_shared<graphics::Material>();
+            material->blendState = blendState;
+            material->shader = shader;
+            material->diffuseColor = math::Color{255, 0, 0, 255};
+            material->opacity = 0.5F;
+
+            auto secondMaterial = std::make_shared<graphics::Material>();
+            secondMaterial->blendState = blendState;
+            secondMaterial->shader = shader;
+            secondMaterial->diffuseColor = math::Color{255, 0, 0, 255};
+            secondMaterial->opacity = 0.5F;
+
+            expect(layout.addMember(*material, math::identityMatrix<float, 4>, indices, makeQuad(0.0F)) == 0, "Wrong first member");
+            expect(layout.addMember(*secondMaterial, math::identityMatrix<float, 4>, indices, makeQuad(2.0F)) == 1, "Wrong second member");
+            expect(layout.addMember(*secondMaterial, math::identityMatrix<float, 4>, indices, makeQuad(4.0F)) == 2, "Wrong third member");
+        }
+
+        // the first renderer is destroyed, like in StaticBatch::removeRenderer
+        layout.setMemberHidden(0, true);
+        layout.build(math::identityMatrix<float, 4>);
+
+        const auto& cells = layout.getCells();
+        expect(cells.size() == 1, "Members not in one cell");
+        expect(cells[0].groups.size() == 1, "Compatible materials not grouped");
+
+        const auto& group = cells[0].groups[0];
+        expect(group.members == std::vector<scene::StaticBatchLayout::MemberId>{0, 1, 2}, "Wrong group members");
+        expect(group.indices.size() == 18 && group.vertices.size() == 12, "Wrong group geometry");
+        expect(group.indices[6] == 4 && group.indices[17] == 10, "Member indices not offset by their vertices");
+
+        // the group draws with its own copy of the material after the materials of the renderers are gone
+        expect(group.material.blendState == blendState && group.material.shader == shader, "Pipeline state not copied");
+        expect(group.material.diffuseColor == math::Color(255, 0, 0, 255), "Diffuse color not copied");
+        expect(group.material.opacity == 0.5F, "Opacity not copied");
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+        layout.forEachDrawRange(group, [&ranges](std::uint32_t startIndex, std::uint32_t indexCount) {
+            ranges.emplace_back(startIndex, indexCount);
+        });
+        expect(ranges == std::vector<std::pair<std::uint32_t, std::uint32_t>>{{6, 12}}, "Hidden member drawn");
+
+        // a hidden member in the middle splits the draw call
+        layout.setMemberHidden(0, false);
+        layout.setMemberHidden(1, true);
+        ranges.clear();
+        layout.forEachDrawRange(group, [&ranges](std::uint32_t startIndex, std::uint32_t indexCount) {
+            ranges.emplace_back(startIndex, indexCount);
+        });
+        expect(ranges == std::vector<std::pair<std::uint32_t, std::uint32_t>>{{0, 6}, {12, 6}}, "Visible members not split around the hidden one");
+
+        layout.releaseGeometry();
+        expect(cells[0].groups[0].indices.empty() && cells[0].groups[0].vertices.empty(), "Geometry not released");
+
+        expectThrow<std::out_of_range>([&layout]() { layout.setMemberHidden(3, true); }, "Invalid member accepted");
+    }
+}
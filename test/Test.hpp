@@ -0,0 +1,57 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_TEST_TEST_HPP
+#define OUZEL_TEST_TEST_HPP
+
+#include <stdexcept>
+#include <string>
+
+namespace ouzel::test
+{
+    class TestError final: public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    inline void expect(bool condition, const std::string& message)
+    {
+        if (!condition) throw TestError{message};
+    }
+
+    template <class Exception, class Function>
+    void expectThrow(Function function, const std::string& message)
+    {
+        try
+        {
+            function();
+        }
+        catch (const Exception&)
+        {
+            return;
+        }
+
+        throw TestError{message};
+    }
+
+    void testBlockDecoder();
+    void testClusterGrid();
+    void testComponentPool();
+    void testCullBoxes();
+    void testDrawOrder();
+    void testFrameReplay();
+    void testImageWriter();
+    void testMeshSimplifier();
+    void testMipmapGenerator();
+    void testRenderGraphSchedule();
+    void testResourceTable();
+    void testSceneData();
+    void testSkeletalAnimation();
+    void testSkylinePacker();
+    void testSoftwareRasterizer();
+    void testStaticBatchLayout();
+    void testTextureLevels();
+    void testTileAnimation();
+}
+
+#endif // OUZEL_TEST_TEST_HPP
@@ -0,0 +1,29 @@
+// Ouzel by Elviss Strazdins
+
+#include <stdexcept>
+#include "Test.hpp"
+#include "assets/TextureLevels.hpp"
+
+namespace ouzel::test
+{
+    void testTextureLevels()
+    {
+        expect(assets::getMaxLevelCount(1, 1) == 1, "Wrong level count of a 1x1 texture");
+        expect(assets::getMaxLevelCount(256, 256) == 9, "Wrong level count of a 256x256 texture");
+        expect(assets::getMaxLevelCount(300, 5) == 9, "Wrong level count of a 300x5 texture");
+        expect(assets::getMaxLevelCount(0xFFFFFFFFU, 1) == 32, "Wrong level count of the widest texture");
+
+        const auto levels = assets::getLevelSizes(8, 2, 4);
+        expect(levels.size() == 4, "Wrong number of levels");
+        expect(levels[1].v[0] == 4 && levels[1].v[1] == 1, "Wrong size of the second level");
+        expect(levels[3].v[0] == 1 && levels[3].v[1] == 1, "Wrong size of the last level");
+
+        // counts and sizes read from malformed files
+        expectThrow<std::runtime_error>([]{ assets::getLevelSizes(8, 2, 5); }, "Too many levels accepted");
+        expectThrow<std::runtime_error>([]{ assets::getLevelSizes(1024, 1024, 32); }, "32 levels accepted");
+        expectThrow<std::runtime_error>([]{ assets::getLevelSizes(1024, 1024, 0xFFFFFFFFU); }, "Huge level count accepted");
+        expectThrow<std::runtime_error>([]{ assets::getLevelSizes(0, 16, 1); }, "Zero width accepted");
+        expectThrow<std::runtime_error>([]{ assets::getLevelSizes(16, 0, 1); }, "Zero height accepted");
+        expectThrow<std::runtime_error>([]{ assets::getLevelSizes(16, 16, 0); }, "Zero levels accepted");
+    }
+}
@@ -0,0 +1,79 @@
+// Ouzel by Elviss Strazdins
+
+#include <vector>
+#include "Test.hpp"
+#include "scene/TileAnimation.hpp"
+
+namespace ouzel::test
+{
+    namespace
+    {
+        using ChunkUpdate = scene::TileAnimation::ChunkUpdate;
+
+        void testChunkUpdates()
+        {
+            scene::TileAnimation animation;
+            animation.reset(8);
+
+            const auto version = animation.getVersion();
+
+            // changed tiles need new geometry, animated frames only new texture coordinates
+            expect(animation.getChunkUpdate(true, false, version) == ChunkUpdate::rebuild, "Dirty chunk not rebuilt");
+            expect(animation.getChunkUpdate(true, true, version - 1) == ChunkUpdate::rebuild, "Dirty animated chunk not rebuilt");
+            expect(animation.getChunkUpdate(false, true, version - 1) == ChunkUpdate::frames, "Animated chunk frames not updated");
+            expect(animation.getChunkUpdate(false, false, version - 1) == ChunkUpdate::none, "Chunk without animated tiles updated");
+            expect(animation.getChunkUpdate(false, true, version) == ChunkUpdate::none, "Up to date chunk updated");
+        }
+
+        void testFrames()
+        {
+            scene::TileAnimation animation;
+            animation.reset(8);
+
+            expect(animation.getFrame(3) == 3 && !animation.isAnimated(3), "Tile not mapped to itself");
+
+            animation.setAnimatedTile(3, {4, 5, 6}, 0.5F);
+            expect(animation.isAnimated(3) && animation.hasAnimatedTiles(), "Tile not animated");
+            expect(animation.getFrame(3) == 4, "Animation not started with the first frame");
+
+            // the version changes only when a tile shows another frame
+            auto version = animation.getVersion();
+            animation.update(0.25F);
+            expect(animation.getVersion() == version && animation.getFrame(3) == 4, "Frame changed before its interval");
+
+            animation.update(0.25F);
+            expect(animation.getVersion() != version && animation.getFrame(3) == 5, "Frame not advanced");
+
+            animation.update(1.0F);
+            expect(animation.getFrame(3) == 4, "Animation not looped");
+
+            version = animation.getVersion();
+            expect(animation.removeAnimatedTile(3), "Animated tile not removed");
+            expect(animation.getFrame(3) == 3 && !animation.hasAnimatedTiles(), "Removed tile not mapped to itself");
+            expect(animation.getVersion() != version, "Removed tile frame not updated");
+            expect(!animation.removeAnimatedTile(3), "Tile removed twice");
+
+            version = animation.getVersion();
+            animation.update(1.0F);
+            expect(animation.getVersion() == version, "Version changed without animated tiles");
+
+            expectThrow<std::runtime_error>([&animation]() {
+                animation.setAnimatedTile(9, {1}, 0.5F);
+            }, "Invalid tile animated");
+
+            expectThrow<std::runtime_error>([&animation]() {
+                animation.setAnimatedTile(3, {1, 9}, 0.5F);
+            }, "Invalid frame accepted");
+
+            expectThrow<std::runtime_error>([&animation]() {
+                animation.setAnimatedTile(3, {}, 0.5F);
+            }, "Empty animation accepted");
+        }
+    }
+
+    void testTileAnimation()
+    {
+        testChunkUpdates();
+        testFrames();
+    }
+}
@@ -1,8 +1,63 @@
 // Ouzel by Elviss Strazdins
 
-#include "cstdlib"
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include "Test.hpp"
+
+namespace
+{
+    struct TestCase final
+    {
+        const char* name;
+        void (*function)();
+    };
+
+    const TestCase testCases[] = {
+        {"BlockDecoder", ouzel::test::testBlockDecoder},
+        {"ClusterGrid", ouzel::test::testClusterGrid},
+        {"ComponentPool", ouzel::test::testComponentPool},
+        {"CullBoxes", ouzel::test::testCullBoxes},
+        {"DrawOrder", ouzel::test::testDrawOrder},
+        {"FrameReplay", ouzel::test::testFrameReplay},
+        {"ImageWriter", ouzel::test::testImageWriter},
+        {"MeshSimplifier", ouzel::test::testMeshSimplifier},
+        {"MipmapGenerator", ouzel::test::testMipmapGenerator},
+        {"RenderGraphSchedule", ouzel::test::testRenderGraphSchedule},
+        {"ResourceTable", ouzel::test::testResourceTable},
+        {"SceneData", ouzel::test::testSceneData},
+        {"SkeletalAnimation", ouzel::test::testSkeletalAnimation},
+        {"SkylinePacker", ouzel::test::testSkylinePacker},
+        {"SoftwareRasterizer", ouzel::test::testSoftwareRasterizer},
+        {"StaticBatchLayout", ouzel::test::testStaticBatchLayout},
+        {"TextureLevels", ouzel::test::testTextureLevels},
+        {"TileAnimation", ouzel::test::testTileAnimation}
+    };
+}
 
 int main()
 {
+    std::size_t failed = 0;
+
+    for (const auto& testCase : testCases)
+    {
+        try
+        {
+            testCase.function();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << testCase.name << " failed: " << e.what() << '\n';
+            ++failed;
+        }
+    }
+
+    if (failed)
+    {
+        std::cerr << failed << " of " << std::size(testCases) << " tests failed\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "All " << std::size(testCases) << " tests passed\n";
     return EXIT_SUCCESS;
 }
@@ -3,6 +3,7 @@
 #ifndef OUZEL_ASSET_HPP
 #define OUZEL_ASSET_HPP
 
+#include <cstdint>
 #include "storage/Path.hpp"
 
 namespace ouzel
@@ -27,6 +28,7 @@ namespace ouzel
         struct Options final
         {
             bool mipmaps = true;
+            std::uint32_t lods = 0; // number of simplified levels of detail generated for meshes
         };
 
         Asset(const storage::Path& initPath,
@@ -0,0 +1,441 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_MESHSIMPLIFIER_HPP
+#define OUZEL_MESHSIMPLIFIER_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "storage/Path.hpp"
+
+namespace ouzel
+{
+    // Reduces the triangle count of a mesh by collapsing the edges with the smallest quadric error
+    class MeshSimplifier final
+    {
+    public:
+        using Position = std::array<double, 3>;
+        using Triangle = std::array<std::uint32_t, 3>;
+
+        MeshSimplifier(const std::vector<Position>& initPositions,
+                       const std::vector<Triangle>& initTriangles):
+            positions{initPositions},
+            triangles{initTriangles},
+            quadrics(initPositions.size()),
+            vertexTriangles(initPositions.size()),
+            removedVertices(initPositions.size()),
+            removedTriangles(initTriangles.size()),
+            versions(initPositions.size()),
+            remaining{initTriangles.size()}
+        {
+            for (std::size_t triangleIndex = 0; triangleIndex < triangles.size(); ++triangleIndex)
+            {
+                const auto& triangle = triangles[triangleIndex];
+
+                for (const auto vertex : triangle)
+                {
+                    if (vertex >= positions.size())
+                        throw std::runtime_error{"Invalid vertex index"};
+
+                    vertexTriangles[vertex].push_back(triangleIndex);
+                }
+
+                const auto [normal, area] = getNormal(triangle);
+                if (area <= 0.0) continue;
+
+                const auto plane = makePlane(normal, positions[triangle[0]]);
+                for (const auto vertex : triangle)
+                    addPlane(quadrics[vertex], plane, area);
+            }
+
+            // planes perpendicular to the open edges keep the outline of the mesh in place
+            for (std::size_t triangleIndex = 0; triangleIndex < triangles.size(); ++triangleIndex)
+            {
+                const auto& triangle = triangles[triangleIndex];
+                const auto [normal, area] = getNormal(triangle);
+                if (area <= 0.0) continue;
+
+                for (std::size_t edge = 0; edge < 3; ++edge)
+                {
+                    const auto vertex1 = triangle[edge];
+                    const auto vertex2 = triangle[(edge + 1) % 3];
+
+                    if (getSharedTriangleCount(vertex1, vertex2) != 1) continue;
+
+                    const Position direction{
+                        positions[vertex2][0] - positions[vertex1][0],
+                        positions[vertex2][1] - positions[vertex1][1],
+                        positions[vertex2][2] - positions[vertex1][2]
+                    };
+
+                    const auto edgeNormal = normalize(cross(direction, normal));
+                    const auto plane = makePlane(edgeNormal, positions[vertex1]);
+                    addPlane(quadrics[vertex1], plane, boundaryWeight * area);
+                    addPlane(quadrics[vertex2], plane, boundaryWeight * area);
+                }
+            }
+
+            for (std::uint32_t vertex = 0; vertex < positions.size(); ++vertex)
+                addCollapses(vertex);
+        }
+
+        // returns the remaining triangles, the vertices keep their original indices
+        std::vector<Triangle> simplify(std::size_t targetTriangleCount)
+        {
+            while (remaining > targetTriangleCount && !collapses.empty())
+            {
+                const auto collapse = collapses.top();
+                collapses.pop();
+
+                if (removedVertices[collapse.from] || removedVertices[collapse.to] ||
+                    versions[collapse.from] != collapse.fromVersion ||
+                    versions[collapse.to] != collapse.toVersion)
+                    continue;
+
+                if (flipsTriangle(collapse.from, collapse.to)) continue;
+
+                for (const auto triangleIndex : vertexTriangles[collapse.from])
+                {
+                    if (removedTriangles[triangleIndex]) continue;
+
+                    auto& triangle = triangles[triangleIndex];
+
+                    if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+                    {
+                        removedTriangles[triangleIndex] = true;
+                        --remaining;
+                    }
+                    else
+                    {
+                        for (auto& vertex : triangle)
+                            if (vertex == collapse.from) vertex = collapse.to;
+
+                        vertexTriangles[collapse.to].push_back(triangleIndex);
+                    }
+                }
+
+                for (std::size_t i = 0; i < quadrics[collapse.to].size(); ++i)
+                    quadrics[collapse.to][i] += quadrics[collapse.from][i];
+
+                removedVertices[collapse.from] = true;
+                ++versions[collapse.to];
+                addCollapses(collapse.to);
+            }
+
+            std::vector<Triangle> result;
+            result.reserve(remaining);
+
+            for (std::size_t triangleIndex = 0; triangleIndex < triangles.size(); ++triangleIndex)
+                if (!removedTriangles[triangleIndex])
+                    result.push_back(triangles[triangleIndex]);
+
+            return result;
+        }
+
+    private:
+        static constexpr double boundaryWeight = 10.0;
+
+        using Quadric = std::array<double, 10>; // upper triangle of the symmetric 4x4 matrix
+        using Plane = std::array<double, 4>;
+
+        struct Collapse final
+        {
+            double cost;
+            std::uint32_t from;
+            std::uint32_t to;
+            std::uint32_t fromVersion;
+            std::uint32_t toVersion;
+
+            bool operator<(const Collapse& other) const noexcept
+            {
+                return cost > other.cost; // the priority queue returns the cheapest collapse first
+            }
+        };
+
+        static Position cross(const Position& a, const Position& b) noexcept
+        {
+            return {
+                a[1] * b[2] - a[2] * b[1],
+                a[2] * b[0] - a[0] * b[2],
+                a[0] * b[1] - a[1] * b[0]
+            };
+        }
+
+        static Position normalize(const Position& v) noexcept
+        {
+            const auto length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            if (length <= 0.0) return v;
+            return {v[0] / length, v[1] / length, v[2] / length};
+        }
+
+        static Plane makePlane(const Position& normal, const Position& point) noexcept
+        {
+            return {normal[0], normal[1], normal[2], -(normal[0] * point[0] + normal[1] * point[1] + normal[2] * point[2])};
+        }
+
+        static void addPlane(Quadric& quadric, const Plane& plane, double weight) noexcept
+        {
+            std::size_t i = 0;
+            for (std::size_t row = 0; row < 4; ++row)
+                for (std::size_t column = row; column < 4; ++column)
+                    quadric[i++] += plane[row] * plane[column] * weight;
+        }
+
+        static double getError(const Quadric& quadric, const Position& position) noexcept
+        {
+            const std::array<double, 4> v{position[0], position[1], position[2], 1.0};
+
+            double result = 0.0;
+            std::size_t i = 0;
+            for (std::size_t row = 0; row < 4; ++row)
+                for (std::size_t column = row; column < 4; ++column)
+                    result += quadric[i++] * v[row] * v[column] * (row == column ? 1.0 : 2.0);
+
+            return result;
+        }
+
+        std::pair<Position, double> getNormal(const Triangle& triangle) const noexcept
+        {
+            const auto& p0 = positions[triangle[0]];
+            const auto& p1 = positions[triangle[1]];
+            const auto& p2 = positions[triangle[2]];
+
+            const auto normal = cross(Position{p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]},
+                                      Position{p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]});
+            const auto length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+            return {normalize(normal), length / 2.0};
+        }
+
+        std::size_t getSharedTriangleCount(std::uint32_t vertex1, std::uint32_t vertex2) const noexcept
+        {
+            std::size_t result = 0;
+
+            for (const auto triangleIndex : vertexTriangles[vertex1])
+            {
+                const auto& triangle = triangles[triangleIndex];
+                if (triangle[0] == vertex2 || triangle[1] == vertex2 || triangle[2] == vertex2)
+                    ++result;
+            }
+
+            return result;
+        }
+
+        // moving the vertex must not turn any of its other triangles over
+        bool flipsTriangle(std::uint32_t from, std::uint32_t to) const noexcept
+        {
+            for (const auto triangleIndex : vertexTriangles[from])
+            {
+                if (removedTriangles[triangleIndex]) continue;
+
+                const auto& triangle = triangles[triangleIndex];
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to) continue;
+
+                auto collapsed = triangle;
+                for (auto& vertex : collapsed)
+                    if (vertex == from) vertex = to;
+
+                const auto [oldNormal, oldArea] = getNormal(triangle);
+                const auto [newNormal, newArea] = getNormal(collapsed);
+
+                if (newArea <= 0.0 ||
+                    oldNormal[0] * newNormal[0] + oldNormal[1] * newNormal[1] + oldNormal[2] * newNormal[2] < 0.2)
+                    return true;
+            }
+
+            return false;
+        }
+
+        void addCollapses(std::uint32_t vertex)
+        {
+            for (const auto triangleIndex : vertexTriangles[vertex])
+            {
+                if (removedTriangles[triangleIndex]) continue;
+
+                for (const auto neighbor : triangles[triangleIndex])
+                {
+                    if (neighbor == vertex) continue;
+
+                    Quadric quadric = quadrics[vertex];
+                    for (std::size_t i = 0; i < quadric.size(); ++i)
+                        quadric[i] += quadrics[neighbor][i];
+
+                    collapses.push(Collapse{getError(quadric, positions[neighbor]), vertex, neighbor, versions[vertex], versions[neighbor]});
+                    collapses.push(Collapse{getError(quadric, positions[vertex]), neighbor, vertex, versions[neighbor], versions[vertex]});
+                }
+            }
+        }
+
+        std::vector<Position> positions;
+        std::vector<Triangle> triangles;
+        std::vector<Quadric> quadrics;
+        std::vector<std::vector<std::size_t>> vertexTriangles;
+        std::vector<bool> removedVertices;
+        std::vector<bool> removedTriangles;
+        std::vector<std::uint32_t> versions;
+        std::priority_queue<Collapse> collapses;
+        std::size_t remaining;
+    };
+
+    // Appends simplified copies of every object of an OBJ file as <object>_LOD<n>, halving the triangle count with every level
+    // Faces before the first named object belong to the object with the default name
+    inline void generateObjLods(const storage::Path& inputPath,
+                                const storage::Path& outputPath,
+                                const std::string& defaultName,
+                                std::uint32_t lodCount)
+    {
+        struct Corner final
+        {
+            std::uint32_t position;
+            std::string texCoord; // empty if the corner has no texture coordinates
+            std::string reference; // the face element as written in the file, e.g. 1/2/3
+        };
+
+        struct Object final
+        {
+            std::string name;
+            std::vector<std::array<Corner, 3>> faces;
+        };
+
+        std::ifstream inputFile{inputPath, std::ios::binary};
+        if (!inputFile)
+            throw std::runtime_error{"Failed to open " + std::string(inputPath)};
+
+        std::string source;
+        std::vector<MeshSimplifier::Position> positions;
+        std::vector<Object> objects{Object{defaultName, {}}};
+        std::size_t texCoordCount = 0;
+        std::size_t normalCount = 0;
+
+        // converts relative indices, so that the elements can be written after the end of the file
+        const auto makeAbsolute = [](const std::string& index, std::size_t count) {
+            const auto value = std::stol(index);
+            return std::to_string(value < 0 ? static_cast<long>(count) + value + 1 : value);
+        };
+
+        for (std::string line; std::getline(inputFile, line);)
+        {
+            source += line + '\n';
+
+            std::istringstream lineStream{line};
+            std::string keyword;
+            lineStream >> keyword;
+
+            if (keyword == "v")
+            {
+                MeshSimplifier::Position position{};
+                lineStream >> position[0] >> position[1] >> position[2];
+                positions.push_back(position);
+            }
+            else if (keyword == "vt")
+                ++texCoordCount;
+            else if (keyword == "vn")
+                ++normalCount;
+            else if (keyword == "o")
+            {
+                Object object;
+                lineStream >> object.name;
+                objects.push_back(object);
+            }
+            else if (keyword == "f")
+            {
+                std::vector<Corner> corners;
+
+                for (std::string element; lineStream >> element;)
+                {
+                    std::array<std::string, 3> parts;
+                    std::size_t part = 0;
+                    for (const auto c : element)
+                        if (c == '/') { if (++part > 2) break; }
+                        else parts[part] += c;
+
+                    const auto position = makeAbsolute(parts[0], positions.size());
+
+                    Corner corner;
+                    corner.position = static_cast<std::uint32_t>(std::stoul(position) - 1);
+                    corner.reference = position;
+                    if (part >= 1 && !parts[1].empty()) corner.texCoord = makeAbsolute(parts[1], texCoordCount);
+                    if (part >= 1) corner.reference += '/' + corner.texCoord;
+                    if (part >= 2) corner.reference += '/' + makeAbsolute(parts[2], normalCount);
+                    corners.push_back(corner);
+                }
+
+                if (corners.size() < 3)
+                    throw std::runtime_error{"Invalid face"};
+
+                for (std::size_t i = 1; i + 1 < corners.size(); ++i)
+                    objects.back().faces.push_back({corners[0], corners[i], corners[i + 1]});
+            }
+        }
+
+        std::ofstream outputFile{outputPath, std::ios::binary};
+        if (!outputFile)
+            throw std::runtime_error{"Failed to open " + std::string(outputPath)};
+
+        outputFile << source;
+
+        for (const auto& object : objects)
+        {
+            if (object.faces.empty()) continue;
+
+            // corners with the same position but different texture coordinates are separate vertices,
+            // so the texture seams become open edges that the simplifier keeps in place
+            std::map<std::pair<std::uint32_t, std::string>, std::uint32_t> vertexIndices;
+            std::vector<MeshSimplifier::Position> vertices;
+            std::vector<std::string> references; // the corners of the remaining triangles keep their texture coordinates and normals
+            std::vector<MeshSimplifier::Triangle> triangles;
+            triangles.reserve(object.faces.size());
+
+            for (const auto& face : object.faces)
+            {
+                MeshSimplifier::Triangle triangle;
+
+                for (std::size_t i = 0; i < face.size(); ++i)
+                {
+                    const auto& corner = face[i];
+                    if (corner.position >= positions.size())
+                        throw std::runtime_error{"Invalid vertex index"};
+
+                    const auto [vertexIndex, inserted] = vertexIndices.insert(std::pair(std::pair(corner.position, corner.texCoord),
+                                                                                        static_cast<std::uint32_t>(vertices.size())));
+                    if (inserted)
+                    {
+                        vertices.push_back(positions[corner.position]);
+                        references.push_back(corner.reference);
+                    }
+
+                    triangle[i] = vertexIndex->second;
+                }
+
+                triangles.push_back(triangle);
+            }
+
+            MeshSimplifier simplifier{vertices, triangles};
+            auto targetTriangleCount = triangles.size();
+
+            for (std::uint32_t level = 1; level <= lodCount; ++level)
+            {
+                targetTriangleCount /= 2;
+                const auto simplified = simplifier.simplify(targetTriangleCount);
+
+                outputFile << "o " << object.name << "_LOD" << level << '\n';
+
+                for (const auto& triangle : simplified)
+                    outputFile << "f " << references[triangle[0]] << ' '
+                        << references[triangle[1]] << ' '
+                        << references[triangle[2]] << '\n';
+            }
+        }
+    }
+}
+
+#endif // OUZEL_MESHSIMPLIFIER_HPP
@@ -5,6 +5,7 @@
 
 #include <fstream>
 #include "Asset.hpp"
+#include "MeshSimplifier.hpp"
 #include "Target.hpp"
 #include "storage/FileSystem.hpp"
 #include "formats/Json.hpp"
@@ -65,6 +66,7 @@ namespace ouzel
                     const auto assetType = stringToAssetType(assetObject["type"].as<std::string>());
                     Asset::Options options;
                     options.mipmaps = assetObject.hasMember("mipmaps") ? assetObject["mipmaps"].as<bool>() : false;
+                    options.lods = assetObject.hasMember("lods") ? assetObject["lods"].as<std::uint32_t>() : 0;
 
                     assets.emplace_back(assetPath, assetName, assetType, options);
                 }
@@ -99,6 +101,15 @@ namespace ouzel
                 if (targetIterator == targets.end())
                     throw std::runtime_error{"Target not found"};
 
+                // the levels are stored next to the source mesh as <mesh>.lod.obj, which the bundle loads instead of <mesh>.obj
+                if (asset.type == Asset::Type::mesh && asset.options.lods > 0)
+                {
+                    auto lodPath = asset.path;
+                    lodPath.replaceExtension("lod.obj");
+                    generateObjLods(asset.path, lodPath, asset.name, asset.options.lods);
+                    continue;
+                }
+
                 // TODO: check if input file exists
                 // TODO: check if output file exists and is older than the input file
                 // TODO: export input file to output file